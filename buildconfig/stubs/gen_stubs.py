@@ -33,6 +33,8 @@ PG_AUTOIMPORT_SUBMODS = [
     "pixelcopy",
     "sndarray",
     "sprite",
+    "atlas",
+    "tilelayer",
     "surfarray",
     "transform",
     "scrap",
@@ -58,11 +60,13 @@ PG_AUTOIMPORT_SUBMODS = [
 # pygame classes that are autoimported into main namespace are kept in this dict
 PG_AUTOIMPORT_CLASSES = {
     "rect": ["Rect", "FRect"],
-    "surface": ["Surface", "SurfaceType"],
+    "surface": ["Surface", "SurfaceType", "BlitBatch"],
     "color": ["Color"],
     "pixelarray": ["PixelArray"],
     "math": ["Vector2", "Vector3"],
     "cursors": ["Cursor"],
+    "atlas": ["Atlas"],
+    "tilelayer": ["TileLayer"],
     "bufferproxy": ["BufferProxy"],
     "mask": ["Mask"],
     "_debug": ["print_debug_info"],
@@ -20,6 +20,8 @@ from . import (
     pixelcopy as pixelcopy,
     sndarray as sndarray,
     sprite as sprite,
+    atlas as atlas,
+    tilelayer as tilelayer,
     surfarray as surfarray,
     transform as transform,
     scrap as scrap,
@@ -43,11 +45,18 @@ from . import (
 )
 
 from .rect import Rect as Rect, FRect as FRect
-from .surface import Surface as Surface, SurfaceType as SurfaceType
+from .surface import (
+    Surface as Surface,
+    SurfaceType as SurfaceType,
+    BlitBatch as BlitBatch,
+)
+
 from .color import Color as Color
 from .pixelarray import PixelArray as PixelArray
 from .math import Vector2 as Vector2, Vector3 as Vector3
 from .cursors import Cursor as Cursor
+from .atlas import Atlas as Atlas
+from .tilelayer import TileLayer as TileLayer
 from .bufferproxy import BufferProxy as BufferProxy
 from .mask import Mask as Mask
 from ._debug import print_debug_info as print_debug_info
@@ -65,12 +74,14 @@ from .base import (
     get_array_interface as get_array_interface,
     get_error as get_error,
     get_init as get_init,
+    get_num_threads as get_num_threads,
     get_sdl_byteorder as get_sdl_byteorder,
     get_sdl_version as get_sdl_version,
     init as init,
     quit as quit,
     register_quit as register_quit,
     set_error as set_error,
+    set_num_threads as set_num_threads,
 )
 
 from .rwobject import (
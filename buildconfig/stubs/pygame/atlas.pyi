@@ -0,0 +1,21 @@
+from collections.abc import Iterable
+
+from pygame._render import Renderer, Texture
+from pygame.rect import Rect
+from pygame.surface import Surface
+from pygame.typing import IntPoint
+
+class Atlas:
+    def __init__(
+        self,
+        page_size: IntPoint = (1024, 1024),
+        padding: int = 1,
+        flags: int = ...,
+        depth: int = 32,
+    ) -> None: ...
+    @property
+    def pages(self) -> list[Surface]: ...
+    def add(self, surface: Surface) -> Surface: ...
+    def add_all(self, surfaces: Iterable[Surface]) -> list[Surface]: ...
+    def locate(self, region: Surface) -> tuple[int, Rect]: ...
+    def get_textures(self, renderer: Renderer) -> list[Texture]: ...
@@ -16,6 +16,10 @@ def get_error() -> str: ...
 def set_error(error_msg: str, /) -> None: ...
 def get_sdl_version(linked: bool = True) -> tuple[int, int, int]: ...
 def get_sdl_byteorder() -> int: ...
+def set_num_threads(
+    num_threads: int, threshold: int | None = None
+) -> tuple[int, int]: ...
+def get_num_threads() -> int: ...
 def register_quit(callable: Callable[[], Any], /) -> None: ...
 
 # undocumented part of pygame API, kept here to make stubtest happy
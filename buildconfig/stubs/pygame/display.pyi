@@ -340,7 +340,13 @@ def update(*args):  # type: ignore
     This call cannot be used on ``pygame.OPENGL`` displays and will generate an
     exception.
 
+    If dirty rect tracking is turned on for the display Surface (see
+    :meth:`pygame.Surface.set_dirty_tracking`), calling ``update()`` without
+    arguments only updates the areas that changed since the last update, and then
+    clears them. ``pygame.display.flip()`` still updates everything.
+
     .. versionchanged:: 2.5.1 Added support for passing an iterable, previously only sequence was allowed
+    .. versionchanged:: 2.5.7 Uses the dirty rects of the display Surface when it tracks them
     """
 
 def get_driver() -> str:
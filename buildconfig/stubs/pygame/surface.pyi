@@ -10,7 +10,10 @@ from pygame.typing import (
     RectLike,
     SequenceLike,
 )
-from typing_extensions import deprecated  # added in 3.13
+from typing_extensions import (
+    Buffer,  # collections.abc 3.12
+    deprecated,  # added in 3.13
+)
 
 _ViewKind: TypeAlias = Literal[
     "0",
@@ -190,7 +193,10 @@ class Surface:
             - The blit is ignored if the ``source`` is positioned completely outside this ``Surface``'s
               clipping area. Otherwise only the overlapping area will be drawn.
 
+            - Large blits can be split over multiple threads, see :func:`pygame.set_num_threads`.
+
         .. versionchanged:: 2.5.1 The dest argument is optional and defaults to (0, 0)
+        .. versionchanged:: 2.5.7 Large blits can run on multiple threads
         """
 
     def blits(
@@ -255,7 +261,7 @@ class Surface:
 
     def fblits(
         self,
-        blit_sequence: Iterable[tuple[Surface, Point | RectLike]],
+        blit_sequence: Iterable[tuple[Surface, Point | RectLike]] | BlitBatch,
         special_flags: int = 0,
         /,
     ) -> None:
@@ -279,7 +285,171 @@ class Surface:
             optimizations are applied if blit_sequence is a list or a tuple (using one
             of them is recommended).
 
+        .. note:: ``blit_sequence`` can also be a :class:`BlitBatch`. Its blits were
+            already checked when they were added, so nothing has to be parsed when
+            drawing it. Blits of the batch that were added without special_flags
+            use the ``special_flags`` passed here.
+
         .. versionadded:: 2.1.4
+        .. versionchanged:: 2.5.7 Accepts a :class:`BlitBatch`
+        """
+
+    def blit_transformed(
+        self,
+        source: Surface,
+        dest: Point | RectLike,
+        angle: float = 0,
+        scale: float = 1,
+        flip_x: bool = False,
+        flip_y: bool = False,
+        special_flags: int = 0,
+        smooth: bool = True,
+    ) -> Rect:
+        """Draw a rotated, scaled and flipped image onto this Surface.
+
+        Draws ``source`` flipped first, then rotated counterclockwise by
+        ``angle`` degrees and scaled by ``scale``, without creating any
+        intermediate Surface. The bounding box of the result is placed with
+        its top left corner at ``dest``.
+
+        The bounding box is the smallest one holding the transformed source,
+        so it can be a pixel or two smaller than the Surface returned by
+        `pygame.transform.rotozoom()`, which rounds its size up to even
+        numbers. The image is the same as the one of
+        ``transform.rotozoom(transform.flip(source, flip_x, flip_y), angle,
+        scale)`` centered on the bounding box, up to the filtering of the
+        edges. For multiples of 90 degrees without scaling it matches
+        `pygame.transform.rotate()` exactly.
+
+        Only the pixels of the bounding box inside the clip area of this
+        Surface are computed, each of them by mapping it back onto the source.
+        With ``smooth`` the source is sampled with bilinear filtering,
+        otherwise the nearest pixel is used.
+
+        The result is blended like `blit()` does, honouring the per pixel
+        alpha, surface alpha and colorkey of the source and ``special_flags``.
+        Sources that are not 32 bit are converted before they are drawn.
+
+        :param source: the Surface to draw
+        :param dest: the top left corner of the bounding box, as a position or
+            a rect
+        :param angle: the counterclockwise rotation in degrees
+        :param scale: the scale factor, must be positive
+        :param flip_x: whether to flip the source horizontally
+        :param flip_y: whether to flip the source vertically
+        :param special_flags: the blend mode, see :doc:`special_flags_list`
+        :param smooth: whether to use bilinear filtering
+
+        :returns: the area of this Surface that was drawn on, clipped to the
+            clip area
+
+        .. versionadded:: 2.5.7
+        """
+
+    def blit_tiled(
+        self,
+        source: Surface,
+        dest: RectLike,
+        offset: Point = (0, 0),
+        special_flags: int = 0,
+    ) -> Rect:
+        """Fill an area of this Surface with copies of a Surface.
+
+        Repeats ``source`` over the ``dest`` rect, like a series of `blit()`
+        calls in a grid would, trimming the copies on the edges of the rect.
+        ``offset`` is the position in the pattern drawn at the top left corner
+        of ``dest``, so that scrolling a background only needs a new offset.
+
+        :param source: the Surface to repeat
+        :param dest: the area to fill
+        :param offset: the position in ``source`` drawn at the top left of
+            ``dest``, wrapped around the size of ``source``
+        :param special_flags: the blend mode, see :doc:`special_flags_list`
+
+        :returns: the area of this Surface that was drawn on, clipped to the
+            clip area
+
+        .. versionadded:: 2.5.7
+        """
+
+    def blit_nine_slice(
+        self,
+        source: Surface,
+        dest: RectLike,
+        borders: int | tuple[int, int, int, int],
+        mode: Literal["stretch", "tile"] = "stretch",
+        special_flags: int = 0,
+    ) -> Rect:
+        """Draw a Surface resized to a rect, keeping its borders intact.
+
+        Cuts ``source`` in nine pieces along ``borders`` and draws them to fill
+        ``dest``, the way resizable panels and buttons are usually drawn. The
+        four corners are drawn unchanged, the top and bottom edges are resized
+        horizontally, the left and right edges vertically and the center in
+        both directions. With ``mode`` ``"stretch"`` the pieces are scaled
+        with nearest neighbour sampling, with ``"tile"`` they are repeated and
+        trimmed instead.
+
+        When ``dest`` is smaller than the borders, the borders are shrunk in
+        proportion and the corners are scaled down.
+
+        No subsurfaces or scaled Surfaces are created, and the pieces are
+        blended like `blit()` does.
+
+        :param source: the Surface to draw
+        :param dest: the area to fill
+        :param borders: the width of the left, top, right and bottom borders
+            of ``source``, or a single width for all four
+        :param mode: ``"stretch"`` or ``"tile"``
+        :param special_flags: the blend mode, see :doc:`special_flags_list`
+
+        :returns: the area of this Surface that was drawn on, clipped to the
+            clip area
+
+        :raises ValueError: if the borders are negative or do not fit in
+            ``source``
+
+        .. versionadded:: 2.5.7
+        """
+
+    def blit_tilemap(
+        self,
+        tileset: Surface,
+        tile_size: Point,
+        tiles: Any,
+        offset: Point = (0, 0),
+        viewport: RectLike | None = None,
+        special_flags: int = 0,
+    ) -> Rect:
+        """Draw the visible part of a grid of tiles onto this Surface.
+
+        ``tiles`` is a 2D array of tile indices supporting the buffer protocol,
+        for example a ``numpy`` array or an ``array`` memoryview cast to a 2D
+        shape, indexed as ``tiles[row][column]``. Its items are usually
+        ``uint16`` but any integer type is accepted. Tile ``n`` is the ``n``-th
+        ``tile_size`` cell of ``tileset``, counting from the top left corner
+        row by row. Indices that are negative or past the last tile of
+        ``tileset`` (such as ``65535``) leave their cell empty.
+
+        The map is drawn inside ``viewport``, the whole Surface by default,
+        scrolled so that pixel ``offset`` of the map is at the top left corner
+        of the viewport. Only the tiles overlapping the viewport and the clip
+        area are drawn, each of them blended like `blit()` does.
+
+        :param tileset: the Surface holding the tile images
+        :param tile_size: the width and height of a tile in pixels
+        :param tiles: the 2D array of tile indices
+        :param offset: the map pixel drawn at the top left of the viewport
+        :param viewport: the area of this Surface to draw the map in
+        :param special_flags: the blend mode, see :doc:`special_flags_list`
+
+        :returns: the area of this Surface that was drawn on, the viewport
+            clipped to the clip area
+
+        .. seealso:: :class:`pygame.TileLayer` caches the drawn tiles in
+            chunks for layers that do not change.
+
+        .. versionadded:: 2.5.7
         """
 
     @overload
@@ -344,8 +514,17 @@ class Surface:
         If the Surface is a subsurface, the returned Surface will *not* retain
         the parent and will be a regular Surface with its own pixel data.
 
+        The pixels are copied lazily: the copy shares them with the original
+        until either Surface is drawn on, blitted to or locked, at which point
+        the pixels are duplicated. Copying a Surface that is itself such a
+        copy, or that is locked, RLE accelerated or palettized, duplicates the
+        pixels right away.
+
         .. versionadded:: 2.3.1
             Added support for deepcopy by implementing __deepcopy__, calls copy() internally.
+
+        .. versionchanged:: 2.5.7
+            The pixels are only duplicated when one of the Surfaces is modified.
         """
 
     def fill(
@@ -375,6 +554,84 @@ class Surface:
             part of the ``Rect`` overlapping the window's ``Rect`` will be filled.
         """
 
+    def fill_rects(
+        self,
+        color: ColorLike | SequenceLike[ColorLike] | Any,
+        rects: SequenceLike[RectLike] | Any,
+        special_flags: int = 0,
+    ) -> Rect:
+        """Fill many rectangles with solid colors.
+
+        Fills each rect of ``rects`` like `fill()` would, clipping all of them
+        in one call, which is much faster for heatmaps, grids or debug overlays
+        made of thousands of cells.
+
+        ``rects`` is a sequence of rect style objects, or an array of numbers
+        supporting the buffer protocol with a shape of ``(n, 4)`` or
+        ``(n * 4,)`` holding ``x, y, w, h`` for each rect.
+
+        ``color`` is either a single color for all the rects, or one color per
+        rect: a sequence of ``len(rects)`` colors, or a ``uint8`` array with a
+        shape of ``(len(rects), 3)`` or ``(len(rects), 4)``. A sequence that is
+        a valid color by itself, like ``(255, 0, 0)``, is taken as a single
+        color.
+
+        The special_flags argument controls how the colors are combined. See
+        :doc:`special_flags_list` for a list of possible values.
+
+        :returns: the bounding rect of the filled areas, with a size of 0 when
+            nothing was filled
+
+        .. versionadded:: 2.5.7
+        """
+
+    def fill_gradient(
+        self,
+        rect: RectLike | None,
+        stops: SequenceLike[ColorLike | tuple[float, ColorLike]],
+        kind: Literal["linear", "radial", "conic"] = "linear",
+        angle: float = 0,
+        special_flags: int = 0,
+    ) -> Rect:
+        """Fill a rectangle with a gradient.
+
+        Fills ``rect``, or the whole Surface if it is ``None``, with a gradient
+        going through the colors of ``stops``. Like `fill()`, the colors replace
+        the pixels, including their alpha. The colors are computed one row at a
+        time straight into the Surface, so a gradient can be composited with
+        ``special_flags`` without drawing it on an intermediate Surface first.
+
+        ``stops`` is a sequence of colors spread evenly over the gradient. Any
+        of them may instead be a ``(position, color)`` pair placing the color at
+        a position between 0 (the start of the gradient) and 1 (its end), the
+        positions must not decrease. The colors are interpolated between the
+        stops, and the first and last colors extend to the ends of the gradient.
+
+        ``kind`` selects the shape of the gradient:
+
+            * ``'linear'``: the colors change along the direction of ``angle``,
+              in degrees counterclockwise from the left to right direction. The
+              gradient starts and ends at the corners of ``rect`` furthest
+              along that direction.
+            * ``'radial'``: the colors change from the center of ``rect`` to
+              the edge of the ellipse fitting in it, the pixels outside the
+              ellipse get the last color. ``angle`` is not used.
+            * ``'conic'``: the colors change counterclockwise around the center
+              of ``rect``, starting and ending in the direction of ``angle``.
+
+        The part of ``rect`` outside the clip area of the Surface is not drawn,
+        but the gradient keeps the shape of the whole ``rect``.
+
+        The special_flags argument controls how the colors are combined with
+        the pixels, the same way as for `fill()`. See :doc:`special_flags_list`
+        for a list of possible values.
+
+        :returns: the area of the Surface that was drawn on, with a size of 0
+            when nothing was drawn
+
+        .. versionadded:: 2.5.7
+        """
+
     def scroll(self, dx: int = 0, dy: int = 0, scroll_flag: int = 0, /) -> None:
         """Shift the Surface pixels in place.
 
@@ -1018,6 +1275,93 @@ class Surface:
         .. versionadded:: 2.5.1
         """
 
+    def set_dirty_tracking(self, enabled: bool = True, /) -> None:
+        """Turn recording of the changed areas of the Surface on or off.
+
+        When dirty rect tracking is on, the Surface records the areas changed by
+        :meth:`blit`, :meth:`blits`, :meth:`fblits`, :meth:`fill`, :meth:`scroll`,
+        the :mod:`pygame.draw` functions and the :mod:`pygame.transform` functions
+        writing into a ``dest_surface``. Overlapping and touching areas are merged,
+        and the number of separate areas is kept small.
+
+        Changes to a subsurface are also recorded by its parent Surfaces that track
+        them, in the coordinates of the parent.
+
+        The recorded areas can be read with :meth:`get_dirty_rects`. If this Surface
+        is the display Surface, ``pygame.display.update()`` called without
+        arguments only updates these areas.
+
+        Direct pixel access (e.g. :meth:`set_at`, :class:`pygame.PixelArray` or
+        :mod:`pygame.surfarray`) is not recorded.
+
+        Turning tracking off forgets the recorded areas.
+
+        .. versionadded:: 2.5.7
+        """
+
+    def get_dirty_tracking(self) -> bool:
+        """Test if the changed areas of the Surface are recorded.
+
+        Returns ``True`` if dirty rect tracking was turned on with
+        :meth:`set_dirty_tracking`.
+
+        .. versionadded:: 2.5.7
+        """
+
+    def get_dirty_rects(self) -> list[Rect]:
+        """Get the areas of the Surface changed since the last clear.
+
+        Returns a list of :class:`Rect` objects covering every area changed since
+        tracking was turned on or :meth:`clear_dirty` was last called. The list is
+        empty if tracking is off.
+
+        .. versionadded:: 2.5.7
+        """
+
+    def clear_dirty(self) -> None:
+        """Forget the recorded changed areas of the Surface.
+
+        Tracking stays on. ``pygame.display.update()`` and
+        ``pygame.display.flip()`` call this for the display Surface.
+
+        .. versionadded:: 2.5.7
+        """
+
+    def set_span_encoding(self, enabled: bool = True, /) -> None:
+        """Turn the span encoding of the visible pixels of the Surface on or off.
+
+        A span encoded Surface keeps, for every row, the runs of its pixels that
+        are not fully transparent. Blitting it without ``special_flags`` skips the
+        fully transparent pixels and copies runs of fully opaque pixels directly,
+        which makes mostly empty sprites much cheaper to draw. Only the remaining
+        translucent pixels are blended. This is similar to the ``RLEACCEL`` flag,
+        but also covers blits of per pixel alpha Surfaces done by pygame.
+
+        The encoding is used for 32 bit Surfaces with per pixel alpha, and for 32
+        bit Surfaces with a colorkey blitted to a Surface of the same pixel format.
+        Other blits from the Surface work as usual. The result of a blit is the
+        same with and without the encoding.
+
+        The runs are built by the first blit from the Surface and rebuilt after
+        its pixels, colorkey or alpha change. Locking the Surface, which also
+        happens for :meth:`get_at`, :meth:`set_at` and pixel arrays, counts as a
+        change, so the encoding pays off for Surfaces that are blitted far more
+        often than they are modified.
+
+        Subsurfaces can not be span encoded, a ``ValueError`` is raised.
+
+        .. versionadded:: 2.5.7
+        """
+
+    def get_span_encoding(self) -> bool:
+        """Test if the visible pixels of the Surface are span encoded.
+
+        Returns ``True`` if span encoding was turned on with
+        :meth:`set_span_encoding`.
+
+        .. versionadded:: 2.5.7
+        """
+
     @property
     def width(self) -> int:
         """Surface width in pixels (read-only).
@@ -1053,5 +1397,103 @@ class Surface:
         .. versionaddedold:: 1.9.2
         """
 
+class BlitBatch:
+    """Pygame object for storing a reusable sequence of blits.
+
+    A BlitBatch keeps a packed list of blits, each made of a source Surface,
+    a destination position, an optional area of the source and optional
+    special_flags. The items are checked once, when they are added, so drawing
+    the batch with :meth:`Surface.fblits` does not have to look at any Python
+    objects. This makes it the fastest way to draw the same set of Surfaces
+    every frame, e.g. thousands of sprites that only change position.
+
+    ``blit_sequence`` takes the same ``(source, dest, area, special_flags)``
+    items as :meth:`Surface.blits`, where ``area`` and ``special_flags`` are
+    optional.
+
+    The positions of all the blits can be changed at once with
+    :meth:`set_positions`, which can read them directly from a NumPy array or
+    any other object supporting the buffer protocol.
+
+    ::
+
+        batch = pygame.BlitBatch([(bullet_image, pos) for pos in positions])
+        while running:
+            ...
+            batch.set_positions(positions_array)
+            screen.fblits(batch)
+
+    The batch keeps a reference to every source Surface until it is cleared.
+
+    .. versionadded:: 2.5.7
+    """
+
+    def __init__(
+        self,
+        blit_sequence: Iterable[
+            tuple[Surface, Point | RectLike]
+            | tuple[Surface, Point | RectLike, RectLike | None]
+            | tuple[Surface, Point | RectLike, RectLike | None, int]
+        ] = (),
+    ) -> None: ...
+    def __len__(self) -> int: ...
+    def append(
+        self,
+        source: Surface,
+        dest: Point | RectLike,
+        area: RectLike | None = None,
+        special_flags: int = 0,
+    ) -> None:
+        """Add a single blit to the end of the batch.
+
+        Adds a blit of ``source`` at ``dest``. Like in :meth:`Surface.blit`,
+        ``area`` is the portion of ``source`` to draw and defaults to the whole
+        Surface. ``special_flags`` defaults to ``0``, which means the flags passed
+        to :meth:`Surface.fblits` are used for this blit.
+
+        .. versionadded:: 2.5.7
+        """
+
+    def extend(
+        self,
+        blit_sequence: Iterable[
+            tuple[Surface, Point | RectLike]
+            | tuple[Surface, Point | RectLike, RectLike | None]
+            | tuple[Surface, Point | RectLike, RectLike | None, int]
+        ],
+        /,
+    ) -> None:
+        """Add many blits to the end of the batch.
+
+        Takes the same ``(source, dest, area, special_flags)`` items as the
+        constructor.
+
+        .. versionadded:: 2.5.7
+        """
+
+    def clear(self) -> None:
+        """Remove all blits from the batch.
+
+        Removes all the blits and releases the source Surfaces. The memory of the
+        batch is kept, so refilling it afterwards is cheap.
+
+        .. versionadded:: 2.5.7
+        """
+
+    def set_positions(self, positions: Buffer | SequenceLike[Point], /) -> None:
+        """Update the destination of every blit in the batch at once.
+
+        ``positions`` holds one ``(x, y)`` position per blit, in the order the
+        blits were added. It can be a sequence of pairs, or an object supporting
+        the buffer protocol (like a NumPy array) with a shape of ``(n, 2)`` or
+        ``(n * 2,)`` and an integer or floating point item type. Floating point
+        positions are truncated. Arrays are read directly, without creating any
+        Python objects.
+
+        Raises ``ValueError`` if the number of positions is not ``len(batch)``.
+
+        .. versionadded:: 2.5.7
+        """
+
 @deprecated("Use `Surface` instead (SurfaceType is an old alias)")
 class SurfaceType(Surface): ...
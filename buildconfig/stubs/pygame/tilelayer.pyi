@@ -0,0 +1,30 @@
+from typing import Any
+
+from pygame.rect import Rect
+from pygame.surface import Surface
+from pygame.typing import IntPoint, Point, RectLike
+
+class TileLayer:
+    tileset: Surface
+    tiles: Any
+    def __init__(
+        self,
+        tileset: Surface,
+        tile_size: IntPoint,
+        tiles: Any,
+        chunk_size: IntPoint | None = None,
+    ) -> None: ...
+    @property
+    def tile_size(self) -> tuple[int, int]: ...
+    @property
+    def chunk_size(self) -> tuple[int, int] | None: ...
+    @property
+    def size(self) -> tuple[int, int]: ...
+    def invalidate(self, area: RectLike | None = None) -> None: ...
+    def draw(
+        self,
+        surface: Surface,
+        offset: Point = (0, 0),
+        viewport: RectLike | None = None,
+        special_flags: int = 0,
+    ) -> Rect: ...
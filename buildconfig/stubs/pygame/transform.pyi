@@ -33,6 +33,7 @@ def scale(
     surface: Surface,
     size: Point,
     dest_surface: Surface | None = None,
+    filter: Literal["nearest", "bilinear", "bicubic", "lanczos3"] = "nearest",
 ) -> Surface:
     """Resize to new resolution.
 
@@ -43,15 +44,28 @@ def scale(
     Surface. This destination surface must be the same as the size (width, height) passed
     in, and the same depth and format as the source Surface.
 
+    The ``filter`` argument picks how the new pixels are sampled. ``"nearest"``,
+    the default, copies the nearest source pixel. ``"bilinear"``, ``"bicubic"`` and
+    ``"lanczos3"`` blend the source pixels around each new pixel, from the softest
+    to the sharpest result, with the filter widened when shrinking so that every
+    source pixel counts. These three only work with 24 and 32 bit surfaces, and
+    ``"bicubic"`` and ``"lanczos3"`` can slightly overshoot next to sharp edges,
+    which gives the typical halos of these filters. Like :func:`smoothscale()`,
+    they treat the alpha channel like the color channels, so the colors of fully
+    transparent pixels bleed into the visible ones next to them.
+
     .. versionchanged:: 2.2.1 internal scaling algorithm was replaced with a nearly
         equivalent one that is 40% faster. Scale results will be very slightly
         different.
+
+    .. versionchanged:: 2.5.7 Added the ``filter`` argument.
     """
 
 def scale_by(
     surface: Surface,
     factor: float | SequenceLike[float],
     dest_surface: Surface | None = None,
+    filter: Literal["nearest", "bilinear", "bicubic", "lanczos3"] = "nearest",
 ) -> Surface:
     """Resize to new resolution, using scalar(s).
 
@@ -66,7 +80,11 @@ def scale_by(
     Surface. This destination surface must have the scaled dimensions
     (width * factor, height * factor) and same depth and format as the source Surface.
 
+    ``filter`` works like in :func:`scale()`.
+
     .. versionadded:: 2.1.3
+
+    .. versionchanged:: 2.5.7 Added the ``filter`` argument.
     """
 
 def rotate(surface: Surface, angle: float) -> Surface:
@@ -106,6 +124,56 @@ def scale2x(surface: Surface, dest_surface: Surface | None = None) -> Surface:
     An optional destination surface can be passed which is faster than creating a new
     Surface. This destination surface must have double the dimensions
     (width * 2, height * 2) and same depth and format as the source Surface.
+
+    .. versionchanged:: 2.5.7 Large surfaces are scaled on several threads
+        when enabled with :func:`pygame.set_num_threads`.
+    """
+
+def scale3x(surface: Surface, dest_surface: Surface | None = None) -> Surface:
+    """Specialized image tripler.
+
+    This will return a new image that is three times the size of the original.
+    It uses the AdvanceMAME Scale3X algorithm, the three times larger version of
+    :func:`scale2x()`. Like it, it only copies pixels of the source, so it works
+    with surfaces of any bit depth.
+
+    An optional destination surface can be passed which is faster than creating a new
+    Surface. This destination surface must have three times the dimensions
+    (width * 3, height * 3) and same depth and format as the source Surface.
+
+    .. versionadded:: 2.5.7
+    """
+
+def scale4x(surface: Surface, dest_surface: Surface | None = None) -> Surface:
+    """Specialized image quadrupler.
+
+    This will return a new image that is four times the size of the original.
+    It uses the AdvanceMAME Scale4X algorithm, which is :func:`scale2x()` applied
+    twice. Like it, it only copies pixels of the source, so it works with
+    surfaces of any bit depth.
+
+    An optional destination surface can be passed which is faster than creating a new
+    Surface. This destination surface must have four times the dimensions
+    (width * 4, height * 4) and same depth and format as the source Surface.
+
+    .. versionadded:: 2.5.7
+    """
+
+def xbr2x(surface: Surface, dest_surface: Surface | None = None) -> Surface:
+    """Edge blending image doubler.
+
+    This will return a new image that is double the size of the original. It
+    uses the 2xBR algorithm, which follows the edges between areas of different
+    colors like :func:`scale2x()`, but blends the pixels along them for smoother
+    diagonals and curves. The result contains colors that are not in the
+    source, so this function only works for 24-bit or 32-bit surfaces. A
+    ``ValueError`` will be thrown if the input surface bit depth is less than 24.
+
+    An optional destination surface can be passed which is faster than creating a new
+    Surface. This destination surface must have double the dimensions
+    (width * 2, height * 2) and same depth and format as the source Surface.
+
+    .. versionadded:: 2.5.7
     """
 
 def smoothscale(
@@ -130,6 +198,9 @@ def smoothscale(
     .. versionchanged:: 2.4.0 now uses SSE2/NEON SIMD for acceleration on x86
         and ARM machines, a performance improvement over previous MMX/SSE only
         supported on x86.
+
+    .. versionchanged:: 2.5.7 Large surfaces are scaled on several threads
+        when enabled with :func:`pygame.set_num_threads`.
     """
 
 def smoothscale_by(
@@ -154,8 +225,54 @@ def smoothscale_by(
     .. versionadded:: 2.1.3
     """
 
-def get_smoothscale_backend() -> Literal["GENERIC", "SSE2", "NEON"]:
-    """Return smoothscale filter version in use: 'GENERIC', 'MMX', 'SSE', 'SSE2', or 'NEON'.
+def build_mipmaps(surface: Surface, levels: int = -1) -> list[Surface]:
+    """Build a chain of half size copies of a surface.
+
+    Returns a list starting with ``surface`` itself, followed by copies of it that
+    are each half the width and height of the one before. Each pixel of a copy is
+    the rounded average of the 2x2 block of pixels it covers. Odd sizes are
+    rounded down, and a side stops halving once it is 1 pixel long.
+
+    For surfaces with per pixel alpha the colors are averaged weighted by their
+    alpha, like premultiplied colors would be, so that the color of transparent
+    pixels does not bleed into the opaque pixels next to them. The alpha itself is
+    the plain average.
+
+    ``levels`` is the number of half size copies to make. The chain stops early
+    at a 1x1 surface, and a negative value makes copies all the way down to it.
+
+    Scaling the same large surface down to many sizes with :func:`smoothscale()`
+    pays for the whole surface every time. Building the chain once and scaling
+    with :func:`scale_mipmapped()` instead only filters a level at most twice
+    the size of the result.
+
+    This function only works for 24-bit or 32-bit surfaces. A ``ValueError`` will
+    be thrown if the input surface bit depth is less than 24.
+
+    .. versionadded:: 2.5.7
+    """
+
+def scale_mipmapped(
+    chain: SequenceLike[Surface],
+    size: Point,
+    dest_surface: Surface | None = None,
+) -> Surface:
+    """Scale a surface to an arbitrary size using a chain of mipmaps.
+
+    Takes a chain of surfaces from :func:`build_mipmaps()` and scales the smallest
+    of them that is at least ``size`` in both dimensions to ``size`` with the
+    ``'bilinear'`` filter of :func:`scale()`. The largest surface of the chain is
+    used when none is big enough.
+
+    An optional destination surface can be passed which is faster than creating a new
+    Surface. This destination surface must be the same as the size (width, height) passed
+    in, and the same depth and format as the surfaces of the chain.
+
+    .. versionadded:: 2.5.7
+    """
+
+def get_smoothscale_backend() -> Literal["GENERIC", "SSE2", "AVX2", "NEON"]:
+    """Return smoothscale filter version in use: 'GENERIC', 'MMX', 'SSE', 'SSE2', 'AVX2', or 'NEON'.
 
     Shows whether or not smoothscale is using SIMD acceleration.
     If no acceleration is available then "GENERIC" is returned. The level of
@@ -164,10 +281,14 @@ def get_smoothscale_backend() -> Literal["GENERIC", "SSE2", "NEON"]:
     This function is provided for pygame testing and debugging.
 
     .. versionchanged:: 2.4.0 Added SSE2 and NEON backends, MMX and SSE are deprecated.
+
+    .. versionchanged:: 2.5.7 Added the AVX2 backend.
     """
 
-def set_smoothscale_backend(backend: Literal["GENERIC", "SSE2", "NEON"]) -> None:
-    """Set smoothscale filter version to one of: 'GENERIC', 'MMX', 'SSE', 'SSE2', or 'NEON'.
+def set_smoothscale_backend(
+    backend: Literal["GENERIC", "SSE2", "AVX2", "NEON"],
+) -> None:
+    """Set smoothscale filter version to one of: 'GENERIC', 'MMX', 'SSE', 'SSE2', 'AVX2', or 'NEON'.
 
     Sets smoothscale acceleration. Takes a string argument. A value of 'GENERIC'
     turns off acceleration. A value error is raised if type is not
@@ -178,6 +299,39 @@ def set_smoothscale_backend(backend: Literal["GENERIC", "SSE2", "NEON"]) -> None
     be reported. Use this function as a temporary fix only.
 
     .. versionchanged:: 2.4.0 Added SSE2 and NEON backends, MMX and SSE are deprecated.
+
+    .. versionchanged:: 2.5.7 Added the AVX2 backend.
+    """
+
+def get_pool_stats() -> dict[str, int]:
+    """Return statistics about the pool of recycled transform surfaces.
+
+    The Surfaces returned by most transforms come from a pool. When such a
+    Surface is deleted, its pixels are kept in the pool and reused by the next
+    transform returning a Surface of the same size and format, which saves
+    memory allocations when the same transforms run every frame. Rotated
+    Surfaces from :func:`rotozoom` and Surfaces passed as ``dest_surface`` are
+    not pooled.
+
+    Returns a dictionary with the keys ``"hits"`` and ``"misses"``, the number
+    of pooled Surfaces that were reused or had to be allocated, ``"count"`` and
+    ``"bytes"``, the number and total pixel size of the Surfaces currently kept
+    in the pool, and ``"budget"``, see :func:`set_pool_budget`.
+
+    The pool is emptied by :func:`pygame.quit`.
+
+    .. versionadded:: 2.5.7
+    """
+
+def set_pool_budget(budget: int) -> None:
+    """Set how many bytes of pixels the pool of recycled transform surfaces may keep.
+
+    When keeping a Surface would go over ``budget`` bytes, the Surfaces kept
+    for the longest time are freed first. Surfaces larger than the budget are
+    never kept, and a budget of 0 disables the pool. The default budget is 32
+    MiB. Raises ``ValueError`` if ``budget`` is negative.
+
+    .. versionadded:: 2.5.7
     """
 
 def chop(surface: Surface, rect: RectLike) -> Surface:
@@ -235,6 +389,7 @@ def gaussian_blur(
     radius: int,
     repeat_edge_pixels: bool = True,
     dest_surface: Surface | None = None,
+    mode: Literal["exact", "fast"] = "exact",
 ) -> Surface:
     """Blur a surface using gaussian blur.
 
@@ -248,6 +403,11 @@ def gaussian_blur(
     Surface. This destination surface must have the same dimensions (width, height) and
     depth and format as the source Surface.
 
+    With ``mode="fast"`` the gaussian blur is approximated by three box blurs in a
+    row, sized to match the standard deviation. This is much faster for large
+    radii, as the cost per pixel no longer grows with the radius, and the result
+    only differs slightly from the default ``"exact"`` mode.
+
     .. versionadded:: 2.2.0
 
     .. versionchanged:: 2.3.0
@@ -259,6 +419,111 @@ def gaussian_blur(
 
     .. versionchanged:: 2.5.0
         A surface with either width or height equal to 0 won't raise a ``ValueError``
+
+    .. versionchanged:: 2.5.7 Added the ``mode`` argument.
+    """
+
+def convolve(
+    surface: Surface,
+    kernel: SequenceLike[SequenceLike[float]],
+    dest_surface: Surface | None = None,
+    separable: bool | None = None,
+    border: Literal["clamp", "wrap", "zero"] = "clamp",
+) -> Surface:
+    """Apply a convolution kernel to a surface.
+
+    Returns a surface where each pixel is the sum of the pixels around it in
+    ``surface``, weighted by ``kernel``. This runs sharpen, emboss, edge detection
+    and other filters without a round trip through :mod:`pygame.surfarray`.
+
+    ``kernel`` is a sequence of rows of weights, all of the same length.
+    ``kernel[j][i]`` weights the pixel at ``(x + i - len(kernel[0]) // 2,
+    y + j - len(kernel) // 2)`` for the pixel at ``(x, y)``, so the weight in the
+    middle of the kernel applies to the pixel itself. The kernel is not flipped,
+    which makes this a correlation like most image filters use: flip the rows and
+    columns of the kernel for a convolution in the mathematical sense. The weights
+    are used as they are: divide them by their sum to keep the brightness of the
+    surface.
+    Results are rounded and clipped to the range 0 to 255, and the weights are
+    converted to fixed point, so very small weights lose precision and a
+    ``ValueError`` is raised for kernels whose weights are too large.
+
+    Only the color channels are filtered, the alpha of the source surface is kept.
+    This function only works for 24 and 32 bit surfaces.
+
+    A kernel that is the product of a column and a row of weights, like a box or
+    a gaussian blur, is applied as a column pass and a row pass, which is much
+    faster for large kernels. With ``separable=None`` such kernels are detected,
+    ``True`` raises a ``ValueError`` for kernels that are not separable and
+    ``False`` always applies the kernel as a whole.
+
+    ``border`` picks the pixels used past the edges of the surface: ``"clamp"``
+    repeats the edge pixels, ``"wrap"`` takes them from the opposite edge and
+    ``"zero"`` leaves them out.
+
+    An optional destination surface can be passed which is faster than creating a new
+    Surface. This destination surface must have the same dimensions (width, height) and
+    depth as the source Surface, and must not share pixels with it.
+
+    .. versionadded:: 2.5.7
+    """
+
+def apply_lut(
+    surface: Surface,
+    r_lut: SequenceLike[int] | None = None,
+    g_lut: SequenceLike[int] | None = None,
+    b_lut: SequenceLike[int] | None = None,
+    a_lut: SequenceLike[int] | None = None,
+    dest_surface: Surface | None = None,
+) -> Surface:
+    """Map each channel of a surface through a lookup table.
+
+    Returns a surface where each red value ``r`` of ``surface`` is replaced by
+    ``r_lut[r]``, and likewise for the green, blue and alpha channels. A lookup
+    table is a sequence of 256 integers from 0 to 255, such as a ``bytes`` object,
+    and ``None`` leaves the channel as it is. The alpha table is ignored for
+    surfaces without per pixel alpha.
+
+    Any number of per channel adjustments, like curves, levels, gamma or
+    posterization, can be folded into one table for each channel and applied in a
+    single pass, since ``lut2[lut1[v]]`` is itself a lookup table.
+
+    An optional destination surface can be passed which is faster than creating a new
+    Surface. This destination surface must have the same dimensions (width, height)
+    as the source Surface, and may be the source Surface itself.
+
+    .. versionadded:: 2.5.7
+    """
+
+def color_matrix(
+    surface: Surface,
+    matrix: SequenceLike[SequenceLike[float]],
+    dest_surface: Surface | None = None,
+) -> Surface:
+    """Transform the colors of a surface with a 4x5 matrix.
+
+    Returns a surface where the red, green, blue and alpha of each pixel are
+    computed from the pixel in ``surface``, with one row of ``matrix`` for each of
+    them. The first four numbers of a row weight the red, green, blue and alpha of
+    the source pixel, and the fifth is added to the sum, so that the new red is::
+
+        m[0][0] * r + m[0][1] * g + m[0][2] * b + m[0][3] * a + m[0][4]
+
+    Results are rounded and clipped to the range 0 to 255. The weights must be
+    between -8 and 8, and are applied in fixed point with 12 fraction bits. The
+    alpha of surfaces without per pixel alpha is taken as 255, and their alpha row
+    is ignored.
+
+    Grayscale, sepia, inversion, channel swaps, brightness, contrast and
+    saturation are all color matrices, and a chain of them can be folded into a
+    single pass by multiplying their matrices, extended to 5x5 with a last row of
+    ``(0, 0, 0, 0, 1)``.
+
+    An optional destination surface can be passed which is faster than creating a new
+    Surface. This destination surface must have the same dimensions (width, height)
+    as the source Surface, and may be the source Surface itself.
+
+    .. versionadded:: 2.5.7
     """
 
 def average_surfaces(
@@ -458,6 +723,9 @@ def hsl(
         new_surf = hsl(original_surf, 30, 0.2, -0.1)
 
     .. versionadded:: 2.5.0
+
+    .. versionchanged:: 2.5.7 Large 24-bit and 32-bit surfaces are processed on
+        several threads when enabled with :func:`pygame.set_num_threads`.
     """
 
 def pixelate(
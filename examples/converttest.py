@@ -0,0 +1,76 @@
+#!/usr/bin/env python
+"""pygame.examples.converttest
+
+Times Surface.convert() and Surface.convert_alpha() between the common 24 and
+32 bit pixel formats.
+
+"""
+
+import sys
+import time
+
+import pygame
+
+FORMATS = {
+    "RGB24": (0, 24, (0xFF0000, 0xFF00, 0xFF, 0)),
+    "BGR24": (0, 24, (0xFF, 0xFF00, 0xFF0000, 0)),
+    "XRGB8888": (0, 32, (0xFF0000, 0xFF00, 0xFF, 0)),
+    "XBGR8888": (0, 32, (0xFF, 0xFF00, 0xFF0000, 0)),
+    "ARGB8888": (pygame.SRCALPHA, 32, (0xFF0000, 0xFF00, 0xFF, 0xFF000000)),
+    "ABGR8888": (pygame.SRCALPHA, 32, (0xFF, 0xFF00, 0xFF0000, 0xFF000000)),
+}
+
+
+def make_surface(size, name):
+    flags, depth, masks = FORMATS[name]
+    surf = pygame.Surface(size, flags, depth, masks)
+    surf.fill((40, 120, 200, 255))
+    return surf
+
+
+def time_call(func, rounds):
+    duration = 0.0
+    for _ in range(rounds):
+        start = time.perf_counter()
+        func()
+        duration += time.perf_counter() - start
+    return duration / rounds * 1000
+
+
+def main(size=(1024, 1024), rounds=50):
+    """time pixel format conversions
+
+    Args:
+        size - size of the converted surfaces (default (1024, 1024))
+        rounds - conversions timed per format pair (default 50)
+    """
+    pygame.display.init()
+    pygame.display.set_mode((1, 1))
+
+    print(f"\nSurface Conversion Speed Test - Surface Size {str(size)}\n")
+
+    for src_name in FORMATS:
+        src = make_surface(size, src_name)
+        for dst_name in FORMATS:
+            if src_name == dst_name:
+                continue
+            dst = make_surface((1, 1), dst_name)
+            ms = time_call(lambda: src.convert(dst), rounds)
+            print(f"{src_name:>8} -> {dst_name:<8} convert: {ms:.4f} ms.")
+
+    print()
+    for src_name in FORMATS:
+        src = make_surface(size, src_name)
+        ms = time_call(src.convert, rounds)
+        print(f"{src_name:>8} convert(): {ms:.4f} ms.")
+        ms = time_call(src.convert_alpha, rounds)
+        print(f"{src_name:>8} convert_alpha(): {ms:.4f} ms.")
+
+    pygame.quit()
+
+
+if __name__ == "__main__":
+    if len(sys.argv) > 2:
+        main((int(sys.argv[1]), int(sys.argv[2])))
+    else:
+        main()
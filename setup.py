@@ -82,6 +82,13 @@ compiler_options = {
     'msvc': ('/arch:AVX2',)
 }
 
+avx512_filenames = ['simd_blitters_avx512']
+
+avx512_compiler_options = {
+    'unix': ('-mavx512f', '-mavx512bw'),
+    'msvc': ('/arch:AVX512',)
+}
+
 
 def spawn(self, cmd, **kwargs):
     should_use_avx2 = False
@@ -93,18 +100,23 @@ def spawn(self, cmd, **kwargs):
         should_use_avx2 = True
 
     if should_use_avx2:
-        extra_options = compiler_options.get(self.compiler_type)
-        if extra_options is not None:
-            # filenames are closer to the end of command line
-            for argument in reversed(cmd):
-                # Check if argument contains a filename. We must check for all
-                # possible extensions; checking for target extension is faster.
-                if not argument.endswith(self.obj_extension):
+        simd_options = (
+            (avx2_filenames, compiler_options.get(self.compiler_type)),
+            (avx512_filenames, avx512_compiler_options.get(self.compiler_type)),
+        )
+        # filenames are closer to the end of command line
+        for argument in reversed(cmd):
+            # Check if argument contains a filename. We must check for all
+            # possible extensions; checking for target extension is faster.
+            if not argument.endswith(self.obj_extension):
+                continue
+
+            # check for a filename only to avoid building a new string
+            # with variable extension
+            for filenames, extra_options in simd_options:
+                if extra_options is None:
                     continue
-
-                # check for a filename only to avoid building a new string
-                # with variable extension
-                for filename in avx2_filenames:
+                for filename in filenames:
                     off_end = -len(self.obj_extension)
                     off_start = -len(filename) + off_end
                     if argument.endswith(filename, off_start, off_end):
@@ -115,8 +127,8 @@ def spawn(self, cmd, **kwargs):
                         else:
                             cmd += extra_options
 
-                # filename is found, no need to search any further
-                break
+            # filename is found, no need to search any further
+            break
 
     distutils.ccompiler.spawn(cmd, dry_run=self.dry_run, **kwargs)
 
@@ -192,6 +204,10 @@ if consume_arg('-enable-arm-neon'):
     cflags += '-mfpu=neon'
     os.environ['CFLAGS'] = cflags
 
+# arm64 builds run the SSE2 kernels through sse2neon, this uses the
+# experimental native NEON kernels instead
+native_neon_kernels = consume_arg('-native-neon-kernels')
+
 no_compilation = bool({'docs', 'sdist', 'stubcheck'}.intersection(sys.argv))
 
 compile_cython = not no_compilation
@@ -407,6 +423,8 @@ for e in extensions:
     # Only define the ARM_NEON defines if they have been enabled at build time.
     if enable_arm_neon:
         e.define_macros.append(('PG_ENABLE_ARM_NEON', '1'))
+    if native_neon_kernels:
+        e.define_macros.append(('PG_NEON_NATIVE_KERNELS', '1'))
 
     e.extra_compile_args.extend(
         # some warnings are skipped here
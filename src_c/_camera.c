@@ -116,6 +116,9 @@ surf_colorspace(PyObject *self, PyObject *arg)
         }
     }
     else {
+        if (!pgSurface_Unshare(surfobj2)) {
+            return NULL;
+        }
         newsurf = pgSurface_AsSurface(surfobj2);
     }
 
@@ -146,6 +149,7 @@ surf_colorspace(PyObject *self, PyObject *arg)
     SDL_UnlockSurface(newsurf);
 
     if (surfobj2) {
+        pgSurface_AddDirtyRect(surfobj2, NULL);
         Py_INCREF(surfobj2);
         return (PyObject *)surfobj2;
     }
@@ -405,6 +409,9 @@ camera_get_image(pgCameraObject *self, PyObject *arg)
 #endif
     }
     else {
+        if (!pgSurface_Unshare(surfobj)) {
+            return NULL;
+        }
         surf = pgSurface_AsSurface(surfobj);
     }
 
@@ -432,6 +439,7 @@ camera_get_image(pgCameraObject *self, PyObject *arg)
     }
 
     if (surfobj) {
+        pgSurface_AddDirtyRect(surfobj, NULL);
         Py_INCREF(surfobj);
         return (PyObject *)surfobj;
     }
@@ -453,6 +461,9 @@ camera_get_image(pgCameraObject *self, PyObject *arg)
         surf = PG_CreateSurface(width, height, SDL_PIXELFORMAT_XRGB8888);
     }
     else {
+        if (!pgSurface_Unshare(surfobj)) {
+            return NULL;
+        }
         surf = pgSurface_AsSurface(surfobj);
     }
 
@@ -470,6 +481,7 @@ camera_get_image(pgCameraObject *self, PyObject *arg)
     }
 
     if (surfobj) {
+        pgSurface_AddDirtyRect(surfobj, NULL);
         Py_INCREF(surfobj);
         return (PyObject *)surfobj;
     }
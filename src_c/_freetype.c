@@ -2070,6 +2070,9 @@ _ftfont_render_to(pgFontObject *self, PyObject *args, PyObject *kwds)
         PyErr_SetString(pgExc_SDLError, "display Surface quit");
         goto error;
     }
+    if (!pgSurface_Unshare((pgSurfaceObject *)surface_obj)) {
+        goto error;
+    }
     if (_PGFT_Render_ExistingSurface(
             self->freetype, self, &render, text, surface, xpos, ypos,
             &fg_color, (bg_color_obj || self->is_bg_col_set) ? &bg_color : 0,
@@ -2077,6 +2080,7 @@ _ftfont_render_to(pgFontObject *self, PyObject *args, PyObject *kwds)
         goto error;
     }
     free_string(text);
+    pgSurface_AddDirtyRect((pgSurfaceObject *)surface_obj, &r);
 
     return pgRect_New(&r);
 
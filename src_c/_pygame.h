@@ -725,6 +725,51 @@ struct pgSubSurface_Data {
     int offsetx, offsety;
 };
 
+/* Upper bound of separately kept dirty rects, past it new rects are merged
+ * into the existing rect that grows the least. */
+#define PG_DIRTY_RECTS_MAX 32
+
+struct pgDirtyRects {
+    int count;
+    SDL_Rect rects[PG_DIRTY_RECTS_MAX];
+};
+
+/* A run of visible pixels in a row of a span encoded Surface. The pixels
+ * between runs are fully transparent. */
+struct pgSpan {
+    int x, len;
+    int opaque; /* every pixel of the run is fully opaque */
+};
+
+/* Per row runs of the visible pixels of a Surface. Changing the pixels marks
+ * the encoding invalid, it is rebuilt by the next blit from the Surface. */
+struct pgSpanCache {
+    int valid;
+    /* the Surface state the runs were encoded for */
+    void *pixels;
+    int w, h, pitch;
+    Uint32 format;
+    int has_colorkey;
+    Uint32 colorkey;
+    Uint8 alpha;
+    SDL_BlendMode blend;
+    /* the runs of row y are spans[rows[y]] up to spans[rows[y + 1]] */
+    int *rows;
+    struct pgSpan *spans;
+    int allocated;
+};
+
+/* Copy-on-write state of a Surface. Surface.copy() can return a Surface
+ * sharing the pixels of its source, pgSurface_Unshare gives it pixels of its
+ * own before either of them writes. */
+struct pgCowData {
+    /* for a copy: the SDL surface owning the shared pixels, holding a
+     * reference to it, or NULL once the copy has pixels of its own */
+    SDL_Surface *backing;
+    void *pixels;     /* own pixels allocated by pgSurface_Unshare */
+    PyObject *copies; /* for a source: weakrefs to the copies sharing it */
+};
+
 /*
  * color module internals
  */
@@ -763,12 +808,12 @@ typedef enum {
 #define PYGAMEAPI_RECT_NUMSLOTS 10
 #define PYGAMEAPI_JOYSTICK_NUMSLOTS 3
 #define PYGAMEAPI_DISPLAY_NUMSLOTS 2
-#define PYGAMEAPI_SURFACE_NUMSLOTS 4
-#define PYGAMEAPI_SURFLOCK_NUMSLOTS 6
+#define PYGAMEAPI_SURFACE_NUMSLOTS 9
+#define PYGAMEAPI_SURFLOCK_NUMSLOTS 8
 #define PYGAMEAPI_RWOBJECT_NUMSLOTS 5
 #define PYGAMEAPI_PIXELARRAY_NUMSLOTS 2
 #define PYGAMEAPI_COLOR_NUMSLOTS 5
-#define PYGAMEAPI_BASE_NUMSLOTS 30
+#define PYGAMEAPI_BASE_NUMSLOTS 32
 #define PYGAMEAPI_EVENT_NUMSLOTS 10
 #define PYGAMEAPI_WINDOW_NUMSLOTS 1
 #define PYGAMEAPI_RENDER_NUMSLOTS 3
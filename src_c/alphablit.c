@@ -22,7 +22,6 @@
   pete@shinners.org
 */
 
-#define NO_PYGAME_C_API
 #include "_surface.h"
 #include "simd_shared.h"
 #include "simd_blitters.h"
@@ -60,11 +59,670 @@ blit_blend_premultiplied(SDL_BlitInfo *info);
 
 static int
 SoftBlitPyGame(SDL_Surface *src, SDL_Rect *srcrect, SDL_Surface *dst,
-               SDL_Rect *dstrect, int blend_flags);
+               SDL_Rect *dstrect, int blend_flags, struct pgSpanCache *spans);
+
+/* Runs the blitter matching blend_flags over the rows described by info.
+ * blend_flags must already have been checked by _pg_blend_flags_supported */
+static void
+_pg_blit_dispatch(SDL_Surface *src, SDL_Surface *dst, SDL_BlitInfo *info,
+                  int blend_flags)
+{
+    switch (blend_flags) {
+        case 0: {
+            if (info->src_blend != SDL_BLENDMODE_NONE && info->src->Amask) {
+#if !defined(__EMSCRIPTEN__)
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+                if (PG_SURF_BytesPerPixel(src) == 4 &&
+                    PG_SURF_BytesPerPixel(dst) == 4 &&
+                    info->src->Rmask == info->dst->Rmask &&
+                    info->src->Gmask == info->dst->Gmask &&
+                    info->src->Bmask == info->dst->Bmask) {
+                    /* If our source and destination are the same ARGB
+                       32bit format we can use SSE2/NEON/AVX2/AVX512 to speed
+                       up the blend */
+                    if (pg_has_avx512() && (src != dst)) {
+                        if (info->src_blanket_alpha != 255) {
+                            alphablit_alpha_avx512_argb_surf_alpha(info);
+                        }
+                        else if (SDL_ISPIXELFORMAT_ALPHA(
+                                     PG_SURF_FORMATENUM(dst)) &&
+                                 info->dst_blend != SDL_BLENDMODE_NONE) {
+                            alphablit_alpha_avx512_argb_no_surf_alpha(info);
+                        }
+                        else {
+                            alphablit_alpha_avx512_argb_no_surf_alpha_opaque_dst(
+                                info);
+                        }
+                        break;
+                    }
+                    if (pg_has_avx2() && (src != dst)) {
+                        if (info->src_blanket_alpha != 255) {
+                            alphablit_alpha_avx2_argb_surf_alpha(info);
+                        }
+                        else if (SDL_ISPIXELFORMAT_ALPHA(
+                                     PG_SURF_FORMATENUM(dst)) &&
+                                 info->dst_blend != SDL_BLENDMODE_NONE) {
+                            alphablit_alpha_avx2_argb_no_surf_alpha(info);
+                        }
+                        else {
+                            alphablit_alpha_avx2_argb_no_surf_alpha_opaque_dst(
+                                info);
+                        }
+                        break;
+                    }
+#if PG_ENABLE_NATIVE_NEON
+                    if ((pg_HasSSE_NEON()) && (src != dst)) {
+                        if (info->src_blanket_alpha != 255) {
+                            alphablit_alpha_neon_argb_surf_alpha(info);
+                        }
+                        else if (SDL_ISPIXELFORMAT_ALPHA(
+                                     PG_SURF_FORMATENUM(dst)) &&
+                                 info->dst_blend != SDL_BLENDMODE_NONE) {
+                            alphablit_alpha_neon_argb_no_surf_alpha(info);
+                        }
+                        else {
+                            alphablit_alpha_neon_argb_no_surf_alpha_opaque_dst(
+                                info);
+                        }
+                        break;
+                    }
+#elif PG_ENABLE_SSE_NEON
+                    if ((pg_HasSSE_NEON()) && (src != dst)) {
+                        if (info->src_blanket_alpha != 255) {
+                            alphablit_alpha_sse2_argb_surf_alpha(info);
+                        }
+                        else if (SDL_ISPIXELFORMAT_ALPHA(
+                                     PG_SURF_FORMATENUM(dst)) &&
+                                 info->dst_blend != SDL_BLENDMODE_NONE) {
+                            alphablit_alpha_sse2_argb_no_surf_alpha(info);
+                        }
+                        else {
+                            alphablit_alpha_sse2_argb_no_surf_alpha_opaque_dst(
+                                info);
+                        }
+                        break;
+                    }
+#endif /* PG_ENABLE_NATIVE_NEON */
+                }
+#endif /* SDL_BYTEORDER == SDL_LIL_ENDIAN */
+#endif /* __EMSCRIPTEN__ */
+                alphablit_alpha(info);
+            }
+            else if (info->src_has_colorkey) {
+                alphablit_colorkey(info);
+            }
+            else {
+                alphablit_solid(info);
+            }
+            break;
+        }
+        case PYGAME_BLEND_ADD: {
+#if !defined(__EMSCRIPTEN__)
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+            if (PG_SURF_BytesPerPixel(src) == 4 &&
+                PG_SURF_BytesPerPixel(dst) == 4 &&
+                info->src->Rmask == info->dst->Rmask &&
+                info->src->Gmask == info->dst->Gmask &&
+                info->src->Bmask == info->dst->Bmask &&
+                !(info->src->Amask != 0 && info->dst->Amask != 0 &&
+                  info->src->Amask != info->dst->Amask) &&
+                pg_has_avx2() && (src != dst)) {
+                blit_blend_rgb_add_avx2(info);
+                break;
+            }
+#if PG_ENABLE_SSE_NEON
+            if (PG_SURF_BytesPerPixel(src) == 4 &&
+                PG_SURF_BytesPerPixel(dst) == 4 &&
+                info->src->Rmask == info->dst->Rmask &&
+                info->src->Gmask == info->dst->Gmask &&
+                info->src->Bmask == info->dst->Bmask &&
+                !(info->src->Amask != 0 && info->dst->Amask != 0 &&
+                  info->src->Amask != info->dst->Amask) &&
+                pg_HasSSE_NEON() && (src != dst)) {
+#if PG_ENABLE_NATIVE_NEON
+                blit_blend_rgb_add_neon(info);
+#else
+                blit_blend_rgb_add_sse2(info);
+#endif /* PG_ENABLE_NATIVE_NEON */
+                break;
+            }
+#endif /* PG_ENABLE_SSE_NEON */
+#endif /* SDL_BYTEORDER == SDL_LIL_ENDIAN */
+#endif /* __EMSCRIPTEN__ */
+            blit_blend_add(info);
+            break;
+        }
+        case PYGAME_BLEND_SUB: {
+#if !defined(__EMSCRIPTEN__)
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+            if (PG_SURF_BytesPerPixel(src) == 4 &&
+                PG_SURF_BytesPerPixel(dst) == 4 &&
+                info->src->Rmask == info->dst->Rmask &&
+                info->src->Gmask == info->dst->Gmask &&
+                info->src->Bmask == info->dst->Bmask &&
+                !(info->src->Amask != 0 && info->dst->Amask != 0 &&
+                  info->src->Amask != info->dst->Amask) &&
+                pg_has_avx2() && (src != dst)) {
+                blit_blend_rgb_sub_avx2(info);
+                break;
+            }
+#if PG_ENABLE_SSE_NEON
+            if (PG_SURF_BytesPerPixel(src) == 4 &&
+                PG_SURF_BytesPerPixel(dst) == 4 &&
+                info->src->Rmask == info->dst->Rmask &&
+                info->src->Gmask == info->dst->Gmask &&
+                info->src->Bmask == info->dst->Bmask &&
+                !(info->src->Amask != 0 && info->dst->Amask != 0 &&
+                  info->src->Amask != info->dst->Amask) &&
+                pg_HasSSE_NEON() && (src != dst)) {
+#if PG_ENABLE_NATIVE_NEON
+                blit_blend_rgb_sub_neon(info);
+#else
+                blit_blend_rgb_sub_sse2(info);
+#endif /* PG_ENABLE_NATIVE_NEON */
+                break;
+            }
+#endif /* PG_ENABLE_SSE_NEON */
+#endif /* SDL_BYTEORDER == SDL_LIL_ENDIAN */
+#endif /* __EMSCRIPTEN__ */
+            blit_blend_sub(info);
+            break;
+        }
+        case PYGAME_BLEND_MULT: {
+#if !defined(__EMSCRIPTEN__)
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+            if (PG_SURF_BytesPerPixel(src) == 4 &&
+                PG_SURF_BytesPerPixel(dst) == 4 &&
+                info->src->Rmask == info->dst->Rmask &&
+                info->src->Gmask == info->dst->Gmask &&
+                info->src->Bmask == info->dst->Bmask &&
+                !(info->src->Amask != 0 && info->dst->Amask != 0 &&
+                  info->src->Amask != info->dst->Amask) &&
+                pg_has_avx2() && (src != dst)) {
+                blit_blend_rgb_mul_avx2(info);
+                break;
+            }
+#if PG_ENABLE_SSE_NEON
+            if (PG_SURF_BytesPerPixel(src) == 4 &&
+                PG_SURF_BytesPerPixel(dst) == 4 &&
+                info->src->Rmask == info->dst->Rmask &&
+                info->src->Gmask == info->dst->Gmask &&
+                info->src->Bmask == info->dst->Bmask &&
+                !(info->src->Amask != 0 && info->dst->Amask != 0 &&
+                  info->src->Amask != info->dst->Amask) &&
+                pg_HasSSE_NEON() && (src != dst)) {
+#if PG_ENABLE_NATIVE_NEON
+                blit_blend_rgb_mul_neon(info);
+#else
+                blit_blend_rgb_mul_sse2(info);
+#endif /* PG_ENABLE_NATIVE_NEON */
+                break;
+            }
+#endif /* PG_ENABLE_SSE_NEON */
+#endif /* SDL_BYTEORDER == SDL_LIL_ENDIAN */
+#endif /* __EMSCRIPTEN__ */
+            blit_blend_mul(info);
+            break;
+        }
+        case PYGAME_BLEND_MIN: {
+#if !defined(__EMSCRIPTEN__)
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+            if (PG_SURF_BytesPerPixel(src) == 4 &&
+                PG_SURF_BytesPerPixel(dst) == 4 &&
+                info->src->Rmask == info->dst->Rmask &&
+                info->src->Gmask == info->dst->Gmask &&
+                info->src->Bmask == info->dst->Bmask &&
+                !(info->src->Amask != 0 && info->dst->Amask != 0 &&
+                  info->src->Amask != info->dst->Amask) &&
+                pg_has_avx2() && (src != dst)) {
+                blit_blend_rgb_min_avx2(info);
+                break;
+            }
+#if PG_ENABLE_SSE_NEON
+            if (PG_SURF_BytesPerPixel(src) == 4 &&
+                PG_SURF_BytesPerPixel(dst) == 4 &&
+                info->src->Rmask == info->dst->Rmask &&
+                info->src->Gmask == info->dst->Gmask &&
+                info->src->Bmask == info->dst->Bmask &&
+                !(info->src->Amask != 0 && info->dst->Amask != 0 &&
+                  info->src->Amask != info->dst->Amask) &&
+                pg_HasSSE_NEON() && (src != dst)) {
+#if PG_ENABLE_NATIVE_NEON
+                blit_blend_rgb_min_neon(info);
+#else
+                blit_blend_rgb_min_sse2(info);
+#endif /* PG_ENABLE_NATIVE_NEON */
+                break;
+            }
+#endif /* PG_ENABLE_SSE_NEON */
+#endif /* SDL_BYTEORDER == SDL_LIL_ENDIAN */
+#endif /* __EMSCRIPTEN__ */
+            blit_blend_min(info);
+            break;
+        }
+        case PYGAME_BLEND_MAX: {
+#if !defined(__EMSCRIPTEN__)
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+            if (PG_SURF_BytesPerPixel(src) == 4 &&
+                PG_SURF_BytesPerPixel(dst) == 4 &&
+                info->src->Rmask == info->dst->Rmask &&
+                info->src->Gmask == info->dst->Gmask &&
+                info->src->Bmask == info->dst->Bmask &&
+                !(info->src->Amask != 0 && info->dst->Amask != 0 &&
+                  info->src->Amask != info->dst->Amask) &&
+                pg_has_avx2() && (src != dst)) {
+                blit_blend_rgb_max_avx2(info);
+                break;
+            }
+#if PG_ENABLE_SSE_NEON
+            if (PG_SURF_BytesPerPixel(src) == 4 &&
+                PG_SURF_BytesPerPixel(dst) == 4 &&
+                info->src->Rmask == info->dst->Rmask &&
+                info->src->Gmask == info->dst->Gmask &&
+                info->src->Bmask == info->dst->Bmask &&
+                !(info->src->Amask != 0 && info->dst->Amask != 0 &&
+                  info->src->Amask != info->dst->Amask) &&
+                pg_HasSSE_NEON() && (src != dst)) {
+#if PG_ENABLE_NATIVE_NEON
+                blit_blend_rgb_max_neon(info);
+#else
+                blit_blend_rgb_max_sse2(info);
+#endif /* PG_ENABLE_NATIVE_NEON */
+                break;
+            }
+#endif /* PG_ENABLE_SSE_NEON */
+#endif /* SDL_BYTEORDER == SDL_LIL_ENDIAN */
+#endif /* __EMSCRIPTEN__ */
+            blit_blend_max(info);
+            break;
+        }
+
+        case PYGAME_BLEND_RGBA_ADD: {
+#if !defined(__EMSCRIPTEN__)
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+            if (PG_SURF_BytesPerPixel(src) == 4 &&
+                PG_SURF_BytesPerPixel(dst) == 4 &&
+                info->src->Rmask == info->dst->Rmask &&
+                info->src->Gmask == info->dst->Gmask &&
+                info->src->Bmask == info->dst->Bmask &&
+                info->src_blend != SDL_BLENDMODE_NONE &&
+                pg_has_avx512() && (src != dst)) {
+                blit_blend_rgba_add_avx512(info);
+                break;
+            }
+            if (PG_SURF_BytesPerPixel(src) == 4 &&
+                PG_SURF_BytesPerPixel(dst) == 4 &&
+                info->src->Rmask == info->dst->Rmask &&
+                info->src->Gmask == info->dst->Gmask &&
+                info->src->Bmask == info->dst->Bmask &&
+                info->src_blend != SDL_BLENDMODE_NONE &&
+                pg_has_avx2() && (src != dst)) {
+                blit_blend_rgba_add_avx2(info);
+                break;
+            }
+#if PG_ENABLE_SSE_NEON
+            if (PG_SURF_BytesPerPixel(src) == 4 &&
+                PG_SURF_BytesPerPixel(dst) == 4 &&
+                info->src->Rmask == info->dst->Rmask &&
+                info->src->Gmask == info->dst->Gmask &&
+                info->src->Bmask == info->dst->Bmask &&
+                info->src_blend != SDL_BLENDMODE_NONE &&
+                pg_HasSSE_NEON() && (src != dst)) {
+#if PG_ENABLE_NATIVE_NEON
+                blit_blend_rgba_add_neon(info);
+#else
+                blit_blend_rgba_add_sse2(info);
+#endif /* PG_ENABLE_NATIVE_NEON */
+                break;
+            }
+#endif /* PG_ENABLE_SSE_NEON */
+#endif /* SDL_BYTEORDER == SDL_LIL_ENDIAN */
+#endif /* __EMSCRIPTEN__ */
+            blit_blend_rgba_add(info);
+            break;
+        }
+        case PYGAME_BLEND_RGBA_SUB: {
+#if !defined(__EMSCRIPTEN__)
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+            if (PG_SURF_BytesPerPixel(src) == 4 &&
+                PG_SURF_BytesPerPixel(dst) == 4 &&
+                info->src->Rmask == info->dst->Rmask &&
+                info->src->Gmask == info->dst->Gmask &&
+                info->src->Bmask == info->dst->Bmask &&
+                info->src_blend != SDL_BLENDMODE_NONE &&
+                pg_has_avx512() && (src != dst)) {
+                blit_blend_rgba_sub_avx512(info);
+                break;
+            }
+            if (PG_SURF_BytesPerPixel(src) == 4 &&
+                PG_SURF_BytesPerPixel(dst) == 4 &&
+                info->src->Rmask == info->dst->Rmask &&
+                info->src->Gmask == info->dst->Gmask &&
+                info->src->Bmask == info->dst->Bmask &&
+                info->src_blend != SDL_BLENDMODE_NONE &&
+                pg_has_avx2() && (src != dst)) {
+                blit_blend_rgba_sub_avx2(info);
+                break;
+            }
+#if PG_ENABLE_SSE_NEON
+            if (PG_SURF_BytesPerPixel(src) == 4 &&
+                PG_SURF_BytesPerPixel(dst) == 4 &&
+                info->src->Rmask == info->dst->Rmask &&
+                info->src->Gmask == info->dst->Gmask &&
+                info->src->Bmask == info->dst->Bmask &&
+                info->src_blend != SDL_BLENDMODE_NONE &&
+                pg_HasSSE_NEON() && (src != dst)) {
+#if PG_ENABLE_NATIVE_NEON
+                blit_blend_rgba_sub_neon(info);
+#else
+                blit_blend_rgba_sub_sse2(info);
+#endif /* PG_ENABLE_NATIVE_NEON */
+                break;
+            }
+#endif /* PG_ENABLE_SSE_NEON */
+#endif /* SDL_BYTEORDER == SDL_LIL_ENDIAN */
+#endif /* __EMSCRIPTEN__ */
+            blit_blend_rgba_sub(info);
+            break;
+        }
+        case PYGAME_BLEND_RGBA_MULT: {
+#if !defined(__EMSCRIPTEN__)
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+            if (PG_SURF_BytesPerPixel(src) == 4 &&
+                PG_SURF_BytesPerPixel(dst) == 4 &&
+                info->src->Rmask == info->dst->Rmask &&
+                info->src->Gmask == info->dst->Gmask &&
+                info->src->Bmask == info->dst->Bmask &&
+                info->src_blend != SDL_BLENDMODE_NONE &&
+                pg_has_avx512() && (src != dst)) {
+                blit_blend_rgba_mul_avx512(info);
+                break;
+            }
+            if (PG_SURF_BytesPerPixel(src) == 4 &&
+                PG_SURF_BytesPerPixel(dst) == 4 &&
+                info->src->Rmask == info->dst->Rmask &&
+                info->src->Gmask == info->dst->Gmask &&
+                info->src->Bmask == info->dst->Bmask &&
+                info->src_blend != SDL_BLENDMODE_NONE &&
+                pg_has_avx2() && (src != dst)) {
+                blit_blend_rgba_mul_avx2(info);
+                break;
+            }
+#if PG_ENABLE_SSE_NEON
+            if (PG_SURF_BytesPerPixel(src) == 4 &&
+                PG_SURF_BytesPerPixel(dst) == 4 &&
+                info->src->Rmask == info->dst->Rmask &&
+                info->src->Gmask == info->dst->Gmask &&
+                info->src->Bmask == info->dst->Bmask &&
+                info->src_blend != SDL_BLENDMODE_NONE &&
+                pg_HasSSE_NEON() && (src != dst)) {
+#if PG_ENABLE_NATIVE_NEON
+                blit_blend_rgba_mul_neon(info);
+#else
+                blit_blend_rgba_mul_sse2(info);
+#endif /* PG_ENABLE_NATIVE_NEON */
+                break;
+            }
+#endif /* PG_ENABLE_SSE_NEON */
+#endif /* SDL_BYTEORDER == SDL_LIL_ENDIAN */
+#endif /* __EMSCRIPTEN__ */
+            blit_blend_rgba_mul(info);
+            break;
+        }
+        case PYGAME_BLEND_RGBA_MIN: {
+#if !defined(__EMSCRIPTEN__)
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+            if (PG_SURF_BytesPerPixel(src) == 4 &&
+                PG_SURF_BytesPerPixel(dst) == 4 &&
+                info->src->Rmask == info->dst->Rmask &&
+                info->src->Gmask == info->dst->Gmask &&
+                info->src->Bmask == info->dst->Bmask &&
+                info->src_blend != SDL_BLENDMODE_NONE &&
+                pg_has_avx512() && (src != dst)) {
+                blit_blend_rgba_min_avx512(info);
+                break;
+            }
+            if (PG_SURF_BytesPerPixel(src) == 4 &&
+                PG_SURF_BytesPerPixel(dst) == 4 &&
+                info->src->Rmask == info->dst->Rmask &&
+                info->src->Gmask == info->dst->Gmask &&
+                info->src->Bmask == info->dst->Bmask &&
+                info->src_blend != SDL_BLENDMODE_NONE &&
+                pg_has_avx2() && (src != dst)) {
+                blit_blend_rgba_min_avx2(info);
+                break;
+            }
+#if PG_ENABLE_SSE_NEON
+            if (PG_SURF_BytesPerPixel(src) == 4 &&
+                PG_SURF_BytesPerPixel(dst) == 4 &&
+                info->src->Rmask == info->dst->Rmask &&
+                info->src->Gmask == info->dst->Gmask &&
+                info->src->Bmask == info->dst->Bmask &&
+                info->src_blend != SDL_BLENDMODE_NONE &&
+                pg_HasSSE_NEON() && (src != dst)) {
+#if PG_ENABLE_NATIVE_NEON
+                blit_blend_rgba_min_neon(info);
+#else
+                blit_blend_rgba_min_sse2(info);
+#endif /* PG_ENABLE_NATIVE_NEON */
+                break;
+            }
+#endif /* PG_ENABLE_SSE_NEON */
+#endif /* SDL_BYTEORDER == SDL_LIL_ENDIAN */
+#endif /* __EMSCRIPTEN__ */
+            blit_blend_rgba_min(info);
+            break;
+        }
+        case PYGAME_BLEND_RGBA_MAX: {
+#if !defined(__EMSCRIPTEN__)
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+            if (PG_SURF_BytesPerPixel(src) == 4 &&
+                PG_SURF_BytesPerPixel(dst) == 4 &&
+                info->src->Rmask == info->dst->Rmask &&
+                info->src->Gmask == info->dst->Gmask &&
+                info->src->Bmask == info->dst->Bmask &&
+                info->src_blend != SDL_BLENDMODE_NONE &&
+                pg_has_avx512() && (src != dst)) {
+                blit_blend_rgba_max_avx512(info);
+                break;
+            }
+            if (PG_SURF_BytesPerPixel(src) == 4 &&
+                PG_SURF_BytesPerPixel(dst) == 4 &&
+                info->src->Rmask == info->dst->Rmask &&
+                info->src->Gmask == info->dst->Gmask &&
+                info->src->Bmask == info->dst->Bmask &&
+                info->src_blend != SDL_BLENDMODE_NONE &&
+                pg_has_avx2() && (src != dst)) {
+                blit_blend_rgba_max_avx2(info);
+                break;
+            }
+#if PG_ENABLE_SSE_NEON
+            if (PG_SURF_BytesPerPixel(src) == 4 &&
+                PG_SURF_BytesPerPixel(dst) == 4 &&
+                info->src->Rmask == info->dst->Rmask &&
+                info->src->Gmask == info->dst->Gmask &&
+                info->src->Bmask == info->dst->Bmask &&
+                info->src_blend != SDL_BLENDMODE_NONE &&
+                pg_HasSSE_NEON() && (src != dst)) {
+#if PG_ENABLE_NATIVE_NEON
+                blit_blend_rgba_max_neon(info);
+#else
+                blit_blend_rgba_max_sse2(info);
+#endif /* PG_ENABLE_NATIVE_NEON */
+                break;
+            }
+#endif /* PG_ENABLE_SSE_NEON */
+#endif /* SDL_BYTEORDER == SDL_LIL_ENDIAN */
+#endif /* __EMSCRIPTEN__ */
+            blit_blend_rgba_max(info);
+            break;
+        }
+        case PYGAME_BLEND_PREMULTIPLIED: {
+#if !defined(__EMSCRIPTEN__)
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+            if (PG_SURF_BytesPerPixel(src) == 4 &&
+                PG_SURF_BytesPerPixel(dst) == 4 &&
+                info->src->Rmask == info->dst->Rmask &&
+                info->src->Gmask == info->dst->Gmask &&
+                info->src->Bmask == info->dst->Bmask &&
+                info->src_blend != SDL_BLENDMODE_NONE &&
+                pg_has_avx512() && (src != dst)) {
+                blit_blend_premultiplied_avx512(info);
+                break;
+            }
+            if (PG_SURF_BytesPerPixel(src) == 4 &&
+                PG_SURF_BytesPerPixel(dst) == 4 &&
+                info->src->Rmask == info->dst->Rmask &&
+                info->src->Gmask == info->dst->Gmask &&
+                info->src->Bmask == info->dst->Bmask &&
+                info->src_blend != SDL_BLENDMODE_NONE &&
+                pg_has_avx2() && (src != dst)) {
+                blit_blend_premultiplied_avx2(info);
+                break;
+            }
+#if PG_ENABLE_SSE_NEON
+            if (PG_SURF_BytesPerPixel(src) == 4 &&
+                PG_SURF_BytesPerPixel(dst) == 4 &&
+                info->src->Rmask == info->dst->Rmask &&
+                info->src->Gmask == info->dst->Gmask &&
+                info->src->Bmask == info->dst->Bmask &&
+                info->src->Amask == 0xFF000000 &&
+                info->src_blend != SDL_BLENDMODE_NONE &&
+                pg_HasSSE_NEON() && (src != dst)) {
+#if PG_ENABLE_NATIVE_NEON
+                blit_blend_premultiplied_neon(info);
+#else
+                blit_blend_premultiplied_sse2(info);
+#endif /* PG_ENABLE_NATIVE_NEON */
+                break;
+            }
+#endif /* PG_ENABLE_SSE_NEON */
+#endif /* SDL_BYTEORDER == SDL_LIL_ENDIAN */
+#endif /* __EMSCRIPTEN__ */
+
+            blit_blend_premultiplied(info);
+            break;
+        }
+        default: {
+            break;
+        }
+    }
+}
+
+static int
+_pg_blend_flags_supported(int blend_flags)
+{
+    switch (blend_flags) {
+        case 0:
+        case PYGAME_BLEND_ADD:
+        case PYGAME_BLEND_SUB:
+        case PYGAME_BLEND_MULT:
+        case PYGAME_BLEND_MIN:
+        case PYGAME_BLEND_MAX:
+        case PYGAME_BLEND_RGBA_ADD:
+        case PYGAME_BLEND_RGBA_SUB:
+        case PYGAME_BLEND_RGBA_MULT:
+        case PYGAME_BLEND_RGBA_MIN:
+        case PYGAME_BLEND_RGBA_MAX:
+        case PYGAME_BLEND_PREMULTIPLIED:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+typedef struct {
+    SDL_Surface *src;
+    SDL_Surface *dst;
+    SDL_BlitInfo *info;
+    int blend_flags;
+} pgBlitBand;
+
+/* pg_rowbandproc that blits the rows [start_row, end_row) of a band */
+static void
+_pg_blit_band(void *data, int start_row, int end_row)
+{
+    pgBlitBand *band = (pgBlitBand *)data;
+    SDL_BlitInfo info = *band->info;
+
+    info.height = end_row - start_row;
+    info.s_pixels += (Sint64)start_row * band->src->pitch;
+    info.d_pixels += (Sint64)start_row * band->dst->pitch;
+    _pg_blit_dispatch(band->src, band->dst, &info, band->blend_flags);
+}
+
+/* Blits one run of pixels with the regular blitter for blend_flags 0 */
+static void
+_pg_blit_span_run(SDL_Surface *src, SDL_Surface *dst, SDL_BlitInfo *info,
+                  Uint8 *s, Uint8 *d, int len)
+{
+    SDL_BlitInfo run = *info;
+
+    run.width = len;
+    run.height = 1;
+    run.s_pixels = s;
+    run.s_skip = src->pitch - len * run.s_pxskip;
+    run.d_pixels = d;
+    run.d_skip = dst->pitch - len * run.d_pxskip;
+    _pg_blit_dispatch(src, dst, &run, 0);
+}
+
+/* Blits the clipped area described by info and srcrect using the runs of
+ * a span encoded source. Both surfaces are 32 bit and don't share pixels.
+ * Fully transparent pixels are skipped and fully opaque runs are copied
+ * when the formats match, the rest goes through the regular blitter. */
+static void
+_pg_blit_spans(SDL_Surface *src, SDL_Surface *dst, SDL_BlitInfo *info,
+               struct pgSpanCache *spans, SDL_Rect *srcrect)
+{
+    int copy = PG_SURF_FORMATENUM(src) == PG_SURF_FORMATENUM(dst);
+    /* Blending a transparent pixel onto a transparent destination pixel
+       still replaces its color, so the gaps can only be skipped when the
+       destination has no alpha or the source is color keyed */
+    int gaps = info->dst->Amask && !info->src_has_colorkey;
+    int x, y, i, start, end, last;
+    struct pgSpan *span;
+    Uint8 *s, *d;
+
+    for (y = 0; y < info->height; ++y) {
+        s = info->s_pixels + (Sint64)y * src->pitch;
+        d = info->d_pixels + (Sint64)y * dst->pitch;
+        x = 0;
+        last = spans->rows[srcrect->y + y + 1];
+        for (i = spans->rows[srcrect->y + y]; i < last; ++i) {
+            span = spans->spans + i;
+            start = span->x - srcrect->x;
+            if (start >= info->width) {
+                break;
+            }
+            end = MIN(start + span->len, info->width);
+            start = MAX(start, 0);
+            if (end <= start) {
+                continue;
+            }
+            if (gaps && start > x) {
+                _pg_blit_span_run(src, dst, info, s + x * 4, d + x * 4,
+                                  start - x);
+            }
+            if (span->opaque && copy) {
+                memcpy(d + start * 4, s + start * 4, (end - start) * 4);
+            }
+            else {
+                _pg_blit_span_run(src, dst, info, s + start * 4,
+                                  d + start * 4, end - start);
+            }
+            x = end;
+        }
+        if (gaps && x < info->width) {
+            _pg_blit_span_run(src, dst, info, s + x * 4, d + x * 4,
+                              info->width - x);
+        }
+    }
+}
 
 static int
 SoftBlitPyGame(SDL_Surface *src, SDL_Rect *srcrect, SDL_Surface *dst,
-               SDL_Rect *dstrect, int blend_flags)
+               SDL_Rect *dstrect, int blend_flags, struct pgSpanCache *spans)
 {
     int okay;
     int src_locked;
@@ -128,6 +786,24 @@ SoftBlitPyGame(SDL_Surface *src, SDL_Rect *srcrect, SDL_Surface *dst,
             okay = 0;
         }
         if (okay) {
+            int bands = pg_ParallelBandCount(
+                info.height, (Py_ssize_t)info.width * info.height);
+
+            if (bands > 1) {
+                /* Row bands can only run concurrently if the source and
+                   destination pixels don't overlap in memory */
+                Uint8 *s_end = info.s_pixels +
+                               (info.height - 1) * src->pitch +
+                               info.width * info.s_pxskip;
+                Uint8 *d_end = info.d_pixels +
+                               (info.height - 1) * dst->pitch +
+                               info.width * info.d_pxskip;
+
+                if (info.d_pixels < s_end && info.s_pixels < d_end) {
+                    bands = 1;
+                }
+            }
+
             if (info.d_pixels > info.s_pixels) {
                 int span = info.width * PG_FORMAT_BytesPerPixel(info.src);
                 Uint8 *srcpixend =
@@ -160,419 +836,24 @@ SoftBlitPyGame(SDL_Surface *src, SDL_Rect *srcrect, SDL_Surface *dst,
                 blend_flags = PYGAME_BLEND_MULT;
             }
 
-            switch (blend_flags) {
-                case 0: {
-                    if (info.src_blend != SDL_BLENDMODE_NONE &&
-                        info.src->Amask) {
-#if !defined(__EMSCRIPTEN__)
-#if SDL_BYTEORDER == SDL_LIL_ENDIAN
-                        if (PG_SURF_BytesPerPixel(src) == 4 &&
-                            PG_SURF_BytesPerPixel(dst) == 4 &&
-                            info.src->Rmask == info.dst->Rmask &&
-                            info.src->Gmask == info.dst->Gmask &&
-                            info.src->Bmask == info.dst->Bmask) {
-                            /* If our source and destination are the same ARGB
-                               32bit format we can use SSE2/NEON/AVX2 to speed
-                               up the blend */
-                            if (pg_has_avx2() && (src != dst)) {
-                                if (info.src_blanket_alpha != 255) {
-                                    alphablit_alpha_avx2_argb_surf_alpha(
-                                        &info);
-                                }
-                                else if (SDL_ISPIXELFORMAT_ALPHA(
-                                             PG_SURF_FORMATENUM(dst)) &&
-                                         info.dst_blend !=
-                                             SDL_BLENDMODE_NONE) {
-                                    alphablit_alpha_avx2_argb_no_surf_alpha(
-                                        &info);
-                                }
-                                else {
-                                    alphablit_alpha_avx2_argb_no_surf_alpha_opaque_dst(
-                                        &info);
-                                }
-                                break;
-                            }
-#if PG_ENABLE_SSE_NEON
-                            if ((pg_HasSSE_NEON()) && (src != dst)) {
-                                if (info.src_blanket_alpha != 255) {
-                                    alphablit_alpha_sse2_argb_surf_alpha(
-                                        &info);
-                                }
-                                else if (SDL_ISPIXELFORMAT_ALPHA(
-                                             PG_SURF_FORMATENUM(dst)) &&
-                                         info.dst_blend !=
-                                             SDL_BLENDMODE_NONE) {
-                                    alphablit_alpha_sse2_argb_no_surf_alpha(
-                                        &info);
-                                }
-                                else {
-                                    alphablit_alpha_sse2_argb_no_surf_alpha_opaque_dst(
-                                        &info);
-                                }
-                                break;
-                            }
-#endif /* PG_ENABLE_SSE_NEON */
-                        }
-#endif /* SDL_BYTEORDER == SDL_LIL_ENDIAN */
-#endif /* __EMSCRIPTEN__ */
-                        alphablit_alpha(&info);
-                    }
-                    else if (info.src_has_colorkey) {
-                        alphablit_colorkey(&info);
-                    }
-                    else {
-                        alphablit_solid(&info);
-                    }
-                    break;
-                }
-                case PYGAME_BLEND_ADD: {
-#if !defined(__EMSCRIPTEN__)
-#if SDL_BYTEORDER == SDL_LIL_ENDIAN
-                    if (PG_SURF_BytesPerPixel(src) == 4 &&
-                        PG_SURF_BytesPerPixel(dst) == 4 &&
-                        info.src->Rmask == info.dst->Rmask &&
-                        info.src->Gmask == info.dst->Gmask &&
-                        info.src->Bmask == info.dst->Bmask &&
-                        !(info.src->Amask != 0 && info.dst->Amask != 0 &&
-                          info.src->Amask != info.dst->Amask) &&
-                        pg_has_avx2() && (src != dst)) {
-                        blit_blend_rgb_add_avx2(&info);
-                        break;
-                    }
-#if PG_ENABLE_SSE_NEON
-                    if (PG_SURF_BytesPerPixel(src) == 4 &&
-                        PG_SURF_BytesPerPixel(dst) == 4 &&
-                        info.src->Rmask == info.dst->Rmask &&
-                        info.src->Gmask == info.dst->Gmask &&
-                        info.src->Bmask == info.dst->Bmask &&
-                        !(info.src->Amask != 0 && info.dst->Amask != 0 &&
-                          info.src->Amask != info.dst->Amask) &&
-                        pg_HasSSE_NEON() && (src != dst)) {
-                        blit_blend_rgb_add_sse2(&info);
-                        break;
-                    }
-#endif /* PG_ENABLE_SSE_NEON */
-#endif /* SDL_BYTEORDER == SDL_LIL_ENDIAN */
-#endif /* __EMSCRIPTEN__ */
-                    blit_blend_add(&info);
-                    break;
-                }
-                case PYGAME_BLEND_SUB: {
-#if !defined(__EMSCRIPTEN__)
-#if SDL_BYTEORDER == SDL_LIL_ENDIAN
-                    if (PG_SURF_BytesPerPixel(src) == 4 &&
-                        PG_SURF_BytesPerPixel(dst) == 4 &&
-                        info.src->Rmask == info.dst->Rmask &&
-                        info.src->Gmask == info.dst->Gmask &&
-                        info.src->Bmask == info.dst->Bmask &&
-                        !(info.src->Amask != 0 && info.dst->Amask != 0 &&
-                          info.src->Amask != info.dst->Amask) &&
-                        pg_has_avx2() && (src != dst)) {
-                        blit_blend_rgb_sub_avx2(&info);
-                        break;
-                    }
-#if PG_ENABLE_SSE_NEON
-                    if (PG_SURF_BytesPerPixel(src) == 4 &&
-                        PG_SURF_BytesPerPixel(dst) == 4 &&
-                        info.src->Rmask == info.dst->Rmask &&
-                        info.src->Gmask == info.dst->Gmask &&
-                        info.src->Bmask == info.dst->Bmask &&
-                        !(info.src->Amask != 0 && info.dst->Amask != 0 &&
-                          info.src->Amask != info.dst->Amask) &&
-                        pg_HasSSE_NEON() && (src != dst)) {
-                        blit_blend_rgb_sub_sse2(&info);
-                        break;
-                    }
-#endif /* PG_ENABLE_SSE_NEON */
-#endif /* SDL_BYTEORDER == SDL_LIL_ENDIAN */
-#endif /* __EMSCRIPTEN__ */
-                    blit_blend_sub(&info);
-                    break;
-                }
-                case PYGAME_BLEND_MULT: {
-#if !defined(__EMSCRIPTEN__)
-#if SDL_BYTEORDER == SDL_LIL_ENDIAN
-                    if (PG_SURF_BytesPerPixel(src) == 4 &&
-                        PG_SURF_BytesPerPixel(dst) == 4 &&
-                        info.src->Rmask == info.dst->Rmask &&
-                        info.src->Gmask == info.dst->Gmask &&
-                        info.src->Bmask == info.dst->Bmask &&
-                        !(info.src->Amask != 0 && info.dst->Amask != 0 &&
-                          info.src->Amask != info.dst->Amask) &&
-                        pg_has_avx2() && (src != dst)) {
-                        blit_blend_rgb_mul_avx2(&info);
-                        break;
-                    }
-#if PG_ENABLE_SSE_NEON
-                    if (PG_SURF_BytesPerPixel(src) == 4 &&
-                        PG_SURF_BytesPerPixel(dst) == 4 &&
-                        info.src->Rmask == info.dst->Rmask &&
-                        info.src->Gmask == info.dst->Gmask &&
-                        info.src->Bmask == info.dst->Bmask &&
-                        !(info.src->Amask != 0 && info.dst->Amask != 0 &&
-                          info.src->Amask != info.dst->Amask) &&
-                        pg_HasSSE_NEON() && (src != dst)) {
-                        blit_blend_rgb_mul_sse2(&info);
-                        break;
-                    }
-#endif /* PG_ENABLE_SSE_NEON */
-#endif /* SDL_BYTEORDER == SDL_LIL_ENDIAN */
-#endif /* __EMSCRIPTEN__ */
-                    blit_blend_mul(&info);
-                    break;
-                }
-                case PYGAME_BLEND_MIN: {
-#if !defined(__EMSCRIPTEN__)
-#if SDL_BYTEORDER == SDL_LIL_ENDIAN
-                    if (PG_SURF_BytesPerPixel(src) == 4 &&
-                        PG_SURF_BytesPerPixel(dst) == 4 &&
-                        info.src->Rmask == info.dst->Rmask &&
-                        info.src->Gmask == info.dst->Gmask &&
-                        info.src->Bmask == info.dst->Bmask &&
-                        !(info.src->Amask != 0 && info.dst->Amask != 0 &&
-                          info.src->Amask != info.dst->Amask) &&
-                        pg_has_avx2() && (src != dst)) {
-                        blit_blend_rgb_min_avx2(&info);
-                        break;
-                    }
-#if PG_ENABLE_SSE_NEON
-                    if (PG_SURF_BytesPerPixel(src) == 4 &&
-                        PG_SURF_BytesPerPixel(dst) == 4 &&
-                        info.src->Rmask == info.dst->Rmask &&
-                        info.src->Gmask == info.dst->Gmask &&
-                        info.src->Bmask == info.dst->Bmask &&
-                        !(info.src->Amask != 0 && info.dst->Amask != 0 &&
-                          info.src->Amask != info.dst->Amask) &&
-                        pg_HasSSE_NEON() && (src != dst)) {
-                        blit_blend_rgb_min_sse2(&info);
-                        break;
-                    }
-#endif /* PG_ENABLE_SSE_NEON */
-#endif /* SDL_BYTEORDER == SDL_LIL_ENDIAN */
-#endif /* __EMSCRIPTEN__ */
-                    blit_blend_min(&info);
-                    break;
-                }
-                case PYGAME_BLEND_MAX: {
-#if !defined(__EMSCRIPTEN__)
-#if SDL_BYTEORDER == SDL_LIL_ENDIAN
-                    if (PG_SURF_BytesPerPixel(src) == 4 &&
-                        PG_SURF_BytesPerPixel(dst) == 4 &&
-                        info.src->Rmask == info.dst->Rmask &&
-                        info.src->Gmask == info.dst->Gmask &&
-                        info.src->Bmask == info.dst->Bmask &&
-                        !(info.src->Amask != 0 && info.dst->Amask != 0 &&
-                          info.src->Amask != info.dst->Amask) &&
-                        pg_has_avx2() && (src != dst)) {
-                        blit_blend_rgb_max_avx2(&info);
-                        break;
-                    }
-#if PG_ENABLE_SSE_NEON
-                    if (PG_SURF_BytesPerPixel(src) == 4 &&
-                        PG_SURF_BytesPerPixel(dst) == 4 &&
-                        info.src->Rmask == info.dst->Rmask &&
-                        info.src->Gmask == info.dst->Gmask &&
-                        info.src->Bmask == info.dst->Bmask &&
-                        !(info.src->Amask != 0 && info.dst->Amask != 0 &&
-                          info.src->Amask != info.dst->Amask) &&
-                        pg_HasSSE_NEON() && (src != dst)) {
-                        blit_blend_rgb_max_sse2(&info);
-                        break;
-                    }
-#endif /* PG_ENABLE_SSE_NEON */
-#endif /* SDL_BYTEORDER == SDL_LIL_ENDIAN */
-#endif /* __EMSCRIPTEN__ */
-                    blit_blend_max(&info);
-                    break;
-                }
-
-                case PYGAME_BLEND_RGBA_ADD: {
-#if !defined(__EMSCRIPTEN__)
-#if SDL_BYTEORDER == SDL_LIL_ENDIAN
-                    if (PG_SURF_BytesPerPixel(src) == 4 &&
-                        PG_SURF_BytesPerPixel(dst) == 4 &&
-                        info.src->Rmask == info.dst->Rmask &&
-                        info.src->Gmask == info.dst->Gmask &&
-                        info.src->Bmask == info.dst->Bmask &&
-                        info.src_blend != SDL_BLENDMODE_NONE &&
-                        pg_has_avx2() && (src != dst)) {
-                        blit_blend_rgba_add_avx2(&info);
-                        break;
-                    }
-#if PG_ENABLE_SSE_NEON
-                    if (PG_SURF_BytesPerPixel(src) == 4 &&
-                        PG_SURF_BytesPerPixel(dst) == 4 &&
-                        info.src->Rmask == info.dst->Rmask &&
-                        info.src->Gmask == info.dst->Gmask &&
-                        info.src->Bmask == info.dst->Bmask &&
-                        info.src_blend != SDL_BLENDMODE_NONE &&
-                        pg_HasSSE_NEON() && (src != dst)) {
-                        blit_blend_rgba_add_sse2(&info);
-                        break;
-                    }
-#endif /* PG_ENABLE_SSE_NEON */
-#endif /* SDL_BYTEORDER == SDL_LIL_ENDIAN */
-#endif /* __EMSCRIPTEN__ */
-                    blit_blend_rgba_add(&info);
-                    break;
-                }
-                case PYGAME_BLEND_RGBA_SUB: {
-#if !defined(__EMSCRIPTEN__)
-#if SDL_BYTEORDER == SDL_LIL_ENDIAN
-                    if (PG_SURF_BytesPerPixel(src) == 4 &&
-                        PG_SURF_BytesPerPixel(dst) == 4 &&
-                        info.src->Rmask == info.dst->Rmask &&
-                        info.src->Gmask == info.dst->Gmask &&
-                        info.src->Bmask == info.dst->Bmask &&
-                        info.src_blend != SDL_BLENDMODE_NONE &&
-                        pg_has_avx2() && (src != dst)) {
-                        blit_blend_rgba_sub_avx2(&info);
-                        break;
-                    }
-#if PG_ENABLE_SSE_NEON
-                    if (PG_SURF_BytesPerPixel(src) == 4 &&
-                        PG_SURF_BytesPerPixel(dst) == 4 &&
-                        info.src->Rmask == info.dst->Rmask &&
-                        info.src->Gmask == info.dst->Gmask &&
-                        info.src->Bmask == info.dst->Bmask &&
-                        info.src_blend != SDL_BLENDMODE_NONE &&
-                        pg_HasSSE_NEON() && (src != dst)) {
-                        blit_blend_rgba_sub_sse2(&info);
-                        break;
-                    }
-#endif /* PG_ENABLE_SSE_NEON */
-#endif /* SDL_BYTEORDER == SDL_LIL_ENDIAN */
-#endif /* __EMSCRIPTEN__ */
-                    blit_blend_rgba_sub(&info);
-                    break;
-                }
-                case PYGAME_BLEND_RGBA_MULT: {
-#if !defined(__EMSCRIPTEN__)
-#if SDL_BYTEORDER == SDL_LIL_ENDIAN
-                    if (PG_SURF_BytesPerPixel(src) == 4 &&
-                        PG_SURF_BytesPerPixel(dst) == 4 &&
-                        info.src->Rmask == info.dst->Rmask &&
-                        info.src->Gmask == info.dst->Gmask &&
-                        info.src->Bmask == info.dst->Bmask &&
-                        info.src_blend != SDL_BLENDMODE_NONE &&
-                        pg_has_avx2() && (src != dst)) {
-                        blit_blend_rgba_mul_avx2(&info);
-                        break;
-                    }
-#if PG_ENABLE_SSE_NEON
-                    if (PG_SURF_BytesPerPixel(src) == 4 &&
-                        PG_SURF_BytesPerPixel(dst) == 4 &&
-                        info.src->Rmask == info.dst->Rmask &&
-                        info.src->Gmask == info.dst->Gmask &&
-                        info.src->Bmask == info.dst->Bmask &&
-                        info.src_blend != SDL_BLENDMODE_NONE &&
-                        pg_HasSSE_NEON() && (src != dst)) {
-                        blit_blend_rgba_mul_sse2(&info);
-                        break;
-                    }
-#endif /* PG_ENABLE_SSE_NEON */
-#endif /* SDL_BYTEORDER == SDL_LIL_ENDIAN */
-#endif /* __EMSCRIPTEN__ */
-                    blit_blend_rgba_mul(&info);
-                    break;
-                }
-                case PYGAME_BLEND_RGBA_MIN: {
-#if !defined(__EMSCRIPTEN__)
-#if SDL_BYTEORDER == SDL_LIL_ENDIAN
-                    if (PG_SURF_BytesPerPixel(src) == 4 &&
-                        PG_SURF_BytesPerPixel(dst) == 4 &&
-                        info.src->Rmask == info.dst->Rmask &&
-                        info.src->Gmask == info.dst->Gmask &&
-                        info.src->Bmask == info.dst->Bmask &&
-                        info.src_blend != SDL_BLENDMODE_NONE &&
-                        pg_has_avx2() && (src != dst)) {
-                        blit_blend_rgba_min_avx2(&info);
-                        break;
-                    }
-#if PG_ENABLE_SSE_NEON
-                    if (PG_SURF_BytesPerPixel(src) == 4 &&
-                        PG_SURF_BytesPerPixel(dst) == 4 &&
-                        info.src->Rmask == info.dst->Rmask &&
-                        info.src->Gmask == info.dst->Gmask &&
-                        info.src->Bmask == info.dst->Bmask &&
-                        info.src_blend != SDL_BLENDMODE_NONE &&
-                        pg_HasSSE_NEON() && (src != dst)) {
-                        blit_blend_rgba_min_sse2(&info);
-                        break;
-                    }
-#endif /* PG_ENABLE_SSE_NEON */
-#endif /* SDL_BYTEORDER == SDL_LIL_ENDIAN */
-#endif /* __EMSCRIPTEN__ */
-                    blit_blend_rgba_min(&info);
-                    break;
-                }
-                case PYGAME_BLEND_RGBA_MAX: {
-#if !defined(__EMSCRIPTEN__)
-#if SDL_BYTEORDER == SDL_LIL_ENDIAN
-                    if (PG_SURF_BytesPerPixel(src) == 4 &&
-                        PG_SURF_BytesPerPixel(dst) == 4 &&
-                        info.src->Rmask == info.dst->Rmask &&
-                        info.src->Gmask == info.dst->Gmask &&
-                        info.src->Bmask == info.dst->Bmask &&
-                        info.src_blend != SDL_BLENDMODE_NONE &&
-                        pg_has_avx2() && (src != dst)) {
-                        blit_blend_rgba_max_avx2(&info);
-                        break;
-                    }
-#if PG_ENABLE_SSE_NEON
-                    if (PG_SURF_BytesPerPixel(src) == 4 &&
-                        PG_SURF_BytesPerPixel(dst) == 4 &&
-                        info.src->Rmask == info.dst->Rmask &&
-                        info.src->Gmask == info.dst->Gmask &&
-                        info.src->Bmask == info.dst->Bmask &&
-                        info.src_blend != SDL_BLENDMODE_NONE &&
-                        pg_HasSSE_NEON() && (src != dst)) {
-                        blit_blend_rgba_max_sse2(&info);
-                        break;
-                    }
-#endif /* PG_ENABLE_SSE_NEON */
-#endif /* SDL_BYTEORDER == SDL_LIL_ENDIAN */
-#endif /* __EMSCRIPTEN__ */
-                    blit_blend_rgba_max(&info);
-                    break;
-                }
-                case PYGAME_BLEND_PREMULTIPLIED: {
-#if !defined(__EMSCRIPTEN__)
-#if SDL_BYTEORDER == SDL_LIL_ENDIAN
-                    if (PG_SURF_BytesPerPixel(src) == 4 &&
-                        PG_SURF_BytesPerPixel(dst) == 4 &&
-                        info.src->Rmask == info.dst->Rmask &&
-                        info.src->Gmask == info.dst->Gmask &&
-                        info.src->Bmask == info.dst->Bmask &&
-                        info.src_blend != SDL_BLENDMODE_NONE &&
-                        pg_has_avx2() && (src != dst)) {
-                        blit_blend_premultiplied_avx2(&info);
-                        break;
-                    }
-#if PG_ENABLE_SSE_NEON
-                    if (PG_SURF_BytesPerPixel(src) == 4 &&
-                        PG_SURF_BytesPerPixel(dst) == 4 &&
-                        info.src->Rmask == info.dst->Rmask &&
-                        info.src->Gmask == info.dst->Gmask &&
-                        info.src->Bmask == info.dst->Bmask &&
-                        info.src->Amask == 0xFF000000 &&
-                        info.src_blend != SDL_BLENDMODE_NONE &&
-                        pg_HasSSE_NEON() && (src != dst)) {
-                        blit_blend_premultiplied_sse2(&info);
-                        break;
-                    }
-#endif /* PG_ENABLE_SSE_NEON */
-#endif /* SDL_BYTEORDER == SDL_LIL_ENDIAN */
-#endif /* __EMSCRIPTEN__ */
-
-                    blit_blend_premultiplied(&info);
-                    break;
-                }
-                default: {
-                    SDL_SetError("Invalid argument passed to blit.");
-                    okay = 0;
-                    break;
-                }
+            if (!_pg_blend_flags_supported(blend_flags)) {
+                SDL_SetError("Invalid argument passed to blit.");
+                okay = 0;
+            }
+            else if (spans) {
+                _pg_blit_spans(src, dst, &info, spans, srcrect);
+            }
+            else if (bands > 1) {
+                pgBlitBand band = {src, dst, &info, blend_flags};
+
+                /* The row bands don't overlap in memory, so the result is
+                   the same as blitting serially */
+                Py_BEGIN_ALLOW_THREADS;
+                pg_ParallelForRows(info.height, bands, _pg_blit_band, &band);
+                Py_END_ALLOW_THREADS;
+            }
+            else {
+                _pg_blit_dispatch(src, dst, &info, blend_flags);
             }
         }
     }
@@ -1578,10 +1859,10 @@ alphablit_solid(SDL_BlitInfo *info)
     }
 }
 
-/*we assume the "dst" has pixel alpha*/
-int
-pygame_Blit(SDL_Surface *src, SDL_Rect *srcrect, SDL_Surface *dst,
-            SDL_Rect *dstrect, int blend_flags)
+static int
+_pg_blit_clipped(SDL_Surface *src, SDL_Rect *srcrect, SDL_Surface *dst,
+                 SDL_Rect *dstrect, int blend_flags,
+                 struct pgSpanCache *spans)
 {
     SDL_Rect fulldst;
     int srcx, srcy, w, h;
@@ -1680,12 +1961,192 @@ pygame_Blit(SDL_Surface *src, SDL_Rect *srcrect, SDL_Surface *dst,
         sr.y = srcy;
         sr.w = dstrect->w = w;
         sr.h = dstrect->h = h;
-        return SoftBlitPyGame(src, &sr, dst, dstrect, blend_flags);
+        return SoftBlitPyGame(src, &sr, dst, dstrect, blend_flags, spans);
     }
     dstrect->w = dstrect->h = 0;
     return 0;
 }
 
+/*we assume the "dst" has pixel alpha*/
+int
+pygame_Blit(SDL_Surface *src, SDL_Rect *srcrect, SDL_Surface *dst,
+            SDL_Rect *dstrect, int blend_flags)
+{
+    return _pg_blit_clipped(src, srcrect, dst, dstrect, blend_flags, NULL);
+}
+
+/* Span encoding */
+
+/* Copies the blending state of surf into spans, returns 1 if it differs
+ * from the state the runs were encoded for */
+static int
+_pg_span_state_update(SDL_Surface *surf, struct pgSpanCache *spans)
+{
+    Uint32 colorkey = 0;
+    Uint8 alpha = 255;
+    SDL_BlendMode blend = SDL_BLENDMODE_NONE;
+    int has_colorkey = SDL_HasColorKey(surf);
+    int changed;
+
+    if (has_colorkey) {
+        SDL_GetColorKey(surf, &colorkey);
+    }
+    PG_GetSurfaceAlphaMod(surf, &alpha);
+    PG_GetSurfaceBlendMode(surf, &blend);
+
+    changed = spans->pixels != surf->pixels || spans->w != surf->w ||
+              spans->h != surf->h || spans->pitch != surf->pitch ||
+              spans->format != (Uint32)PG_SURF_FORMATENUM(surf) ||
+              spans->has_colorkey != has_colorkey ||
+              spans->colorkey != colorkey || spans->alpha != alpha ||
+              spans->blend != blend;
+
+    spans->pixels = surf->pixels;
+    spans->w = surf->w;
+    spans->h = surf->h;
+    spans->pitch = surf->pitch;
+    spans->format = (Uint32)PG_SURF_FORMATENUM(surf);
+    spans->has_colorkey = has_colorkey;
+    spans->colorkey = colorkey;
+    spans->alpha = alpha;
+    spans->blend = blend;
+    return changed;
+}
+
+/* 0 for a fully transparent pixel, 1 for a translucent and 2 for a fully
+ * opaque one */
+static int
+_pg_span_class(Uint32 pixel, struct pgSpanCache *spans, Uint32 rgbmask,
+               Uint32 amask)
+{
+    if (spans->has_colorkey &&
+        (pixel & rgbmask) == (spans->colorkey & rgbmask)) {
+        return 0;
+    }
+    if (amask && spans->blend != SDL_BLENDMODE_NONE) {
+        if (!(pixel & amask)) {
+            return 0;
+        }
+        if ((pixel & amask) != amask) {
+            return 1;
+        }
+    }
+    return spans->alpha == 255 ? 2 : 1;
+}
+
+/* Re-encodes the runs of a 32 bit surf if its pixels or blending state
+ * changed since the last call. Returns -1 with an SDL error set if out of
+ * memory. */
+static int
+_pg_span_cache_update(SDL_Surface *surf, struct pgSpanCache *spans)
+{
+    PG_PixelFormat *fmt;
+    SDL_Palette *palette;
+    Uint32 rgbmask, *row;
+    int x, y, start, kind, count = 0;
+    int *rows;
+    struct pgSpan *runs;
+
+    if (!_pg_span_state_update(surf, spans) && spans->valid) {
+        return 0;
+    }
+    spans->valid = 0;
+    if (!PG_GetSurfaceDetails(surf, &fmt, &palette)) {
+        return -1;
+    }
+    rgbmask = fmt->Rmask | fmt->Gmask | fmt->Bmask;
+
+    rows = PyMem_Realloc(spans->rows, (surf->h + 1) * sizeof(int));
+    if (!rows) {
+        SDL_OutOfMemory();
+        return -1;
+    }
+    spans->rows = rows;
+
+    for (y = 0; y < surf->h; ++y) {
+        row = (Uint32 *)((Uint8 *)surf->pixels + (Sint64)y * surf->pitch);
+        rows[y] = count;
+        x = 0;
+        while (x < surf->w) {
+            start = x;
+            kind = _pg_span_class(row[x], spans, rgbmask, fmt->Amask);
+            do {
+                ++x;
+            } while (x < surf->w &&
+                     _pg_span_class(row[x], spans, rgbmask, fmt->Amask) ==
+                         kind);
+            if (!kind) {
+                continue;
+            }
+            if (count == spans->allocated) {
+                int allocated = spans->allocated ? spans->allocated * 2 : 64;
+
+                runs = PyMem_Realloc(spans->spans,
+                                     allocated * sizeof(struct pgSpan));
+                if (!runs) {
+                    SDL_OutOfMemory();
+                    return -1;
+                }
+                spans->spans = runs;
+                spans->allocated = allocated;
+            }
+            spans->spans[count].x = start;
+            spans->spans[count].len = x - start;
+            spans->spans[count].opaque = kind == 2;
+            ++count;
+        }
+    }
+    rows[surf->h] = count;
+    spans->valid = 1;
+    return 0;
+}
+
+/* Returns 1 if a blit with no blend flags from src to dst can use the span
+ * encoding of src */
+int
+pygame_SpanBlitSupported(SDL_Surface *src, SDL_Surface *dst)
+{
+    SDL_BlendMode blend;
+    Uint8 alpha;
+
+    if (PG_SURF_BytesPerPixel(src) != 4 || PG_SURF_BytesPerPixel(dst) != 4 ||
+        src->pixels == dst->pixels || PG_SurfaceHasRLE(src) ||
+        PG_SurfaceHasRLE(dst) || SDL_MUSTLOCK(src) || SDL_MUSTLOCK(dst) ||
+        !PG_GetSurfaceBlendMode(src, &blend) ||
+        !PG_GetSurfaceAlphaMod(src, &alpha)) {
+        return 0;
+    }
+    if (SDL_HasColorKey(src)) {
+        /* Only the plain copy SDL does for same format color keyed blits */
+        return !SDL_ISPIXELFORMAT_ALPHA(PG_SURF_FORMATENUM(src)) &&
+               PG_SURF_FORMATENUM(src) == PG_SURF_FORMATENUM(dst) &&
+               alpha == 255;
+    }
+    return SDL_ISPIXELFORMAT_ALPHA(PG_SURF_FORMATENUM(src)) &&
+           blend != SDL_BLENDMODE_NONE;
+}
+
+/* pygame_Blit with no blend flags, skipping the transparent runs of src */
+int
+pygame_SpanBlit(SDL_Surface *src, struct pgSpanCache *spans,
+                SDL_Rect *srcrect, SDL_Surface *dst, SDL_Rect *dstrect)
+{
+    if (_pg_span_cache_update(src, spans)) {
+        return -1;
+    }
+    return _pg_blit_clipped(src, srcrect, dst, dstrect, 0, spans);
+}
+
+void
+pygame_SpanCacheFree(struct pgSpanCache *spans)
+{
+    if (spans) {
+        PyMem_Free(spans->rows);
+        PyMem_Free(spans->spans);
+        PyMem_Free(spans);
+    }
+}
+
 int
 pygame_AlphaBlit(SDL_Surface *src, SDL_Rect *srcrect, SDL_Surface *dst,
                  SDL_Rect *dstrect, int blend_flags)
@@ -1728,7 +2189,11 @@ premul_surf_color_by_alpha(SDL_Surface *src, SDL_Surface *dst)
 #endif /* __SSE2__*/
 #if PG_ENABLE_ARM_NEON
     if ((PG_SURF_BytesPerPixel(src) == 4) && SDL_HasNEON()) {
+#if PG_ENABLE_NATIVE_NEON
+        premul_surf_color_by_alpha_neon(src, src_format, dst);
+#else
         premul_surf_color_by_alpha_sse2(src, src_format, dst);
+#endif /* PG_ENABLE_NATIVE_NEON */
         return 0;
     }
 #endif /* PG_ENABLE_ARM_NEON */
@@ -1784,6 +2249,99 @@ premul_surf_color_by_alpha_non_simd(SDL_Surface *src,
     }
 }
 
+#if !defined(__EMSCRIPTEN__) && SDL_BYTEORDER == SDL_LIL_ENDIAN
+/* Finds the byte of a pixel holding the 8 bit channel of mask, -1 if the
+ * format has no such channel, -2 if it is not a whole byte. */
+static int
+_pg_channel_byte(Uint32 mask, Uint8 shift)
+{
+    if (!mask) {
+        return -1;
+    }
+    if (mask != (Uint32)0xFF << shift || shift % 8) {
+        return -2;
+    }
+    return shift / 8;
+}
+#endif /* !__EMSCRIPTEN__ && SDL_BYTEORDER == SDL_LIL_ENDIAN */
+
+/* Copies the pixels of src into dst, a surface of the same size in another
+ * format, when both have 8 bit channels in 3 or 4 bytes per pixel and the
+ * conversion boils down to moving bytes around. Returns -1 when there is no
+ * fast path for the formats, leaving dst untouched, and -2 on SDL error.
+ * Both surfaces must be locked by the caller. */
+int
+convert_surf_pixels(SDL_Surface *src, SDL_Surface *dst)
+{
+#if !defined(__EMSCRIPTEN__)
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+    PG_PixelFormat *src_format, *dst_format;
+    SDL_Palette *src_palette, *dst_palette;
+    int srcbpp = PG_SURF_BytesPerPixel(src);
+    int dstbpp = PG_SURF_BytesPerPixel(dst);
+    int src_bytes[4], dst_bytes[4];
+    int shuffle[4] = {-1, -1, -1, -1};
+    int i;
+
+    if ((srcbpp != 3 && srcbpp != 4) || (dstbpp != 3 && dstbpp != 4) ||
+        src->w != dst->w || src->h != dst->h) {
+        return -1;
+    }
+    if (!PG_GetSurfaceDetails(src, &src_format, &src_palette) ||
+        !PG_GetSurfaceDetails(dst, &dst_format, &dst_palette)) {
+        return -2;
+    }
+
+    src_bytes[0] = _pg_channel_byte(src_format->Rmask, src_format->Rshift);
+    src_bytes[1] = _pg_channel_byte(src_format->Gmask, src_format->Gshift);
+    src_bytes[2] = _pg_channel_byte(src_format->Bmask, src_format->Bshift);
+    src_bytes[3] = _pg_channel_byte(src_format->Amask, src_format->Ashift);
+    dst_bytes[0] = _pg_channel_byte(dst_format->Rmask, dst_format->Rshift);
+    dst_bytes[1] = _pg_channel_byte(dst_format->Gmask, dst_format->Gshift);
+    dst_bytes[2] = _pg_channel_byte(dst_format->Bmask, dst_format->Bshift);
+    dst_bytes[3] = _pg_channel_byte(dst_format->Amask, dst_format->Ashift);
+
+    for (i = 0; i < 4; i++) {
+        if (src_bytes[i] == -2 || dst_bytes[i] == -2 ||
+            (i < 3 && (src_bytes[i] < 0 || dst_bytes[i] < 0))) {
+            return -1;
+        }
+        if (dst_bytes[i] >= 0) {
+            /* a missing source alpha is opaque */
+            shuffle[dst_bytes[i]] = src_bytes[i];
+        }
+    }
+    if (dstbpp == 4 && dst_bytes[3] < 0 && srcbpp == 4) {
+        /* the unused byte keeps whatever the unused or alpha byte of the
+         * source held, the byte left over by the color channels */
+        shuffle[6 - dst_bytes[0] - dst_bytes[1] - dst_bytes[2]] =
+            6 - src_bytes[0] - src_bytes[1] - src_bytes[2];
+    }
+
+    if (pg_has_avx2()) {
+        convert_surf_pixels_avx2(src, dst, shuffle);
+        return 0;
+    }
+    if (srcbpp != 4 || dstbpp != 4) {
+        return -1;
+    }
+#if defined(__SSE2__)
+    if (SDL_HasSSE2()) {
+        convert_surf_pixels_sse2(src, dst, shuffle);
+        return 0;
+    }
+#endif /* __SSE2__*/
+#if PG_ENABLE_ARM_NEON
+    if (SDL_HasNEON()) {
+        convert_surf_pixels_sse2(src, dst, shuffle);
+        return 0;
+    }
+#endif /* PG_ENABLE_ARM_NEON */
+#endif /* SDL_BYTEORDER == SDL_LIL_ENDIAN */
+#endif /* __EMSCRIPTEN__ */
+    return -1;
+}
+
 #define _PG_WARN_SIMD(s)                                              \
     if (pg_##s##_at_runtime_but_uncompiled()) {                       \
         if (PyErr_WarnEx(                                             \
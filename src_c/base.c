@@ -257,6 +257,8 @@ pg_init(PyObject *self, PyObject *_null)
 void
 pg_atexit_quit(void)
 {
+    pg_ParallelQuit();
+
     /* Maybe it is safe to call SDL_quit more than once after an SDL_Init,
        but this is undocumented. So play it safe and only call after a
        successful SDL_Init.
@@ -1981,6 +1983,259 @@ pg_EnvShouldBlendAlphaSDL2(void)
     return pg_env_blend_alpha_SDL2;
 }
 
+/* Worker pool used to split large per-pixel loops (blits, transforms) into
+ * row bands. Only one job runs on the pool at a time, a caller that finds the
+ * pool busy simply runs its job serially. The callers are expected to release
+ * the GIL around pg_ParallelForRows, the workers never touch Python. */
+#define PG_PARALLEL_MAX_THREADS 64
+#define PG_PARALLEL_DEFAULT_THRESHOLD (512 * 512)
+
+static int pg_parallel_num_threads = 1;
+static Py_ssize_t pg_parallel_threshold = PG_PARALLEL_DEFAULT_THRESHOLD;
+
+#ifndef __EMSCRIPTEN__
+static struct {
+    SDL_mutex *lock;
+    SDL_cond *wake;
+    SDL_cond *done;
+    SDL_Thread *threads[PG_PARALLEL_MAX_THREADS];
+    int num_workers;
+    int quitting;
+    int busy;
+    /* the job currently being run, if any */
+    pg_rowbandproc func;
+    void *data;
+    int rows;
+    int bands;
+    int next_band;
+    int pending;
+} pg_worker_pool = {0};
+
+/* Runs the unclaimed bands of the current job, must hold the pool lock */
+static void
+_pg_parallel_run_bands(void)
+{
+    while (pg_worker_pool.next_band < pg_worker_pool.bands) {
+        int band = pg_worker_pool.next_band++;
+        int start =
+            (int)((Sint64)pg_worker_pool.rows * band / pg_worker_pool.bands);
+        int end = (int)((Sint64)pg_worker_pool.rows * (band + 1) /
+                        pg_worker_pool.bands);
+        pg_rowbandproc func = pg_worker_pool.func;
+        void *data = pg_worker_pool.data;
+
+        PG_UnlockMutex(pg_worker_pool.lock);
+        func(data, start, end);
+        PG_LockMutex(pg_worker_pool.lock);
+
+        if (--pg_worker_pool.pending == 0) {
+            SDL_CondBroadcast(pg_worker_pool.done);
+        }
+    }
+}
+
+static int SDLCALL
+_pg_parallel_worker(void *unused)
+{
+    PG_LockMutex(pg_worker_pool.lock);
+    while (!pg_worker_pool.quitting) {
+        if (pg_worker_pool.next_band < pg_worker_pool.bands) {
+            _pg_parallel_run_bands();
+        }
+        else {
+            SDL_CondWait(pg_worker_pool.wake, pg_worker_pool.lock);
+        }
+    }
+    PG_UnlockMutex(pg_worker_pool.lock);
+    return 0;
+}
+#endif /* ~__EMSCRIPTEN__ */
+
+static void
+_pg_parallel_init(void)
+{
+#ifndef __EMSCRIPTEN__
+    /* Like the event filter mutex, these are never freed. If any of them
+     * can't be created everything just runs serially. */
+    SDL_mutex *lock = SDL_CreateMutex();
+    SDL_cond *wake = SDL_CreateCond();
+    SDL_cond *done = SDL_CreateCond();
+
+    if (!lock || !wake || !done) {
+        if (lock) {
+            SDL_DestroyMutex(lock);
+        }
+        if (wake) {
+            SDL_DestroyCond(wake);
+        }
+        if (done) {
+            SDL_DestroyCond(done);
+        }
+        return;
+    }
+    pg_worker_pool.lock = lock;
+    pg_worker_pool.wake = wake;
+    pg_worker_pool.done = done;
+#endif /* ~__EMSCRIPTEN__ */
+}
+
+/* Returns how many row bands a job of the given size should be split into,
+ * 1 meaning it should just run serially on the calling thread. work is the
+ * number of pixels the job touches. */
+int
+pg_ParallelBandCount(int rows, Py_ssize_t work)
+{
+#ifdef __EMSCRIPTEN__
+    return 1;
+#else
+    if (pg_parallel_num_threads <= 1 || work < pg_parallel_threshold ||
+        rows < 2) {
+        return 1;
+    }
+    return MIN(pg_parallel_num_threads, rows);
+#endif
+}
+
+/* Calls func over the rows [0, rows) split into the given number of bands.
+ * The calling thread takes part in the work, and this only returns once all
+ * bands have finished. Falls back to a single serial call if the pool is
+ * unavailable or already in use. */
+void
+pg_ParallelForRows(int rows, int bands, pg_rowbandproc func, void *data)
+{
+#ifndef __EMSCRIPTEN__
+    if (bands > rows) {
+        bands = rows;
+    }
+    if (bands > 1 && pg_worker_pool.lock) {
+        PG_LockMutex(pg_worker_pool.lock);
+        if (!pg_worker_pool.busy && !pg_worker_pool.quitting) {
+            while (pg_worker_pool.num_workers < bands - 1 &&
+                   pg_worker_pool.num_workers < PG_PARALLEL_MAX_THREADS) {
+                SDL_Thread *thread = SDL_CreateThread(
+                    _pg_parallel_worker, "pygame worker", NULL);
+                if (!thread) {
+                    break;
+                }
+                pg_worker_pool.threads[pg_worker_pool.num_workers++] = thread;
+            }
+        }
+        if (!pg_worker_pool.busy && !pg_worker_pool.quitting &&
+            pg_worker_pool.num_workers) {
+            pg_worker_pool.busy = 1;
+            pg_worker_pool.func = func;
+            pg_worker_pool.data = data;
+            pg_worker_pool.rows = rows;
+            pg_worker_pool.bands = bands;
+            pg_worker_pool.next_band = 0;
+            pg_worker_pool.pending = bands;
+            SDL_CondBroadcast(pg_worker_pool.wake);
+
+            _pg_parallel_run_bands();
+            while (pg_worker_pool.pending) {
+                SDL_CondWait(pg_worker_pool.done, pg_worker_pool.lock);
+            }
+
+            pg_worker_pool.func = NULL;
+            pg_worker_pool.data = NULL;
+            pg_worker_pool.bands = pg_worker_pool.next_band = 0;
+            pg_worker_pool.busy = 0;
+            /* wake up anyone waiting in pg_ParallelQuit */
+            SDL_CondBroadcast(pg_worker_pool.done);
+            PG_UnlockMutex(pg_worker_pool.lock);
+            return;
+        }
+        PG_UnlockMutex(pg_worker_pool.lock);
+    }
+#endif /* ~__EMSCRIPTEN__ */
+    func(data, 0, rows);
+}
+
+/* Joins all worker threads. They are started again on demand, so this is safe
+ * to call from pygame.quit() */
+void
+pg_ParallelQuit(void)
+{
+#ifndef __EMSCRIPTEN__
+    int i, num_workers;
+
+    if (!pg_worker_pool.lock) {
+        return;
+    }
+
+    PG_LockMutex(pg_worker_pool.lock);
+    while (pg_worker_pool.busy) {
+        SDL_CondWait(pg_worker_pool.done, pg_worker_pool.lock);
+    }
+    pg_worker_pool.quitting = 1;
+    num_workers = pg_worker_pool.num_workers;
+    SDL_CondBroadcast(pg_worker_pool.wake);
+    PG_UnlockMutex(pg_worker_pool.lock);
+
+    for (i = 0; i < num_workers; i++) {
+        SDL_WaitThread(pg_worker_pool.threads[i], NULL);
+        pg_worker_pool.threads[i] = NULL;
+    }
+
+    PG_LockMutex(pg_worker_pool.lock);
+    pg_worker_pool.num_workers = 0;
+    pg_worker_pool.quitting = 0;
+    PG_UnlockMutex(pg_worker_pool.lock);
+#endif /* ~__EMSCRIPTEN__ */
+}
+
+PyObject *
+pg_set_num_threads(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+    int num_threads;
+    PyObject *threshold_obj = Py_None, *old;
+    Py_ssize_t threshold = -1;
+
+    static char *keywords[] = {"num_threads", "threshold", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "i|O", keywords,
+                                     &num_threads, &threshold_obj)) {
+        return NULL;
+    }
+
+    if (num_threads < 0) {
+        return RAISE(PyExc_ValueError, "num_threads must not be negative");
+    }
+    if (threshold_obj != Py_None) {
+        threshold = PyLong_AsSsize_t(threshold_obj);
+        if (threshold == -1 && PyErr_Occurred()) {
+            return NULL;
+        }
+        if (threshold < 0) {
+            return RAISE(PyExc_ValueError, "threshold must not be negative");
+        }
+    }
+
+    /* The previous settings, so that they can be restored */
+    old =
+        Py_BuildValue("(in)", pg_parallel_num_threads, pg_parallel_threshold);
+    if (!old) {
+        return NULL;
+    }
+
+    if (num_threads == 0) {
+        num_threads = SDL_GetCPUCount();
+    }
+    pg_parallel_num_threads =
+        MAX(1, MIN(num_threads, PG_PARALLEL_MAX_THREADS + 1));
+    if (threshold >= 0) {
+        pg_parallel_threshold = threshold;
+    }
+
+    return old;
+}
+
+PyObject *
+pg_get_num_threads(PyObject *self, PyObject *_null)
+{
+    return PyLong_FromLong(pg_parallel_num_threads);
+}
+
 /*error signal handlers(replacing SDL parachute)*/
 void
 pygame_parachute(int sig)
@@ -2103,6 +2358,10 @@ static PyMethodDef _base_methods[] = {
      METH_VARARGS | METH_KEYWORDS, DOC_GETSDLVERSION},
     {"get_sdl_byteorder", (PyCFunction)pg_get_sdl_byteorder, METH_NOARGS,
      DOC_GETSDLBYTEORDER},
+    {"set_num_threads", (PyCFunction)pg_set_num_threads,
+     METH_VARARGS | METH_KEYWORDS, DOC_SETNUMTHREADS},
+    {"get_num_threads", (PyCFunction)pg_get_num_threads, METH_NOARGS,
+     DOC_GETNUMTHREADS},
     {"get_array_interface", (PyCFunction)pg_get_array_interface, METH_O,
      "return an array struct interface as an interface dictionary"},
 #if defined(BUILD_STATIC)
@@ -2204,8 +2463,10 @@ MODINIT_DEFINE(base)
     c_api[27] = pg_GetDefaultConvertFormat;
     c_api[28] = pg_SetDefaultConvertFormat;
     c_api[29] = pgObject_getRectHelper;
+    c_api[30] = pg_ParallelBandCount;
+    c_api[31] = pg_ParallelForRows;
 
-#define FILLED_SLOTS 30
+#define FILLED_SLOTS 32
 
 #if PYGAMEAPI_BASE_NUMSLOTS != FILLED_SLOTS
 #error export slot count mismatch
@@ -2259,6 +2520,8 @@ MODINIT_DEFINE(base)
         goto error;
     }
 
+    _pg_parallel_init();
+
 #ifdef MS_WIN32
     SDL_RegisterApp("pygame", 0, GetModuleHandle(NULL));
 #endif
@@ -2659,6 +2922,8 @@ PyInit_pygame_static()
 #undef pgSurface_UnlockBy
 #undef pgSurface_Prep
 #undef pgSurface_Unprep
+#undef pgSurface_Unshare
+#undef pgSurface_LockRead
 
 #include "surflock.c"
 
@@ -2678,10 +2943,17 @@ PyInit_pygame_static()
 #undef pgSurface_New
 #undef pgSurface_Type
 #undef pgSurface_SetSurface
+#undef pgSurface_AddDirtyRect
+#undef pgSurface_PoolCreate
+#undef pgSurface_PoolRelease
+#undef pgSurface_PoolStats
+#undef pgSurface_PoolSetBudget
 
 #include "surface.c"
 #include "simd_blitters_avx2.c"
+#include "simd_blitters_avx512.c"
 #include "simd_blitters_sse2.c"
+#include "simd_blitters_neon.c"
 
 #include "window.c"
 
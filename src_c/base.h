@@ -219,6 +219,17 @@ pg_SetDefaultConvertFormat(PG_PixelFormatEnum format);
 PG_PixelFormatEnum
 pg_GetDefaultConvertFormat(void);
 
+int
+pg_ParallelBandCount(int rows, Py_ssize_t work);
+void
+pg_ParallelForRows(int rows, int bands, pg_rowbandproc func, void *data);
+void
+pg_ParallelQuit(void);
+PyObject *
+pg_set_num_threads(PyObject *self, PyObject *args, PyObject *kwargs);
+PyObject *
+pg_get_num_threads(PyObject *self, PyObject *_null);
+
 #if defined(BUILD_STATIC) && defined(NO_PYGAME_C_API)
 // in case of wasm+dynamic loading it could be a trampoline in the globals
 // generated at runtime.
@@ -2206,6 +2206,14 @@ pg_flip_internal(_DisplayState *state)
         return -1;
     }
 
+    /* The whole window is up to date now */
+    if (!state->using_gl) {
+        pgSurfaceObject *screen = pg_GetDefaultWindowSurface();
+        if (screen && screen->dirty) {
+            screen->dirty->count = 0;
+        }
+    }
+
     return 0;
 }
 
@@ -2251,6 +2259,30 @@ pg_screencroprect(SDL_Rect *r, int w, int h, SDL_Rect *cur)
     return cur;
 }
 
+/* Updates the areas of the display Surface recorded by its dirty rect
+ * tracking, see Surface.set_dirty_tracking() */
+static PyObject *
+pg_update_dirty_rects(SDL_Window *win, pgSurfaceObject *screen, int w, int h)
+{
+    struct pgDirtyRects *dirty = screen->dirty;
+    SDL_Rect rects[PG_DIRTY_RECTS_MAX];
+    int i, count = 0;
+
+    for (i = 0; i < dirty->count; i++) {
+        if (pg_screencroprect(&dirty->rects[i], w, h, &rects[count])) {
+            ++count;
+        }
+    }
+    dirty->count = 0;
+
+    if (count) {
+        Py_BEGIN_ALLOW_THREADS;
+        SDL_UpdateWindowSurfaceRects(win, rects, count);
+        Py_END_ALLOW_THREADS;
+    }
+    Py_RETURN_NONE;
+}
+
 static PyObject *
 pg_update(PyObject *self, PyObject *arg)
 {
@@ -2276,6 +2308,14 @@ pg_update(PyObject *self, PyObject *arg)
 
     /*determine type of argument we got*/
     if (PyTuple_Size(arg) == 0) {
+        pgSurfaceObject *screen = pg_GetDefaultWindowSurface();
+
+        /* Only push the areas that changed, unless the window surface was
+         * recreated (e.g. resized) and needs a full update */
+        if (screen && screen->dirty &&
+            screen->surf == SDL_GetWindowSurface(win)) {
+            return pg_update_dirty_rects(win, screen, wide, high);
+        }
         return pg_flip(self, NULL);
     }
 
@@ -9,6 +9,8 @@
 #define DOC_SETERROR "set_error(error_msg, /) -> None\nset the current error message"
 #define DOC_GETSDLVERSION "get_sdl_version(linked=True) -> major, minor, patch\nget the version number of SDL"
 #define DOC_GETSDLBYTEORDER "get_sdl_byteorder() -> int\nget the byte order of SDL"
+#define DOC_SETNUMTHREADS "set_num_threads(num_threads, threshold=None) -> tuple[int, int]\nset how many threads pygame may use for large pixel operations"
+#define DOC_GETNUMTHREADS "get_num_threads() -> int\nget how many threads pygame may use for large pixel operations"
 #define DOC_REGISTERQUIT "register_quit(callable, /) -> None\nregister a function to be called when pygame quits"
 #define DOC_ENCODESTRING "encode_string([obj [, encoding [, errors [, etype]]]]) -> bytes or None\nEncode a Unicode or bytes object"
 #define DOC_ENCODEFILEPATH "encode_file_path([obj [, etype]]) -> bytes or None\nEncode a Unicode or bytes object as a file system path"
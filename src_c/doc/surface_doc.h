@@ -3,10 +3,16 @@
 #define DOC_SURFACE_BLIT "blit(source, dest=(0, 0), area=None, special_flags=0) -> Rect\nDraw another Surface onto this one."
 #define DOC_SURFACE_BLITS "blits(blit_sequence, doreturn=1) -> list[Rect] | None\nDraw many Surfaces onto this Surface at their corresponding location."
 #define DOC_SURFACE_FBLITS "fblits(blit_sequence, special_flags=0, /) -> None\nDraw many Surfaces onto this Surface at their corresponding location and with the same special_flags."
+#define DOC_SURFACE_BLITTRANSFORMED "blit_transformed(source, dest, angle=0, scale=1, flip_x=False, flip_y=False, special_flags=0, smooth=True) -> Rect\nDraw a rotated, scaled and flipped image onto this Surface."
+#define DOC_SURFACE_BLITTILED "blit_tiled(source, dest, offset=(0, 0), special_flags=0) -> Rect\nFill an area of this Surface with copies of a Surface."
+#define DOC_SURFACE_BLITNINESLICE "blit_nine_slice(source, dest, borders, mode='stretch', special_flags=0) -> Rect\nDraw a Surface resized to a rect, keeping its borders intact."
+#define DOC_SURFACE_BLITTILEMAP "blit_tilemap(tileset, tile_size, tiles, offset=(0, 0), viewport=None, special_flags=0) -> Rect\nDraw the visible part of a grid of tiles onto this Surface."
 #define DOC_SURFACE_CONVERT "convert(surface, /) -> Surface\nconvert(depth, flags=0, /) -> Surface\nconvert(masks, flags=0, /) -> Surface\nconvert() -> Surface\nChange the pixel format of a Surface."
 #define DOC_SURFACE_CONVERTALPHA "convert_alpha() -> Surface\nChange the pixel format of a Surface including per pixel alphas."
 #define DOC_SURFACE_COPY "copy() -> Surface\nCreate a new copy of a Surface."
 #define DOC_SURFACE_FILL "fill(color, rect=None, special_flags=0) -> Rect\nFill Surface with a solid color."
+#define DOC_SURFACE_FILLRECTS "fill_rects(color, rects, special_flags=0) -> Rect\nFill many rectangles with solid colors."
+#define DOC_SURFACE_FILLGRADIENT "fill_gradient(rect, stops, kind='linear', angle=0, special_flags=0) -> Rect\nFill a rectangle with a gradient."
 #define DOC_SURFACE_SCROLL "scroll(dx=0, dy=0, scroll_flag=0, /) -> None\nShift the Surface pixels in place."
 #define DOC_SURFACE_SETCOLORKEY "set_colorkey(color, flags=0, /) -> None\nset_colorkey(color, /) -> None\nSet the transparent colorkey."
 #define DOC_SURFACE_GETCOLORKEY "get_colorkey() -> tuple[int, int, int, int] | None\nGet the current transparent colorkey."
@@ -52,7 +58,18 @@
 #define DOC_SURFACE_GETBUFFER "get_buffer() -> BufferProxy\nAcquires a buffer object for the pixels of the Surface."
 #define DOC_SURFACE_PREMULALPHA "premul_alpha() -> Surface\nReturns a copy of the Surface with the RGB channels pre-multiplied by the alpha channel."
 #define DOC_SURFACE_PREMULALPHAIP "premul_alpha_ip() -> Surface\nMultiplies the RGB channels by the Surface alpha channel."
+#define DOC_SURFACE_SETDIRTYTRACKING "set_dirty_tracking(enabled=True, /) -> None\nTurn recording of the changed areas of the Surface on or off."
+#define DOC_SURFACE_GETDIRTYTRACKING "get_dirty_tracking() -> bool\nTest if the changed areas of the Surface are recorded."
+#define DOC_SURFACE_GETDIRTYRECTS "get_dirty_rects() -> list[Rect]\nGet the areas of the Surface changed since the last clear."
+#define DOC_SURFACE_CLEARDIRTY "clear_dirty() -> None\nForget the recorded changed areas of the Surface."
+#define DOC_SURFACE_SETSPANENCODING "set_span_encoding(enabled=True, /) -> None\nTurn the span encoding of the visible pixels of the Surface on or off."
+#define DOC_SURFACE_GETSPANENCODING "get_span_encoding() -> bool\nTest if the visible pixels of the Surface are span encoded."
 #define DOC_SURFACE_WIDTH "width -> int\nSurface width in pixels (read-only)."
 #define DOC_SURFACE_HEIGHT "height -> int\nSurface height in pixels (read-only)."
 #define DOC_SURFACE_SIZE "size -> tuple[int, int]\nSurface size in pixels (read-only)."
 #define DOC_SURFACE_PIXELSADDRESS "_pixels_address -> int\nPixel buffer address."
+#define DOC_BLITBATCH "BlitBatch(blit_sequence=()) -> BlitBatch\nPygame object for storing a reusable sequence of blits."
+#define DOC_BLITBATCH_APPEND "append(source, dest, area=None, special_flags=0) -> None\nAdd a single blit to the end of the batch."
+#define DOC_BLITBATCH_EXTEND "extend(blit_sequence, /) -> None\nAdd many blits to the end of the batch."
+#define DOC_BLITBATCH_CLEAR "clear() -> None\nRemove all blits from the batch."
+#define DOC_BLITBATCH_SETPOSITIONS "set_positions(positions, /) -> None\nUpdate the destination of every blit in the batch at once."
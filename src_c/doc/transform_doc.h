@@ -1,19 +1,29 @@
 /* Auto generated file: with make_docs.py .  Docs go in docs/reST/ref/ . */
 #define DOC_TRANSFORM "Pygame module to transform surfaces."
 #define DOC_TRANSFORM_FLIP "flip(surface, flip_x, flip_y) -> Surface\nFlip vertically and horizontally."
-#define DOC_TRANSFORM_SCALE "scale(surface, size, dest_surface=None) -> Surface\nResize to new resolution."
-#define DOC_TRANSFORM_SCALEBY "scale_by(surface, factor, dest_surface=None) -> Surface\nResize to new resolution, using scalar(s)."
+#define DOC_TRANSFORM_SCALE "scale(surface, size, dest_surface=None, filter='nearest') -> Surface\nResize to new resolution."
+#define DOC_TRANSFORM_SCALEBY "scale_by(surface, factor, dest_surface=None, filter='nearest') -> Surface\nResize to new resolution, using scalar(s)."
 #define DOC_TRANSFORM_ROTATE "rotate(surface, angle) -> Surface\nRotate an image."
 #define DOC_TRANSFORM_ROTOZOOM "rotozoom(surface, angle, scale) -> Surface\nFiltered scale and rotation."
 #define DOC_TRANSFORM_SCALE2X "scale2x(surface, dest_surface=None) -> Surface\nSpecialized image doubler."
+#define DOC_TRANSFORM_SCALE3X "scale3x(surface, dest_surface=None) -> Surface\nSpecialized image tripler."
+#define DOC_TRANSFORM_SCALE4X "scale4x(surface, dest_surface=None) -> Surface\nSpecialized image quadrupler."
+#define DOC_TRANSFORM_XBR2X "xbr2x(surface, dest_surface=None) -> Surface\nEdge blending image doubler."
 #define DOC_TRANSFORM_SMOOTHSCALE "smoothscale(surface, size, dest_surface=None) -> Surface\nScale a surface to an arbitrary size smoothly."
 #define DOC_TRANSFORM_SMOOTHSCALEBY "smoothscale_by(surface, factor, dest_surface=None) -> Surface\nResize to new resolution, using scalar(s)."
-#define DOC_TRANSFORM_GETSMOOTHSCALEBACKEND "get_smoothscale_backend() -> Literal['GENERIC', 'SSE2', 'NEON']\nReturn smoothscale filter version in use: 'GENERIC', 'MMX', 'SSE', 'SSE2', or 'NEON'."
-#define DOC_TRANSFORM_SETSMOOTHSCALEBACKEND "set_smoothscale_backend(backend) -> None\nSet smoothscale filter version to one of: 'GENERIC', 'MMX', 'SSE', 'SSE2', or 'NEON'."
+#define DOC_TRANSFORM_BUILDMIPMAPS "build_mipmaps(surface, levels=-1) -> list[Surface]\nBuild a chain of half size copies of a surface."
+#define DOC_TRANSFORM_SCALEMIPMAPPED "scale_mipmapped(chain, size, dest_surface=None) -> Surface\nScale a surface to an arbitrary size using a chain of mipmaps."
+#define DOC_TRANSFORM_GETSMOOTHSCALEBACKEND "get_smoothscale_backend() -> Literal['GENERIC', 'SSE2', 'AVX2', 'NEON']\nReturn smoothscale filter version in use: 'GENERIC', 'MMX', 'SSE', 'SSE2', 'AVX2', or 'NEON'."
+#define DOC_TRANSFORM_SETSMOOTHSCALEBACKEND "set_smoothscale_backend(backend) -> None\nSet smoothscale filter version to one of: 'GENERIC', 'MMX', 'SSE', 'SSE2', 'AVX2', or 'NEON'."
+#define DOC_TRANSFORM_GETPOOLSTATS "get_pool_stats() -> dict[str, int]\nReturn statistics about the pool of recycled transform surfaces."
+#define DOC_TRANSFORM_SETPOOLBUDGET "set_pool_budget(budget) -> None\nSet how many bytes of pixels the pool of recycled transform surfaces may keep."
 #define DOC_TRANSFORM_CHOP "chop(surface, rect) -> Surface\nGets a copy of an image with an interior area removed."
 #define DOC_TRANSFORM_LAPLACIAN "laplacian(surface, dest_surface=None) -> Surface\nFind edges in a surface."
 #define DOC_TRANSFORM_BOXBLUR "box_blur(surface, radius, repeat_edge_pixels=True, dest_surface=None) -> Surface\nBlur a surface using box blur."
-#define DOC_TRANSFORM_GAUSSIANBLUR "gaussian_blur(surface, radius, repeat_edge_pixels=True, dest_surface=None) -> Surface\nBlur a surface using gaussian blur."
+#define DOC_TRANSFORM_GAUSSIANBLUR "gaussian_blur(surface, radius, repeat_edge_pixels=True, dest_surface=None, mode='exact') -> Surface\nBlur a surface using gaussian blur."
+#define DOC_TRANSFORM_CONVOLVE "convolve(surface, kernel, dest_surface=None, separable=None, border='clamp') -> Surface\nApply a convolution kernel to a surface."
+#define DOC_TRANSFORM_APPLYLUT "apply_lut(surface, r_lut=None, g_lut=None, b_lut=None, a_lut=None, dest_surface=None) -> Surface\nMap each channel of a surface through a lookup table."
+#define DOC_TRANSFORM_COLORMATRIX "color_matrix(surface, matrix, dest_surface=None) -> Surface\nTransform the colors of a surface with a 4x5 matrix."
 #define DOC_TRANSFORM_AVERAGESURFACES "average_surfaces(surfaces, dest_surface=None, palette_colors=1) -> Surface\nFind the average surface from many surfaces."
 #define DOC_TRANSFORM_AVERAGECOLOR "average_color(surface, rect=None, consider_alpha=False) -> tuple[int, int, int, int]\nFinds the average color of a surface."
 #define DOC_TRANSFORM_INVERT "invert(surface, dest_surface=None) -> Surface\nInverts the RGB elements of a surface."
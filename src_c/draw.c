@@ -124,6 +124,19 @@ unsafe_set_at(SDL_Surface *surf, int x, int y, Uint32 color);
 
 /* Definition of functions that get called in Python */
 
+/* Returns the bounding box of a non empty drawn_area as a Rect, after
+ * recording it as a changed area of the surface. */
+static PyObject *
+_drawn_area_rect(pgSurfaceObject *surfobj, int *drawn_area)
+{
+    SDL_Rect rect = {drawn_area[0], drawn_area[1],
+                     drawn_area[2] - drawn_area[0] + 1,
+                     drawn_area[3] - drawn_area[1] + 1};
+
+    pgSurface_AddDirtyRect(surfobj, &rect);
+    return pgRect_New(&rect);
+}
+
 /* Draws an antialiased line on the given surface.
  *
  * Returns a Rect bounding the drawn area.
@@ -211,9 +224,7 @@ aaline(PyObject *self, PyObject *arg, PyObject *kwargs)
 
     if (drawn_area[0] != INT_MAX && drawn_area[1] != INT_MAX &&
         drawn_area[2] != INT_MIN && drawn_area[3] != INT_MIN) {
-        return pgRect_New4(drawn_area[0], drawn_area[1],
-                           drawn_area[2] - drawn_area[0] + 1,
-                           drawn_area[3] - drawn_area[1] + 1);
+        return _drawn_area_rect(surfobj, drawn_area);
     }
     else {
         return pgRect_New4((int)startx, (int)starty, 0, 0);
@@ -286,9 +297,7 @@ line(PyObject *self, PyObject *arg, PyObject *kwargs)
     /* Compute return rect. */
     if (drawn_area[0] != INT_MAX && drawn_area[1] != INT_MAX &&
         drawn_area[2] != INT_MIN && drawn_area[3] != INT_MIN) {
-        return pgRect_New4(drawn_area[0], drawn_area[1],
-                           drawn_area[2] - drawn_area[0] + 1,
-                           drawn_area[3] - drawn_area[1] + 1);
+        return _drawn_area_rect(surfobj, drawn_area);
     }
     else {
         return pgRect_New4(startx, starty, 0, 0);
@@ -508,9 +517,7 @@ aalines(PyObject *self, PyObject *arg, PyObject *kwargs)
     /* Compute return rect. */
     if (drawn_area[0] != INT_MAX && drawn_area[1] != INT_MAX &&
         drawn_area[2] != INT_MIN && drawn_area[3] != INT_MIN) {
-        return pgRect_New4(drawn_area[0], drawn_area[1],
-                           drawn_area[2] - drawn_area[0] + 1,
-                           drawn_area[3] - drawn_area[1] + 1);
+        return _drawn_area_rect(surfobj, drawn_area);
     }
     else {
         return pgRect_New4(l, t, 0, 0);
@@ -638,9 +645,7 @@ lines(PyObject *self, PyObject *arg, PyObject *kwargs)
     /* Compute return rect. */
     if (drawn_area[0] != INT_MAX && drawn_area[1] != INT_MAX &&
         drawn_area[2] != INT_MIN && drawn_area[3] != INT_MIN) {
-        return pgRect_New4(drawn_area[0], drawn_area[1],
-                           drawn_area[2] - drawn_area[0] + 1,
-                           drawn_area[3] - drawn_area[1] + 1);
+        return _drawn_area_rect(surfobj, drawn_area);
     }
     else {
         return pgRect_New4(x, y, 0, 0);
@@ -720,9 +725,7 @@ arc(PyObject *self, PyObject *arg, PyObject *kwargs)
     /* Compute return rect. */
     if (drawn_area[0] != INT_MAX && drawn_area[1] != INT_MAX &&
         drawn_area[2] != INT_MIN && drawn_area[3] != INT_MIN) {
-        return pgRect_New4(drawn_area[0], drawn_area[1],
-                           drawn_area[2] - drawn_area[0] + 1,
-                           drawn_area[3] - drawn_area[1] + 1);
+        return _drawn_area_rect(surfobj, drawn_area);
     }
     else {
         return pgRect_New4(rect->x, rect->y, 0, 0);
@@ -794,9 +797,7 @@ ellipse(PyObject *self, PyObject *arg, PyObject *kwargs)
 
     if (drawn_area[0] != INT_MAX && drawn_area[1] != INT_MAX &&
         drawn_area[2] != INT_MIN && drawn_area[3] != INT_MIN) {
-        return pgRect_New4(drawn_area[0], drawn_area[1],
-                           drawn_area[2] - drawn_area[0] + 1,
-                           drawn_area[3] - drawn_area[1] + 1);
+        return _drawn_area_rect(surfobj, drawn_area);
     }
     else {
         return pgRect_New4(rect->x, rect->y, 0, 0);
@@ -906,9 +907,7 @@ circle(PyObject *self, PyObject *args, PyObject *kwargs)
     }
     if (drawn_area[0] != INT_MAX && drawn_area[1] != INT_MAX &&
         drawn_area[2] != INT_MIN && drawn_area[3] != INT_MIN) {
-        return pgRect_New4(drawn_area[0], drawn_area[1],
-                           drawn_area[2] - drawn_area[0] + 1,
-                           drawn_area[3] - drawn_area[1] + 1);
+        return _drawn_area_rect(surfobj, drawn_area);
     }
     else {
         return pgRect_New4(posx, posy, 0, 0);
@@ -1040,9 +1039,7 @@ aacircle(PyObject *self, PyObject *args, PyObject *kwargs)
     }
     if (drawn_area[0] != INT_MAX && drawn_area[1] != INT_MAX &&
         drawn_area[2] != INT_MIN && drawn_area[3] != INT_MIN) {
-        return pgRect_New4(drawn_area[0], drawn_area[1],
-                           drawn_area[2] - drawn_area[0] + 1,
-                           drawn_area[3] - drawn_area[1] + 1);
+        return _drawn_area_rect(surfobj, drawn_area);
     }
     else {
         return pgRect_New4(posx, posy, 0, 0);
@@ -1159,9 +1156,7 @@ polygon(PyObject *self, PyObject *arg, PyObject *kwargs)
 
     if (drawn_area[0] != INT_MAX && drawn_area[1] != INT_MAX &&
         drawn_area[2] != INT_MIN && drawn_area[3] != INT_MIN) {
-        return pgRect_New4(drawn_area[0], drawn_area[1],
-                           drawn_area[2] - drawn_area[0] + 1,
-                           drawn_area[3] - drawn_area[1] + 1);
+        return _drawn_area_rect(surfobj, drawn_area);
     }
     else {
         return pgRect_New4(l, t, 0, 0);
@@ -1247,7 +1242,9 @@ rect(PyObject *self, PyObject *args, PyObject *kwargs)
                       width, color);
         }
         else {
-            pgSurface_Prep(surfobj);
+            if (!pgSurface_Prep(surfobj)) {
+                return NULL;
+            }
             pgSurface_Lock(surfobj);
             bool success = PG_FillSurfaceRect(surf, &clipped, color);
             pgSurface_Unlock(surfobj);
@@ -1256,6 +1253,7 @@ rect(PyObject *self, PyObject *args, PyObject *kwargs)
                 return RAISE(pgExc_SDLError, SDL_GetError());
             }
         }
+        pgSurface_AddDirtyRect(surfobj, &clipped);
         return pgRect_New(&clipped);
     }
     else {
@@ -1289,9 +1287,7 @@ rect(PyObject *self, PyObject *args, PyObject *kwargs)
 
     if (drawn_area[0] != INT_MAX && drawn_area[1] != INT_MAX &&
         drawn_area[2] != INT_MIN && drawn_area[3] != INT_MIN) {
-        return pgRect_New4(drawn_area[0], drawn_area[1],
-                           drawn_area[2] - drawn_area[0] + 1,
-                           drawn_area[3] - drawn_area[1] + 1);
+        return _drawn_area_rect(surfobj, drawn_area);
     }
     else {
         return pgRect_New4(rect->x, rect->y, 0, 0);
@@ -1395,9 +1391,7 @@ flood_fill(PyObject *self, PyObject *arg, PyObject *kwargs)
     /* Compute return rect. */
     if (drawn_area[0] != INT_MAX && drawn_area[1] != INT_MAX &&
         drawn_area[2] != INT_MIN && drawn_area[3] != INT_MIN) {
-        return pgRect_New4(drawn_area[0], drawn_area[1],
-                           drawn_area[2] - drawn_area[0] + 1,
-                           drawn_area[3] - drawn_area[1] + 1);
+        return _drawn_area_rect(surfobj, drawn_area);
     }
     else {
         return pgRect_New4(startx, starty, 0, 0);
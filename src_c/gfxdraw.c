@@ -168,6 +168,9 @@ _gfx_pixelcolor(PyObject *self, PyObject *args)
     if (!pgSurface_Check(surface)) {
         return RAISE(PyExc_TypeError, "surface must be a Surface");
     }
+    if (!pgSurface_Unshare((pgSurfaceObject *)surface)) {
+        return NULL;
+    }
     if (!pg_RGBAFromObjEx(color, rgba, PG_COLOR_HANDLE_SIMPLE)) {
         return NULL;
     }
@@ -176,6 +179,7 @@ _gfx_pixelcolor(PyObject *self, PyObject *args)
                   rgba[2], rgba[3]) == -1) {
         return RAISE(pgExc_SDLError, SDL_GetError());
     }
+    pgSurface_AddDirtyRect((pgSurfaceObject *)surface, NULL);
     Py_RETURN_NONE;
 }
 
@@ -196,6 +200,9 @@ _gfx_hlinecolor(PyObject *self, PyObject *args)
     if (!pgSurface_Check(surface)) {
         return RAISE(PyExc_TypeError, "surface must be a Surface");
     }
+    if (!pgSurface_Unshare((pgSurfaceObject *)surface)) {
+        return NULL;
+    }
     if (!pg_RGBAFromObjEx(color, rgba, PG_COLOR_HANDLE_SIMPLE)) {
         return NULL;
     }
@@ -204,6 +211,7 @@ _gfx_hlinecolor(PyObject *self, PyObject *args)
                   rgba[2], rgba[3]) == -1) {
         return RAISE(pgExc_SDLError, SDL_GetError());
     }
+    pgSurface_AddDirtyRect((pgSurfaceObject *)surface, NULL);
     Py_RETURN_NONE;
 }
 
@@ -224,6 +232,9 @@ _gfx_vlinecolor(PyObject *self, PyObject *args)
     if (!pgSurface_Check(surface)) {
         return RAISE(PyExc_TypeError, "surface must be a Surface");
     }
+    if (!pgSurface_Unshare((pgSurfaceObject *)surface)) {
+        return NULL;
+    }
     if (!pg_RGBAFromObjEx(color, rgba, PG_COLOR_HANDLE_SIMPLE)) {
         return NULL;
     }
@@ -232,6 +243,7 @@ _gfx_vlinecolor(PyObject *self, PyObject *args)
                   rgba[2], rgba[3]) == -1) {
         return RAISE(pgExc_SDLError, SDL_GetError());
     }
+    pgSurface_AddDirtyRect((pgSurfaceObject *)surface, NULL);
     Py_RETURN_NONE;
 }
 
@@ -253,6 +265,9 @@ _gfx_rectanglecolor(PyObject *self, PyObject *args)
     if (!pgSurface_Check(surface)) {
         return RAISE(PyExc_TypeError, "surface must be a Surface");
     }
+    if (!pgSurface_Unshare((pgSurfaceObject *)surface)) {
+        return NULL;
+    }
     sdlrect = pgRect_FromObject(rect, &temprect);
     if (sdlrect == NULL) {
         return RAISE(PyExc_TypeError, "invalid rect style argument");
@@ -271,6 +286,7 @@ _gfx_rectanglecolor(PyObject *self, PyObject *args)
                       rgba[1], rgba[2], rgba[3]) == -1) {
         return RAISE(pgExc_SDLError, SDL_GetError());
     }
+    pgSurface_AddDirtyRect((pgSurfaceObject *)surface, NULL);
     Py_RETURN_NONE;
 }
 
@@ -292,6 +308,9 @@ _gfx_boxcolor(PyObject *self, PyObject *args)
     if (!pgSurface_Check(surface)) {
         return RAISE(PyExc_TypeError, "surface must be a Surface");
     }
+    if (!pgSurface_Unshare((pgSurfaceObject *)surface)) {
+        return NULL;
+    }
     sdlrect = pgRect_FromObject(rect, &temprect);
     if (sdlrect == NULL) {
         return RAISE(PyExc_TypeError, "invalid rect style argument");
@@ -309,6 +328,7 @@ _gfx_boxcolor(PyObject *self, PyObject *args)
                 rgba[1], rgba[2], rgba[3]) == -1) {
         return RAISE(pgExc_SDLError, SDL_GetError());
     }
+    pgSurface_AddDirtyRect((pgSurfaceObject *)surface, NULL);
     Py_RETURN_NONE;
 }
 
@@ -329,6 +349,9 @@ _gfx_linecolor(PyObject *self, PyObject *args)
     if (!pgSurface_Check(surface)) {
         return RAISE(PyExc_TypeError, "surface must be a Surface");
     }
+    if (!pgSurface_Unshare((pgSurfaceObject *)surface)) {
+        return NULL;
+    }
     if (!pg_RGBAFromObjEx(color, rgba, PG_COLOR_HANDLE_SIMPLE)) {
         return NULL;
     }
@@ -337,6 +360,7 @@ _gfx_linecolor(PyObject *self, PyObject *args)
                  rgba[1], rgba[2], rgba[3]) == -1) {
         return RAISE(pgExc_SDLError, SDL_GetError());
     }
+    pgSurface_AddDirtyRect((pgSurfaceObject *)surface, NULL);
     Py_RETURN_NONE;
 }
 
@@ -357,6 +381,9 @@ _gfx_circlecolor(PyObject *self, PyObject *args)
     if (!pgSurface_Check(surface)) {
         return RAISE(PyExc_TypeError, "surface must be a Surface");
     }
+    if (!pgSurface_Unshare((pgSurfaceObject *)surface)) {
+        return NULL;
+    }
     if (!pg_RGBAFromObjEx(color, rgba, PG_COLOR_HANDLE_SIMPLE)) {
         return NULL;
     }
@@ -365,6 +392,7 @@ _gfx_circlecolor(PyObject *self, PyObject *args)
                    rgba[2], rgba[3]) == -1) {
         return RAISE(pgExc_SDLError, SDL_GetError());
     }
+    pgSurface_AddDirtyRect((pgSurfaceObject *)surface, NULL);
     Py_RETURN_NONE;
 }
 
@@ -385,6 +413,9 @@ _gfx_arccolor(PyObject *self, PyObject *args)
     if (!pgSurface_Check(surface)) {
         return RAISE(PyExc_TypeError, "surface must be a Surface");
     }
+    if (!pgSurface_Unshare((pgSurfaceObject *)surface)) {
+        return NULL;
+    }
     if (!pg_RGBAFromObjEx(color, rgba, PG_COLOR_HANDLE_SIMPLE)) {
         return NULL;
     }
@@ -393,6 +424,7 @@ _gfx_arccolor(PyObject *self, PyObject *args)
                 rgba[1], rgba[2], rgba[3]) == -1) {
         return RAISE(pgExc_SDLError, SDL_GetError());
     }
+    pgSurface_AddDirtyRect((pgSurfaceObject *)surface, NULL);
     Py_RETURN_NONE;
 }
 
@@ -413,6 +445,9 @@ _gfx_aacirclecolor(PyObject *self, PyObject *args)
     if (!pgSurface_Check(surface)) {
         return RAISE(PyExc_TypeError, "surface must be a Surface");
     }
+    if (!pgSurface_Unshare((pgSurfaceObject *)surface)) {
+        return NULL;
+    }
     if (!pg_RGBAFromObjEx(color, rgba, PG_COLOR_HANDLE_SIMPLE)) {
         return NULL;
     }
@@ -421,6 +456,7 @@ _gfx_aacirclecolor(PyObject *self, PyObject *args)
                      rgba[2], rgba[3]) == -1) {
         return RAISE(pgExc_SDLError, SDL_GetError());
     }
+    pgSurface_AddDirtyRect((pgSurfaceObject *)surface, NULL);
     Py_RETURN_NONE;
 }
 
@@ -441,6 +477,9 @@ _gfx_filledcirclecolor(PyObject *self, PyObject *args)
     if (!pgSurface_Check(surface)) {
         return RAISE(PyExc_TypeError, "surface must be a Surface");
     }
+    if (!pgSurface_Unshare((pgSurfaceObject *)surface)) {
+        return NULL;
+    }
     if (!pg_RGBAFromObjEx(color, rgba, PG_COLOR_HANDLE_SIMPLE)) {
         return NULL;
     }
@@ -449,6 +488,7 @@ _gfx_filledcirclecolor(PyObject *self, PyObject *args)
                          rgba[1], rgba[2], rgba[3]) == -1) {
         return RAISE(pgExc_SDLError, SDL_GetError());
     }
+    pgSurface_AddDirtyRect((pgSurfaceObject *)surface, NULL);
     Py_RETURN_NONE;
 }
 
@@ -469,6 +509,9 @@ _gfx_ellipsecolor(PyObject *self, PyObject *args)
     if (!pgSurface_Check(surface)) {
         return RAISE(PyExc_TypeError, "surface must be a Surface");
     }
+    if (!pgSurface_Unshare((pgSurfaceObject *)surface)) {
+        return NULL;
+    }
     if (!pg_RGBAFromObjEx(color, rgba, PG_COLOR_HANDLE_SIMPLE)) {
         return NULL;
     }
@@ -477,6 +520,7 @@ _gfx_ellipsecolor(PyObject *self, PyObject *args)
                     rgba[1], rgba[2], rgba[3]) == -1) {
         return RAISE(pgExc_SDLError, SDL_GetError());
     }
+    pgSurface_AddDirtyRect((pgSurfaceObject *)surface, NULL);
     Py_RETURN_NONE;
 }
 
@@ -497,6 +541,9 @@ _gfx_aaellipsecolor(PyObject *self, PyObject *args)
     if (!pgSurface_Check(surface)) {
         return RAISE(PyExc_TypeError, "surface must be a Surface");
     }
+    if (!pgSurface_Unshare((pgSurfaceObject *)surface)) {
+        return NULL;
+    }
     if (!pg_RGBAFromObjEx(color, rgba, PG_COLOR_HANDLE_SIMPLE)) {
         return NULL;
     }
@@ -505,6 +552,7 @@ _gfx_aaellipsecolor(PyObject *self, PyObject *args)
                       rgba[1], rgba[2], rgba[3]) == -1) {
         return RAISE(pgExc_SDLError, SDL_GetError());
     }
+    pgSurface_AddDirtyRect((pgSurfaceObject *)surface, NULL);
     Py_RETURN_NONE;
 }
 
@@ -525,6 +573,9 @@ _gfx_filledellipsecolor(PyObject *self, PyObject *args)
     if (!pgSurface_Check(surface)) {
         return RAISE(PyExc_TypeError, "surface must be a Surface");
     }
+    if (!pgSurface_Unshare((pgSurfaceObject *)surface)) {
+        return NULL;
+    }
     if (!pg_RGBAFromObjEx(color, rgba, PG_COLOR_HANDLE_SIMPLE)) {
         return NULL;
     }
@@ -533,6 +584,7 @@ _gfx_filledellipsecolor(PyObject *self, PyObject *args)
                           rgba[1], rgba[2], rgba[3]) == -1) {
         return RAISE(pgExc_SDLError, SDL_GetError());
     }
+    pgSurface_AddDirtyRect((pgSurfaceObject *)surface, NULL);
     Py_RETURN_NONE;
 }
 
@@ -553,6 +605,9 @@ _gfx_piecolor(PyObject *self, PyObject *args)
     if (!pgSurface_Check(surface)) {
         return RAISE(PyExc_TypeError, "surface must be a Surface");
     }
+    if (!pgSurface_Unshare((pgSurfaceObject *)surface)) {
+        return NULL;
+    }
     if (!pg_RGBAFromObjEx(color, rgba, PG_COLOR_HANDLE_SIMPLE)) {
         return NULL;
     }
@@ -561,6 +616,7 @@ _gfx_piecolor(PyObject *self, PyObject *args)
                 rgba[1], rgba[2], rgba[3]) == -1) {
         return RAISE(pgExc_SDLError, SDL_GetError());
     }
+    pgSurface_AddDirtyRect((pgSurfaceObject *)surface, NULL);
     Py_RETURN_NONE;
 }
 
@@ -581,6 +637,9 @@ _gfx_trigoncolor(PyObject *self, PyObject *args)
     if (!pgSurface_Check(surface)) {
         return RAISE(PyExc_TypeError, "surface must be a Surface");
     }
+    if (!pgSurface_Unshare((pgSurfaceObject *)surface)) {
+        return NULL;
+    }
     if (!pg_RGBAFromObjEx(color, rgba, PG_COLOR_HANDLE_SIMPLE)) {
         return NULL;
     }
@@ -589,6 +648,7 @@ _gfx_trigoncolor(PyObject *self, PyObject *args)
                    rgba[0], rgba[1], rgba[2], rgba[3]) == -1) {
         return RAISE(pgExc_SDLError, SDL_GetError());
     }
+    pgSurface_AddDirtyRect((pgSurfaceObject *)surface, NULL);
     Py_RETURN_NONE;
 }
 
@@ -609,6 +669,9 @@ _gfx_aatrigoncolor(PyObject *self, PyObject *args)
     if (!pgSurface_Check(surface)) {
         return RAISE(PyExc_TypeError, "surface must be a Surface");
     }
+    if (!pgSurface_Unshare((pgSurfaceObject *)surface)) {
+        return NULL;
+    }
     if (!pg_RGBAFromObjEx(color, rgba, PG_COLOR_HANDLE_SIMPLE)) {
         return NULL;
     }
@@ -617,6 +680,7 @@ _gfx_aatrigoncolor(PyObject *self, PyObject *args)
                      rgba[0], rgba[1], rgba[2], rgba[3]) == -1) {
         return RAISE(pgExc_SDLError, SDL_GetError());
     }
+    pgSurface_AddDirtyRect((pgSurfaceObject *)surface, NULL);
     Py_RETURN_NONE;
 }
 
@@ -637,6 +701,9 @@ _gfx_filledtrigoncolor(PyObject *self, PyObject *args)
     if (!pgSurface_Check(surface)) {
         return RAISE(PyExc_TypeError, "surface must be a Surface");
     }
+    if (!pgSurface_Unshare((pgSurfaceObject *)surface)) {
+        return NULL;
+    }
     if (!pg_RGBAFromObjEx(color, rgba, PG_COLOR_HANDLE_SIMPLE)) {
         return NULL;
     }
@@ -645,6 +712,7 @@ _gfx_filledtrigoncolor(PyObject *self, PyObject *args)
                          rgba[0], rgba[1], rgba[2], rgba[3]) == -1) {
         return RAISE(pgExc_SDLError, SDL_GetError());
     }
+    pgSurface_AddDirtyRect((pgSurfaceObject *)surface, NULL);
     Py_RETURN_NONE;
 }
 
@@ -666,6 +734,9 @@ _gfx_polygoncolor(PyObject *self, PyObject *args)
     if (!pgSurface_Check(surface)) {
         return RAISE(PyExc_TypeError, "surface must be a Surface");
     }
+    if (!pgSurface_Unshare((pgSurfaceObject *)surface)) {
+        return NULL;
+    }
     if (!pg_RGBAFromObjEx(color, rgba, PG_COLOR_HANDLE_SIMPLE)) {
         return NULL;
     }
@@ -721,6 +792,7 @@ _gfx_polygoncolor(PyObject *self, PyObject *args)
     if (ret == -1) {
         return RAISE(pgExc_SDLError, SDL_GetError());
     }
+    pgSurface_AddDirtyRect((pgSurfaceObject *)surface, NULL);
     Py_RETURN_NONE;
 }
 
@@ -742,6 +814,9 @@ _gfx_aapolygoncolor(PyObject *self, PyObject *args)
     if (!pgSurface_Check(surface)) {
         return RAISE(PyExc_TypeError, "surface must be a Surface");
     }
+    if (!pgSurface_Unshare((pgSurfaceObject *)surface)) {
+        return NULL;
+    }
     if (!pg_RGBAFromObjEx(color, rgba, PG_COLOR_HANDLE_SIMPLE)) {
         return NULL;
     }
@@ -797,6 +872,7 @@ _gfx_aapolygoncolor(PyObject *self, PyObject *args)
     if (ret == -1) {
         return RAISE(pgExc_SDLError, SDL_GetError());
     }
+    pgSurface_AddDirtyRect((pgSurfaceObject *)surface, NULL);
     Py_RETURN_NONE;
 }
 
@@ -819,6 +895,9 @@ _gfx_filledpolygoncolor(PyObject *self, PyObject *args)
     if (!pgSurface_Check(surface)) {
         return RAISE(PyExc_TypeError, "surface must be a Surface");
     }
+    if (!pgSurface_Unshare((pgSurfaceObject *)surface)) {
+        return NULL;
+    }
     if (!pg_RGBAFromObjEx(color, rgba, PG_COLOR_HANDLE_SIMPLE)) {
         return NULL;
     }
@@ -874,6 +953,7 @@ _gfx_filledpolygoncolor(PyObject *self, PyObject *args)
     if (ret == -1) {
         return RAISE(pgExc_SDLError, SDL_GetError());
     }
+    pgSurface_AddDirtyRect((pgSurfaceObject *)surface, NULL);
     Py_RETURN_NONE;
 }
 
@@ -896,6 +976,9 @@ _gfx_texturedpolygon(PyObject *self, PyObject *args)
     if (!pgSurface_Check(surface)) {
         return RAISE(PyExc_TypeError, "surface must be a Surface");
     }
+    if (!pgSurface_Unshare((pgSurfaceObject *)surface)) {
+        return NULL;
+    }
     s_surface = pgSurface_AsSurface(surface);
     if (!pgSurface_Check(texture)) {
         return RAISE(PyExc_TypeError, "texture must be a Surface");
@@ -958,6 +1041,7 @@ _gfx_texturedpolygon(PyObject *self, PyObject *args)
     if (ret == -1) {
         return RAISE(pgExc_SDLError, SDL_GetError());
     }
+    pgSurface_AddDirtyRect((pgSurfaceObject *)surface, NULL);
     Py_RETURN_NONE;
 }
 
@@ -980,6 +1064,9 @@ _gfx_beziercolor(PyObject *self, PyObject *args)
     if (!pgSurface_Check(surface)) {
         return RAISE(PyExc_TypeError, "surface must be a Surface");
     }
+    if (!pgSurface_Unshare((pgSurfaceObject *)surface)) {
+        return NULL;
+    }
     if (!pg_RGBAFromObjEx(color, rgba, PG_COLOR_HANDLE_SIMPLE)) {
         return NULL;
     }
@@ -1040,6 +1127,7 @@ _gfx_beziercolor(PyObject *self, PyObject *args)
     if (ret == -1) {
         return RAISE(pgExc_SDLError, SDL_GetError());
     }
+    pgSurface_AddDirtyRect((pgSurfaceObject *)surface, NULL);
     Py_RETURN_NONE;
 }
 
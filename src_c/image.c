@@ -169,7 +169,9 @@ image_save(PyObject *self, PyObject *arg, PyObject *kwarg)
     }
 
     surf = pgSurface_AsSurface(surfobj);
-    pgSurface_Prep(surfobj);
+    if (!pgSurface_Prep(surfobj)) {
+        return NULL;
+    }
 
     oencoded = pg_EncodeString(obj, "UTF-8", NULL, pgExc_SDLError);
     if (oencoded == NULL) {
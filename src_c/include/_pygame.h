@@ -99,6 +99,22 @@ typedef struct pg_bufferinfo_s {
     pybuffer_releaseproc release_buffer;
 } pg_buffer;
 
+/*
+ * Work callback for pg_ParallelForRows. Called once per row band with the
+ * half open row range [start_row, end_row). It may run on a worker thread,
+ * so it must not touch Python objects or the SDL error state.
+ */
+typedef void (*pg_rowbandproc)(void *data, int start_row, int end_row);
+
+/*
+ * Runs func over the rows [0, rows) of a job costing about work pixels,
+ * split in bands on several threads if the caller supports it. Taken by the
+ * row based routines linked into several modules, which can not call
+ * pg_ParallelForRows themselves. NULL runs the rows on the calling thread.
+ */
+typedef void (*pg_rowrunner)(int rows, Py_ssize_t work, pg_rowbandproc func,
+                             void *data);
+
 #include "pgimport.h"
 #include "../pgcompat_rect.h"
 
@@ -193,6 +209,13 @@ typedef struct pg_bufferinfo_s {
     (*(PyObject * (*)(PyObject *, PyObject *const *, Py_ssize_t, PyObject *, \
                       char *)) PYGAMEAPI_GET_SLOT(base, 29))
 
+#define pg_ParallelBandCount \
+    (*(int (*)(int, Py_ssize_t))PYGAMEAPI_GET_SLOT(base, 30))
+
+#define pg_ParallelForRows                                            \
+    (*(void (*)(int, int, pg_rowbandproc, void *))PYGAMEAPI_GET_SLOT( \
+        base, 31))
+
 #define import_pygame_base() IMPORT_PYGAME_MODULE(base)
 #endif /* ~PYGAMEAPI_BASE_INTERNAL */
 
@@ -317,6 +340,9 @@ typedef struct {
  * SURFACE module
  */
 struct pgSubSurface_Data;
+struct pgDirtyRects;
+struct pgSpanCache;
+struct pgCowData;
 struct SDL_Surface;
 
 typedef struct {
@@ -327,6 +353,9 @@ typedef struct {
     PyObject *weakreflist;
     PyObject *locklist;
     PyObject *dependency;
+    struct pgDirtyRects *dirty; /* changed areas (if tracking is on) */
+    struct pgSpanCache *spans;  /* visible pixel runs (if encoding is on) */
+    struct pgCowData *cow;      /* copy-on-write sharing (if any) */
 } pgSurfaceObject;
 #define pgSurface_AsSurface(x) (((pgSurfaceObject *)x)->surf)
 
@@ -347,6 +376,22 @@ typedef struct {
     (*(int (*)(pgSurfaceObject *, pgSurfaceObject *, SDL_Rect *, SDL_Rect *, \
                int))PYGAMEAPI_GET_SLOT(surface, 2))
 
+#define pgSurface_AddDirtyRect \
+    (*(void (*)(pgSurfaceObject *, SDL_Rect *))PYGAMEAPI_GET_SLOT(surface, 4))
+
+#define pgSurface_PoolCreate                            \
+    (*(SDL_Surface * (*)(int, int, PG_PixelFormatEnum)) \
+         PYGAMEAPI_GET_SLOT(surface, 5))
+
+#define pgSurface_PoolRelease \
+    (*(void (*)(SDL_Surface *))PYGAMEAPI_GET_SLOT(surface, 6))
+
+#define pgSurface_PoolStats \
+    (*(PyObject * (*)(void))PYGAMEAPI_GET_SLOT(surface, 7))
+
+#define pgSurface_PoolSetBudget \
+    (*(void (*)(Py_ssize_t))PYGAMEAPI_GET_SLOT(surface, 8))
+
 #define import_pygame_surface()         \
     do {                                \
         IMPORT_PYGAME_MODULE(surface);  \
@@ -365,9 +410,11 @@ typedef struct {
  * auto imported/initialized by surface
  */
 #ifndef PYGAMEAPI_SURFLOCK_INTERNAL
-#define pgSurface_Prep(x) \
-    if ((x)->subsurface)  \
-    (*(*(void (*)(pgSurfaceObject *))PYGAMEAPI_GET_SLOT(surflock, 0)))(x)
+#define pgSurface_Prep(x)                                                \
+    ((x)->subsurface                                                     \
+         ? (*(*(int (*)(pgSurfaceObject *))PYGAMEAPI_GET_SLOT(surflock, \
+                                                               0)))(x)   \
+         : 1)
 
 #define pgSurface_Unprep(x) \
     if ((x)->subsurface)    \
@@ -384,6 +431,12 @@ typedef struct {
 
 #define pgSurface_UnlockBy \
     (*(int (*)(pgSurfaceObject *, PyObject *))PYGAMEAPI_GET_SLOT(surflock, 5))
+
+#define pgSurface_Unshare \
+    (*(int (*)(pgSurfaceObject *))PYGAMEAPI_GET_SLOT(surflock, 6))
+
+#define pgSurface_LockRead \
+    (*(int (*)(pgSurfaceObject *))PYGAMEAPI_GET_SLOT(surflock, 7))
 #endif
 
 /*
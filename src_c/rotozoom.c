@@ -32,6 +32,186 @@ typedef struct tColorRGBA {
 #define M_PI 3.141592654
 #endif
 
+#if !defined(PG_ENABLE_ARM_NEON) && defined(__aarch64__)
+// arm64 has neon optimisations enabled by default, even when fpu=neon is not
+// passed
+#define PG_ENABLE_ARM_NEON 1
+#endif
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define ROTOZOOM_SIMD 1
+#elif PG_ENABLE_ARM_NEON
+// sse2neon.h is from here: https://github.com/DLTcollab/sse2neon
+#include "include/sse2neon.h"
+#define ROTOZOOM_SIMD 1
+#else
+#define ROTOZOOM_SIMD 0
+#endif
+
+static void
+runRows(pg_rowrunner run_rows, int rows, Py_ssize_t work,
+        pg_rowbandproc func, void *data)
+{
+    if (run_rows) {
+        run_rows(rows, work, func, data);
+    }
+    else {
+        func(data, 0, rows);
+    }
+}
+
+#if ROTOZOOM_SIMD
+
+static int
+hasSimd(void)
+{
+#if defined(__SSE2__)
+    return SDL_HasSSE2();
+#else
+    return SDL_HasNEON();
+#endif
+}
+
+/*
+
+ a + (((b - a) * f) >> 16) on 16 bit lanes, with f from 0 to 65535. The
+ multiply is signed, so f >= 32768 counts as f - 65536, which is made up for
+ by adding (b - a) back. This gives exactly the result of the scalar code.
+
+*/
+static PG_INLINE __m128i
+lerp16(__m128i a, __m128i b, __m128i f)
+{
+    __m128i d = _mm_sub_epi16(b, a);
+    __m128i hi = _mm_and_si128(d, _mm_srai_epi16(f, 15));
+    return _mm_add_epi16(a, _mm_add_epi16(_mm_mulhi_epi16(d, f), hi));
+}
+
+/*
+
+ Bilinear interpolation of two pixels, as 16 bit channels. 'p0' and 'p1'
+ point at the top left pixel of the 2x2 block each of them is sampled from.
+
+*/
+static PG_INLINE __m128i
+interpolate2(const Uint8 *p0, const Uint8 *p1, int pitch, int ex0, int ex1,
+             int ey0, int ey1)
+{
+    const __m128i zero = _mm_setzero_si128();
+    __m128i top0 =
+        _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)p0), zero);
+    __m128i top1 =
+        _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)p1), zero);
+    __m128i bottom0 = _mm_unpacklo_epi8(
+        _mm_loadl_epi64((const __m128i *)(p0 + pitch)), zero);
+    __m128i bottom1 = _mm_unpacklo_epi8(
+        _mm_loadl_epi64((const __m128i *)(p1 + pitch)), zero);
+    __m128i fx = _mm_set_epi16((short)ex1, (short)ex1, (short)ex1, (short)ex1,
+                               (short)ex0, (short)ex0, (short)ex0, (short)ex0);
+    __m128i fy = _mm_set_epi16((short)ey1, (short)ey1, (short)ey1, (short)ey1,
+                               (short)ey0, (short)ey0, (short)ey0, (short)ey0);
+    __m128i t1 = lerp16(_mm_unpacklo_epi64(top0, top1),
+                        _mm_unpackhi_epi64(top0, top1), fx);
+    __m128i t2 = lerp16(_mm_unpacklo_epi64(bottom0, bottom1),
+                        _mm_unpackhi_epi64(bottom0, bottom1), fx);
+    return lerp16(t1, t2, fy);
+}
+
+#endif /* ROTOZOOM_SIMD */
+
+/*
+
+ Rows of the 32bit Zoomer, the source column and row of each destination
+ pixel being in 'sxs' and 'sys' and their fractions in 'sax' and 'say'.
+
+*/
+
+typedef struct {
+    SDL_Surface *src;
+    SDL_Surface *dst;
+    const int *sax, *say;
+    const int *sxs, *sys;
+    int smooth;
+} tZoomRows;
+
+static void
+zoomRowsRGBA(void *data, int start, int end)
+{
+    tZoomRows *zoom = (tZoomRows *)data;
+    SDL_Surface *src = zoom->src;
+    SDL_Surface *dst = zoom->dst;
+    const int *sax = zoom->sax;
+    const int *sxs = zoom->sxs;
+    int x, y, ex, ey, t1, t2;
+    tColorRGBA *c00, *c01, *c10, *c11;
+    tColorRGBA *csp, *dp;
+#if ROTOZOOM_SIMD
+    int simd = zoom->smooth && hasSimd();
+#endif /* ROTOZOOM_SIMD */
+
+    for (y = start; y < end; y++) {
+        csp = (tColorRGBA *)((Uint8 *)src->pixels +
+                             (size_t)zoom->sys[y] * src->pitch);
+        dp = (tColorRGBA *)((Uint8 *)dst->pixels + (size_t)y * dst->pitch);
+        x = 0;
+        if (zoom->smooth) {
+            /*
+             * Interpolating Zoom
+             */
+            ey = (zoom->say[y] & 0xffff);
+#if ROTOZOOM_SIMD
+            if (simd) {
+                for (; x + 4 <= dst->w; x += 4) {
+                    const Uint8 *sp = (const Uint8 *)csp;
+                    __m128i lo = interpolate2(
+                        sp + sxs[x] * 4, sp + sxs[x + 1] * 4, src->pitch,
+                        sax[x] & 0xffff, sax[x + 1] & 0xffff, ey, ey);
+                    __m128i hi = interpolate2(
+                        sp + sxs[x + 2] * 4, sp + sxs[x + 3] * 4, src->pitch,
+                        sax[x + 2] & 0xffff, sax[x + 3] & 0xffff, ey, ey);
+                    _mm_storeu_si128((__m128i *)(dp + x),
+                                     _mm_packus_epi16(lo, hi));
+                }
+            }
+#endif /* ROTOZOOM_SIMD */
+            for (; x < dst->w; x++) {
+                /*
+                 * Setup color source pointers
+                 */
+                c00 = csp + sxs[x];
+                c01 = c00 + 1;
+                c10 = (tColorRGBA *)((Uint8 *)c00 + src->pitch);
+                c11 = c10 + 1;
+                /*
+                 * Interpolate colors
+                 */
+                ex = (sax[x] & 0xffff);
+                t1 = ((((c01->r - c00->r) * ex) >> 16) + c00->r) & 0xff;
+                t2 = ((((c11->r - c10->r) * ex) >> 16) + c10->r) & 0xff;
+                dp[x].r = (((t2 - t1) * ey) >> 16) + t1;
+                t1 = ((((c01->g - c00->g) * ex) >> 16) + c00->g) & 0xff;
+                t2 = ((((c11->g - c10->g) * ex) >> 16) + c10->g) & 0xff;
+                dp[x].g = (((t2 - t1) * ey) >> 16) + t1;
+                t1 = ((((c01->b - c00->b) * ex) >> 16) + c00->b) & 0xff;
+                t2 = ((((c11->b - c10->b) * ex) >> 16) + c10->b) & 0xff;
+                dp[x].b = (((t2 - t1) * ey) >> 16) + t1;
+                t1 = ((((c01->a - c00->a) * ex) >> 16) + c00->a) & 0xff;
+                t2 = ((((c11->a - c10->a) * ex) >> 16) + c10->a) & 0xff;
+                dp[x].a = (((t2 - t1) * ey) >> 16) + t1;
+            }
+        }
+        else {
+            /*
+             * Non-Interpolating Zoom
+             */
+            for (; x < dst->w; x++) {
+                dp[x] = csp[sxs[x]];
+            }
+        }
+    }
+}
+
 /*
 
  32bit Zoomer with optional anti-aliasing by bilinear interpolation.
@@ -40,13 +220,12 @@ typedef struct tColorRGBA {
 
 */
 int
-zoomSurfaceRGBA(SDL_Surface *src, SDL_Surface *dst, int smooth)
+zoomSurfaceRGBA(SDL_Surface *src, SDL_Surface *dst, int smooth,
+                pg_rowrunner run_rows)
 {
-    int x, y, sx, sy, *sax, *say, *csax, *csay, csx, csy, ex, ey, t1, t2,
-        sstep;
-    tColorRGBA *c00, *c01, *c10, *c11;
-    tColorRGBA *sp, *csp, *dp;
-    int dgap;
+    int x, y, sx, sy, *sax, *say, *csax, *csay, csx, csy;
+    int *sxs, *sys;
+    tZoomRows zoom;
 
     /*
      * Variable setup
@@ -67,18 +246,23 @@ zoomSurfaceRGBA(SDL_Surface *src, SDL_Surface *dst, int smooth)
     }
 
     /*
-     * Allocate memory for row increments
+     * Allocate memory for row increments and source positions
      */
-    if ((sax = (int *)malloc((dst->w + 1) * sizeof(int))) == NULL) {
-        return (-1);
-    }
-    if ((say = (int *)malloc((dst->h + 1) * sizeof(int))) == NULL) {
+    sax = (int *)malloc((dst->w + 1) * sizeof(int));
+    say = (int *)malloc((dst->h + 1) * sizeof(int));
+    sxs = (int *)malloc((dst->w + 1) * sizeof(int));
+    sys = (int *)malloc((dst->h + 1) * sizeof(int));
+    if (!sax || !say || !sxs || !sys) {
         free(sax);
+        free(say);
+        free(sxs);
+        free(sys);
         return (-1);
     }
 
     /*
-     * Precalculate row increments
+     * Precalculate row increments, and from them the source column and
+     * row of each destination pixel
      */
     csx = 0;
     csax = sax;
@@ -96,308 +280,308 @@ zoomSurfaceRGBA(SDL_Surface *src, SDL_Surface *dst, int smooth)
         csy &= 0xffff;
         csy += sy;
     }
-
-    /*
-     * Pointer setup
-     */
-    csp = (tColorRGBA *)src->pixels;
-    dp = (tColorRGBA *)dst->pixels;
-    dgap = dst->pitch - dst->w * 4;
-
-    /*
-     * Switch between interpolating and non-interpolating code
-     */
-    if (smooth) {
-        /*
-         * Interpolating Zoom
-         */
-
-        /*
-         * Scan destination
-         */
-        csay = say;
-        for (y = 0; y < dst->h; y++) {
-            /*
-             * Setup color source pointers
-             */
-            c00 = csp;
-            c01 = csp;
-            c01++;
-            c10 = (tColorRGBA *)((Uint8 *)csp + src->pitch);
-            c11 = c10;
-            c11++;
-            csax = sax;
-            for (x = 0; x < dst->w; x++) {
-                /*
-                 * Interpolate colors
-                 */
-                ex = (*csax & 0xffff);
-                ey = (*csay & 0xffff);
-                t1 = ((((c01->r - c00->r) * ex) >> 16) + c00->r) & 0xff;
-                t2 = ((((c11->r - c10->r) * ex) >> 16) + c10->r) & 0xff;
-                dp->r = (((t2 - t1) * ey) >> 16) + t1;
-                t1 = ((((c01->g - c00->g) * ex) >> 16) + c00->g) & 0xff;
-                t2 = ((((c11->g - c10->g) * ex) >> 16) + c10->g) & 0xff;
-                dp->g = (((t2 - t1) * ey) >> 16) + t1;
-                t1 = ((((c01->b - c00->b) * ex) >> 16) + c00->b) & 0xff;
-                t2 = ((((c11->b - c10->b) * ex) >> 16) + c10->b) & 0xff;
-                dp->b = (((t2 - t1) * ey) >> 16) + t1;
-                t1 = ((((c01->a - c00->a) * ex) >> 16) + c00->a) & 0xff;
-                t2 = ((((c11->a - c10->a) * ex) >> 16) + c10->a) & 0xff;
-                dp->a = (((t2 - t1) * ey) >> 16) + t1;
-
-                /*
-                 * Advance source pointers
-                 */
-                csax++;
-                sstep = (*csax >> 16);
-                c00 += sstep;
-                c01 += sstep;
-                c10 += sstep;
-                c11 += sstep;
-                /*
-                 * Advance destination pointer
-                 */
-                dp++;
-            }
-            /*
-             * Advance source pointer
-             */
-            csay++;
-            csp = (tColorRGBA *)((Uint8 *)csp + (*csay >> 16) * src->pitch);
-            /*
-             * Advance destination pointers
-             */
-            dp = (tColorRGBA *)((Uint8 *)dp + dgap);
-        }
+    sxs[0] = 0;
+    for (x = 1; x <= dst->w; x++) {
+        sxs[x] = sxs[x - 1] + (sax[x] >> 16);
     }
-    else {
-        /*
-         * Non-Interpolating Zoom
-         */
-
-        csay = say;
-        for (y = 0; y < dst->h; y++) {
-            sp = csp;
-            csax = sax;
-            for (x = 0; x < dst->w; x++) {
-                /*
-                 * Draw
-                 */
-                *dp = *sp;
-                /*
-                 * Advance source pointers
-                 */
-                csax++;
-                sp += (*csax >> 16);
-                /*
-                 * Advance destination pointer
-                 */
-                dp++;
-            }
-            /*
-             * Advance source pointer
-             */
-            csay++;
-            csp = (tColorRGBA *)((Uint8 *)csp + (*csay >> 16) * src->pitch);
-            /*
-             * Advance destination pointers
-             */
-            dp = (tColorRGBA *)((Uint8 *)dp + dgap);
-        }
+    sys[0] = 0;
+    for (y = 1; y <= dst->h; y++) {
+        sys[y] = sys[y - 1] + (say[y] >> 16);
     }
 
+    zoom.src = src;
+    zoom.dst = dst;
+    zoom.sax = sax;
+    zoom.say = say;
+    zoom.sxs = sxs;
+    zoom.sys = sys;
+    zoom.smooth = smooth;
+    runRows(run_rows, dst->h, (Py_ssize_t)dst->w * dst->h, zoomRowsRGBA,
+            &zoom);
+
     /*
      * Remove temp arrays
      */
     free(sax);
     free(say);
+    free(sxs);
+    free(sys);
 
     return (0);
 }
 
 /*
 
- 32bit Rotozoomer with optional anti-aliasing by bilinear interpolation.
+ Samples one row for the 32bit Rotozoomer.
 
- Rotates and zooms 32bit RGBA/ABGR 'src' surface to 'dst' surface.
+ Walks the 32bit RGBA/ABGR 'src' surface from the 16.16 fixed point position
+ (sdx, sdy), advancing by (stepx, stepy) for each of the 'width' pixels
+ written to 'row'. Pixels sampling outside of 'src' are left untouched. If
+ 'first' is not NULL, the range of pixels written is stored in 'first' and
+ 'last', with *first > *last if there is none.
 
 */
 
 void
-transformSurfaceRGBA(SDL_Surface *src, SDL_Surface *dst, int cx, int cy,
-                     int isin, int icos, int smooth)
+transformRowRGBA(SDL_Surface *src, void *row, int width, int sdx, int sdy,
+                 int stepx, int stepy, int smooth, int *first, int *last)
 {
-    int x, y, t1, t2, dx, dy, xd, yd, sdx, sdy, ax, ay, ex, ey, sw, sh;
+    int x, t1, t2, dx, dy, ex, ey, sw, sh;
+    int lo = width, hi = -1;
     tColorRGBA c00, c01, c10, c11;
-    tColorRGBA *pc, *sp;
-    int gap;
+    tColorRGBA *pc = row, *sp;
+#if ROTOZOOM_SIMD
+    int simd = smooth && hasSimd();
+#endif /* ROTOZOOM_SIMD */
 
-    /*
-     * Variable setup
-     */
-    xd = ((unsigned long long)(src->w - dst->w) << 15);
-    yd = ((unsigned long long)(src->h - dst->h) << 15);
-    ax = (cx << 16) - (icos * cx);
-    ay = (cy << 16) - (isin * cx);
     sw = src->w - 1;
     sh = src->h - 1;
-    pc = dst->pixels;
-    gap = dst->pitch - dst->w * 4;
 
     /*
      * Switch between interpolating and non-interpolating code
      */
     if (smooth) {
-        for (y = 0; y < dst->h; y++) {
-            dy = cy - y;
-            sdx = (ax + (isin * dy)) + xd;
-            sdy = (ay - (icos * dy)) + yd;
-            for (x = 0; x < dst->w; x++) {
-                dx = (sdx >> 16);
-                dy = (sdy >> 16);
-                if ((dx >= -1) && (dy >= -1) && (dx < src->w) &&
-                    (dy < src->h)) {
-                    if ((dx >= 0) && (dy >= 0) && (dx < sw) && (dy < sh)) {
-                        sp = (tColorRGBA *)((Uint8 *)src->pixels +
-                                            src->pitch * dy);
-                        sp += dx;
-                        c00 = *sp;
-                        sp += 1;
-                        c01 = *sp;
-                        sp = (tColorRGBA *)((Uint8 *)sp + src->pitch);
-                        sp -= 1;
-                        c10 = *sp;
-                        sp += 1;
-                        c11 = *sp;
-                    }
-                    else if ((dx == sw) && (dy == sh)) {
-                        sp = (tColorRGBA *)((Uint8 *)src->pixels +
-                                            src->pitch * dy);
-                        sp += dx;
-                        c00 = *sp;
-                        c01 = *sp;
-                        c10 = *sp;
-                        c11 = *sp;
-                    }
-                    else if ((dx == -1) && (dy == -1)) {
-                        sp = (tColorRGBA *)(src->pixels);
-                        c00 = *sp;
-                        c01 = *sp;
-                        c10 = *sp;
-                        c11 = *sp;
-                    }
-                    else if ((dx == -1) && (dy == sh)) {
-                        sp = (tColorRGBA *)((Uint8 *)src->pixels +
-                                            src->pitch * dy);
-                        c00 = *sp;
-                        c01 = *sp;
-                        c10 = *sp;
-                        c11 = *sp;
-                    }
-                    else if ((dx == sw) && (dy == -1)) {
-                        sp = (tColorRGBA *)(src->pixels);
-                        sp += dx;
-                        c00 = *sp;
-                        c01 = *sp;
-                        c10 = *sp;
-                        c11 = *sp;
-                    }
-                    else if (dx == -1) {
-                        sp = (tColorRGBA *)((Uint8 *)src->pixels +
-                                            src->pitch * dy);
-                        c00 = *sp;
-                        c01 = *sp;
-                        c10 = *sp;
-                        sp = (tColorRGBA *)((Uint8 *)sp + src->pitch);
-                        c11 = *sp;
-                    }
-                    else if (dy == -1) {
-                        sp = (tColorRGBA *)(src->pixels);
-                        sp += dx;
-                        c00 = *sp;
-                        c01 = *sp;
-                        c10 = *sp;
-                        sp += 1;
-                        c11 = *sp;
-                    }
-                    else if (dx == sw) {
-                        sp = (tColorRGBA *)((Uint8 *)src->pixels +
-                                            src->pitch * dy);
-                        sp += dx;
-                        c00 = *sp;
-                        c01 = *sp;
-                        sp = (tColorRGBA *)((Uint8 *)sp + src->pitch);
-                        c10 = *sp;
-                        c11 = *sp;
-                    }
-                    else if (dy == sh) {
-                        sp = (tColorRGBA *)((Uint8 *)src->pixels +
-                                            src->pitch * dy);
-                        sp += dx;
-                        c00 = *sp;
-                        sp += 1;
-                        c01 = *sp;
-                        c10 = *sp;
-                        c11 = *sp;
-                    }
-                    else {
-                        // NOTE: a catchall to appease gcc4 warnings...
-                        // Probably should not get here.  we'll see.
-                        //  old behaviour would be to use the previous pixel,
-                        //  from the previous loop.
-                        sp = (tColorRGBA *)(src->pixels);
-                        c00 = *sp;
-                        c01 = *sp;
-                        c10 = *sp;
-                        c11 = *sp;
-                    }
-                    /*
-                     * Interpolate colors
-                     */
-                    ex = (sdx & 0xffff);
-                    ey = (sdy & 0xffff);
-                    t1 = ((((c01.r - c00.r) * ex) >> 16) + c00.r) & 0xff;
-                    t2 = ((((c11.r - c10.r) * ex) >> 16) + c10.r) & 0xff;
-                    pc->r = (((t2 - t1) * ey) >> 16) + t1;
-                    t1 = ((((c01.g - c00.g) * ex) >> 16) + c00.g) & 0xff;
-                    t2 = ((((c11.g - c10.g) * ex) >> 16) + c10.g) & 0xff;
-                    pc->g = (((t2 - t1) * ey) >> 16) + t1;
-                    t1 = ((((c01.b - c00.b) * ex) >> 16) + c00.b) & 0xff;
-                    t2 = ((((c11.b - c10.b) * ex) >> 16) + c10.b) & 0xff;
-                    pc->b = (((t2 - t1) * ey) >> 16) + t1;
-                    t1 = ((((c01.a - c00.a) * ex) >> 16) + c00.a) & 0xff;
-                    t2 = ((((c11.a - c10.a) * ex) >> 16) + c10.a) & 0xff;
-                    pc->a = (((t2 - t1) * ey) >> 16) + t1;
+        for (x = 0; x < width; x++) {
+#if ROTOZOOM_SIMD
+            /*
+             * Four pixels at once when all their 2x2 blocks are inside
+             * the surface, which is true when it is for the first and last
+             * of them as the positions are on a line
+             */
+            if (simd && x + 4 <= width && sdx >= 0 && sdy >= 0 &&
+                (sdx >> 16) < sw && (sdy >> 16) < sh &&
+                sdx + 3 * stepx >= 0 && sdy + 3 * stepy >= 0 &&
+                ((sdx + 3 * stepx) >> 16) < sw &&
+                ((sdy + 3 * stepy) >> 16) < sh) {
+                const Uint8 *sp8[4];
+                int exs[4], eys[4], i;
+                __m128i lo4, hi4;
+
+                for (i = 0; i < 4; i++) {
+                    sp8[i] = (const Uint8 *)src->pixels +
+                             (size_t)src->pitch * (sdy >> 16) +
+                             (size_t)(sdx >> 16) * 4;
+                    exs[i] = (sdx & 0xffff);
+                    eys[i] = (sdy & 0xffff);
+                    sdx += stepx;
+                    sdy += stepy;
+                }
+                lo4 = interpolate2(sp8[0], sp8[1], src->pitch, exs[0], exs[1],
+                                   eys[0], eys[1]);
+                hi4 = interpolate2(sp8[2], sp8[3], src->pitch, exs[2], exs[3],
+                                   eys[2], eys[3]);
+                _mm_storeu_si128((__m128i *)pc, _mm_packus_epi16(lo4, hi4));
+                if (x < lo) {
+                    lo = x;
                 }
-                sdx += icos;
-                sdy += isin;
-                pc++;
+                hi = x + 3;
+                x += 3;
+                pc += 4;
+                continue;
             }
-            pc = (tColorRGBA *)((Uint8 *)pc + gap);
+#endif /* ROTOZOOM_SIMD */
+            dx = (sdx >> 16);
+            dy = (sdy >> 16);
+            if ((dx >= -1) && (dy >= -1) && (dx < src->w) && (dy < src->h)) {
+                if ((dx >= 0) && (dy >= 0) && (dx < sw) && (dy < sh)) {
+                    sp = (tColorRGBA *)((Uint8 *)src->pixels +
+                                        src->pitch * dy);
+                    sp += dx;
+                    c00 = *sp;
+                    sp += 1;
+                    c01 = *sp;
+                    sp = (tColorRGBA *)((Uint8 *)sp + src->pitch);
+                    sp -= 1;
+                    c10 = *sp;
+                    sp += 1;
+                    c11 = *sp;
+                }
+                else if ((dx == sw) && (dy == sh)) {
+                    sp = (tColorRGBA *)((Uint8 *)src->pixels +
+                                        src->pitch * dy);
+                    sp += dx;
+                    c00 = *sp;
+                    c01 = *sp;
+                    c10 = *sp;
+                    c11 = *sp;
+                }
+                else if ((dx == -1) && (dy == -1)) {
+                    sp = (tColorRGBA *)(src->pixels);
+                    c00 = *sp;
+                    c01 = *sp;
+                    c10 = *sp;
+                    c11 = *sp;
+                }
+                else if ((dx == -1) && (dy == sh)) {
+                    sp = (tColorRGBA *)((Uint8 *)src->pixels +
+                                        src->pitch * dy);
+                    c00 = *sp;
+                    c01 = *sp;
+                    c10 = *sp;
+                    c11 = *sp;
+                }
+                else if ((dx == sw) && (dy == -1)) {
+                    sp = (tColorRGBA *)(src->pixels);
+                    sp += dx;
+                    c00 = *sp;
+                    c01 = *sp;
+                    c10 = *sp;
+                    c11 = *sp;
+                }
+                else if (dx == -1) {
+                    sp = (tColorRGBA *)((Uint8 *)src->pixels +
+                                        src->pitch * dy);
+                    c00 = *sp;
+                    c01 = *sp;
+                    c10 = *sp;
+                    sp = (tColorRGBA *)((Uint8 *)sp + src->pitch);
+                    c11 = *sp;
+                }
+                else if (dy == -1) {
+                    sp = (tColorRGBA *)(src->pixels);
+                    sp += dx;
+                    c00 = *sp;
+                    c01 = *sp;
+                    c10 = *sp;
+                    sp += 1;
+                    c11 = *sp;
+                }
+                else if (dx == sw) {
+                    sp = (tColorRGBA *)((Uint8 *)src->pixels +
+                                        src->pitch * dy);
+                    sp += dx;
+                    c00 = *sp;
+                    c01 = *sp;
+                    sp = (tColorRGBA *)((Uint8 *)sp + src->pitch);
+                    c10 = *sp;
+                    c11 = *sp;
+                }
+                else if (dy == sh) {
+                    sp = (tColorRGBA *)((Uint8 *)src->pixels +
+                                        src->pitch * dy);
+                    sp += dx;
+                    c00 = *sp;
+                    sp += 1;
+                    c01 = *sp;
+                    c10 = *sp;
+                    c11 = *sp;
+                }
+                else {
+                    // NOTE: a catchall to appease gcc4 warnings...
+                    // Probably should not get here.  we'll see.
+                    //  old behaviour would be to use the previous pixel,
+                    //  from the previous loop.
+                    sp = (tColorRGBA *)(src->pixels);
+                    c00 = *sp;
+                    c01 = *sp;
+                    c10 = *sp;
+                    c11 = *sp;
+                }
+                /*
+                 * Interpolate colors
+                 */
+                ex = (sdx & 0xffff);
+                ey = (sdy & 0xffff);
+                t1 = ((((c01.r - c00.r) * ex) >> 16) + c00.r) & 0xff;
+                t2 = ((((c11.r - c10.r) * ex) >> 16) + c10.r) & 0xff;
+                pc->r = (((t2 - t1) * ey) >> 16) + t1;
+                t1 = ((((c01.g - c00.g) * ex) >> 16) + c00.g) & 0xff;
+                t2 = ((((c11.g - c10.g) * ex) >> 16) + c10.g) & 0xff;
+                pc->g = (((t2 - t1) * ey) >> 16) + t1;
+                t1 = ((((c01.b - c00.b) * ex) >> 16) + c00.b) & 0xff;
+                t2 = ((((c11.b - c10.b) * ex) >> 16) + c10.b) & 0xff;
+                pc->b = (((t2 - t1) * ey) >> 16) + t1;
+                t1 = ((((c01.a - c00.a) * ex) >> 16) + c00.a) & 0xff;
+                t2 = ((((c11.a - c10.a) * ex) >> 16) + c10.a) & 0xff;
+                pc->a = (((t2 - t1) * ey) >> 16) + t1;
+                if (x < lo) {
+                    lo = x;
+                }
+                hi = x;
+            }
+            sdx += stepx;
+            sdy += stepy;
+            pc++;
         }
     }
     else {
-        for (y = 0; y < dst->h; y++) {
-            dy = cy - y;
-            sdx = (ax + (isin * dy)) + xd;
-            sdy = (ay - (icos * dy)) + yd;
-            for (x = 0; x < dst->w; x++) {
-                dx = (short)(sdx >> 16);
-                dy = (short)(sdy >> 16);
-                if ((dx >= 0) && (dy >= 0) && (dx < src->w) && (dy < src->h)) {
-                    sp =
-                        (tColorRGBA *)((Uint8 *)src->pixels + src->pitch * dy);
-                    sp += dx;
-                    *pc = *sp;
+        for (x = 0; x < width; x++) {
+            dx = (short)(sdx >> 16);
+            dy = (short)(sdy >> 16);
+            if ((dx >= 0) && (dy >= 0) && (dx < src->w) && (dy < src->h)) {
+                sp = (tColorRGBA *)((Uint8 *)src->pixels + src->pitch * dy);
+                sp += dx;
+                *pc = *sp;
+                if (x < lo) {
+                    lo = x;
                 }
-                sdx += icos;
-                sdy += isin;
-                pc++;
+                hi = x;
             }
-            pc = (tColorRGBA *)((Uint8 *)pc + gap);
+            sdx += stepx;
+            sdy += stepy;
+            pc++;
         }
     }
+    if (first) {
+        *first = lo;
+        *last = hi;
+    }
+}
+
+/*
+
+ 32bit Rotozoomer with optional anti-aliasing by bilinear interpolation.
+
+ Rotates and zooms 32bit RGBA/ABGR 'src' surface to 'dst' surface.
+
+*/
+
+typedef struct {
+    SDL_Surface *src;
+    SDL_Surface *dst;
+    int cy, isin, icos, smooth;
+    int xd, yd, ax, ay;
+} tTransformRows;
+
+static void
+transformRowsRGBA(void *data, int start, int end)
+{
+    tTransformRows *t = (tTransformRows *)data;
+    int y, dy;
+    Uint8 *row = (Uint8 *)t->dst->pixels + (size_t)start * t->dst->pitch;
+
+    for (y = start; y < end; y++) {
+        dy = t->cy - y;
+        transformRowRGBA(t->src, row, t->dst->w,
+                         (t->ax + (t->isin * dy)) + t->xd,
+                         (t->ay - (t->icos * dy)) + t->yd, t->icos, t->isin,
+                         t->smooth, NULL, NULL);
+        row += t->dst->pitch;
+    }
+}
+
+void
+transformSurfaceRGBA(SDL_Surface *src, SDL_Surface *dst, int cx, int cy,
+                     int isin, int icos, int smooth, pg_rowrunner run_rows)
+{
+    tTransformRows t;
+
+    /*
+     * Variable setup
+     */
+    t.src = src;
+    t.dst = dst;
+    t.cy = cy;
+    t.isin = isin;
+    t.icos = icos;
+    t.smooth = smooth;
+    t.xd = ((unsigned long long)(src->w - dst->w) << 15);
+    t.yd = ((unsigned long long)(src->h - dst->h) << 15);
+    t.ax = (cx << 16) - (icos * cx);
+    t.ay = (cy << 16) - (isin * cx);
+
+    runRows(run_rows, dst->h, (Py_ssize_t)dst->w * dst->h, transformRowsRGBA,
+            &t);
 }
 
 /*
@@ -409,6 +593,7 @@ transformSurfaceRGBA(SDL_Surface *src, SDL_Surface *dst, int cx, int cy,
  'smooth' is 1 then the destination 32bit surface is anti-aliased. If the
  surface is not 8bit or 32bit RGBA/ABGR it will be converted into a 32bit RGBA
  format on the fly.
+ 'run_rows' splits the work on several threads, see pg_rowrunner.
 
 */
 
@@ -504,7 +689,8 @@ zoomSurfaceSize(int width, int height, double zoomx, double zoomy,
 /* Publicly available rotozoom function */
 
 SDL_Surface *
-rotozoomSurface(SDL_Surface *src, double angle, double zoom, int smooth)
+rotozoomSurface(SDL_Surface *src, double angle, double zoom, int smooth,
+                pg_rowrunner run_rows)
 {
     SDL_Surface *rz_src;
     SDL_Surface *rz_dst;
@@ -612,7 +798,7 @@ rotozoomSurface(SDL_Surface *src, double angle, double zoom, int smooth)
          */
         transformSurfaceRGBA(rz_src, rz_dst, dstwidthhalf, dstheighthalf,
                              (int)(sanglezoominv), (int)(canglezoominv),
-                             smooth);
+                             smooth, run_rows);
         /*
          * Turn on source-alpha support
          */
@@ -669,7 +855,7 @@ rotozoomSurface(SDL_Surface *src, double angle, double zoom, int smooth)
          * Call the 32bit transformation routine to do the zooming (using
          * alpha)
          */
-        zoomSurfaceRGBA(rz_src, rz_dst, smooth);
+        zoomSurfaceRGBA(rz_src, rz_dst, smooth, run_rows);
         /*
          * Turn on source-alpha support
          */
@@ -28,16 +28,21 @@
    an astonishing job of doubling game graphic data while interpolating out
    the jaggies. Congrats to the AdvanceMAME team, I'm very impressed and
    surprised with this code!
+
+   Scale3x comes from the same page, and Scale4x is Scale2x applied twice,
+   as AdvanceMAME defines it. xBR is Hyllian's 2xBR filter, which looks
+   for edges in a 5x5 block around each pixel and blends the pixels along
+   them instead of only copying neighbours.
 */
 
-#ifdef PG_SDL3
-#include <SDL3/SDL.h>
-#else
-#include <SDL.h>
-#endif
+#include "simd_transform.h"
 
+#ifndef MAX
 #define MAX(a, b) (((a) > (b)) ? (a) : (b))
+#endif
+#ifndef MIN
 #define MIN(a, b) (((a) < (b)) ? (a) : (b))
+#endif
 
 static inline int
 read_int24(const Uint8 *x)
@@ -54,187 +59,540 @@ store_int24(Uint8 *x, int i)
 }
 
 /*
-  this requires a destination surface already setup to be twice as
-  large as the source. oh, and formats must match too. this will just
-  blindly assume you didn't flounder.
+  The scalers work on rows of 32 bit pixel values whatever the depth of the
+  surfaces, padded with two copies of the end pixels on each side so that
+  the neighbours of every pixel can be read without checks.
 */
+#define ROW_PADDING 2
 
-void
-scale2x(SDL_Surface *src, SDL_Surface *dst)
+static void
+load_row(const Uint8 *src, int bpp, Uint32 *row, int width)
 {
-    int looph, loopw;
-
-    Uint8 *srcpix = (Uint8 *)src->pixels;
-    Uint8 *dstpix = (Uint8 *)dst->pixels;
+    int x;
 
-    const int srcpitch = src->pitch;
-    const int dstpitch = dst->pitch;
-    const int width = src->w;
-    const int height = src->h;
+    switch (bpp) {
+        case 1:
+            for (x = 0; x < width; x++) {
+                row[x] = src[x];
+            }
+            break;
+        case 2:
+            for (x = 0; x < width; x++) {
+                row[x] = ((const Uint16 *)src)[x];
+            }
+            break;
+        case 3:
+            for (x = 0; x < width; x++) {
+                row[x] = read_int24(src + x * 3);
+            }
+            break;
+        default:
+            memcpy(row, src, (size_t)width * 4);
+            break;
+    }
+    row[-2] = row[-1] = row[0];
+    row[width] = row[width + 1] = row[width - 1];
+}
 
-#if SDL_VERSION_ATLEAST(3, 0, 0)
-    const Uint8 Bpp = SDL_BYTESPERPIXEL(src->format);
-#else
-    const Uint8 Bpp = src->format->BytesPerPixel;
-#endif
+static void
+store_row(const Uint32 *row, Uint8 *dst, int bpp, int count)
+{
+    int x;
 
-    switch (Bpp) {
-        case 1: {
-            Uint8 E0, E1, E2, E3, B, D, E, F, H;
-            for (looph = 0; looph < height; ++looph) {
-                Uint8 *src_row = srcpix + looph * srcpitch;
-                Uint8 *dst_row0 = dstpix + looph * 2 * dstpitch;
-                Uint8 *dst_row1 = dstpix + (looph * 2 + 1) * dstpitch;
-
-                Uint8 *src_row_prev = srcpix + MAX(0, looph - 1) * srcpitch;
-                Uint8 *src_row_next =
-                    srcpix + MIN(height - 1, looph + 1) * srcpitch;
-
-                for (loopw = 0; loopw < width; ++loopw) {
-                    B = *(Uint8 *)(src_row_prev + loopw);
-                    D = *(Uint8 *)(src_row + MAX(0, loopw - 1));
-                    E = *(Uint8 *)(src_row + loopw);
-                    F = *(Uint8 *)(src_row + MIN(width - 1, loopw + 1));
-                    H = *(Uint8 *)(src_row_next + loopw);
-
-                    if (B != H && D != F) {
-                        E0 = (D == B) ? D : E;
-                        E1 = (B == F) ? F : E;
-                        E2 = (D == H) ? D : E;
-                        E3 = (H == F) ? F : E;
-                    }
-                    else {
-                        E0 = E;
-                        E1 = E;
-                        E2 = E;
-                        E3 = E;
-                    }
-
-                    *(Uint8 *)(dst_row0 + loopw * 2) = E0;
-                    *(Uint8 *)(dst_row0 + loopw * 2 + 1) = E1;
-                    *(Uint8 *)(dst_row1 + loopw * 2) = E2;
-                    *(Uint8 *)(dst_row1 + loopw * 2 + 1) = E3;
-                }
+    switch (bpp) {
+        case 1:
+            for (x = 0; x < count; x++) {
+                dst[x] = (Uint8)row[x];
             }
             break;
-        }
-        case 2: {
-            Uint16 E0, E1, E2, E3, B, D, E, F, H;
-            for (looph = 0; looph < height; ++looph) {
-                Uint8 *src_row = srcpix + looph * srcpitch;
-                Uint8 *dst_row0 = dstpix + looph * 2 * dstpitch;
-                Uint8 *dst_row1 = dstpix + (looph * 2 + 1) * dstpitch;
-
-                Uint8 *src_row_prev = srcpix + MAX(0, looph - 1) * srcpitch;
-                Uint8 *src_row_next =
-                    srcpix + MIN(height - 1, looph + 1) * srcpitch;
-
-                for (loopw = 0; loopw < width; ++loopw) {
-                    B = *(Uint16 *)(src_row_prev + 2 * loopw);
-                    D = *(Uint16 *)(src_row + 2 * MAX(0, loopw - 1));
-                    E = *(Uint16 *)(src_row + 2 * loopw);
-                    F = *(Uint16 *)(src_row + 2 * MIN(width - 1, loopw + 1));
-                    H = *(Uint16 *)(src_row_next + 2 * loopw);
-
-                    if (B != H && D != F) {
-                        E0 = (D == B) ? D : E;
-                        E1 = (B == F) ? F : E;
-                        E2 = (D == H) ? D : E;
-                        E3 = (H == F) ? F : E;
-                    }
-                    else {
-                        E0 = E;
-                        E1 = E;
-                        E2 = E;
-                        E3 = E;
-                    }
-
-                    *(Uint16 *)(dst_row0 + loopw * 2 * 2) = E0;
-                    *(Uint16 *)(dst_row0 + (loopw * 2 + 1) * 2) = E1;
-                    *(Uint16 *)(dst_row1 + loopw * 2 * 2) = E2;
-                    *(Uint16 *)(dst_row1 + (loopw * 2 + 1) * 2) = E3;
-                }
+        case 2:
+            for (x = 0; x < count; x++) {
+                ((Uint16 *)dst)[x] = (Uint16)row[x];
             }
             break;
-        }
-        case 3: {
-            int E0, E1, E2, E3, B, D, E, F, H;
-            for (looph = 0; looph < height; ++looph) {
-                Uint8 *src_row = srcpix + looph * srcpitch;
-                Uint8 *dst_row0 = dstpix + looph * 2 * dstpitch;
-                Uint8 *dst_row1 = dstpix + (looph * 2 + 1) * dstpitch;
-
-                Uint8 *src_row_prev = srcpix + MAX(0, looph - 1) * srcpitch;
-                Uint8 *src_row_next =
-                    srcpix + MIN(height - 1, looph + 1) * srcpitch;
-
-                for (loopw = 0; loopw < width; ++loopw) {
-                    B = read_int24(src_row_prev + (3 * loopw));
-                    D = read_int24(src_row + (3 * MAX(0, loopw - 1)));
-                    E = read_int24(src_row + (3 * loopw));
-                    F = read_int24(src_row + (3 * MIN(width - 1, loopw + 1)));
-                    H = read_int24(src_row_next + (3 * loopw));
-
-                    if (B != H && D != F) {
-                        E0 = (D == B) ? D : E;
-                        E1 = (B == F) ? F : E;
-                        E2 = (D == H) ? D : E;
-                        E3 = (H == F) ? F : E;
-                    }
-                    else {
-                        E0 = E;
-                        E1 = E;
-                        E2 = E;
-                        E3 = E;
-                    }
-
-                    store_int24(dst_row0 + loopw * 2 * 3, E0);
-                    store_int24(dst_row0 + (loopw * 2 + 1) * 3, E1);
-                    store_int24(dst_row1 + loopw * 2 * 3, E2);
-                    store_int24(dst_row1 + (loopw * 2 + 1) * 3, E3);
-                }
+        case 3:
+            for (x = 0; x < count; x++) {
+                store_int24(dst + x * 3, row[x]);
             }
             break;
+        default:
+            memcpy(dst, row, (size_t)count * 4);
+            break;
+    }
+}
+
+static void
+scale2x_row(const Uint32 *prev, const Uint32 *cur, const Uint32 *next,
+            Uint32 *out0, Uint32 *out1, int count)
+{
+    Uint32 B, D, E, F, H;
+    int x;
+
+    for (x = 0; x < count; x++) {
+        B = prev[x];
+        D = cur[x - 1];
+        E = cur[x];
+        F = cur[x + 1];
+        H = next[x];
+
+        if (B != H && D != F) {
+            out0[x * 2] = (D == B) ? D : E;
+            out0[x * 2 + 1] = (B == F) ? F : E;
+            out1[x * 2] = (D == H) ? D : E;
+            out1[x * 2 + 1] = (H == F) ? F : E;
         }
-        default: {
-            Uint32 E0, E1, E2, E3, B, D, E, F, H;
-
-            for (looph = 0; looph < height; ++looph) {
-                Uint8 *src_row = srcpix + looph * srcpitch;
-                Uint8 *dst_row0 = dstpix + looph * 2 * dstpitch;
-                Uint8 *dst_row1 = dstpix + (looph * 2 + 1) * dstpitch;
-
-                Uint8 *src_row_prev = srcpix + MAX(0, looph - 1) * srcpitch;
-                Uint8 *src_row_next =
-                    srcpix + MIN(height - 1, looph + 1) * srcpitch;
-
-                for (loopw = 0; loopw < width; ++loopw) {
-                    B = *(Uint32 *)(src_row_prev + 4 * loopw);
-                    D = *(Uint32 *)(src_row + 4 * MAX(0, loopw - 1));
-                    E = *(Uint32 *)(src_row + 4 * loopw);
-                    F = *(Uint32 *)(src_row + 4 * MIN(width - 1, loopw + 1));
-                    H = *(Uint32 *)(src_row_next + 4 * loopw);
-
-                    if (B != H && D != F) {
-                        E0 = (D == B) ? D : E;
-                        E1 = (B == F) ? F : E;
-                        E2 = (D == H) ? D : E;
-                        E3 = (H == F) ? F : E;
-                    }
-                    else {
-                        E0 = E;
-                        E1 = E;
-                        E2 = E;
-                        E3 = E;
-                    }
-
-                    *(Uint32 *)(dst_row0 + loopw * 2 * 4) = E0;
-                    *(Uint32 *)(dst_row0 + (loopw * 2 + 1) * 4) = E1;
-                    *(Uint32 *)(dst_row1 + loopw * 2 * 4) = E2;
-                    *(Uint32 *)(dst_row1 + (loopw * 2 + 1) * 4) = E3;
-                }
+        else {
+            out0[x * 2] = out0[x * 2 + 1] = E;
+            out1[x * 2] = out1[x * 2 + 1] = E;
+        }
+    }
+}
+
+static void
+scale3x_row(const Uint32 *prev, const Uint32 *cur, const Uint32 *next,
+            Uint32 *out0, Uint32 *out1, Uint32 *out2, int count)
+{
+    Uint32 A, B, C, D, E, F, G, H, I;
+    int x;
+
+    for (x = 0; x < count; x++) {
+        A = prev[x - 1];
+        B = prev[x];
+        C = prev[x + 1];
+        D = cur[x - 1];
+        E = cur[x];
+        F = cur[x + 1];
+        G = next[x - 1];
+        H = next[x];
+        I = next[x + 1];
+
+        if (B != H && D != F) {
+            out0[x * 3] = (D == B) ? D : E;
+            out0[x * 3 + 1] =
+                ((D == B && E != C) || (B == F && E != A)) ? B : E;
+            out0[x * 3 + 2] = (B == F) ? F : E;
+            out1[x * 3] = ((D == B && E != G) || (D == H && E != A)) ? D : E;
+            out1[x * 3 + 1] = E;
+            out1[x * 3 + 2] =
+                ((B == F && E != I) || (H == F && E != C)) ? F : E;
+            out2[x * 3] = (D == H) ? D : E;
+            out2[x * 3 + 1] =
+                ((D == H && E != I) || (H == F && E != G)) ? H : E;
+            out2[x * 3 + 2] = (H == F) ? F : E;
+        }
+        else {
+            out0[x * 3] = out0[x * 3 + 1] = out0[x * 3 + 2] = E;
+            out1[x * 3] = out1[x * 3 + 1] = out1[x * 3 + 2] = E;
+            out2[x * 3] = out2[x * 3 + 1] = out2[x * 3 + 2] = E;
+        }
+    }
+}
+
+/*
+  The pixels of xBR, with their color in YUV to measure the differences
+  like hqx does.
+*/
+typedef struct {
+    Uint32 pixel;
+    Sint32 y, u, v;
+} xbrPixel;
+
+static void
+xbr_load_row(const Uint32 *row, xbrPixel *dst, int count, const int *shifts)
+{
+    int x;
+
+    for (x = 0; x < count; x++) {
+        int r = (row[x] >> shifts[0]) & 0xff;
+        int g = (row[x] >> shifts[1]) & 0xff;
+        int b = (row[x] >> shifts[2]) & 0xff;
+
+        dst[x].pixel = row[x];
+        dst[x].y = 77 * r + 150 * g + 29 * b;
+        dst[x].u = -43 * r - 85 * g + 128 * b;
+        dst[x].v = 128 * r - 107 * g - 21 * b;
+    }
+}
+
+static inline int
+xbr_diff(const xbrPixel *a, const xbrPixel *b)
+{
+    return 48 * abs(a->y - b->y) + 7 * abs(a->u - b->u) +
+           6 * abs(a->v - b->v);
+}
+
+static inline int
+xbr_eq(const xbrPixel *a, const xbrPixel *b)
+{
+    return abs(a->y - b->y) <= 48 * 256 && abs(a->u - b->u) <= 7 * 256 &&
+           abs(a->v - b->v) <= 6 * 256;
+}
+
+/* Moves weight / 256 of the way from each byte of dst to src */
+static inline Uint32
+xbr_blend(Uint32 dst, Uint32 src, Uint32 weight)
+{
+    Uint32 result = 0;
+    int k;
+
+    for (k = 0; k < 32; k += 8) {
+        Uint32 d = (dst >> k) & 0xff, s = (src >> k) & 0xff;
+        result |= ((s * weight + d * (256 - weight)) >> 8) << k;
+    }
+    return result;
+}
+
+/*
+  The neighbours used by the filter of each corner, as indexes in the 5x5
+  block around E numbered row by row, followed by the output pixels N1, N2
+  and N3 of the 2x2 block of E numbered the same way. The filter is written
+  for the bottom right corner, the other corners turn the block around:
+
+        A1 B1 C1
+     A0 A  B  C  C4
+     D0 D  E  F  F4        N0 N1
+     G0 G  H  I  I4        N2 N3
+        G5 H5 I5
+*/
+enum {
+    XBR_E,
+    XBR_I,
+    XBR_H,
+    XBR_F,
+    XBR_G,
+    XBR_C,
+    XBR_D,
+    XBR_B,
+    XBR_F4,
+    XBR_I4,
+    XBR_H5,
+    XBR_I5,
+    XBR_N1,
+    XBR_N2,
+    XBR_N3,
+    XBR_CORNER_SIZE
+};
+
+static const Uint8 xbr_corners[4][XBR_CORNER_SIZE] = {
+    {12, 18, 17, 13, 16, 8, 11, 7, 14, 19, 22, 23, 1, 2, 3},
+    {12, 8, 13, 7, 18, 6, 17, 11, 2, 3, 14, 9, 0, 3, 1},
+    {12, 6, 7, 11, 8, 16, 13, 17, 10, 5, 2, 1, 2, 1, 0},
+    {12, 16, 11, 17, 6, 18, 7, 13, 22, 21, 10, 15, 3, 0, 2},
+};
+
+static void
+xbr_corner(const xbrPixel *const *block, const Uint8 *corner, Uint32 *out)
+{
+    const xbrPixel *E = block[corner[XBR_E]], *I = block[corner[XBR_I]];
+    const xbrPixel *H = block[corner[XBR_H]], *F = block[corner[XBR_F]];
+    const xbrPixel *G = block[corner[XBR_G]], *C = block[corner[XBR_C]];
+    const xbrPixel *D = block[corner[XBR_D]], *B = block[corner[XBR_B]];
+    const xbrPixel *F4 = block[corner[XBR_F4]], *I4 = block[corner[XBR_I4]];
+    const xbrPixel *H5 = block[corner[XBR_H5]], *I5 = block[corner[XBR_I5]];
+    Uint32 *N1 = out + corner[XBR_N1], *N2 = out + corner[XBR_N2];
+    Uint32 *N3 = out + corner[XBR_N3];
+    int e, i, ke, ki, shallow, steep;
+    Uint32 px;
+
+    if (E->pixel == H->pixel || E->pixel == F->pixel) {
+        return;
+    }
+
+    /* the weight of an edge along H-F against one along E-I */
+    e = xbr_diff(E, C) + xbr_diff(E, G) + xbr_diff(I, H5) + xbr_diff(I, F4) +
+        4 * xbr_diff(H, F);
+    i = xbr_diff(H, D) + xbr_diff(H, I5) + xbr_diff(F, I4) + xbr_diff(F, B) +
+        4 * xbr_diff(E, I);
+    px = xbr_diff(E, F) <= xbr_diff(E, H) ? F->pixel : H->pixel;
+
+    if (e < i && ((!xbr_eq(F, B) && !xbr_eq(H, D)) ||
+                  (xbr_eq(E, I) && !xbr_eq(F, I4) && !xbr_eq(H, I5)) ||
+                  xbr_eq(E, G) || xbr_eq(E, C))) {
+        /* shallow and steep edges reach into the next corners */
+        ke = xbr_diff(F, G);
+        ki = xbr_diff(H, C);
+        shallow = ke * 2 <= ki && E->pixel != G->pixel &&
+                  D->pixel != G->pixel;
+        steep = ke >= ki * 2 && E->pixel != C->pixel && B->pixel != C->pixel;
+
+        if (shallow || steep) {
+            *N3 = xbr_blend(*N3, px, 192);
+            if (shallow) {
+                *N2 = xbr_blend(*N2, px, 64);
             }
-            break;
+            if (steep) {
+                *N1 = xbr_blend(*N1, px, 64);
+            }
+        }
+        else {
+            *N3 = xbr_blend(*N3, px, 128);
+        }
+    }
+    else if (e <= i) {
+        *N3 = xbr_blend(*N3, px, 64);
+    }
+}
+
+static void
+xbr_row(const xbrPixel *const *rows, Uint32 *out0, Uint32 *out1, int count)
+{
+    const xbrPixel *block[25];
+    Uint32 out[4];
+    int x, k;
+
+    for (x = 0; x < count; x++) {
+        for (k = 0; k < 25; k++) {
+            block[k] = rows[k / 5] + x + k % 5 - 2;
         }
+        out[0] = out[1] = out[2] = out[3] = rows[2][x].pixel;
+        for (k = 0; k < 4; k++) {
+            xbr_corner(block, xbr_corners[k], out);
+        }
+        out0[x * 2] = out[0];
+        out0[x * 2 + 1] = out[1];
+        out1[x * 2] = out[2];
+        out1[x * 2 + 1] = out[3];
+    }
+}
+
+typedef struct {
+    const Uint8 *srcpix;
+    Uint8 *dstpix;
+    int srcpitch, dstpitch;
+    int srcbpp, dstbpp;
+    int width, height; /* of the source */
+    int factor;
+    const int *shifts; /* of red, green and blue for xBR, else NULL */
+    int simd;
+    int failed;
+} scalexPass;
+
+static void
+scalex_rows(scalexPass *pass, const Uint32 *prev, const Uint32 *cur,
+            const Uint32 *next, Uint32 **out)
+{
+    int count = pass->width, done = 0;
+
+#if !defined(__EMSCRIPTEN__)
+    if (pass->simd == 2) {
+        done = count & ~7;
+        if (pass->factor == 2) {
+            scale2x_row_avx2(prev, cur, next, out[0], out[1], done);
+        }
+        else {
+            scale3x_row_avx2(prev, cur, next, out[0], out[1], out[2], done);
+        }
+    }
+#if defined(__SSE2__) || defined(PG_ENABLE_ARM_NEON)
+    else if (pass->simd) {
+        done = count & ~3;
+        if (pass->factor == 2) {
+            scale2x_row_sse2(prev, cur, next, out[0], out[1], done);
+        }
+        else {
+            scale3x_row_sse2(prev, cur, next, out[0], out[1], out[2], done);
+        }
+    }
+#endif /* defined(__SSE2__) || defined(PG_ENABLE_ARM_NEON) */
+#endif /* !defined(__EMSCRIPTEN__) */
+
+    if (pass->factor == 2) {
+        scale2x_row(prev + done, cur + done, next + done, out[0] + done * 2,
+                    out[1] + done * 2, count - done);
+    }
+    else {
+        scale3x_row(prev + done, cur + done, next + done, out[0] + done * 3,
+                    out[1] + done * 3, out[2] + done * 3, count - done);
+    }
+}
+
+static void
+scalex_band(void *data, int start, int end)
+{
+    scalexPass *pass = (scalexPass *)data;
+    const int width = pass->width, factor = pass->factor;
+    const int padded = width + ROW_PADDING * 2;
+    const int nrows = pass->shifts ? 5 : 3;
+    Uint32 *scratch, *out[3];
+    xbrPixel *xbrscratch = NULL;
+    const xbrPixel *xbrrows[5];
+    Uint32 *rows[5];
+    int y, k, outrows = 0;
+
+    /* the 32 bit output rows are only needed for other depths */
+    if (pass->dstbpp != 4) {
+        outrows = factor;
+    }
+    scratch = (Uint32 *)malloc(
+        sizeof(Uint32) * ((size_t)padded * nrows + (size_t)width * factor *
+                                                       outrows));
+    if (pass->shifts) {
+        xbrscratch = (xbrPixel *)malloc(sizeof(xbrPixel) * padded * 5);
+    }
+    if (!scratch || (pass->shifts && !xbrscratch)) {
+        free(scratch);
+        free(xbrscratch);
+        pass->failed = 1;
+        return;
+    }
+    for (k = 0; k < nrows; k++) {
+        rows[k] = scratch + (size_t)padded * k + ROW_PADDING;
+    }
+
+    for (y = start; y < end; y++) {
+        for (k = 0; k < nrows; k++) {
+            int srcy = MIN(MAX(y + k - nrows / 2, 0), pass->height - 1);
+
+            load_row(pass->srcpix + (size_t)srcy * pass->srcpitch,
+                     pass->srcbpp, rows[k], width);
+            if (xbrscratch) {
+                xbr_load_row(rows[k] - ROW_PADDING,
+                             xbrscratch + (size_t)padded * k, padded,
+                             pass->shifts);
+                xbrrows[k] = xbrscratch + (size_t)padded * k + ROW_PADDING;
+            }
+        }
+
+        for (k = 0; k < factor; k++) {
+            if (outrows) {
+                out[k] = scratch + (size_t)padded * nrows +
+                         (size_t)width * factor * k;
+            }
+            else {
+                out[k] = (Uint32 *)(pass->dstpix +
+                                    ((size_t)y * factor + k) * pass->dstpitch);
+            }
+        }
+
+        if (xbrscratch) {
+            xbr_row(xbrrows, out[0], out[1], width);
+        }
+        else {
+            scalex_rows(pass, rows[0], rows[1], rows[2], out);
+        }
+
+        for (k = 0; k < outrows; k++) {
+            store_row(out[k],
+                      pass->dstpix + ((size_t)y * factor + k) * pass->dstpitch,
+                      pass->dstbpp, width * factor);
+        }
+    }
+    free(scratch);
+    free(xbrscratch);
+}
+
+static int
+scalex_run(scalexPass *pass, pg_rowrunner run_rows)
+{
+    Py_ssize_t work = (Py_ssize_t)pass->width * pass->height * pass->factor *
+                      pass->factor * (pass->shifts ? 16 : 1);
+
+    pass->failed = 0;
+    if (run_rows) {
+        run_rows(pass->height, work, scalex_band, pass);
+    }
+    else {
+        scalex_band(pass, 0, pass->height);
+    }
+    return !pass->failed;
+}
+
+static void
+scalex_init(scalexPass *pass, SDL_Surface *src, SDL_Surface *dst, int factor,
+            int simd)
+{
+    pass->srcpix = (Uint8 *)src->pixels;
+    pass->srcpitch = src->pitch;
+    pass->srcbpp = PG_SURF_BytesPerPixel(src);
+    pass->dstpix = (Uint8 *)dst->pixels;
+    pass->dstpitch = dst->pitch;
+    pass->dstbpp = PG_SURF_BytesPerPixel(dst);
+    pass->width = src->w;
+    pass->height = src->h;
+    pass->factor = factor;
+    pass->shifts = NULL;
+    pass->simd = simd;
+}
+
+/*
+  These require a destination surface already set up to be two, three or
+  four times as large as the source, of the same format. simd is 1 for the
+  SSE2 or NEON rows and 2 for the AVX2 ones, and run_rows splits the rows
+  on several threads, see pg_rowrunner. They return 0 when out of
+  memory.
+*/
+
+int
+scale2x(SDL_Surface *src, SDL_Surface *dst, int simd, pg_rowrunner run_rows)
+{
+    scalexPass pass;
+
+    if (!src->w || !src->h) {
+        return 1;
+    }
+    scalex_init(&pass, src, dst, 2, simd);
+    return scalex_run(&pass, run_rows);
+}
+
+int
+scale3x(SDL_Surface *src, SDL_Surface *dst, int simd, pg_rowrunner run_rows)
+{
+    scalexPass pass;
+
+    if (!src->w || !src->h) {
+        return 1;
+    }
+    scalex_init(&pass, src, dst, 3, simd);
+    return scalex_run(&pass, run_rows);
+}
+
+int
+scale4x(SDL_Surface *src, SDL_Surface *dst, int simd, pg_rowrunner run_rows)
+{
+    scalexPass pass;
+    Uint32 *temp;
+    int okay;
+
+    if (!src->w || !src->h) {
+        return 1;
+    }
+
+    /* Scale2x into a 32 bit buffer, then Scale2x again into dst */
+    temp = (Uint32 *)malloc(sizeof(Uint32) * src->w * 2 * src->h * 2);
+    if (!temp) {
+        return 0;
+    }
+    scalex_init(&pass, src, dst, 2, simd);
+    pass.dstpix = (Uint8 *)temp;
+    pass.dstpitch = src->w * 2 * 4;
+    pass.dstbpp = 4;
+    okay = scalex_run(&pass, run_rows);
+
+    if (okay) {
+        scalex_init(&pass, src, dst, 2, simd);
+        pass.srcpix = (Uint8 *)temp;
+        pass.srcpitch = src->w * 2 * 4;
+        pass.srcbpp = 4;
+        pass.width = src->w * 2;
+        pass.height = src->h * 2;
+        okay = scalex_run(&pass, run_rows);
+    }
+    free(temp);
+    return okay;
+}
+
+/* shifts are the bit positions of red, green and blue in the pixel values
+ * of the 24 or 32 bit src, as read by load_row */
+int
+xbr2x(SDL_Surface *src, SDL_Surface *dst, const int *shifts,
+      pg_rowrunner run_rows)
+{
+    scalexPass pass;
+
+    if (!src->w || !src->h) {
+        return 1;
     }
+    scalex_init(&pass, src, dst, 2, 0);
+    pass.shifts = shifts;
+    return scalex_run(&pass, run_rows);
 }
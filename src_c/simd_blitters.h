@@ -8,6 +8,18 @@
 #define PG_ENABLE_ARM_NEON 1
 #endif
 
+/* On arm64 the SSE2 code paths can run hand written NEON kernels instead of
+ * going through sse2neon. They are opt in until they have been measured on
+ * arm64 hardware, see the neon_kernels meson option. */
+#if !defined(PG_ENABLE_NATIVE_NEON)
+#if defined(__aarch64__) && PG_ENABLE_ARM_NEON && \
+    defined(PG_NEON_NATIVE_KERNELS)
+#define PG_ENABLE_NATIVE_NEON 1
+#else
+#define PG_ENABLE_NATIVE_NEON 0
+#endif
+#endif /* !defined(PG_ENABLE_NATIVE_NEON) */
+
 #if (defined(__SSE2__) || defined(PG_ENABLE_ARM_NEON))
 void
 alphablit_alpha_sse2_argb_surf_alpha(SDL_BlitInfo *info);
@@ -57,6 +69,9 @@ premul_surf_color_by_alpha_non_simd(SDL_Surface *src,
 void
 premul_surf_color_by_alpha_sse2(SDL_Surface *src, PG_PixelFormat *srcfmt,
                                 SDL_Surface *dst);
+void
+convert_surf_pixels_sse2(SDL_Surface *src, SDL_Surface *dst,
+                         const int *shuffle);
 
 void
 alphablit_alpha_avx2_argb_no_surf_alpha_opaque_dst(SDL_BlitInfo *info);
@@ -89,3 +104,57 @@ blit_blend_premultiplied_avx2(SDL_BlitInfo *info);
 void
 premul_surf_color_by_alpha_avx2(SDL_Surface *src, PG_PixelFormat *src_format,
                                 SDL_Surface *dst);
+void
+convert_surf_pixels_avx2(SDL_Surface *src, SDL_Surface *dst,
+                         const int *shuffle);
+
+void
+alphablit_alpha_avx512_argb_no_surf_alpha_opaque_dst(SDL_BlitInfo *info);
+void
+alphablit_alpha_avx512_argb_no_surf_alpha(SDL_BlitInfo *info);
+void
+alphablit_alpha_avx512_argb_surf_alpha(SDL_BlitInfo *info);
+void
+blit_blend_rgba_mul_avx512(SDL_BlitInfo *info);
+void
+blit_blend_rgba_add_avx512(SDL_BlitInfo *info);
+void
+blit_blend_rgba_sub_avx512(SDL_BlitInfo *info);
+void
+blit_blend_rgba_max_avx512(SDL_BlitInfo *info);
+void
+blit_blend_rgba_min_avx512(SDL_BlitInfo *info);
+void
+blit_blend_premultiplied_avx512(SDL_BlitInfo *info);
+
+void
+alphablit_alpha_neon_argb_no_surf_alpha_opaque_dst(SDL_BlitInfo *info);
+void
+alphablit_alpha_neon_argb_no_surf_alpha(SDL_BlitInfo *info);
+void
+alphablit_alpha_neon_argb_surf_alpha(SDL_BlitInfo *info);
+void
+blit_blend_rgba_mul_neon(SDL_BlitInfo *info);
+void
+blit_blend_rgb_mul_neon(SDL_BlitInfo *info);
+void
+blit_blend_rgba_add_neon(SDL_BlitInfo *info);
+void
+blit_blend_rgb_add_neon(SDL_BlitInfo *info);
+void
+blit_blend_rgba_sub_neon(SDL_BlitInfo *info);
+void
+blit_blend_rgb_sub_neon(SDL_BlitInfo *info);
+void
+blit_blend_rgba_max_neon(SDL_BlitInfo *info);
+void
+blit_blend_rgb_max_neon(SDL_BlitInfo *info);
+void
+blit_blend_rgba_min_neon(SDL_BlitInfo *info);
+void
+blit_blend_rgb_min_neon(SDL_BlitInfo *info);
+void
+blit_blend_premultiplied_neon(SDL_BlitInfo *info);
+void
+premul_surf_color_by_alpha_neon(SDL_Surface *src, PG_PixelFormat *srcfmt,
+                                SDL_Surface *dst);
@@ -1645,3 +1645,94 @@ premul_surf_color_by_alpha_avx2(SDL_Surface *src, PG_PixelFormat *src_format,
 }
 #endif /* defined(__AVX2__) && defined(HAVE_IMMINTRIN_H) && \
 !defined(SDL_DISABLE_IMMINTRIN_H) */
+
+#if defined(__AVX2__) && defined(HAVE_IMMINTRIN_H) && \
+    !defined(SDL_DISABLE_IMMINTRIN_H)
+/* Converts the pixels of src to the format of dst, both having 8 bit
+ * channels in 3 or 4 bytes per pixel. Byte i of a dst pixel is byte
+ * shuffle[i] of the src pixel, or 0xFF where shuffle[i] is -1.
+ *
+ * Each 128 bit lane holds four pixels, 24 bit pixels being packed in the
+ * first 12 bytes of the lanes, so a single byte shuffle reorders them. */
+void
+convert_surf_pixels_avx2(SDL_Surface *src, SDL_Surface *dst,
+                         const int *shuffle)
+{
+    const int srcbpp = PG_SURF_BytesPerPixel(src);
+    const int dstbpp = PG_SURF_BytesPerPixel(dst);
+    const int width = src->w;
+    int x, y, p, i;
+    Uint8 *srcp, *dstp;
+    char shuffle_bytes[32], fill_bytes[32];
+
+    for (p = 0; p < 8; p++) {
+        for (i = 0; i < 4; i++) {
+            int lane = p / 4 * 16, s = shuffle[i];
+            int out = lane + p % 4 * dstbpp + i;
+            if (i >= dstbpp) {
+                /* the last four bytes of the lanes of 24 bit pixels */
+                out = lane + 12 + p % 4;
+                s = -2;
+            }
+            shuffle_bytes[out] = s < 0 ? -1 : (char)(p % 4 * srcbpp + s);
+            fill_bytes[out] = s == -1 ? -1 : 0;
+        }
+    }
+
+    const __m256i mm256_shuffle =
+        _mm256_loadu_si256((const __m256i *)shuffle_bytes);
+    const __m256i mm256_fill = _mm256_loadu_si256((const __m256i *)fill_bytes);
+    /* spreads 24 bytes over the lanes and packs them back */
+    const __m256i mm256_spread = _mm256_set_epi32(5, 5, 4, 3, 2, 2, 1, 0);
+    const __m256i mm256_pack = _mm256_set_epi32(7, 7, 6, 5, 4, 2, 1, 0);
+    const __m256i mm256_mask24 =
+        _mm256_set_epi32(0, 0, -1, -1, -1, -1, -1, -1);
+    __m256i mm256_pixels;
+
+    for (y = 0; y < src->h; y++) {
+        srcp = (Uint8 *)src->pixels + (size_t)y * src->pitch;
+        dstp = (Uint8 *)dst->pixels + (size_t)y * dst->pitch;
+
+        for (x = 0; x + 8 <= width; x += 8) {
+            if (srcbpp == 4) {
+                mm256_pixels = _mm256_loadu_si256((__m256i *)srcp);
+            }
+            else {
+                mm256_pixels = _mm256_permutevar8x32_epi32(
+                    _mm256_maskload_epi32((int *)srcp, mm256_mask24),
+                    mm256_spread);
+            }
+
+            mm256_pixels = _mm256_or_si256(
+                _mm256_shuffle_epi8(mm256_pixels, mm256_shuffle), mm256_fill);
+
+            if (dstbpp == 4) {
+                _mm256_storeu_si256((__m256i *)dstp, mm256_pixels);
+            }
+            else {
+                _mm256_maskstore_epi32(
+                    (int *)dstp, mm256_mask24,
+                    _mm256_permutevar8x32_epi32(mm256_pixels, mm256_pack));
+            }
+            srcp += 8 * srcbpp;
+            dstp += 8 * dstbpp;
+        }
+
+        for (; x < width; x++) {
+            for (i = 0; i < dstbpp; i++) {
+                dstp[i] = shuffle[i] < 0 ? 0xFF : srcp[shuffle[i]];
+            }
+            srcp += srcbpp;
+            dstp += dstbpp;
+        }
+    }
+}
+#else
+void
+convert_surf_pixels_avx2(SDL_Surface *src, SDL_Surface *dst,
+                         const int *shuffle)
+{
+    BAD_AVX2_FUNCTION_CALL;
+}
+#endif /* defined(__AVX2__) && defined(HAVE_IMMINTRIN_H) && \
+!defined(SDL_DISABLE_IMMINTRIN_H) */
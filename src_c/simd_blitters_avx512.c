@@ -0,0 +1,505 @@
+#include "simd_blitters.h"
+
+#if defined(HAVE_IMMINTRIN_H) && !defined(SDL_DISABLE_IMMINTRIN_H)
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif /* defined(_MSC_VER) */
+#endif /* defined(HAVE_IMMINTRIN_H) && !defined(SDL_DISABLE_IMMINTRIN_H) */
+
+#define BAD_AVX512_FUNCTION_CALL                                       \
+    printf(                                                            \
+        "Fatal Error: Attempted calling an AVX512 function when both " \
+        "compile time and runtime support is missing. If you are "     \
+        "seeing this message, you have stumbled across a pygame bug, " \
+        "please report it to the devs!");                              \
+    PG_EXIT(1)
+
+#if defined(__AVX512F__) && defined(__AVX512BW__) && \
+    defined(HAVE_IMMINTRIN_H) && !defined(SDL_DISABLE_IMMINTRIN_H)
+/* SDL only exposes a check for the AVX512 foundation instructions, but the
+ * blitters below also need the byte/word extension (missing on Xeon Phi) */
+static int
+_pg_cpu_has_avx512bw(void)
+{
+#if defined(_MSC_VER)
+    int regs[4];
+    __cpuidex(regs, 7, 0);
+    return (regs[1] >> 30) & 1;
+#elif defined(__GNUC__)
+    return __builtin_cpu_supports("avx512bw");
+#else
+    return 0;
+#endif /* defined(_MSC_VER) */
+}
+#endif /* defined(__AVX512F__) && defined(__AVX512BW__) && \
+          defined(HAVE_IMMINTRIN_H) && !defined(SDL_DISABLE_IMMINTRIN_H) */
+
+/* helper function that does a runtime check for AVX512 (F and BW). It has
+ * the added functionality of also returning 0 if compile time support is
+ * missing */
+int
+pg_has_avx512()
+{
+#if defined(__AVX512F__) && defined(__AVX512BW__) && \
+    defined(HAVE_IMMINTRIN_H) && !defined(SDL_DISABLE_IMMINTRIN_H)
+    static int has_avx512 = -1;
+    if (has_avx512 < 0) {
+        has_avx512 = SDL_HasAVX512F() && _pg_cpu_has_avx512bw();
+    }
+    return has_avx512;
+#else
+    return 0;
+#endif /* defined(__AVX512F__) && defined(__AVX512BW__) && \
+          defined(HAVE_IMMINTRIN_H) && !defined(SDL_DISABLE_IMMINTRIN_H) */
+}
+
+/* Setup for RUN_AVX512_BLITTER */
+#define SETUP_AVX512_BLITTER                                               \
+    int width = info->width;                                               \
+    int height = info->height;                                             \
+                                                                           \
+    Uint32 *srcp = (Uint32 *)info->s_pixels;                               \
+    int srcskip = info->s_skip >> 2;                                       \
+    int srcpxskip = info->s_pxskip >> 2;                                   \
+                                                                           \
+    Uint32 *dstp = (Uint32 *)info->d_pixels;                               \
+    int dstskip = info->d_skip >> 2;                                       \
+    int dstpxskip = info->d_pxskip >> 2;                                   \
+                                                                           \
+    int pre_16_width = width % 16;                                         \
+    int post_16_width = width / 16;                                        \
+                                                                           \
+    /* Since this operates on 16 pixels at a time, it needs to mask out */ \
+    /* 0-15 pixels for partial loads/stores at periphery of blit area. */  \
+    /* Masked out lanes are never touched, so this can't fault */          \
+    __mmask16 _partial16_mask = (__mmask16)((1u << pre_16_width) - 1);     \
+                                                                           \
+    __m512i pixels_src, pixels_dst;
+
+/* Interface definition
+ * Definitions needed: MACRO(SETUP_AVX512_BLITTER)
+ * Input variables: None
+ * Output variables: pixels_src, pixels_dst (containing raw pixel data)
+ *
+ * Operation: BLITTER_CODE takes pixels_src and pixels_dst and puts processed
+ * results into pixels_dst
+ */
+#define RUN_AVX512_BLITTER(BLITTER_CODE)                                  \
+    while (height--) {                                                    \
+        for (int i = post_16_width; i > 0; i--) {                         \
+            /* ==== load 16 pixels into AVX512 registers ==== */          \
+            pixels_src = _mm512_loadu_si512((void *)srcp);                \
+            pixels_dst = _mm512_loadu_si512((void *)dstp);                \
+                                                                          \
+            {BLITTER_CODE}                                                \
+                                                                          \
+            /* ==== store 16 pixels from AVX512 registers ==== */         \
+            _mm512_storeu_si512((void *)dstp, pixels_dst);                \
+                                                                          \
+            srcp += 16;                                                   \
+            dstp += 16;                                                   \
+        }                                                                 \
+        if (pre_16_width > 0) {                                           \
+            pixels_src = _mm512_maskz_loadu_epi32(_partial16_mask, srcp); \
+            pixels_dst = _mm512_maskz_loadu_epi32(_partial16_mask, dstp); \
+                                                                          \
+            {BLITTER_CODE}                                                \
+                                                                          \
+            /* ==== store 1-15 pixels from AVX512 registers ==== */       \
+            _mm512_mask_storeu_epi32(dstp, _partial16_mask, pixels_dst);  \
+                                                                          \
+            srcp += srcpxskip * pre_16_width;                             \
+            dstp += dstpxskip * pre_16_width;                             \
+        }                                                                 \
+                                                                          \
+        srcp += srcskip;                                                  \
+        dstp += dstskip;                                                  \
+    }
+
+/* Setup for RUN_16BIT_UNPACK_AVX512 */
+#define SETUP_16BIT_UNPACK_AVX512                    \
+    const __m512i _zero512 = _mm512_setzero_si512(); \
+    __m512i shuff_src, shuff_dst, _shuff16_temp;
+
+/* Interface definition
+ * Definitions needed: MACRO(SETUP_16BIT_UNPACK_AVX512)
+ * Input variables: pixels_src, pixels_dst (containing raw pixel data)
+ * Output variables: pixels_dst (containing processed and repacked pixel data)
+ *
+ * Operation: BLITTER_CODE takes shuff_src and shuff_dst and puts resulting
+ * pixel data in shuff_dst
+ *
+ * Unlike the AVX2 version this doesn't need shuffle masks, the unpack and pack
+ * instructions work within each 128 bit lane so they undo each other.
+ */
+#define RUN_16BIT_UNPACK_AVX512(BLITTER_CODE)                 \
+    /* ==== unpack pixels out into two registers each, src */ \
+    /* and dst set up for 16 bit math, like 0A0R0G0B ==== */  \
+    shuff_src = _mm512_unpacklo_epi8(pixels_src, _zero512);   \
+    shuff_dst = _mm512_unpacklo_epi8(pixels_dst, _zero512);   \
+                                                              \
+    {BLITTER_CODE}                                            \
+                                                              \
+    _shuff16_temp = shuff_dst;                                \
+                                                              \
+    shuff_src = _mm512_unpackhi_epi8(pixels_src, _zero512);   \
+    shuff_dst = _mm512_unpackhi_epi8(pixels_dst, _zero512);   \
+                                                              \
+    {BLITTER_CODE}                                            \
+                                                              \
+    /* ==== recombine lo and hi pixels ==== */                \
+    pixels_dst = _mm512_packus_epi16(_shuff16_temp, shuff_dst);
+
+/* Interface definition
+ * Input variables: A_OFF, the byte offset of alpha in an unpacked pixel
+ * Output variables: `shuff_out_alpha` shuffle control mask.
+ *
+ * Takes a pixel in AVX512 registers like           [0][A][0][R][0][G][0][B]
+ * (or however RGBA are aligned) and turns it into  [0][A][0][A][0][A][0][A]
+ * */
+#define ADD_SHUFFLE_OUT_ALPHA_CONTROL_AVX512(A_OFF)                           \
+    __m512i shuff_out_alpha = _mm512_broadcast_i32x4(                         \
+        _mm_set_epi8(0x80, 8 + (A_OFF), 0x80, 8 + (A_OFF), 0x80, 8 + (A_OFF), \
+                     0x80, 8 + (A_OFF), 0x80, (A_OFF), 0x80, (A_OFF), 0x80,   \
+                     (A_OFF), 0x80, (A_OFF)));
+
+/* Divides each element in input mm512i by 255
+ * See: https://stackoverflow.com/a/35286833/13816541 */
+#define DO_AVX512_DIV255_U16(MM512I) \
+    _mm512_srli_epi16(               \
+        _mm512_mulhi_epu16(MM512I, _mm512_set1_epi16((short)0x8081)), 7);
+
+/* The alpha blitters below use the same math as their AVX2 counterparts, so
+ * see simd_blitters_avx2.c for a more thorough explanation of them */
+
+#if defined(__AVX512F__) && defined(__AVX512BW__) && \
+    defined(HAVE_IMMINTRIN_H) && !defined(SDL_DISABLE_IMMINTRIN_H)
+void
+alphablit_alpha_avx512_argb_no_surf_alpha_opaque_dst(SDL_BlitInfo *info)
+{
+    SETUP_AVX512_BLITTER
+    SETUP_16BIT_UNPACK_AVX512
+    ADD_SHUFFLE_OUT_ALPHA_CONTROL_AVX512(info->src->Ashift >> 2)
+
+    __m512i src_alpha, temp;
+
+    /* The location of the destination's missing alpha channel can be masked
+     * out by composing all the other channels' masks. */
+    __m512i mask_out_alpha = _mm512_set1_epi32(
+        (int)(info->dst->Rmask | info->dst->Gmask | info->dst->Bmask));
+
+    /*
+     dstRGB = (((dstRGB << 8) + (srcRGB - dstRGB) * srcA + srcRGB) >> 8)
+     */
+
+    RUN_AVX512_BLITTER(
+        RUN_16BIT_UNPACK_AVX512(
+            src_alpha = _mm512_shuffle_epi8(shuff_src, shuff_out_alpha);
+            temp = _mm512_sub_epi16(shuff_src, shuff_dst);
+            temp = _mm512_mullo_epi16(temp, src_alpha);
+            shuff_dst = _mm512_slli_epi16(shuff_dst, 8);
+            shuff_dst = _mm512_add_epi16(shuff_dst, temp);
+            shuff_dst = _mm512_add_epi16(shuff_dst, shuff_src);
+            shuff_dst = _mm512_srli_epi16(shuff_dst, 8););
+
+        pixels_dst = _mm512_and_si512(pixels_dst, mask_out_alpha);)
+}
+#else
+void
+alphablit_alpha_avx512_argb_no_surf_alpha_opaque_dst(SDL_BlitInfo *info)
+{
+    BAD_AVX512_FUNCTION_CALL;
+}
+#endif /* defined(__AVX512F__) && defined(__AVX512BW__) && \
+          defined(HAVE_IMMINTRIN_H) && !defined(SDL_DISABLE_IMMINTRIN_H) */
+
+#if defined(__AVX512F__) && defined(__AVX512BW__) && \
+    defined(HAVE_IMMINTRIN_H) && !defined(SDL_DISABLE_IMMINTRIN_H)
+void
+alphablit_alpha_avx512_argb_no_surf_alpha(SDL_BlitInfo *info)
+{
+    SETUP_AVX512_BLITTER
+    SETUP_16BIT_UNPACK_AVX512
+    ADD_SHUFFLE_OUT_ALPHA_CONTROL_AVX512(info->src->Ashift >> 2)
+
+    /* Selects the alpha word of every unpacked pixel, to merge the new
+     * destination alpha back in with the blended RGB values */
+    __mmask32 combine_rgba_mask = 0x11111111u << (info->src->Ashift >> 3);
+
+    __m512i src_alpha, temp, dst_alpha, new_dst_alpha;
+    const __m512i two_five_fives = _mm512_set1_epi16(255);
+
+    /*
+     dstRGB = (((dstRGB << 8) + (srcRGB - dstRGB) * srcA + srcRGB) >> 8)
+     dstA = srcA + dstA - ((srcA * dstA) / 255);
+     */
+
+    RUN_AVX512_BLITTER(RUN_16BIT_UNPACK_AVX512(
+        src_alpha = _mm512_shuffle_epi8(shuff_src, shuff_out_alpha);
+        dst_alpha = _mm512_shuffle_epi8(shuff_dst, shuff_out_alpha);
+
+        // figure out alpha
+        temp = _mm512_mullo_epi16(src_alpha, dst_alpha);
+        temp = DO_AVX512_DIV255_U16(temp);
+        new_dst_alpha = _mm512_sub_epi16(dst_alpha, temp);
+        new_dst_alpha = _mm512_add_epi16(src_alpha, new_dst_alpha);
+
+        // if preexisting dst alpha is 0, src alpha should be set to 255
+        // enforces that dest alpha 0 means "copy source RGB"
+        // happens after real src alpha values used to calculate dst alpha
+        src_alpha = _mm512_mask_mov_epi16(
+            src_alpha, _mm512_cmpeq_epi16_mask(dst_alpha, _zero512),
+            two_five_fives);
+
+        // figure out RGB
+        temp = _mm512_sub_epi16(shuff_src, shuff_dst);
+        temp = _mm512_mullo_epi16(temp, src_alpha);
+        temp = _mm512_add_epi16(temp, shuff_src);
+        shuff_dst = _mm512_slli_epi16(shuff_dst, 8);
+        shuff_dst = _mm512_add_epi16(shuff_dst, temp);
+        shuff_dst = _mm512_srli_epi16(shuff_dst, 8);
+
+        // blend together dstRGB and dstA
+        shuff_dst = _mm512_mask_blend_epi16(combine_rgba_mask, shuff_dst,
+                                            new_dst_alpha);))
+}
+#else
+void
+alphablit_alpha_avx512_argb_no_surf_alpha(SDL_BlitInfo *info)
+{
+    BAD_AVX512_FUNCTION_CALL;
+}
+#endif /* defined(__AVX512F__) && defined(__AVX512BW__) && \
+          defined(HAVE_IMMINTRIN_H) && !defined(SDL_DISABLE_IMMINTRIN_H) */
+
+#if defined(__AVX512F__) && defined(__AVX512BW__) && \
+    defined(HAVE_IMMINTRIN_H) && !defined(SDL_DISABLE_IMMINTRIN_H)
+void
+alphablit_alpha_avx512_argb_surf_alpha(SDL_BlitInfo *info)
+{
+    SETUP_AVX512_BLITTER
+    SETUP_16BIT_UNPACK_AVX512
+    ADD_SHUFFLE_OUT_ALPHA_CONTROL_AVX512(info->src->Ashift >> 2)
+
+    /* Selects the alpha word of every unpacked pixel, to merge the new
+     * destination alpha back in with the blended RGB values */
+    __mmask32 combine_rgba_mask = 0x11111111u << (info->src->Ashift >> 3);
+
+    __m512i src_alpha, temp, dst_alpha, new_dst_alpha;
+    const __m512i two_five_fives = _mm512_set1_epi16(255);
+
+    int dst_alpha_offset = (info->dst->Amask ? 0 : 255);
+
+    __m512i modulate_alpha = _mm512_set1_epi16(info->src_blanket_alpha);
+
+    /*
+     dstRGB = (((dstRGB << 8) + (srcRGB - dstRGB) * srcA + srcRGB) >> 8)
+     dstA = srcA + dstA - ((srcA * dstA) / 255);
+     */
+
+    RUN_AVX512_BLITTER(RUN_16BIT_UNPACK_AVX512(
+        src_alpha = _mm512_shuffle_epi8(shuff_src, shuff_out_alpha);
+
+        // src_alpha = src_alpha * module_alpha / 255
+        src_alpha = _mm512_mullo_epi16(src_alpha, modulate_alpha);
+        src_alpha = DO_AVX512_DIV255_U16(src_alpha);
+
+        dst_alpha = _mm512_shuffle_epi8(shuff_dst, shuff_out_alpha);
+        // if the destination is opaque, it takes the max of each alpha
+        // with 255 otherwise it takes with the max with 0. This is
+        // equivalent to if opaque: alpha = 255
+        dst_alpha =
+            _mm512_max_epi16(dst_alpha, _mm512_set1_epi16(dst_alpha_offset));
+
+        // figure out alpha
+        temp = _mm512_mullo_epi16(src_alpha, dst_alpha);
+        temp = DO_AVX512_DIV255_U16(temp);
+        new_dst_alpha = _mm512_sub_epi16(dst_alpha, temp);
+        new_dst_alpha = _mm512_add_epi16(src_alpha, new_dst_alpha);
+
+        // if preexisting dst alpha is 0, src alpha should be set to 255
+        // enforces that dest alpha 0 means "copy source RGB"
+        // happens after real src alpha values used to calculate dst alpha
+        src_alpha = _mm512_mask_mov_epi16(
+            src_alpha, _mm512_cmpeq_epi16_mask(dst_alpha, _zero512),
+            two_five_fives);
+
+        // figure out RGB
+        temp = _mm512_sub_epi16(shuff_src, shuff_dst);
+        temp = _mm512_mullo_epi16(temp, src_alpha);
+        temp = _mm512_add_epi16(temp, shuff_src);
+        shuff_dst = _mm512_slli_epi16(shuff_dst, 8);
+        shuff_dst = _mm512_add_epi16(shuff_dst, temp);
+        shuff_dst = _mm512_srli_epi16(shuff_dst, 8);
+
+        // blend together dstRGB and dstA
+        shuff_dst = _mm512_mask_blend_epi16(combine_rgba_mask, shuff_dst,
+                                            new_dst_alpha);))
+}
+#else
+void
+alphablit_alpha_avx512_argb_surf_alpha(SDL_BlitInfo *info)
+{
+    BAD_AVX512_FUNCTION_CALL;
+}
+#endif /* defined(__AVX512F__) && defined(__AVX512BW__) && \
+          defined(HAVE_IMMINTRIN_H) && !defined(SDL_DISABLE_IMMINTRIN_H) */
+
+#if defined(__AVX512F__) && defined(__AVX512BW__) && \
+    defined(HAVE_IMMINTRIN_H) && !defined(SDL_DISABLE_IMMINTRIN_H)
+void
+blit_blend_rgba_mul_avx512(SDL_BlitInfo *info)
+{
+    SETUP_AVX512_BLITTER
+    SETUP_16BIT_UNPACK_AVX512
+
+    const __m512i two_five_fives = _mm512_set1_epi16(255);
+
+    /* dstRGBA = ((dstRGBA * srcRGBA) + 255) >> 8 */
+
+    RUN_AVX512_BLITTER(RUN_16BIT_UNPACK_AVX512(
+        shuff_dst = _mm512_mullo_epi16(shuff_src, shuff_dst);
+        shuff_dst = _mm512_add_epi16(shuff_dst, two_five_fives);
+        shuff_dst = _mm512_srli_epi16(shuff_dst, 8);))
+}
+#else
+void
+blit_blend_rgba_mul_avx512(SDL_BlitInfo *info)
+{
+    BAD_AVX512_FUNCTION_CALL;
+}
+#endif /* defined(__AVX512F__) && defined(__AVX512BW__) && \
+          defined(HAVE_IMMINTRIN_H) && !defined(SDL_DISABLE_IMMINTRIN_H) */
+
+#if defined(__AVX512F__) && defined(__AVX512BW__) && \
+    defined(HAVE_IMMINTRIN_H) && !defined(SDL_DISABLE_IMMINTRIN_H)
+void
+blit_blend_rgba_add_avx512(SDL_BlitInfo *info)
+{
+    SETUP_AVX512_BLITTER
+
+    RUN_AVX512_BLITTER(pixels_dst = _mm512_adds_epu8(pixels_dst, pixels_src);)
+}
+#else
+void
+blit_blend_rgba_add_avx512(SDL_BlitInfo *info)
+{
+    BAD_AVX512_FUNCTION_CALL;
+}
+#endif /* defined(__AVX512F__) && defined(__AVX512BW__) && \
+          defined(HAVE_IMMINTRIN_H) && !defined(SDL_DISABLE_IMMINTRIN_H) */
+
+#if defined(__AVX512F__) && defined(__AVX512BW__) && \
+    defined(HAVE_IMMINTRIN_H) && !defined(SDL_DISABLE_IMMINTRIN_H)
+void
+blit_blend_rgba_sub_avx512(SDL_BlitInfo *info)
+{
+    SETUP_AVX512_BLITTER
+
+    RUN_AVX512_BLITTER(pixels_dst = _mm512_subs_epu8(pixels_dst, pixels_src);)
+}
+#else
+void
+blit_blend_rgba_sub_avx512(SDL_BlitInfo *info)
+{
+    BAD_AVX512_FUNCTION_CALL;
+}
+#endif /* defined(__AVX512F__) && defined(__AVX512BW__) && \
+          defined(HAVE_IMMINTRIN_H) && !defined(SDL_DISABLE_IMMINTRIN_H) */
+
+#if defined(__AVX512F__) && defined(__AVX512BW__) && \
+    defined(HAVE_IMMINTRIN_H) && !defined(SDL_DISABLE_IMMINTRIN_H)
+void
+blit_blend_rgba_max_avx512(SDL_BlitInfo *info)
+{
+    SETUP_AVX512_BLITTER
+
+    RUN_AVX512_BLITTER(pixels_dst = _mm512_max_epu8(pixels_dst, pixels_src);)
+}
+#else
+void
+blit_blend_rgba_max_avx512(SDL_BlitInfo *info)
+{
+    BAD_AVX512_FUNCTION_CALL;
+}
+#endif /* defined(__AVX512F__) && defined(__AVX512BW__) && \
+          defined(HAVE_IMMINTRIN_H) && !defined(SDL_DISABLE_IMMINTRIN_H) */
+
+#if defined(__AVX512F__) && defined(__AVX512BW__) && \
+    defined(HAVE_IMMINTRIN_H) && !defined(SDL_DISABLE_IMMINTRIN_H)
+void
+blit_blend_rgba_min_avx512(SDL_BlitInfo *info)
+{
+    SETUP_AVX512_BLITTER
+
+    RUN_AVX512_BLITTER(pixels_dst = _mm512_min_epu8(pixels_dst, pixels_src);)
+}
+#else
+void
+blit_blend_rgba_min_avx512(SDL_BlitInfo *info)
+{
+    BAD_AVX512_FUNCTION_CALL;
+}
+#endif /* defined(__AVX512F__) && defined(__AVX512BW__) && \
+          defined(HAVE_IMMINTRIN_H) && !defined(SDL_DISABLE_IMMINTRIN_H) */
+
+#if defined(__AVX512F__) && defined(__AVX512BW__) && \
+    defined(HAVE_IMMINTRIN_H) && !defined(SDL_DISABLE_IMMINTRIN_H)
+void
+blit_blend_premultiplied_avx512(SDL_BlitInfo *info)
+{
+    SETUP_AVX512_BLITTER
+    SETUP_16BIT_UNPACK_AVX512
+
+    /* if either surface has a non-zero alpha mask use that as our mask */
+    Uint32 amask = info->src->Amask | info->dst->Amask;
+    /* find the index 0, 1, 2 or 3 of the alpha channel within the pixel
+     * this can vary depending on the channel order in the pixel format.
+     * e.g. ARGB vs RGBA or BGRA
+     */
+    char a_index = ((amask >> 8) == 0)    ? 0
+                   : ((amask >> 16) == 0) ? 1
+                   : ((amask >> 24) == 0) ? 2
+                                          : 3;
+
+    ADD_SHUFFLE_OUT_ALPHA_CONTROL_AVX512(a_index * 2)
+
+    __m512i src_alpha, temp, orig_dst;
+    const __m512i ones = _mm512_set1_epi16(1);
+    const __m512i mm512_amask = _mm512_set1_epi32((int)amask);
+
+    /* The blend formula for a single color channel is:
+     * (sC + dC - ((dC + 1) * sA >> 8))
+     * see blit_blend_premultiplied_avx2 for how this is derived */
+
+    RUN_AVX512_BLITTER(
+        orig_dst = pixels_dst;
+
+        RUN_16BIT_UNPACK_AVX512(
+            src_alpha = _mm512_shuffle_epi8(shuff_src, shuff_out_alpha);
+            temp = _mm512_add_epi16(shuff_dst, ones);
+            temp = _mm512_mullo_epi16(temp, src_alpha);
+            temp = _mm512_srli_epi16(temp, 8);
+            shuff_dst = _mm512_add_epi16(shuff_src, shuff_dst);
+            shuff_dst = _mm512_sub_epi16(shuff_dst, temp);)
+
+        /* same shortcuts as the non simd blitter, fully transparent source
+         * pixels leave the destination alone and opaque ones are copied */
+        pixels_dst = _mm512_mask_mov_epi32(
+            orig_dst, _mm512_test_epi32_mask(pixels_src, mm512_amask),
+            pixels_dst);
+        pixels_dst = _mm512_mask_mov_epi32(
+            pixels_dst,
+            _mm512_cmpeq_epi32_mask(
+                _mm512_and_si512(pixels_src, mm512_amask), mm512_amask),
+            pixels_src);)
+}
+#else
+void
+blit_blend_premultiplied_avx512(SDL_BlitInfo *info)
+{
+    BAD_AVX512_FUNCTION_CALL;
+}
+#endif /* defined(__AVX512F__) && defined(__AVX512BW__) && \
+          defined(HAVE_IMMINTRIN_H) && !defined(SDL_DISABLE_IMMINTRIN_H) */
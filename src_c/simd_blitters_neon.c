@@ -0,0 +1,502 @@
+#include "simd_blitters.h"
+
+#if PG_ENABLE_NATIVE_NEON
+#include <arm_neon.h>
+#endif /* PG_ENABLE_NATIVE_NEON */
+
+#define BAD_NEON_FUNCTION_CALL                                              \
+    printf(                                                                 \
+        "Fatal Error: Attempted calling a NEON function when both compile " \
+        "time and runtime support is missing. If you are seeing this "      \
+        "message, you have stumbled across a pygame bug, please report it " \
+        "to the devs!");                                                    \
+    PG_EXIT(1)
+
+/* These are native versions of the SSE2 blitters, for arm64. The SSE2 code
+ * also compiles there through sse2neon, but that has to emulate a few SSE2
+ * instructions (byte shuffles, mulhi, packus) with several NEON ones, and
+ * the SSE2 alpha blitters only handle one pixel at a time. The kernels below
+ * work on four pixels per 128 bit register and produce exactly the same
+ * results as the SSE2 ones. */
+
+#if PG_ENABLE_NATIVE_NEON
+
+/* Setup for RUN_NEON_BLITTER */
+#define SETUP_NEON_BLITTER            \
+    int i;                            \
+    int width = info->width;          \
+    int height = info->height;        \
+                                      \
+    Uint8 *srcp = info->s_pixels;     \
+    Uint8 *dstp = info->d_pixels;     \
+                                      \
+    const int srcskip = info->s_skip; \
+    const int dstskip = info->d_skip; \
+    const int pxl_excess = width % 4; \
+    const int n_iters_4 = width / 4;  \
+                                      \
+    Uint8 _tail_src[16] = {0};        \
+    Uint8 _tail_dst[16] = {0};        \
+                                      \
+    uint8x16_t pixels_src, pixels_dst;
+
+/* Interface definition
+ * Definitions needed: MACRO(SETUP_NEON_BLITTER)
+ * Input variables: None
+ * Output variables: pixels_src, pixels_dst (containing raw pixel data)
+ *
+ * Operation: BLITTER_CODE takes pixels_src and pixels_dst and puts processed
+ * results into pixels_dst. The last 1-3 pixels of a row go through a small
+ * buffer, so nothing past the end of a row is ever read or written.
+ */
+#define RUN_NEON_BLITTER(BLITTER_CODE)               \
+    while (height--) {                               \
+        for (i = 0; i < n_iters_4; i++) {            \
+            pixels_src = vld1q_u8(srcp);             \
+            pixels_dst = vld1q_u8(dstp);             \
+                                                     \
+            {BLITTER_CODE}                           \
+                                                     \
+            vst1q_u8(dstp, pixels_dst);              \
+            srcp += 16;                              \
+            dstp += 16;                              \
+        }                                            \
+        if (pxl_excess) {                            \
+            memcpy(_tail_src, srcp, pxl_excess * 4); \
+            memcpy(_tail_dst, dstp, pxl_excess * 4); \
+            pixels_src = vld1q_u8(_tail_src);        \
+            pixels_dst = vld1q_u8(_tail_dst);        \
+                                                     \
+            {BLITTER_CODE}                           \
+                                                     \
+            vst1q_u8(_tail_dst, pixels_dst);         \
+            memcpy(dstp, _tail_dst, pxl_excess * 4); \
+            srcp += pxl_excess * 4;                  \
+            dstp += pxl_excess * 4;                  \
+        }                                            \
+        srcp += srcskip;                             \
+        dstp += dstskip;                             \
+    }
+
+/* Returns a table lookup control that copies the byte at a_index of each
+ * pixel over the whole pixel, e.g. [A][R][G][B] -> [A][A][A][A] */
+static inline uint8x16_t
+_pg_neon_alpha_shuffle(int a_index)
+{
+    Uint8 control[16];
+    int i;
+
+    for (i = 0; i < 16; i++) {
+        control[i] = (Uint8)((i & ~3) + a_index);
+    }
+    return vld1q_u8(control);
+}
+
+/* Returns a register with amask set in every pixel, to select channels with
+ * vbslq_u8 */
+static inline uint8x16_t
+_pg_neon_pixel_mask(Uint32 amask)
+{
+    return vreinterpretq_u8_u32(vdupq_n_u32(amask));
+}
+
+/* (a * b) / 255 for each byte, rounded down like the SSE2 version.
+ * x / 255 == (x + (x >> 8) + 1) >> 8 for all x <= 255 * 255 */
+static inline uint8x16_t
+_pg_neon_mul_div255(uint8x16_t a, uint8x16_t b)
+{
+    const uint16x8_t ones = vdupq_n_u16(1);
+    uint16x8_t lo = vmull_u8(vget_low_u8(a), vget_low_u8(b));
+    uint16x8_t hi = vmull_high_u8(a, b);
+
+    lo = vsraq_n_u16(lo, lo, 8);
+    hi = vsraq_n_u16(hi, hi, 8);
+    return vaddhn_high_u16(vaddhn_u16(lo, ones), hi, ones);
+}
+
+/* ((a * b) + 255) >> 8 for each byte */
+static inline uint8x16_t
+_pg_neon_mul_255(uint8x16_t a, uint8x16_t b)
+{
+    const uint16x8_t two_five_fives = vdupq_n_u16(255);
+    uint16x8_t lo = vmull_u8(vget_low_u8(a), vget_low_u8(b));
+    uint16x8_t hi = vmull_high_u8(a, b);
+
+    return vaddhn_high_u16(vaddhn_u16(lo, two_five_fives), hi,
+                           two_five_fives);
+}
+
+/* ((c + 1) * a) >> 8 for each byte */
+static inline uint8x16_t
+_pg_neon_premul(uint8x16_t c, uint8x16_t a)
+{
+    uint16x8_t lo = vmull_u8(vget_low_u8(c), vget_low_u8(a));
+    uint16x8_t hi = vmull_high_u8(c, a);
+
+    lo = vaddw_u8(lo, vget_low_u8(a));
+    hi = vaddw_high_u8(hi, a);
+    return vshrn_high_n_u16(vshrn_n_u16(lo, 8), hi, 8);
+}
+
+/* dstRGB = (((dstRGB << 8) + (srcRGB - dstRGB) * srcA + srcRGB) >> 8)
+ * The intermediate result always fits in 16 bits, so it can be built up
+ * with widening multiply-accumulates without caring about the sign of
+ * (srcRGB - dstRGB). */
+static inline uint8x16_t
+_pg_neon_blend_alpha(uint8x16_t src, uint8x16_t dst, uint8x16_t alpha)
+{
+    uint16x8_t lo = vshll_n_u8(vget_low_u8(dst), 8);
+    uint16x8_t hi = vshll_high_n_u8(dst, 8);
+
+    lo = vmlal_u8(lo, vget_low_u8(src), vget_low_u8(alpha));
+    hi = vmlal_high_u8(hi, src, alpha);
+    lo = vmlsl_u8(lo, vget_low_u8(dst), vget_low_u8(alpha));
+    hi = vmlsl_high_u8(hi, dst, alpha);
+    lo = vaddw_u8(lo, vget_low_u8(src));
+    hi = vaddw_high_u8(hi, src);
+    return vshrn_high_n_u16(vshrn_n_u16(lo, 8), hi, 8);
+}
+
+void
+alphablit_alpha_neon_argb_no_surf_alpha_opaque_dst(SDL_BlitInfo *info)
+{
+    SETUP_NEON_BLITTER
+
+    const uint8x16_t shuff_out_alpha =
+        _pg_neon_alpha_shuffle(info->src->Ashift >> 3);
+    /* The location of the destination's missing alpha channel can be masked
+     * out by composing all the other channels' masks. */
+    const uint8x16_t mask_out_alpha = _pg_neon_pixel_mask(
+        info->dst->Rmask | info->dst->Gmask | info->dst->Bmask);
+
+    uint8x16_t src_alpha;
+
+    RUN_NEON_BLITTER({
+        src_alpha = vqtbl1q_u8(pixels_src, shuff_out_alpha);
+        pixels_dst = _pg_neon_blend_alpha(pixels_src, pixels_dst, src_alpha);
+        pixels_dst = vandq_u8(pixels_dst, mask_out_alpha);
+    })
+}
+
+void
+alphablit_alpha_neon_argb_no_surf_alpha(SDL_BlitInfo *info)
+{
+    SETUP_NEON_BLITTER
+
+    const uint8x16_t shuff_out_alpha =
+        _pg_neon_alpha_shuffle(info->src->Ashift >> 3);
+    const uint8x16_t alpha_mask = _pg_neon_pixel_mask(info->src->Amask);
+
+    uint8x16_t src_alpha, dst_alpha, new_dst_alpha;
+
+    /*
+     dstRGB = (((dstRGB << 8) + (srcRGB - dstRGB) * srcA + srcRGB) >> 8)
+     dstA = srcA + dstA - ((srcA * dstA) / 255);
+     */
+
+    RUN_NEON_BLITTER({
+        src_alpha = vqtbl1q_u8(pixels_src, shuff_out_alpha);
+        dst_alpha = vqtbl1q_u8(pixels_dst, shuff_out_alpha);
+
+        // figure out alpha, this never goes over 255
+        new_dst_alpha = vsubq_u8(vaddq_u8(src_alpha, dst_alpha),
+                                 _pg_neon_mul_div255(src_alpha, dst_alpha));
+
+        // if preexisting dst alpha is 0, src alpha should be set to 255
+        // enforces that dest alpha 0 means "copy source RGB"
+        src_alpha = vorrq_u8(src_alpha, vceqzq_u8(dst_alpha));
+
+        pixels_dst = _pg_neon_blend_alpha(pixels_src, pixels_dst, src_alpha);
+        pixels_dst = vbslq_u8(alpha_mask, new_dst_alpha, pixels_dst);
+    })
+}
+
+void
+alphablit_alpha_neon_argb_surf_alpha(SDL_BlitInfo *info)
+{
+    SETUP_NEON_BLITTER
+
+    const uint8x16_t shuff_out_alpha =
+        _pg_neon_alpha_shuffle(info->src->Ashift >> 3);
+    const uint8x16_t alpha_mask = _pg_neon_pixel_mask(info->src->Amask);
+    const uint8x16_t modulate_alpha = vdupq_n_u8(info->src_blanket_alpha);
+    /* destinations without per pixel alpha count as opaque */
+    const uint8x16_t dst_alpha_offset =
+        vdupq_n_u8(info->dst->Amask ? 0 : 255);
+
+    uint8x16_t src_alpha, dst_alpha, new_dst_alpha;
+
+    RUN_NEON_BLITTER({
+        src_alpha = vqtbl1q_u8(pixels_src, shuff_out_alpha);
+        src_alpha = _pg_neon_mul_div255(src_alpha, modulate_alpha);
+        dst_alpha = vqtbl1q_u8(pixels_dst, shuff_out_alpha);
+        dst_alpha = vmaxq_u8(dst_alpha, dst_alpha_offset);
+
+        new_dst_alpha = vsubq_u8(vaddq_u8(src_alpha, dst_alpha),
+                                 _pg_neon_mul_div255(src_alpha, dst_alpha));
+
+        src_alpha = vorrq_u8(src_alpha, vceqzq_u8(dst_alpha));
+
+        pixels_dst = _pg_neon_blend_alpha(pixels_src, pixels_dst, src_alpha);
+        pixels_dst = vbslq_u8(alpha_mask, new_dst_alpha, pixels_dst);
+    })
+}
+
+void
+blit_blend_premultiplied_neon(SDL_BlitInfo *info)
+{
+    SETUP_NEON_BLITTER
+
+    /* if either surface has a non-zero alpha mask use that as our mask */
+    Uint32 amask = info->src->Amask | info->dst->Amask;
+    int a_index = ((amask >> 8) == 0)    ? 0
+                  : ((amask >> 16) == 0) ? 1
+                  : ((amask >> 24) == 0) ? 2
+                                         : 3;
+    const uint8x16_t shuff_out_alpha = _pg_neon_alpha_shuffle(a_index);
+
+    uint8x16_t src_alpha, blended;
+    uint16x8_t lo, hi;
+
+    /* (sC + dC - ((dC + 1) * sA >> 8)), which gives back sC when sA is 255.
+     * Fully transparent source pixels leave the destination alone. */
+    RUN_NEON_BLITTER({
+        src_alpha = vqtbl1q_u8(pixels_src, shuff_out_alpha);
+        blended = _pg_neon_premul(pixels_dst, src_alpha);
+        lo = vaddl_u8(vget_low_u8(pixels_src), vget_low_u8(pixels_dst));
+        hi = vaddl_high_u8(pixels_src, pixels_dst);
+        lo = vsubw_u8(lo, vget_low_u8(blended));
+        hi = vsubw_high_u8(hi, blended);
+        blended = vqmovn_high_u16(vqmovn_u16(lo), hi);
+        pixels_dst = vbslq_u8(vceqzq_u8(src_alpha), pixels_dst, blended);
+    })
+}
+
+void
+premul_surf_color_by_alpha_neon(SDL_Surface *src, PG_PixelFormat *srcfmt,
+                                SDL_Surface *dst)
+{
+    int i;
+    int width = src->w;
+    int height = src->h;
+    Uint8 *srcp = (Uint8 *)src->pixels;
+    Uint8 *dstp = (Uint8 *)dst->pixels;
+    const int srcskip = src->pitch - width * 4;
+    const int dstskip = dst->pitch - width * 4;
+    const int pxl_excess = width % 4;
+    const int n_iters_4 = width / 4;
+
+    Uint8 _tail_src[16] = {0};
+    Uint8 _tail_dst[16] = {0};
+
+    uint8x16_t pixels_src, pixels_dst;
+
+    const uint8x16_t shuff_out_alpha =
+        _pg_neon_alpha_shuffle(srcfmt->Ashift >> 3);
+    /* without an alpha channel every pixel is copied as is */
+    const uint8x16_t keep_mask =
+        _pg_neon_pixel_mask(srcfmt->Amask ? srcfmt->Amask : 0xFFFFFFFF);
+
+    /* ((C + 1) * A) >> 8 leaves C untouched when A is 255, so opaque pixels
+     * don't need to be special cased */
+    RUN_NEON_BLITTER({
+        pixels_dst = _pg_neon_premul(
+            pixels_src, vqtbl1q_u8(pixels_src, shuff_out_alpha));
+        pixels_dst = vbslq_u8(keep_mask, pixels_src, pixels_dst);
+    })
+}
+
+void
+blit_blend_rgba_mul_neon(SDL_BlitInfo *info)
+{
+    SETUP_NEON_BLITTER
+    RUN_NEON_BLITTER(
+        { pixels_dst = _pg_neon_mul_255(pixels_dst, pixels_src); })
+}
+
+void
+blit_blend_rgb_mul_neon(SDL_BlitInfo *info)
+{
+    SETUP_NEON_BLITTER
+    const uint8x16_t amask =
+        _pg_neon_pixel_mask(info->src->Amask | info->dst->Amask);
+
+    RUN_NEON_BLITTER({
+        pixels_src = vorrq_u8(pixels_src, amask);
+        pixels_dst = _pg_neon_mul_255(pixels_dst, pixels_src);
+    })
+}
+
+void
+blit_blend_rgba_add_neon(SDL_BlitInfo *info)
+{
+    SETUP_NEON_BLITTER
+    RUN_NEON_BLITTER({ pixels_dst = vqaddq_u8(pixels_dst, pixels_src); })
+}
+
+void
+blit_blend_rgb_add_neon(SDL_BlitInfo *info)
+{
+    SETUP_NEON_BLITTER
+    const uint8x16_t amask =
+        _pg_neon_pixel_mask(info->src->Amask | info->dst->Amask);
+
+    RUN_NEON_BLITTER({
+        pixels_src = vbicq_u8(pixels_src, amask);
+        pixels_dst = vqaddq_u8(pixels_dst, pixels_src);
+    })
+}
+
+void
+blit_blend_rgba_sub_neon(SDL_BlitInfo *info)
+{
+    SETUP_NEON_BLITTER
+    RUN_NEON_BLITTER({ pixels_dst = vqsubq_u8(pixels_dst, pixels_src); })
+}
+
+void
+blit_blend_rgb_sub_neon(SDL_BlitInfo *info)
+{
+    SETUP_NEON_BLITTER
+    const uint8x16_t amask =
+        _pg_neon_pixel_mask(info->src->Amask | info->dst->Amask);
+
+    RUN_NEON_BLITTER({
+        pixels_src = vbicq_u8(pixels_src, amask);
+        pixels_dst = vqsubq_u8(pixels_dst, pixels_src);
+    })
+}
+
+void
+blit_blend_rgba_max_neon(SDL_BlitInfo *info)
+{
+    SETUP_NEON_BLITTER
+    RUN_NEON_BLITTER({ pixels_dst = vmaxq_u8(pixels_dst, pixels_src); })
+}
+
+void
+blit_blend_rgb_max_neon(SDL_BlitInfo *info)
+{
+    SETUP_NEON_BLITTER
+    const uint8x16_t amask =
+        _pg_neon_pixel_mask(info->src->Amask | info->dst->Amask);
+
+    RUN_NEON_BLITTER({
+        pixels_src = vbicq_u8(pixels_src, amask);
+        pixels_dst = vmaxq_u8(pixels_dst, pixels_src);
+    })
+}
+
+void
+blit_blend_rgba_min_neon(SDL_BlitInfo *info)
+{
+    SETUP_NEON_BLITTER
+    RUN_NEON_BLITTER({ pixels_dst = vminq_u8(pixels_dst, pixels_src); })
+}
+
+void
+blit_blend_rgb_min_neon(SDL_BlitInfo *info)
+{
+    SETUP_NEON_BLITTER
+    const uint8x16_t amask =
+        _pg_neon_pixel_mask(info->src->Amask | info->dst->Amask);
+
+    RUN_NEON_BLITTER({
+        pixels_src = vorrq_u8(pixels_src, amask);
+        pixels_dst = vminq_u8(pixels_dst, pixels_src);
+    })
+}
+
+#else
+
+void
+alphablit_alpha_neon_argb_no_surf_alpha_opaque_dst(SDL_BlitInfo *info)
+{
+    BAD_NEON_FUNCTION_CALL;
+}
+
+void
+alphablit_alpha_neon_argb_no_surf_alpha(SDL_BlitInfo *info)
+{
+    BAD_NEON_FUNCTION_CALL;
+}
+
+void
+alphablit_alpha_neon_argb_surf_alpha(SDL_BlitInfo *info)
+{
+    BAD_NEON_FUNCTION_CALL;
+}
+
+void
+blit_blend_premultiplied_neon(SDL_BlitInfo *info)
+{
+    BAD_NEON_FUNCTION_CALL;
+}
+
+void
+premul_surf_color_by_alpha_neon(SDL_Surface *src, PG_PixelFormat *srcfmt,
+                                SDL_Surface *dst)
+{
+    BAD_NEON_FUNCTION_CALL;
+}
+
+void
+blit_blend_rgba_mul_neon(SDL_BlitInfo *info)
+{
+    BAD_NEON_FUNCTION_CALL;
+}
+
+void
+blit_blend_rgb_mul_neon(SDL_BlitInfo *info)
+{
+    BAD_NEON_FUNCTION_CALL;
+}
+
+void
+blit_blend_rgba_add_neon(SDL_BlitInfo *info)
+{
+    BAD_NEON_FUNCTION_CALL;
+}
+
+void
+blit_blend_rgb_add_neon(SDL_BlitInfo *info)
+{
+    BAD_NEON_FUNCTION_CALL;
+}
+
+void
+blit_blend_rgba_sub_neon(SDL_BlitInfo *info)
+{
+    BAD_NEON_FUNCTION_CALL;
+}
+
+void
+blit_blend_rgb_sub_neon(SDL_BlitInfo *info)
+{
+    BAD_NEON_FUNCTION_CALL;
+}
+
+void
+blit_blend_rgba_max_neon(SDL_BlitInfo *info)
+{
+    BAD_NEON_FUNCTION_CALL;
+}
+
+void
+blit_blend_rgb_max_neon(SDL_BlitInfo *info)
+{
+    BAD_NEON_FUNCTION_CALL;
+}
+
+void
+blit_blend_rgba_min_neon(SDL_BlitInfo *info)
+{
+    BAD_NEON_FUNCTION_CALL;
+}
+
+void
+blit_blend_rgb_min_neon(SDL_BlitInfo *info)
+{
+    BAD_NEON_FUNCTION_CALL;
+}
+#endif /* PG_ENABLE_NATIVE_NEON */
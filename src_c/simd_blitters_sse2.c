@@ -963,3 +963,64 @@ blit_blend_rgba_max_sse2(SDL_BlitInfo *info)
     RUN_SSE2_BLITTER({ mm128_dst = _mm_max_epu8(mm128_dst, mm128_src); })
 }
 #endif /* __SSE2__ || PG_ENABLE_ARM_NEON*/
+
+#if defined(__SSE2__) || defined(PG_ENABLE_ARM_NEON)
+/* Converts the pixels of src to the format of dst, both 32 bit with 8 bit
+ * channels. Byte i of a dst pixel is byte shuffle[i] of the src pixel, or
+ * 0xFF where shuffle[i] is -1. Without a byte shuffle in SSE2, each byte is
+ * moved in place with shifts, four pixels at a time. */
+void
+convert_surf_pixels_sse2(SDL_Surface *src, SDL_Surface *dst,
+                         const int *shuffle)
+{
+    const int width = src->w;
+    int x, y, i;
+    Uint32 fill = 0, pixel, out;
+    Uint32 *srcp, *dstp;
+    __m128i mm_src, mm_dst, mm_byte;
+    __m128i mm_src_shift[4], mm_dst_shift[4];
+    const __m128i mm_ff = _mm_set1_epi32(0xFF);
+
+    for (i = 0; i < 4; i++) {
+        if (shuffle[i] < 0) {
+            fill |= 0xFFu << (8 * i);
+        }
+        else {
+            mm_src_shift[i] = _mm_cvtsi32_si128(8 * shuffle[i]);
+            mm_dst_shift[i] = _mm_cvtsi32_si128(8 * i);
+        }
+    }
+    const __m128i mm_fill = _mm_set1_epi32(fill);
+
+    for (y = 0; y < src->h; y++) {
+        srcp = (Uint32 *)((Uint8 *)src->pixels + (size_t)y * src->pitch);
+        dstp = (Uint32 *)((Uint8 *)dst->pixels + (size_t)y * dst->pitch);
+
+        for (x = 0; x + 4 <= width; x += 4) {
+            mm_src = _mm_loadu_si128((__m128i *)(srcp + x));
+            mm_dst = mm_fill;
+            for (i = 0; i < 4; i++) {
+                if (shuffle[i] < 0) {
+                    continue;
+                }
+                mm_byte = _mm_and_si128(_mm_srl_epi32(mm_src, mm_src_shift[i]),
+                                        mm_ff);
+                mm_dst = _mm_or_si128(mm_dst,
+                                      _mm_sll_epi32(mm_byte, mm_dst_shift[i]));
+            }
+            _mm_storeu_si128((__m128i *)(dstp + x), mm_dst);
+        }
+
+        for (; x < width; x++) {
+            pixel = srcp[x];
+            out = fill;
+            for (i = 0; i < 4; i++) {
+                if (shuffle[i] >= 0) {
+                    out |= ((pixel >> (8 * shuffle[i])) & 0xFF) << (8 * i);
+                }
+            }
+            dstp[x] = out;
+        }
+    }
+}
+#endif /* __SSE2__ || PG_ENABLE_ARM_NEON*/
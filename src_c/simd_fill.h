@@ -121,3 +121,53 @@ int
 surface_fill_blend_rgba_max_sse2(SDL_Surface *surface,
                                  PG_PixelFormat *surface_format,
                                  SDL_Rect *rect, Uint32 color);
+
+/* Index in the lookup table of a gradient for the position f, given in
+ * table units. The row kernels round the same way, so that all of them draw
+ * the same pixels. */
+static PG_INLINE int
+gradient_lut_index(float f)
+{
+    if (!(f > 0.0f)) {
+        return 0;
+    }
+    if (f > (float)(PG_GRADIENT_LUT_SIZE - 1)) {
+        f = (float)(PG_GRADIENT_LUT_SIZE - 1);
+    }
+    return (int)(f + 0.5f);
+}
+
+// AVX2 gradient functions
+void
+gradient_row_linear_avx2(Uint32 *row, int width, const Uint32 *lut, float t,
+                         float dt);
+void
+gradient_row_radial_avx2(Uint32 *row, int width, const Uint32 *lut, float u,
+                         float du, float vv);
+void
+gradient_blend_row_add_avx2(Uint32 *dst, const Uint32 *src, int width);
+void
+gradient_blend_row_sub_avx2(Uint32 *dst, const Uint32 *src, int width);
+void
+gradient_blend_row_mult_avx2(Uint32 *dst, const Uint32 *src, int width);
+void
+gradient_blend_row_min_avx2(Uint32 *dst, const Uint32 *src, int width);
+void
+gradient_blend_row_max_avx2(Uint32 *dst, const Uint32 *src, int width);
+// SSE2 gradient functions
+void
+gradient_row_linear_sse2(Uint32 *row, int width, const Uint32 *lut, float t,
+                         float dt);
+void
+gradient_row_radial_sse2(Uint32 *row, int width, const Uint32 *lut, float u,
+                         float du, float vv);
+void
+gradient_blend_row_add_sse2(Uint32 *dst, const Uint32 *src, int width);
+void
+gradient_blend_row_sub_sse2(Uint32 *dst, const Uint32 *src, int width);
+void
+gradient_blend_row_mult_sse2(Uint32 *dst, const Uint32 *src, int width);
+void
+gradient_blend_row_min_sse2(Uint32 *dst, const Uint32 *src, int width);
+void
+gradient_blend_row_max_sse2(Uint32 *dst, const Uint32 *src, int width);
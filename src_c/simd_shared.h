@@ -12,6 +12,8 @@ int
 pg_avx2_at_runtime_but_uncompiled();
 int
 pg_has_avx2();
+int
+pg_has_avx512();
 
 #if !defined(PG_ENABLE_ARM_NEON) && defined(__aarch64__)
 // arm64 has neon optimisations enabled by default, even when fpu=neon is not
@@ -185,3 +185,151 @@ INVALID_DEFS(max)
 INVALID_DEFS(mult)
 #endif /* defined(__AVX2__) && defined(HAVE_IMMINTRIN_H) && \
  !defined(SDL_DISABLE_IMMINTRIN_H) */
+
+/* Gradient row kernels. The positions of eight pixels are computed at once
+ * and gathered from the color table of the gradient */
+#define GRADIENT_ROW_AVX2(POSITION_CODE, TAIL_CODE)                       \
+    int i;                                                                \
+    __m256 mm256_f;                                                       \
+    __m256i mm256_idx;                                                    \
+    __m256 mm256_x =                                                      \
+        _mm256_set_ps(7.0f, 6.0f, 5.0f, 4.0f, 3.0f, 2.0f, 1.0f, 0.0f);    \
+    __m256 mm256_eight = _mm256_set1_ps(8.0f);                            \
+    __m256 mm256_zero = _mm256_setzero_ps();                              \
+    __m256 mm256_half = _mm256_set1_ps(0.5f);                             \
+    __m256 mm256_max = _mm256_set1_ps((float)(PG_GRADIENT_LUT_SIZE - 1)); \
+                                                                          \
+    for (i = 0; i + 8 <= width; i += 8) {                                 \
+        {POSITION_CODE}                                                   \
+        mm256_f = _mm256_min_ps(_mm256_max_ps(mm256_f, mm256_zero),       \
+                                mm256_max);                               \
+        mm256_idx =                                                       \
+            _mm256_cvttps_epi32(_mm256_add_ps(mm256_f, mm256_half));      \
+        _mm256_storeu_si256(                                              \
+            (__m256i *)(row + i),                                         \
+            _mm256_i32gather_epi32((const int *)lut, mm256_idx, 4));      \
+        mm256_x = _mm256_add_ps(mm256_x, mm256_eight);                    \
+    }                                                                     \
+    for (; i < width; i++) {                                              \
+        TAIL_CODE                                                         \
+    }
+
+/* Blends a row of colors into a row of pixels, eight pixels at a time */
+#define GRADIENT_BLENDER_AVX2(NAME, BLEND_CODE)                               \
+    void gradient_blend_row_##NAME##_avx2(Uint32 *dst, const Uint32 *src,     \
+                                          int width)                          \
+    {                                                                         \
+        int i;                                                                \
+        int pxl_excess = width % 8;                                           \
+        __m256i mm256_dst, mm256_color;                                       \
+        __m256i shuff_dst, shuff_src, _shuff16_temp;                          \
+        __m256i mm256_zero = _mm256_setzero_si256();                          \
+        __m256i mask = _mm256_set_epi32(                                      \
+            0, pxl_excess > 6 ? -1 : 0, pxl_excess > 5 ? -1 : 0,              \
+            pxl_excess > 4 ? -1 : 0, pxl_excess > 3 ? -1 : 0,                 \
+            pxl_excess > 2 ? -1 : 0, pxl_excess > 1 ? -1 : 0,                 \
+            pxl_excess > 0 ? -1 : 0);                                         \
+                                                                              \
+        for (i = 0; i + 8 <= width; i += 8) {                                 \
+            mm256_dst = _mm256_loadu_si256((__m256i *)(dst + i));             \
+            mm256_color = _mm256_loadu_si256((__m256i *)(src + i));           \
+                                                                              \
+            {BLEND_CODE}                                                      \
+                                                                              \
+            _mm256_storeu_si256((__m256i *)(dst + i), mm256_dst);             \
+        }                                                                     \
+        if (pxl_excess) {                                                     \
+            mm256_dst = _mm256_maskload_epi32((int *)(dst + i), mask);        \
+            mm256_color = _mm256_maskload_epi32((int *)(src + i), mask);      \
+                                                                              \
+            {BLEND_CODE}                                                      \
+                                                                              \
+            _mm256_maskstore_epi32((int *)(dst + i), mask, mm256_dst);        \
+        }                                                                     \
+        (void)shuff_dst;                                                      \
+        (void)shuff_src;                                                      \
+        (void)_shuff16_temp;                                                  \
+        (void)mm256_zero;                                                     \
+    }
+
+#define INVALID_GRADIENT_BLENDER_AVX2(NAME)                               \
+    void gradient_blend_row_##NAME##_avx2(Uint32 *dst, const Uint32 *src, \
+                                          int width)                      \
+    {                                                                     \
+        BAD_AVX2_FUNCTION_CALL;                                           \
+    }
+
+/* Multiplies the pixels and colors as 16 bit values like 0A0R0G0B */
+#define GRADIENT_MULT_CODE                                               \
+    shuff_dst = _mm256_unpacklo_epi8(mm256_dst, mm256_zero);             \
+    shuff_src = _mm256_unpacklo_epi8(mm256_color, mm256_zero);           \
+    shuff_dst = _mm256_mullo_epi16(shuff_dst, shuff_src);                \
+    shuff_dst = _mm256_adds_epu16(shuff_dst, _mm256_set1_epi16(255));    \
+    _shuff16_temp = _mm256_srli_epi16(shuff_dst, 8);                     \
+                                                                         \
+    shuff_dst = _mm256_unpackhi_epi8(mm256_dst, mm256_zero);             \
+    shuff_src = _mm256_unpackhi_epi8(mm256_color, mm256_zero);           \
+    shuff_dst = _mm256_mullo_epi16(shuff_dst, shuff_src);                \
+    shuff_dst = _mm256_adds_epu16(shuff_dst, _mm256_set1_epi16(255));    \
+    shuff_dst = _mm256_srli_epi16(shuff_dst, 8);                         \
+                                                                         \
+    mm256_dst = _mm256_packus_epi16(_shuff16_temp, shuff_dst);
+
+#if defined(__AVX2__) && defined(HAVE_IMMINTRIN_H) && \
+    !defined(SDL_DISABLE_IMMINTRIN_H)
+void
+gradient_row_linear_avx2(Uint32 *row, int width, const Uint32 *lut, float t,
+                         float dt)
+{
+    __m256 mm256_t = _mm256_set1_ps(t);
+    __m256 mm256_dt = _mm256_set1_ps(dt);
+
+    GRADIENT_ROW_AVX2(
+        mm256_f = _mm256_add_ps(mm256_t, _mm256_mul_ps(mm256_x, mm256_dt));
+        , row[i] = lut[gradient_lut_index(t + (float)i * dt)];)
+}
+
+void
+gradient_row_radial_avx2(Uint32 *row, int width, const Uint32 *lut, float u,
+                         float du, float vv)
+{
+    __m256 mm256_u = _mm256_set1_ps(u);
+    __m256 mm256_du = _mm256_set1_ps(du);
+    __m256 mm256_vv = _mm256_set1_ps(vv);
+    float x;
+
+    GRADIENT_ROW_AVX2(
+        mm256_f = _mm256_add_ps(mm256_u, _mm256_mul_ps(mm256_x, mm256_du));
+        mm256_f = _mm256_sqrt_ps(
+            _mm256_add_ps(_mm256_mul_ps(mm256_f, mm256_f), mm256_vv));
+        , x = u + (float)i * du;
+        row[i] = lut[gradient_lut_index(sqrtf(x * x + vv))];)
+}
+
+GRADIENT_BLENDER_AVX2(add, ADD_CODE)
+GRADIENT_BLENDER_AVX2(sub, SUB_CODE)
+GRADIENT_BLENDER_AVX2(mult, GRADIENT_MULT_CODE)
+GRADIENT_BLENDER_AVX2(min, MIN_CODE)
+GRADIENT_BLENDER_AVX2(max, MAX_CODE)
+#else
+void
+gradient_row_linear_avx2(Uint32 *row, int width, const Uint32 *lut, float t,
+                         float dt)
+{
+    BAD_AVX2_FUNCTION_CALL;
+}
+
+void
+gradient_row_radial_avx2(Uint32 *row, int width, const Uint32 *lut, float u,
+                         float du, float vv)
+{
+    BAD_AVX2_FUNCTION_CALL;
+}
+
+INVALID_GRADIENT_BLENDER_AVX2(add)
+INVALID_GRADIENT_BLENDER_AVX2(sub)
+INVALID_GRADIENT_BLENDER_AVX2(mult)
+INVALID_GRADIENT_BLENDER_AVX2(min)
+INVALID_GRADIENT_BLENDER_AVX2(max)
+#endif /* defined(__AVX2__) && defined(HAVE_IMMINTRIN_H) && \
+ !defined(SDL_DISABLE_IMMINTRIN_H) */
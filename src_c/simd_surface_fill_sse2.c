@@ -174,3 +174,140 @@ INVALID_DEFS(min)
 INVALID_DEFS(max)
 INVALID_DEFS(mult)
 #endif /* defined(__SSE2__) || defined(PG_ENABLE_ARM_NEON) */
+
+/* Gradient row kernels. The positions of four pixels are computed at once
+ * and looked up in the color table of the gradient */
+#define GRADIENT_ROW_SSE2(POSITION_CODE, TAIL_CODE)                    \
+    int i, j;                                                          \
+    int idx[4];                                                        \
+    __m128 mm_f;                                                       \
+    __m128 mm_x = _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f);                  \
+    __m128 mm_four = _mm_set1_ps(4.0f);                                \
+    __m128 mm_zero = _mm_setzero_ps();                                 \
+    __m128 mm_half = _mm_set1_ps(0.5f);                                \
+    __m128 mm_max = _mm_set1_ps((float)(PG_GRADIENT_LUT_SIZE - 1));    \
+                                                                       \
+    for (i = 0; i + 4 <= width; i += 4) {                              \
+        {POSITION_CODE}                                                \
+        mm_f = _mm_min_ps(_mm_max_ps(mm_f, mm_zero), mm_max);          \
+        _mm_storeu_si128((__m128i *)idx,                               \
+                         _mm_cvttps_epi32(_mm_add_ps(mm_f, mm_half))); \
+        for (j = 0; j < 4; j++) {                                      \
+            row[i + j] = lut[idx[j]];                                  \
+        }                                                              \
+        mm_x = _mm_add_ps(mm_x, mm_four);                              \
+    }                                                                  \
+    for (; i < width; i++) {                                           \
+        TAIL_CODE                                                      \
+    }
+
+/* Blends a row of colors into a row of pixels, four pixels at a time. The
+ * excess pixels go through the same code one at a time */
+#define GRADIENT_BLENDER_SSE2(NAME, BLEND_CODE)                           \
+    void gradient_blend_row_##NAME##_sse2(Uint32 *dst, const Uint32 *src, \
+                                          int width)                      \
+    {                                                                     \
+        int i;                                                            \
+        __m128i mm128_dst, mm128_color;                                   \
+        __m128i shuff_dst, shuff_src, _shuff16_temp;                      \
+        __m128i mm128_zero = _mm_setzero_si128();                         \
+                                                                          \
+        for (i = 0; i + 4 <= width; i += 4) {                             \
+            mm128_dst = _mm_loadu_si128((__m128i *)(dst + i));            \
+            mm128_color = _mm_loadu_si128((__m128i *)(src + i));          \
+                                                                          \
+            {BLEND_CODE}                                                  \
+                                                                          \
+            _mm_storeu_si128((__m128i *)(dst + i), mm128_dst);            \
+        }                                                                 \
+        for (; i < width; i++) {                                          \
+            mm128_dst = _mm_cvtsi32_si128(dst[i]);                        \
+            mm128_color = _mm_cvtsi32_si128(src[i]);                      \
+                                                                          \
+            {BLEND_CODE}                                                  \
+                                                                          \
+            dst[i] = _mm_cvtsi128_si32(mm128_dst);                        \
+        }                                                                 \
+        (void)shuff_dst;                                                  \
+        (void)shuff_src;                                                  \
+        (void)_shuff16_temp;                                              \
+        (void)mm128_zero;                                                 \
+    }
+
+#define INVALID_GRADIENT_BLENDER_SSE2(NAME)                               \
+    void gradient_blend_row_##NAME##_sse2(Uint32 *dst, const Uint32 *src, \
+                                          int width)                      \
+    {                                                                     \
+        BAD_SSE2_FUNCTION_CALL;                                           \
+    }
+
+/* Multiplies the pixels and colors as 16 bit values like 0A0R0G0B */
+#define GRADIENT_MULT_CODE                                          \
+    shuff_dst = _mm_unpacklo_epi8(mm128_dst, mm128_zero);           \
+    shuff_src = _mm_unpacklo_epi8(mm128_color, mm128_zero);         \
+    shuff_dst = _mm_mullo_epi16(shuff_dst, shuff_src);              \
+    shuff_dst = _mm_adds_epu16(shuff_dst, _mm_set1_epi16(255));     \
+    _shuff16_temp = _mm_srli_epi16(shuff_dst, 8);                   \
+                                                                    \
+    shuff_dst = _mm_unpackhi_epi8(mm128_dst, mm128_zero);           \
+    shuff_src = _mm_unpackhi_epi8(mm128_color, mm128_zero);         \
+    shuff_dst = _mm_mullo_epi16(shuff_dst, shuff_src);              \
+    shuff_dst = _mm_adds_epu16(shuff_dst, _mm_set1_epi16(255));     \
+    shuff_dst = _mm_srli_epi16(shuff_dst, 8);                       \
+                                                                    \
+    mm128_dst = _mm_packus_epi16(_shuff16_temp, shuff_dst);
+
+#if defined(__SSE2__) || defined(PG_ENABLE_ARM_NEON)
+void
+gradient_row_linear_sse2(Uint32 *row, int width, const Uint32 *lut, float t,
+                         float dt)
+{
+    __m128 mm_t = _mm_set1_ps(t);
+    __m128 mm_dt = _mm_set1_ps(dt);
+
+    GRADIENT_ROW_SSE2(mm_f = _mm_add_ps(mm_t, _mm_mul_ps(mm_x, mm_dt));
+                      , row[i] = lut[gradient_lut_index(t + (float)i * dt)];)
+}
+
+void
+gradient_row_radial_sse2(Uint32 *row, int width, const Uint32 *lut, float u,
+                         float du, float vv)
+{
+    __m128 mm_u = _mm_set1_ps(u);
+    __m128 mm_du = _mm_set1_ps(du);
+    __m128 mm_vv = _mm_set1_ps(vv);
+    float x;
+
+    GRADIENT_ROW_SSE2(mm_f = _mm_add_ps(mm_u, _mm_mul_ps(mm_x, mm_du));
+                      mm_f = _mm_sqrt_ps(
+                          _mm_add_ps(_mm_mul_ps(mm_f, mm_f), mm_vv));
+                      , x = u + (float)i * du;
+                      row[i] = lut[gradient_lut_index(sqrtf(x * x + vv))];)
+}
+
+GRADIENT_BLENDER_SSE2(add, ADD_CODE)
+GRADIENT_BLENDER_SSE2(sub, SUB_CODE)
+GRADIENT_BLENDER_SSE2(mult, GRADIENT_MULT_CODE)
+GRADIENT_BLENDER_SSE2(min, MIN_CODE)
+GRADIENT_BLENDER_SSE2(max, MAX_CODE)
+#else
+void
+gradient_row_linear_sse2(Uint32 *row, int width, const Uint32 *lut, float t,
+                         float dt)
+{
+    BAD_SSE2_FUNCTION_CALL;
+}
+
+void
+gradient_row_radial_sse2(Uint32 *row, int width, const Uint32 *lut, float u,
+                         float du, float vv)
+{
+    BAD_SSE2_FUNCTION_CALL;
+}
+
+INVALID_GRADIENT_BLENDER_SSE2(add)
+INVALID_GRADIENT_BLENDER_SSE2(sub)
+INVALID_GRADIENT_BLENDER_SSE2(mult)
+INVALID_GRADIENT_BLENDER_SSE2(min)
+INVALID_GRADIENT_BLENDER_SSE2(max)
+#endif /* defined(__SSE2__) || defined(PG_ENABLE_ARM_NEON) */
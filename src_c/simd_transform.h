@@ -22,6 +22,18 @@
 #define PG_ENABLE_ARM_NEON 1
 #endif
 
+/* On arm64 the SSE2 code paths can run hand written NEON kernels instead of
+ * going through sse2neon. They are opt in until they have been measured on
+ * arm64 hardware, see the neon_kernels meson option. */
+#if !defined(PG_ENABLE_NATIVE_NEON)
+#if defined(__aarch64__) && PG_ENABLE_ARM_NEON && \
+    defined(PG_NEON_NATIVE_KERNELS)
+#define PG_ENABLE_NATIVE_NEON 1
+#else
+#define PG_ENABLE_NATIVE_NEON 0
+#endif
+#endif /* !defined(PG_ENABLE_NATIVE_NEON) */
+
 // SSE2 functions
 #if defined(__SSE2__) || defined(PG_ENABLE_ARM_NEON)
 
@@ -43,6 +55,50 @@ filter_expand_Y_SSE2(Uint8 *srcpix, Uint8 *dstpix, int width, int srcpitch,
                      int dstpitch, int srcheight, int dstheight);
 void
 invert_sse2(SDL_Surface *src, PG_PixelFormat *src_fmt, SDL_Surface *newsurf);
+// resampling filters of transform.scale
+void
+resample_row_h_sse2(const Uint8 *srcrow, Uint8 *dstrow, int dstwidth,
+                    const int *starts, const int *counts,
+                    const Sint16 *weights, int window);
+void
+resample_row_v_sse2(const Uint8 *srcpix, int srcpitch, Uint8 *dstrow,
+                    int width, int count, const Sint16 *weights);
+// box passes of the fast transform.gaussian_blur
+void
+fastblur_row_sse2(const Uint8 *src, Uint8 *dst, int width, int radius,
+                  int repeat);
+void
+fastblur_columns_sse2(const Uint8 *src, int src_pitch, Uint8 *dst,
+                      int dst_pitch, Uint32 *sums, int height, int count,
+                      int radius, int repeat);
+// fixed point passes of transform.convolve
+void
+convolve_h_sse2(Sint32 *acc, const Sint16 *row, int width,
+                const Sint16 *taps, int count);
+void
+convolve_v_sse2(Sint32 *acc, const Sint16 *row0, const Sint16 *row1,
+                int weight0, int weight1, int count);
+void
+convolve_finish_sse2(const Sint32 *acc, Sint16 *dst16, Uint8 *dst8,
+                     int count, int shift);
+// 32 bit rows of transform.color_matrix
+void
+colormatrix_row_sse2(const Uint8 *src, Uint8 *dst, int count,
+                     const Sint16 *matrix, const Sint32 *offsets);
+// 32 bit rows of transform.hsl
+void
+modify_hsl_sse2(const Uint8 *src, Uint8 *dst, int count, const int *shifts,
+                float h, float s, float l);
+// 2x2 box reduction of transform.build_mipmaps
+void
+mipmap_row_sse2(const Uint8 *row0, const Uint8 *row1, Uint8 *dst, int width);
+// 32 bit rows of transform.scale2x, transform.scale3x and transform.scale4x
+void
+scale2x_row_sse2(const Uint32 *prev, const Uint32 *cur, const Uint32 *next,
+                 Uint32 *out0, Uint32 *out1, int count);
+void
+scale3x_row_sse2(const Uint32 *prev, const Uint32 *cur, const Uint32 *next,
+                 Uint32 *out0, Uint32 *out1, Uint32 *out2, int count);
 
 #endif /* (defined(__SSE2__) || defined(PG_ENABLE_ARM_NEON)) */
 
@@ -52,3 +108,63 @@ grayscale_avx2(SDL_Surface *src, PG_PixelFormat *src_fmt,
                SDL_Surface *newsurf);
 void
 invert_avx2(SDL_Surface *src, PG_PixelFormat *src_fmt, SDL_Surface *newsurf);
+// smoothscale filters
+void
+filter_shrink_X_AVX2(Uint8 *srcpix, Uint8 *dstpix, int height, int srcpitch,
+                     int dstpitch, int srcwidth, int dstwidth);
+void
+filter_shrink_Y_AVX2(Uint8 *srcpix, Uint8 *dstpix, int width, int srcpitch,
+                     int dstpitch, int srcheight, int dstheight);
+void
+filter_expand_X_AVX2(Uint8 *srcpix, Uint8 *dstpix, int height, int srcpitch,
+                     int dstpitch, int srcwidth, int dstwidth);
+void
+filter_expand_Y_AVX2(Uint8 *srcpix, Uint8 *dstpix, int width, int srcpitch,
+                     int dstpitch, int srcheight, int dstheight);
+// fixed point passes of transform.convolve
+void
+convolve_h_avx2(Sint32 *acc, const Sint16 *row, int width,
+                const Sint16 *taps, int count);
+void
+convolve_v_avx2(Sint32 *acc, const Sint16 *row0, const Sint16 *row1,
+                int weight0, int weight1, int count);
+// 32 bit rows of transform.apply_lut and transform.color_matrix
+void
+colorlut_row_avx2(const Uint8 *src, Uint8 *dst, int count, const Uint32 *lut);
+void
+colormatrix_row_avx2(const Uint8 *src, Uint8 *dst, int count,
+                     const Sint16 *matrix, const Sint32 *offsets);
+// 32 bit rows of transform.hsl
+void
+modify_hsl_avx2(const Uint8 *src, Uint8 *dst, int count, const int *shifts,
+                float h, float s, float l);
+// 2x2 box reduction of transform.build_mipmaps
+void
+mipmap_row_avx2(const Uint8 *row0, const Uint8 *row1, Uint8 *dst, int width);
+// 32 bit rows of transform.scale2x, transform.scale3x and transform.scale4x
+void
+scale2x_row_avx2(const Uint32 *prev, const Uint32 *cur, const Uint32 *next,
+                 Uint32 *out0, Uint32 *out1, int count);
+void
+scale3x_row_avx2(const Uint32 *prev, const Uint32 *cur, const Uint32 *next,
+                 Uint32 *out0, Uint32 *out1, Uint32 *out2, int count);
+
+// NEON functions
+void
+grayscale_neon(SDL_Surface *src, PG_PixelFormat *src_fmt,
+               SDL_Surface *newsurf);
+void
+invert_neon(SDL_Surface *src, PG_PixelFormat *src_fmt, SDL_Surface *newsurf);
+// smoothscale filters
+void
+filter_shrink_X_NEON(Uint8 *srcpix, Uint8 *dstpix, int height, int srcpitch,
+                     int dstpitch, int srcwidth, int dstwidth);
+void
+filter_shrink_Y_NEON(Uint8 *srcpix, Uint8 *dstpix, int width, int srcpitch,
+                     int dstpitch, int srcheight, int dstheight);
+void
+filter_expand_X_NEON(Uint8 *srcpix, Uint8 *dstpix, int height, int srcpitch,
+                     int dstpitch, int srcwidth, int dstwidth);
+void
+filter_expand_Y_NEON(Uint8 *srcpix, Uint8 *dstpix, int width, int srcpitch,
+                     int dstpitch, int srcheight, int dstheight);
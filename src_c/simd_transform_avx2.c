@@ -297,6 +297,902 @@ invert_avx2(SDL_Surface *src, PG_PixelFormat *src_fmt, SDL_Surface *newsurf)
         srcp256 = (__m256i *)srcp;
     }
 }
+/* The smoothscale filters below do the same math as the SSE2 ones, so they
+ * give the same pixels, with twice as many pixels in each register. */
+#define _pg_avx2_loadu_si32(p) _mm_cvtsi32_si128(*(int const *)(p))
+#define _pg_avx2_storeu_si32(p, a) (void)(*(int *)(p) = _mm_cvtsi128_si32((a)))
+
+void
+filter_shrink_X_AVX2(Uint8 *srcpix, Uint8 *dstpix, int height, int srcpitch,
+                     int dstpitch, int srcwidth, int dstwidth)
+{
+    /* Four rows are filtered at once, each in its own 64 bits */
+    Uint8 *srcrows[4], *dstrows[4];
+    int x, y, i;
+    __m128i low, high;
+    __m256i src, dst, accumulate, mm256_xcounter, mm256_xfrac;
+
+    int xspace = 0x04000 * srcwidth / dstwidth; /* must be > 1 */
+    __m256i xrecip = _mm256_set1_epi16((Uint16)(0x40000000 / xspace));
+
+    for (y = 0; y < height; y += 4) {
+        int xcounter = xspace;
+        accumulate = _mm256_setzero_si256();
+
+        /* rows past the end of the surface redo the last row */
+        for (i = 0; i < 4; i++) {
+            int row = MIN(y + i, height - 1);
+            srcrows[i] = srcpix + (size_t)row * srcpitch;
+            dstrows[i] = dstpix + (size_t)row * dstpitch;
+        }
+
+        for (x = 0; x < srcwidth; x++) {
+            src = _mm256_cvtepu8_epi16(_mm_setr_epi32(
+                *(int const *)srcrows[0], *(int const *)srcrows[1],
+                *(int const *)srcrows[2], *(int const *)srcrows[3]));
+            for (i = 0; i < 4; i++) {
+                srcrows[i] += 4;
+            }
+
+            if (xcounter > 0x04000) {
+                accumulate = _mm256_add_epi16(accumulate, src);
+                xcounter -= 0x04000;
+            }
+            /* write out a destination pixel */
+            else {
+                int xfrac = 0x04000 - xcounter;
+
+                mm256_xcounter = _mm256_set1_epi16(xcounter);
+                mm256_xfrac = _mm256_set1_epi16(xfrac);
+
+                src = _mm256_slli_epi16(src, 2);
+                dst = _mm256_mulhi_epu16(src, mm256_xcounter);
+                dst = _mm256_add_epi16(dst, accumulate);
+                accumulate = _mm256_mulhi_epu16(src, mm256_xfrac);
+
+                dst = _mm256_mulhi_epu16(dst, xrecip);
+                dst = _mm256_packus_epi16(dst, _mm256_setzero_si256());
+
+                /* each lane holds the pixels of two rows */
+                low = _mm256_castsi256_si128(dst);
+                high = _mm256_extracti128_si256(dst, 1);
+                _pg_avx2_storeu_si32(dstrows[0], low);
+                _pg_avx2_storeu_si32(dstrows[1], _mm_srli_si128(low, 4));
+                _pg_avx2_storeu_si32(dstrows[2], high);
+                _pg_avx2_storeu_si32(dstrows[3], _mm_srli_si128(high, 4));
+                for (i = 0; i < 4; i++) {
+                    dstrows[i] += 4;
+                }
+                xcounter = xspace - xfrac;
+            }
+        }
+    }
+}
+
+void
+filter_shrink_Y_AVX2(Uint8 *srcpix, Uint8 *dstpix, int width, int srcpitch,
+                     int dstpitch, int srcheight, int dstheight)
+{
+    /* Four pixels of a row at once, the last few one at a time */
+    int srcdiff = srcpitch - (width * 4);
+    int dstdiff = dstpitch - (width * 4);
+    int x, y;
+    __m128i src, dst, mm_acc, mm_yfrac, mm_ycounter, mm_yrecip;
+    __m256i src256, dst256, mm256_acc, mm256_yfrac, mm256_ycounter;
+
+    int during_4_width = width / 4;
+    int post_4_width = width % 4;
+
+    int yspace = 0x04000 * srcheight / dstheight; /* must be > 1 */
+    __m256i yrecip = _mm256_set1_epi16(0x40000000 / yspace);
+    int ycounter = yspace;
+
+    Uint16 *templine;
+    /* allocate a clear memory area for storing the accumulator line */
+    templine = (Uint16 *)calloc(dstpitch, 2);
+    if (templine == NULL) {
+        return;
+    }
+    mm_yrecip = _mm256_castsi256_si128(yrecip);
+
+    for (y = 0; y < srcheight; y++) {
+        Uint16 *accumulate = templine;
+        if (ycounter > 0x04000) {
+            for (x = 0; x < during_4_width; x++) {
+                src256 = _mm256_cvtepu8_epi16(
+                    _mm_loadu_si128((const __m128i *)srcpix));
+                _mm256_storeu_si256(
+                    (__m256i *)accumulate,
+                    _mm256_add_epi16(
+                        _mm256_loadu_si256((const __m256i *)accumulate),
+                        src256));
+                accumulate += 16;
+                srcpix += 16;
+            }
+            for (x = 0; x < post_4_width; x++) {
+                src = _mm_cvtepu8_epi16(_pg_avx2_loadu_si32(srcpix));
+                _mm_storel_epi64(
+                    (__m128i *)accumulate,
+                    _mm_add_epi16(_mm_loadl_epi64((const __m128i *)accumulate),
+                                  src));
+                accumulate += 4;
+                srcpix += 4;
+            }
+            ycounter -= 0x04000;
+        }
+        else {
+            int yfrac = 0x04000 - ycounter;
+            mm256_yfrac = _mm256_set1_epi16(yfrac);
+            mm256_ycounter = _mm256_set1_epi16(ycounter);
+            mm_yfrac = _mm256_castsi256_si128(mm256_yfrac);
+            mm_ycounter = _mm256_castsi256_si128(mm256_ycounter);
+
+            /* write out a destination line */
+            for (x = 0; x < during_4_width; x++) {
+                src256 = _mm256_cvtepu8_epi16(
+                    _mm_loadu_si128((const __m128i *)srcpix));
+                srcpix += 16;
+                mm256_acc = _mm256_loadu_si256((const __m256i *)accumulate);
+
+                src256 = _mm256_slli_epi16(src256, 2);
+                dst256 = _mm256_mulhi_epu16(src256, mm256_yfrac);
+                src256 = _mm256_mulhi_epu16(src256, mm256_ycounter);
+
+                _mm256_storeu_si256((__m256i *)accumulate, dst256);
+                accumulate += 16;
+
+                dst256 = _mm256_add_epi16(src256, mm256_acc);
+                dst256 = _mm256_mulhi_epu16(dst256, yrecip);
+                dst256 = _mm256_packus_epi16(dst256, _mm256_setzero_si256());
+                dst256 = _mm256_permute4x64_epi64(dst256, 0x08);
+                _mm_storeu_si128((__m128i *)dstpix,
+                                 _mm256_castsi256_si128(dst256));
+                dstpix += 16;
+            }
+            for (x = 0; x < post_4_width; x++) {
+                src = _mm_cvtepu8_epi16(_pg_avx2_loadu_si32(srcpix));
+                srcpix += 4;
+                mm_acc = _mm_loadl_epi64((const __m128i *)accumulate);
+
+                src = _mm_slli_epi16(src, 2);
+                dst = _mm_mulhi_epu16(src, mm_yfrac);
+                src = _mm_mulhi_epu16(src, mm_ycounter);
+
+                _mm_storel_epi64((__m128i *)accumulate, dst);
+                accumulate += 4;
+
+                dst = _mm_add_epi16(src, mm_acc);
+                dst = _mm_mulhi_epu16(dst, mm_yrecip);
+                dst = _mm_packus_epi16(dst, _mm_setzero_si128());
+                _pg_avx2_storeu_si32(dstpix, dst);
+                dstpix += 4;
+            }
+            dstpix += dstdiff;
+            ycounter = yspace - yfrac;
+        }
+        srcpix += srcdiff;
+    }
+
+    /* free the temporary memory */
+    free(templine);
+}
+
+void
+filter_expand_X_AVX2(Uint8 *srcpix, Uint8 *dstpix, int height, int srcpitch,
+                     int dstpitch, int srcwidth, int dstwidth)
+{
+    /* Two destination pixels at once, one in each lane */
+    int dstdiff = dstpitch - (dstwidth * 4);
+    int *xidx0, *xmult_combined;
+    int x, y;
+    const int factorwidth = 8;
+    __m128i src, multcombined, dst;
+    __m256i src256, mult256, dst256;
+    const __m256i mm256_spread_mult =
+        _mm256_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3);
+    const __m256i mm256_gather_pixels =
+        _mm256_setr_epi32(0, 4, 0, 0, 0, 0, 0, 0);
+
+#ifdef _MSC_VER
+    /* Make MSVC static analyzer happy by assuring dstwidth >= 2 to suppress
+     * a false analyzer report */
+    __analysis_assume(dstwidth >= 2);
+#endif
+
+    /* Allocate memory for factors */
+    xidx0 = malloc(dstwidth * 4);
+    if (xidx0 == 0) {
+        return;
+    }
+    xmult_combined = (int *)malloc(dstwidth * factorwidth);
+    if (xmult_combined == 0) {
+        free(xidx0);
+        return;
+    }
+
+    /* Create multiplier factors and starting indices and put them in arrays */
+    for (x = 0; x < dstwidth; x++) {
+        int xm1 = 0x100 * ((x * (srcwidth - 1)) % dstwidth) / dstwidth;
+        int xm0 = 0x100 - xm1;
+        xidx0[x] = x * (srcwidth - 1) / dstwidth;
+
+        xmult_combined[x * 2] = xm0 | (xm0 << 16);
+        xmult_combined[x * 2 + 1] = xm1 | (xm1 << 16);
+    }
+
+    /* Do the scaling in raster order so we don't trash the cache */
+    for (y = 0; y < height; y++) {
+        Uint8 *srcrow0 = srcpix + y * srcpitch;
+        for (x = 0; x + 2 <= dstwidth; x += 2) {
+            /* the two source pixels of each destination pixel */
+            src256 = _mm256_cvtepu8_epi16(_mm_unpacklo_epi64(
+                _mm_loadl_epi64((const __m128i *)(srcrow0 + xidx0[x] * 4)),
+                _mm_loadl_epi64(
+                    (const __m128i *)(srcrow0 + xidx0[x + 1] * 4))));
+
+            mult256 = _mm256_permutevar8x32_epi32(
+                _mm256_castsi128_si256(_mm_loadu_si128(
+                    (const __m128i *)(xmult_combined + x * 2))),
+                mm256_spread_mult);
+            src256 = _mm256_mullo_epi16(src256, mult256);
+
+            dst256 = _mm256_add_epi16(src256, _mm256_bsrli_epi128(src256, 8));
+            dst256 = _mm256_packus_epi16(_mm256_srli_epi16(dst256, 8),
+                                         _mm256_setzero_si256());
+            dst256 = _mm256_permutevar8x32_epi32(dst256, mm256_gather_pixels);
+            _mm_storel_epi64((__m128i *)dstpix,
+                             _mm256_castsi256_si128(dst256));
+
+            dstpix += 8;
+        }
+        if (x < dstwidth) {
+            src = _mm_cvtepu8_epi16(
+                _mm_loadl_epi64((const __m128i *)(srcrow0 + xidx0[x] * 4)));
+
+            multcombined = _mm_shuffle_epi32(
+                _mm_loadl_epi64((const __m128i *)(xmult_combined + x * 2)),
+                0b01010000);
+            src = _mm_mullo_epi16(src, multcombined);
+
+            dst = _mm_add_epi16(src, _mm_bsrli_si128(src, 8));
+            dst =
+                _mm_packus_epi16(_mm_srli_epi16(dst, 8), _mm_setzero_si128());
+            _pg_avx2_storeu_si32(dstpix, dst);
+
+            dstpix += 4;
+        }
+        dstpix += dstdiff;
+    }
+
+    /* free memory */
+    free(xidx0);
+    free(xmult_combined);
+}
+
+void
+filter_expand_Y_AVX2(Uint8 *srcpix, Uint8 *dstpix, int width, int srcpitch,
+                     int dstpitch, int srcheight, int dstheight)
+{
+    /* Four pixels of a row at once, the last few one at a time */
+    int x, y;
+    __m128i src0, src1, dst, ymult0_mm, ymult1_mm;
+    __m256i src0_256, src1_256, dst256, ymult0_mm256, ymult1_mm256;
+
+    int dstdiff = dstpitch - (width * 4);
+
+    int during_4_width = width / 4;
+    int post_4_width = width % 4;
+
+    for (y = 0; y < dstheight; y++) {
+        int yidx0 = y * (srcheight - 1) / dstheight;
+        Uint8 *srcrow0 = srcpix + yidx0 * srcpitch;
+        Uint8 *srcrow1 = srcrow0 + srcpitch;
+        int ymult1 = 0x0100 * ((y * (srcheight - 1)) % dstheight) / dstheight;
+        int ymult0 = 0x0100 - ymult1;
+
+        ymult0_mm256 = _mm256_set1_epi16(ymult0);
+        ymult1_mm256 = _mm256_set1_epi16(ymult1);
+        ymult0_mm = _mm256_castsi256_si128(ymult0_mm256);
+        ymult1_mm = _mm256_castsi256_si128(ymult1_mm256);
+
+        for (x = 0; x < during_4_width; x++) {
+            src0_256 = _mm256_cvtepu8_epi16(
+                _mm_loadu_si128((const __m128i *)srcrow0));
+            src1_256 = _mm256_cvtepu8_epi16(
+                _mm_loadu_si128((const __m128i *)srcrow1));
+
+            src0_256 = _mm256_mullo_epi16(src0_256, ymult0_mm256);
+            src1_256 = _mm256_mullo_epi16(src1_256, ymult1_mm256);
+            dst256 = _mm256_add_epi16(src0_256, src1_256);
+            dst256 = _mm256_srli_epi16(dst256, 8);
+
+            dst256 = _mm256_packus_epi16(dst256, _mm256_setzero_si256());
+            dst256 = _mm256_permute4x64_epi64(dst256, 0x08);
+            _mm_storeu_si128((__m128i *)dstpix,
+                             _mm256_castsi256_si128(dst256));
+
+            srcrow0 += 16;
+            srcrow1 += 16;
+            dstpix += 16;
+        }
+        for (x = 0; x < post_4_width; x++) {
+            src0 = _mm_cvtepu8_epi16(_pg_avx2_loadu_si32(srcrow0));
+            src1 = _mm_cvtepu8_epi16(_pg_avx2_loadu_si32(srcrow1));
+
+            src0 = _mm_mullo_epi16(src0, ymult0_mm);
+            src1 = _mm_mullo_epi16(src1, ymult1_mm);
+            dst = _mm_add_epi16(src0, src1);
+            dst = _mm_srli_epi16(dst, 8);
+
+            dst = _mm_packus_epi16(dst, _mm_setzero_si128());
+            _pg_avx2_storeu_si32(dstpix, dst);
+
+            srcrow0 += 4;
+            srcrow1 += 4;
+            dstpix += 4;
+        }
+        dstpix += dstdiff;
+    }
+}
+
+/* Two 16 bit weights, repeated for each pair of channels */
+#define _PG_WEIGHT_PAIR_AVX2(w0, w1) \
+    _mm256_set1_epi32((Uint16)(w0) | ((Uint32)(Uint16)(w1) << 16))
+
+/* See convolve_h_sse2, this does four pixels at once. The 128 bit lanes
+ * interleave them, the low lane ends up with pixels 0 and 1 and the high lane
+ * with pixels 2 and 3 once they are permuted back into order. */
+void
+convolve_h_avx2(Sint32 *acc, const Sint16 *row, int width,
+                const Sint16 *taps, int count)
+{
+    const __m256i mm256_zero = _mm256_setzero_si256();
+    __m256i mm256_a, mm256_b, mm256_weights, mm256_lo, mm256_hi;
+    int x, k, c;
+
+    for (x = 0; x + 4 <= width; x += 4) {
+        const Sint16 *srcp = row + (size_t)x * 4;
+        Sint32 *accp = acc + (size_t)x * 4;
+
+        mm256_lo = mm256_hi = mm256_zero;
+        for (k = 0; k + 2 <= count; k += 2) {
+            mm256_a = _mm256_loadu_si256((const __m256i *)(srcp + k * 4));
+            mm256_b =
+                _mm256_loadu_si256((const __m256i *)(srcp + k * 4 + 4));
+            mm256_weights = _PG_WEIGHT_PAIR_AVX2(taps[k], taps[k + 1]);
+            mm256_lo = _mm256_add_epi32(
+                mm256_lo,
+                _mm256_madd_epi16(_mm256_unpacklo_epi16(mm256_a, mm256_b),
+                                  mm256_weights));
+            mm256_hi = _mm256_add_epi32(
+                mm256_hi,
+                _mm256_madd_epi16(_mm256_unpackhi_epi16(mm256_a, mm256_b),
+                                  mm256_weights));
+        }
+        if (k < count) {
+            mm256_a = _mm256_loadu_si256((const __m256i *)(srcp + k * 4));
+            mm256_weights = _PG_WEIGHT_PAIR_AVX2(taps[k], 0);
+            mm256_lo = _mm256_add_epi32(
+                mm256_lo,
+                _mm256_madd_epi16(_mm256_unpacklo_epi16(mm256_a, mm256_zero),
+                                  mm256_weights));
+            mm256_hi = _mm256_add_epi32(
+                mm256_hi,
+                _mm256_madd_epi16(_mm256_unpackhi_epi16(mm256_a, mm256_zero),
+                                  mm256_weights));
+        }
+        _mm256_storeu_si256(
+            (__m256i *)accp,
+            _mm256_add_epi32(
+                _mm256_loadu_si256((__m256i *)accp),
+                _mm256_permute2x128_si256(mm256_lo, mm256_hi, 0x20)));
+        _mm256_storeu_si256(
+            (__m256i *)(accp + 8),
+            _mm256_add_epi32(
+                _mm256_loadu_si256((__m256i *)(accp + 8)),
+                _mm256_permute2x128_si256(mm256_lo, mm256_hi, 0x31)));
+    }
+
+    for (; x < width; x++) {
+        for (c = 0; c < 4; c++) {
+            const Sint16 *srcp = row + (size_t)x * 4 + c;
+            Sint32 sum = 0;
+
+            for (k = 0; k < count; k++) {
+                sum += taps[k] * srcp[k * 4];
+            }
+            acc[(size_t)x * 4 + c] += sum;
+        }
+    }
+}
+
+/* See convolve_v_sse2, this does sixteen values at once */
+void
+convolve_v_avx2(Sint32 *acc, const Sint16 *row0, const Sint16 *row1,
+                int weight0, int weight1, int count)
+{
+    const __m256i mm256_weights = _PG_WEIGHT_PAIR_AVX2(weight0, weight1);
+    __m256i mm256_a, mm256_b, mm256_lo, mm256_hi;
+    int i;
+
+    for (i = 0; i + 16 <= count; i += 16) {
+        mm256_a = _mm256_loadu_si256((const __m256i *)(row0 + i));
+        mm256_b = _mm256_loadu_si256((const __m256i *)(row1 + i));
+        mm256_lo = _mm256_madd_epi16(_mm256_unpacklo_epi16(mm256_a, mm256_b),
+                                     mm256_weights);
+        mm256_hi = _mm256_madd_epi16(_mm256_unpackhi_epi16(mm256_a, mm256_b),
+                                     mm256_weights);
+        _mm256_storeu_si256(
+            (__m256i *)(acc + i),
+            _mm256_add_epi32(
+                _mm256_loadu_si256((__m256i *)(acc + i)),
+                _mm256_permute2x128_si256(mm256_lo, mm256_hi, 0x20)));
+        _mm256_storeu_si256(
+            (__m256i *)(acc + i + 8),
+            _mm256_add_epi32(
+                _mm256_loadu_si256((__m256i *)(acc + i + 8)),
+                _mm256_permute2x128_si256(mm256_lo, mm256_hi, 0x31)));
+    }
+    for (; i < count; i++) {
+        acc[i] += weight0 * row0[i] + weight1 * row1[i];
+    }
+}
+
+/* Looks up eight 32 bit pixels at a time for transform.apply_lut. lut holds
+ * four tables of 256 entries, one for each byte of the pixel values from the
+ * lowest up, with the new byte already shifted into place. */
+void
+colorlut_row_avx2(const Uint8 *src, Uint8 *dst, int count, const Uint32 *lut)
+{
+    const __m256i mm256_mask = _mm256_set1_epi32(0xFF);
+    __m256i mm256_src, mm256_dst;
+    Uint32 pixel;
+    int i;
+
+    for (i = 0; i + 8 <= count; i += 8) {
+        mm256_src = _mm256_loadu_si256((const __m256i *)(src + i * 4));
+        mm256_dst = _mm256_i32gather_epi32(
+            (const int *)lut, _mm256_and_si256(mm256_src, mm256_mask), 4);
+        mm256_dst = _mm256_or_si256(
+            mm256_dst,
+            _mm256_i32gather_epi32(
+                (const int *)(lut + 256),
+                _mm256_and_si256(_mm256_srli_epi32(mm256_src, 8), mm256_mask),
+                4));
+        mm256_dst = _mm256_or_si256(
+            mm256_dst,
+            _mm256_i32gather_epi32(
+                (const int *)(lut + 512),
+                _mm256_and_si256(_mm256_srli_epi32(mm256_src, 16),
+                                 mm256_mask),
+                4));
+        mm256_dst = _mm256_or_si256(
+            mm256_dst,
+            _mm256_i32gather_epi32((const int *)(lut + 768),
+                                   _mm256_srli_epi32(mm256_src, 24), 4));
+        _mm256_storeu_si256((__m256i *)(dst + i * 4), mm256_dst);
+    }
+    for (; i < count; i++) {
+        memcpy(&pixel, src + i * 4, 4);
+        pixel = lut[pixel & 0xFF] | lut[256 + ((pixel >> 8) & 0xFF)] |
+                lut[512 + ((pixel >> 16) & 0xFF)] | lut[768 + (pixel >> 24)];
+        memcpy(dst + i * 4, &pixel, 4);
+    }
+}
+
+/* See colormatrix_row_sse2, this does eight pixels at once. The pixels of
+ * the two 128 bit lanes come out of the packs interleaved, and are put back
+ * in order with a permute. */
+void
+colormatrix_row_avx2(const Uint8 *src, Uint8 *dst, int count,
+                     const Sint16 *matrix, const Sint32 *offsets)
+{
+    const __m256i mm256_w01 = _mm256_set_epi16(
+        matrix[13], matrix[12], matrix[9], matrix[8], matrix[5], matrix[4],
+        matrix[1], matrix[0], matrix[13], matrix[12], matrix[9], matrix[8],
+        matrix[5], matrix[4], matrix[1], matrix[0]);
+    const __m256i mm256_w23 = _mm256_set_epi16(
+        matrix[15], matrix[14], matrix[11], matrix[10], matrix[7], matrix[6],
+        matrix[3], matrix[2], matrix[15], matrix[14], matrix[11], matrix[10],
+        matrix[7], matrix[6], matrix[3], matrix[2]);
+    const __m256i mm256_offsets = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128((const __m128i *)offsets));
+    __m256i mm256_a, mm256_b, mm256_ab, mm256_cd;
+    Uint8 pixels[32];
+    int i, n;
+
+#define _PG_MATRIX_PIXELS(pixels, shuffle01, shuffle23)                    \
+    _mm256_srai_epi32(                                                      \
+        _mm256_add_epi32(                                                   \
+            _mm256_add_epi32(                                               \
+                _mm256_madd_epi16(_mm256_shuffle_epi32(pixels, shuffle01),  \
+                                  mm256_w01),                               \
+                _mm256_madd_epi16(_mm256_shuffle_epi32(pixels, shuffle23),  \
+                                  mm256_w23)),                              \
+            mm256_offsets),                                                 \
+        12)
+
+    for (i = 0; i < count; i += 8) {
+        const Uint8 *srcp = src + i * 4;
+
+        n = MIN(count - i, 8);
+        if (n < 8) {
+            memcpy(pixels, srcp, (size_t)n * 4);
+            srcp = pixels;
+        }
+        /* each lane holds two pixels, pixels 0, 1, 4 and 5 in the low lanes
+         * and pixels 2, 3, 6 and 7 in the high lanes */
+        mm256_a = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)srcp));
+        mm256_b = _mm256_cvtepu8_epi16(
+            _mm_loadu_si128((const __m128i *)(srcp + 16)));
+
+        mm256_ab = _mm256_packs_epi32(_PG_MATRIX_PIXELS(mm256_a, 0x00, 0x55),
+                                      _PG_MATRIX_PIXELS(mm256_a, 0xAA, 0xFF));
+        mm256_cd = _mm256_packs_epi32(_PG_MATRIX_PIXELS(mm256_b, 0x00, 0x55),
+                                      _PG_MATRIX_PIXELS(mm256_b, 0xAA, 0xFF));
+        mm256_ab = _mm256_permute4x64_epi64(
+            _mm256_packus_epi16(mm256_ab, mm256_cd), 0xD8);
+        if (n < 8) {
+            _mm256_storeu_si256((__m256i *)pixels, mm256_ab);
+            memcpy(dst + i * 4, pixels, (size_t)n * 4);
+        }
+        else {
+            _mm256_storeu_si256((__m256i *)(dst + i * 4), mm256_ab);
+        }
+    }
+#undef _PG_MATRIX_PIXELS
+}
+
+/* Picks a where mask is set and b elsewhere */
+#define _PG_SELECT_PS_AVX2(mask, a, b) \
+    _mm256_or_ps(_mm256_and_ps((mask), (a)), _mm256_andnot_ps((mask), (b)))
+
+/* See _hue_to_rgb_sse2 */
+static PG_FORCEINLINE __m256
+_hue_to_rgb_avx2(__m256 p, __m256 q, __m256 t)
+{
+    const __m256 mm256_one = _mm256_set1_ps(1.0f);
+    const __m256 mm256_six = _mm256_set1_ps(6.0f);
+    const __m256 mm256_two_thirds = _mm256_set1_ps(2 / 3.0f);
+    __m256 mm256_value;
+
+    t = _mm256_add_ps(
+        t, _mm256_and_ps(
+               _mm256_cmp_ps(t, _mm256_setzero_ps(), _CMP_LT_OQ), mm256_one));
+    t = _mm256_sub_ps(
+        t, _mm256_and_ps(_mm256_cmp_ps(t, mm256_one, _CMP_GT_OQ), mm256_one));
+
+    mm256_value = _PG_SELECT_PS_AVX2(
+        _mm256_cmp_ps(t, mm256_two_thirds, _CMP_LT_OQ),
+        _mm256_add_ps(
+            p, _mm256_mul_ps(
+                   _mm256_mul_ps(_mm256_sub_ps(q, p),
+                                 _mm256_sub_ps(mm256_two_thirds, t)),
+                   mm256_six)),
+        p);
+    mm256_value = _PG_SELECT_PS_AVX2(
+        _mm256_cmp_ps(t, _mm256_set1_ps(1 / 2.0f), _CMP_LT_OQ), q,
+        mm256_value);
+    return _PG_SELECT_PS_AVX2(
+        _mm256_cmp_ps(t, _mm256_set1_ps(1 / 6.0f), _CMP_LT_OQ),
+        _mm256_add_ps(p, _mm256_mul_ps(
+                             _mm256_mul_ps(_mm256_sub_ps(q, p), mm256_six),
+                             t)),
+        mm256_value);
+}
+
+/* Gets a channel of eight pixels as floats from 0 to 1 */
+#define _PG_HSL_CHANNEL_AVX2(pixels, shift)                                \
+    _mm256_div_ps(                                                         \
+        _mm256_cvtepi32_ps(_mm256_and_si256(                               \
+            _mm256_srl_epi32(pixels, shift), _mm256_set1_epi32(0xFF))),    \
+        _mm256_set1_ps(255.0f))
+
+/* See modify_hsl_sse2, this does eight pixels at once */
+void
+modify_hsl_avx2(const Uint8 *src, Uint8 *dst, int count, const int *shifts,
+                float h, float s, float l)
+{
+    const __m128i mm_rshift = _mm_cvtsi32_si128(shifts[0]);
+    const __m128i mm_gshift = _mm_cvtsi32_si128(shifts[1]);
+    const __m128i mm_bshift = _mm_cvtsi32_si128(shifts[2]);
+    const __m256i mm256_keep = _mm256_set1_epi32(
+        (int)~((0xFFu << shifts[0]) | (0xFFu << shifts[1]) |
+               (0xFFu << shifts[2])));
+    const __m256 mm256_zero = _mm256_setzero_ps();
+    const __m256 mm256_one = _mm256_set1_ps(1.0f);
+    const __m256 mm256_two = _mm256_set1_ps(2.0f);
+    const __m256 mm256_half = _mm256_set1_ps(0.5f);
+    const __m256 mm256_255 = _mm256_set1_ps(255.0f);
+    const __m256 mm256_third = _mm256_set1_ps(1 / 3.0f);
+    __m256i mm256_src, mm256_dst;
+    __m256 r, g, b, min, max, delta, hue, sat, lum, mask, p, q;
+    Uint8 pixels[32];
+    int i, n;
+
+    for (i = 0; i < count; i += 8) {
+        const Uint8 *srcp = src + i * 4;
+
+        n = MIN(count - i, 8);
+        if (n < 8) {
+            memcpy(pixels, srcp, (size_t)n * 4);
+            srcp = pixels;
+        }
+        mm256_src = _mm256_loadu_si256((const __m256i *)srcp);
+        r = _PG_HSL_CHANNEL_AVX2(mm256_src, mm_rshift);
+        g = _PG_HSL_CHANNEL_AVX2(mm256_src, mm_gshift);
+        b = _PG_HSL_CHANNEL_AVX2(mm256_src, mm_bshift);
+
+        /* RGB_to_HSL */
+        min = _mm256_min_ps(_mm256_min_ps(r, g), b);
+        max = _mm256_max_ps(_mm256_max_ps(r, g), b);
+        delta = _mm256_sub_ps(max, min);
+        lum = _mm256_div_ps(_mm256_add_ps(max, min), mm256_two);
+
+        sat = _PG_SELECT_PS_AVX2(
+            _mm256_cmp_ps(lum, mm256_half, _CMP_GT_OQ),
+            _mm256_div_ps(delta, _mm256_sub_ps(_mm256_sub_ps(mm256_two, max),
+                                               min)),
+            _mm256_div_ps(delta, _mm256_add_ps(max, min)));
+        hue = _PG_SELECT_PS_AVX2(
+            _mm256_cmp_ps(max, r, _CMP_EQ_OQ),
+            _mm256_add_ps(
+                _mm256_div_ps(_mm256_sub_ps(g, b), delta),
+                _mm256_and_ps(_mm256_cmp_ps(g, b, _CMP_LT_OQ),
+                              _mm256_set1_ps(6.0f))),
+            _PG_SELECT_PS_AVX2(
+                _mm256_cmp_ps(max, g, _CMP_EQ_OQ),
+                _mm256_add_ps(_mm256_div_ps(_mm256_sub_ps(b, r), delta),
+                              mm256_two),
+                _mm256_add_ps(_mm256_div_ps(_mm256_sub_ps(r, g), delta),
+                              _mm256_set1_ps(4.0f))));
+        hue = _mm256_div_ps(hue, _mm256_set1_ps(6.0f));
+        mask = _mm256_cmp_ps(delta, mm256_zero, _CMP_NEQ_UQ);
+        hue = _mm256_and_ps(mask, hue);
+        sat = _mm256_and_ps(mask, sat);
+
+        if (h) {
+            hue = _mm256_add_ps(hue, _mm256_set1_ps(h));
+            mask = _mm256_cmp_ps(hue, mm256_one, _CMP_GT_OQ);
+            hue = _PG_SELECT_PS_AVX2(
+                mask, _mm256_sub_ps(hue, mm256_one),
+                _mm256_add_ps(
+                    hue,
+                    _mm256_and_ps(_mm256_cmp_ps(hue, mm256_zero, _CMP_LT_OQ),
+                                  mm256_one)));
+        }
+        if (s) {
+            sat = _mm256_mul_ps(sat, _mm256_set1_ps(1 + s));
+            sat = _mm256_max_ps(_mm256_min_ps(sat, mm256_one), mm256_zero);
+        }
+        if (l) {
+            lum = l < 0 ? _mm256_mul_ps(lum, _mm256_set1_ps(1 + l))
+                        : _mm256_add_ps(
+                              _mm256_mul_ps(lum, _mm256_set1_ps(1 - l)),
+                              _mm256_set1_ps(l));
+            lum = _mm256_max_ps(_mm256_min_ps(lum, mm256_one), mm256_zero);
+        }
+
+        /* HSL_to_RGB */
+        q = _PG_SELECT_PS_AVX2(
+            _mm256_cmp_ps(lum, mm256_half, _CMP_LT_OQ),
+            _mm256_mul_ps(lum, _mm256_add_ps(mm256_one, sat)),
+            _mm256_sub_ps(_mm256_add_ps(lum, sat), _mm256_mul_ps(lum, sat)));
+        p = _mm256_sub_ps(_mm256_mul_ps(mm256_two, lum), q);
+        mask = _mm256_cmp_ps(sat, mm256_zero, _CMP_EQ_OQ);
+        r = _PG_SELECT_PS_AVX2(
+            mask, lum,
+            _hue_to_rgb_avx2(p, q, _mm256_add_ps(hue, mm256_third)));
+        g = _PG_SELECT_PS_AVX2(mask, lum, _hue_to_rgb_avx2(p, q, hue));
+        b = _PG_SELECT_PS_AVX2(
+            mask, lum,
+            _hue_to_rgb_avx2(p, q, _mm256_sub_ps(hue, mm256_third)));
+
+        mm256_dst = _mm256_and_si256(mm256_src, mm256_keep);
+        mm256_dst = _mm256_or_si256(
+            mm256_dst,
+            _mm256_sll_epi32(_mm256_cvttps_epi32(_mm256_mul_ps(r, mm256_255)),
+                             mm_rshift));
+        mm256_dst = _mm256_or_si256(
+            mm256_dst,
+            _mm256_sll_epi32(_mm256_cvttps_epi32(_mm256_mul_ps(g, mm256_255)),
+                             mm_gshift));
+        mm256_dst = _mm256_or_si256(
+            mm256_dst,
+            _mm256_sll_epi32(_mm256_cvttps_epi32(_mm256_mul_ps(b, mm256_255)),
+                             mm_bshift));
+        if (n < 8) {
+            _mm256_storeu_si256((__m256i *)pixels, mm256_dst);
+            memcpy(dst + i * 4, pixels, (size_t)n * 4);
+        }
+        else {
+            _mm256_storeu_si256((__m256i *)(dst + i * 4), mm256_dst);
+        }
+    }
+}
+
+/* Halves two rows of 32 bit pixels into width pixels for
+ * transform.build_mipmaps, four output pixels at a time. Each output byte
+ * is the rounded mean of the 2x2 block of bytes above it. */
+void
+mipmap_row_avx2(const Uint8 *row0, const Uint8 *row1, Uint8 *dst, int width)
+{
+    const __m256i mm256_zero = _mm256_setzero_si256();
+    const __m256i mm256_two = _mm256_set1_epi16(2);
+    __m256i mm256_src0, mm256_src1, mm256_lo, mm256_hi;
+    int x, k;
+
+    for (x = 0; x + 4 <= width; x += 4) {
+        mm256_src0 = _mm256_loadu_si256((const __m256i *)(row0 + x * 8));
+        mm256_src1 = _mm256_loadu_si256((const __m256i *)(row1 + x * 8));
+        mm256_lo =
+            _mm256_add_epi16(_mm256_unpacklo_epi8(mm256_src0, mm256_zero),
+                             _mm256_unpacklo_epi8(mm256_src1, mm256_zero));
+        mm256_hi =
+            _mm256_add_epi16(_mm256_unpackhi_epi8(mm256_src0, mm256_zero),
+                             _mm256_unpackhi_epi8(mm256_src1, mm256_zero));
+        /* the sums of the pixel pairs in the low halves of the lanes */
+        mm256_lo = _mm256_add_epi16(mm256_lo, _mm256_srli_si256(mm256_lo, 8));
+        mm256_hi = _mm256_add_epi16(mm256_hi, _mm256_srli_si256(mm256_hi, 8));
+        mm256_lo = _mm256_srli_epi16(
+            _mm256_add_epi16(_mm256_unpacklo_epi64(mm256_lo, mm256_hi),
+                             mm256_two),
+            2);
+        mm256_lo = _mm256_permute4x64_epi64(
+            _mm256_packus_epi16(mm256_lo, mm256_lo), 0x08);
+        _mm_storeu_si128((__m128i *)(dst + x * 4),
+                         _mm256_castsi256_si128(mm256_lo));
+    }
+    for (; x < width; x++) {
+        for (k = 0; k < 4; k++) {
+            dst[x * 4 + k] = (Uint8)((row0[x * 8 + k] + row0[x * 8 + 4 + k] +
+                                      row1[x * 8 + k] +
+                                      row1[x * 8 + 4 + k] + 2) >>
+                                     2);
+        }
+    }
+}
+
+/* Picks the 32 bit lanes of a where mask is set and of b elsewhere */
+#define _PG_SELECT_SI256(mask, a, b) \
+    _mm256_or_si256(_mm256_and_si256(mask, a), _mm256_andnot_si256(mask, b))
+
+/* Loads the neighbours of eight pixels of the padded rows of
+ * transform.scale2x and transform.scale3x, see _PG_SCALEX_LOAD_SSE2 */
+#define _PG_SCALEX_LOAD_AVX2(x)                                            \
+    mm256_b = _mm256_loadu_si256((const __m256i *)(prev + (x)));           \
+    mm256_d = _mm256_loadu_si256((const __m256i *)(cur + (x) - 1));        \
+    mm256_e = _mm256_loadu_si256((const __m256i *)(cur + (x)));            \
+    mm256_f = _mm256_loadu_si256((const __m256i *)(cur + (x) + 1));        \
+    mm256_h = _mm256_loadu_si256((const __m256i *)(next + (x)));           \
+    mm256_cond = _mm256_andnot_si256(                                      \
+        _mm256_or_si256(_mm256_cmpeq_epi32(mm256_b, mm256_h),              \
+                        _mm256_cmpeq_epi32(mm256_d, mm256_f)),             \
+        mm256_ones);                                                       \
+    mm256_db =                                                             \
+        _mm256_and_si256(_mm256_cmpeq_epi32(mm256_d, mm256_b), mm256_cond); \
+    mm256_bf =                                                             \
+        _mm256_and_si256(_mm256_cmpeq_epi32(mm256_b, mm256_f), mm256_cond); \
+    mm256_dh =                                                             \
+        _mm256_and_si256(_mm256_cmpeq_epi32(mm256_d, mm256_h), mm256_cond); \
+    mm256_hf =                                                             \
+        _mm256_and_si256(_mm256_cmpeq_epi32(mm256_h, mm256_f), mm256_cond);
+
+/* Doubles count pixels of a row of 32 bit pixels for transform.scale2x,
+ * count being a multiple of 8. prev, cur and next are the rows above, at
+ * and below, each readable one pixel past both ends. */
+void
+scale2x_row_avx2(const Uint32 *prev, const Uint32 *cur, const Uint32 *next,
+                 Uint32 *out0, Uint32 *out1, int count)
+{
+    const __m256i mm256_ones = _mm256_set1_epi32(-1);
+    __m256i mm256_b, mm256_d, mm256_e, mm256_f, mm256_h;
+    __m256i mm256_cond, mm256_db, mm256_bf, mm256_dh, mm256_hf;
+    __m256i mm256_e0, mm256_e1, mm256_lo, mm256_hi;
+    int x;
+
+    for (x = 0; x < count; x += 8) {
+        _PG_SCALEX_LOAD_AVX2(x)
+
+        /* unpacking works within the 128 bit lanes */
+        mm256_e0 = _PG_SELECT_SI256(mm256_db, mm256_d, mm256_e);
+        mm256_e1 = _PG_SELECT_SI256(mm256_bf, mm256_f, mm256_e);
+        mm256_lo = _mm256_unpacklo_epi32(mm256_e0, mm256_e1);
+        mm256_hi = _mm256_unpackhi_epi32(mm256_e0, mm256_e1);
+        _mm256_storeu_si256((__m256i *)(out0 + x * 2),
+                            _mm256_permute2x128_si256(mm256_lo, mm256_hi,
+                                                      0x20));
+        _mm256_storeu_si256((__m256i *)(out0 + x * 2 + 8),
+                            _mm256_permute2x128_si256(mm256_lo, mm256_hi,
+                                                      0x31));
+
+        mm256_e0 = _PG_SELECT_SI256(mm256_dh, mm256_d, mm256_e);
+        mm256_e1 = _PG_SELECT_SI256(mm256_hf, mm256_f, mm256_e);
+        mm256_lo = _mm256_unpacklo_epi32(mm256_e0, mm256_e1);
+        mm256_hi = _mm256_unpackhi_epi32(mm256_e0, mm256_e1);
+        _mm256_storeu_si256((__m256i *)(out1 + x * 2),
+                            _mm256_permute2x128_si256(mm256_lo, mm256_hi,
+                                                      0x20));
+        _mm256_storeu_si256((__m256i *)(out1 + x * 2 + 8),
+                            _mm256_permute2x128_si256(mm256_lo, mm256_hi,
+                                                      0x31));
+    }
+}
+
+/* Interleaves the lanes of three vectors, storing a0 b0 c0 a1 b1 c1 ... */
+static PG_FORCEINLINE void
+_scale3x_store_avx2(Uint32 *dst, __m256i a, __m256i b, __m256i c)
+{
+    __m256 lo = _mm256_castsi256_ps(_mm256_unpacklo_epi32(a, b));
+    __m256 hi = _mm256_castsi256_ps(_mm256_unpackhi_epi32(a, b));
+    __m256 mid = _mm256_shuffle_ps(_mm256_castsi256_ps(c), lo,
+                                   _PG_SIMD_SHUFFLE(3, 2, 1, 0));
+    __m256 end = _mm256_shuffle_ps(_mm256_castsi256_ps(c), hi,
+                                   _PG_SIMD_SHUFFLE(3, 2, 3, 2));
+    __m256 out0, out1, out2;
+
+    /* the pixels of each 128 bit lane, as in _scale3x_store_sse2 */
+    out0 = _mm256_shuffle_ps(lo, mid, _PG_SIMD_SHUFFLE(2, 0, 1, 0));
+    out1 = _mm256_shuffle_ps(mid, hi, _PG_SIMD_SHUFFLE(1, 0, 1, 3));
+    out2 = _mm256_shuffle_ps(end, end, _PG_SIMD_SHUFFLE(1, 3, 2, 0));
+    _mm256_storeu_ps((float *)dst, _mm256_permute2f128_ps(out0, out1, 0x20));
+    _mm256_storeu_ps((float *)(dst + 8),
+                     _mm256_permute2f128_ps(out2, out0, 0x30));
+    _mm256_storeu_ps((float *)(dst + 16),
+                     _mm256_permute2f128_ps(out1, out2, 0x31));
+}
+
+/* Triples count pixels of a row of 32 bit pixels for transform.scale3x,
+ * count being a multiple of 8. prev, cur and next are the rows above, at
+ * and below, each readable one pixel past both ends. */
+void
+scale3x_row_avx2(const Uint32 *prev, const Uint32 *cur, const Uint32 *next,
+                 Uint32 *out0, Uint32 *out1, Uint32 *out2, int count)
+{
+    const __m256i mm256_ones = _mm256_set1_epi32(-1);
+    __m256i mm256_b, mm256_d, mm256_e, mm256_f, mm256_h;
+    __m256i mm256_cond, mm256_db, mm256_bf, mm256_dh, mm256_hf;
+    __m256i mm256_ea, mm256_ec, mm256_eg, mm256_ei;
+    int x;
+
+    for (x = 0; x < count; x += 8) {
+        _PG_SCALEX_LOAD_AVX2(x)
+        mm256_ea = _mm256_cmpeq_epi32(
+            mm256_e, _mm256_loadu_si256((const __m256i *)(prev + x - 1)));
+        mm256_ec = _mm256_cmpeq_epi32(
+            mm256_e, _mm256_loadu_si256((const __m256i *)(prev + x + 1)));
+        mm256_eg = _mm256_cmpeq_epi32(
+            mm256_e, _mm256_loadu_si256((const __m256i *)(next + x - 1)));
+        mm256_ei = _mm256_cmpeq_epi32(
+            mm256_e, _mm256_loadu_si256((const __m256i *)(next + x + 1)));
+
+        _scale3x_store_avx2(
+            out0 + x * 3, _PG_SELECT_SI256(mm256_db, mm256_d, mm256_e),
+            _PG_SELECT_SI256(
+                _mm256_or_si256(_mm256_andnot_si256(mm256_ec, mm256_db),
+                                _mm256_andnot_si256(mm256_ea, mm256_bf)),
+                mm256_b, mm256_e),
+            _PG_SELECT_SI256(mm256_bf, mm256_f, mm256_e));
+        _scale3x_store_avx2(
+            out1 + x * 3,
+            _PG_SELECT_SI256(
+                _mm256_or_si256(_mm256_andnot_si256(mm256_eg, mm256_db),
+                                _mm256_andnot_si256(mm256_ea, mm256_dh)),
+                mm256_d, mm256_e),
+            mm256_e,
+            _PG_SELECT_SI256(
+                _mm256_or_si256(_mm256_andnot_si256(mm256_ei, mm256_bf),
+                                _mm256_andnot_si256(mm256_ec, mm256_hf)),
+                mm256_f, mm256_e));
+        _scale3x_store_avx2(
+            out2 + x * 3, _PG_SELECT_SI256(mm256_dh, mm256_d, mm256_e),
+            _PG_SELECT_SI256(
+                _mm256_or_si256(_mm256_andnot_si256(mm256_ei, mm256_dh),
+                                _mm256_andnot_si256(mm256_eg, mm256_hf)),
+                mm256_h, mm256_e),
+            _PG_SELECT_SI256(mm256_hf, mm256_f, mm256_e));
+    }
+}
 #else
 void
 grayscale_avx2(SDL_Surface *src, PG_PixelFormat *src_fmt, SDL_Surface *newsurf)
@@ -308,5 +1204,75 @@ invert_avx2(SDL_Surface *src, PG_PixelFormat *src_fmt, SDL_Surface *newsurf)
 {
     BAD_AVX2_FUNCTION_CALL;
 }
+void
+filter_shrink_X_AVX2(Uint8 *srcpix, Uint8 *dstpix, int height, int srcpitch,
+                     int dstpitch, int srcwidth, int dstwidth)
+{
+    BAD_AVX2_FUNCTION_CALL;
+}
+void
+filter_shrink_Y_AVX2(Uint8 *srcpix, Uint8 *dstpix, int width, int srcpitch,
+                     int dstpitch, int srcheight, int dstheight)
+{
+    BAD_AVX2_FUNCTION_CALL;
+}
+void
+filter_expand_X_AVX2(Uint8 *srcpix, Uint8 *dstpix, int height, int srcpitch,
+                     int dstpitch, int srcwidth, int dstwidth)
+{
+    BAD_AVX2_FUNCTION_CALL;
+}
+void
+filter_expand_Y_AVX2(Uint8 *srcpix, Uint8 *dstpix, int width, int srcpitch,
+                     int dstpitch, int srcheight, int dstheight)
+{
+    BAD_AVX2_FUNCTION_CALL;
+}
+void
+convolve_h_avx2(Sint32 *acc, const Sint16 *row, int width,
+                const Sint16 *taps, int count)
+{
+    BAD_AVX2_FUNCTION_CALL;
+}
+void
+convolve_v_avx2(Sint32 *acc, const Sint16 *row0, const Sint16 *row1,
+                int weight0, int weight1, int count)
+{
+    BAD_AVX2_FUNCTION_CALL;
+}
+void
+colorlut_row_avx2(const Uint8 *src, Uint8 *dst, int count, const Uint32 *lut)
+{
+    BAD_AVX2_FUNCTION_CALL;
+}
+void
+colormatrix_row_avx2(const Uint8 *src, Uint8 *dst, int count,
+                     const Sint16 *matrix, const Sint32 *offsets)
+{
+    BAD_AVX2_FUNCTION_CALL;
+}
+void
+modify_hsl_avx2(const Uint8 *src, Uint8 *dst, int count, const int *shifts,
+                float h, float s, float l)
+{
+    BAD_AVX2_FUNCTION_CALL;
+}
+void
+mipmap_row_avx2(const Uint8 *row0, const Uint8 *row1, Uint8 *dst, int width)
+{
+    BAD_AVX2_FUNCTION_CALL;
+}
+void
+scale2x_row_avx2(const Uint32 *prev, const Uint32 *cur, const Uint32 *next,
+                 Uint32 *out0, Uint32 *out1, int count)
+{
+    BAD_AVX2_FUNCTION_CALL;
+}
+void
+scale3x_row_avx2(const Uint32 *prev, const Uint32 *cur, const Uint32 *next,
+                 Uint32 *out0, Uint32 *out1, Uint32 *out2, int count)
+{
+    BAD_AVX2_FUNCTION_CALL;
+}
 #endif /* defined(__AVX2__) && defined(HAVE_IMMINTRIN_H) && \
           !defined(SDL_DISABLE_IMMINTRIN_H) */
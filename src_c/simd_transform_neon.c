@@ -0,0 +1,473 @@
+#include "simd_transform.h"
+
+#if PG_ENABLE_NATIVE_NEON
+#include <arm_neon.h>
+#endif /* PG_ENABLE_NATIVE_NEON */
+
+#define BAD_NEON_FUNCTION_CALL                                              \
+    printf(                                                                 \
+        "Fatal Error: Attempted calling a NEON function when both compile " \
+        "time and runtime support is missing. If you are seeing this "      \
+        "message, you have stumbled across a pygame bug, please report it " \
+        "to the devs!");                                                    \
+    PG_EXIT(1)
+
+/* Native arm64 versions of the functions in simd_transform_sse2.c. They
+ * give exactly the same results as the SSE2 ones, see there for more
+ * detailed explanations of the math. */
+
+#if PG_ENABLE_NATIVE_NEON
+
+/* Runs PIXEL_CODE over every pixel of src, four pixels at a time. PIXEL_CODE
+ * takes pixels_src and puts its results in pixels_dst. The last 1-3 pixels
+ * of a row go through a small buffer, so nothing past the end of a row is
+ * ever read or written. */
+#define RUN_NEON_PIXEL_OP(PIXEL_CODE)                                    \
+    {                                                                    \
+        const int n_iters_4 = src->w / 4;                                \
+        const int pxl_excess = src->w % 4;                               \
+        Uint8 _tail[16] = {0};                                           \
+        int x, y;                                                        \
+                                                                         \
+        for (y = 0; y < src->h; y++) {                                   \
+            Uint8 *srcp = (Uint8 *)src->pixels + y * src->pitch;         \
+            Uint8 *dstp = (Uint8 *)newsurf->pixels + y * newsurf->pitch; \
+                                                                         \
+            for (x = 0; x < n_iters_4; x++) {                            \
+                pixels_src = vld1q_u8(srcp);                             \
+                                                                         \
+                {PIXEL_CODE}                                             \
+                                                                         \
+                vst1q_u8(dstp, pixels_dst);                              \
+                srcp += 16;                                              \
+                dstp += 16;                                              \
+            }                                                            \
+            if (pxl_excess) {                                            \
+                memcpy(_tail, srcp, pxl_excess * 4);                     \
+                pixels_src = vld1q_u8(_tail);                            \
+                                                                         \
+                {PIXEL_CODE}                                             \
+                                                                         \
+                vst1q_u8(_tail, pixels_dst);                             \
+                memcpy(dstp, _tail, pxl_excess * 4);                     \
+            }                                                            \
+        }                                                                \
+    }
+
+/* The high 16 bits of each 16x16 bit product, like _mm_mulhi_epu16 */
+static inline uint16x8_t
+_pg_neon_mulhi_u16(uint16x8_t a, uint16x8_t b)
+{
+    uint32x4_t lo = vmull_u16(vget_low_u16(a), vget_low_u16(b));
+    uint32x4_t hi = vmull_high_u16(a, b);
+
+    return vuzp2q_u16(vreinterpretq_u16_u32(lo), vreinterpretq_u16_u32(hi));
+}
+
+static inline uint8x16_t
+_pg_neon_load_4_rows(Uint8 *row0, Uint8 *row1, Uint8 *row2, Uint8 *row3)
+{
+    uint32x4_t pixels = vdupq_n_u32(0);
+    Uint32 pixel;
+
+    memcpy(&pixel, row0, 4);
+    pixels = vsetq_lane_u32(pixel, pixels, 0);
+    memcpy(&pixel, row1, 4);
+    pixels = vsetq_lane_u32(pixel, pixels, 1);
+    memcpy(&pixel, row2, 4);
+    pixels = vsetq_lane_u32(pixel, pixels, 2);
+    memcpy(&pixel, row3, 4);
+    pixels = vsetq_lane_u32(pixel, pixels, 3);
+    return vreinterpretq_u8_u32(pixels);
+}
+
+void
+filter_shrink_X_NEON(Uint8 *srcpix, Uint8 *dstpix, int height, int srcpitch,
+                     int dstpitch, int srcwidth, int dstwidth)
+{
+    // Like the SSE2 filter this runs several rows at once, since the pixels
+    // within a row depend on each other. With NEON that is four rows, two in
+    // each accumulator.
+    int x, y, row;
+    Uint8 *srcrows[4], *dstrows[4];
+    uint8x16_t src;
+    uint16x8_t src01, src23, dst01, dst23, acc01, acc23;
+
+    int xspace = 0x04000 * srcwidth / dstwidth; /* must be > 1 */
+    const uint16x8_t xrecip = vdupq_n_u16((Uint16)(0x40000000 / xspace));
+
+    for (y = 0; y < height; y += 4) {
+        int xcounter = xspace;
+
+        // Rows past the end of the surface repeat the last one, which just
+        // writes the same result twice
+        for (row = 0; row < 4; row++) {
+            int r = (y + row < height) ? y + row : height - 1;
+            srcrows[row] = srcpix + r * srcpitch;
+            dstrows[row] = dstpix + r * dstpitch;
+        }
+        acc01 = vdupq_n_u16(0);
+        acc23 = vdupq_n_u16(0);
+
+        for (x = 0; x < srcwidth; x++) {
+            src = _pg_neon_load_4_rows(srcrows[0], srcrows[1], srcrows[2],
+                                       srcrows[3]);
+            src01 = vmovl_u8(vget_low_u8(src));
+            src23 = vmovl_high_u8(src);
+            for (row = 0; row < 4; row++) {
+                srcrows[row] += 4;
+            }
+
+            if (xcounter > 0x04000) {
+                acc01 = vaddq_u16(acc01, src01);
+                acc23 = vaddq_u16(acc23, src23);
+                xcounter -= 0x04000;
+            }
+            /* write out a destination pixel */
+            else {
+                int xfrac = 0x04000 - xcounter;
+                const uint16x8_t mm_xcounter = vdupq_n_u16(xcounter);
+                const uint16x8_t mm_xfrac = vdupq_n_u16(xfrac);
+                uint8x16_t dst;
+
+                src01 = vshlq_n_u16(src01, 2);
+                src23 = vshlq_n_u16(src23, 2);
+                dst01 = vaddq_u16(_pg_neon_mulhi_u16(src01, mm_xcounter),
+                                  acc01);
+                dst23 = vaddq_u16(_pg_neon_mulhi_u16(src23, mm_xcounter),
+                                  acc23);
+                acc01 = _pg_neon_mulhi_u16(src01, mm_xfrac);
+                acc23 = _pg_neon_mulhi_u16(src23, mm_xfrac);
+                dst01 = _pg_neon_mulhi_u16(dst01, xrecip);
+                dst23 = _pg_neon_mulhi_u16(dst23, xrecip);
+
+                dst = vqmovn_high_u16(vqmovn_u16(dst01), dst23);
+                for (row = 0; row < 4; row++) {
+                    Uint32 pixel =
+                        vgetq_lane_u32(vreinterpretq_u32_u8(dst), 0);
+                    memcpy(dstrows[row], &pixel, 4);
+                    dstrows[row] += 4;
+                    dst = vextq_u8(dst, dst, 4);
+                }
+                xcounter = xspace - xfrac;
+            }
+        }
+    }
+}
+
+void
+filter_shrink_Y_NEON(Uint8 *srcpix, Uint8 *dstpix, int width, int srcpitch,
+                     int dstpitch, int srcheight, int dstheight)
+{
+    // Each pixel of a row is independent here, so this runs 4 pixels at a
+    // time, then the rest of the row 1 pixel at a time.
+    int srcdiff = srcpitch - (width * 4);
+    int dstdiff = dstpitch - (width * 4);
+    int x, y;
+    uint8x16_t src;
+    uint16x8_t src_lo, src_hi, dst_lo, dst_hi;
+    uint16x4_t src_px, dst_px;
+
+    int during_4_width = width / 4;
+    int post_4_width = width % 4;
+
+    int yspace = 0x04000 * srcheight / dstheight; /* must be > 1 */
+    const uint16x8_t yrecip = vdupq_n_u16(0x40000000 / yspace);
+    int ycounter = yspace;
+
+    Uint16 *templine;
+    /* allocate a clear memory area for storing the accumulator line */
+    templine = (Uint16 *)calloc(dstpitch, 2);
+    if (templine == NULL) {
+        return;
+    }
+
+    for (y = 0; y < srcheight; y++) {
+        Uint16 *accumulate = templine;
+        if (ycounter > 0x04000) {
+            for (x = 0; x < during_4_width; x++) {
+                src = vld1q_u8(srcpix);
+                vst1q_u16(accumulate, vaddw_u8(vld1q_u16(accumulate),
+                                               vget_low_u8(src)));
+                vst1q_u16(accumulate + 8,
+                          vaddw_high_u8(vld1q_u16(accumulate + 8), src));
+                accumulate += 16;
+                srcpix += 16;
+            }
+            for (x = 0; x < post_4_width * 4; x++) {
+                *accumulate++ += *srcpix++;
+            }
+            ycounter -= 0x04000;
+        }
+        else {
+            int yfrac = 0x04000 - ycounter;
+            const uint16x8_t mm_yfrac = vdupq_n_u16(yfrac);
+            const uint16x8_t mm_ycounter = vdupq_n_u16(ycounter);
+
+            /* write out a destination line */
+            for (x = 0; x < during_4_width; x++) {
+                src = vld1q_u8(srcpix);
+                srcpix += 16;
+                src_lo = vshll_n_u8(vget_low_u8(src), 2);
+                src_hi = vshll_high_n_u8(src, 2);
+
+                dst_lo = vaddq_u16(_pg_neon_mulhi_u16(src_lo, mm_ycounter),
+                                   vld1q_u16(accumulate));
+                dst_hi = vaddq_u16(_pg_neon_mulhi_u16(src_hi, mm_ycounter),
+                                   vld1q_u16(accumulate + 8));
+                vst1q_u16(accumulate, _pg_neon_mulhi_u16(src_lo, mm_yfrac));
+                vst1q_u16(accumulate + 8,
+                          _pg_neon_mulhi_u16(src_hi, mm_yfrac));
+                accumulate += 16;
+
+                dst_lo = _pg_neon_mulhi_u16(dst_lo, yrecip);
+                dst_hi = _pg_neon_mulhi_u16(dst_hi, yrecip);
+                vst1q_u8(dstpix,
+                         vqmovn_high_u16(vqmovn_u16(dst_lo), dst_hi));
+                dstpix += 16;
+            }
+            for (x = 0; x < post_4_width; x++) {
+                Uint32 pixel;
+                memcpy(&pixel, srcpix, 4);
+                srcpix += 4;
+                src_px = vget_low_u16(vmovl_u8(
+                    vreinterpret_u8_u32(vdup_n_u32(pixel))));
+                src_px = vshl_n_u16(src_px, 2);
+
+                dst_px = vshrn_n_u32(
+                    vmull_u16(src_px, vget_low_u16(mm_ycounter)), 16);
+                dst_px = vadd_u16(dst_px, vld1_u16(accumulate));
+                vst1_u16(accumulate,
+                         vshrn_n_u32(
+                             vmull_u16(src_px, vget_low_u16(mm_yfrac)), 16));
+                accumulate += 4;
+
+                dst_px = vshrn_n_u32(
+                    vmull_u16(dst_px, vget_low_u16(yrecip)), 16);
+                pixel = vget_lane_u32(
+                    vreinterpret_u32_u8(vqmovn_u16(vcombine_u16(dst_px,
+                                                                dst_px))),
+                    0);
+                memcpy(dstpix, &pixel, 4);
+                dstpix += 4;
+            }
+            dstpix += dstdiff;
+            ycounter = yspace - yfrac;
+        }
+        srcpix += srcdiff;
+    }
+
+    /* free the temporary memory */
+    free(templine);
+}
+
+void
+filter_expand_X_NEON(Uint8 *srcpix, Uint8 *dstpix, int height, int srcpitch,
+                     int dstpitch, int srcwidth, int dstwidth)
+{
+    int dstdiff = dstpitch - (dstwidth * 4);
+    int *xidx0;
+    Uint16 *xmult;
+    int x, y;
+
+    /* Allocate memory for factors */
+    xidx0 = malloc(dstwidth * sizeof(int));
+    if (xidx0 == NULL) {
+        return;
+    }
+    // xm0 and xm1 for every destination pixel, next to each other
+    xmult = (Uint16 *)malloc(dstwidth * 2 * sizeof(Uint16));
+    if (xmult == NULL) {
+        free(xidx0);
+        return;
+    }
+
+    /* Create multiplier factors and starting indices and put them in arrays */
+    for (x = 0; x < dstwidth; x++) {
+        int xm1 = 0x100 * ((x * (srcwidth - 1)) % dstwidth) / dstwidth;
+        int xm0 = 0x100 - xm1;
+        xidx0[x] = x * (srcwidth - 1) / dstwidth;
+        xmult[x * 2] = (Uint16)xm0;
+        xmult[x * 2 + 1] = (Uint16)xm1;
+    }
+
+    uint16x8_t src_a, src_b;
+    uint16x4_t dst_a, dst_b;
+
+    /* Do the scaling in raster order so we don't trash the cache */
+    for (y = 0; y < height; y++) {
+        Uint8 *srcrow0 = srcpix + y * srcpitch;
+
+        // two destination pixels at a time, each one is made of a pair of
+        // neighbouring source pixels
+        for (x = 0; x + 1 < dstwidth; x += 2) {
+            src_a = vmovl_u8(vld1_u8(srcrow0 + xidx0[x] * 4));
+            src_b = vmovl_u8(vld1_u8(srcrow0 + xidx0[x + 1] * 4));
+
+            dst_a = vmul_n_u16(vget_low_u16(src_a), xmult[x * 2]);
+            dst_a = vmla_n_u16(dst_a, vget_high_u16(src_a), xmult[x * 2 + 1]);
+            dst_b = vmul_n_u16(vget_low_u16(src_b), xmult[x * 2 + 2]);
+            dst_b = vmla_n_u16(dst_b, vget_high_u16(src_b), xmult[x * 2 + 3]);
+
+            vst1_u8(dstpix, vshrn_n_u16(vcombine_u16(dst_a, dst_b), 8));
+            dstpix += 8;
+        }
+        if (x < dstwidth) {
+            Uint8 *src_p = srcrow0 + xidx0[x] * 4;
+            int i;
+            for (i = 0; i < 4; i++) {
+                *dstpix++ = (Uint8)((src_p[i] * xmult[x * 2] +
+                                     src_p[i + 4] * xmult[x * 2 + 1]) >>
+                                    8);
+            }
+        }
+        dstpix += dstdiff;
+    }
+
+    /* free memory */
+    free(xidx0);
+    free(xmult);
+}
+
+void
+filter_expand_Y_NEON(Uint8 *srcpix, Uint8 *dstpix, int width, int srcpitch,
+                     int dstpitch, int srcheight, int dstheight)
+{
+    int x, y;
+    uint8x16_t src0, src1;
+    uint16x8_t dst_lo, dst_hi;
+
+    int dstdiff = dstpitch - (width * 4);
+
+    int during_4_width = width / 4;
+    int post_4_width = width % 4;
+
+    for (y = 0; y < dstheight; y++) {
+        int yidx0 = y * (srcheight - 1) / dstheight;
+        Uint8 *srcrow0 = srcpix + yidx0 * srcpitch;
+        Uint8 *srcrow1 = srcrow0 + srcpitch;
+        int ymult1 = 0x0100 * ((y * (srcheight - 1)) % dstheight) / dstheight;
+        int ymult0 = 0x0100 - ymult1;
+
+        // ymult0 only goes up to 0xFF when ymult1 isn't 0, so the rest of
+        // the math fits in widening byte multiplies
+        if (ymult1 == 0) {
+            memcpy(dstpix, srcrow0, width * 4);
+            dstpix += dstpitch;
+            continue;
+        }
+
+        const uint8x16_t ymult0_mm = vdupq_n_u8((Uint8)ymult0);
+        const uint8x16_t ymult1_mm = vdupq_n_u8((Uint8)ymult1);
+
+        for (x = 0; x < during_4_width; x++) {
+            src0 = vld1q_u8(srcrow0);
+            src1 = vld1q_u8(srcrow1);
+
+            dst_lo = vmull_u8(vget_low_u8(src0), vget_low_u8(ymult0_mm));
+            dst_hi = vmull_high_u8(src0, ymult0_mm);
+            dst_lo = vmlal_u8(dst_lo, vget_low_u8(src1),
+                              vget_low_u8(ymult1_mm));
+            dst_hi = vmlal_high_u8(dst_hi, src1, ymult1_mm);
+
+            vst1q_u8(dstpix, vshrn_high_n_u16(vshrn_n_u16(dst_lo, 8), dst_hi,
+                                               8));
+
+            srcrow0 += 16;
+            srcrow1 += 16;
+            dstpix += 16;
+        }
+        for (x = 0; x < post_4_width * 4; x++) {
+            *dstpix++ =
+                (Uint8)(((*srcrow0++ * ymult0) + (*srcrow1++ * ymult1)) >> 8);
+        }
+        dstpix += dstdiff;
+    }
+}
+
+void
+grayscale_neon(SDL_Surface *src, PG_PixelFormat *src_fmt, SDL_Surface *newsurf)
+{
+    /* Each channel is weighted with (C * W + 255) >> 8 like the SSE2 version,
+     * then the 4 channels of each pixel are summed with pairwise adds. The
+     * weights sum to 255, so the sum can't overflow. Multiplying the sum by
+     * 0x01010101 copies it into every channel. */
+    const Uint32 rgb_weights =
+        ((0x4C << src_fmt->Rshift) | (0x96 << src_fmt->Gshift) |
+         (0x1D << src_fmt->Bshift));
+    const uint8x16_t weights = vreinterpretq_u8_u32(vdupq_n_u32(rgb_weights));
+    const uint8x16_t alpha_mask =
+        vreinterpretq_u8_u32(vdupq_n_u32(src_fmt->Amask));
+    const uint16x8_t two_five_fives = vdupq_n_u16(255);
+
+    uint8x16_t pixels_src, pixels_dst, weighted;
+    uint32x4_t gray;
+
+    RUN_NEON_PIXEL_OP({
+        weighted = vaddhn_high_u16(
+            vaddhn_u16(
+                vmull_u8(vget_low_u8(pixels_src), vget_low_u8(weights)),
+                two_five_fives),
+            vmull_high_u8(pixels_src, weights), two_five_fives);
+        gray = vpaddlq_u16(vpaddlq_u8(weighted));
+        gray = vmulq_n_u32(gray, 0x01010101);
+        pixels_dst = vbslq_u8(alpha_mask, pixels_src,
+                              vreinterpretq_u8_u32(gray));
+    })
+}
+
+void
+invert_neon(SDL_Surface *src, PG_PixelFormat *src_fmt, SDL_Surface *newsurf)
+{
+    const uint8x16_t alpha_mask =
+        vreinterpretq_u8_u32(vdupq_n_u32(src_fmt->Amask));
+
+    uint8x16_t pixels_src, pixels_dst;
+
+    RUN_NEON_PIXEL_OP({
+        pixels_dst = vbslq_u8(alpha_mask, pixels_src, vmvnq_u8(pixels_src));
+    })
+}
+
+#else
+
+void
+filter_shrink_X_NEON(Uint8 *srcpix, Uint8 *dstpix, int height, int srcpitch,
+                     int dstpitch, int srcwidth, int dstwidth)
+{
+    BAD_NEON_FUNCTION_CALL;
+}
+
+void
+filter_shrink_Y_NEON(Uint8 *srcpix, Uint8 *dstpix, int width, int srcpitch,
+                     int dstpitch, int srcheight, int dstheight)
+{
+    BAD_NEON_FUNCTION_CALL;
+}
+
+void
+filter_expand_X_NEON(Uint8 *srcpix, Uint8 *dstpix, int height, int srcpitch,
+                     int dstpitch, int srcwidth, int dstwidth)
+{
+    BAD_NEON_FUNCTION_CALL;
+}
+
+void
+filter_expand_Y_NEON(Uint8 *srcpix, Uint8 *dstpix, int width, int srcpitch,
+                     int dstpitch, int srcheight, int dstheight)
+{
+    BAD_NEON_FUNCTION_CALL;
+}
+
+void
+grayscale_neon(SDL_Surface *src, PG_PixelFormat *src_fmt, SDL_Surface *newsurf)
+{
+    BAD_NEON_FUNCTION_CALL;
+}
+
+void
+invert_neon(SDL_Surface *src, PG_PixelFormat *src_fmt, SDL_Surface *newsurf)
+{
+    BAD_NEON_FUNCTION_CALL;
+}
+#endif /* PG_ENABLE_NATIVE_NEON */
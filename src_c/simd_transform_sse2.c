@@ -686,4 +686,757 @@ invert_sse2(SDL_Surface *src, PG_PixelFormat *src_fmt, SDL_Surface *newsurf)
     }
 }
 
+
+/* Two 16 bit weights, repeated for each pair of channels */
+#define _PG_WEIGHT_PAIR(w0, w1) \
+    _mm_set1_epi32((Uint16)(w0) | ((Uint32)(Uint16)(w1) << 16))
+
+/* Resamples a row of 32 bit pixels for transform.scale. Destination pixel x
+ * is the sum of counts[x] source pixels from starts[x] on, weighted by the
+ * 2.14 fixed point weights at weights + x * window. Each channel is done on
+ * its own, with _mm_madd_epi16 summing two weighted pixels at once. */
+void
+resample_row_h_sse2(const Uint8 *srcrow, Uint8 *dstrow, int dstwidth,
+                    const int *starts, const int *counts,
+                    const Sint16 *weights, int window)
+{
+    const __m128i mm_zero = _mm_setzero_si128();
+    const __m128i mm_round = _mm_set1_epi32(1 << 13);
+    __m128i mm_pixels, mm_weights, mm_acc;
+    int x, k;
+
+    for (x = 0; x < dstwidth; x++) {
+        const Uint8 *srcp = srcrow + (size_t)starts[x] * 4;
+        const Sint16 *w = weights + (size_t)x * window;
+        int count = counts[x];
+
+        mm_acc = mm_round;
+        for (k = 0; k + 2 <= count; k += 2) {
+            /* channels of the two pixels next to each other */
+            mm_pixels = _mm_unpacklo_epi8(
+                _mm_unpacklo_epi8(_pg_loadu_si32(srcp),
+                                  _pg_loadu_si32(srcp + 4)),
+                mm_zero);
+            mm_weights = _PG_WEIGHT_PAIR(w[k], w[k + 1]);
+            mm_acc =
+                _mm_add_epi32(mm_acc, _mm_madd_epi16(mm_pixels, mm_weights));
+            srcp += 8;
+        }
+        if (k < count) {
+            mm_pixels = _mm_unpacklo_epi8(
+                _mm_unpacklo_epi8(_pg_loadu_si32(srcp), mm_zero), mm_zero);
+            mm_weights = _PG_WEIGHT_PAIR(w[k], 0);
+            mm_acc =
+                _mm_add_epi32(mm_acc, _mm_madd_epi16(mm_pixels, mm_weights));
+        }
+
+        mm_acc = _mm_srai_epi32(mm_acc, 14);
+        mm_acc = _mm_packs_epi32(mm_acc, mm_acc);
+        _pg_storeu_si32(dstrow + (size_t)x * 4,
+                        _mm_packus_epi16(mm_acc, mm_acc));
+    }
+}
+
+/* Resamples a column of rows for transform.scale, the width pixels of the
+ * destination row being the sum of the pixels below each other in count
+ * rows from srcpix on, weighted by the 2.14 fixed point weights. Four pixels
+ * are done at once, the rest like resample_row_h_sse2. */
+void
+resample_row_v_sse2(const Uint8 *srcpix, int srcpitch, Uint8 *dstrow,
+                    int width, int count, const Sint16 *weights)
+{
+    const __m128i mm_zero = _mm_setzero_si128();
+    const __m128i mm_round = _mm_set1_epi32(1 << 13);
+    __m128i mm_row0, mm_row1, mm_lo, mm_hi, mm_weights;
+    __m128i mm_acc0, mm_acc1, mm_acc2, mm_acc3;
+    int x, k;
+
+    for (x = 0; x + 4 <= width; x += 4) {
+        const Uint8 *srcp = srcpix + (size_t)x * 4;
+
+        mm_acc0 = mm_acc1 = mm_acc2 = mm_acc3 = mm_round;
+        for (k = 0; k < count; k += 2) {
+            mm_row0 = _mm_loadu_si128((const __m128i *)srcp);
+            if (k + 1 < count) {
+                mm_row1 = _mm_loadu_si128((const __m128i *)(srcp + srcpitch));
+                mm_weights = _PG_WEIGHT_PAIR(weights[k], weights[k + 1]);
+            }
+            else {
+                mm_row1 = mm_zero;
+                mm_weights = _PG_WEIGHT_PAIR(weights[k], 0);
+            }
+            mm_lo = _mm_unpacklo_epi8(mm_row0, mm_row1);
+            mm_hi = _mm_unpackhi_epi8(mm_row0, mm_row1);
+            mm_acc0 = _mm_add_epi32(
+                mm_acc0,
+                _mm_madd_epi16(_mm_unpacklo_epi8(mm_lo, mm_zero), mm_weights));
+            mm_acc1 = _mm_add_epi32(
+                mm_acc1,
+                _mm_madd_epi16(_mm_unpackhi_epi8(mm_lo, mm_zero), mm_weights));
+            mm_acc2 = _mm_add_epi32(
+                mm_acc2,
+                _mm_madd_epi16(_mm_unpacklo_epi8(mm_hi, mm_zero), mm_weights));
+            mm_acc3 = _mm_add_epi32(
+                mm_acc3,
+                _mm_madd_epi16(_mm_unpackhi_epi8(mm_hi, mm_zero), mm_weights));
+            srcp += (size_t)srcpitch * 2;
+        }
+
+        mm_acc0 = _mm_packs_epi32(_mm_srai_epi32(mm_acc0, 14),
+                                  _mm_srai_epi32(mm_acc1, 14));
+        mm_acc2 = _mm_packs_epi32(_mm_srai_epi32(mm_acc2, 14),
+                                  _mm_srai_epi32(mm_acc3, 14));
+        _mm_storeu_si128((__m128i *)(dstrow + (size_t)x * 4),
+                         _mm_packus_epi16(mm_acc0, mm_acc2));
+    }
+
+    for (; x < width; x++) {
+        const Uint8 *srcp = srcpix + (size_t)x * 4;
+
+        mm_acc0 = mm_round;
+        for (k = 0; k < count; k++) {
+            mm_row0 = _mm_unpacklo_epi8(
+                _mm_unpacklo_epi8(_pg_loadu_si32(srcp), mm_zero), mm_zero);
+            mm_weights = _PG_WEIGHT_PAIR(weights[k], 0);
+            mm_acc0 =
+                _mm_add_epi32(mm_acc0, _mm_madd_epi16(mm_row0, mm_weights));
+            srcp += srcpitch;
+        }
+
+        mm_acc0 = _mm_srai_epi32(mm_acc0, 14);
+        mm_acc0 = _mm_packs_epi32(mm_acc0, mm_acc0);
+        _pg_storeu_si32(dstrow + (size_t)x * 4,
+                        _mm_packus_epi16(mm_acc0, mm_acc0));
+    }
+}
+
+/* Box blurs a row of 32 bit pixels for the fast transform.gaussian_blur,
+ * each pixel becoming the average of the 2 * radius + 1 pixels around it.
+ * The sums of the four channels slide along the row together. Pixels past
+ * the ends are the edge pixels with repeat, or 0. */
+void
+fastblur_row_sse2(const Uint8 *src, Uint8 *dst, int width, int radius,
+                  int repeat)
+{
+    const __m128i mm_zero = _mm_setzero_si128();
+    const __m128 mm_inv = _mm_set1_ps(1.0f / (radius * 2 + 1));
+    const __m128 mm_half = _mm_set1_ps(0.5f);
+    __m128i mm_first, mm_last, mm_sum, mm_out;
+    int x, k;
+
+/* the channels of pixel k as 32 bit lanes */
+#define _PG_BLUR_PIXEL(k)                                                \
+    ((k) < 0                                                             \
+         ? mm_first                                                      \
+         : ((k) >= width ? mm_last                                       \
+                         : _mm_unpacklo_epi16(                           \
+                               _mm_unpacklo_epi8(                        \
+                                   _pg_loadu_si32(src + (size_t)(k) * 4), \
+                                   mm_zero),                             \
+                               mm_zero)))
+
+    mm_first = mm_last = mm_zero;
+    if (repeat) {
+        mm_first = _PG_BLUR_PIXEL(0);
+        mm_last = _PG_BLUR_PIXEL(width - 1);
+    }
+
+    mm_sum = mm_zero;
+    for (k = -radius; k <= radius; k++) {
+        mm_sum = _mm_add_epi32(mm_sum, _PG_BLUR_PIXEL(k));
+    }
+    for (x = 0; x < width; x++) {
+        mm_out = _mm_cvttps_epi32(_mm_add_ps(
+            _mm_mul_ps(_mm_cvtepi32_ps(mm_sum), mm_inv), mm_half));
+        mm_out = _mm_packs_epi32(mm_out, mm_out);
+        _pg_storeu_si32(dst + (size_t)x * 4, _mm_packus_epi16(mm_out, mm_out));
+
+        mm_sum = _mm_add_epi32(mm_sum, _PG_BLUR_PIXEL(x + radius + 1));
+        mm_sum = _mm_sub_epi32(mm_sum, _PG_BLUR_PIXEL(x - radius));
+    }
+#undef _PG_BLUR_PIXEL
+}
+
+/* Box blurs count bytes of each row down the height rows from src into dst,
+ * for the fast transform.gaussian_blur. sums holds the running sum of each
+ * byte. Sixteen bytes are done at once, the rest one by one with the same
+ * rounding. */
+void
+fastblur_columns_sse2(const Uint8 *src, int src_pitch, Uint8 *dst,
+                      int dst_pitch, Uint32 *sums, int height, int count,
+                      int radius, int repeat)
+{
+    const __m128i mm_zero = _mm_setzero_si128();
+    const __m128 mm_inv = _mm_set1_ps(1.0f / (radius * 2 + 1));
+    const __m128 mm_half = _mm_set1_ps(0.5f);
+    const float inv = 1.0f / (radius * 2 + 1);
+    const Uint8 *add, *sub;
+    __m128i mm_lo, mm_hi, mm_sum[4], mm_out[4];
+    int i, j, k, y;
+
+/* row k of src, NULL past the ends without repeat */
+#define _PG_BLUR_ROW(k)                                               \
+    ((k) < 0 ? (repeat ? src : NULL)                                  \
+             : ((k) >= height ? (repeat ? src + (size_t)(height - 1) * \
+                                                  src_pitch            \
+                                        : NULL)                       \
+                              : src + (size_t)(k) * src_pitch))
+
+    memset(sums, 0, sizeof(Uint32) * count);
+    for (k = -radius; k <= radius; k++) {
+        add = _PG_BLUR_ROW(k);
+        if (add) {
+            for (i = 0; i < count; i++) {
+                sums[i] += add[i];
+            }
+        }
+    }
+
+    for (y = 0; y < height; y++) {
+        Uint8 *dstrow = dst + (size_t)y * dst_pitch;
+
+        add = _PG_BLUR_ROW(y + radius + 1);
+        sub = _PG_BLUR_ROW(y - radius);
+        for (i = 0; i + 16 <= count; i += 16) {
+            for (j = 0; j < 4; j++) {
+                mm_sum[j] = _mm_loadu_si128((__m128i *)(sums + i + j * 4));
+                mm_out[j] = _mm_cvttps_epi32(_mm_add_ps(
+                    _mm_mul_ps(_mm_cvtepi32_ps(mm_sum[j]), mm_inv), mm_half));
+            }
+            mm_lo = _mm_packs_epi32(mm_out[0], mm_out[1]);
+            mm_hi = _mm_packs_epi32(mm_out[2], mm_out[3]);
+            _mm_storeu_si128((__m128i *)(dstrow + i),
+                             _mm_packus_epi16(mm_lo, mm_hi));
+
+            if (add) {
+                mm_lo = _mm_loadu_si128((const __m128i *)(add + i));
+                mm_hi = _mm_unpackhi_epi8(mm_lo, mm_zero);
+                mm_lo = _mm_unpacklo_epi8(mm_lo, mm_zero);
+                mm_sum[0] = _mm_add_epi32(
+                    mm_sum[0], _mm_unpacklo_epi16(mm_lo, mm_zero));
+                mm_sum[1] = _mm_add_epi32(
+                    mm_sum[1], _mm_unpackhi_epi16(mm_lo, mm_zero));
+                mm_sum[2] = _mm_add_epi32(
+                    mm_sum[2], _mm_unpacklo_epi16(mm_hi, mm_zero));
+                mm_sum[3] = _mm_add_epi32(
+                    mm_sum[3], _mm_unpackhi_epi16(mm_hi, mm_zero));
+            }
+            if (sub) {
+                mm_lo = _mm_loadu_si128((const __m128i *)(sub + i));
+                mm_hi = _mm_unpackhi_epi8(mm_lo, mm_zero);
+                mm_lo = _mm_unpacklo_epi8(mm_lo, mm_zero);
+                mm_sum[0] = _mm_sub_epi32(
+                    mm_sum[0], _mm_unpacklo_epi16(mm_lo, mm_zero));
+                mm_sum[1] = _mm_sub_epi32(
+                    mm_sum[1], _mm_unpackhi_epi16(mm_lo, mm_zero));
+                mm_sum[2] = _mm_sub_epi32(
+                    mm_sum[2], _mm_unpacklo_epi16(mm_hi, mm_zero));
+                mm_sum[3] = _mm_sub_epi32(
+                    mm_sum[3], _mm_unpackhi_epi16(mm_hi, mm_zero));
+            }
+            for (j = 0; j < 4; j++) {
+                _mm_storeu_si128((__m128i *)(sums + i + j * 4), mm_sum[j]);
+            }
+        }
+        for (; i < count; i++) {
+            dstrow[i] = (Uint8)((float)sums[i] * inv + 0.5f);
+            if (add) {
+                sums[i] += add[i];
+            }
+            if (sub) {
+                sums[i] -= sub[i];
+            }
+        }
+    }
+#undef _PG_BLUR_ROW
+}
+
+/* Adds a row convolved with taps to the accumulators of transform.convolve.
+ * row holds width + count - 1 pixels of four 16 bit channels, and each of
+ * the width accumulated pixels gets the sum of the count pixels from its own
+ * position on, weighted by taps. Two pixels are done at once, with
+ * _mm_madd_epi16 weighting the same channel of two pixels in one go. */
+void
+convolve_h_sse2(Sint32 *acc, const Sint16 *row, int width,
+                const Sint16 *taps, int count)
+{
+    const __m128i mm_zero = _mm_setzero_si128();
+    __m128i mm_a, mm_b, mm_weights, mm_acc0, mm_acc1;
+    int x, k, c;
+
+    for (x = 0; x + 2 <= width; x += 2) {
+        const Sint16 *srcp = row + (size_t)x * 4;
+
+        mm_acc0 = _mm_loadu_si128((__m128i *)(acc + (size_t)x * 4));
+        mm_acc1 = _mm_loadu_si128((__m128i *)(acc + (size_t)x * 4 + 4));
+        for (k = 0; k + 2 <= count; k += 2) {
+            /* pixels k and k + 1, and pixels k + 1 and k + 2 */
+            mm_a = _mm_loadu_si128((const __m128i *)(srcp + k * 4));
+            mm_b = _mm_loadu_si128((const __m128i *)(srcp + k * 4 + 4));
+            mm_weights = _PG_WEIGHT_PAIR(taps[k], taps[k + 1]);
+            mm_acc0 = _mm_add_epi32(
+                mm_acc0, _mm_madd_epi16(_mm_unpacklo_epi16(mm_a, mm_b),
+                                        mm_weights));
+            mm_acc1 = _mm_add_epi32(
+                mm_acc1, _mm_madd_epi16(_mm_unpackhi_epi16(mm_a, mm_b),
+                                        mm_weights));
+        }
+        if (k < count) {
+            mm_a = _mm_loadu_si128((const __m128i *)(srcp + k * 4));
+            mm_weights = _PG_WEIGHT_PAIR(taps[k], 0);
+            mm_acc0 = _mm_add_epi32(
+                mm_acc0, _mm_madd_epi16(_mm_unpacklo_epi16(mm_a, mm_zero),
+                                        mm_weights));
+            mm_acc1 = _mm_add_epi32(
+                mm_acc1, _mm_madd_epi16(_mm_unpackhi_epi16(mm_a, mm_zero),
+                                        mm_weights));
+        }
+        _mm_storeu_si128((__m128i *)(acc + (size_t)x * 4), mm_acc0);
+        _mm_storeu_si128((__m128i *)(acc + (size_t)x * 4 + 4), mm_acc1);
+    }
+
+    for (; x < width; x++) {
+        for (c = 0; c < 4; c++) {
+            const Sint16 *srcp = row + (size_t)x * 4 + c;
+            Sint32 sum = 0;
+
+            for (k = 0; k < count; k++) {
+                sum += taps[k] * srcp[k * 4];
+            }
+            acc[(size_t)x * 4 + c] += sum;
+        }
+    }
+}
+
+/* Adds two rows of count 16 bit values, weighted by weight0 and weight1, to
+ * the accumulators of transform.convolve */
+void
+convolve_v_sse2(Sint32 *acc, const Sint16 *row0, const Sint16 *row1,
+                int weight0, int weight1, int count)
+{
+    const __m128i mm_weights = _PG_WEIGHT_PAIR(weight0, weight1);
+    __m128i mm_a, mm_b;
+    int i;
+
+    for (i = 0; i + 8 <= count; i += 8) {
+        mm_a = _mm_loadu_si128((const __m128i *)(row0 + i));
+        mm_b = _mm_loadu_si128((const __m128i *)(row1 + i));
+        _mm_storeu_si128(
+            (__m128i *)(acc + i),
+            _mm_add_epi32(_mm_loadu_si128((__m128i *)(acc + i)),
+                          _mm_madd_epi16(_mm_unpacklo_epi16(mm_a, mm_b),
+                                         mm_weights)));
+        _mm_storeu_si128(
+            (__m128i *)(acc + i + 4),
+            _mm_add_epi32(_mm_loadu_si128((__m128i *)(acc + i + 4)),
+                          _mm_madd_epi16(_mm_unpackhi_epi16(mm_a, mm_b),
+                                         mm_weights)));
+    }
+    for (; i < count; i++) {
+        acc[i] += weight0 * row0[i] + weight1 * row1[i];
+    }
+}
+
+/* Rounds the count accumulators of transform.convolve to fixed point with
+ * shift fraction bits, and saturates them to 16 bit values in dst16, or to
+ * 8 bit values in dst8 when dst16 is NULL */
+void
+convolve_finish_sse2(const Sint32 *acc, Sint16 *dst16, Uint8 *dst8,
+                     int count, int shift)
+{
+    const __m128i mm_round = _mm_set1_epi32(shift ? 1 << (shift - 1) : 0);
+    const __m128i mm_shift = _mm_cvtsi32_si128(shift);
+    __m128i mm_lo, mm_hi;
+    int i;
+
+    for (i = 0; i + 8 <= count; i += 8) {
+        mm_lo = _mm_loadu_si128((const __m128i *)(acc + i));
+        mm_hi = _mm_loadu_si128((const __m128i *)(acc + i + 4));
+        mm_lo = _mm_sra_epi32(_mm_add_epi32(mm_lo, mm_round), mm_shift);
+        mm_hi = _mm_sra_epi32(_mm_add_epi32(mm_hi, mm_round), mm_shift);
+        mm_lo = _mm_packs_epi32(mm_lo, mm_hi);
+        if (dst16) {
+            _mm_storeu_si128((__m128i *)(dst16 + i), mm_lo);
+        }
+        else {
+            _mm_storel_epi64((__m128i *)(dst8 + i),
+                             _mm_packus_epi16(mm_lo, mm_lo));
+        }
+    }
+    for (; i < count; i++) {
+        Sint32 value = (acc[i] + (shift ? 1 << (shift - 1) : 0)) >> shift;
+
+        if (dst16) {
+            dst16[i] = (Sint16)MIN(MAX(value, -32768), 32767);
+        }
+        else {
+            dst8[i] = (Uint8)MIN(MAX(value, 0), 255);
+        }
+    }
+}
+
+/* Applies the color matrix of transform.color_matrix to count 32 bit pixels.
+ * Each output byte o is the sum of matrix[o * 4 + i] times input byte i, in
+ * 12 bit fixed point, plus offsets[o]. The two pairs of input bytes of a
+ * pixel are broadcast and weighted with _mm_madd_epi16 for all four outputs
+ * at once. src and dst may be the same. */
+void
+colormatrix_row_sse2(const Uint8 *src, Uint8 *dst, int count,
+                     const Sint16 *matrix, const Sint32 *offsets)
+{
+    const __m128i mm_zero = _mm_setzero_si128();
+    const __m128i mm_w01 = _mm_set_epi16(
+        matrix[13], matrix[12], matrix[9], matrix[8], matrix[5], matrix[4],
+        matrix[1], matrix[0]);
+    const __m128i mm_w23 = _mm_set_epi16(
+        matrix[15], matrix[14], matrix[11], matrix[10], matrix[7], matrix[6],
+        matrix[3], matrix[2]);
+    const __m128i mm_offsets = _mm_loadu_si128((const __m128i *)offsets);
+    __m128i mm_src, mm_lo, mm_hi, mm_px0, mm_px1, mm_px2, mm_px3;
+    int i;
+
+#define _PG_MATRIX_PIXEL(pixels, shuffle01, shuffle23)                     \
+    _mm_srai_epi32(                                                         \
+        _mm_add_epi32(                                                      \
+            _mm_add_epi32(                                                  \
+                _mm_madd_epi16(_mm_shuffle_epi32(pixels, shuffle01),        \
+                               mm_w01),                                     \
+                _mm_madd_epi16(_mm_shuffle_epi32(pixels, shuffle23),        \
+                               mm_w23)),                                    \
+            mm_offsets),                                                    \
+        12)
+
+    for (i = 0; i + 4 <= count; i += 4) {
+        mm_src = _mm_loadu_si128((const __m128i *)(src + i * 4));
+        mm_lo = _mm_unpacklo_epi8(mm_src, mm_zero);
+        mm_hi = _mm_unpackhi_epi8(mm_src, mm_zero);
+        mm_px0 = _PG_MATRIX_PIXEL(mm_lo, 0x00, 0x55);
+        mm_px1 = _PG_MATRIX_PIXEL(mm_lo, 0xAA, 0xFF);
+        mm_px2 = _PG_MATRIX_PIXEL(mm_hi, 0x00, 0x55);
+        mm_px3 = _PG_MATRIX_PIXEL(mm_hi, 0xAA, 0xFF);
+        _mm_storeu_si128((__m128i *)(dst + i * 4),
+                         _mm_packus_epi16(_mm_packs_epi32(mm_px0, mm_px1),
+                                          _mm_packs_epi32(mm_px2, mm_px3)));
+    }
+    for (; i < count; i++) {
+        mm_lo = _mm_unpacklo_epi8(_pg_loadu_si32(src + i * 4), mm_zero);
+        mm_px0 = _PG_MATRIX_PIXEL(mm_lo, 0x00, 0x55);
+        mm_px0 = _mm_packs_epi32(mm_px0, mm_px0);
+        _pg_storeu_si32(dst + i * 4, _mm_packus_epi16(mm_px0, mm_px0));
+    }
+#undef _PG_MATRIX_PIXEL
+}
+
+/* Picks a where mask is set and b elsewhere */
+#define _PG_SELECT_PS(mask, a, b) \
+    _mm_or_ps(_mm_and_ps((mask), (a)), _mm_andnot_ps((mask), (b)))
+
+/* hue_to_rgb of transform.c, with the same operations in the same order */
+static PG_FORCEINLINE __m128
+_hue_to_rgb_sse2(__m128 p, __m128 q, __m128 t)
+{
+    const __m128 mm_one = _mm_set1_ps(1.0f);
+    const __m128 mm_six = _mm_set1_ps(6.0f);
+    const __m128 mm_two_thirds = _mm_set1_ps(2 / 3.0f);
+    __m128 mm_value;
+
+    t = _mm_add_ps(t, _mm_and_ps(_mm_cmplt_ps(t, _mm_setzero_ps()), mm_one));
+    t = _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, mm_one), mm_one));
+
+    mm_value = _PG_SELECT_PS(
+        _mm_cmplt_ps(t, mm_two_thirds),
+        _mm_add_ps(p, _mm_mul_ps(_mm_mul_ps(_mm_sub_ps(q, p),
+                                            _mm_sub_ps(mm_two_thirds, t)),
+                                 mm_six)),
+        p);
+    mm_value =
+        _PG_SELECT_PS(_mm_cmplt_ps(t, _mm_set1_ps(1 / 2.0f)), q, mm_value);
+    return _PG_SELECT_PS(
+        _mm_cmplt_ps(t, _mm_set1_ps(1 / 6.0f)),
+        _mm_add_ps(p, _mm_mul_ps(_mm_mul_ps(_mm_sub_ps(q, p), mm_six), t)),
+        mm_value);
+}
+
+/* Shifts the hue, saturation and lightness of count 32 bit pixels for
+ * transform.hsl, four at a time. shifts holds the bit positions of red,
+ * green and blue in the pixel values, the other bits are copied. This runs
+ * every branch of RGB_to_HSL and HSL_to_RGB in transform.c and keeps the
+ * one the pixel takes, so the results are the same on x86. sse2neon
+ * approximates _mm_div_ps on 32 bit ARM, which can move a channel by 1. */
+void
+modify_hsl_sse2(const Uint8 *src, Uint8 *dst, int count, const int *shifts,
+                float h, float s, float l)
+{
+    const __m128i mm_byte = _mm_set1_epi32(0xFF);
+    const __m128i mm_rshift = _mm_cvtsi32_si128(shifts[0]);
+    const __m128i mm_gshift = _mm_cvtsi32_si128(shifts[1]);
+    const __m128i mm_bshift = _mm_cvtsi32_si128(shifts[2]);
+    const __m128i mm_keep = _mm_set1_epi32(
+        (int)~((0xFFu << shifts[0]) | (0xFFu << shifts[1]) |
+               (0xFFu << shifts[2])));
+    const __m128 mm_zero = _mm_setzero_ps();
+    const __m128 mm_one = _mm_set1_ps(1.0f);
+    const __m128 mm_half = _mm_set1_ps(0.5f);
+    const __m128 mm_255 = _mm_set1_ps(255.0f);
+    const __m128 mm_third = _mm_set1_ps(1 / 3.0f);
+    __m128i mm_src, mm_dst;
+    __m128 r, g, b, min, max, delta, hue, sat, lum, mask, p, q;
+    Uint8 pixels[16];
+    int i, n;
+
+    for (i = 0; i < count; i += 4) {
+        const Uint8 *srcp = src + i * 4;
+
+        n = MIN(count - i, 4);
+        if (n < 4) {
+            memcpy(pixels, srcp, (size_t)n * 4);
+            srcp = pixels;
+        }
+        mm_src = _mm_loadu_si128((const __m128i *)srcp);
+        r = _mm_div_ps(_mm_cvtepi32_ps(_mm_and_si128(
+                           _mm_srl_epi32(mm_src, mm_rshift), mm_byte)),
+                       mm_255);
+        g = _mm_div_ps(_mm_cvtepi32_ps(_mm_and_si128(
+                           _mm_srl_epi32(mm_src, mm_gshift), mm_byte)),
+                       mm_255);
+        b = _mm_div_ps(_mm_cvtepi32_ps(_mm_and_si128(
+                           _mm_srl_epi32(mm_src, mm_bshift), mm_byte)),
+                       mm_255);
+
+        /* RGB_to_HSL */
+        min = _mm_min_ps(_mm_min_ps(r, g), b);
+        max = _mm_max_ps(_mm_max_ps(r, g), b);
+        delta = _mm_sub_ps(max, min);
+        lum = _mm_div_ps(_mm_add_ps(max, min), _mm_set1_ps(2.0f));
+
+        sat = _PG_SELECT_PS(
+            _mm_cmpgt_ps(lum, mm_half),
+            _mm_div_ps(delta,
+                       _mm_sub_ps(_mm_sub_ps(_mm_set1_ps(2.0f), max), min)),
+            _mm_div_ps(delta, _mm_add_ps(max, min)));
+        mask = _mm_cmpeq_ps(max, r);
+        hue = _PG_SELECT_PS(
+            mask,
+            _mm_add_ps(_mm_div_ps(_mm_sub_ps(g, b), delta),
+                       _mm_and_ps(_mm_cmplt_ps(g, b), _mm_set1_ps(6.0f))),
+            _PG_SELECT_PS(_mm_cmpeq_ps(max, g),
+                          _mm_add_ps(_mm_div_ps(_mm_sub_ps(b, r), delta),
+                                     _mm_set1_ps(2.0f)),
+                          _mm_add_ps(_mm_div_ps(_mm_sub_ps(r, g), delta),
+                                     _mm_set1_ps(4.0f))));
+        hue = _mm_div_ps(hue, _mm_set1_ps(6.0f));
+        mask = _mm_cmpneq_ps(delta, mm_zero);
+        hue = _mm_and_ps(mask, hue);
+        sat = _mm_and_ps(mask, sat);
+
+        if (h) {
+            hue = _mm_add_ps(hue, _mm_set1_ps(h));
+            mask = _mm_cmpgt_ps(hue, mm_one);
+            hue = _PG_SELECT_PS(
+                mask, _mm_sub_ps(hue, mm_one),
+                _mm_add_ps(hue, _mm_and_ps(_mm_cmplt_ps(hue, mm_zero),
+                                           mm_one)));
+        }
+        if (s) {
+            sat = _mm_mul_ps(sat, _mm_set1_ps(1 + s));
+            sat = _mm_max_ps(_mm_min_ps(sat, mm_one), mm_zero);
+        }
+        if (l) {
+            lum = l < 0 ? _mm_mul_ps(lum, _mm_set1_ps(1 + l))
+                        : _mm_add_ps(_mm_mul_ps(lum, _mm_set1_ps(1 - l)),
+                                     _mm_set1_ps(l));
+            lum = _mm_max_ps(_mm_min_ps(lum, mm_one), mm_zero);
+        }
+
+        /* HSL_to_RGB, which gives the lightness for no saturation */
+        q = _PG_SELECT_PS(
+            _mm_cmplt_ps(lum, mm_half),
+            _mm_mul_ps(lum, _mm_add_ps(mm_one, sat)),
+            _mm_sub_ps(_mm_add_ps(lum, sat), _mm_mul_ps(lum, sat)));
+        p = _mm_sub_ps(_mm_mul_ps(_mm_set1_ps(2.0f), lum), q);
+        mask = _mm_cmpeq_ps(sat, mm_zero);
+        r = _PG_SELECT_PS(mask, lum,
+                          _hue_to_rgb_sse2(p, q, _mm_add_ps(hue, mm_third)));
+        g = _PG_SELECT_PS(mask, lum, _hue_to_rgb_sse2(p, q, hue));
+        b = _PG_SELECT_PS(mask, lum,
+                          _hue_to_rgb_sse2(p, q, _mm_sub_ps(hue, mm_third)));
+
+        mm_dst = _mm_and_si128(mm_src, mm_keep);
+        mm_dst = _mm_or_si128(
+            mm_dst, _mm_sll_epi32(_mm_cvttps_epi32(_mm_mul_ps(r, mm_255)),
+                                  mm_rshift));
+        mm_dst = _mm_or_si128(
+            mm_dst, _mm_sll_epi32(_mm_cvttps_epi32(_mm_mul_ps(g, mm_255)),
+                                  mm_gshift));
+        mm_dst = _mm_or_si128(
+            mm_dst, _mm_sll_epi32(_mm_cvttps_epi32(_mm_mul_ps(b, mm_255)),
+                                  mm_bshift));
+        if (n < 4) {
+            _mm_storeu_si128((__m128i *)pixels, mm_dst);
+            memcpy(dst + i * 4, pixels, (size_t)n * 4);
+        }
+        else {
+            _mm_storeu_si128((__m128i *)(dst + i * 4), mm_dst);
+        }
+    }
+}
+
+/* Halves two rows of 32 bit pixels into width pixels for
+ * transform.build_mipmaps, each output byte being the rounded mean of the
+ * 2x2 block of bytes above it. */
+void
+mipmap_row_sse2(const Uint8 *row0, const Uint8 *row1, Uint8 *dst, int width)
+{
+    const __m128i mm_zero = _mm_setzero_si128();
+    const __m128i mm_two = _mm_set1_epi16(2);
+    __m128i mm_src0, mm_src1, mm_lo, mm_hi;
+    int x, k;
+
+    /* two output pixels from four source pixels of each row */
+    for (x = 0; x + 2 <= width; x += 2) {
+        mm_src0 = _mm_loadu_si128((const __m128i *)(row0 + x * 8));
+        mm_src1 = _mm_loadu_si128((const __m128i *)(row1 + x * 8));
+        mm_lo = _mm_add_epi16(_mm_unpacklo_epi8(mm_src0, mm_zero),
+                              _mm_unpacklo_epi8(mm_src1, mm_zero));
+        mm_hi = _mm_add_epi16(_mm_unpackhi_epi8(mm_src0, mm_zero),
+                              _mm_unpackhi_epi8(mm_src1, mm_zero));
+        mm_lo = _mm_add_epi16(mm_lo, _mm_srli_si128(mm_lo, 8));
+        mm_hi = _mm_add_epi16(mm_hi, _mm_srli_si128(mm_hi, 8));
+        mm_lo = _mm_srli_epi16(
+            _mm_add_epi16(_mm_unpacklo_epi64(mm_lo, mm_hi), mm_two), 2);
+        _mm_storel_epi64((__m128i *)(dst + x * 4),
+                         _mm_packus_epi16(mm_lo, mm_lo));
+    }
+    for (; x < width; x++) {
+        for (k = 0; k < 4; k++) {
+            dst[x * 4 + k] = (Uint8)((row0[x * 8 + k] + row0[x * 8 + 4 + k] +
+                                      row1[x * 8 + k] +
+                                      row1[x * 8 + 4 + k] + 2) >>
+                                     2);
+        }
+    }
+}
+
+/* Picks the 32 bit lanes of a where mask is set and of b elsewhere */
+#define _PG_SELECT_SI128(mask, a, b) \
+    _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b))
+
+/* Loads the neighbours of four pixels of the padded rows of
+ * transform.scale2x and transform.scale3x, named as in AdvanceMAME:
+ * A B C above, D E F around and G H I below. The corners A, C, G and I are
+ * only needed by scale3x. cond is set where B != H and D != F, the only
+ * pixels the rules change. */
+#define _PG_SCALEX_LOAD_SSE2(x)                                          \
+    mm_b = _mm_loadu_si128((const __m128i *)(prev + (x)));               \
+    mm_d = _mm_loadu_si128((const __m128i *)(cur + (x) - 1));            \
+    mm_e = _mm_loadu_si128((const __m128i *)(cur + (x)));                \
+    mm_f = _mm_loadu_si128((const __m128i *)(cur + (x) + 1));            \
+    mm_h = _mm_loadu_si128((const __m128i *)(next + (x)));               \
+    mm_cond = _mm_andnot_si128(_mm_or_si128(_mm_cmpeq_epi32(mm_b, mm_h), \
+                                            _mm_cmpeq_epi32(mm_d, mm_f)), \
+                               mm_ones);                                 \
+    mm_db = _mm_and_si128(_mm_cmpeq_epi32(mm_d, mm_b), mm_cond);         \
+    mm_bf = _mm_and_si128(_mm_cmpeq_epi32(mm_b, mm_f), mm_cond);         \
+    mm_dh = _mm_and_si128(_mm_cmpeq_epi32(mm_d, mm_h), mm_cond);         \
+    mm_hf = _mm_and_si128(_mm_cmpeq_epi32(mm_h, mm_f), mm_cond);
+
+/* Doubles count pixels of a row of 32 bit pixels for transform.scale2x,
+ * count being a multiple of 4. prev, cur and next are the rows above, at
+ * and below, each readable one pixel past both ends. */
+void
+scale2x_row_sse2(const Uint32 *prev, const Uint32 *cur, const Uint32 *next,
+                 Uint32 *out0, Uint32 *out1, int count)
+{
+    const __m128i mm_ones = _mm_set1_epi32(-1);
+    __m128i mm_b, mm_d, mm_e, mm_f, mm_h;
+    __m128i mm_cond, mm_db, mm_bf, mm_dh, mm_hf, mm_e0, mm_e1;
+    int x;
+
+    for (x = 0; x < count; x += 4) {
+        _PG_SCALEX_LOAD_SSE2(x)
+
+        mm_e0 = _PG_SELECT_SI128(mm_db, mm_d, mm_e);
+        mm_e1 = _PG_SELECT_SI128(mm_bf, mm_f, mm_e);
+        _mm_storeu_si128((__m128i *)(out0 + x * 2),
+                         _mm_unpacklo_epi32(mm_e0, mm_e1));
+        _mm_storeu_si128((__m128i *)(out0 + x * 2 + 4),
+                         _mm_unpackhi_epi32(mm_e0, mm_e1));
+
+        mm_e0 = _PG_SELECT_SI128(mm_dh, mm_d, mm_e);
+        mm_e1 = _PG_SELECT_SI128(mm_hf, mm_f, mm_e);
+        _mm_storeu_si128((__m128i *)(out1 + x * 2),
+                         _mm_unpacklo_epi32(mm_e0, mm_e1));
+        _mm_storeu_si128((__m128i *)(out1 + x * 2 + 4),
+                         _mm_unpackhi_epi32(mm_e0, mm_e1));
+    }
+}
+
+/* Interleaves the lanes of three vectors, storing a0 b0 c0 a1 b1 c1 ... */
+static PG_FORCEINLINE void
+_scale3x_store_sse2(Uint32 *dst, __m128i a, __m128i b, __m128i c)
+{
+    __m128 lo = _mm_castsi128_ps(_mm_unpacklo_epi32(a, b));
+    __m128 hi = _mm_castsi128_ps(_mm_unpackhi_epi32(a, b));
+    __m128 mid = _mm_shuffle_ps(_mm_castsi128_ps(c), lo,
+                                _PG_SIMD_SHUFFLE(3, 2, 1, 0));
+    __m128 end = _mm_shuffle_ps(_mm_castsi128_ps(c), hi,
+                                _PG_SIMD_SHUFFLE(3, 2, 3, 2));
+
+    /* lo = a0 b0 a1 b1, mid = c0 c1 a1 b1, end = c2 c3 a3 b3 */
+    _mm_storeu_ps((float *)dst,
+                  _mm_shuffle_ps(lo, mid, _PG_SIMD_SHUFFLE(2, 0, 1, 0)));
+    _mm_storeu_ps((float *)(dst + 4),
+                  _mm_shuffle_ps(mid, hi, _PG_SIMD_SHUFFLE(1, 0, 1, 3)));
+    _mm_storeu_ps((float *)(dst + 8),
+                  _mm_shuffle_ps(end, end, _PG_SIMD_SHUFFLE(1, 3, 2, 0)));
+}
+
+/* Triples count pixels of a row of 32 bit pixels for transform.scale3x,
+ * count being a multiple of 4. prev, cur and next are the rows above, at
+ * and below, each readable one pixel past both ends. */
+void
+scale3x_row_sse2(const Uint32 *prev, const Uint32 *cur, const Uint32 *next,
+                 Uint32 *out0, Uint32 *out1, Uint32 *out2, int count)
+{
+    const __m128i mm_ones = _mm_set1_epi32(-1);
+    __m128i mm_b, mm_d, mm_e, mm_f, mm_h;
+    __m128i mm_cond, mm_db, mm_bf, mm_dh, mm_hf;
+    __m128i mm_ea, mm_ec, mm_eg, mm_ei;
+    int x;
+
+    for (x = 0; x < count; x += 4) {
+        _PG_SCALEX_LOAD_SSE2(x)
+        mm_ea = _mm_cmpeq_epi32(
+            mm_e, _mm_loadu_si128((const __m128i *)(prev + x - 1)));
+        mm_ec = _mm_cmpeq_epi32(
+            mm_e, _mm_loadu_si128((const __m128i *)(prev + x + 1)));
+        mm_eg = _mm_cmpeq_epi32(
+            mm_e, _mm_loadu_si128((const __m128i *)(next + x - 1)));
+        mm_ei = _mm_cmpeq_epi32(
+            mm_e, _mm_loadu_si128((const __m128i *)(next + x + 1)));
+
+        _scale3x_store_sse2(
+            out0 + x * 3, _PG_SELECT_SI128(mm_db, mm_d, mm_e),
+            _PG_SELECT_SI128(_mm_or_si128(_mm_andnot_si128(mm_ec, mm_db),
+                                          _mm_andnot_si128(mm_ea, mm_bf)),
+                             mm_b, mm_e),
+            _PG_SELECT_SI128(mm_bf, mm_f, mm_e));
+        _scale3x_store_sse2(
+            out1 + x * 3,
+            _PG_SELECT_SI128(_mm_or_si128(_mm_andnot_si128(mm_eg, mm_db),
+                                          _mm_andnot_si128(mm_ea, mm_dh)),
+                             mm_d, mm_e),
+            mm_e,
+            _PG_SELECT_SI128(_mm_or_si128(_mm_andnot_si128(mm_ei, mm_bf),
+                                          _mm_andnot_si128(mm_ec, mm_hf)),
+                             mm_f, mm_e));
+        _scale3x_store_sse2(
+            out2 + x * 3, _PG_SELECT_SI128(mm_dh, mm_d, mm_e),
+            _PG_SELECT_SI128(_mm_or_si128(_mm_andnot_si128(mm_ei, mm_dh),
+                                          _mm_andnot_si128(mm_eg, mm_hf)),
+                             mm_h, mm_e),
+            _PG_SELECT_SI128(mm_hf, mm_f, mm_e));
+    }
+}
+
 #endif /* __SSE2__ || PG_ENABLE_ARM_NEON*/
@@ -40,6 +40,12 @@
 #include <stdint.h>
 #endif /* _MSC_VER */
 
+#include <math.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
 typedef enum {
     VIEWKIND_0D = 0,
     VIEWKIND_1D = 1,
@@ -65,6 +71,42 @@ typedef struct pg_bufferinternal_s {
 int
 pgSurface_Blit(pgSurfaceObject *dstobj, pgSurfaceObject *srcobj,
                SDL_Rect *dstrect, SDL_Rect *srcrect, int blend_flags);
+static int
+_pg_blit_surfaces(SDL_Surface *src, struct pgSpanCache *spans,
+                  SDL_Rect *srcrect, SDL_Surface *dst, SDL_Rect *dstrect,
+                  SDL_Rect *dstclip, int blend_flags);
+static struct pgSpanCache *
+_pg_surface_spans(pgSurfaceObject *surfobj);
+
+static int
+_blitbatch_read_coord(const char *p, char kind, Py_ssize_t itemsize,
+                      int *coord);
+static char
+_blitbatch_view_kind(Py_buffer *view_p);
+
+/* from rotozoom.c */
+void
+transformRowRGBA(SDL_Surface *src, void *row, int width, int sdx, int sdy,
+                 int stepx, int stepy, int smooth, int *first, int *last);
+
+/* A single precompiled blit of a BlitBatch. area.w < 0 means the whole
+ * source Surface is drawn. */
+typedef struct {
+    pgSurfaceObject *source;
+    SDL_Rect area;
+    int x, y;
+    int blend_flags;
+} pgBlitBatchItem;
+
+typedef struct {
+    PyObject_HEAD pgBlitBatchItem *items;
+    Py_ssize_t length;
+    Py_ssize_t allocated;
+} pgBlitBatchObject;
+
+static PyTypeObject pgBlitBatch_Type;
+
+#define pgBlitBatch_Check(x) (PyObject_TypeCheck((x), &pgBlitBatch_Type))
 
 /* statics */
 static pgSurfaceObject *
@@ -137,8 +179,21 @@ surf_blits(pgSurfaceObject *self, PyObject *args, PyObject *keywds);
 static PyObject *
 surf_fblits(pgSurfaceObject *self, PyObject *const *args, Py_ssize_t nargs);
 static PyObject *
+surf_blit_transformed(pgSurfaceObject *self, PyObject *args,
+                      PyObject *keywds);
+static PyObject *
+surf_blit_tiled(pgSurfaceObject *self, PyObject *args, PyObject *keywds);
+static PyObject *
+surf_blit_nine_slice(pgSurfaceObject *self, PyObject *args, PyObject *keywds);
+static PyObject *
+surf_blit_tilemap(pgSurfaceObject *self, PyObject *args, PyObject *keywds);
+static PyObject *
 surf_fill(pgSurfaceObject *self, PyObject *args, PyObject *keywds);
 static PyObject *
+surf_fill_rects(pgSurfaceObject *self, PyObject *args, PyObject *keywds);
+static PyObject *
+surf_fill_gradient(pgSurfaceObject *self, PyObject *args, PyObject *keywds);
+static PyObject *
 surf_scroll(PyObject *self, PyObject *args, PyObject *keywds);
 static PyObject *
 surf_get_abs_offset(PyObject *self, PyObject *args);
@@ -192,6 +247,30 @@ static PyObject *
 surf_premul_alpha(pgSurfaceObject *self, PyObject *args);
 static PyObject *
 surf_premul_alpha_ip(pgSurfaceObject *self, PyObject *args);
+static PyObject *
+surf_set_dirty_tracking(pgSurfaceObject *self, PyObject *args);
+static PyObject *
+surf_get_dirty_tracking(pgSurfaceObject *self, PyObject *args);
+static PyObject *
+surf_get_dirty_rects(pgSurfaceObject *self, PyObject *args);
+static PyObject *
+surf_clear_dirty(pgSurfaceObject *self, PyObject *args);
+static PyObject *
+surf_set_span_encoding(pgSurfaceObject *self, PyObject *args);
+static PyObject *
+surf_get_span_encoding(pgSurfaceObject *self, PyObject *args);
+static void
+pgSurface_AddDirtyRect(pgSurfaceObject *surfobj, SDL_Rect *rect);
+static SDL_Surface *
+pgSurface_PoolCreate(int width, int height, PG_PixelFormatEnum format);
+static void
+pgSurface_PoolRelease(SDL_Surface *surf);
+static PyObject *
+pgSurface_PoolStats(void);
+static void
+pgSurface_PoolSetBudget(Py_ssize_t budget);
+static int
+_pg_pool_park(SDL_Surface *surf);
 static int
 _view_kind(PyObject *obj, void *view_kind_vptr);
 static int
@@ -223,6 +302,8 @@ static SDL_Surface *
 pg_DisplayFormatAlpha(SDL_Surface *surface);
 static SDL_Surface *
 pg_DisplayFormat(SDL_Surface *surface);
+static SDL_Surface *
+_pg_convert_surface_format(SDL_Surface *surface, PG_PixelFormatEnum format);
 static int
 _PgSurface_SrcAlpha(SDL_Surface *surf);
 
@@ -277,11 +358,23 @@ static struct PyMethodDef surface_methods[] = {
 
     {"fill", (PyCFunction)surf_fill, METH_VARARGS | METH_KEYWORDS,
      DOC_SURFACE_FILL},
+    {"fill_rects", (PyCFunction)surf_fill_rects, METH_VARARGS | METH_KEYWORDS,
+     DOC_SURFACE_FILLRECTS},
+    {"fill_gradient", (PyCFunction)surf_fill_gradient,
+     METH_VARARGS | METH_KEYWORDS, DOC_SURFACE_FILLGRADIENT},
     {"blit", (PyCFunction)surf_blit, METH_VARARGS | METH_KEYWORDS,
      DOC_SURFACE_BLIT},
     {"blits", (PyCFunction)surf_blits, METH_VARARGS | METH_KEYWORDS,
      DOC_SURFACE_BLITS},
     {"fblits", (PyCFunction)surf_fblits, METH_FASTCALL, DOC_SURFACE_FBLITS},
+    {"blit_transformed", (PyCFunction)surf_blit_transformed,
+     METH_VARARGS | METH_KEYWORDS, DOC_SURFACE_BLITTRANSFORMED},
+    {"blit_tiled", (PyCFunction)surf_blit_tiled, METH_VARARGS | METH_KEYWORDS,
+     DOC_SURFACE_BLITTILED},
+    {"blit_nine_slice", (PyCFunction)surf_blit_nine_slice,
+     METH_VARARGS | METH_KEYWORDS, DOC_SURFACE_BLITNINESLICE},
+    {"blit_tilemap", (PyCFunction)surf_blit_tilemap,
+     METH_VARARGS | METH_KEYWORDS, DOC_SURFACE_BLITTILEMAP},
     {"scroll", (PyCFunction)surf_scroll, METH_VARARGS | METH_KEYWORDS,
      DOC_SURFACE_SCROLL},
 
@@ -318,6 +411,18 @@ static struct PyMethodDef surface_methods[] = {
      DOC_SURFACE_PREMULALPHA},
     {"premul_alpha_ip", (PyCFunction)surf_premul_alpha_ip, METH_NOARGS,
      DOC_SURFACE_PREMULALPHAIP},
+    {"set_dirty_tracking", (PyCFunction)surf_set_dirty_tracking, METH_VARARGS,
+     DOC_SURFACE_SETDIRTYTRACKING},
+    {"get_dirty_tracking", (PyCFunction)surf_get_dirty_tracking, METH_NOARGS,
+     DOC_SURFACE_GETDIRTYTRACKING},
+    {"get_dirty_rects", (PyCFunction)surf_get_dirty_rects, METH_NOARGS,
+     DOC_SURFACE_GETDIRTYRECTS},
+    {"clear_dirty", (PyCFunction)surf_clear_dirty, METH_NOARGS,
+     DOC_SURFACE_CLEARDIRTY},
+    {"set_span_encoding", (PyCFunction)surf_set_span_encoding, METH_VARARGS,
+     DOC_SURFACE_SETSPANENCODING},
+    {"get_span_encoding", (PyCFunction)surf_get_span_encoding, METH_NOARGS,
+     DOC_SURFACE_GETSPANENCODING},
 
     {NULL, NULL, 0, NULL}};
 
@@ -393,6 +498,9 @@ surface_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
         self->weakreflist = NULL;
         self->dependency = NULL;
         self->locklist = NULL;
+        self->dirty = NULL;
+        self->spans = NULL;
+        self->cow = NULL;
     }
     return (PyObject *)self;
 }
@@ -402,7 +510,7 @@ static void
 surface_cleanup(pgSurfaceObject *self)
 {
     if (self->surf && self->owner) {
-        SDL_FreeSurface(self->surf);
+        pgSurface_PoolRelease(self->surf);
         self->surf = NULL;
     }
     if (self->subsurface) {
@@ -419,6 +527,19 @@ surface_cleanup(pgSurfaceObject *self)
         Py_DECREF(self->locklist);
         self->locklist = NULL;
     }
+    if (self->spans) {
+        self->spans->valid = 0;
+    }
+    /* Only after the SDL surface, which may still point to these pixels */
+    if (self->cow) {
+        if (self->cow->backing) {
+            SDL_FreeSurface(self->cow->backing);
+        }
+        PyMem_Free(self->cow->pixels);
+        Py_XDECREF(self->cow->copies);
+        PyMem_Free(self->cow);
+        self->cow = NULL;
+    }
     self->owner = 0;
 }
 
@@ -429,6 +550,10 @@ surface_dealloc(PyObject *self)
         PyObject_ClearWeakRefs(self);
     }
     surface_cleanup((pgSurfaceObject *)self);
+    /* Kept out of surface_cleanup, so that tracking survives the display
+     * Surface being replaced by set_mode() */
+    PyMem_Free(((pgSurfaceObject *)self)->dirty);
+    pygame_SpanCacheFree(((pgSurfaceObject *)self)->spans);
     Py_TYPE(self)->tp_free(self);
 }
 
@@ -910,7 +1035,7 @@ surf_get_at(PyObject *self, PyObject *position)
         return RAISE(PyExc_RuntimeError, "invalid color depth for surface");
     }
 
-    if (!pgSurface_Lock((pgSurfaceObject *)self)) {
+    if (!pgSurface_LockRead((pgSurfaceObject *)self)) {
         return NULL;
     }
 
@@ -1068,7 +1193,7 @@ surf_get_at_mapped(PyObject *self, PyObject *position)
         return RAISE(PyExc_RuntimeError, "invalid color depth for surface");
     }
 
-    if (!pgSurface_Lock((pgSurfaceObject *)self)) {
+    if (!pgSurface_LockRead((pgSurfaceObject *)self)) {
         return NULL;
     }
 
@@ -1434,7 +1559,14 @@ surf_set_colorkey(pgSurfaceObject *self, PyObject *args)
         hascolor = SDL_TRUE;
     }
 
-    pgSurface_Prep(self);
+    /* RLE encoding may release the pixels shared with copies */
+    if ((flags & PGS_RLEACCEL) && !pgSurface_Unshare(self)) {
+        return NULL;
+    }
+
+    if (!pgSurface_Prep(self)) {
+        return NULL;
+    }
     bool success = true;
     if (hascolor && PG_SURF_BytesPerPixel(surf) == 1) {
         /* For an indexed surface, remove the previous colorkey first.
@@ -1540,7 +1672,13 @@ surf_set_alpha(pgSurfaceObject *self, PyObject *args)
             return RAISE(pgExc_SDLError, SDL_GetError());
         }
     }
-    pgSurface_Prep(self);
+    /* RLE encoding may release the pixels shared with copies */
+    if ((flags & PGS_RLEACCEL) && !pgSurface_Unshare(self)) {
+        return NULL;
+    }
+    if (!pgSurface_Prep(self)) {
+        return NULL;
+    }
     bool success =
         PG_SetSurfaceRLE(surf, (flags & PGS_RLEACCEL) ? SDL_TRUE : SDL_FALSE);
     /* HACK HACK HACK */
@@ -1610,6 +1748,124 @@ surf_get_blendmode(PyObject *self, PyObject *_null)
     return PyLong_FromLong((long)mode);
 }
 
+/* Whether a copy of self can share its pixels until either is written.
+ * Copies of copies, indexed (shared palette), RLE and locked surfaces, and
+ * those not owned by this object are copied right away. */
+static int
+_pg_cow_can_share(pgSurfaceObject *self)
+{
+    SDL_Surface *surf = self->surf;
+
+    if (!self->owner || self->subsurface || surf->pixels == NULL ||
+        (self->locklist && PyList_GET_SIZE(self->locklist) > 0)) {
+        return 0;
+    }
+    if (self->cow && (self->cow->backing || self->cow->pixels)) {
+        return 0;
+    }
+    return !PG_SurfaceHasRLE(surf) && !SDL_MUSTLOCK(surf) &&
+           !SDL_ISPIXELFORMAT_INDEXED(PG_SURF_FORMATENUM(surf));
+}
+
+/* Copies the blend mode, surface alpha and colorkey of from to to.
+ * Returns 0 with the SDL error set on failure. */
+static int
+_pg_copy_surface_settings(SDL_Surface *from, SDL_Surface *to)
+{
+    SDL_BlendMode mode;
+    Uint32 colorkey;
+    Uint8 alpha;
+
+    if (!PG_GetSurfaceBlendMode(from, &mode) ||
+        !PG_SetSurfaceBlendMode(to, mode) ||
+        !PG_GetSurfaceAlphaMod(from, &alpha) ||
+        !PG_SetSurfaceAlphaMod(to, alpha)) {
+        return 0;
+    }
+    if (SDL_HasColorKey(from)) {
+        SDL_GetColorKey(from, &colorkey);
+        if (!PG_SetSurfaceColorKey(to, SDL_TRUE, colorkey)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/* Makes a new SDL surface sharing the pixels of self, remembering it in
+ * the returned Surface, and the Surface in the copies of self */
+static PyObject *
+_pg_cow_copy(pgSurfaceObject *self)
+{
+    SDL_Surface *surf = self->surf;
+    SDL_Surface *newsurf;
+    pgSurfaceObject *final;
+    PyObject *ref, *live;
+    Py_ssize_t i;
+
+    if (!self->cow) {
+        if (!(self->cow = PyMem_New(struct pgCowData, 1))) {
+            return PyErr_NoMemory();
+        }
+        memset(self->cow, 0, sizeof(struct pgCowData));
+    }
+    if (!self->cow->copies && !(self->cow->copies = PyList_New(0))) {
+        return NULL;
+    }
+
+    newsurf = PG_CreateSurfaceFrom(surf->w, surf->h, PG_SURF_FORMATENUM(surf),
+                                   surf->pixels, surf->pitch);
+    if (!newsurf) {
+        return RAISE(pgExc_SDLError, SDL_GetError());
+    }
+    if (!_pg_copy_surface_settings(surf, newsurf)) {
+        SDL_FreeSurface(newsurf);
+        return RAISE(pgExc_SDLError, SDL_GetError());
+    }
+
+    final = (pgSurfaceObject *)surf_subtype_new(Py_TYPE(self), newsurf, 1);
+    if (!final) {
+        SDL_FreeSurface(newsurf);
+        return NULL;
+    }
+    if (!(final->cow = PyMem_New(struct pgCowData, 1))) {
+        Py_DECREF(final);
+        return PyErr_NoMemory();
+    }
+    memset(final->cow, 0, sizeof(struct pgCowData));
+    /* Keeps the pixels alive if self is deleted or reinitialized */
+    ++surf->refcount;
+    final->cow->backing = surf;
+
+    ref = PyWeakref_NewRef((PyObject *)final, NULL);
+    if (!ref || PyList_Append(self->cow->copies, ref)) {
+        Py_XDECREF(ref);
+        Py_DECREF(final);
+        return NULL;
+    }
+    Py_DECREF(ref);
+
+    /* Forget the copies that died or were written to now and then */
+    if (PyList_GET_SIZE(self->cow->copies) % 64 == 0) {
+        for (i = PyList_GET_SIZE(self->cow->copies) - 1; i >= 0; --i) {
+            if (PyWeakref_GetRef(PyList_GET_ITEM(self->cow->copies, i),
+                                 &live) < 0) {
+                Py_DECREF(final);
+                return NULL;
+            }
+            if (!live || !((pgSurfaceObject *)live)->cow ||
+                ((pgSurfaceObject *)live)->cow->backing != surf) {
+                if (PySequence_DelItem(self->cow->copies, i)) {
+                    Py_XDECREF(live);
+                    Py_DECREF(final);
+                    return NULL;
+                }
+            }
+            Py_XDECREF(live);
+        }
+    }
+    return (PyObject *)final;
+}
+
 static PyObject *
 surf_copy(pgSurfaceObject *self, PyObject *_null)
 {
@@ -1619,7 +1875,13 @@ surf_copy(pgSurfaceObject *self, PyObject *_null)
 
     SURF_INIT_CHECK(surf)
 
-    pgSurface_Prep(self);
+    if (_pg_cow_can_share(self)) {
+        return _pg_cow_copy(self);
+    }
+
+    if (!pgSurface_Prep(self)) {
+        return NULL;
+    }
     newsurf = PG_ConvertSurface(surf, surf->format);
     pgSurface_Unprep(self);
 
@@ -1656,7 +1918,9 @@ surf_convert(pgSurfaceObject *self, PyObject *args)
 
     SURF_INIT_CHECK(surf)
 
-    pgSurface_Prep(self);
+    if (!pgSurface_Prep(self)) {
+        return NULL;
+    }
 
 #if SDL_VERSION_ATLEAST(3, 0, 0)
     if ((has_colorkey = SDL_HasColorKey(surf))) {
@@ -1680,7 +1944,13 @@ surf_convert(pgSurfaceObject *self, PyObject *args)
     if (argobject) {
         if (pgSurface_Check(argobject)) {
             src = pgSurface_AsSurface(argobject);
-            newsurf = PG_ConvertSurface(surf, src->format);
+            if (SDL_ISPIXELFORMAT_INDEXED(PG_SURF_FORMATENUM(src))) {
+                newsurf = PG_ConvertSurface(surf, src->format);
+            }
+            else {
+                newsurf = _pg_convert_surface_format(
+                    surf, PG_SURF_FORMATENUM(src));
+            }
         }
         else {
             /* will be updated later, initialize to make static analyzer happy
@@ -1834,7 +2104,13 @@ surf_convert(pgSurfaceObject *self, PyObject *args)
     if (argobject) {
         if (pgSurface_Check(argobject)) {
             src = pgSurface_AsSurface(argobject);
-            newsurf = PG_ConvertSurface(surf, src->format);
+            if (SDL_ISPIXELFORMAT_INDEXED(PG_SURF_FORMATENUM(src))) {
+                newsurf = PG_ConvertSurface(surf, src->format);
+            }
+            else {
+                newsurf = _pg_convert_surface_format(
+                    surf, PG_SURF_FORMATENUM(src));
+            }
         }
         else {
             /* will be updated later, initialize to make static analyzer happy
@@ -1987,6 +2263,67 @@ surf_convert(pgSurfaceObject *self, PyObject *args)
     return final;
 }
 
+/* Like PG_ConvertSurfaceFormat, with the pixels copied by
+ * convert_surf_pixels when it has a fast path for the formats. */
+static SDL_Surface *
+_pg_convert_surface_format(SDL_Surface *surface, PG_PixelFormatEnum format)
+{
+    SDL_Surface *newsurf;
+    SDL_BlendMode mode;
+    SDL_Rect clip;
+    Uint8 alpha;
+    int result;
+
+    if (SDL_HasColorKey(surface) || PG_SurfaceHasRLE(surface) ||
+        SDL_ISPIXELFORMAT_INDEXED(format)) {
+        return PG_ConvertSurfaceFormat(surface, format);
+    }
+
+    newsurf = PG_CreateSurface(surface->w, surface->h, format);
+    if (!newsurf) {
+        return NULL;
+    }
+    if (SDL_MUSTLOCK(surface) && !PG_LockSurface(surface)) {
+        SDL_FreeSurface(newsurf);
+        return NULL;
+    }
+    result = convert_surf_pixels(surface, newsurf);
+    if (SDL_MUSTLOCK(surface)) {
+        SDL_UnlockSurface(surface);
+    }
+    if (result == -1) {
+        SDL_FreeSurface(newsurf);
+        return PG_ConvertSurfaceFormat(surface, format);
+    }
+    if (result == -2) {
+        SDL_FreeSurface(newsurf);
+        return NULL;
+    }
+
+    /* the same settings SDL_ConvertSurface gives the new surface */
+    if (!PG_GetSurfaceAlphaMod(surface, &alpha) ||
+        !PG_SetSurfaceAlphaMod(newsurf, alpha) ||
+        !PG_GetSurfaceBlendMode(surface, &mode)) {
+        SDL_FreeSurface(newsurf);
+        return NULL;
+    }
+    if (mode == SDL_BLENDMODE_BLEND) {
+        mode = SDL_BLENDMODE_NONE;
+    }
+    if (alpha != 255 ||
+        (SDL_ISPIXELFORMAT_ALPHA(PG_SURF_FORMATENUM(surface)) &&
+         SDL_ISPIXELFORMAT_ALPHA(format))) {
+        mode = SDL_BLENDMODE_BLEND;
+    }
+    if (!PG_SetSurfaceBlendMode(newsurf, mode)) {
+        SDL_FreeSurface(newsurf);
+        return NULL;
+    }
+    PG_GetSurfaceClipRect(surface, &clip);
+    SDL_SetClipRect(newsurf, &clip);
+    return newsurf;
+}
+
 static SDL_Surface *
 pg_DisplayFormat(SDL_Surface *surface)
 {
@@ -1997,7 +2334,7 @@ pg_DisplayFormat(SDL_Surface *surface)
             " or Window.get_surface().");
         return NULL;
     }
-    return PG_ConvertSurfaceFormat(surface, default_format);
+    return _pg_convert_surface_format(surface, default_format);
 }
 
 static SDL_Surface *
@@ -2038,7 +2375,7 @@ pg_DisplayFormatAlpha(SDL_Surface *surface)
         default:
             break;
     }
-    return PG_ConvertSurfaceFormat(surface, pfe);
+    return _pg_convert_surface_format(surface, pfe);
 }
 
 static PyObject *
@@ -2152,6 +2489,10 @@ surf_fill(pgSurfaceObject *self, PyObject *args, PyObject *keywds)
     }
     SURF_INIT_CHECK(surf)
 
+    if (!pgSurface_Unshare(self)) {
+        return NULL;
+    }
+
     if (!pg_MappedColorFromObj(rgba_obj, surf, &color, PG_COLOR_HANDLE_ALL)) {
         return NULL;
     }
@@ -2189,7 +2530,9 @@ surf_fill(pgSurfaceObject *self, PyObject *args, PyObject *keywds)
         result = surface_fill_blend(surf, &sdlrect, color, blendargs);
     }
     else {
-        pgSurface_Prep(self);
+        if (!pgSurface_Prep(self)) {
+            return NULL;
+        }
         pgSurface_Lock((pgSurfaceObject *)self);
         result = PG_FillSurfaceRect(surf, &sdlrect, color) - 1;
         pgSurface_Unlock((pgSurfaceObject *)self);
@@ -2199,89 +2542,530 @@ surf_fill(pgSurfaceObject *self, PyObject *args, PyObject *keywds)
         return RAISE(pgExc_SDLError, SDL_GetError());
     }
 
+    pgSurface_AddDirtyRect(self, &sdlrect);
     return pgRect_New(&sdlrect);
 }
 
-static PyObject *
-surf_blit(pgSurfaceObject *self, PyObject *args, PyObject *keywds)
+/* Reads the rects of fill_rects from a sequence of rect styles or from a
+ * numeric buffer of shape (n, 4) or (n * 4,). Returns a PyMem array of
+ * *count rects, or NULL with an exception set. */
+static SDL_Rect *
+_pg_rects_from_obj(PyObject *obj, Py_ssize_t *count)
 {
-    SDL_Surface *src, *dest = pgSurface_AsSurface(self);
-    SDL_Rect *src_rect, temp;
-    PyObject *argpos = NULL, *argrect = NULL;
-    pgSurfaceObject *srcobject;
-    int dx, dy, result;
-    SDL_Rect dest_rect;
-    int sx, sy;
-    int blend_flags = 0;
-
-    static char *kwids[] = {"source", "dest", "area", "special_flags", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, keywds, "O!|OOi", kwids,
-                                     &pgSurface_Type, &srcobject, &argpos,
-                                     &argrect, &blend_flags)) {
-        return NULL;
+    SDL_Rect *rects, *rect, temp;
+    PyObject *seq;
+    Py_buffer view;
+    Py_ssize_t i, stride_item, stride_coord;
+    const char *p;
+    char kind;
+
+    if (PyObject_CheckBuffer(obj)) {
+        if (PyObject_GetBuffer(obj, &view, PyBUF_RECORDS_RO)) {
+            return NULL;
+        }
+        kind = _blitbatch_view_kind(&view);
+        if (kind && view.ndim == 2 && view.shape[1] == 4) {
+            *count = view.shape[0];
+            stride_item = view.strides[0];
+            stride_coord = view.strides[1];
+        }
+        else if (kind && view.ndim == 1 && view.shape[0] % 4 == 0) {
+            *count = view.shape[0] / 4;
+            stride_item = view.strides[0] * 4;
+            stride_coord = view.strides[0];
+        }
+        else {
+            PyBuffer_Release(&view);
+            return (SDL_Rect *)RAISE(PyExc_ValueError,
+                                     "rects array must be numeric with a "
+                                     "shape of (n, 4) or (n * 4,)");
+        }
+        if (!(rects = PyMem_New(SDL_Rect, *count ? *count : 1))) {
+            PyBuffer_Release(&view);
+            return (SDL_Rect *)PyErr_NoMemory();
+        }
+        p = (const char *)view.buf;
+        for (i = 0; i < *count; i++, p += stride_item) {
+            if (_blitbatch_read_coord(p, kind, view.itemsize, &rects[i].x) ||
+                _blitbatch_read_coord(p + stride_coord, kind, view.itemsize,
+                                      &rects[i].y) ||
+                _blitbatch_read_coord(p + 2 * stride_coord, kind,
+                                      view.itemsize, &rects[i].w) ||
+                _blitbatch_read_coord(p + 3 * stride_coord, kind,
+                                      view.itemsize, &rects[i].h)) {
+                PyMem_Free(rects);
+                PyBuffer_Release(&view);
+                return NULL;
+            }
+        }
+        PyBuffer_Release(&view);
+        return rects;
     }
 
-    src = pgSurface_AsSurface(srcobject);
-    SURF_INIT_CHECK(src)
-    SURF_INIT_CHECK(dest)
-
-    if (argpos == NULL) { /* dest argument is absent  */
-        dx = 0;
-        dy = 0;
+    if (!(seq = PySequence_Fast(obj, "rects must be a sequence of rects"))) {
+        return NULL;
     }
-    else if ((src_rect = pgRect_FromObject(argpos, &temp))) {
-        dx = src_rect->x;
-        dy = src_rect->y;
+    *count = PySequence_Fast_GET_SIZE(seq);
+    if (!(rects = PyMem_New(SDL_Rect, *count ? *count : 1))) {
+        Py_DECREF(seq);
+        return (SDL_Rect *)PyErr_NoMemory();
     }
-    else if (pg_TwoIntsFromObj(argpos, &sx, &sy)) {
-        dx = sx;
-        dy = sy;
+    for (i = 0; i < *count; i++) {
+        if (!(rect = pgRect_FromObject(PySequence_Fast_GET_ITEM(seq, i),
+                                       &temp))) {
+            PyMem_Free(rects);
+            Py_DECREF(seq);
+            return (SDL_Rect *)RAISE(PyExc_TypeError,
+                                     "rects must be a sequence of rects");
+        }
+        rects[i] = *rect;
     }
-    else {
-        return RAISE(PyExc_TypeError, "invalid destination position for blit");
+    Py_DECREF(seq);
+    return rects;
+}
+
+/* Maps the colors of fill_rects: a single color, a sequence of count
+ * colors or an unsigned 8 bit buffer of shape (count, 3) or (count, 4).
+ * Returns a PyMem array of *ncolors colors, or NULL with an exception
+ * set. */
+static Uint32 *
+_pg_colors_from_obj(PyObject *obj, SDL_Surface *surf, Py_ssize_t count,
+                    Py_ssize_t *ncolors)
+{
+    PG_PixelFormat *format;
+    SDL_Palette *palette;
+    Uint32 *colors;
+    PyObject *seq;
+    Py_buffer view;
+    Py_ssize_t i;
+    const Uint8 *p;
+
+    if (!(colors = PyMem_New(Uint32, count > 1 ? count : 1))) {
+        return (Uint32 *)PyErr_NoMemory();
+    }
+    if (pg_MappedColorFromObj(obj, surf, colors, PG_COLOR_HANDLE_ALL)) {
+        *ncolors = 1;
+        return colors;
+    }
+    /* Keep the error of the single color unless obj is a container */
+    if (PyUnicode_Check(obj) ||
+        (!PyObject_CheckBuffer(obj) && !PySequence_Check(obj))) {
+        PyMem_Free(colors);
+        return NULL;
     }
+    PyErr_Clear();
+    *ncolors = count;
 
-    if (argrect && argrect != Py_None) {
-        if (!(src_rect = pgRect_FromObject(argrect, &temp))) {
-            return RAISE(PyExc_TypeError, "Invalid rectstyle argument");
+    if (PyObject_CheckBuffer(obj)) {
+        if (PyObject_GetBuffer(obj, &view, PyBUF_RECORDS_RO)) {
+            PyMem_Free(colors);
+            return NULL;
         }
+        if (_blitbatch_view_kind(&view) != 'u' || view.itemsize != 1 ||
+            view.ndim != 2 || view.shape[0] != count ||
+            (view.shape[1] != 3 && view.shape[1] != 4) ||
+            !PG_GetSurfaceDetails(surf, &format, &palette)) {
+            PyBuffer_Release(&view);
+            PyMem_Free(colors);
+            return (Uint32 *)RAISE(PyExc_ValueError,
+                                   "colors array must be uint8 with a shape "
+                                   "of (len(rects), 3) or (len(rects), 4)");
+        }
+        for (i = 0; i < count; i++) {
+            p = (const Uint8 *)view.buf + i * view.strides[0];
+            colors[i] = PG_MapRGBA(
+                format, palette, p[0], p[view.strides[1]],
+                p[2 * view.strides[1]],
+                view.shape[1] == 4 ? p[3 * view.strides[1]] : 255);
+        }
+        PyBuffer_Release(&view);
+        return colors;
+    }
+
+    if (!(seq = PySequence_Fast(obj, "colors must be a sequence"))) {
+        PyMem_Free(colors);
+        return NULL;
     }
-    else {
-        temp.x = temp.y = 0;
-        temp.w = src->w;
-        temp.h = src->h;
-        src_rect = &temp;
+    if (PySequence_Fast_GET_SIZE(seq) != count) {
+        Py_DECREF(seq);
+        PyMem_Free(colors);
+        return (Uint32 *)RAISE(PyExc_ValueError,
+                               "expected a color or one color per rect");
+    }
+    for (i = 0; i < count; i++) {
+        if (!pg_MappedColorFromObj(PySequence_Fast_GET_ITEM(seq, i), surf,
+                                   &colors[i], PG_COLOR_HANDLE_ALL)) {
+            Py_DECREF(seq);
+            PyMem_Free(colors);
+            return NULL;
+        }
     }
+    Py_DECREF(seq);
+    return colors;
+}
 
-    dest_rect.x = dx;
-    dest_rect.y = dy;
-    dest_rect.w = src_rect->w;
-    dest_rect.h = src_rect->h;
+static PyObject *
+surf_fill_rects(pgSurfaceObject *self, PyObject *args, PyObject *keywds)
+{
+    SDL_Surface *surf = pgSurface_AsSurface(self);
+    SDL_Rect *rects = NULL, clip, clipped, bounds = {0, 0, 0, 0};
+    Uint32 *colors = NULL;
+    PyObject *rgba_obj, *rects_obj, *ret = NULL;
+    Py_ssize_t i, n, count, ncolors;
+    int blendargs = 0, result = 0;
+
+    static char *kwids[] = {"color", "rects", "special_flags", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, keywds, "OO|i", kwids, &rgba_obj,
+                                     &rects_obj, &blendargs)) {
+        return NULL;
+    }
+    SURF_INIT_CHECK(surf)
 
-    if (!blend_flags) {
-        blend_flags = 0;
+    if (!(rects = _pg_rects_from_obj(rects_obj, &count)) ||
+        !(colors = _pg_colors_from_obj(rgba_obj, surf, count, &ncolors))) {
+        goto end;
+    }
+    if (count > INT_MAX) {
+        PyErr_SetString(PyExc_ValueError, "too many rects");
+        goto end;
     }
 
-    result =
-        pgSurface_Blit(self, srcobject, &dest_rect, src_rect, blend_flags);
+    /* Clip all the rects first, dropping the empty ones with their color */
+    if (!PG_GetSurfaceClipRect(surf, &clip)) {
+        PyErr_SetString(pgExc_SDLError, SDL_GetError());
+        goto end;
+    }
+    for (i = n = 0; i < count; i++) {
+        if (!SDL_IntersectRect(&rects[i], &clip, &clipped)) {
+            continue;
+        }
+        rects[n] = clipped;
+        if (ncolors > 1) {
+            colors[n] = colors[i];
+        }
+        if (n == 0) {
+            bounds = rects[n];
+        }
+        else {
+            SDL_UnionRect(&bounds, &rects[n], &bounds);
+        }
+        n++;
+    }
 
-    if (result != 0) {
-        return NULL;
+    if (n > 0) {
+        if (!pgSurface_Unshare(self) || !pgSurface_Prep(self)) {
+            goto end;
+        }
+        if (blendargs != 0) {
+            result = surface_fill_blend_rects(surf, rects, colors,
+                                              (int)ncolors, (int)n, blendargs);
+        }
+        else {
+            pgSurface_Lock(self);
+            for (i = 0; i < n && result == 0; i++) {
+                result = PG_FillSurfaceRect(surf, &rects[i],
+                                            colors[ncolors > 1 ? i : 0]) -
+                         1;
+            }
+            pgSurface_Unlock(self);
+        }
+        pgSurface_Unprep(self);
+        if (result == -1) {
+            PyErr_SetString(pgExc_SDLError, SDL_GetError());
+            goto end;
+        }
+        for (i = 0; i < n; i++) {
+            pgSurface_AddDirtyRect(self, &rects[i]);
+        }
     }
+    ret = pgRect_New(&bounds);
 
-    return pgRect_New(&dest_rect);
+end:
+    PyMem_Free(rects);
+    PyMem_Free(colors);
+    return ret;
 }
 
-#define BLITS_ERR_SEQUENCE_REQUIRED 1
-#define BLITS_ERR_DISPLAY_SURF_QUIT 2
-#define BLITS_ERR_SEQUENCE_SURF 3
-#define BLITS_ERR_NO_OPENGL_SURF 4
-#define BLITS_ERR_INVALID_DESTINATION 5
-#define BLITS_ERR_INVALID_RECT_STYLE 6
-#define BLITS_ERR_MUST_ASSIGN_NUMERIC 7
-#define BLITS_ERR_BLIT_FAIL 8
-#define BLITS_ERR_PY_EXCEPTION_RAISED 9
-#define BLITS_ERR_SOURCE_NOT_SURFACE 10
+/* Builds the PG_GRADIENT_LUT_SIZE colors of a gradient, mapped to surf,
+ * from stops: a sequence of colors spread evenly, each of which may also be
+ * a (position, color) pair placing the color at a position between 0 and 1.
+ * Returns 0 with an exception set on failure. */
+static int
+_pg_gradient_lut_from_obj(PyObject *obj, SDL_Surface *surf, Uint32 *lut)
+{
+    PG_PixelFormat *format;
+    SDL_Palette *palette;
+    PyObject *seq, *item, *pos_obj, *color_obj;
+    double *positions = NULL, pos;
+    Uint8 *colors = NULL, *c0, *c1;
+    Py_ssize_t i, n, stop;
+    int k, ret = 0;
+
+    if (PyUnicode_Check(obj)) {
+        PyErr_SetString(PyExc_TypeError,
+                        "stops must be a sequence of colors or (position, "
+                        "color) pairs");
+        return 0;
+    }
+    if (!(seq = PySequence_Fast(obj, "stops must be a sequence of colors or "
+                                     "(position, color) pairs"))) {
+        return 0;
+    }
+    n = PySequence_Fast_GET_SIZE(seq);
+    if (n == 0) {
+        PyErr_SetString(PyExc_ValueError, "stops must not be empty");
+        goto end;
+    }
+    positions = PyMem_New(double, n);
+    colors = PyMem_New(Uint8, 4 * n);
+    if (!positions || !colors) {
+        PyErr_NoMemory();
+        goto end;
+    }
+
+    for (i = 0; i < n; i++) {
+        item = PySequence_Fast_GET_ITEM(seq, i);
+        positions[i] = n > 1 ? (double)i / (n - 1) : 0.0;
+        if (pg_RGBAFromObjEx(item, colors + 4 * i, PG_COLOR_HANDLE_ALL)) {
+            continue;
+        }
+        /* Keep the error of the color unless item can be a pair */
+        if (PyUnicode_Check(item) || !PySequence_Check(item) ||
+            PySequence_Size(item) != 2) {
+            goto end;
+        }
+        PyErr_Clear();
+        if (!(pos_obj = PySequence_GetItem(item, 0))) {
+            goto end;
+        }
+        pos = PyFloat_AsDouble(pos_obj);
+        Py_DECREF(pos_obj);
+        if (pos == -1.0 && PyErr_Occurred()) {
+            goto end;
+        }
+        if (!(pos >= 0.0 && pos <= 1.0)) {
+            PyErr_SetString(PyExc_ValueError,
+                            "stop positions must be between 0 and 1");
+            goto end;
+        }
+        if (!(color_obj = PySequence_GetItem(item, 1))) {
+            goto end;
+        }
+        k = pg_RGBAFromObjEx(color_obj, colors + 4 * i, PG_COLOR_HANDLE_ALL);
+        Py_DECREF(color_obj);
+        if (!k) {
+            goto end;
+        }
+        positions[i] = pos;
+    }
+    for (i = 1; i < n; i++) {
+        if (positions[i] < positions[i - 1]) {
+            PyErr_SetString(PyExc_ValueError,
+                            "stop positions must be in increasing order");
+            goto end;
+        }
+    }
+
+    if (!PG_GetSurfaceDetails(surf, &format, &palette)) {
+        PyErr_SetString(pgExc_SDLError, SDL_GetError());
+        goto end;
+    }
+    /* Interpolate each entry between the stops around it, the first and
+     * last colors extend to the ends of the gradient */
+    stop = 0;
+    for (k = 0; k < PG_GRADIENT_LUT_SIZE; k++) {
+        pos = (double)k / (PG_GRADIENT_LUT_SIZE - 1);
+        while (stop < n && positions[stop] <= pos) {
+            stop++;
+        }
+        if (stop == 0 || stop == n) {
+            c0 = colors + 4 * (stop ? n - 1 : 0);
+            lut[k] = PG_MapRGBA(format, palette, c0[0], c0[1], c0[2], c0[3]);
+            continue;
+        }
+        c0 = colors + 4 * (stop - 1);
+        c1 = colors + 4 * stop;
+        pos = (pos - positions[stop - 1]) /
+              (positions[stop] - positions[stop - 1]);
+        lut[k] = PG_MapRGBA(format, palette,
+                            (Uint8)(c0[0] + (c1[0] - c0[0]) * pos + 0.5),
+                            (Uint8)(c0[1] + (c1[1] - c0[1]) * pos + 0.5),
+                            (Uint8)(c0[2] + (c1[2] - c0[2]) * pos + 0.5),
+                            (Uint8)(c0[3] + (c1[3] - c0[3]) * pos + 0.5));
+    }
+    ret = 1;
+
+end:
+    Py_DECREF(seq);
+    PyMem_Free(positions);
+    PyMem_Free(colors);
+    return ret;
+}
+
+static PyObject *
+surf_fill_gradient(pgSurfaceObject *self, PyObject *args, PyObject *keywds)
+{
+    SDL_Surface *surf = pgSurface_AsSurface(self);
+    SDL_Rect *rect, temp, clip, area = {0, 0, 0, 0};
+    PyObject *r, *stops_obj;
+    Uint32 *lut;
+    const char *kind_name = "linear";
+    double angle = 0.0;
+    int kind, result, blendargs = 0;
+
+    static char *kwids[] = {"rect",  "stops",         "kind",
+                            "angle", "special_flags", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, keywds, "OO|sdi", kwids, &r,
+                                     &stops_obj, &kind_name, &angle,
+                                     &blendargs)) {
+        return NULL;
+    }
+    SURF_INIT_CHECK(surf)
+
+    if (!strcmp(kind_name, "linear")) {
+        kind = PG_GRADIENT_LINEAR;
+    }
+    else if (!strcmp(kind_name, "radial")) {
+        kind = PG_GRADIENT_RADIAL;
+    }
+    else if (!strcmp(kind_name, "conic")) {
+        kind = PG_GRADIENT_CONIC;
+    }
+    else {
+        return RAISE(PyExc_ValueError,
+                     "kind must be 'linear', 'radial' or 'conic'");
+    }
+    if (!isfinite(angle)) {
+        return RAISE(PyExc_ValueError, "angle must be finite");
+    }
+    angle = fmod(angle, 360.0);
+
+    if (r == Py_None) {
+        temp.x = temp.y = 0;
+        temp.w = surf->w;
+        temp.h = surf->h;
+    }
+    else if (!(rect = pgRect_FromObject(r, &temp))) {
+        return RAISE(PyExc_ValueError, "invalid rectstyle object");
+    }
+    else if (rect != &temp) {
+        memcpy(&temp, rect, sizeof(temp));
+    }
+
+    if (!(lut = PyMem_New(Uint32, PG_GRADIENT_LUT_SIZE))) {
+        return PyErr_NoMemory();
+    }
+    if (!_pg_gradient_lut_from_obj(stops_obj, surf, lut)) {
+        PyMem_Free(lut);
+        return NULL;
+    }
+
+    if (!PG_GetSurfaceClipRect(surf, &clip)) {
+        PyMem_Free(lut);
+        return RAISE(pgExc_SDLError, SDL_GetError());
+    }
+    if (!SDL_IntersectRect(&temp, &clip, &area)) {
+        PyMem_Free(lut);
+        area.x = area.y = area.w = area.h = 0;
+        return pgRect_New(&area);
+    }
+
+    if (!pgSurface_Unshare(self) || !pgSurface_Prep(self)) {
+        PyMem_Free(lut);
+        return NULL;
+    }
+    result = surface_fill_gradient(surf, &temp, &area, kind, angle, lut,
+                                   blendargs);
+    pgSurface_Unprep(self);
+    PyMem_Free(lut);
+    if (result == -1) {
+        return RAISE(pgExc_SDLError, SDL_GetError());
+    }
+
+    pgSurface_AddDirtyRect(self, &area);
+    return pgRect_New(&area);
+}
+
+static PyObject *
+surf_blit(pgSurfaceObject *self, PyObject *args, PyObject *keywds)
+{
+    SDL_Surface *src, *dest = pgSurface_AsSurface(self);
+    SDL_Rect *src_rect, temp;
+    PyObject *argpos = NULL, *argrect = NULL;
+    pgSurfaceObject *srcobject;
+    int dx, dy, result;
+    SDL_Rect dest_rect;
+    int sx, sy;
+    int blend_flags = 0;
+
+    static char *kwids[] = {"source", "dest", "area", "special_flags", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, keywds, "O!|OOi", kwids,
+                                     &pgSurface_Type, &srcobject, &argpos,
+                                     &argrect, &blend_flags)) {
+        return NULL;
+    }
+
+    src = pgSurface_AsSurface(srcobject);
+    SURF_INIT_CHECK(src)
+    SURF_INIT_CHECK(dest)
+
+    if (argpos == NULL) { /* dest argument is absent  */
+        dx = 0;
+        dy = 0;
+    }
+    else if ((src_rect = pgRect_FromObject(argpos, &temp))) {
+        dx = src_rect->x;
+        dy = src_rect->y;
+    }
+    else if (pg_TwoIntsFromObj(argpos, &sx, &sy)) {
+        dx = sx;
+        dy = sy;
+    }
+    else {
+        return RAISE(PyExc_TypeError, "invalid destination position for blit");
+    }
+
+    if (argrect && argrect != Py_None) {
+        if (!(src_rect = pgRect_FromObject(argrect, &temp))) {
+            return RAISE(PyExc_TypeError, "Invalid rectstyle argument");
+        }
+    }
+    else {
+        temp.x = temp.y = 0;
+        temp.w = src->w;
+        temp.h = src->h;
+        src_rect = &temp;
+    }
+
+    dest_rect.x = dx;
+    dest_rect.y = dy;
+    dest_rect.w = src_rect->w;
+    dest_rect.h = src_rect->h;
+
+    if (!blend_flags) {
+        blend_flags = 0;
+    }
+
+    result =
+        pgSurface_Blit(self, srcobject, &dest_rect, src_rect, blend_flags);
+
+    if (result != 0) {
+        return NULL;
+    }
+
+    return pgRect_New(&dest_rect);
+}
+
+#define BLITS_ERR_SEQUENCE_REQUIRED 1
+#define BLITS_ERR_DISPLAY_SURF_QUIT 2
+#define BLITS_ERR_SEQUENCE_SURF 3
+#define BLITS_ERR_NO_OPENGL_SURF 4
+#define BLITS_ERR_INVALID_DESTINATION 5
+#define BLITS_ERR_INVALID_RECT_STYLE 6
+#define BLITS_ERR_MUST_ASSIGN_NUMERIC 7
+#define BLITS_ERR_BLIT_FAIL 8
+#define BLITS_ERR_PY_EXCEPTION_RAISED 9
+#define BLITS_ERR_SOURCE_NOT_SURFACE 10
 
 static PyObject *
 surf_blits(pgSurfaceObject *self, PyObject *args, PyObject *keywds)
@@ -2527,6 +3311,7 @@ bliterror:
 #define FBLITS_ERR_TUPLE_REQUIRED 11
 #define FBLITS_ERR_INCORRECT_ARGS_NUM 12
 #define FBLITS_ERR_FLAG_NOT_NUMERIC 13
+#define FBLITS_ERR_SURF_NOT_INIT 14
 
 static int PG_FORCEINLINE
 _surf_fblits_item_check_and_blit(pgSurfaceObject *self, PyObject *item,
@@ -2577,6 +3362,47 @@ _surf_fblits_item_check_and_blit(pgSurfaceObject *self, PyObject *item,
     return 0;
 }
 
+/* Runs a precompiled BlitBatch. Everything was validated when the items
+ * were added, so the only thing left to check is that the sources are
+ * still alive. Items without their own flags use blend_flags. */
+static int
+_surf_fblits_batch(pgSurfaceObject *self, pgBlitBatchObject *batch,
+                   int blend_flags)
+{
+    Py_ssize_t i;
+    pgBlitBatchItem item;
+    SDL_Surface *src;
+    SDL_Rect dest_rect;
+    int result;
+
+    /* Locking subsurfaces may run the garbage collector and with it
+     * arbitrary code, so work on a copy of each item and keep its source
+     * alive for the duration of the blit. */
+    for (i = 0; i < batch->length; i++) {
+        item = batch->items[i];
+        if (!(src = pgSurface_AsSurface(item.source))) {
+            return FBLITS_ERR_SURF_NOT_INIT;
+        }
+
+        dest_rect.x = item.x;
+        dest_rect.y = item.y;
+        dest_rect.w = item.area.w < 0 ? src->w : item.area.w;
+        dest_rect.h = item.area.w < 0 ? src->h : item.area.h;
+
+        Py_INCREF(item.source);
+        result = pgSurface_Blit(
+            self, item.source, &dest_rect,
+            item.area.w < 0 ? NULL : &item.area,
+            item.blend_flags ? item.blend_flags : blend_flags);
+        Py_DECREF(item.source);
+        if (result) {
+            return BLITS_ERR_BLIT_FAIL;
+        }
+    }
+
+    return 0;
+}
+
 static PyObject *
 surf_fblits(pgSurfaceObject *self, PyObject *const *args, Py_ssize_t nargs)
 {
@@ -2606,8 +3432,16 @@ surf_fblits(pgSurfaceObject *self, PyObject *const *args, Py_ssize_t nargs)
 
     blit_sequence = args[0];
 
+    /* Fastest path, the items were already parsed by the BlitBatch */
+    if (pgBlitBatch_Check(blit_sequence)) {
+        error = _surf_fblits_batch(self, (pgBlitBatchObject *)blit_sequence,
+                                   blend_flags);
+        if (error) {
+            goto on_error;
+        }
+    }
     /* Fast path for Lists or Tuples */
-    if (pgSequenceFast_Check(blit_sequence)) {
+    else if (pgSequenceFast_Check(blit_sequence)) {
         Py_ssize_t i;
         PyObject **sequence_items = PySequence_Fast_ITEMS(blit_sequence);
         for (i = 0; i < PySequence_Fast_GET_SIZE(blit_sequence); i++) {
@@ -2681,1985 +3515,3714 @@ on_error:
         case FBLITS_ERR_FLAG_NOT_NUMERIC:
             return RAISE(PyExc_TypeError,
                          "The special_flags parameter must be an int");
+        case FBLITS_ERR_SURF_NOT_INIT:
+            return RAISE(pgExc_SDLError,
+                         "Source Surface of the BlitBatch is not initialized");
     }
     return RAISE(PyExc_TypeError, "Unknown error");
 }
 
+/* Fixed point 16.16 value of v, as used by the rotozoom row sampler */
 static int
-scroll_repeat(int h, int dx, int dy, int pitch, int span, int xoffset,
-              Uint8 *startsrc, Uint8 *endsrc, Uint8 *linesrc)
+_pg_fixed(double v)
 {
-    if (dy != 0) {
-        int yincrease = dy > 0 ? -pitch : pitch;
-        int spanincrease = dy > 0 ? -span : span;
-        int templen = (dy > 0 ? dy * span : -dy * span);
-        int tempheight = (dy > 0 ? dy : -dy);
-        /* Create a temporary buffer to store the pixels that
-           are disappearing from the surface */
-        Uint8 *tempbuf = (Uint8 *)malloc(templen);
-        if (tempbuf == NULL) {
-            PyErr_NoMemory();
-            return -1;
-        }
-        memset(tempbuf, 0, templen);
-        Uint8 *templine = tempbuf;
-        Uint8 *tempend =
-            templine + (dy > 0 ? (dy - 1) * span : -(dy + 1) * span);
-        if (dy > 0) {
-            templine = tempend;
+    return (int)floor(v * 65536.0 + 0.5);
+}
+
+/* Returns src, or a copy of it when its pixels can not be read while dest
+ * is written to: when they overlap, or when need32 is set and src is not
+ * a plain 32 bit Surface the row sampler can read. Copies are freed by the
+ * caller. Returns NULL with an exception set on error. */
+static SDL_Surface *
+_pg_sample_surface(SDL_Surface *src, SDL_Surface *dest, int need32)
+{
+    SDL_Surface *copy;
+    Uint8 *srcstart = (Uint8 *)src->pixels;
+    Uint8 *srcend = srcstart + (size_t)src->pitch * src->h;
+    Uint8 *deststart = (Uint8 *)dest->pixels;
+    Uint8 *destend = deststart + (size_t)dest->pitch * dest->h;
+
+    if (need32 &&
+        (PG_SURF_BytesPerPixel(src) != 4 || PG_SurfaceHasRLE(src))) {
+        copy = PG_SURF_BytesPerPixel(src) == 4
+                   ? PG_ConvertSurface(src, src->format)
+                   : PG_ConvertSurfaceFormat(src, SDL_PIXELFORMAT_ARGB8888);
+    }
+    else if (srcstart < destend && deststart < srcend) {
+        copy = PG_ConvertSurface(src, src->format);
+    }
+    else {
+        return src;
+    }
+    if (!copy ||
+        (PG_SurfaceHasRLE(copy) && !PG_SetSurfaceRLE(copy, SDL_FALSE))) {
+        if (copy) {
+            SDL_FreeSurface(copy);
         }
-        int looph = h;
-        while (looph--) {
-            // If the current line should disappear copy it to the
-            // temporary buffer
-            if ((templine <= tempend && dy < 0) ||
-                (templine >= tempbuf && dy > 0)) {
-                if (dx > 0) {
-                    memcpy(templine, linesrc + span - xoffset, xoffset);
-                    memcpy(templine + xoffset, linesrc, span - xoffset);
-                }
-                else if (dx < 0) {
-                    memcpy(templine + span + xoffset, linesrc, -xoffset);
-                    memcpy(templine, linesrc - xoffset, span + xoffset);
-                }
-                else {
-                    memcpy(templine, linesrc, span);
-                }
-                memset(linesrc, 0, span);
-                templine += spanincrease;
-            }
-            else {
-                Uint8 *pastesrc = linesrc + pitch * dy;
-                if ((dy < 0 && pastesrc >= startsrc) ||
-                    (dy > 0 && pastesrc <= endsrc)) {
-                    if (dx > 0) {
-                        memcpy(pastesrc, linesrc + span - xoffset, xoffset);
-                        memcpy(pastesrc + xoffset, linesrc, span - xoffset);
-                    }
-                    else if (dx < 0) {
-                        memcpy(pastesrc + span + xoffset, linesrc, -xoffset);
-                        memcpy(pastesrc, linesrc - xoffset, span + xoffset);
-                    }
-                    else {
-                        memcpy(pastesrc, linesrc, span);
-                    }
-                }
-            }
-            linesrc += yincrease;
+        return (SDL_Surface *)RAISE(pgExc_SDLError, SDL_GetError());
+    }
+    return copy;
+}
+
+/* Makes a one row Surface blitted like sample, over a new buffer of width
+ * pixels for the row sampler. Returns NULL with an exception set on error,
+ * free with _pg_free_row_surface. */
+static SDL_Surface *
+_pg_new_row_surface(SDL_Surface *sample, int width)
+{
+    SDL_Surface *rowsurf;
+    Uint32 *row = PyMem_New(Uint32, width);
+
+    if (!row) {
+        return (SDL_Surface *)PyErr_NoMemory();
+    }
+    rowsurf = PG_CreateSurfaceFrom(width, 1, PG_SURF_FORMATENUM(sample), row,
+                                   width * 4);
+    if (!rowsurf || !_pg_copy_surface_settings(sample, rowsurf)) {
+        PyErr_SetString(pgExc_SDLError, SDL_GetError());
+        if (rowsurf) {
+            SDL_FreeSurface(rowsurf);
         }
-        // Copy the data of the buffer back to the original pixels to
-        // repeat
-        templine = tempbuf;
-        if (dy < 0) {
-            linesrc = startsrc + pitch * (h - tempheight);
-        }
-        else {
-            linesrc = startsrc;
-        }
-        while (tempheight--) {
-            memcpy(linesrc, templine, span);
-            linesrc += pitch;
-            templine += span;
-        }
-        free(tempbuf);
+        PyMem_Free(row);
+        return NULL;
     }
-    else {
-        // No y-shifting, the temporary buffer should only store the x loss
-        Uint8 *tempbuf = (Uint8 *)malloc((dx > 0 ? xoffset : -xoffset));
-        if (tempbuf == NULL) {
-            PyErr_NoMemory();
-            return -1;
-        }
-        while (h--) {
-            if (dx > 0) {
-                memcpy(tempbuf, linesrc + span - xoffset, xoffset);
-                memmove(linesrc + xoffset, linesrc, span - xoffset);
-                memcpy(linesrc, tempbuf, xoffset);
-            }
-            else if (dx < 0) {
-                memcpy(tempbuf, linesrc, -xoffset);
-                memmove(linesrc, linesrc - xoffset, span + xoffset);
-                memcpy(linesrc + span + xoffset, tempbuf, -xoffset);
-            }
-            linesrc += pitch;
-        }
-        free(tempbuf);
+    return rowsurf;
+}
+
+static void
+_pg_free_row_surface(SDL_Surface *rowsurf)
+{
+    void *row = rowsurf->pixels;
+
+    SDL_FreeSurface(rowsurf);
+    PyMem_Free(row);
+}
+
+/* Blits the pixels first to last of the sampled row of rowsurf at x, y */
+static int
+_pg_blit_row(SDL_Surface *rowsurf, int first, int last, SDL_Surface *dst,
+             int x, int y, SDL_Rect *clip, int blend_flags)
+{
+    SDL_Rect srcrect, dstrect;
+
+    if (first > last) {
+        return 0;
     }
-    return 0;
+    srcrect.x = first;
+    srcrect.y = 0;
+    srcrect.w = last - first + 1;
+    srcrect.h = 1;
+    dstrect.x = x + first;
+    dstrect.y = y;
+    dstrect.w = srcrect.w;
+    dstrect.h = 1;
+    return _pg_blit_surfaces(rowsurf, NULL, &srcrect, dst, &dstrect, clip,
+                             blend_flags);
 }
 
+/* Draws srcrect of the 32 bit sample stretched over dstrect, with nearest
+ * neighbour sampling, a row of rowsurf at a time. */
 static int
-scroll_default(int h, int dx, int dy, int pitch, int span, int xoffset,
-               Uint8 *startsrc, Uint8 *endsrc, Uint8 *linesrc, int erase)
+_pg_blit_stretched(SDL_Surface *sample, SDL_Rect *srcrect,
+                   SDL_Surface *rowsurf, SDL_Surface *dst, SDL_Rect *dstrect,
+                   int blend_flags)
 {
-    if (dy != 0) {
-        /* Copy the current line to a before or after position if it's
-           valid with consideration of x offset and memset to avoid
-           artifacts */
-        int yincrease = dy > 0 ? -pitch : pitch;
-        while (h--) {
-            Uint8 *pastesrc = linesrc + pitch * dy;
-            if ((dy < 0 && pastesrc >= startsrc) ||
-                (dy > 0 && pastesrc <= endsrc)) {
-                if (dx > 0) {
-                    memcpy(pastesrc + xoffset, linesrc, span - xoffset);
-                }
-                else if (dx < 0) {
-                    memcpy(pastesrc, linesrc - xoffset, span + xoffset);
-                }
-                else {
-                    memcpy(pastesrc, linesrc, span);
-                }
-                if (erase) {
-                    memset(linesrc, 0, span);
-                    // Fix the missing pixel bug
-                    if (dx < 0) {
-                        memset(pastesrc + span + xoffset, 0, -xoffset);
-                    }
-                    else if (dx > 0) {
-                        memset(pastesrc, 0, xoffset);
-                    }
-                }
-            }
-            linesrc += yincrease;
-        }
+    SDL_Surface *view;
+    SDL_Rect area, clip;
+    double ratiox, ratioy;
+    int y, first, last, stepx, result = 0;
+
+    PG_GetSurfaceClipRect(dst, &clip);
+    if (!SDL_IntersectRect(dstrect, &clip, &area)) {
+        return 0;
     }
-    else {
-        // No y-shifting, we only need to move pixels on the same line
-        while (h--) {
-            if (dx > 0) {
-                memmove(linesrc + xoffset, linesrc, span - xoffset);
-                if (erase) {
-                    memset(linesrc, 0, xoffset);
-                }
-            }
-            else if (dx < 0) {
-                memmove(linesrc, linesrc - xoffset, span + xoffset);
-                if (erase) {
-                    memset(linesrc + span + xoffset, 0, -xoffset);
-                }
-            }
-            linesrc += pitch;
-        }
+    /* The sampler reads the whole surface it is given, so a view keeps the
+     * filtering inside srcrect */
+    view = PG_CreateSurfaceFrom(
+        srcrect->w, srcrect->h, PG_SURF_FORMATENUM(sample),
+        (Uint8 *)sample->pixels + (size_t)srcrect->y * sample->pitch +
+            srcrect->x * 4,
+        sample->pitch);
+    if (!view) {
+        return -1;
     }
-    return 0;
+
+    ratiox = (double)srcrect->w / dstrect->w;
+    ratioy = (double)srcrect->h / dstrect->h;
+    /* Rounded down, so that the last pixel never samples past the edge */
+    stepx = (int)(ratiox * 65536.0);
+    for (y = area.y; y < area.y + area.h && !result; y++) {
+        transformRowRGBA(
+            view, rowsurf->pixels, area.w,
+            (int)((area.x - dstrect->x + 0.5) * ratiox * 65536.0),
+            (int)((y - dstrect->y + 0.5) * ratioy * 65536.0), stepx, 0, 0,
+            &first, &last);
+        result = _pg_blit_row(rowsurf, first, last, dst, area.x, y, &clip,
+                              blend_flags);
+    }
+    SDL_FreeSurface(view);
+    return result;
 }
 
+/* Repeats srcrect of src over dstrect of dst, starting offx, offy pixels
+ * into the pattern. */
 static int
-scroll(SDL_Surface *surf, int dx, int dy, int x, int y, int w, int h,
-       int repeat, int erase)
+_pg_blit_tiled(SDL_Surface *src, struct pgSpanCache *spans,
+               SDL_Rect *srcrect, SDL_Surface *dst, SDL_Rect *dstrect,
+               int offx, int offy, int blend_flags)
 {
-    int bpp = PG_SURF_BytesPerPixel(surf);
-    int pitch = surf->pitch;
-    int span = w * bpp;
-    Uint8 *linesrc = (Uint8 *)surf->pixels + pitch * y + bpp * x;
-    Uint8 *startsrc = linesrc;
-    int xoffset = dx * bpp;
-    Uint8 *endsrc = linesrc;
-    if (dy > 0) {
-        endsrc = linesrc + pitch * (h - 1);
-        linesrc = endsrc;
+    SDL_Rect orig_clip, area, tile_src, tile_dst;
+    Sint64 start;
+    int x, y, x0, y0, result = 0;
+
+    PG_GetSurfaceClipRect(dst, &orig_clip);
+    if (!SDL_IntersectRect(dstrect, &orig_clip, &area)) {
+        return 0;
     }
+    offx %= srcrect->w;
+    offy %= srcrect->h;
+    if (offx < 0) {
+        offx += srcrect->w;
+    }
+    if (offy < 0) {
+        offy += srcrect->h;
+    }
+
+    /* Start at the first tile column and row overlapping area, dstrect can
+     * begin far outside of it */
+    start = (Sint64)dstrect->x - offx;
+    x0 = (int)(start + (area.x - start) / srcrect->w * srcrect->w);
+    start = (Sint64)dstrect->y - offy;
+    y0 = (int)(start + (area.y - start) / srcrect->h * srcrect->h);
+
+    /* Tiles are drawn whole, the clip rect trims the ones on the edges */
+    SDL_SetClipRect(dst, &area);
+    for (y = y0; y < area.y + area.h && !result; y += srcrect->h) {
+        for (x = x0; x < area.x + area.w && !result; x += srcrect->w) {
+            tile_src = *srcrect;
+            tile_dst.x = x;
+            tile_dst.y = y;
+            tile_dst.w = srcrect->w;
+            tile_dst.h = srcrect->h;
+            result = _pg_blit_surfaces(src, spans, &tile_src, dst, &tile_dst,
+                                       &area, blend_flags);
+        }
+    }
+    SDL_SetClipRect(dst, &orig_clip);
+    return result;
+}
 
-    if (repeat) {
-        return scroll_repeat(h, dx, dy, pitch, span, xoffset, startsrc, endsrc,
-                             linesrc);
+static PyObject *
+_pg_blit_error(int result)
+{
+    if (result == -2) {
+        return RAISE(pgExc_SDLError, "Surface was lost");
     }
-    else {
-        return scroll_default(h, dx, dy, pitch, span, xoffset, startsrc,
-                              endsrc, linesrc, erase);
+    if (result == -1) {
+        return RAISE(pgExc_SDLError, SDL_GetError());
     }
+    return NULL;
 }
 
 static PyObject *
-surf_scroll(PyObject *self, PyObject *args, PyObject *keywds)
+surf_blit_transformed(pgSurfaceObject *self, PyObject *args,
+                      PyObject *keywds)
 {
-    int dx = 0, dy = 0, scroll_flag = PGS_SCROLL_DEFAULT;
-    int erase = 0, repeat = 0;
-    SDL_Surface *surf;
-    SDL_Rect work_rect;
-    int w = 0, h = 0, x = 0, y = 0;
-
-    static char *kwids[] = {"dx", "dy", "scroll_flag", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, keywds, "|iii", kwids, &dx, &dy,
-                                     &scroll_flag)) {
+    SDL_Surface *src, *sample, *rowsurf, *dest = pgSurface_AsSurface(self);
+    SDL_Rect *rect, temp, area, clip;
+    PyObject *argpos;
+    pgSurfaceObject *srcobject;
+    double angle = 0.0, scale = 1.0, rad, c, s, bw, bh, fx, fy, ox, oy;
+    double u, v;
+    Sint64 x0, y0, x1, y1;
+    int flip_x = 0, flip_y = 0, blend_flags = 0, smooth = 1;
+    int dx, dy, y, first, last, stepx, stepy, result = 0;
+
+    static char *kwids[] = {"source", "dest",   "angle",         "scale",
+                            "flip_x", "flip_y", "special_flags", "smooth",
+                            NULL};
+    if (!PyArg_ParseTupleAndKeywords(
+            args, keywds, "O!O|ddppip", kwids, &pgSurface_Type, &srcobject,
+            &argpos, &angle, &scale, &flip_x, &flip_y, &blend_flags,
+            &smooth)) {
         return NULL;
     }
 
-    surf = pgSurface_AsSurface(self);
-    SURF_INIT_CHECK(surf)
+    src = pgSurface_AsSurface(srcobject);
+    SURF_INIT_CHECK(src)
+    SURF_INIT_CHECK(dest)
 
-    if (dx == 0 && dy == 0) {
-        Py_RETURN_NONE;
+    if ((rect = pgRect_FromObject(argpos, &temp))) {
+        dx = rect->x;
+        dy = rect->y;
     }
-
-    switch (scroll_flag) {
-        case PGS_SCROLL_REPEAT: {
-            repeat = 1;
-            break;
-        }
-        case PGS_SCROLL_ERASE: {
-            erase = 1;
-            break;
-        }
-        default: {
-            if (scroll_flag != PGS_SCROLL_DEFAULT) {
-                return RAISE(PyExc_ValueError, "Invalid scroll flag");
-            }
-        }
+    else if (!pg_TwoIntsFromObj(argpos, &dx, &dy)) {
+        return RAISE(PyExc_TypeError, "invalid destination position for blit");
     }
 
-    SDL_Rect clip_rect;
-    if (!PG_GetSurfaceClipRect(surf, &clip_rect)) {
-        return RAISE(pgExc_SDLError, SDL_GetError());
+    if (!(scale > 0.0) || !isfinite(scale) || !isfinite(angle)) {
+        return RAISE(PyExc_ValueError,
+                     "scale must be a positive number and angle finite");
     }
-
-    SDL_Rect surf_rect = {0, 0, surf->w, surf->h};
-
-    // In SDL3, SDL_IntersectRect is renamed to SDL_GetRectIntersection
-    if (!SDL_IntersectRect(&clip_rect, &surf_rect, &work_rect)) {
-        Py_RETURN_NONE;
+    /* Source coordinates of the whole bounding box must fit in 16.16 */
+    if (src->w + src->h > 32767) {
+        return RAISE(PyExc_ValueError, "source Surface is too large");
     }
 
-    w = work_rect.w;
-    h = work_rect.h;
-    x = work_rect.x;
-    y = work_rect.y;
+    rad = fmod(angle, 360.0) * M_PI / 180.0;
+    c = cos(rad);
+    s = sin(rad);
+    bw = ceil(fabs(src->w * scale * c) + fabs(src->h * scale * s) - 1e-6);
+    bh = ceil(fabs(src->w * scale * s) + fabs(src->h * scale * c) - 1e-6);
+    if (bw > INT_MAX / 2 || bh > INT_MAX / 2) {
+        return RAISE(PyExc_ValueError, "scale is too large");
+    }
 
-    /* If the clip rect is outside the surface fill and return
-      for scrolls without repeat. Only fill when erase is true */
-    if (!repeat) {
-        if (dx >= w || dx <= -w || dy >= h || dy <= -h) {
-            if (erase) {
-                if (!PG_FillSurfaceRect(surf, NULL, 0)) {
-                    PyErr_SetString(pgExc_SDLError, SDL_GetError());
-                    return NULL;
-                }
-            }
-            Py_RETURN_NONE;
-        }
+    PG_GetSurfaceClipRect(dest, &clip);
+    x0 = MAX((Sint64)dx, clip.x);
+    y0 = MAX((Sint64)dy, clip.y);
+    x1 = MIN((Sint64)dx + (Sint64)bw, (Sint64)clip.x + clip.w);
+    y1 = MIN((Sint64)dy + (Sint64)bh, (Sint64)clip.y + clip.h);
+    if (x1 <= x0 || y1 <= y0 || src->w == 0 || src->h == 0) {
+        return pgRect_New4(dx, dy, 0, 0);
     }
-    // Repeated scrolls are periodic so we can delete the exceeding value
-    dx = dx % w;
-    dy = dy % h;
+    area.x = (int)x0;
+    area.y = (int)y0;
+    area.w = (int)(x1 - x0);
+    area.h = (int)(y1 - y0);
 
-    if (!pgSurface_Lock((pgSurfaceObject *)self)) {
+    if (!pgSurface_Unshare(self) || !pgSurface_Prep(self)) {
         return NULL;
     }
-
-    if (scroll(surf, dx, dy, x, y, w, h, repeat, erase) < 0) {
-        pgSurface_Unlock((pgSurfaceObject *)self);
+    if (!pgSurface_Prep(srcobject)) {
+        pgSurface_Unprep(self);
         return NULL;
     }
-
-    if (!pgSurface_Unlock((pgSurfaceObject *)self)) {
+    sample = _pg_sample_surface(src, dest, 1);
+    rowsurf = sample ? _pg_new_row_surface(sample, area.w) : NULL;
+    if (!rowsurf) {
+        if (sample && sample != src) {
+            SDL_FreeSurface(sample);
+        }
+        pgSurface_Unprep(srcobject);
+        pgSurface_Unprep(self);
         return NULL;
     }
 
-    Py_RETURN_NONE;
-}
+    /* Inverse mapping: the center of each destination pixel is rotated and
+     * scaled back to the source, flipping the source first */
+    fx = flip_x ? -1.0 : 1.0;
+    fy = flip_y ? -1.0 : 1.0;
+    /* Bilinear filtering interpolates between pixel centers */
+    ox = src->w / 2.0 - (smooth ? 0.5 : 0.0);
+    oy = src->h / 2.0 - (smooth ? 0.5 : 0.0);
+    stepx = _pg_fixed(c / scale * fx);
+    stepy = _pg_fixed(s / scale * fy);
+    u = area.x - dx + 0.5 - bw / 2.0;
+
+    for (y = area.y; y < area.y + area.h && !result; y++) {
+        v = y - dy + 0.5 - bh / 2.0;
+        transformRowRGBA(sample, rowsurf->pixels, area.w,
+                         _pg_fixed((u * c - v * s) / scale * fx + ox),
+                         _pg_fixed((u * s + v * c) / scale * fy + oy), stepx,
+                         stepy, smooth, &first, &last);
+        result = _pg_blit_row(rowsurf, first, last, dest, area.x, y, &clip,
+                              blend_flags);
+    }
+    pgSurface_Unprep(self);
 
-static int
-_PgSurface_SrcAlpha(SDL_Surface *surf)
-{
-    SDL_BlendMode mode;
-    if (!PG_GetSurfaceBlendMode(surf, &mode)) {
-        PyErr_SetString(pgExc_SDLError, SDL_GetError());
-        return -1;
+    _pg_free_row_surface(rowsurf);
+    if (sample != src) {
+        SDL_FreeSurface(sample);
     }
-    return (mode != SDL_BLENDMODE_NONE);
+    pgSurface_Unprep(srcobject);
+    if (result) {
+        return _pg_blit_error(result);
+    }
+
+    pgSurface_AddDirtyRect(self, &area);
+    return pgRect_New(&area);
 }
 
 static PyObject *
-surf_get_flags(PyObject *self, PyObject *_null)
+surf_blit_tiled(pgSurfaceObject *self, PyObject *args, PyObject *keywds)
 {
-    Uint32 sdl_flags = 0;
-#if SDL_VERSION_ATLEAST(3, 0, 0)
-    SDL_WindowFlags window_flags = 0;
-#else
-    Uint32 window_flags = 0;
-#endif
-    Uint32 flags = 0;
-    int is_alpha;
-    int is_window_surf = 0;
-    SDL_Window *win = pg_GetDefaultWindow();
+    SDL_Surface *src, *tiles, *dest = pgSurface_AsSurface(self);
+    SDL_Rect *rect, temp, srcrect, area, clip;
+    PyObject *argrect, *argoffset = NULL;
+    pgSurfaceObject *srcobject;
+    struct pgSpanCache *spans;
+    int offx = 0, offy = 0, blend_flags = 0, result;
+
+    static char *kwids[] = {"source", "dest", "offset", "special_flags",
+                            NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, keywds, "O!O|Oi", kwids,
+                                     &pgSurface_Type, &srcobject, &argrect,
+                                     &argoffset, &blend_flags)) {
+        return NULL;
+    }
 
-    SDL_Surface *surf = pgSurface_AsSurface(self);
+    src = pgSurface_AsSurface(srcobject);
+    SURF_INIT_CHECK(src)
+    SURF_INIT_CHECK(dest)
 
-    SURF_INIT_CHECK(surf)
+    if (!(rect = pgRect_FromObject(argrect, &temp))) {
+        return RAISE(PyExc_TypeError, "Invalid rectstyle argument");
+    }
+    if (argoffset && !pg_TwoIntsFromObj(argoffset, &offx, &offy)) {
+        return RAISE(PyExc_TypeError, "offset must be a pair of integers");
+    }
 
-    if (win && pg_GetDefaultWindowSurface()) {
-        if (surf == pgSurface_AsSurface(pg_GetDefaultWindowSurface())) {
-            is_window_surf = 1;
-            window_flags = SDL_GetWindowFlags(win);
-        }
+    PG_GetSurfaceClipRect(dest, &clip);
+    if (src->w == 0 || src->h == 0 ||
+        !SDL_IntersectRect(rect, &clip, &area)) {
+        return pgRect_New4(rect->x, rect->y, 0, 0);
     }
-    sdl_flags = surf->flags;
-    if ((is_alpha = _PgSurface_SrcAlpha(surf)) == -1) {
+
+    if (!pgSurface_Unshare(self) || !pgSurface_Prep(self)) {
         return NULL;
     }
-    if (is_alpha) {
-        flags |= PGS_SRCALPHA;
+    if (!pgSurface_Prep(srcobject)) {
+        pgSurface_Unprep(self);
+        return NULL;
     }
-    if (SDL_HasColorKey(surf)) {
-        flags |= PGS_SRCCOLORKEY;
+    if (!(tiles = _pg_sample_surface(src, dest, 0))) {
+        pgSurface_Unprep(srcobject);
+        pgSurface_Unprep(self);
+        return NULL;
     }
-    if (sdl_flags & SDL_PREALLOC) {
-        flags |= PGS_PREALLOC;
-    }
-    /* This checks if RLE was requested on the surface */
-    if (PG_SurfaceHasRLE(surf)) {
-        flags |= PGS_RLEACCELOK;
-    }
-    /* this checks if the surface actually has RLE.
-     * On SDL2: SDL_MUSTLOCK is (flags & SDL_RLEACCEL) */
-    if (SDL_MUSTLOCK(surf)) {
-        flags |= PGS_RLEACCEL;
-    }
-    if (is_window_surf) {
-        if (window_flags & PG_WINDOW_FULLSCREEN_INCLUSIVE) {
-            flags |= PGS_FULLSCREEN;
-        }
-        if (window_flags & SDL_WINDOW_OPENGL) {
-            flags |= PGS_OPENGL;
-        }
-        if (window_flags & SDL_WINDOW_RESIZABLE) {
-            flags |= PGS_RESIZABLE;
-        }
-        if (window_flags & SDL_WINDOW_BORDERLESS) {
-            flags |= PGS_NOFRAME;
-        }
-    }
-
-    return PyLong_FromLong((long)flags);
-}
-
-static PyObject *
-surf_get_pitch(PyObject *self, PyObject *_null)
-{
-    SDL_Surface *surf = pgSurface_AsSurface(self);
+    srcrect.x = srcrect.y = 0;
+    srcrect.w = src->w;
+    srcrect.h = src->h;
 
-    SURF_INIT_CHECK(surf)
-    return PyLong_FromLong(surf->pitch);
-}
-
-static PyObject *
-surf_get_size(PyObject *self, PyObject *_null)
-{
-    SDL_Surface *surf = pgSurface_AsSurface(self);
-
-    SURF_INIT_CHECK(surf)
-    return pg_tuple_couple_from_values_int(surf->w, surf->h);
-}
-
-static PyObject *
-surf_get_width(PyObject *self, PyObject *_null)
-{
-    SDL_Surface *surf = pgSurface_AsSurface(self);
-
-    SURF_INIT_CHECK(surf)
-    return PyLong_FromLong(surf->w);
-}
+    spans = tiles == src ? _pg_surface_spans(srcobject) : NULL;
+    result = _pg_blit_tiled(tiles, spans, &srcrect, dest, rect, offx, offy,
+                            blend_flags);
+    pgSurface_Unprep(self);
 
-static PyObject *
-surf_get_height(PyObject *self, PyObject *_null)
-{
-    SDL_Surface *surf = pgSurface_AsSurface(self);
+    if (tiles != src) {
+        SDL_FreeSurface(tiles);
+    }
+    pgSurface_Unprep(srcobject);
+    if (result) {
+        return _pg_blit_error(result);
+    }
 
-    SURF_INIT_CHECK(surf)
-    return PyLong_FromLong(surf->h);
+    pgSurface_AddDirtyRect(self, &area);
+    return pgRect_New(&area);
 }
 
-static PyObject *
-surf_get_rect(PyObject *self, PyObject *const *args, Py_ssize_t nargs,
-              PyObject *kwnames)
+/* Splits length into the sizes of the two borders and the middle, shrinking
+ * the borders in proportion when they do not fit */
+static void
+_pg_nine_slice_split(int length, int first, int second, int *out)
 {
-    SDL_Surface *surf = pgSurface_AsSurface(self);
-    SURF_INIT_CHECK(surf)
-
-    PyObject *rect = pgRect_New4(0, 0, surf->w, surf->h);
-
-    return pgObject_getRectHelper(rect, args, nargs, kwnames, "rect");
+    if (first + second > length) {
+        out[1] = (int)((Sint64)first * length / (first + second));
+        out[2] = out[1];
+    }
+    else {
+        out[1] = first;
+        out[2] = length - second;
+    }
+    out[0] = 0;
+    out[3] = length;
 }
 
 static PyObject *
-surf_get_frect(PyObject *self, PyObject *const *args, Py_ssize_t nargs,
-               PyObject *kwnames)
+surf_blit_nine_slice(pgSurfaceObject *self, PyObject *args, PyObject *keywds)
 {
-    SDL_Surface *surf = pgSurface_AsSurface(self);
-    SURF_INIT_CHECK(surf)
-
-    PyObject *rect = pgFRect_New4(0.f, 0.f, (float)surf->w, (float)surf->h);
+    SDL_Surface *src, *pieces, *sample = NULL, *rowsurf = NULL;
+    SDL_Surface *dest = pgSurface_AsSurface(self);
+    SDL_Rect *rect, temp, area, clip, srcrect, dstrect;
+    PyObject *argrect, *argborders;
+    pgSurfaceObject *srcobject;
+    struct pgSpanCache *spans;
+    const char *mode = "stretch";
+    int borders[4], srcx[4], srcy[4], dstx[4], dsty[4];
+    int blend_flags = 0, tile, i, j, result = 0;
+
+    static char *kwids[] = {"source", "dest", "borders", "mode",
+                            "special_flags", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, keywds, "O!OO|si", kwids,
+                                     &pgSurface_Type, &srcobject, &argrect,
+                                     &argborders, &mode, &blend_flags)) {
+        return NULL;
+    }
 
-    return pgObject_getRectHelper(rect, args, nargs, kwnames, "frect");
-}
+    src = pgSurface_AsSurface(srcobject);
+    SURF_INIT_CHECK(src)
+    SURF_INIT_CHECK(dest)
 
-static PyObject *
-surf_get_bitsize(PyObject *self, PyObject *_null)
-{
-    SDL_Surface *surf = pgSurface_AsSurface(self);
-    SURF_INIT_CHECK(surf)
+    if (!(rect = pgRect_FromObject(argrect, &temp))) {
+        return RAISE(PyExc_TypeError, "Invalid rectstyle argument");
+    }
+    if (pg_IntFromObj(argborders, &borders[0])) {
+        borders[1] = borders[2] = borders[3] = borders[0];
+    }
+    else if (!PySequence_Check(argborders) ||
+             PySequence_Size(argborders) != 4 ||
+             !pg_IntFromObjIndex(argborders, 0, &borders[0]) ||
+             !pg_IntFromObjIndex(argborders, 1, &borders[1]) ||
+             !pg_IntFromObjIndex(argborders, 2, &borders[2]) ||
+             !pg_IntFromObjIndex(argborders, 3, &borders[3])) {
+        PyErr_Clear();
+        return RAISE(PyExc_TypeError,
+                     "borders must be an integer or a sequence of 4 "
+                     "integers (left, top, right, bottom)");
+    }
+    if (borders[0] < 0 || borders[1] < 0 || borders[2] < 0 ||
+        borders[3] < 0 || borders[0] + borders[2] > src->w ||
+        borders[1] + borders[3] > src->h) {
+        return RAISE(PyExc_ValueError,
+                     "borders must be positive and fit in the source Surface");
+    }
+    if (!strcmp(mode, "stretch")) {
+        tile = 0;
+    }
+    else if (!strcmp(mode, "tile")) {
+        tile = 1;
+    }
+    else {
+        return RAISE(PyExc_ValueError, "mode must be 'stretch' or 'tile'");
+    }
 
-    return PyLong_FromLong(PG_SURF_BitsPerPixel(surf));
-}
+    PG_GetSurfaceClipRect(dest, &clip);
+    if (!SDL_IntersectRect(rect, &clip, &area)) {
+        return pgRect_New4(rect->x, rect->y, 0, 0);
+    }
 
-static PyObject *
-surf_get_bytesize(PyObject *self, PyObject *_null)
-{
-    SDL_Surface *surf = pgSurface_AsSurface(self);
-    SURF_INIT_CHECK(surf)
+    if (!pgSurface_Unshare(self)) {
+        return NULL;
+    }
 
-    return PyLong_FromLong(PG_SURF_BytesPerPixel(surf));
-}
+    srcx[0] = 0;
+    srcx[1] = borders[0];
+    srcx[2] = src->w - borders[2];
+    srcx[3] = src->w;
+    srcy[0] = 0;
+    srcy[1] = borders[1];
+    srcy[2] = src->h - borders[3];
+    srcy[3] = src->h;
+    _pg_nine_slice_split(rect->w, borders[0], borders[2], dstx);
+    _pg_nine_slice_split(rect->h, borders[1], borders[3], dsty);
 
-static PyObject *
-surf_get_masks(PyObject *self, PyObject *_null)
-{
-    SDL_Surface *surf = pgSurface_AsSurface(self);
+    if (!pgSurface_Prep(self)) {
+        return NULL;
+    }
+    if (!pgSurface_Prep(srcobject)) {
+        pgSurface_Unprep(self);
+        return NULL;
+    }
+    if (!(pieces = _pg_sample_surface(src, dest, 0))) {
+        pgSurface_Unprep(srcobject);
+        pgSurface_Unprep(self);
+        return NULL;
+    }
 
-    SURF_INIT_CHECK(surf)
+    spans = pieces == src ? _pg_surface_spans(srcobject) : NULL;
+    for (j = 0; j < 3 && !result; j++) {
+        for (i = 0; i < 3 && !result; i++) {
+            srcrect.x = srcx[i];
+            srcrect.y = srcy[j];
+            srcrect.w = srcx[i + 1] - srcx[i];
+            srcrect.h = srcy[j + 1] - srcy[j];
+            dstrect.x = rect->x + dstx[i];
+            dstrect.y = rect->y + dsty[j];
+            dstrect.w = dstx[i + 1] - dstx[i];
+            dstrect.h = dsty[j + 1] - dsty[j];
+            if (srcrect.w <= 0 || srcrect.h <= 0 || dstrect.w <= 0 ||
+                dstrect.h <= 0) {
+                continue;
+            }
 
-    PG_PixelFormat *format = PG_GetSurfaceFormat(surf);
-    if (format == NULL) {
-        return RAISE(pgExc_SDLError, SDL_GetError());
+            if (srcrect.w == dstrect.w && srcrect.h == dstrect.h) {
+                result = _pg_blit_surfaces(pieces, spans, &srcrect, dest,
+                                           &dstrect, &clip, blend_flags);
+            }
+            /* Corners are only resized when the borders do not fit */
+            else if (tile && (i == 1 || j == 1)) {
+                result = _pg_blit_tiled(pieces, spans, &srcrect, dest,
+                                        &dstrect, 0, 0, blend_flags);
+            }
+            else {
+                if (!rowsurf) {
+                    if (!(sample = _pg_sample_surface(pieces, dest, 1)) ||
+                        !(rowsurf = _pg_new_row_surface(sample, area.w))) {
+                        result = 1;
+                        break;
+                    }
+                }
+                result = _pg_blit_stretched(sample, &srcrect, rowsurf, dest,
+                                            &dstrect, blend_flags);
+            }
+        }
     }
+    pgSurface_Unprep(self);
 
-    return Py_BuildValue("(IIII)", format->Rmask, format->Gmask, format->Bmask,
-                         format->Amask);
-}
+    if (rowsurf) {
+        _pg_free_row_surface(rowsurf);
+    }
+    if (sample && sample != pieces) {
+        SDL_FreeSurface(sample);
+    }
+    if (pieces != src) {
+        SDL_FreeSurface(pieces);
+    }
+    pgSurface_Unprep(srcobject);
+    if (result) {
+        return _pg_blit_error(result);
+    }
 
-static PyObject *
-surf_set_masks(PyObject *self, PyObject *args)
-{
-    return RAISE(PyExc_TypeError, "The surface masks are read-only in SDL2");
+    pgSurface_AddDirtyRect(self, &area);
+    return pgRect_New(&area);
 }
 
-static PyObject *
-surf_get_shifts(PyObject *self, PyObject *_null)
+/* Reads one tile index of a tilemap array. kind is 'i' for signed and 'u'
+ * for unsigned items. Unsigned indices past the Sint64 range come back as
+ * -1, so they are skipped like any other index outside the tileset. */
+static Sint64
+_pg_tilemap_read_index(const char *p, char kind, Py_ssize_t itemsize)
 {
-    SDL_Surface *surf = pgSurface_AsSurface(self);
-
-    SURF_INIT_CHECK(surf)
-
-    PG_PixelFormat *format = PG_GetSurfaceFormat(surf);
-    if (format == NULL) {
-        return RAISE(pgExc_SDLError, SDL_GetError());
+    switch (itemsize) {
+        case 1:
+            return kind == 'u' ? *(const Uint8 *)p : *(const Sint8 *)p;
+        case 2: {
+            Uint16 u;
+            Sint16 v;
+            memcpy(&u, p, 2);
+            memcpy(&v, p, 2);
+            return kind == 'u' ? u : v;
+        }
+        case 4: {
+            Uint32 u;
+            Sint32 v;
+            memcpy(&u, p, 4);
+            memcpy(&v, p, 4);
+            return kind == 'u' ? u : v;
+        }
+        default: {
+            Uint64 u;
+            Sint64 v;
+            memcpy(&u, p, 8);
+            memcpy(&v, p, 8);
+            if (kind == 'u') {
+                return u > (Uint64)INT64_MAX ? -1 : (Sint64)u;
+            }
+            return v;
+        }
     }
-
-    return Py_BuildValue("(iiii)", format->Rshift, format->Gshift,
-                         format->Bshift, format->Ashift);
 }
 
-static PyObject *
-surf_set_shifts(PyObject *self, PyObject *args)
+/* Index of the tile holding pixel pos of a row or column, rounded down */
+static Sint64
+_pg_tile_floor(Sint64 pos, int size)
 {
-    return RAISE(PyExc_TypeError, "The surface shifts are read-only in SDL2");
+    return pos >= 0 ? pos / size : -((-pos + size - 1) / size);
 }
 
 static PyObject *
-surf_get_losses(PyObject *self, PyObject *_null)
+surf_blit_tilemap(pgSurfaceObject *self, PyObject *args, PyObject *keywds)
 {
-    SDL_Surface *surf = pgSurface_AsSurface(self);
+    SDL_Surface *tileset, *tiles, *dest = pgSurface_AsSurface(self);
+    SDL_Rect *rect, temp, viewport, area, orig_clip, srcrect, dstrect;
+    PyObject *argsize, *argtiles, *argoffset = NULL, *argviewport = NULL;
+    pgSurfaceObject *srcobject;
+    struct pgSpanCache *spans;
+    Py_buffer view;
+    Sint64 originx, originy, col0, col1, row0, row1, col, row, index;
+    const char *p;
+    char kind;
+    int tilew, tileh, setcols, count, offx = 0, offy = 0;
+    int blend_flags = 0, result = 0;
+
+    static char *kwids[] = {"tileset", "tile_size", "tiles", "offset",
+                            "viewport", "special_flags", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, keywds, "O!OO|OOi", kwids,
+                                     &pgSurface_Type, &srcobject, &argsize,
+                                     &argtiles, &argoffset, &argviewport,
+                                     &blend_flags)) {
+        return NULL;
+    }
 
-    SURF_INIT_CHECK(surf)
+    tileset = pgSurface_AsSurface(srcobject);
+    SURF_INIT_CHECK(tileset)
+    SURF_INIT_CHECK(dest)
 
-    PG_PixelFormat *format = PG_GetSurfaceFormat(surf);
-    if (format == NULL) {
-        return RAISE(pgExc_SDLError, SDL_GetError());
+    if (!pg_TwoIntsFromObj(argsize, &tilew, &tileh)) {
+        return RAISE(PyExc_TypeError, "tile_size must be a pair of integers");
+    }
+    if (tilew <= 0 || tileh <= 0) {
+        return RAISE(PyExc_ValueError, "tile_size must be positive");
+    }
+    if (argoffset && !pg_TwoIntsFromObj(argoffset, &offx, &offy)) {
+        return RAISE(PyExc_TypeError, "offset must be a pair of integers");
+    }
+    if (argviewport && argviewport != Py_None) {
+        if (!(rect = pgRect_FromObject(argviewport, &temp))) {
+            return RAISE(PyExc_TypeError, "Invalid rectstyle argument");
+        }
+        viewport = *rect;
+    }
+    else {
+        viewport.x = viewport.y = 0;
+        viewport.w = dest->w;
+        viewport.h = dest->h;
     }
 
-    return Py_BuildValue("(iiii)", PG_FORMAT_R_LOSS(format),
-                         PG_FORMAT_G_LOSS(format), PG_FORMAT_B_LOSS(format),
-                         PG_FORMAT_A_LOSS(format));
-}
+    if (PyObject_GetBuffer(argtiles, &view, PyBUF_RECORDS_RO)) {
+        return NULL;
+    }
+    kind = _blitbatch_view_kind(&view);
+    if (view.ndim != 2 || (kind != 'i' && kind != 'u')) {
+        PyBuffer_Release(&view);
+        return RAISE(PyExc_ValueError, "tiles must be a 2D array of integers");
+    }
 
-static PyObject *
-surf_subsurface(PyObject *self, PyObject *args)
-{
-    SDL_Surface *surf = pgSurface_AsSurface(self);
-    SDL_Rect *rect, temp;
-    SDL_Surface *sub;
-    PyObject *subobj;
-    struct pgSubSurface_Data *data;
-    Uint8 alpha;
-    Uint32 colorkey;
+    PG_GetSurfaceClipRect(dest, &orig_clip);
+    if (!SDL_IntersectRect(&viewport, &orig_clip, &area)) {
+        PyBuffer_Release(&view);
+        return pgRect_New4(viewport.x, viewport.y, 0, 0);
+    }
 
-    SURF_INIT_CHECK(surf)
+    /* Only the tiles overlapping the clipped viewport are drawn */
+    setcols = tileset->w / tilew;
+    count = setcols * (tileset->h / tileh);
+    originx = (Sint64)viewport.x - offx;
+    originy = (Sint64)viewport.y - offy;
+    col0 = MAX(_pg_tile_floor(area.x - originx, tilew), 0);
+    col1 = MIN(_pg_tile_floor(area.x + area.w - 1 - originx, tilew),
+               (Sint64)view.shape[1] - 1);
+    row0 = MAX(_pg_tile_floor(area.y - originy, tileh), 0);
+    row1 = MIN(_pg_tile_floor(area.y + area.h - 1 - originy, tileh),
+               (Sint64)view.shape[0] - 1);
 
-    PG_PixelFormat *format;
-    SDL_Palette *palette;
-    if (!PG_GetSurfaceDetails(surf, &format, &palette)) {
-        return RAISE(pgExc_SDLError, SDL_GetError());
+    if (!pgSurface_Unshare(self)) {
+        PyBuffer_Release(&view);
+        return NULL;
     }
 
-    if (!(rect = pgRect_FromObject(args, &temp))) {
-        return RAISE(PyExc_ValueError, "invalid rectstyle argument");
+    if (!pgSurface_Prep(self)) {
+        PyBuffer_Release(&view);
+        return NULL;
     }
-    if (rect->x < 0 || rect->y < 0 || rect->x + rect->w > surf->w ||
-        rect->y + rect->h > surf->h) {
-        return RAISE(PyExc_ValueError,
-                     "subsurface rectangle outside surface area");
+    if (!pgSurface_Prep(srcobject)) {
+        pgSurface_Unprep(self);
+        PyBuffer_Release(&view);
+        return NULL;
+    }
+    if (!(tiles = _pg_sample_surface(tileset, dest, 0))) {
+        pgSurface_Unprep(srcobject);
+        pgSurface_Unprep(self);
+        PyBuffer_Release(&view);
+        return NULL;
     }
 
-    pgSurface_Lock((pgSurfaceObject *)self);
-
-    char *startpixel = ((char *)surf->pixels) +
-                       rect->x * PG_FORMAT_BytesPerPixel(format) +
-                       rect->y * surf->pitch;
-
-    sub = PG_CreateSurfaceFrom(rect->w, rect->h, format->format, startpixel,
-                               surf->pitch);
-
-    pgSurface_Unlock((pgSurfaceObject *)self);
+    spans = tiles == tileset ? _pg_surface_spans(srcobject) : NULL;
+    SDL_SetClipRect(dest, &area);
+    for (row = row0; row <= row1 && !result; row++) {
+        p = (const char *)view.buf + row * view.strides[0] +
+            col0 * view.strides[1];
+        for (col = col0; col <= col1 && !result;
+             col++, p += view.strides[1]) {
+            index = _pg_tilemap_read_index(p, kind, view.itemsize);
+            if (index < 0 || index >= count) {
+                continue;
+            }
+            /* index < count, so it fits in an int from here on */
+            srcrect.x = (int)index % setcols * tilew;
+            srcrect.y = (int)index / setcols * tileh;
+            srcrect.w = tilew;
+            srcrect.h = tileh;
+            dstrect.x = (int)(originx + col * tilew);
+            dstrect.y = (int)(originy + row * tileh);
+            dstrect.w = tilew;
+            dstrect.h = tileh;
+            result = _pg_blit_surfaces(tiles, spans, &srcrect, dest,
+                                       &dstrect, &area, blend_flags);
+        }
+    }
+    SDL_SetClipRect(dest, &orig_clip);
+    pgSurface_Unprep(self);
 
-    if (!sub) {
-        return RAISE(pgExc_SDLError, SDL_GetError());
+    if (tiles != tileset) {
+        SDL_FreeSurface(tiles);
+    }
+    pgSurface_Unprep(srcobject);
+    PyBuffer_Release(&view);
+    if (result) {
+        return _pg_blit_error(result);
     }
 
-    /* copy the colormap if we need it */
-    if (SDL_ISPIXELFORMAT_INDEXED(format->format) && palette) {
-        SDL_Color *colors = palette->colors;
-        int ncolors = palette->ncolors;
-        SDL_Palette *pal = SDL_AllocPalette(ncolors);
+    pgSurface_AddDirtyRect(self, &area);
+    return pgRect_New(&area);
+}
 
-        if (!pal) {
-            PyErr_SetString(pgExc_SDLError, SDL_GetError());
-            SDL_FreeSurface(sub);
-            return NULL;
-        }
-        if (!PG_SetPaletteColors(pal, colors, 0, ncolors)) {
-            PyErr_SetString(pgExc_SDLError, SDL_GetError());
-            SDL_FreePalette(pal);
-            SDL_FreeSurface(sub);
-            return NULL;
+static int
+scroll_repeat(int h, int dx, int dy, int pitch, int span, int xoffset,
+              Uint8 *startsrc, Uint8 *endsrc, Uint8 *linesrc)
+{
+    if (dy != 0) {
+        int yincrease = dy > 0 ? -pitch : pitch;
+        int spanincrease = dy > 0 ? -span : span;
+        int templen = (dy > 0 ? dy * span : -dy * span);
+        int tempheight = (dy > 0 ? dy : -dy);
+        /* Create a temporary buffer to store the pixels that
+           are disappearing from the surface */
+        Uint8 *tempbuf = (Uint8 *)malloc(templen);
+        if (tempbuf == NULL) {
+            PyErr_NoMemory();
+            return -1;
         }
-        if (!PG_SetSurfacePalette(sub, pal)) {
-            PyErr_SetString(pgExc_SDLError, SDL_GetError());
-            SDL_FreePalette(pal);
-            SDL_FreeSurface(sub);
-            return NULL;
+        memset(tempbuf, 0, templen);
+        Uint8 *templine = tempbuf;
+        Uint8 *tempend =
+            templine + (dy > 0 ? (dy - 1) * span : -(dy + 1) * span);
+        if (dy > 0) {
+            templine = tempend;
         }
-        SDL_FreePalette(pal);
-    }
-    if (!PG_GetSurfaceAlphaMod(surf, &alpha)) {
-        PyErr_SetString(pgExc_SDLError, SDL_GetError());
-        SDL_FreeSurface(sub);
-        return NULL;
-    }
-    if (alpha != 255) {
-        if (!PG_SetSurfaceAlphaMod(sub, alpha)) {
-            PyErr_SetString(pgExc_SDLError, SDL_GetError());
-            SDL_FreeSurface(sub);
-            return NULL;
+        int looph = h;
+        while (looph--) {
+            // If the current line should disappear copy it to the
+            // temporary buffer
+            if ((templine <= tempend && dy < 0) ||
+                (templine >= tempbuf && dy > 0)) {
+                if (dx > 0) {
+                    memcpy(templine, linesrc + span - xoffset, xoffset);
+                    memcpy(templine + xoffset, linesrc, span - xoffset);
+                }
+                else if (dx < 0) {
+                    memcpy(templine + span + xoffset, linesrc, -xoffset);
+                    memcpy(templine, linesrc - xoffset, span + xoffset);
+                }
+                else {
+                    memcpy(templine, linesrc, span);
+                }
+                memset(linesrc, 0, span);
+                templine += spanincrease;
+            }
+            else {
+                Uint8 *pastesrc = linesrc + pitch * dy;
+                if ((dy < 0 && pastesrc >= startsrc) ||
+                    (dy > 0 && pastesrc <= endsrc)) {
+                    if (dx > 0) {
+                        memcpy(pastesrc, linesrc + span - xoffset, xoffset);
+                        memcpy(pastesrc + xoffset, linesrc, span - xoffset);
+                    }
+                    else if (dx < 0) {
+                        memcpy(pastesrc + span + xoffset, linesrc, -xoffset);
+                        memcpy(pastesrc, linesrc - xoffset, span + xoffset);
+                    }
+                    else {
+                        memcpy(pastesrc, linesrc, span);
+                    }
+                }
+            }
+            linesrc += yincrease;
+        }
+        // Copy the data of the buffer back to the original pixels to
+        // repeat
+        templine = tempbuf;
+        if (dy < 0) {
+            linesrc = startsrc + pitch * (h - tempheight);
+        }
+        else {
+            linesrc = startsrc;
         }
+        while (tempheight--) {
+            memcpy(linesrc, templine, span);
+            linesrc += pitch;
+            templine += span;
+        }
+        free(tempbuf);
     }
-    if (SDL_HasColorKey(surf)) {
-        SDL_GetColorKey(surf, &colorkey);
-        if (!PG_SetSurfaceColorKey(sub, SDL_TRUE, colorkey)) {
-            PyErr_SetString(pgExc_SDLError, SDL_GetError());
-            SDL_FreeSurface(sub);
-            return NULL;
+    else {
+        // No y-shifting, the temporary buffer should only store the x loss
+        Uint8 *tempbuf = (Uint8 *)malloc((dx > 0 ? xoffset : -xoffset));
+        if (tempbuf == NULL) {
+            PyErr_NoMemory();
+            return -1;
+        }
+        while (h--) {
+            if (dx > 0) {
+                memcpy(tempbuf, linesrc + span - xoffset, xoffset);
+                memmove(linesrc + xoffset, linesrc, span - xoffset);
+                memcpy(linesrc, tempbuf, xoffset);
+            }
+            else if (dx < 0) {
+                memcpy(tempbuf, linesrc, -xoffset);
+                memmove(linesrc, linesrc - xoffset, span + xoffset);
+                memcpy(linesrc + span + xoffset, tempbuf, -xoffset);
+            }
+            linesrc += pitch;
         }
+        free(tempbuf);
     }
+    return 0;
+}
 
-    data = PyMem_New(struct pgSubSurface_Data, 1);
-    if (!data) {
-        return NULL;
+static int
+scroll_default(int h, int dx, int dy, int pitch, int span, int xoffset,
+               Uint8 *startsrc, Uint8 *endsrc, Uint8 *linesrc, int erase)
+{
+    if (dy != 0) {
+        /* Copy the current line to a before or after position if it's
+           valid with consideration of x offset and memset to avoid
+           artifacts */
+        int yincrease = dy > 0 ? -pitch : pitch;
+        while (h--) {
+            Uint8 *pastesrc = linesrc + pitch * dy;
+            if ((dy < 0 && pastesrc >= startsrc) ||
+                (dy > 0 && pastesrc <= endsrc)) {
+                if (dx > 0) {
+                    memcpy(pastesrc + xoffset, linesrc, span - xoffset);
+                }
+                else if (dx < 0) {
+                    memcpy(pastesrc, linesrc - xoffset, span + xoffset);
+                }
+                else {
+                    memcpy(pastesrc, linesrc, span);
+                }
+                if (erase) {
+                    memset(linesrc, 0, span);
+                    // Fix the missing pixel bug
+                    if (dx < 0) {
+                        memset(pastesrc + span + xoffset, 0, -xoffset);
+                    }
+                    else if (dx > 0) {
+                        memset(pastesrc, 0, xoffset);
+                    }
+                }
+            }
+            linesrc += yincrease;
+        }
     }
-
-    subobj = surf_subtype_new(Py_TYPE(self), sub, 1);
-    if (!subobj) {
-        PyMem_Free(data);
-        return NULL;
+    else {
+        // No y-shifting, we only need to move pixels on the same line
+        while (h--) {
+            if (dx > 0) {
+                memmove(linesrc + xoffset, linesrc, span - xoffset);
+                if (erase) {
+                    memset(linesrc, 0, xoffset);
+                }
+            }
+            else if (dx < 0) {
+                memmove(linesrc, linesrc - xoffset, span + xoffset);
+                if (erase) {
+                    memset(linesrc + span + xoffset, 0, -xoffset);
+                }
+            }
+            linesrc += pitch;
+        }
     }
-    Py_INCREF(self);
-    data->owner = self;
-    data->offsetx = rect->x;
-    data->offsety = rect->y;
-    ((pgSurfaceObject *)subobj)->subsurface = data;
-
-    return subobj;
+    return 0;
 }
 
-static PyObject *
-surf_get_offset(PyObject *self, PyObject *_null)
+static int
+scroll(SDL_Surface *surf, int dx, int dy, int x, int y, int w, int h,
+       int repeat, int erase)
 {
-    SDL_Surface *surf = pgSurface_AsSurface(self);
-    struct pgSubSurface_Data *subdata;
-
-    SURF_INIT_CHECK(surf)
+    int bpp = PG_SURF_BytesPerPixel(surf);
+    int pitch = surf->pitch;
+    int span = w * bpp;
+    Uint8 *linesrc = (Uint8 *)surf->pixels + pitch * y + bpp * x;
+    Uint8 *startsrc = linesrc;
+    int xoffset = dx * bpp;
+    Uint8 *endsrc = linesrc;
+    if (dy > 0) {
+        endsrc = linesrc + pitch * (h - 1);
+        linesrc = endsrc;
+    }
 
-    subdata = ((pgSurfaceObject *)self)->subsurface;
-    if (!subdata) {
-        return pg_tuple_couple_from_values_int(0, 0);
+    if (repeat) {
+        return scroll_repeat(h, dx, dy, pitch, span, xoffset, startsrc, endsrc,
+                             linesrc);
+    }
+    else {
+        return scroll_default(h, dx, dy, pitch, span, xoffset, startsrc,
+                              endsrc, linesrc, erase);
     }
-    return pg_tuple_couple_from_values_int(subdata->offsetx, subdata->offsety);
 }
 
 static PyObject *
-surf_get_abs_offset(PyObject *self, PyObject *_null)
+surf_scroll(PyObject *self, PyObject *args, PyObject *keywds)
 {
-    SDL_Surface *surf = pgSurface_AsSurface(self);
-    struct pgSubSurface_Data *subdata;
-    PyObject *owner;
-    int offsetx, offsety;
-
-    SURF_INIT_CHECK(surf)
+    int dx = 0, dy = 0, scroll_flag = PGS_SCROLL_DEFAULT;
+    int erase = 0, repeat = 0;
+    SDL_Surface *surf;
+    SDL_Rect work_rect;
+    int w = 0, h = 0, x = 0, y = 0;
 
-    subdata = ((pgSurfaceObject *)self)->subsurface;
-    if (!subdata) {
-        return pg_tuple_couple_from_values_int(0, 0);
+    static char *kwids[] = {"dx", "dy", "scroll_flag", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, keywds, "|iii", kwids, &dx, &dy,
+                                     &scroll_flag)) {
+        return NULL;
     }
 
-    subdata = ((pgSurfaceObject *)self)->subsurface;
-    owner = subdata->owner;
-    offsetx = subdata->offsetx;
-    offsety = subdata->offsety;
+    surf = pgSurface_AsSurface(self);
+    SURF_INIT_CHECK(surf)
 
-    while (((pgSurfaceObject *)owner)->subsurface) {
-        subdata = ((pgSurfaceObject *)owner)->subsurface;
-        owner = subdata->owner;
-        offsetx += subdata->offsetx;
-        offsety += subdata->offsety;
+    if (dx == 0 && dy == 0) {
+        Py_RETURN_NONE;
     }
-    return pg_tuple_couple_from_values_int(offsetx, offsety);
-}
+
+    if (!pgSurface_Unshare((pgSurfaceObject *)self)) {
+        return NULL;
+    }
+
+    switch (scroll_flag) {
+        case PGS_SCROLL_REPEAT: {
+            repeat = 1;
+            break;
+        }
+        case PGS_SCROLL_ERASE: {
+            erase = 1;
+            break;
+        }
+        default: {
+            if (scroll_flag != PGS_SCROLL_DEFAULT) {
+                return RAISE(PyExc_ValueError, "Invalid scroll flag");
+            }
+        }
+    }
+
+    SDL_Rect clip_rect;
+    if (!PG_GetSurfaceClipRect(surf, &clip_rect)) {
+        return RAISE(pgExc_SDLError, SDL_GetError());
+    }
+
+    SDL_Rect surf_rect = {0, 0, surf->w, surf->h};
+
+    // In SDL3, SDL_IntersectRect is renamed to SDL_GetRectIntersection
+    if (!SDL_IntersectRect(&clip_rect, &surf_rect, &work_rect)) {
+        Py_RETURN_NONE;
+    }
+
+    w = work_rect.w;
+    h = work_rect.h;
+    x = work_rect.x;
+    y = work_rect.y;
+
+    /* If the clip rect is outside the surface fill and return
+      for scrolls without repeat. Only fill when erase is true */
+    if (!repeat) {
+        if (dx >= w || dx <= -w || dy >= h || dy <= -h) {
+            if (erase) {
+                if (!PG_FillSurfaceRect(surf, NULL, 0)) {
+                    PyErr_SetString(pgExc_SDLError, SDL_GetError());
+                    return NULL;
+                }
+                pgSurface_AddDirtyRect((pgSurfaceObject *)self, NULL);
+            }
+            Py_RETURN_NONE;
+        }
+    }
+    // Repeated scrolls are periodic so we can delete the exceeding value
+    dx = dx % w;
+    dy = dy % h;
+
+    if (!pgSurface_Lock((pgSurfaceObject *)self)) {
+        return NULL;
+    }
+
+    if (scroll(surf, dx, dy, x, y, w, h, repeat, erase) < 0) {
+        pgSurface_Unlock((pgSurfaceObject *)self);
+        return NULL;
+    }
+
+    if (!pgSurface_Unlock((pgSurfaceObject *)self)) {
+        return NULL;
+    }
+
+    pgSurface_AddDirtyRect((pgSurfaceObject *)self, &work_rect);
+    Py_RETURN_NONE;
+}
+
+static int
+_PgSurface_SrcAlpha(SDL_Surface *surf)
+{
+    SDL_BlendMode mode;
+    if (!PG_GetSurfaceBlendMode(surf, &mode)) {
+        PyErr_SetString(pgExc_SDLError, SDL_GetError());
+        return -1;
+    }
+    return (mode != SDL_BLENDMODE_NONE);
+}
 
 static PyObject *
-surf_get_parent(PyObject *self, PyObject *_null)
+surf_get_flags(PyObject *self, PyObject *_null)
 {
+    Uint32 sdl_flags = 0;
+#if SDL_VERSION_ATLEAST(3, 0, 0)
+    SDL_WindowFlags window_flags = 0;
+#else
+    Uint32 window_flags = 0;
+#endif
+    Uint32 flags = 0;
+    int is_alpha;
+    int is_window_surf = 0;
+    SDL_Window *win = pg_GetDefaultWindow();
+
     SDL_Surface *surf = pgSurface_AsSurface(self);
-    struct pgSubSurface_Data *subdata;
 
     SURF_INIT_CHECK(surf)
 
-    subdata = ((pgSurfaceObject *)self)->subsurface;
-    if (!subdata) {
-        Py_RETURN_NONE;
+    if (win && pg_GetDefaultWindowSurface()) {
+        if (surf == pgSurface_AsSurface(pg_GetDefaultWindowSurface())) {
+            is_window_surf = 1;
+            window_flags = SDL_GetWindowFlags(win);
+        }
+    }
+    sdl_flags = surf->flags;
+    if ((is_alpha = _PgSurface_SrcAlpha(surf)) == -1) {
+        return NULL;
+    }
+    if (is_alpha) {
+        flags |= PGS_SRCALPHA;
+    }
+    if (SDL_HasColorKey(surf)) {
+        flags |= PGS_SRCCOLORKEY;
+    }
+    if (sdl_flags & SDL_PREALLOC) {
+        flags |= PGS_PREALLOC;
+    }
+    /* This checks if RLE was requested on the surface */
+    if (PG_SurfaceHasRLE(surf)) {
+        flags |= PGS_RLEACCELOK;
+    }
+    /* this checks if the surface actually has RLE.
+     * On SDL2: SDL_MUSTLOCK is (flags & SDL_RLEACCEL) */
+    if (SDL_MUSTLOCK(surf)) {
+        flags |= PGS_RLEACCEL;
+    }
+    if (is_window_surf) {
+        if (window_flags & PG_WINDOW_FULLSCREEN_INCLUSIVE) {
+            flags |= PGS_FULLSCREEN;
+        }
+        if (window_flags & SDL_WINDOW_OPENGL) {
+            flags |= PGS_OPENGL;
+        }
+        if (window_flags & SDL_WINDOW_RESIZABLE) {
+            flags |= PGS_RESIZABLE;
+        }
+        if (window_flags & SDL_WINDOW_BORDERLESS) {
+            flags |= PGS_NOFRAME;
+        }
     }
 
-    Py_INCREF(subdata->owner);
-    return subdata->owner;
+    return PyLong_FromLong((long)flags);
 }
 
 static PyObject *
-surf_get_abs_parent(PyObject *self, PyObject *_null)
+surf_get_pitch(PyObject *self, PyObject *_null)
 {
     SDL_Surface *surf = pgSurface_AsSurface(self);
-    struct pgSubSurface_Data *subdata;
-    PyObject *owner;
 
     SURF_INIT_CHECK(surf)
+    return PyLong_FromLong(surf->pitch);
+}
 
-    subdata = ((pgSurfaceObject *)self)->subsurface;
-    if (!subdata) {
-        Py_INCREF(self);
-        return self;
-    }
+static PyObject *
+surf_get_size(PyObject *self, PyObject *_null)
+{
+    SDL_Surface *surf = pgSurface_AsSurface(self);
 
-    subdata = ((pgSurfaceObject *)self)->subsurface;
-    owner = subdata->owner;
+    SURF_INIT_CHECK(surf)
+    return pg_tuple_couple_from_values_int(surf->w, surf->h);
+}
 
-    while (((pgSurfaceObject *)owner)->subsurface) {
-        subdata = ((pgSurfaceObject *)owner)->subsurface;
-        owner = subdata->owner;
-    }
+static PyObject *
+surf_get_width(PyObject *self, PyObject *_null)
+{
+    SDL_Surface *surf = pgSurface_AsSurface(self);
 
-    Py_INCREF(owner);
-    return owner;
+    SURF_INIT_CHECK(surf)
+    return PyLong_FromLong(surf->w);
 }
 
 static PyObject *
-surf_get_bounding_rect(PyObject *self, PyObject *args, PyObject *kwargs)
+surf_get_height(PyObject *self, PyObject *_null)
 {
-#if SDL_BYTEORDER == SDL_LIL_ENDIAN
-    const int BYTE0 = 0;
-    const int BYTE1 = 1;
-    const int BYTE2 = 2;
-#else
-    const int BYTE0 = 2;
-    const int BYTE1 = 1;
-    const int BYTE2 = 0;
-#endif
-    PyObject *rect;
     SDL_Surface *surf = pgSurface_AsSurface(self);
-    Uint8 *pixels = NULL;
-    Uint8 *pixel;
-    int x, y;
-    int min_x, min_y, max_x, max_y;
-    int min_alpha = 1;
-    int found_alpha = 0;
-    Uint32 value;
-    Uint8 r, g, b, a;
-    int has_colorkey = 0;
-    Uint32 colorkey;
-    Uint8 keyr, keyg, keyb;
 
-    char *kwids[] = {"min_alpha", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|i", kwids, &min_alpha)) {
-        return RAISE(PyExc_ValueError,
-                     "get_bounding_rect only accepts a single optional "
-                     "min_alpha argument");
-    }
+    SURF_INIT_CHECK(surf)
+    return PyLong_FromLong(surf->h);
+}
 
+static PyObject *
+surf_get_rect(PyObject *self, PyObject *const *args, Py_ssize_t nargs,
+              PyObject *kwnames)
+{
+    SDL_Surface *surf = pgSurface_AsSurface(self);
     SURF_INIT_CHECK(surf)
 
-    if (!pgSurface_Lock((pgSurfaceObject *)self)) {
-        return RAISE(pgExc_SDLError, "could not lock surface");
-    }
+    PyObject *rect = pgRect_New4(0, 0, surf->w, surf->h);
 
-    PG_PixelFormat *format;
-    SDL_Palette *palette;
-    if (!PG_GetSurfaceDetails(surf, &format, &palette)) {
-        return RAISE(pgExc_SDLError, SDL_GetError());
-    }
-    int bpp = PG_FORMAT_BytesPerPixel(format);
+    return pgObject_getRectHelper(rect, args, nargs, kwnames, "rect");
+}
 
-    if ((has_colorkey = SDL_HasColorKey(surf))) {
-        SDL_GetColorKey(surf, &colorkey);
-        PG_GetRGBA(colorkey, format, palette, &keyr, &keyg, &keyb, &a);
-    }
+static PyObject *
+surf_get_frect(PyObject *self, PyObject *const *args, Py_ssize_t nargs,
+               PyObject *kwnames)
+{
+    SDL_Surface *surf = pgSurface_AsSurface(self);
+    SURF_INIT_CHECK(surf)
 
-    pixels = (Uint8 *)surf->pixels;
-    min_y = 0;
-    min_x = 0;
-    max_x = surf->w;
-    max_y = surf->h;
+    PyObject *rect = pgFRect_New4(0.f, 0.f, (float)surf->w, (float)surf->h);
 
-    found_alpha = 0;
-    for (y = max_y - 1; y >= min_y; --y) {
-        for (x = min_x; x < max_x; ++x) {
-            pixel = (pixels + y * surf->pitch) + x * bpp;
-            switch (bpp) {
-                case 1:
-                    value = *pixel;
-                    break;
-                case 2:
-                    value = *(Uint16 *)pixel;
-                    break;
-                case 3:
-                    value = pixel[BYTE0];
-                    value |= pixel[BYTE1] << 8;
-                    value |= pixel[BYTE2] << 16;
-                    break;
-                default:
-                    assert(bpp == 4);
-                    value = *(Uint32 *)pixel;
-            }
-            PG_GetRGBA(value, format, palette, &r, &g, &b, &a);
-            if ((a >= min_alpha && has_colorkey == 0) ||
-                (has_colorkey != 0 && (r != keyr || g != keyg || b != keyb))) {
-                found_alpha = 1;
-                break;
-            }
-        }
-        if (found_alpha == 1) {
-            break;
-        }
-        max_y = y;
-    }
-    found_alpha = 0;
-    for (x = max_x - 1; x >= min_x; --x) {
-        for (y = min_y; y < max_y; ++y) {
-            pixel = (pixels + y * surf->pitch) + x * bpp;
-            switch (bpp) {
-                case 1:
-                    value = *pixel;
-                    break;
-                case 2:
-                    value = *(Uint16 *)pixel;
-                    break;
-                case 3:
-                    value = pixel[BYTE0];
-                    value |= pixel[BYTE1] << 8;
-                    value |= pixel[BYTE2] << 16;
-                    break;
-                default:
-                    assert(bpp == 4);
-                    value = *(Uint32 *)pixel;
-            }
-            PG_GetRGBA(value, format, palette, &r, &g, &b, &a);
-            if ((a >= min_alpha && has_colorkey == 0) ||
-                (has_colorkey != 0 && (r != keyr || g != keyg || b != keyb))) {
-                found_alpha = 1;
-                break;
-            }
-        }
-        if (found_alpha == 1) {
-            break;
-        }
-        max_x = x;
-    }
-    found_alpha = 0;
-    for (y = min_y; y < max_y; ++y) {
-        min_y = y;
-        for (x = min_x; x < max_x; ++x) {
-            pixel = (pixels + y * surf->pitch) + x * bpp;
-            switch (bpp) {
-                case 1:
-                    value = *pixel;
-                    break;
-                case 2:
-                    value = *(Uint16 *)pixel;
-                    break;
-                case 3:
-                    value = pixel[BYTE0];
-                    value |= pixel[BYTE1] << 8;
-                    value |= pixel[BYTE2] << 16;
-                    break;
-                default:
-                    assert(bpp == 4);
-                    value = *(Uint32 *)pixel;
-            }
-            PG_GetRGBA(value, format, palette, &r, &g, &b, &a);
-            if ((a >= min_alpha && has_colorkey == 0) ||
-                (has_colorkey != 0 && (r != keyr || g != keyg || b != keyb))) {
-                found_alpha = 1;
-                break;
-            }
-        }
-        if (found_alpha == 1) {
-            break;
-        }
-    }
-    found_alpha = 0;
-    for (x = min_x; x < max_x; ++x) {
-        min_x = x;
-        for (y = min_y; y < max_y; ++y) {
-            pixel = (pixels + y * surf->pitch) + x * bpp;
-            switch (bpp) {
-                case 1:
-                    value = *pixel;
-                    break;
-                case 2:
-                    value = *(Uint16 *)pixel;
-                    break;
-                case 3:
-                    value = pixel[BYTE0];
-                    value |= pixel[BYTE1] << 8;
-                    value |= pixel[BYTE2] << 16;
-                    break;
-                default:
-                    assert(bpp == 4);
-                    value = *(Uint32 *)pixel;
-            }
-            PG_GetRGBA(value, format, palette, &r, &g, &b, &a);
-            if ((a >= min_alpha && has_colorkey == 0) ||
-                (has_colorkey != 0 && (r != keyr || g != keyg || b != keyb))) {
-                found_alpha = 1;
-                break;
-            }
-        }
-        if (found_alpha == 1) {
-            break;
-        }
-    }
-    if (!pgSurface_Unlock((pgSurfaceObject *)self)) {
-        return RAISE(pgExc_SDLError, "could not unlock surface");
+    return pgObject_getRectHelper(rect, args, nargs, kwnames, "frect");
+}
+
+static PyObject *
+surf_get_bitsize(PyObject *self, PyObject *_null)
+{
+    SDL_Surface *surf = pgSurface_AsSurface(self);
+    SURF_INIT_CHECK(surf)
+
+    return PyLong_FromLong(PG_SURF_BitsPerPixel(surf));
+}
+
+static PyObject *
+surf_get_bytesize(PyObject *self, PyObject *_null)
+{
+    SDL_Surface *surf = pgSurface_AsSurface(self);
+    SURF_INIT_CHECK(surf)
+
+    return PyLong_FromLong(PG_SURF_BytesPerPixel(surf));
+}
+
+static PyObject *
+surf_get_masks(PyObject *self, PyObject *_null)
+{
+    SDL_Surface *surf = pgSurface_AsSurface(self);
+
+    SURF_INIT_CHECK(surf)
+
+    PG_PixelFormat *format = PG_GetSurfaceFormat(surf);
+    if (format == NULL) {
+        return RAISE(pgExc_SDLError, SDL_GetError());
     }
 
-    rect = pgRect_New4(min_x, min_y, max_x - min_x, max_y - min_y);
-    return rect;
+    return Py_BuildValue("(IIII)", format->Rmask, format->Gmask, format->Bmask,
+                         format->Amask);
 }
 
 static PyObject *
-_raise_get_view_ndim_error(int bitsize, SurfViewKind kind)
+surf_set_masks(PyObject *self, PyObject *args)
 {
-    const char *name = "<unknown>"; /* guard against a segfault */
+    return RAISE(PyExc_TypeError, "The surface masks are read-only in SDL2");
+}
 
-    /* Put a human readable name to a surface view kind */
-    switch (kind) {
-            /* This switch statement is exhaustive over the SurfViewKind enum
-             */
+static PyObject *
+surf_get_shifts(PyObject *self, PyObject *_null)
+{
+    SDL_Surface *surf = pgSurface_AsSurface(self);
 
-        case VIEWKIND_0D:
-            name = "contiguous bytes";
-            break;
-        case VIEWKIND_1D:
-            name = "contiguous pixels";
-            break;
-        case VIEWKIND_2D:
-            name = "2D";
-            break;
-        case VIEWKIND_3D:
-            name = "3D";
-            break;
-        case VIEWKIND_RED:
-            name = "red";
-            break;
-        case VIEWKIND_GREEN:
-            name = "green";
-            break;
-        case VIEWKIND_BLUE:
-            name = "blue";
-            break;
-        case VIEWKIND_ALPHA:
-            name = "alpha";
-            break;
+    SURF_INIT_CHECK(surf)
 
-#ifndef NDEBUG
-            /* Assert this switch statement is exhaustive */
-        default:
-            /* Should not be here */
-            PyErr_Format(PyExc_SystemError,
-                         "pygame bug in _raise_get_view_ndim_error:"
-                         " unknown view kind %d",
-                         (int)kind);
-            return 0;
-#endif
+    PG_PixelFormat *format = PG_GetSurfaceFormat(surf);
+    if (format == NULL) {
+        return RAISE(pgExc_SDLError, SDL_GetError());
     }
-    PyErr_Format(PyExc_ValueError,
-                 "unsupported bit depth %d for %s reference array", bitsize,
-                 name);
-    return 0;
+
+    return Py_BuildValue("(iiii)", format->Rshift, format->Gshift,
+                         format->Bshift, format->Ashift);
 }
 
 static PyObject *
-surf_get_view(PyObject *self, PyObject *args)
+surf_set_shifts(PyObject *self, PyObject *args)
 {
-    SDL_Surface *surface = pgSurface_AsSurface(self);
-    Uint32 mask = 0;
-    SurfViewKind view_kind = VIEWKIND_2D;
-    getbufferproc get_buffer = 0;
+    return RAISE(PyExc_TypeError, "The surface shifts are read-only in SDL2");
+}
 
-    if (!PyArg_ParseTuple(args, "|O&", _view_kind, &view_kind)) {
-        return 0;
+static PyObject *
+surf_get_losses(PyObject *self, PyObject *_null)
+{
+    SDL_Surface *surf = pgSurface_AsSurface(self);
+
+    SURF_INIT_CHECK(surf)
+
+    PG_PixelFormat *format = PG_GetSurfaceFormat(surf);
+    if (format == NULL) {
+        return RAISE(pgExc_SDLError, SDL_GetError());
     }
 
-    SURF_INIT_CHECK(surface)
+    return Py_BuildValue("(iiii)", PG_FORMAT_R_LOSS(format),
+                         PG_FORMAT_G_LOSS(format), PG_FORMAT_B_LOSS(format),
+                         PG_FORMAT_A_LOSS(format));
+}
+
+static PyObject *
+surf_subsurface(PyObject *self, PyObject *args)
+{
+    SDL_Surface *surf = pgSurface_AsSurface(self);
+    SDL_Rect *rect, temp;
+    SDL_Surface *sub;
+    PyObject *subobj;
+    struct pgSubSurface_Data *data;
+    Uint8 alpha;
+    Uint32 colorkey;
+
+    SURF_INIT_CHECK(surf)
 
     PG_PixelFormat *format;
     SDL_Palette *palette;
-    if (!PG_GetSurfaceDetails(surface, &format, &palette)) {
+    if (!PG_GetSurfaceDetails(surf, &format, &palette)) {
         return RAISE(pgExc_SDLError, SDL_GetError());
     }
-    int bpp = PG_FORMAT_BytesPerPixel(format);
-
-    switch (view_kind) {
-            /* This switch statement is exhaustive over the SurfViewKind enum
-             */
 
-        case VIEWKIND_0D:
-            if (surface->pitch != bpp * surface->w) {
-                PyErr_SetString(PyExc_ValueError,
-                                "Surface data is not contiguous");
-                return 0;
-            }
-            get_buffer = _get_buffer_0D;
-            break;
-        case VIEWKIND_1D:
-            if (surface->pitch != bpp * surface->w) {
-                PyErr_SetString(PyExc_ValueError,
-                                "Surface data is not contiguous");
-                return 0;
-            }
-            get_buffer = _get_buffer_1D;
-            break;
-        case VIEWKIND_2D:
-            get_buffer = _get_buffer_2D;
-            break;
-        case VIEWKIND_3D:
-            if (bpp < 3) {
-                return _raise_get_view_ndim_error(bpp * 8, view_kind);
-            }
-            if (format->Gmask != 0x00ff00 &&
-                (bpp != 4 || format->Gmask != 0xff0000)) {
-                return RAISE(PyExc_ValueError,
-                             "unsupported colormasks for 3D reference array");
-            }
-            get_buffer = _get_buffer_3D;
-            break;
-        case VIEWKIND_RED:
-            mask = format->Rmask;
-            if (mask != 0x000000ffU && mask != 0x0000ff00U &&
-                mask != 0x00ff0000U && mask != 0xff000000U) {
-                return RAISE(PyExc_ValueError,
-                             "unsupported colormasks for red reference array");
-            }
-            get_buffer = _get_buffer_red;
-            break;
-        case VIEWKIND_GREEN:
-            mask = format->Gmask;
-            if (mask != 0x000000ffU && mask != 0x0000ff00U &&
-                mask != 0x00ff0000U && mask != 0xff000000U) {
-                return RAISE(
-                    PyExc_ValueError,
-                    "unsupported colormasks for green reference array");
-            }
-            get_buffer = _get_buffer_green;
-            break;
-        case VIEWKIND_BLUE:
-            mask = format->Bmask;
-            if (mask != 0x000000ffU && mask != 0x0000ff00U &&
-                mask != 0x00ff0000U && mask != 0xff000000U) {
-                return RAISE(
-                    PyExc_ValueError,
-                    "unsupported colormasks for blue reference array");
-            }
-            get_buffer = _get_buffer_blue;
-            break;
-        case VIEWKIND_ALPHA:
-            mask = format->Amask;
-            if (mask != 0x000000ffU && mask != 0x0000ff00U &&
-                mask != 0x00ff0000U && mask != 0xff000000U) {
-                return RAISE(
-                    PyExc_ValueError,
-                    "unsupported colormasks for alpha reference array");
-            }
-            get_buffer = _get_buffer_alpha;
-            break;
+    if (!(rect = pgRect_FromObject(args, &temp))) {
+        return RAISE(PyExc_ValueError, "invalid rectstyle argument");
+    }
+    if (rect->x < 0 || rect->y < 0 || rect->x + rect->w > surf->w ||
+        rect->y + rect->h > surf->h) {
+        return RAISE(PyExc_ValueError,
+                     "subsurface rectangle outside surface area");
+    }
 
-#ifndef NDEBUG
-            /* Assert this switch statement is exhaustive */
-        default:
-            /* Should not be here */
-            PyErr_Format(PyExc_SystemError,
-                         "pygame bug in surf_get_view:"
-                         " unrecognized view kind %d",
-                         (int)view_kind);
-            return 0;
-#endif
+    pgSurface_Lock((pgSurfaceObject *)self);
+
+    char *startpixel = ((char *)surf->pixels) +
+                       rect->x * PG_FORMAT_BytesPerPixel(format) +
+                       rect->y * surf->pitch;
+
+    sub = PG_CreateSurfaceFrom(rect->w, rect->h, format->format, startpixel,
+                               surf->pitch);
+
+    pgSurface_Unlock((pgSurfaceObject *)self);
+
+    if (!sub) {
+        return RAISE(pgExc_SDLError, SDL_GetError());
     }
-    assert(get_buffer);
-    return pgBufferProxy_New(self, get_buffer);
+
+    /* copy the colormap if we need it */
+    if (SDL_ISPIXELFORMAT_INDEXED(format->format) && palette) {
+        SDL_Color *colors = palette->colors;
+        int ncolors = palette->ncolors;
+        SDL_Palette *pal = SDL_AllocPalette(ncolors);
+
+        if (!pal) {
+            PyErr_SetString(pgExc_SDLError, SDL_GetError());
+            SDL_FreeSurface(sub);
+            return NULL;
+        }
+        if (!PG_SetPaletteColors(pal, colors, 0, ncolors)) {
+            PyErr_SetString(pgExc_SDLError, SDL_GetError());
+            SDL_FreePalette(pal);
+            SDL_FreeSurface(sub);
+            return NULL;
+        }
+        if (!PG_SetSurfacePalette(sub, pal)) {
+            PyErr_SetString(pgExc_SDLError, SDL_GetError());
+            SDL_FreePalette(pal);
+            SDL_FreeSurface(sub);
+            return NULL;
+        }
+        SDL_FreePalette(pal);
+    }
+    if (!PG_GetSurfaceAlphaMod(surf, &alpha)) {
+        PyErr_SetString(pgExc_SDLError, SDL_GetError());
+        SDL_FreeSurface(sub);
+        return NULL;
+    }
+    if (alpha != 255) {
+        if (!PG_SetSurfaceAlphaMod(sub, alpha)) {
+            PyErr_SetString(pgExc_SDLError, SDL_GetError());
+            SDL_FreeSurface(sub);
+            return NULL;
+        }
+    }
+    if (SDL_HasColorKey(surf)) {
+        SDL_GetColorKey(surf, &colorkey);
+        if (!PG_SetSurfaceColorKey(sub, SDL_TRUE, colorkey)) {
+            PyErr_SetString(pgExc_SDLError, SDL_GetError());
+            SDL_FreeSurface(sub);
+            return NULL;
+        }
+    }
+
+    data = PyMem_New(struct pgSubSurface_Data, 1);
+    if (!data) {
+        return NULL;
+    }
+
+    subobj = surf_subtype_new(Py_TYPE(self), sub, 1);
+    if (!subobj) {
+        PyMem_Free(data);
+        return NULL;
+    }
+    Py_INCREF(self);
+    data->owner = self;
+    data->offsetx = rect->x;
+    data->offsety = rect->y;
+    ((pgSurfaceObject *)subobj)->subsurface = data;
+
+    return subobj;
 }
 
 static PyObject *
-surf_get_buffer(PyObject *self, PyObject *_null)
+surf_get_offset(PyObject *self, PyObject *_null)
 {
-    SDL_Surface *surface = pgSurface_AsSurface(self);
-    PyObject *proxy_obj;
+    SDL_Surface *surf = pgSurface_AsSurface(self);
+    struct pgSubSurface_Data *subdata;
 
-    SURF_INIT_CHECK(surface)
+    SURF_INIT_CHECK(surf)
 
-    proxy_obj = pgBufferProxy_New(self, _get_buffer_0D);
-    if (proxy_obj) {
-        if (pgBufferProxy_Trip(proxy_obj)) {
-            Py_DECREF(proxy_obj);
-            proxy_obj = 0;
-        }
+    subdata = ((pgSurfaceObject *)self)->subsurface;
+    if (!subdata) {
+        return pg_tuple_couple_from_values_int(0, 0);
     }
-    return proxy_obj;
+    return pg_tuple_couple_from_values_int(subdata->offsetx, subdata->offsety);
 }
 
 static PyObject *
-surf_premul_alpha(pgSurfaceObject *self, PyObject *_null)
+surf_get_abs_offset(PyObject *self, PyObject *_null)
 {
     SDL_Surface *surf = pgSurface_AsSurface(self);
-    PyObject *final;
-    SDL_Surface *newsurf;
+    struct pgSubSurface_Data *subdata;
+    PyObject *owner;
+    int offsetx, offsety;
 
     SURF_INIT_CHECK(surf)
 
-    pgSurface_Prep(self);
-    // Make a copy of the surface first
-    newsurf = PG_ConvertSurface(surf, surf->format);
-
-    if ((surf->w > 0 && surf->h > 0)) {
-        // If the surface has no pixels we don't need to premul
-        // just return the copy.
-        int result = premul_surf_color_by_alpha(surf, newsurf);
-        if (result == -1) {
-            return RAISE(PyExc_ValueError,
-                         "source surface to be alpha pre-multiplied must have "
-                         "alpha channel");
-        }
-        else if (result == -2) {
-            return RAISE(pgExc_SDLError, SDL_GetError());
-        }
+    subdata = ((pgSurfaceObject *)self)->subsurface;
+    if (!subdata) {
+        return pg_tuple_couple_from_values_int(0, 0);
     }
-    pgSurface_Unprep(self);
 
-    final = surf_subtype_new(Py_TYPE(self), newsurf, 1);
-    if (!final) {
-        SDL_FreeSurface(newsurf);
+    subdata = ((pgSurfaceObject *)self)->subsurface;
+    owner = subdata->owner;
+    offsetx = subdata->offsetx;
+    offsety = subdata->offsety;
+
+    while (((pgSurfaceObject *)owner)->subsurface) {
+        subdata = ((pgSurfaceObject *)owner)->subsurface;
+        owner = subdata->owner;
+        offsetx += subdata->offsetx;
+        offsety += subdata->offsety;
     }
-    return final;
+    return pg_tuple_couple_from_values_int(offsetx, offsety);
 }
 
 static PyObject *
-surf_premul_alpha_ip(pgSurfaceObject *self, PyObject *_null)
+surf_get_parent(PyObject *self, PyObject *_null)
 {
     SDL_Surface *surf = pgSurface_AsSurface(self);
-    SURF_INIT_CHECK(surf)
-
-    if (!surf->w || !surf->h) {
-        Py_INCREF(self);
-        return (PyObject *)self;
-    }
+    struct pgSubSurface_Data *subdata;
 
-    pgSurface_Prep(self);
+    SURF_INIT_CHECK(surf)
 
-    int result = premul_surf_color_by_alpha(surf, surf);
-    if (result == -1) {
-        return RAISE(PyExc_ValueError,
-                     "source surface to be alpha pre-multiplied must have "
-                     "alpha channel");
-    }
-    else if (result == -2) {
-        return RAISE(pgExc_SDLError, SDL_GetError());
+    subdata = ((pgSurfaceObject *)self)->subsurface;
+    if (!subdata) {
+        Py_RETURN_NONE;
     }
 
-    pgSurface_Unprep(self);
-
-    Py_INCREF(self);
-    return (PyObject *)self;
+    Py_INCREF(subdata->owner);
+    return subdata->owner;
 }
 
-static int
-_get_buffer_0D(PyObject *obj, Py_buffer *view_p, int flags)
+static PyObject *
+surf_get_abs_parent(PyObject *self, PyObject *_null)
 {
-    SDL_Surface *surface = pgSurface_AsSurface(obj);
+    SDL_Surface *surf = pgSurface_AsSurface(self);
+    struct pgSubSurface_Data *subdata;
+    PyObject *owner;
 
-    view_p->obj = 0;
+    SURF_INIT_CHECK(surf)
+
+    subdata = ((pgSurfaceObject *)self)->subsurface;
+    if (!subdata) {
+        Py_INCREF(self);
+        return self;
+    }
+
+    subdata = ((pgSurfaceObject *)self)->subsurface;
+    owner = subdata->owner;
+
+    while (((pgSurfaceObject *)owner)->subsurface) {
+        subdata = ((pgSurfaceObject *)owner)->subsurface;
+        owner = subdata->owner;
+    }
+
+    Py_INCREF(owner);
+    return owner;
+}
+
+static PyObject *
+surf_get_bounding_rect(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+    const int BYTE0 = 0;
+    const int BYTE1 = 1;
+    const int BYTE2 = 2;
+#else
+    const int BYTE0 = 2;
+    const int BYTE1 = 1;
+    const int BYTE2 = 0;
+#endif
+    PyObject *rect;
+    SDL_Surface *surf = pgSurface_AsSurface(self);
+    Uint8 *pixels = NULL;
+    Uint8 *pixel;
+    int x, y;
+    int min_x, min_y, max_x, max_y;
+    int min_alpha = 1;
+    int found_alpha = 0;
+    Uint32 value;
+    Uint8 r, g, b, a;
+    int has_colorkey = 0;
+    Uint32 colorkey;
+    Uint8 keyr, keyg, keyb;
+
+    char *kwids[] = {"min_alpha", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|i", kwids, &min_alpha)) {
+        return RAISE(PyExc_ValueError,
+                     "get_bounding_rect only accepts a single optional "
+                     "min_alpha argument");
+    }
+
+    SURF_INIT_CHECK(surf)
+
+    if (!pgSurface_LockRead((pgSurfaceObject *)self)) {
+        return RAISE(pgExc_SDLError, "could not lock surface");
+    }
+
+    PG_PixelFormat *format;
+    SDL_Palette *palette;
+    if (!PG_GetSurfaceDetails(surf, &format, &palette)) {
+        return RAISE(pgExc_SDLError, SDL_GetError());
+    }
+    int bpp = PG_FORMAT_BytesPerPixel(format);
+
+    if ((has_colorkey = SDL_HasColorKey(surf))) {
+        SDL_GetColorKey(surf, &colorkey);
+        PG_GetRGBA(colorkey, format, palette, &keyr, &keyg, &keyb, &a);
+    }
+
+    pixels = (Uint8 *)surf->pixels;
+    min_y = 0;
+    min_x = 0;
+    max_x = surf->w;
+    max_y = surf->h;
+
+    found_alpha = 0;
+    for (y = max_y - 1; y >= min_y; --y) {
+        for (x = min_x; x < max_x; ++x) {
+            pixel = (pixels + y * surf->pitch) + x * bpp;
+            switch (bpp) {
+                case 1:
+                    value = *pixel;
+                    break;
+                case 2:
+                    value = *(Uint16 *)pixel;
+                    break;
+                case 3:
+                    value = pixel[BYTE0];
+                    value |= pixel[BYTE1] << 8;
+                    value |= pixel[BYTE2] << 16;
+                    break;
+                default:
+                    assert(bpp == 4);
+                    value = *(Uint32 *)pixel;
+            }
+            PG_GetRGBA(value, format, palette, &r, &g, &b, &a);
+            if ((a >= min_alpha && has_colorkey == 0) ||
+                (has_colorkey != 0 && (r != keyr || g != keyg || b != keyb))) {
+                found_alpha = 1;
+                break;
+            }
+        }
+        if (found_alpha == 1) {
+            break;
+        }
+        max_y = y;
+    }
+    found_alpha = 0;
+    for (x = max_x - 1; x >= min_x; --x) {
+        for (y = min_y; y < max_y; ++y) {
+            pixel = (pixels + y * surf->pitch) + x * bpp;
+            switch (bpp) {
+                case 1:
+                    value = *pixel;
+                    break;
+                case 2:
+                    value = *(Uint16 *)pixel;
+                    break;
+                case 3:
+                    value = pixel[BYTE0];
+                    value |= pixel[BYTE1] << 8;
+                    value |= pixel[BYTE2] << 16;
+                    break;
+                default:
+                    assert(bpp == 4);
+                    value = *(Uint32 *)pixel;
+            }
+            PG_GetRGBA(value, format, palette, &r, &g, &b, &a);
+            if ((a >= min_alpha && has_colorkey == 0) ||
+                (has_colorkey != 0 && (r != keyr || g != keyg || b != keyb))) {
+                found_alpha = 1;
+                break;
+            }
+        }
+        if (found_alpha == 1) {
+            break;
+        }
+        max_x = x;
+    }
+    found_alpha = 0;
+    for (y = min_y; y < max_y; ++y) {
+        min_y = y;
+        for (x = min_x; x < max_x; ++x) {
+            pixel = (pixels + y * surf->pitch) + x * bpp;
+            switch (bpp) {
+                case 1:
+                    value = *pixel;
+                    break;
+                case 2:
+                    value = *(Uint16 *)pixel;
+                    break;
+                case 3:
+                    value = pixel[BYTE0];
+                    value |= pixel[BYTE1] << 8;
+                    value |= pixel[BYTE2] << 16;
+                    break;
+                default:
+                    assert(bpp == 4);
+                    value = *(Uint32 *)pixel;
+            }
+            PG_GetRGBA(value, format, palette, &r, &g, &b, &a);
+            if ((a >= min_alpha && has_colorkey == 0) ||
+                (has_colorkey != 0 && (r != keyr || g != keyg || b != keyb))) {
+                found_alpha = 1;
+                break;
+            }
+        }
+        if (found_alpha == 1) {
+            break;
+        }
+    }
+    found_alpha = 0;
+    for (x = min_x; x < max_x; ++x) {
+        min_x = x;
+        for (y = min_y; y < max_y; ++y) {
+            pixel = (pixels + y * surf->pitch) + x * bpp;
+            switch (bpp) {
+                case 1:
+                    value = *pixel;
+                    break;
+                case 2:
+                    value = *(Uint16 *)pixel;
+                    break;
+                case 3:
+                    value = pixel[BYTE0];
+                    value |= pixel[BYTE1] << 8;
+                    value |= pixel[BYTE2] << 16;
+                    break;
+                default:
+                    assert(bpp == 4);
+                    value = *(Uint32 *)pixel;
+            }
+            PG_GetRGBA(value, format, palette, &r, &g, &b, &a);
+            if ((a >= min_alpha && has_colorkey == 0) ||
+                (has_colorkey != 0 && (r != keyr || g != keyg || b != keyb))) {
+                found_alpha = 1;
+                break;
+            }
+        }
+        if (found_alpha == 1) {
+            break;
+        }
+    }
+    if (!pgSurface_Unlock((pgSurfaceObject *)self)) {
+        return RAISE(pgExc_SDLError, "could not unlock surface");
+    }
+
+    rect = pgRect_New4(min_x, min_y, max_x - min_x, max_y - min_y);
+    return rect;
+}
+
+static PyObject *
+_raise_get_view_ndim_error(int bitsize, SurfViewKind kind)
+{
+    const char *name = "<unknown>"; /* guard against a segfault */
+
+    /* Put a human readable name to a surface view kind */
+    switch (kind) {
+            /* This switch statement is exhaustive over the SurfViewKind enum
+             */
+
+        case VIEWKIND_0D:
+            name = "contiguous bytes";
+            break;
+        case VIEWKIND_1D:
+            name = "contiguous pixels";
+            break;
+        case VIEWKIND_2D:
+            name = "2D";
+            break;
+        case VIEWKIND_3D:
+            name = "3D";
+            break;
+        case VIEWKIND_RED:
+            name = "red";
+            break;
+        case VIEWKIND_GREEN:
+            name = "green";
+            break;
+        case VIEWKIND_BLUE:
+            name = "blue";
+            break;
+        case VIEWKIND_ALPHA:
+            name = "alpha";
+            break;
+
+#ifndef NDEBUG
+            /* Assert this switch statement is exhaustive */
+        default:
+            /* Should not be here */
+            PyErr_Format(PyExc_SystemError,
+                         "pygame bug in _raise_get_view_ndim_error:"
+                         " unknown view kind %d",
+                         (int)kind);
+            return 0;
+#endif
+    }
+    PyErr_Format(PyExc_ValueError,
+                 "unsupported bit depth %d for %s reference array", bitsize,
+                 name);
+    return 0;
+}
+
+static PyObject *
+surf_get_view(PyObject *self, PyObject *args)
+{
+    SDL_Surface *surface = pgSurface_AsSurface(self);
+    Uint32 mask = 0;
+    SurfViewKind view_kind = VIEWKIND_2D;
+    getbufferproc get_buffer = 0;
+
+    if (!PyArg_ParseTuple(args, "|O&", _view_kind, &view_kind)) {
+        return 0;
+    }
+
+    SURF_INIT_CHECK(surface)
+
+    PG_PixelFormat *format;
+    SDL_Palette *palette;
+    if (!PG_GetSurfaceDetails(surface, &format, &palette)) {
+        return RAISE(pgExc_SDLError, SDL_GetError());
+    }
+    int bpp = PG_FORMAT_BytesPerPixel(format);
+
+    switch (view_kind) {
+            /* This switch statement is exhaustive over the SurfViewKind enum
+             */
+
+        case VIEWKIND_0D:
+            if (surface->pitch != bpp * surface->w) {
+                PyErr_SetString(PyExc_ValueError,
+                                "Surface data is not contiguous");
+                return 0;
+            }
+            get_buffer = _get_buffer_0D;
+            break;
+        case VIEWKIND_1D:
+            if (surface->pitch != bpp * surface->w) {
+                PyErr_SetString(PyExc_ValueError,
+                                "Surface data is not contiguous");
+                return 0;
+            }
+            get_buffer = _get_buffer_1D;
+            break;
+        case VIEWKIND_2D:
+            get_buffer = _get_buffer_2D;
+            break;
+        case VIEWKIND_3D:
+            if (bpp < 3) {
+                return _raise_get_view_ndim_error(bpp * 8, view_kind);
+            }
+            if (format->Gmask != 0x00ff00 &&
+                (bpp != 4 || format->Gmask != 0xff0000)) {
+                return RAISE(PyExc_ValueError,
+                             "unsupported colormasks for 3D reference array");
+            }
+            get_buffer = _get_buffer_3D;
+            break;
+        case VIEWKIND_RED:
+            mask = format->Rmask;
+            if (mask != 0x000000ffU && mask != 0x0000ff00U &&
+                mask != 0x00ff0000U && mask != 0xff000000U) {
+                return RAISE(PyExc_ValueError,
+                             "unsupported colormasks for red reference array");
+            }
+            get_buffer = _get_buffer_red;
+            break;
+        case VIEWKIND_GREEN:
+            mask = format->Gmask;
+            if (mask != 0x000000ffU && mask != 0x0000ff00U &&
+                mask != 0x00ff0000U && mask != 0xff000000U) {
+                return RAISE(
+                    PyExc_ValueError,
+                    "unsupported colormasks for green reference array");
+            }
+            get_buffer = _get_buffer_green;
+            break;
+        case VIEWKIND_BLUE:
+            mask = format->Bmask;
+            if (mask != 0x000000ffU && mask != 0x0000ff00U &&
+                mask != 0x00ff0000U && mask != 0xff000000U) {
+                return RAISE(
+                    PyExc_ValueError,
+                    "unsupported colormasks for blue reference array");
+            }
+            get_buffer = _get_buffer_blue;
+            break;
+        case VIEWKIND_ALPHA:
+            mask = format->Amask;
+            if (mask != 0x000000ffU && mask != 0x0000ff00U &&
+                mask != 0x00ff0000U && mask != 0xff000000U) {
+                return RAISE(
+                    PyExc_ValueError,
+                    "unsupported colormasks for alpha reference array");
+            }
+            get_buffer = _get_buffer_alpha;
+            break;
+
+#ifndef NDEBUG
+            /* Assert this switch statement is exhaustive */
+        default:
+            /* Should not be here */
+            PyErr_Format(PyExc_SystemError,
+                         "pygame bug in surf_get_view:"
+                         " unrecognized view kind %d",
+                         (int)view_kind);
+            return 0;
+#endif
+    }
+    assert(get_buffer);
+    return pgBufferProxy_New(self, get_buffer);
+}
+
+static PyObject *
+surf_get_buffer(PyObject *self, PyObject *_null)
+{
+    SDL_Surface *surface = pgSurface_AsSurface(self);
+    PyObject *proxy_obj;
+
+    SURF_INIT_CHECK(surface)
+
+    proxy_obj = pgBufferProxy_New(self, _get_buffer_0D);
+    if (proxy_obj) {
+        if (pgBufferProxy_Trip(proxy_obj)) {
+            Py_DECREF(proxy_obj);
+            proxy_obj = 0;
+        }
+    }
+    return proxy_obj;
+}
+
+static PyObject *
+surf_premul_alpha(pgSurfaceObject *self, PyObject *_null)
+{
+    SDL_Surface *surf = pgSurface_AsSurface(self);
+    PyObject *final;
+    SDL_Surface *newsurf;
+
+    SURF_INIT_CHECK(surf)
+
+    if (!pgSurface_Prep(self)) {
+        return NULL;
+    }
+    // Make a copy of the surface first
+    newsurf = PG_ConvertSurface(surf, surf->format);
+
+    if ((surf->w > 0 && surf->h > 0)) {
+        // If the surface has no pixels we don't need to premul
+        // just return the copy.
+        int result = premul_surf_color_by_alpha(surf, newsurf);
+        if (result == -1) {
+            return RAISE(PyExc_ValueError,
+                         "source surface to be alpha pre-multiplied must have "
+                         "alpha channel");
+        }
+        else if (result == -2) {
+            return RAISE(pgExc_SDLError, SDL_GetError());
+        }
+    }
+    pgSurface_Unprep(self);
+
+    final = surf_subtype_new(Py_TYPE(self), newsurf, 1);
+    if (!final) {
+        SDL_FreeSurface(newsurf);
+    }
+    return final;
+}
+
+static PyObject *
+surf_premul_alpha_ip(pgSurfaceObject *self, PyObject *_null)
+{
+    SDL_Surface *surf = pgSurface_AsSurface(self);
+    SURF_INIT_CHECK(surf)
+
+    if (!surf->w || !surf->h) {
+        Py_INCREF(self);
+        return (PyObject *)self;
+    }
+
+    if (!pgSurface_Unshare(self)) {
+        return NULL;
+    }
+
+    if (!pgSurface_Prep(self)) {
+        return NULL;
+    }
+
+    int result = premul_surf_color_by_alpha(surf, surf);
+    pgSurface_Unprep(self);
+    if (result == -1) {
+        return RAISE(PyExc_ValueError,
+                     "source surface to be alpha pre-multiplied must have "
+                     "alpha channel");
+    }
+    else if (result == -2) {
+        return RAISE(pgExc_SDLError, SDL_GetError());
+    }
+    pgSurface_AddDirtyRect(self, NULL);
+
+    Py_INCREF(self);
+    return (PyObject *)self;
+}
+
+static PyObject *
+surf_set_dirty_tracking(pgSurfaceObject *self, PyObject *args)
+{
+    int enabled = 1;
+
+    if (!PyArg_ParseTuple(args, "|p", &enabled)) {
+        return NULL;
+    }
+
+    if (!enabled) {
+        PyMem_Free(self->dirty);
+        self->dirty = NULL;
+    }
+    else if (!self->dirty) {
+        if (!(self->dirty = PyMem_New(struct pgDirtyRects, 1))) {
+            return PyErr_NoMemory();
+        }
+        self->dirty->count = 0;
+    }
+    Py_RETURN_NONE;
+}
+
+static PyObject *
+surf_get_dirty_tracking(pgSurfaceObject *self, PyObject *_null)
+{
+    return PyBool_FromLong(self->dirty != NULL);
+}
+
+static PyObject *
+surf_get_dirty_rects(pgSurfaceObject *self, PyObject *_null)
+{
+    PyObject *list, *rect;
+    int i, count = self->dirty ? self->dirty->count : 0;
+
+    if (!(list = PyList_New(count))) {
+        return NULL;
+    }
+    for (i = 0; i < count; i++) {
+        if (!(rect = pgRect_New(&self->dirty->rects[i]))) {
+            Py_DECREF(list);
+            return NULL;
+        }
+        PyList_SET_ITEM(list, i, rect);
+    }
+    return list;
+}
+
+static PyObject *
+surf_clear_dirty(pgSurfaceObject *self, PyObject *_null)
+{
+    if (self->dirty) {
+        self->dirty->count = 0;
+    }
+    Py_RETURN_NONE;
+}
+
+static PyObject *
+surf_set_span_encoding(pgSurfaceObject *self, PyObject *args)
+{
+    int enabled = 1;
+
+    if (!PyArg_ParseTuple(args, "|p", &enabled)) {
+        return NULL;
+    }
+
+    if (!enabled) {
+        pygame_SpanCacheFree(self->spans);
+        self->spans = NULL;
+    }
+    else if (!self->spans) {
+        /* The pixels of a subsurface can change through its parent
+           without it knowing */
+        if (self->subsurface) {
+            return RAISE(PyExc_ValueError,
+                         "span encoding is not supported on subsurfaces");
+        }
+        if (!(self->spans = PyMem_New(struct pgSpanCache, 1))) {
+            return PyErr_NoMemory();
+        }
+        memset(self->spans, 0, sizeof(struct pgSpanCache));
+    }
+    Py_RETURN_NONE;
+}
+
+static PyObject *
+surf_get_span_encoding(pgSurfaceObject *self, PyObject *_null)
+{
+    return PyBool_FromLong(self->spans != NULL);
+}
+
+static int
+_get_buffer_0D(PyObject *obj, Py_buffer *view_p, int flags)
+{
+    SDL_Surface *surface = pgSurface_AsSurface(obj);
+
+    view_p->obj = 0;
+    if (_init_buffer(obj, view_p, flags)) {
+        return -1;
+    }
+    view_p->buf = surface->pixels;
+    view_p->itemsize = 1;
+    view_p->len = (Py_ssize_t)surface->pitch * surface->h;
+    view_p->readonly = 0;
+    if (PyBUF_HAS_FLAG(flags, PyBUF_FORMAT)) {
+        view_p->format = FormatUint8;
+    }
+    if (PyBUF_HAS_FLAG(flags, PyBUF_ND)) {
+        view_p->ndim = 1;
+        view_p->shape[0] = view_p->len;
+        if (PyBUF_HAS_FLAG(flags, PyBUF_STRIDES)) {
+            view_p->strides[0] = view_p->itemsize;
+        }
+    }
+    Py_INCREF(obj);
+    view_p->obj = obj;
+    return 0;
+}
+
+static int
+_get_buffer_1D(PyObject *obj, Py_buffer *view_p, int flags)
+{
+    SDL_Surface *surface = pgSurface_AsSurface(obj);
+    Py_ssize_t itemsize = PG_SURF_BytesPerPixel(surface);
+
+    view_p->obj = 0;
+    if (itemsize == 1) {
+        return _get_buffer_0D(obj, view_p, flags);
+    }
+    if (_init_buffer(obj, view_p, flags)) {
+        return -1;
+    }
+    if (PyBUF_HAS_FLAG(flags, PyBUF_FORMAT)) {
+        switch (itemsize) {
+                /* This switch statement is exhaustive over all remaining
+                   possible itemsize values, the valid pixel byte sizes of non
+                   color-mapped images */
+
+            case 2:
+                view_p->format = FormatUint16;
+                break;
+            case 3:
+                view_p->format = FormatUint24;
+                break;
+            case 4:
+                view_p->format = FormatUint32;
+                break;
+
+#ifndef NDEBUG
+                /* Assert this switch statement is exhaustive */
+            default:
+                /* Should not be here */
+                PyErr_Format(PyExc_SystemError,
+                             "Pygame bug caught at line %i in file %s: "
+                             "unknown pixel size %zd. Please report",
+                             (int)__LINE__, __FILE__, itemsize);
+                return -1;
+#endif
+        }
+    }
+    view_p->buf = surface->pixels;
+    view_p->itemsize = itemsize;
+    view_p->readonly = 0;
+    view_p->len = (Py_ssize_t)surface->pitch * surface->h;
+    if (PyBUF_HAS_FLAG(flags, PyBUF_ND)) {
+        view_p->ndim = 1;
+        view_p->shape[0] = (Py_ssize_t)surface->w * surface->h;
+        if (PyBUF_HAS_FLAG(flags, PyBUF_STRIDES)) {
+            view_p->strides[0] = itemsize;
+        }
+    }
+    view_p->suboffsets = 0;
+    Py_INCREF(obj);
+    view_p->obj = obj;
+    return 0;
+}
+
+static int
+_get_buffer_2D(PyObject *obj, Py_buffer *view_p, int flags)
+{
+    SDL_Surface *surface = pgSurface_AsSurface(obj);
+    int itemsize = PG_SURF_BytesPerPixel(surface);
+
+    view_p->obj = 0;
+    if (!PyBUF_HAS_FLAG(flags, PyBUF_ND)) {
+        if (surface->pitch != surface->w * itemsize) {
+            PyErr_SetString(pgExc_BufferError,
+                            "A 2D surface view is not C contiguous");
+            return -1;
+        }
+        return _get_buffer_1D(obj, view_p, flags);
+    }
+    if (!PyBUF_HAS_FLAG(flags, PyBUF_STRIDES)) {
+        PyErr_SetString(pgExc_BufferError,
+                        "A 2D surface view is not C contiguous: "
+                        "need strides");
+        return -1;
+    }
+    if (PyBUF_HAS_FLAG(flags, PyBUF_C_CONTIGUOUS)) {
+        PyErr_SetString(pgExc_BufferError,
+                        "A 2D surface view is not C contiguous");
+        return -1;
+    }
+    if (PyBUF_HAS_FLAG(flags, PyBUF_F_CONTIGUOUS) &&
+        surface->pitch != surface->w * itemsize) {
+        PyErr_SetString(pgExc_BufferError,
+                        "This 2D surface view is not F contiguous");
+        return -1;
+    }
+    if (PyBUF_HAS_FLAG(flags, PyBUF_ANY_CONTIGUOUS) &&
+        surface->pitch != surface->w * itemsize) {
+        PyErr_SetString(pgExc_BufferError,
+                        "This 2D surface view is not contiguous");
+        return -1;
+    }
+    if (_init_buffer(obj, view_p, flags)) {
+        return -1;
+    }
+    if (PyBUF_HAS_FLAG(flags, PyBUF_FORMAT)) {
+        switch (itemsize) {
+                /* This switch statement is exhaustive over all possible
+                   itemsize values, valid pixel byte sizes */
+
+            case 1:
+                view_p->format = FormatUint8;
+                break;
+            case 2:
+                view_p->format = FormatUint16;
+                break;
+            case 3:
+                view_p->format = FormatUint24;
+                break;
+            case 4:
+                view_p->format = FormatUint32;
+                break;
+
+#ifndef NDEBUG
+                /* Assert this switch statement is exhaustive */
+            default:
+                /* Should not be here */
+                PyErr_Format(PyExc_SystemError,
+                             "Pygame bug caught at line %i in file %s: "
+                             "unknown pixel size %i. Please report",
+                             (int)__LINE__, __FILE__, itemsize);
+                return -1;
+#endif
+        }
+    }
+    view_p->buf = surface->pixels;
+    view_p->itemsize = itemsize;
+    view_p->ndim = 2;
+    view_p->readonly = 0;
+    view_p->len = (Py_ssize_t)surface->w * surface->h * itemsize;
+    view_p->shape[0] = surface->w;
+    view_p->shape[1] = surface->h;
+    view_p->strides[0] = itemsize;
+    view_p->strides[1] = surface->pitch;
+    view_p->suboffsets = 0;
+    Py_INCREF(obj);
+    view_p->obj = obj;
+    return 0;
+}
+
+static int
+_get_buffer_3D(PyObject *obj, Py_buffer *view_p, int flags)
+{
+    SDL_Surface *surface = pgSurface_AsSurface(obj);
+    int pixelsize = PG_SURF_BytesPerPixel(surface);
+    char *startpixel = (char *)surface->pixels;
+
+    view_p->obj = 0;
+    if (!PyBUF_HAS_FLAG(flags, PyBUF_STRIDES)) {
+        PyErr_SetString(pgExc_BufferError,
+                        "A 3D surface view is not contiguous: needs strides");
+        return -1;
+    }
+    if (PyBUF_HAS_FLAG(flags, PyBUF_C_CONTIGUOUS) ||
+        PyBUF_HAS_FLAG(flags, PyBUF_F_CONTIGUOUS) ||
+        PyBUF_HAS_FLAG(flags, PyBUF_ANY_CONTIGUOUS)) {
+        PyErr_SetString(pgExc_BufferError,
+                        "A 3D surface view is not contiguous");
+        return -1;
+    }
+    PG_PixelFormat *surface_format = PG_GetSurfaceFormat(surface);
+    if (surface_format == NULL) {
+        PyErr_SetString(pgExc_SDLError, SDL_GetError());
+        return -1;
+    }
+
+    if (_init_buffer(obj, view_p, flags)) {
+        return -1;
+    }
+    if (PyBUF_HAS_FLAG(flags, PyBUF_FORMAT)) {
+        view_p->format = FormatUint8;
+    }
+    view_p->itemsize = 1;
+    view_p->ndim = 3;
+    view_p->readonly = 0;
+    view_p->len = (Py_ssize_t)surface->w * surface->h * 3;
+    view_p->shape[0] = surface->w;
+    view_p->shape[1] = surface->h;
+    view_p->shape[2] = 3;
+    view_p->strides[0] = pixelsize;
+    view_p->strides[1] = surface->pitch;
+    switch (surface_format->Rmask) {
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+        case 0xffU:
+            view_p->strides[2] = 1;
+            break;
+        case 0xff00U:
+            assert(pixelsize == 4);
+            view_p->strides[2] = 1;
+            startpixel += 1;
+            break;
+        case 0xff0000U:
+            view_p->strides[2] = -1;
+            startpixel += 2;
+            break;
+        default: /* 0xff000000U */
+            assert(pixelsize == 4);
+            view_p->strides[2] = -1;
+            startpixel += 3;
+#else  /* SDL_BYTEORDER != SDL_LIL_ENDIAN */
+        case 0xffU:
+            view_p->strides[2] = -1;
+            startpixel += pixelsize - 1;
+            break;
+        case 0xff00U:
+            assert(pixelsize == 4);
+            view_p->strides[2] = -1;
+            startpixel += pixelsize - 2;
+            break;
+        case 0xff0000U:
+            view_p->strides[2] = 1;
+            startpixel += pixelsize - 3;
+            break;
+        default: /* 0xff000000U */
+            assert(pixelsize == 4);
+            view_p->strides[2] = 1;
+#endif /* SDL_BYTEORDER != SDL_LIL_ENDIAN */
+    }
+    view_p->buf = startpixel;
+    Py_INCREF(obj);
+    view_p->obj = obj;
+    return 0;
+}
+
+static int
+_get_buffer_red(PyObject *obj, Py_buffer *view_p, int flags)
+{
+    PG_PixelFormat *surface_format =
+        PG_GetSurfaceFormat(pgSurface_AsSurface(obj));
+    if (surface_format == NULL) {
+        PyErr_SetString(pgExc_SDLError, SDL_GetError());
+        return -1;
+    }
+
+    return _get_buffer_colorplane(obj, view_p, flags, "red",
+                                  surface_format->Rmask);
+}
+
+static int
+_get_buffer_green(PyObject *obj, Py_buffer *view_p, int flags)
+{
+    PG_PixelFormat *surface_format =
+        PG_GetSurfaceFormat(pgSurface_AsSurface(obj));
+    if (surface_format == NULL) {
+        PyErr_SetString(pgExc_SDLError, SDL_GetError());
+        return -1;
+    }
+
+    return _get_buffer_colorplane(obj, view_p, flags, "green",
+                                  surface_format->Gmask);
+}
+
+static int
+_get_buffer_blue(PyObject *obj, Py_buffer *view_p, int flags)
+{
+    PG_PixelFormat *surface_format =
+        PG_GetSurfaceFormat(pgSurface_AsSurface(obj));
+    if (surface_format == NULL) {
+        PyErr_SetString(pgExc_SDLError, SDL_GetError());
+        return -1;
+    }
+
+    return _get_buffer_colorplane(obj, view_p, flags, "blue",
+                                  surface_format->Bmask);
+}
+
+static int
+_get_buffer_alpha(PyObject *obj, Py_buffer *view_p, int flags)
+{
+    PG_PixelFormat *surface_format =
+        PG_GetSurfaceFormat(pgSurface_AsSurface(obj));
+    if (surface_format == NULL) {
+        PyErr_SetString(pgExc_SDLError, SDL_GetError());
+        return -1;
+    }
+
+    return _get_buffer_colorplane(obj, view_p, flags, "alpha",
+                                  surface_format->Amask);
+}
+
+static int
+_get_buffer_colorplane(PyObject *obj, Py_buffer *view_p, int flags, char *name,
+                       Uint32 mask)
+{
+    SDL_Surface *surface = pgSurface_AsSurface(obj);
+    int pixelsize = PG_SURF_BytesPerPixel(surface);
+    char *startpixel = (char *)surface->pixels;
+
+    view_p->obj = 0;
+    if (!PyBUF_HAS_FLAG(flags, PyBUF_STRIDES)) {
+        PyErr_SetString(pgExc_BufferError,
+                        "A surface color plane view is not contiguous: "
+                        "need strides");
+        return -1;
+    }
+    if (PyBUF_HAS_FLAG(flags, PyBUF_C_CONTIGUOUS) ||
+        PyBUF_HAS_FLAG(flags, PyBUF_F_CONTIGUOUS) ||
+        PyBUF_HAS_FLAG(flags, PyBUF_ANY_CONTIGUOUS)) {
+        PyErr_SetString(pgExc_BufferError,
+                        "A surface color plane view is not contiguous");
+        return -1;
+    }
+    switch (mask) {
+        /* This switch statement is exhaustive over possible mask value,
+           the allowable masks for 24 bit and 32 bit surfaces */
+
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+        case 0x000000ffU:
+            break;
+        case 0x0000ff00U:
+            startpixel += 1;
+            break;
+        case 0x00ff0000U:
+            startpixel += 2;
+            break;
+        case 0xff000000U:
+            startpixel += 3;
+            break;
+#else  /* SDL_BYTEORDER != SDL_LIL_ENDIAN */
+        case 0x000000ffU:
+            startpixel += pixelsize - 1;
+            break;
+        case 0x0000ff00U:
+            startpixel += pixelsize - 2;
+            break;
+        case 0x00ff0000U:
+            startpixel += pixelsize - 3;
+            break;
+        case 0xff000000U:
+            break;
+#endif /* SDL_BYTEORDER != SDL_LIL_ENDIAN */
+
+#ifndef NDEBUG
+            /* Assert this switch statement is exhaustive */
+        default:
+            /* Should not be here */
+            PyErr_Format(PyExc_SystemError,
+                         "Pygame bug caught at line %i in file %s: "
+                         "unknown mask value %X. Please report",
+                         (int)__LINE__, __FILE__, mask);
+            return -1;
+#endif
+    }
     if (_init_buffer(obj, view_p, flags)) {
         return -1;
     }
-    view_p->buf = surface->pixels;
-    view_p->itemsize = 1;
-    view_p->len = (Py_ssize_t)surface->pitch * surface->h;
-    view_p->readonly = 0;
+    view_p->buf = startpixel;
     if (PyBUF_HAS_FLAG(flags, PyBUF_FORMAT)) {
         view_p->format = FormatUint8;
     }
-    if (PyBUF_HAS_FLAG(flags, PyBUF_ND)) {
-        view_p->ndim = 1;
-        view_p->shape[0] = view_p->len;
-        if (PyBUF_HAS_FLAG(flags, PyBUF_STRIDES)) {
-            view_p->strides[0] = view_p->itemsize;
+    view_p->itemsize = 1;
+    view_p->ndim = 2;
+    view_p->readonly = 0;
+    view_p->len = (Py_ssize_t)surface->w * surface->h;
+    view_p->shape[0] = surface->w;
+    view_p->shape[1] = surface->h;
+    view_p->strides[0] = pixelsize;
+    view_p->strides[1] = surface->pitch;
+    Py_INCREF(obj);
+    view_p->obj = obj;
+    return 0;
+}
+
+static int
+_init_buffer(PyObject *surf, Py_buffer *view_p, int flags)
+{
+    PyObject *consumer;
+    pg_bufferinternal *internal;
+
+    assert(surf);
+    assert(view_p);
+    assert(pgSurface_Check(surf));
+    assert(PyBUF_HAS_FLAG(flags, PyBUF_PYGAME));
+    consumer = ((pg_buffer *)view_p)->consumer;
+    assert(consumer);
+    internal = PyMem_New(pg_bufferinternal, 1);
+    if (!internal) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    internal->consumer_ref = PyWeakref_NewRef(consumer, 0);
+    if (!internal->consumer_ref) {
+        PyMem_Free(internal);
+        return -1;
+    }
+    if (!pgSurface_LockBy((pgSurfaceObject *)surf, consumer)) {
+        PyErr_Format(pgExc_BufferError,
+                     "Unable to lock <%s at %p> by <%s at %p>",
+                     Py_TYPE(surf)->tp_name, (void *)surf,
+                     Py_TYPE(consumer)->tp_name, (void *)consumer);
+        Py_DECREF(internal->consumer_ref);
+        PyMem_Free(internal);
+        return -1;
+    }
+    if (PyBUF_HAS_FLAG(flags, PyBUF_ND)) {
+        view_p->shape = internal->mem;
+        if (PyBUF_HAS_FLAG(flags, PyBUF_STRIDES)) {
+            view_p->strides = internal->mem + 3;
+        }
+        else {
+            view_p->strides = 0;
+        }
+    }
+    else {
+        view_p->shape = 0;
+        view_p->strides = 0;
+    }
+    view_p->ndim = 0;
+    view_p->format = 0;
+    view_p->suboffsets = 0;
+    view_p->internal = internal;
+    ((pg_buffer *)view_p)->release_buffer = _release_buffer;
+    return 0;
+}
+
+static void
+_release_buffer(Py_buffer *view_p)
+{
+    pg_bufferinternal *internal;
+    PyObject *consumer_ref;
+    PyObject *consumer = NULL;
+
+    assert(view_p && view_p->obj && view_p->internal);
+    internal = (pg_bufferinternal *)view_p->internal;
+    consumer_ref = internal->consumer_ref;
+    assert(consumer_ref && PyWeakref_CheckRef(consumer_ref));
+
+    if (PyWeakref_GetRef(consumer_ref, &consumer) != 1) {
+        PyErr_Clear();  // ignore any errors here
+    }
+
+    if (!pgSurface_UnlockBy((pgSurfaceObject *)view_p->obj, consumer)) {
+        PyErr_Clear();
+    }
+    Py_XDECREF(consumer);
+
+    Py_DECREF(consumer_ref);
+    PyMem_Free(internal);
+    Py_DECREF(view_p->obj);
+    view_p->obj = 0;
+}
+
+static int
+_view_kind(PyObject *obj, void *view_kind_vptr)
+{
+    unsigned long ch;
+    SurfViewKind *view_kind_ptr = (SurfViewKind *)view_kind_vptr;
+
+    if (PyUnicode_Check(obj)) {
+        if (PyUnicode_GET_LENGTH(obj) != 1) {
+            PyErr_SetString(PyExc_TypeError,
+                            "expected a length 1 string for argument 1");
+            return 0;
+        }
+        ch = PyUnicode_READ_CHAR(obj, 0);
+    }
+    else if (PyBytes_Check(obj)) {
+        if (PyBytes_GET_SIZE(obj) != 1) {
+            PyErr_SetString(PyExc_TypeError,
+                            "expected a length 1 string for argument 1");
+            return 0;
         }
+        ch = *PyBytes_AS_STRING(obj);
     }
-    Py_INCREF(obj);
-    view_p->obj = obj;
-    return 0;
+    else {
+        PyErr_Format(PyExc_TypeError,
+                     "expected a length one string for argument 1: got '%s'",
+                     Py_TYPE(obj)->tp_name);
+        return 0;
+    }
+    switch (ch) {
+        case '0':
+            *view_kind_ptr = VIEWKIND_0D;
+            break;
+        case '1':
+            *view_kind_ptr = VIEWKIND_1D;
+            break;
+        case '2':
+            *view_kind_ptr = VIEWKIND_2D;
+            break;
+        case 'R':
+        case 'r':
+            *view_kind_ptr = VIEWKIND_RED;
+            break;
+        case 'G':
+        case 'g':
+            *view_kind_ptr = VIEWKIND_GREEN;
+            break;
+        case 'B':
+        case 'b':
+            *view_kind_ptr = VIEWKIND_BLUE;
+            break;
+        case 'A':
+        case 'a':
+            *view_kind_ptr = VIEWKIND_ALPHA;
+            break;
+        case '3':
+            *view_kind_ptr = VIEWKIND_3D;
+            break;
+        default:
+            PyErr_Format(PyExc_TypeError,
+                         "unrecognized view kind '%c' for argument 1",
+                         (int)ch);
+            return 0;
+    }
+    return 1;
+}
+
+static PyObject *
+surf_get_pixels_address(PyObject *self, PyObject *closure)
+{
+    SDL_Surface *surface = pgSurface_AsSurface(self);
+    void *address;
+
+    if (!surface) {
+        Py_RETURN_NONE;
+    }
+    if (!surface->pixels) {
+        return PyLong_FromLong(0L);
+    }
+    /* The caller may write through the address */
+    if (!pgSurface_Unshare((pgSurfaceObject *)self)) {
+        return NULL;
+    }
+    address = surface->pixels;
+#if SIZEOF_VOID_P > SIZEOF_LONG
+    return PyLong_FromUnsignedLongLong((unsigned PY_LONG_LONG)address);
+#else
+    return PyLong_FromUnsignedLong((unsigned long)address);
+#endif
 }
 
 static int
-_get_buffer_1D(PyObject *obj, Py_buffer *view_p, int flags)
+surface_do_overlap(SDL_Surface *src, SDL_Rect *srcrect, SDL_Surface *dst,
+                   SDL_Rect *dstrect, SDL_Rect *clip)
 {
-    SDL_Surface *surface = pgSurface_AsSurface(obj);
-    Py_ssize_t itemsize = PG_SURF_BytesPerPixel(surface);
+    Uint8 *srcpixels;
+    Uint8 *dstpixels;
+    int srcx = srcrect->x, srcy = srcrect->y;
+    int dstx = dstrect->x, dsty = dstrect->y;
+    int x, y;
+    int w = srcrect->w, h = srcrect->h;
+    int maxw, maxh;
+    int span;
+    int dstoffset;
 
-    view_p->obj = 0;
-    if (itemsize == 1) {
-        return _get_buffer_0D(obj, view_p, flags);
+    /* clip the source rectangle to the source surface */
+    if (srcx < 0) {
+        w += srcx;
+        dstx -= srcx;
+        srcx = 0;
     }
-    if (_init_buffer(obj, view_p, flags)) {
-        return -1;
+    maxw = src->w - srcx;
+    if (maxw < w) {
+        w = maxw;
     }
-    if (PyBUF_HAS_FLAG(flags, PyBUF_FORMAT)) {
-        switch (itemsize) {
-                /* This switch statement is exhaustive over all remaining
-                   possible itemsize values, the valid pixel byte sizes of non
-                   color-mapped images */
 
-            case 2:
-                view_p->format = FormatUint16;
-                break;
-            case 3:
-                view_p->format = FormatUint24;
-                break;
-            case 4:
-                view_p->format = FormatUint32;
-                break;
+    if (srcy < 0) {
+        h += srcy;
+        dsty -= srcy;
+        srcy = 0;
+    }
+    maxh = src->h - srcy;
+    if (maxh < h) {
+        h = maxh;
+    }
 
-#ifndef NDEBUG
-                /* Assert this switch statement is exhaustive */
-            default:
-                /* Should not be here */
-                PyErr_Format(PyExc_SystemError,
-                             "Pygame bug caught at line %i in file %s: "
-                             "unknown pixel size %zd. Please report",
-                             (int)__LINE__, __FILE__, itemsize);
-                return -1;
-#endif
+    /* clip the destination rectangle against the clip rectangle */
+    x = clip->x - dstx;
+    if (x > 0) {
+        w -= x;
+        dstx += x;
+        srcx += x;
+    }
+    x = dstx + w - clip->x - clip->w;
+    if (x > 0) {
+        w -= x;
+    }
+    y = clip->y - dsty;
+    if (y > 0) {
+        h -= y;
+        dsty += y;
+        srcy += y;
+    }
+    y = dsty + h - clip->y - clip->h;
+    if (y > 0) {
+        h -= y;
+    }
+
+    if (w <= 0 || h <= 0) {
+        return 0;
+    }
+
+    srcpixels = ((Uint8 *)src->pixels + srcy * src->pitch +
+                 srcx * PG_SURF_BytesPerPixel(src));
+    dstpixels = ((Uint8 *)dst->pixels + dsty * dst->pitch +
+                 dstx * PG_SURF_BytesPerPixel(dst));
+
+    if (dstpixels <= srcpixels) {
+        return 0;
+    }
+
+    span = w * PG_SURF_BytesPerPixel(src);
+
+    if (dstpixels >= srcpixels + (h - 1) * src->pitch + span) {
+        return 0;
+    }
+
+    dstoffset = (dstpixels - srcpixels) % src->pitch;
+
+    return dstoffset < span || dstoffset > src->pitch - span;
+}
+
+int
+PG_BlitSurface(SDL_Surface *src, const SDL_Rect *srcrect, SDL_Surface *dst,
+               SDL_Rect *dstrect)
+{
+#if SDL_VERSION_ATLEAST(3, 0, 0)
+    /* SDL3 doesn't modify dstrect, so compat for that.
+     * Below logic taken from SDL2 source with slight modifications */
+    SDL_Rect r_src, r_dst;
+
+    r_src.x = 0;
+    r_src.y = 0;
+    r_src.w = src->w;
+    r_src.h = src->h;
+
+    if (dstrect) {
+        r_dst.x = dstrect->x;
+        r_dst.y = dstrect->y;
+    }
+    else {
+        r_dst.x = 0;
+        r_dst.y = 0;
+    }
+
+    /* clip the source rectangle to the source surface */
+    if (srcrect) {
+        SDL_Rect tmp;
+        if (SDL_IntersectRect(srcrect, &r_src, &tmp) == SDL_FALSE) {
+            goto end;
         }
+
+        /* Shift dstrect, if srcrect origin has changed */
+        r_dst.x += tmp.x - srcrect->x;
+        r_dst.y += tmp.y - srcrect->y;
+
+        /* Update srcrect */
+        r_src = tmp;
     }
-    view_p->buf = surface->pixels;
-    view_p->itemsize = itemsize;
-    view_p->readonly = 0;
-    view_p->len = (Py_ssize_t)surface->pitch * surface->h;
-    if (PyBUF_HAS_FLAG(flags, PyBUF_ND)) {
-        view_p->ndim = 1;
-        view_p->shape[0] = (Py_ssize_t)surface->w * surface->h;
-        if (PyBUF_HAS_FLAG(flags, PyBUF_STRIDES)) {
-            view_p->strides[0] = itemsize;
+
+    /* There're no dstrect.w/h parameters. It's the same as srcrect */
+    r_dst.w = r_src.w;
+    r_dst.h = r_src.h;
+
+    /* clip the destination rectangle against the clip rectangle */
+    {
+        SDL_Rect tmp, clip_rect;
+        SDL_GetSurfaceClipRect(dst, &clip_rect);
+        if (SDL_IntersectRect(&r_dst, &clip_rect, &tmp) == SDL_FALSE) {
+            goto end;
+        }
+
+        /* Update dstrect */
+        r_dst = tmp;
+    }
+
+    if (r_dst.w > 0 && r_dst.h > 0) {
+        if (dstrect) { /* update output parameter */
+            *dstrect = r_dst;
         }
+        return SDL_BlitSurface(src, srcrect, dst, dstrect) ? 0 : -1;
+    }
+end:
+    if (dstrect) {
+        dstrect->w = dstrect->h = 0;
     }
-    view_p->suboffsets = 0;
-    Py_INCREF(obj);
-    view_p->obj = obj;
     return 0;
+#else
+    return SDL_BlitSurface(src, srcrect, dst, dstrect);
+#endif
+}
+
+/* Picks the blitter for src onto dst. The surfaces must already be locked
+ * or prepped as needed, dstclip is the clip rect of the Surface blitted to. */
+/* The span encoding blits from surfobj may use, or NULL while something
+ * holds a lock on it. A PixelArray, array view or buffer keeping the lock
+ * can write the pixels at any time, without invalidating the runs. */
+static struct pgSpanCache *
+_pg_surface_spans(pgSurfaceObject *surfobj)
+{
+    if (surfobj->locklist && PyList_GET_SIZE(surfobj->locklist) > 0) {
+        return NULL;
+    }
+    return surfobj->spans;
 }
 
 static int
-_get_buffer_2D(PyObject *obj, Py_buffer *view_p, int flags)
+_pg_blit_surfaces(SDL_Surface *src, struct pgSpanCache *spans,
+                  SDL_Rect *srcrect, SDL_Surface *dst, SDL_Rect *dstrect,
+                  SDL_Rect *dstclip, int blend_flags)
 {
-    SDL_Surface *surface = pgSurface_AsSurface(obj);
-    int itemsize = PG_SURF_BytesPerPixel(surface);
+    int result;
+    Uint8 alpha;
 
-    view_p->obj = 0;
-    if (!PyBUF_HAS_FLAG(flags, PyBUF_ND)) {
-        if (surface->pitch != surface->w * itemsize) {
-            PyErr_SetString(pgExc_BufferError,
-                            "A 2D surface view is not C contiguous");
-            return -1;
-        }
-        return _get_buffer_1D(obj, view_p, flags);
-    }
-    if (!PyBUF_HAS_FLAG(flags, PyBUF_STRIDES)) {
-        PyErr_SetString(pgExc_BufferError,
-                        "A 2D surface view is not C contiguous: "
-                        "need strides");
-        return -1;
-    }
-    if (PyBUF_HAS_FLAG(flags, PyBUF_C_CONTIGUOUS)) {
-        PyErr_SetString(pgExc_BufferError,
-                        "A 2D surface view is not C contiguous");
-        return -1;
+    if ((blend_flags != 0 && blend_flags != PYGAME_BLEND_ALPHA_SDL2) ||
+        ((SDL_HasColorKey(src) || _PgSurface_SrcAlpha(src) == 1) &&
+         /* This simplification is possible because a source subsurface
+            is converted to its owner with a clip rect and a dst
+            subsurface cannot be blitted to its owner because the
+            owner is locked.
+            */
+         dst->pixels == src->pixels && srcrect != NULL &&
+         surface_do_overlap(src, srcrect, dst, dstrect, dstclip))) {
+        /* Py_BEGIN_ALLOW_THREADS */
+        result = pygame_Blit(src, srcrect, dst, dstrect, blend_flags);
+        /* Py_END_ALLOW_THREADS */
     }
-    if (PyBUF_HAS_FLAG(flags, PyBUF_F_CONTIGUOUS) &&
-        surface->pitch != surface->w * itemsize) {
-        PyErr_SetString(pgExc_BufferError,
-                        "This 2D surface view is not F contiguous");
-        return -1;
+    /* can't blit alpha to 8bit, crashes SDL */
+    else if (PG_SURF_BytesPerPixel(dst) == 1 &&
+             (SDL_ISPIXELFORMAT_ALPHA(PG_SURF_FORMATENUM(src)) ||
+              ((PG_GetSurfaceAlphaMod(src, &alpha) && alpha != 255)))) {
+        /* Py_BEGIN_ALLOW_THREADS */
+        if (PG_SURF_BytesPerPixel(src) == 1) {
+            result = pygame_Blit(src, srcrect, dst, dstrect, 0);
+        }
+        else {
+#if SDL_VERSION_ATLEAST(3, 0, 0)
+            const SDL_PixelFormatDetails *fmt =
+                SDL_GetPixelFormatDetails(src->format);
+            src = fmt ? SDL_ConvertSurface(src,
+                                           SDL_GetPixelFormatForMasks(
+                                               fmt->bits_per_pixel, fmt->Rmask,
+                                               fmt->Gmask, fmt->Bmask, 0))
+                      : NULL;
+#else
+            SDL_PixelFormat *fmt = src->format;
+            SDL_PixelFormat *newfmt =
+                SDL_AllocFormat(SDL_MasksToPixelFormatEnum(
+                    fmt->BitsPerPixel, fmt->Rmask, fmt->Gmask, fmt->Bmask, 0));
+            if (!newfmt) {
+                src = NULL;
+            }
+            else {
+                src = SDL_ConvertSurface(src, newfmt, 0);
+                SDL_FreeFormat(newfmt);
+            }
+#endif
+            if (src) {
+                result = PG_BlitSurface(src, srcrect, dst, dstrect);
+                SDL_FreeSurface(src);
+            }
+            else {
+                result = -1;
+            }
+        }
+        /* Py_END_ALLOW_THREADS */
     }
-    if (PyBUF_HAS_FLAG(flags, PyBUF_ANY_CONTIGUOUS) &&
-        surface->pitch != surface->w * itemsize) {
-        PyErr_SetString(pgExc_BufferError,
-                        "This 2D surface view is not contiguous");
-        return -1;
+    else if (spans && blend_flags == 0 && !(pg_EnvShouldBlendAlphaSDL2()) &&
+             pygame_SpanBlitSupported(src, dst)) {
+        /* Only the visible runs of a span encoded source are blitted */
+        result = pygame_SpanBlit(src, spans, srcrect, dst, dstrect);
     }
-    if (_init_buffer(obj, view_p, flags)) {
-        return -1;
+    else if (blend_flags != PYGAME_BLEND_ALPHA_SDL2 &&
+             !(pg_EnvShouldBlendAlphaSDL2()) && !SDL_HasColorKey(src) &&
+             (PG_SURF_BytesPerPixel(dst) == 4 ||
+              PG_SURF_BytesPerPixel(dst) == 2) &&
+             _PgSurface_SrcAlpha(src) &&
+             (SDL_ISPIXELFORMAT_ALPHA(PG_SURF_FORMATENUM(src))) &&
+             !PG_SurfaceHasRLE(src) && !PG_SurfaceHasRLE(dst) &&
+             !SDL_MUSTLOCK(src) && !SDL_MUSTLOCK(dst)) {
+        /* If we have a 32bit source surface with per pixel alpha
+           and no RLE we'll use pygame_Blit so we can mimic how SDL1
+            behaved */
+        result = pygame_Blit(src, srcrect, dst, dstrect, blend_flags);
     }
-    if (PyBUF_HAS_FLAG(flags, PyBUF_FORMAT)) {
-        switch (itemsize) {
-                /* This switch statement is exhaustive over all possible
-                   itemsize values, valid pixel byte sizes */
-
-            case 1:
-                view_p->format = FormatUint8;
-                break;
-            case 2:
-                view_p->format = FormatUint16;
-                break;
-            case 3:
-                view_p->format = FormatUint24;
-                break;
-            case 4:
-                view_p->format = FormatUint32;
-                break;
-
-#ifndef NDEBUG
-                /* Assert this switch statement is exhaustive */
-            default:
-                /* Should not be here */
-                PyErr_Format(PyExc_SystemError,
-                             "Pygame bug caught at line %i in file %s: "
-                             "unknown pixel size %i. Please report",
-                             (int)__LINE__, __FILE__, itemsize);
-                return -1;
-#endif
-        }
+    else {
+        /* Py_BEGIN_ALLOW_THREADS */
+        result = PG_BlitSurface(src, srcrect, dst, dstrect);
+        /* Py_END_ALLOW_THREADS */
     }
-    view_p->buf = surface->pixels;
-    view_p->itemsize = itemsize;
-    view_p->ndim = 2;
-    view_p->readonly = 0;
-    view_p->len = (Py_ssize_t)surface->w * surface->h * itemsize;
-    view_p->shape[0] = surface->w;
-    view_p->shape[1] = surface->h;
-    view_p->strides[0] = itemsize;
-    view_p->strides[1] = surface->pitch;
-    view_p->suboffsets = 0;
-    Py_INCREF(obj);
-    view_p->obj = obj;
-    return 0;
+    return result;
 }
 
-static int
-_get_buffer_3D(PyObject *obj, Py_buffer *view_p, int flags)
+/*this internal blit function is accessible through the C api*/
+int
+pgSurface_Blit(pgSurfaceObject *dstobj, pgSurfaceObject *srcobj,
+               SDL_Rect *dstrect, SDL_Rect *srcrect, int blend_flags)
 {
-    SDL_Surface *surface = pgSurface_AsSurface(obj);
-    int pixelsize = PG_SURF_BytesPerPixel(surface);
-    char *startpixel = (char *)surface->pixels;
+    SDL_Surface *src = pgSurface_AsSurface(srcobj);
+    SDL_Surface *dst = pgSurface_AsSurface(dstobj);
+    SDL_Surface *subsurface = NULL;
+    int result, suboffsetx = 0, suboffsety = 0;
+    SDL_Rect orig_clip, sub_clip, dstclip;
 
-    view_p->obj = 0;
-    if (!PyBUF_HAS_FLAG(flags, PyBUF_STRIDES)) {
-        PyErr_SetString(pgExc_BufferError,
-                        "A 3D surface view is not contiguous: needs strides");
-        return -1;
-    }
-    if (PyBUF_HAS_FLAG(flags, PyBUF_C_CONTIGUOUS) ||
-        PyBUF_HAS_FLAG(flags, PyBUF_F_CONTIGUOUS) ||
-        PyBUF_HAS_FLAG(flags, PyBUF_ANY_CONTIGUOUS)) {
-        PyErr_SetString(pgExc_BufferError,
-                        "A 3D surface view is not contiguous");
-        return -1;
+    if (!pgSurface_Unshare(dstobj)) {
+        return 1;
     }
-    PG_PixelFormat *surface_format = PG_GetSurfaceFormat(surface);
-    if (surface_format == NULL) {
+
+    if (!PG_GetSurfaceClipRect(dst, &dstclip)) {
         PyErr_SetString(pgExc_SDLError, SDL_GetError());
-        return -1;
+        return 1;
     }
 
-    if (_init_buffer(obj, view_p, flags)) {
-        return -1;
-    }
-    if (PyBUF_HAS_FLAG(flags, PyBUF_FORMAT)) {
-        view_p->format = FormatUint8;
-    }
-    view_p->itemsize = 1;
-    view_p->ndim = 3;
-    view_p->readonly = 0;
-    view_p->len = (Py_ssize_t)surface->w * surface->h * 3;
-    view_p->shape[0] = surface->w;
-    view_p->shape[1] = surface->h;
-    view_p->shape[2] = 3;
-    view_p->strides[0] = pixelsize;
-    view_p->strides[1] = surface->pitch;
-    switch (surface_format->Rmask) {
-#if SDL_BYTEORDER == SDL_LIL_ENDIAN
-        case 0xffU:
-            view_p->strides[2] = 1;
-            break;
-        case 0xff00U:
-            assert(pixelsize == 4);
-            view_p->strides[2] = 1;
-            startpixel += 1;
-            break;
-        case 0xff0000U:
-            view_p->strides[2] = -1;
-            startpixel += 2;
-            break;
-        default: /* 0xff000000U */
-            assert(pixelsize == 4);
-            view_p->strides[2] = -1;
-            startpixel += 3;
-#else  /* SDL_BYTEORDER != SDL_LIL_ENDIAN */
-        case 0xffU:
-            view_p->strides[2] = -1;
-            startpixel += pixelsize - 1;
-            break;
-        case 0xff00U:
-            assert(pixelsize == 4);
-            view_p->strides[2] = -1;
-            startpixel += pixelsize - 2;
-            break;
-        case 0xff0000U:
-            view_p->strides[2] = 1;
-            startpixel += pixelsize - 3;
-            break;
-        default: /* 0xff000000U */
-            assert(pixelsize == 4);
-            view_p->strides[2] = 1;
-#endif /* SDL_BYTEORDER != SDL_LIL_ENDIAN */
+    /* passthrough blits to the real surface */
+    if (((pgSurfaceObject *)dstobj)->subsurface) {
+        PyObject *owner;
+        struct pgSubSurface_Data *subdata;
+
+        subdata = ((pgSurfaceObject *)dstobj)->subsurface;
+        owner = subdata->owner;
+        subsurface = pgSurface_AsSurface(owner);
+        suboffsetx = subdata->offsetx;
+        suboffsety = subdata->offsety;
+
+        while (((pgSurfaceObject *)owner)->subsurface) {
+            subdata = ((pgSurfaceObject *)owner)->subsurface;
+            owner = subdata->owner;
+            subsurface = pgSurface_AsSurface(owner);
+            suboffsetx += subdata->offsetx;
+            suboffsety += subdata->offsety;
+        }
+
+        SDL_GetClipRect(subsurface, &orig_clip);
+        SDL_GetClipRect(dst, &sub_clip);
+        sub_clip.x += suboffsetx;
+        sub_clip.y += suboffsety;
+        SDL_SetClipRect(subsurface, &sub_clip);
+        dstrect->x += suboffsetx;
+        dstrect->y += suboffsety;
+        dst = subsurface;
+    }
+    else {
+        pgSurface_Prep(dstobj);
+        subsurface = NULL;
     }
-    view_p->buf = startpixel;
-    Py_INCREF(obj);
-    view_p->obj = obj;
-    return 0;
-}
 
-static int
-_get_buffer_red(PyObject *obj, Py_buffer *view_p, int flags)
-{
-    PG_PixelFormat *surface_format =
-        PG_GetSurfaceFormat(pgSurface_AsSurface(obj));
-    if (surface_format == NULL) {
+    if (pgSurface_Prep(srcobj)) {
+        result = _pg_blit_surfaces(src, _pg_surface_spans(srcobj), srcrect,
+                                   dst, dstrect, &dstclip, blend_flags);
+        pgSurface_Unprep(srcobj);
+    }
+    else {
+        result = -3; /* the exception is already set */
+    }
+
+    if (subsurface) {
+        SDL_SetClipRect(subsurface, &orig_clip);
+        dstrect->x -= suboffsetx;
+        dstrect->y -= suboffsety;
+    }
+    else {
+        pgSurface_Unprep(dstobj);
+    }
+
+    if (result == 0) {
+        pgSurface_AddDirtyRect(dstobj, dstrect);
+    }
+    if (result == -1) {
         PyErr_SetString(pgExc_SDLError, SDL_GetError());
-        return -1;
+    }
+    if (result == -2) {
+        PyErr_SetString(pgExc_SDLError, "Surface was lost");
     }
 
-    return _get_buffer_colorplane(obj, view_p, flags, "red",
-                                  surface_format->Rmask);
+    return result != 0;
+}
+
+/* Dirty rect tracking */
+
+static Sint64
+_pg_rect_area(const SDL_Rect *r)
+{
+    return (Sint64)r->w * r->h;
 }
 
 static int
-_get_buffer_green(PyObject *obj, Py_buffer *view_p, int flags)
+_pg_dirty_rect_contains(const SDL_Rect *outer, const SDL_Rect *inner)
 {
-    PG_PixelFormat *surface_format =
-        PG_GetSurfaceFormat(pgSurface_AsSurface(obj));
-    if (surface_format == NULL) {
-        PyErr_SetString(pgExc_SDLError, SDL_GetError());
-        return -1;
+    return inner->x >= outer->x && inner->y >= outer->y &&
+           inner->x + inner->w <= outer->x + outer->w &&
+           inner->y + inner->h <= outer->y + outer->h;
+}
+
+static void
+_pg_rect_union(const SDL_Rect *a, const SDL_Rect *b, SDL_Rect *out)
+{
+    int x = MIN(a->x, b->x);
+    int y = MIN(a->y, b->y);
+
+    out->w = MAX(a->x + a->w, b->x + b->w) - x;
+    out->h = MAX(a->y + a->h, b->y + b->h) - y;
+    out->x = x;
+    out->y = y;
+}
+
+/* Adds a non empty rect to the set, coalescing it with the rects it
+ * overlaps or touches whenever their union wastes no area. */
+static void
+_pg_dirty_rects_add(struct pgDirtyRects *dirty, SDL_Rect rect)
+{
+    SDL_Rect merged;
+    Sint64 cost, best_cost;
+    int i = 0, best = 0;
+
+    while (i < dirty->count) {
+        if (_pg_dirty_rect_contains(&dirty->rects[i], &rect)) {
+            return;
+        }
+        _pg_rect_union(&dirty->rects[i], &rect, &merged);
+        if (_pg_dirty_rect_contains(&rect, &dirty->rects[i]) ||
+            _pg_rect_area(&merged) <=
+                _pg_rect_area(&dirty->rects[i]) + _pg_rect_area(&rect)) {
+            /* The merged rect may now touch rects already checked */
+            rect = merged;
+            dirty->rects[i] = dirty->rects[--dirty->count];
+            i = 0;
+            continue;
+        }
+        i++;
+    }
+
+    if (dirty->count == PG_DIRTY_RECTS_MAX) {
+        best_cost = -1;
+        for (i = 0; i < dirty->count; i++) {
+            _pg_rect_union(&dirty->rects[i], &rect, &merged);
+            cost = _pg_rect_area(&merged) - _pg_rect_area(&dirty->rects[i]);
+            if (best_cost < 0 || cost < best_cost) {
+                best_cost = cost;
+                best = i;
+            }
+        }
+        _pg_rect_union(&dirty->rects[best], &rect, &merged);
+        dirty->rects[best] = dirty->rects[--dirty->count];
+        _pg_dirty_rects_add(dirty, merged);
+        return;
     }
 
-    return _get_buffer_colorplane(obj, view_p, flags, "green",
-                                  surface_format->Gmask);
+    dirty->rects[dirty->count++] = rect;
 }
 
-static int
-_get_buffer_blue(PyObject *obj, Py_buffer *view_p, int flags)
+/* Records that rect (NULL for everything) of surfobj changed. The area is
+ * also recorded on every tracking Surface this one is a subsurface of. */
+static void
+pgSurface_AddDirtyRect(pgSurfaceObject *surfobj, SDL_Rect *rect)
 {
-    PG_PixelFormat *surface_format =
-        PG_GetSurfaceFormat(pgSurface_AsSurface(obj));
-    if (surface_format == NULL) {
-        PyErr_SetString(pgExc_SDLError, SDL_GetError());
-        return -1;
+    struct pgSubSurface_Data *subdata;
+    SDL_Surface *surf;
+    SDL_Rect area;
+    int x, y, right, bottom;
+
+    if (!surfobj->dirty && !surfobj->spans && !surfobj->subsurface) {
+        return;
+    }
+    if (!(surf = surfobj->surf)) {
+        return;
+    }
+    if (rect) {
+        area = *rect;
+    }
+    else {
+        area.x = area.y = 0;
+        area.w = surf->w;
+        area.h = surf->h;
     }
 
-    return _get_buffer_colorplane(obj, view_p, flags, "blue",
-                                  surface_format->Bmask);
+    while (1) {
+        /* Nothing outside of a Surface can change */
+        x = MAX(area.x, 0);
+        y = MAX(area.y, 0);
+        right = MIN(area.x + area.w, surf->w);
+        bottom = MIN(area.y + area.h, surf->h);
+        if (right <= x || bottom <= y) {
+            return;
+        }
+        area.x = x;
+        area.y = y;
+        area.w = right - x;
+        area.h = bottom - y;
+
+        if (surfobj->dirty) {
+            _pg_dirty_rects_add(surfobj->dirty, area);
+        }
+        if (surfobj->spans) {
+            surfobj->spans->valid = 0;
+        }
+
+        if (!(subdata = surfobj->subsurface)) {
+            return;
+        }
+        area.x += subdata->offsetx;
+        area.y += subdata->offsety;
+        surfobj = (pgSurfaceObject *)subdata->owner;
+        if (!(surf = surfobj->surf)) {
+            return;
+        }
+    }
+}
+
+/* Surface pool: SDL surfaces created through pgSurface_PoolCreate, mostly
+ * transform results, are kept here once freed instead of releasing their
+ * pixels, and handed out again for the next request of the same size and
+ * format. The pool is bounded by a budget in bytes and emptied on quit. */
+
+#define PG_POOL_MAX_SURFACES 64
+#define PG_POOL_DEFAULT_BUDGET (32 * 1024 * 1024)
+
+static struct {
+    SDL_Surface *surfs[PG_POOL_MAX_SURFACES]; /* oldest first */
+    int count;
+    Py_ssize_t bytes;
+    Py_ssize_t budget;
+    Py_ssize_t hits;
+    Py_ssize_t misses;
+    int quit_registered;
+} pg_surface_pool = {{NULL}, 0, 0, PG_POOL_DEFAULT_BUDGET, 0, 0, 0};
+
+#if SDL_VERSION_ATLEAST(3, 0, 0)
+#define PG_POOL_PROPERTY "pygame.surface_pool"
+
+static void
+_pg_pool_tag(SDL_Surface *surf)
+{
+    SDL_SetBooleanProperty(SDL_GetSurfaceProperties(surf), PG_POOL_PROPERTY,
+                           true);
 }
 
 static int
-_get_buffer_alpha(PyObject *obj, Py_buffer *view_p, int flags)
+_pg_pool_is_tagged(SDL_Surface *surf)
 {
-    PG_PixelFormat *surface_format =
-        PG_GetSurfaceFormat(pgSurface_AsSurface(obj));
-    if (surface_format == NULL) {
-        PyErr_SetString(pgExc_SDLError, SDL_GetError());
-        return -1;
-    }
+    return SDL_GetBooleanProperty(SDL_GetSurfaceProperties(surf),
+                                  PG_POOL_PROPERTY, false);
+}
+#else
+/* Only its address matters */
+static char _pg_pool_tag_data;
 
-    return _get_buffer_colorplane(obj, view_p, flags, "alpha",
-                                  surface_format->Amask);
+static void
+_pg_pool_tag(SDL_Surface *surf)
+{
+    surf->userdata = &_pg_pool_tag_data;
 }
 
 static int
-_get_buffer_colorplane(PyObject *obj, Py_buffer *view_p, int flags, char *name,
-                       Uint32 mask)
+_pg_pool_is_tagged(SDL_Surface *surf)
 {
-    SDL_Surface *surface = pgSurface_AsSurface(obj);
-    int pixelsize = PG_SURF_BytesPerPixel(surface);
-    char *startpixel = (char *)surface->pixels;
+    return surf->userdata == &_pg_pool_tag_data;
+}
+#endif
 
-    view_p->obj = 0;
-    if (!PyBUF_HAS_FLAG(flags, PyBUF_STRIDES)) {
-        PyErr_SetString(pgExc_BufferError,
-                        "A surface color plane view is not contiguous: "
-                        "need strides");
-        return -1;
-    }
-    if (PyBUF_HAS_FLAG(flags, PyBUF_C_CONTIGUOUS) ||
-        PyBUF_HAS_FLAG(flags, PyBUF_F_CONTIGUOUS) ||
-        PyBUF_HAS_FLAG(flags, PyBUF_ANY_CONTIGUOUS)) {
-        PyErr_SetString(pgExc_BufferError,
-                        "A surface color plane view is not contiguous");
-        return -1;
-    }
-    switch (mask) {
-        /* This switch statement is exhaustive over possible mask value,
-           the allowable masks for 24 bit and 32 bit surfaces */
+static Py_ssize_t
+_pg_pool_size(SDL_Surface *surf)
+{
+    return (Py_ssize_t)surf->pitch * surf->h;
+}
 
-#if SDL_BYTEORDER == SDL_LIL_ENDIAN
-        case 0x000000ffU:
-            break;
-        case 0x0000ff00U:
-            startpixel += 1;
-            break;
-        case 0x00ff0000U:
-            startpixel += 2;
-            break;
-        case 0xff000000U:
-            startpixel += 3;
-            break;
-#else  /* SDL_BYTEORDER != SDL_LIL_ENDIAN */
-        case 0x000000ffU:
-            startpixel += pixelsize - 1;
-            break;
-        case 0x0000ff00U:
-            startpixel += pixelsize - 2;
-            break;
-        case 0x00ff0000U:
-            startpixel += pixelsize - 3;
-            break;
-        case 0xff000000U:
-            break;
-#endif /* SDL_BYTEORDER != SDL_LIL_ENDIAN */
+static void
+_pg_pool_remove(int index)
+{
+    pg_surface_pool.bytes -= _pg_pool_size(pg_surface_pool.surfs[index]);
+    --pg_surface_pool.count;
+    memmove(pg_surface_pool.surfs + index, pg_surface_pool.surfs + index + 1,
+            (pg_surface_pool.count - index) * sizeof(SDL_Surface *));
+}
 
-#ifndef NDEBUG
-            /* Assert this switch statement is exhaustive */
-        default:
-            /* Should not be here */
-            PyErr_Format(PyExc_SystemError,
-                         "Pygame bug caught at line %i in file %s: "
-                         "unknown mask value %X. Please report",
-                         (int)__LINE__, __FILE__, mask);
-            return -1;
-#endif
-    }
-    if (_init_buffer(obj, view_p, flags)) {
-        return -1;
-    }
-    view_p->buf = startpixel;
-    if (PyBUF_HAS_FLAG(flags, PyBUF_FORMAT)) {
-        view_p->format = FormatUint8;
+static void
+_pg_pool_clear(void)
+{
+    while (pg_surface_pool.count) {
+        SDL_FreeSurface(pg_surface_pool.surfs[0]);
+        _pg_pool_remove(0);
     }
-    view_p->itemsize = 1;
-    view_p->ndim = 2;
-    view_p->readonly = 0;
-    view_p->len = (Py_ssize_t)surface->w * surface->h;
-    view_p->shape[0] = surface->w;
-    view_p->shape[1] = surface->h;
-    view_p->strides[0] = pixelsize;
-    view_p->strides[1] = surface->pitch;
-    Py_INCREF(obj);
-    view_p->obj = obj;
-    return 0;
+    /* pygame.quit() forgets the quit functions it ran */
+    pg_surface_pool.quit_registered = 0;
 }
 
+/* Keeps surf for reuse, evicting the oldest surfaces to stay within the
+ * budget. Returns 0 if surf can not be kept. */
 static int
-_init_buffer(PyObject *surf, Py_buffer *view_p, int flags)
+_pg_pool_park(SDL_Surface *surf)
 {
-    PyObject *consumer;
-    pg_bufferinternal *internal;
+    Py_ssize_t size = _pg_pool_size(surf);
 
-    assert(surf);
-    assert(view_p);
-    assert(pgSurface_Check(surf));
-    assert(PyBUF_HAS_FLAG(flags, PyBUF_PYGAME));
-    consumer = ((pg_buffer *)view_p)->consumer;
-    assert(consumer);
-    internal = PyMem_New(pg_bufferinternal, 1);
-    if (!internal) {
-        PyErr_NoMemory();
-        return -1;
+    /* Shared (copy-on-write copies hold a reference), RLE encoded or
+     * foreign pixels are never recycled */
+    if (!_pg_pool_is_tagged(surf) || surf->refcount != 1 ||
+        (surf->flags & SDL_PREALLOC) || SDL_MUSTLOCK(surf) ||
+        size > pg_surface_pool.budget) {
+        return 0;
     }
-    internal->consumer_ref = PyWeakref_NewRef(consumer, 0);
-    if (!internal->consumer_ref) {
-        PyMem_Free(internal);
-        return -1;
+    while (pg_surface_pool.count == PG_POOL_MAX_SURFACES ||
+           pg_surface_pool.bytes + size > pg_surface_pool.budget) {
+        SDL_FreeSurface(pg_surface_pool.surfs[0]);
+        _pg_pool_remove(0);
     }
-    if (!pgSurface_LockBy((pgSurfaceObject *)surf, consumer)) {
-        PyErr_Format(pgExc_BufferError,
-                     "Unable to lock <%s at %p> by <%s at %p>",
-                     Py_TYPE(surf)->tp_name, (void *)surf,
-                     Py_TYPE(consumer)->tp_name, (void *)consumer);
-        Py_DECREF(internal->consumer_ref);
-        PyMem_Free(internal);
-        return -1;
+    pg_surface_pool.surfs[pg_surface_pool.count++] = surf;
+    pg_surface_pool.bytes += size;
+
+    if (!pg_surface_pool.quit_registered) {
+        pg_RegisterQuit(_pg_pool_clear);
+        pg_surface_pool.quit_registered = 1;
     }
-    if (PyBUF_HAS_FLAG(flags, PyBUF_ND)) {
-        view_p->shape = internal->mem;
-        if (PyBUF_HAS_FLAG(flags, PyBUF_STRIDES)) {
-            view_p->strides = internal->mem + 3;
-        }
-        else {
-            view_p->strides = 0;
+    return 1;
+}
+
+/* Creates a zeroed surface like PG_CreateSurface, recycling the pixels of a
+ * pooled one when possible. Palettized surfaces are never pooled. */
+static SDL_Surface *
+pgSurface_PoolCreate(int width, int height, PG_PixelFormatEnum format)
+{
+    SDL_Surface *surf;
+    int i;
+
+    if (SDL_ISPIXELFORMAT_INDEXED(format)) {
+        return PG_CreateSurface(width, height, format);
+    }
+
+    /* Newest first, it is the most likely to still be in the cache */
+    for (i = pg_surface_pool.count - 1; i >= 0; --i) {
+        surf = pg_surface_pool.surfs[i];
+        if (surf->w != width || surf->h != height ||
+            PG_SURF_FORMATENUM(surf) != format) {
+            continue;
         }
+        _pg_pool_remove(i);
+        ++pg_surface_pool.hits;
+
+        /* Back to the state of a new surface */
+        memset(surf->pixels, 0, (size_t)_pg_pool_size(surf));
+        SDL_SetClipRect(surf, NULL);
+        PG_SetSurfaceColorKey(surf, SDL_FALSE, 0);
+        PG_SetSurfaceAlphaMod(surf, 255);
+        SDL_SetSurfaceColorMod(surf, 255, 255, 255);
+        PG_SetSurfaceBlendMode(surf, SDL_ISPIXELFORMAT_ALPHA(format)
+                                         ? SDL_BLENDMODE_BLEND
+                                         : SDL_BLENDMODE_NONE);
+        return surf;
     }
-    else {
-        view_p->shape = 0;
-        view_p->strides = 0;
+
+    ++pg_surface_pool.misses;
+    surf = PG_CreateSurface(width, height, format);
+    if (surf) {
+        _pg_pool_tag(surf);
     }
-    view_p->ndim = 0;
-    view_p->format = 0;
-    view_p->suboffsets = 0;
-    view_p->internal = internal;
-    ((pg_buffer *)view_p)->release_buffer = _release_buffer;
-    return 0;
+    return surf;
 }
 
+/* Frees surf, or keeps it in the pool if it came from it */
 static void
-_release_buffer(Py_buffer *view_p)
+pgSurface_PoolRelease(SDL_Surface *surf)
 {
-    pg_bufferinternal *internal;
-    PyObject *consumer_ref;
-    PyObject *consumer = NULL;
+    if (!_pg_pool_park(surf)) {
+        SDL_FreeSurface(surf);
+    }
+}
 
-    assert(view_p && view_p->obj && view_p->internal);
-    internal = (pg_bufferinternal *)view_p->internal;
-    consumer_ref = internal->consumer_ref;
-    assert(consumer_ref && PyWeakref_CheckRef(consumer_ref));
+static PyObject *
+pgSurface_PoolStats(void)
+{
+    return Py_BuildValue(
+        "{s:n,s:n,s:i,s:n,s:n}", "hits", pg_surface_pool.hits, "misses",
+        pg_surface_pool.misses, "count", pg_surface_pool.count, "bytes",
+        pg_surface_pool.bytes, "budget", pg_surface_pool.budget);
+}
 
-    if (PyWeakref_GetRef(consumer_ref, &consumer) != 1) {
-        PyErr_Clear();  // ignore any errors here
+static void
+pgSurface_PoolSetBudget(Py_ssize_t budget)
+{
+    pg_surface_pool.budget = budget;
+    while (pg_surface_pool.bytes > budget) {
+        SDL_FreeSurface(pg_surface_pool.surfs[0]);
+        _pg_pool_remove(0);
     }
+}
 
-    if (!pgSurface_UnlockBy((pgSurfaceObject *)view_p->obj, consumer)) {
-        PyErr_Clear();
+/* BlitBatch: a packed array of blits that Surface.fblits can run without
+ * touching any Python objects besides the sources themselves. */
+
+static int
+_blitbatch_reserve(pgBlitBatchObject *self, Py_ssize_t needed)
+{
+    Py_ssize_t new_size;
+    pgBlitBatchItem *items;
+
+    if (needed <= self->allocated) {
+        return 0;
+    }
+    new_size = self->allocated ? self->allocated : 16;
+    while (new_size < needed) {
+        new_size *= 2;
     }
-    Py_XDECREF(consumer);
 
-    Py_DECREF(consumer_ref);
-    PyMem_Free(internal);
-    Py_DECREF(view_p->obj);
-    view_p->obj = 0;
+    items = (pgBlitBatchItem *)PyMem_Realloc(
+        self->items, (size_t)new_size * sizeof(pgBlitBatchItem));
+    if (!items) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    self->items = items;
+    self->allocated = new_size;
+    return 0;
 }
 
 static int
-_view_kind(PyObject *obj, void *view_kind_vptr)
+_blitbatch_append(pgBlitBatchObject *self, PyObject *source, PyObject *dest,
+                  PyObject *area, int blend_flags)
 {
-    unsigned long ch;
-    SurfViewKind *view_kind_ptr = (SurfViewKind *)view_kind_vptr;
+    pgBlitBatchItem *item;
+    SDL_Rect *rect, temp;
+    int x, y;
 
-    if (PyUnicode_Check(obj)) {
-        if (PyUnicode_GET_LENGTH(obj) != 1) {
-            PyErr_SetString(PyExc_TypeError,
-                            "expected a length 1 string for argument 1");
-            return 0;
-        }
-        ch = PyUnicode_READ_CHAR(obj, 0);
+    if (!pgSurface_Check(source)) {
+        PyErr_SetString(PyExc_TypeError, "Source objects must be a Surface");
+        return -1;
     }
-    else if (PyBytes_Check(obj)) {
-        if (PyBytes_GET_SIZE(obj) != 1) {
-            PyErr_SetString(PyExc_TypeError,
-                            "expected a length 1 string for argument 1");
-            return 0;
+    if ((rect = pgRect_FromObject(dest, &temp))) {
+        x = rect->x;
+        y = rect->y;
+    }
+    else if (!pg_TwoIntsFromObj(dest, &x, &y)) {
+        PyErr_SetString(PyExc_TypeError,
+                        "invalid destination position for blit");
+        return -1;
+    }
+    if (area && area != Py_None) {
+        if (!(rect = pgRect_FromObject(area, &temp))) {
+            PyErr_SetString(PyExc_TypeError, "Invalid rectstyle argument");
+            return -1;
+        }
+        /* An empty area still has to stay distinguishable from "no area" */
+        temp = *rect;
+        if (temp.w < 0) {
+            temp.w = 0;
+        }
+        if (temp.h < 0) {
+            temp.h = 0;
         }
-        ch = *PyBytes_AS_STRING(obj);
     }
     else {
-        PyErr_Format(PyExc_TypeError,
-                     "expected a length one string for argument 1: got '%s'",
-                     Py_TYPE(obj)->tp_name);
-        return 0;
+        temp.x = temp.y = temp.h = 0;
+        temp.w = -1;
     }
-    switch (ch) {
-        case '0':
-            *view_kind_ptr = VIEWKIND_0D;
-            break;
-        case '1':
-            *view_kind_ptr = VIEWKIND_1D;
-            break;
-        case '2':
-            *view_kind_ptr = VIEWKIND_2D;
-            break;
-        case 'R':
-        case 'r':
-            *view_kind_ptr = VIEWKIND_RED;
-            break;
-        case 'G':
-        case 'g':
-            *view_kind_ptr = VIEWKIND_GREEN;
+
+    if (_blitbatch_reserve(self, self->length + 1)) {
+        return -1;
+    }
+
+    item = &self->items[self->length++];
+    Py_INCREF(source);
+    item->source = (pgSurfaceObject *)source;
+    item->area = temp;
+    item->x = x;
+    item->y = y;
+    item->blend_flags = blend_flags;
+    return 0;
+}
+
+static int
+_blitbatch_extend(pgBlitBatchObject *self, PyObject *blit_sequence)
+{
+    PyObject *iterator, *item, *fast_item;
+    PyObject *area, *special_flags;
+    Py_ssize_t length;
+    int blend_flags;
+
+    if (!(iterator = PyObject_GetIter(blit_sequence))) {
+        return -1;
+    }
+
+    while ((item = PyIter_Next(iterator))) {
+        fast_item = PySequence_Fast(
+            item, "blit_sequence items should be (Surface, dest, area, "
+                  "special_flags) with area and special_flags optional");
+        Py_DECREF(item);
+        if (!fast_item) {
             break;
-        case 'B':
-        case 'b':
-            *view_kind_ptr = VIEWKIND_BLUE;
+        }
+        length = PySequence_Fast_GET_SIZE(fast_item);
+        if (length < 2 || length > 4) {
+            Py_DECREF(fast_item);
+            PyErr_SetString(PyExc_ValueError,
+                            "blit_sequence items should be (Surface, dest, "
+                            "area, special_flags) with area and "
+                            "special_flags optional");
             break;
-        case 'A':
-        case 'a':
-            *view_kind_ptr = VIEWKIND_ALPHA;
+        }
+
+        area = length > 2 ? PySequence_Fast_GET_ITEM(fast_item, 2) : NULL;
+        special_flags =
+            length > 3 ? PySequence_Fast_GET_ITEM(fast_item, 3) : NULL;
+        blend_flags = 0;
+        if (special_flags && !pg_IntFromObj(special_flags, &blend_flags)) {
+            Py_DECREF(fast_item);
+            PyErr_SetString(PyExc_TypeError, "Must assign numeric values");
             break;
-        case '3':
-            *view_kind_ptr = VIEWKIND_3D;
+        }
+
+        if (_blitbatch_append(self, PySequence_Fast_GET_ITEM(fast_item, 0),
+                              PySequence_Fast_GET_ITEM(fast_item, 1), area,
+                              blend_flags)) {
+            Py_DECREF(fast_item);
             break;
-        default:
-            PyErr_Format(PyExc_TypeError,
-                         "unrecognized view kind '%c' for argument 1",
-                         (int)ch);
-            return 0;
+        }
+        Py_DECREF(fast_item);
     }
-    return 1;
+
+    Py_DECREF(iterator);
+    return PyErr_Occurred() ? -1 : 0;
 }
 
-static PyObject *
-surf_get_pixels_address(PyObject *self, PyObject *closure)
+static void
+_blitbatch_clear_items(pgBlitBatchObject *self)
 {
-    SDL_Surface *surface = pgSurface_AsSurface(self);
-    void *address;
+    pgSurfaceObject *source;
 
-    if (!surface) {
-        Py_RETURN_NONE;
-    }
-    if (!surface->pixels) {
-        return PyLong_FromLong(0L);
+    /* Dropping a source may run arbitrary code that changes the batch, so
+     * always shrink it before letting go of the reference */
+    while (self->length > 0) {
+        source = self->items[--self->length].source;
+        Py_DECREF(source);
     }
-    address = surface->pixels;
-#if SIZEOF_VOID_P > SIZEOF_LONG
-    return PyLong_FromUnsignedLongLong((unsigned PY_LONG_LONG)address);
-#else
-    return PyLong_FromUnsignedLong((unsigned long)address);
-#endif
 }
 
 static int
-surface_do_overlap(SDL_Surface *src, SDL_Rect *srcrect, SDL_Surface *dst,
-                   SDL_Rect *dstrect, SDL_Rect *clip)
+blitbatch_traverse(pgBlitBatchObject *self, visitproc visit, void *arg)
 {
-    Uint8 *srcpixels;
-    Uint8 *dstpixels;
-    int srcx = srcrect->x, srcy = srcrect->y;
-    int dstx = dstrect->x, dsty = dstrect->y;
-    int x, y;
-    int w = srcrect->w, h = srcrect->h;
-    int maxw, maxh;
-    int span;
-    int dstoffset;
+    Py_ssize_t i;
 
-    /* clip the source rectangle to the source surface */
-    if (srcx < 0) {
-        w += srcx;
-        dstx -= srcx;
-        srcx = 0;
-    }
-    maxw = src->w - srcx;
-    if (maxw < w) {
-        w = maxw;
+    for (i = 0; i < self->length; i++) {
+        Py_VISIT(self->items[i].source);
     }
+    return 0;
+}
 
-    if (srcy < 0) {
-        h += srcy;
-        dsty -= srcy;
-        srcy = 0;
+static int
+blitbatch_clear(pgBlitBatchObject *self)
+{
+    _blitbatch_clear_items(self);
+    return 0;
+}
+
+static void
+blitbatch_dealloc(pgBlitBatchObject *self)
+{
+    PyObject_GC_UnTrack(self);
+    _blitbatch_clear_items(self);
+    PyMem_Free(self->items);
+    Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+static int
+blitbatch_init(pgBlitBatchObject *self, PyObject *args, PyObject *kwds)
+{
+    PyObject *blit_sequence = NULL;
+    static char *kwids[] = {"blit_sequence", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|O", kwids,
+                                     &blit_sequence)) {
+        return -1;
     }
-    maxh = src->h - srcy;
-    if (maxh < h) {
-        h = maxh;
+
+    _blitbatch_clear_items(self);
+    if (blit_sequence) {
+        return _blitbatch_extend(self, blit_sequence);
     }
+    return 0;
+}
 
-    /* clip the destination rectangle against the clip rectangle */
-    x = clip->x - dstx;
-    if (x > 0) {
-        w -= x;
-        dstx += x;
-        srcx += x;
+static PyObject *
+blitbatch_repr(pgBlitBatchObject *self)
+{
+    return PyUnicode_FromFormat("<BlitBatch(%zd blits)>", self->length);
+}
+
+static Py_ssize_t
+blitbatch_length(pgBlitBatchObject *self)
+{
+    return self->length;
+}
+
+static PyObject *
+blitbatch_append(pgBlitBatchObject *self, PyObject *args, PyObject *kwds)
+{
+    PyObject *source, *dest, *area = NULL;
+    int blend_flags = 0;
+    static char *kwids[] = {"source", "dest", "area", "special_flags", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "OO|Oi", kwids, &source,
+                                     &dest, &area, &blend_flags)) {
+        return NULL;
     }
-    x = dstx + w - clip->x - clip->w;
-    if (x > 0) {
-        w -= x;
+    if (_blitbatch_append(self, source, dest, area, blend_flags)) {
+        return NULL;
     }
-    y = clip->y - dsty;
-    if (y > 0) {
-        h -= y;
-        dsty += y;
-        srcy += y;
+    Py_RETURN_NONE;
+}
+
+static PyObject *
+blitbatch_extend(pgBlitBatchObject *self, PyObject *blit_sequence)
+{
+    if (_blitbatch_extend(self, blit_sequence)) {
+        return NULL;
     }
-    y = dsty + h - clip->y - clip->h;
-    if (y > 0) {
-        h -= y;
+    Py_RETURN_NONE;
+}
+
+static PyObject *
+blitbatch_clear_method(pgBlitBatchObject *self, PyObject *_null)
+{
+    _blitbatch_clear_items(self);
+    Py_RETURN_NONE;
+}
+
+/* Reads one number of a buffer exported position array into *coord. kind
+ * is 'i' for signed, 'u' for unsigned and 'f' for floating point items.
+ * Returns -1 with an exception set if the number is not finite or does not
+ * fit in an int. */
+static int
+_blitbatch_read_coord(const char *p, char kind, Py_ssize_t itemsize,
+                      int *coord)
+{
+    Sint64 value;
+
+    switch (kind) {
+        case 'f': {
+            double d;
+            if (itemsize == 4) {
+                float f;
+                memcpy(&f, p, 4);
+                d = f;
+            }
+            else {
+                memcpy(&d, p, 8);
+            }
+            if (!isfinite(d)) {
+                PyErr_SetString(PyExc_ValueError,
+                                "coordinates must be finite numbers");
+                return -1;
+            }
+            /* Checked as a double, the cast is undefined past the range */
+            if (d <= (double)INT_MIN - 1.0 || d >= (double)INT_MAX + 1.0) {
+                PyErr_SetString(PyExc_OverflowError,
+                                "coordinate is out of the int range");
+                return -1;
+            }
+            *coord = (int)d;
+            return 0;
+        }
+        case 'u':
+            switch (itemsize) {
+                case 1:
+                    value = *(const Uint8 *)p;
+                    break;
+                case 2: {
+                    Uint16 v;
+                    memcpy(&v, p, 2);
+                    value = v;
+                    break;
+                }
+                case 4: {
+                    Uint32 v;
+                    memcpy(&v, p, 4);
+                    value = v;
+                    break;
+                }
+                default: {
+                    Uint64 v;
+                    memcpy(&v, p, 8);
+                    /* Anything past INT_MAX fails the range check below */
+                    value = v > INT_MAX ? (Sint64)INT_MAX + 1 : (Sint64)v;
+                    break;
+                }
+            }
+            break;
+        default:
+            switch (itemsize) {
+                case 1:
+                    value = *(const Sint8 *)p;
+                    break;
+                case 2: {
+                    Sint16 v;
+                    memcpy(&v, p, 2);
+                    value = v;
+                    break;
+                }
+                case 4: {
+                    Sint32 v;
+                    memcpy(&v, p, 4);
+                    value = v;
+                    break;
+                }
+                default:
+                    memcpy(&value, p, 8);
+                    break;
+            }
+            break;
     }
-
-    if (w <= 0 || h <= 0) {
-        return 0;
+    if (value < INT_MIN || value > INT_MAX) {
+        PyErr_SetString(PyExc_OverflowError,
+                        "coordinate is out of the int range");
+        return -1;
     }
+    *coord = (int)value;
+    return 0;
+}
 
-    srcpixels = ((Uint8 *)src->pixels + srcy * src->pitch +
-                 srcx * PG_SURF_BytesPerPixel(src));
-    dstpixels = ((Uint8 *)dst->pixels + dsty * dst->pitch +
-                 dstx * PG_SURF_BytesPerPixel(dst));
+/* Returns the item kind of a position array, or 0 if it is unsupported */
+static char
+_blitbatch_view_kind(Py_buffer *view_p)
+{
+    const char *format = view_p->format ? view_p->format : "B";
+    char kind;
 
-    if (dstpixels <= srcpixels) {
-        return 0;
+    switch (*format) {
+        case '@':
+        case '=':
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+        case '<':
+#else
+        case '>':
+        case '!':
+#endif
+            ++format;
+            break;
     }
-
-    span = w * PG_SURF_BytesPerPixel(src);
-
-    if (dstpixels >= srcpixels + (h - 1) * src->pitch + span) {
+    switch (*format) {
+        case 'b':
+        case 'h':
+        case 'i':
+        case 'l':
+        case 'q':
+            kind = 'i';
+            break;
+        case 'B':
+        case 'H':
+        case 'I':
+        case 'L':
+        case 'Q':
+            kind = 'u';
+            break;
+        case 'f':
+        case 'd':
+            kind = 'f';
+            break;
+        default:
+            return 0;
+    }
+    if (format[1] != '\0') {
         return 0;
     }
-
-    dstoffset = (dstpixels - srcpixels) % src->pitch;
-
-    return dstoffset < span || dstoffset > src->pitch - span;
+    switch (view_p->itemsize) {
+        case 1:
+        case 2:
+            return kind == 'f' ? 0 : kind;
+        case 4:
+        case 8:
+            return kind;
+    }
+    return 0;
 }
 
-int
-PG_BlitSurface(SDL_Surface *src, const SDL_Rect *srcrect, SDL_Surface *dst,
-               SDL_Rect *dstrect)
+static int
+_blitbatch_set_positions_from_buffer(pgBlitBatchObject *self, PyObject *obj)
 {
-#if SDL_VERSION_ATLEAST(3, 0, 0)
-    /* SDL3 doesn't modify dstrect, so compat for that.
-     * Below logic taken from SDL2 source with slight modifications */
-    SDL_Rect r_src, r_dst;
+    Py_buffer view;
+    Py_ssize_t i, count, stride_item, stride_coord;
+    const char *p;
+    char kind;
+    int x, y;
 
-    r_src.x = 0;
-    r_src.y = 0;
-    r_src.w = src->w;
-    r_src.h = src->h;
+    if (PyObject_GetBuffer(obj, &view, PyBUF_RECORDS_RO)) {
+        return -1;
+    }
 
-    if (dstrect) {
-        r_dst.x = dstrect->x;
-        r_dst.y = dstrect->y;
+    if (!(kind = _blitbatch_view_kind(&view))) {
+        PyBuffer_Release(&view);
+        PyErr_SetString(PyExc_ValueError,
+                        "Unsupported array item type for positions");
+        return -1;
     }
-    else {
-        r_dst.x = 0;
-        r_dst.y = 0;
+    if (view.ndim == 2 && view.shape[1] == 2) {
+        count = view.shape[0];
+        stride_item = view.strides[0];
+        stride_coord = view.strides[1];
     }
-
-    /* clip the source rectangle to the source surface */
-    if (srcrect) {
-        SDL_Rect tmp;
-        if (SDL_IntersectRect(srcrect, &r_src, &tmp) == SDL_FALSE) {
-            goto end;
-        }
-
-        /* Shift dstrect, if srcrect origin has changed */
-        r_dst.x += tmp.x - srcrect->x;
-        r_dst.y += tmp.y - srcrect->y;
-
-        /* Update srcrect */
-        r_src = tmp;
+    else if (view.ndim == 1 && view.shape[0] % 2 == 0) {
+        count = view.shape[0] / 2;
+        stride_item = view.strides[0] * 2;
+        stride_coord = view.strides[0];
     }
-
-    /* There're no dstrect.w/h parameters. It's the same as srcrect */
-    r_dst.w = r_src.w;
-    r_dst.h = r_src.h;
-
-    /* clip the destination rectangle against the clip rectangle */
-    {
-        SDL_Rect tmp, clip_rect;
-        SDL_GetSurfaceClipRect(dst, &clip_rect);
-        if (SDL_IntersectRect(&r_dst, &clip_rect, &tmp) == SDL_FALSE) {
-            goto end;
-        }
-
-        /* Update dstrect */
-        r_dst = tmp;
+    else {
+        PyBuffer_Release(&view);
+        PyErr_SetString(PyExc_ValueError,
+                        "positions array must have a shape of (n, 2) or "
+                        "(n * 2,)");
+        return -1;
+    }
+    if (count != self->length) {
+        PyBuffer_Release(&view);
+        PyErr_Format(PyExc_ValueError,
+                     "expected %zd positions, got %zd instead", self->length,
+                     count);
+        return -1;
     }
 
-    if (r_dst.w > 0 && r_dst.h > 0) {
-        if (dstrect) { /* update output parameter */
-            *dstrect = r_dst;
+    /* Checked first so a bad item leaves the batch untouched */
+    p = (const char *)view.buf;
+    for (i = 0; i < count; i++, p += stride_item) {
+        if (_blitbatch_read_coord(p, kind, view.itemsize, &x) ||
+            _blitbatch_read_coord(p + stride_coord, kind, view.itemsize,
+                                  &y)) {
+            PyBuffer_Release(&view);
+            return -1;
         }
-        return SDL_BlitSurface(src, srcrect, dst, dstrect) ? 0 : -1;
     }
-end:
-    if (dstrect) {
-        dstrect->w = dstrect->h = 0;
+    p = (const char *)view.buf;
+    for (i = 0; i < count; i++, p += stride_item) {
+        _blitbatch_read_coord(p, kind, view.itemsize, &self->items[i].x);
+        _blitbatch_read_coord(p + stride_coord, kind, view.itemsize,
+                              &self->items[i].y);
     }
+
+    PyBuffer_Release(&view);
     return 0;
-#else
-    return SDL_BlitSurface(src, srcrect, dst, dstrect);
-#endif
 }
 
-/*this internal blit function is accessible through the C api*/
-int
-pgSurface_Blit(pgSurfaceObject *dstobj, pgSurfaceObject *srcobj,
-               SDL_Rect *dstrect, SDL_Rect *srcrect, int blend_flags)
+static PyObject *
+blitbatch_set_positions(pgBlitBatchObject *self, PyObject *positions)
 {
-    SDL_Surface *src = pgSurface_AsSurface(srcobj);
-    SDL_Surface *dst = pgSurface_AsSurface(dstobj);
-    SDL_Surface *subsurface = NULL;
-    int result, suboffsetx = 0, suboffsety = 0;
-    SDL_Rect orig_clip, sub_clip, dstclip;
-    Uint8 alpha;
-
-    if (!PG_GetSurfaceClipRect(dst, &dstclip)) {
-        PyErr_SetString(pgExc_SDLError, SDL_GetError());
-        return 1;
-    }
-
-    /* passthrough blits to the real surface */
-    if (((pgSurfaceObject *)dstobj)->subsurface) {
-        PyObject *owner;
-        struct pgSubSurface_Data *subdata;
-
-        subdata = ((pgSurfaceObject *)dstobj)->subsurface;
-        owner = subdata->owner;
-        subsurface = pgSurface_AsSurface(owner);
-        suboffsetx = subdata->offsetx;
-        suboffsety = subdata->offsety;
+    PyObject *fast_seq;
+    PyObject **seq_items;
+    Py_ssize_t i, count;
+    int *coords;
 
-        while (((pgSurfaceObject *)owner)->subsurface) {
-            subdata = ((pgSurfaceObject *)owner)->subsurface;
-            owner = subdata->owner;
-            subsurface = pgSurface_AsSurface(owner);
-            suboffsetx += subdata->offsetx;
-            suboffsety += subdata->offsety;
+    if (PyObject_CheckBuffer(positions)) {
+        if (_blitbatch_set_positions_from_buffer(self, positions)) {
+            return NULL;
         }
-
-        SDL_GetClipRect(subsurface, &orig_clip);
-        SDL_GetClipRect(dst, &sub_clip);
-        sub_clip.x += suboffsetx;
-        sub_clip.y += suboffsety;
-        SDL_SetClipRect(subsurface, &sub_clip);
-        dstrect->x += suboffsetx;
-        dstrect->y += suboffsety;
-        dst = subsurface;
-    }
-    else {
-        pgSurface_Prep(dstobj);
-        subsurface = NULL;
+        Py_RETURN_NONE;
     }
 
-    pgSurface_Prep(srcobj);
-
-    if ((blend_flags != 0 && blend_flags != PYGAME_BLEND_ALPHA_SDL2) ||
-        ((SDL_HasColorKey(src) || _PgSurface_SrcAlpha(src) == 1) &&
-         /* This simplification is possible because a source subsurface
-            is converted to its owner with a clip rect and a dst
-            subsurface cannot be blitted to its owner because the
-            owner is locked.
-            */
-         dst->pixels == src->pixels && srcrect != NULL &&
-         surface_do_overlap(src, srcrect, dst, dstrect, &dstclip))) {
-        /* Py_BEGIN_ALLOW_THREADS */
-        result = pygame_Blit(src, srcrect, dst, dstrect, blend_flags);
-        /* Py_END_ALLOW_THREADS */
+    fast_seq = PySequence_Fast(
+        positions, "positions must be a sequence of (x, y) pairs or an array");
+    if (!fast_seq) {
+        return NULL;
     }
-    /* can't blit alpha to 8bit, crashes SDL */
-    else if (PG_SURF_BytesPerPixel(dst) == 1 &&
-             (SDL_ISPIXELFORMAT_ALPHA(PG_SURF_FORMATENUM(src)) ||
-              ((PG_GetSurfaceAlphaMod(src, &alpha) && alpha != 255)))) {
-        /* Py_BEGIN_ALLOW_THREADS */
-        if (PG_SURF_BytesPerPixel(src) == 1) {
-            result = pygame_Blit(src, srcrect, dst, dstrect, 0);
-        }
-        else {
-#if SDL_VERSION_ATLEAST(3, 0, 0)
-            const SDL_PixelFormatDetails *fmt =
-                SDL_GetPixelFormatDetails(src->format);
-            src = fmt ? SDL_ConvertSurface(src,
-                                           SDL_GetPixelFormatForMasks(
-                                               fmt->bits_per_pixel, fmt->Rmask,
-                                               fmt->Gmask, fmt->Bmask, 0))
-                      : NULL;
-#else
-            SDL_PixelFormat *fmt = src->format;
-            SDL_PixelFormat *newfmt =
-                SDL_AllocFormat(SDL_MasksToPixelFormatEnum(
-                    fmt->BitsPerPixel, fmt->Rmask, fmt->Gmask, fmt->Bmask, 0));
-            if (!newfmt) {
-                src = NULL;
-            }
-            else {
-                src = SDL_ConvertSurface(src, newfmt, 0);
-                SDL_FreeFormat(newfmt);
-            }
-#endif
-            if (src) {
-                result = PG_BlitSurface(src, srcrect, dst, dstrect);
-                SDL_FreeSurface(src);
-            }
-            else {
-                result = -1;
-            }
+    count = PySequence_Fast_GET_SIZE(fast_seq);
+    if (count != self->length) {
+        Py_DECREF(fast_seq);
+        return PyErr_Format(PyExc_ValueError,
+                            "expected %zd positions, got %zd instead",
+                            self->length, count);
+    }
+
+    /* Parse everything first so a bad item leaves the batch untouched */
+    if (!(coords = PyMem_New(int, count * 2 + 1))) {
+        Py_DECREF(fast_seq);
+        return PyErr_NoMemory();
+    }
+    seq_items = PySequence_Fast_ITEMS(fast_seq);
+    for (i = 0; i < count; i++) {
+        if (!pg_TwoIntsFromObj(seq_items[i], &coords[i * 2],
+                               &coords[i * 2 + 1])) {
+            PyMem_Free(coords);
+            Py_DECREF(fast_seq);
+            return RAISE(PyExc_TypeError,
+                         "invalid destination position for blit");
         }
-        /* Py_END_ALLOW_THREADS */
-    }
-    else if (blend_flags != PYGAME_BLEND_ALPHA_SDL2 &&
-             !(pg_EnvShouldBlendAlphaSDL2()) && !SDL_HasColorKey(src) &&
-             (PG_SURF_BytesPerPixel(dst) == 4 ||
-              PG_SURF_BytesPerPixel(dst) == 2) &&
-             _PgSurface_SrcAlpha(src) &&
-             (SDL_ISPIXELFORMAT_ALPHA(PG_SURF_FORMATENUM(src))) &&
-             !PG_SurfaceHasRLE(src) && !PG_SurfaceHasRLE(dst) &&
-             !SDL_MUSTLOCK(src) && !SDL_MUSTLOCK(dst)) {
-        /* If we have a 32bit source surface with per pixel alpha
-           and no RLE we'll use pygame_Blit so we can mimic how SDL1
-            behaved */
-        result = pygame_Blit(src, srcrect, dst, dstrect, blend_flags);
     }
-    else {
-        /* Py_BEGIN_ALLOW_THREADS */
-        result = PG_BlitSurface(src, srcrect, dst, dstrect);
-        /* Py_END_ALLOW_THREADS */
+    for (i = 0; i < count; i++) {
+        self->items[i].x = coords[i * 2];
+        self->items[i].y = coords[i * 2 + 1];
     }
 
-    if (subsurface) {
-        SDL_SetClipRect(subsurface, &orig_clip);
-        dstrect->x -= suboffsetx;
-        dstrect->y -= suboffsety;
-    }
-    else {
-        pgSurface_Unprep(dstobj);
-    }
-    pgSurface_Unprep(srcobj);
+    PyMem_Free(coords);
+    Py_DECREF(fast_seq);
+    Py_RETURN_NONE;
+}
 
-    if (result == -1) {
-        PyErr_SetString(pgExc_SDLError, SDL_GetError());
-    }
-    if (result == -2) {
-        PyErr_SetString(pgExc_SDLError, "Surface was lost");
-    }
+static PyMethodDef blitbatch_methods[] = {
+    {"append", (PyCFunction)blitbatch_append, METH_VARARGS | METH_KEYWORDS,
+     DOC_BLITBATCH_APPEND},
+    {"extend", (PyCFunction)blitbatch_extend, METH_O, DOC_BLITBATCH_EXTEND},
+    {"clear", (PyCFunction)blitbatch_clear_method, METH_NOARGS,
+     DOC_BLITBATCH_CLEAR},
+    {"set_positions", (PyCFunction)blitbatch_set_positions, METH_O,
+     DOC_BLITBATCH_SETPOSITIONS},
+    {NULL, NULL, 0, NULL}};
 
-    return result != 0;
-}
+static PySequenceMethods blitbatch_as_sequence = {
+    .sq_length = (lenfunc)blitbatch_length,
+};
+
+static PyTypeObject pgBlitBatch_Type = {
+    PyVarObject_HEAD_INIT(NULL, 0).tp_name = "pygame.surface.BlitBatch",
+    .tp_basicsize = sizeof(pgBlitBatchObject),
+    .tp_dealloc = (destructor)blitbatch_dealloc,
+    .tp_repr = (reprfunc)blitbatch_repr,
+    .tp_as_sequence = &blitbatch_as_sequence,
+    .tp_flags =
+        Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE | Py_TPFLAGS_HAVE_GC,
+    .tp_doc = DOC_BLITBATCH,
+    .tp_traverse = (traverseproc)blitbatch_traverse,
+    .tp_clear = (inquiry)blitbatch_clear,
+    .tp_methods = blitbatch_methods,
+    .tp_init = (initproc)blitbatch_init,
+    .tp_new = PyType_GenericNew,
+};
 
 static PyMethodDef _surface_methods[] = {{NULL, NULL, 0, NULL}};
 
@@ -4694,6 +7257,9 @@ exec_surface(PyObject *module)
     if (PyType_Ready(&pgSurface_Type) < 0) {
         return -1;
     }
+    if (PyType_Ready(&pgBlitBatch_Type) < 0) {
+        return -1;
+    }
 
     PyObject *apiobj;
     static void *c_api[PYGAMEAPI_SURFACE_NUMSLOTS];
@@ -4712,11 +7278,21 @@ exec_surface(PyObject *module)
         return -1;
     }
 
+    if (PyModule_AddObjectRef(module, "BlitBatch",
+                              (PyObject *)&pgBlitBatch_Type)) {
+        return -1;
+    }
+
     /* export the c api */
     c_api[0] = &pgSurface_Type;
     c_api[1] = pgSurface_New2;
     c_api[2] = pgSurface_Blit;
     c_api[3] = pgSurface_SetSurface;
+    c_api[4] = pgSurface_AddDirtyRect;
+    c_api[5] = pgSurface_PoolCreate;
+    c_api[6] = pgSurface_PoolRelease;
+    c_api[7] = pgSurface_PoolStats;
+    c_api[8] = pgSurface_PoolSetBudget;
     apiobj = encapsulate_api(c_api, "surface");
     if (PyModule_Add(module, PYGAMEAPI_LOCAL_ENTRY, apiobj) < 0) {
         return -1;
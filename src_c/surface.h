@@ -348,6 +348,23 @@ int
 surface_fill_blend(SDL_Surface *surface, SDL_Rect *rect, Uint32 color,
                    int blendargs);
 
+int
+surface_fill_blend_rects(SDL_Surface *surface, SDL_Rect *rects,
+                         const Uint32 *colors, int ncolors, int count,
+                         int blendargs);
+
+#define PG_GRADIENT_LINEAR 0
+#define PG_GRADIENT_RADIAL 1
+#define PG_GRADIENT_CONIC 2
+
+/* Number of colors in the lookup table of a gradient */
+#define PG_GRADIENT_LUT_SIZE 1024
+
+int
+surface_fill_gradient(SDL_Surface *surface, SDL_Rect *rect, SDL_Rect *area,
+                      int kind, double angle, const Uint32 *lut,
+                      int blendargs);
+
 void
 surface_respect_clip_rect(SDL_Surface *surface, SDL_Rect *rect);
 
@@ -359,9 +376,22 @@ int
 pygame_Blit(SDL_Surface *src, SDL_Rect *srcrect, SDL_Surface *dst,
             SDL_Rect *dstrect, int blend_flags);
 
+int
+pygame_SpanBlitSupported(SDL_Surface *src, SDL_Surface *dst);
+
+int
+pygame_SpanBlit(SDL_Surface *src, struct pgSpanCache *spans,
+                SDL_Rect *srcrect, SDL_Surface *dst, SDL_Rect *dstrect);
+
+void
+pygame_SpanCacheFree(struct pgSpanCache *spans);
+
 int
 premul_surf_color_by_alpha(SDL_Surface *src, SDL_Surface *dst);
 
+int
+convert_surf_pixels(SDL_Surface *src, SDL_Surface *dst);
+
 int
 pg_warn_simd_at_runtime_but_uncompiled();
 
@@ -21,6 +21,10 @@
 
 #include "simd_fill.h"
 
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
 /*
  * Changes SDL_Rect to respect any clipping rect defined on the surface.
  * Necessary when modifying surface->pixels directly instead of through an
@@ -886,28 +890,14 @@ surface_fill_blend_rgba_max(SDL_Surface *surface, PG_PixelFormat *fmt,
     return result;
 }
 
-int
-surface_fill_blend(SDL_Surface *surface, SDL_Rect *rect, Uint32 color,
-                   int blendargs)
+/* Blends color into rect with the fastest kernel available for the
+ * surface, which must be locked if needed */
+static int
+surface_fill_blend_rect(SDL_Surface *surface, PG_PixelFormat *fmt,
+                        SDL_Palette *palette, SDL_Rect *rect, Uint32 color,
+                        int blendargs)
 {
     int result = -1;
-    int locked = 0;
-
-    surface_respect_clip_rect(surface, rect);
-
-    /* Lock the surface, if needed */
-    if (SDL_MUSTLOCK(surface)) {
-        if (!PG_LockSurface(surface)) {
-            return -1;
-        }
-        locked = 1;
-    }
-
-    PG_PixelFormat *fmt;
-    SDL_Palette *palette;
-    if (!PG_GetSurfaceDetails(surface, &fmt, &palette)) {
-        return -1;
-    }
 
     switch (blendargs) {
         case PYGAME_BLEND_ADD: {
@@ -1148,9 +1138,419 @@ surface_fill_blend(SDL_Surface *surface, SDL_Rect *rect, Uint32 color,
             break;
         }
     }
+    return result;
+}
+
+/* Blends count rects, with the color of each in colors, or colors[0] for
+ * all of them if ncolors is 1. The surface is locked once for all of
+ * them. */
+int
+surface_fill_blend_rects(SDL_Surface *surface, SDL_Rect *rects,
+                         const Uint32 *colors, int ncolors, int count,
+                         int blendargs)
+{
+    PG_PixelFormat *fmt;
+    SDL_Palette *palette;
+    int i, result = 0;
+    int locked = 0;
+
+    /* Lock the surface, if needed */
+    if (SDL_MUSTLOCK(surface)) {
+        if (!PG_LockSurface(surface)) {
+            return -1;
+        }
+        locked = 1;
+    }
+
+    if (!PG_GetSurfaceDetails(surface, &fmt, &palette)) {
+        result = -1;
+    }
+    for (i = 0; i < count && result == 0; i++) {
+        surface_respect_clip_rect(surface, &rects[i]);
+        result = surface_fill_blend_rect(surface, fmt, palette, &rects[i],
+                                         colors[ncolors == 1 ? 0 : i],
+                                         blendargs);
+    }
 
     if (locked) {
         SDL_UnlockSurface(surface);
     }
     return result;
 }
+
+int
+surface_fill_blend(SDL_Surface *surface, SDL_Rect *rect, Uint32 color,
+                   int blendargs)
+{
+    return surface_fill_blend_rects(surface, rect, &color, 1, 1, blendargs);
+}
+
+typedef void (*GradientBlendRowFunc)(Uint32 *dst, const Uint32 *src,
+                                     int width);
+
+static void
+gradient_row_linear(Uint32 *row, int width, const Uint32 *lut, float t,
+                    float dt)
+{
+    int i;
+
+#if !defined(__EMSCRIPTEN__)
+    if (_pg_has_avx2()) {
+        gradient_row_linear_avx2(row, width, lut, t, dt);
+        return;
+    }
+#if PG_ENABLE_SSE_NEON
+    if (_pg_HasSSE_NEON()) {
+        gradient_row_linear_sse2(row, width, lut, t, dt);
+        return;
+    }
+#endif /* PG_ENABLE_SSE_NEON */
+#endif /* __EMSCRIPTEN__ */
+    for (i = 0; i < width; i++) {
+        row[i] = lut[gradient_lut_index(t + (float)i * dt)];
+    }
+}
+
+static void
+gradient_row_radial(Uint32 *row, int width, const Uint32 *lut, float u,
+                    float du, float vv)
+{
+    int i;
+    float x;
+
+#if !defined(__EMSCRIPTEN__)
+    if (_pg_has_avx2()) {
+        gradient_row_radial_avx2(row, width, lut, u, du, vv);
+        return;
+    }
+#if PG_ENABLE_SSE_NEON
+    if (_pg_HasSSE_NEON()) {
+        gradient_row_radial_sse2(row, width, lut, u, du, vv);
+        return;
+    }
+#endif /* PG_ENABLE_SSE_NEON */
+#endif /* __EMSCRIPTEN__ */
+    for (i = 0; i < width; i++) {
+        x = u + (float)i * du;
+        row[i] = lut[gradient_lut_index(sqrtf(x * x + vv))];
+    }
+}
+
+static void
+gradient_row_conic(Uint32 *row, int width, const Uint32 *lut, double x,
+                   double y, double start)
+{
+    int i;
+    double t;
+
+    for (i = 0; i < width; i++, x += 1.0) {
+        t = (atan2(-y, x) - start) / (2.0 * M_PI);
+        t -= floor(t);
+        row[i] = lut[gradient_lut_index(
+            (float)(t * (PG_GRADIENT_LUT_SIZE - 1)))];
+    }
+}
+
+/* Returns the SIMD kernel blending a row of gradient colors into a 32 bit
+ * row, or NULL if there is none for the surface or for blendargs */
+static GradientBlendRowFunc
+gradient_blend_row_simd(SDL_Surface *surface, int blendargs)
+{
+#if !defined(__EMSCRIPTEN__)
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+    int avx2 = _pg_has_avx2();
+
+    if (PG_SURF_BytesPerPixel(surface) != 4) {
+        return NULL;
+    }
+#if PG_ENABLE_SSE_NEON
+    if (!avx2 && !_pg_HasSSE_NEON()) {
+        return NULL;
+    }
+#else
+    if (!avx2) {
+        return NULL;
+    }
+#endif /* PG_ENABLE_SSE_NEON */
+    switch (blendargs) {
+        case PYGAME_BLEND_ADD:
+        case PYGAME_BLEND_RGBA_ADD:
+            return avx2 ? gradient_blend_row_add_avx2
+                        : gradient_blend_row_add_sse2;
+        case PYGAME_BLEND_SUB:
+        case PYGAME_BLEND_RGBA_SUB:
+            return avx2 ? gradient_blend_row_sub_avx2
+                        : gradient_blend_row_sub_sse2;
+        case PYGAME_BLEND_MULT:
+        case PYGAME_BLEND_RGBA_MULT:
+            return avx2 ? gradient_blend_row_mult_avx2
+                        : gradient_blend_row_mult_sse2;
+        case PYGAME_BLEND_MIN:
+        case PYGAME_BLEND_RGBA_MIN:
+            return avx2 ? gradient_blend_row_min_avx2
+                        : gradient_blend_row_min_sse2;
+        case PYGAME_BLEND_MAX:
+        case PYGAME_BLEND_RGBA_MAX:
+            return avx2 ? gradient_blend_row_max_avx2
+                        : gradient_blend_row_max_sse2;
+    }
+#endif /* SDL_BYTEORDER == SDL_LIL_ENDIAN */
+#endif /* __EMSCRIPTEN__ */
+    return NULL;
+}
+
+/* Blends a row of gradient colors into width pixels, one at a time */
+static void
+gradient_blend_row(Uint8 *pixels, const Uint32 *row, int width,
+                   PG_PixelFormat *fmt, SDL_Palette *palette, int bpp,
+                   int ppa, int blendargs)
+{
+    Uint8 sR, sG, sB, sA, cR, cG, cB, cA;
+    Uint32 pixel;
+    Sint32 tmp;
+    size_t offsetR, offsetG, offsetB;
+    int i;
+
+    SET_OFFSETS_24(offsetR, offsetG, offsetB, fmt);
+    for (i = 0; i < width; i++, pixels += bpp) {
+        if (bpp == 1) {
+            GET_PIXELVALS_1(sR, sG, sB, sA, pixels, palette);
+            PG_GetRGBA(row[i], fmt, palette, &cR, &cG, &cB, &cA);
+        }
+        else {
+            GET_PIXEL(pixel, bpp, pixels);
+            GET_PIXELVALS(sR, sG, sB, sA, pixel, fmt, palette, ppa);
+            GET_PIXELVALS(cR, cG, cB, cA, row[i], fmt, palette, ppa);
+        }
+        switch (blendargs) {
+            case PYGAME_BLEND_ADD:
+                BLEND_ADD(tmp, cR, cG, cB, cA, sR, sG, sB, sA);
+                break;
+            case PYGAME_BLEND_SUB:
+                BLEND_SUB(tmp, cR, cG, cB, cA, sR, sG, sB, sA);
+                break;
+            case PYGAME_BLEND_MULT:
+                BLEND_MULT(cR, cG, cB, cA, sR, sG, sB, sA);
+                break;
+            case PYGAME_BLEND_MIN:
+                BLEND_MIN(cR, cG, cB, cA, sR, sG, sB, sA);
+                break;
+            case PYGAME_BLEND_MAX:
+                BLEND_MAX(cR, cG, cB, cA, sR, sG, sB, sA);
+                break;
+            case PYGAME_BLEND_RGBA_ADD:
+                BLEND_RGBA_ADD(tmp, cR, cG, cB, cA, sR, sG, sB, sA);
+                break;
+            case PYGAME_BLEND_RGBA_SUB:
+                BLEND_RGBA_SUB(tmp, cR, cG, cB, cA, sR, sG, sB, sA);
+                break;
+            case PYGAME_BLEND_RGBA_MULT:
+                BLEND_RGBA_MULT(cR, cG, cB, cA, sR, sG, sB, sA);
+                break;
+            case PYGAME_BLEND_RGBA_MIN:
+                BLEND_RGBA_MIN(cR, cG, cB, cA, sR, sG, sB, sA);
+                break;
+            case PYGAME_BLEND_RGBA_MAX:
+                BLEND_RGBA_MAX(cR, cG, cB, cA, sR, sG, sB, sA);
+                break;
+        }
+        switch (bpp) {
+            case 1:
+                *pixels = PG_MapRGBA(fmt, palette, sR, sG, sB, sA);
+                break;
+            case 3:
+                pixels[offsetR] = sR;
+                pixels[offsetG] = sG;
+                pixels[offsetB] = sB;
+                break;
+            default:
+                CREATE_PIXEL(pixels, sR, sG, sB, sA, bpp, fmt);
+                break;
+        }
+    }
+}
+
+/* Stores a row of gradient colors in width pixels of bpp bytes */
+static void
+gradient_store_row(Uint8 *pixels, const Uint32 *row, int width, int bpp)
+{
+    int i;
+
+    switch (bpp) {
+        case 1:
+            for (i = 0; i < width; i++) {
+                pixels[i] = (Uint8)row[i];
+            }
+            break;
+        case 2:
+            for (i = 0; i < width; i++) {
+                ((Uint16 *)pixels)[i] = (Uint16)row[i];
+            }
+            break;
+        case 3:
+            for (i = 0; i < width; i++, pixels += 3) {
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+                pixels[0] = (Uint8)row[i];
+                pixels[1] = (Uint8)(row[i] >> 8);
+                pixels[2] = (Uint8)(row[i] >> 16);
+#else
+                pixels[2] = (Uint8)row[i];
+                pixels[1] = (Uint8)(row[i] >> 8);
+                pixels[0] = (Uint8)(row[i] >> 16);
+#endif
+            }
+            break;
+        default:
+            memcpy(pixels, row, width * sizeof(Uint32));
+            break;
+    }
+}
+
+/*
+ * Fills area, which must lie inside the clip rect of surface, with the
+ * part of a gradient spanning rect. lut holds the PG_GRADIENT_LUT_SIZE
+ * colors of the gradient mapped to the surface, from its start to its end.
+ * The colors of a row are computed into a buffer of one row, which is then
+ * stored or blended with blendargs into the surface, so no intermediate
+ * surface is needed.
+ */
+int
+surface_fill_gradient(SDL_Surface *surface, SDL_Rect *rect, SDL_Rect *area,
+                      int kind, double angle, const Uint32 *lut,
+                      int blendargs)
+{
+    PG_PixelFormat *fmt;
+    SDL_Palette *palette;
+    SDL_BlendMode mode;
+    GradientBlendRowFunc blend_row = NULL;
+    Uint32 simd_lut[PG_GRADIENT_LUT_SIZE];
+    Uint32 *row = NULL;
+    Uint8 *pixels;
+    int bpp = PG_SURF_BytesPerPixel(surface);
+    int x, y, ppa;
+    int locked = 0;
+    double scale = PG_GRADIENT_LUT_SIZE - 1;
+    double ca = cos(angle * M_PI / 180.0), sa = -sin(angle * M_PI / 180.0);
+    double pmin = 0.0, pmax = 0.0, corner, t;
+
+    switch (blendargs) {
+        case 0:
+        case PYGAME_BLEND_ADD:
+        case PYGAME_BLEND_SUB:
+        case PYGAME_BLEND_MULT:
+        case PYGAME_BLEND_MIN:
+        case PYGAME_BLEND_MAX:
+        case PYGAME_BLEND_RGBA_ADD:
+        case PYGAME_BLEND_RGBA_SUB:
+        case PYGAME_BLEND_RGBA_MULT:
+        case PYGAME_BLEND_RGBA_MIN:
+        case PYGAME_BLEND_RGBA_MAX:
+            break;
+        default:
+            SDL_SetError("invalid blend flag for this operation");
+            return -1;
+    }
+    if (!PG_GetSurfaceDetails(surface, &fmt, &palette)) {
+        return -1;
+    }
+    SDL_GetSurfaceBlendMode(surface, &mode);
+    ppa = (fmt->Amask && mode != SDL_BLENDMODE_NONE);
+
+    if (blendargs != 0) {
+        blend_row = gradient_blend_row_simd(surface, blendargs);
+    }
+    if (blend_row) {
+        /* Like the SIMD fillers, leave the alpha of the pixels alone */
+        for (x = 0; x < PG_GRADIENT_LUT_SIZE; x++) {
+            simd_lut[x] = lut[x];
+            switch (blendargs) {
+                case PYGAME_BLEND_ADD:
+                case PYGAME_BLEND_SUB:
+                case PYGAME_BLEND_MAX:
+                    simd_lut[x] &= ~fmt->Amask;
+                    break;
+                case PYGAME_BLEND_MULT:
+                case PYGAME_BLEND_MIN:
+                    simd_lut[x] |= fmt->Amask;
+                    break;
+            }
+        }
+        lut = simd_lut;
+    }
+    if (bpp != 4 || blendargs != 0) {
+        if (!(row = (Uint32 *)malloc(area->w * sizeof(Uint32)))) {
+            SDL_OutOfMemory();
+            return -1;
+        }
+    }
+
+    /* The linear gradient goes from the corner of rect furthest behind to
+     * the one furthest ahead in the direction of angle */
+    if (kind == PG_GRADIENT_LINEAR) {
+        corner = rect->w * ca;
+        pmin = MIN(pmin, corner);
+        pmax = MAX(pmax, corner);
+        corner = rect->h * sa;
+        pmin = MIN(pmin, corner);
+        pmax = MAX(pmax, corner);
+        corner = rect->w * ca + rect->h * sa;
+        pmin = MIN(pmin, corner);
+        pmax = MAX(pmax, corner);
+        scale /= pmax - pmin;
+    }
+
+    /* Lock the surface, if needed */
+    if (SDL_MUSTLOCK(surface)) {
+        if (!PG_LockSurface(surface)) {
+            free(row);
+            return -1;
+        }
+        locked = 1;
+    }
+
+    /* Positions are taken at the pixel centers, relative to rect */
+    x = area->x - rect->x;
+    for (y = area->y - rect->y; y < area->y - rect->y + area->h; y++) {
+        pixels = (Uint8 *)surface->pixels +
+                 (size_t)(y + rect->y) * surface->pitch +
+                 (size_t)area->x * bpp;
+        Uint32 *dst = row ? row : (Uint32 *)pixels;
+
+        switch (kind) {
+            case PG_GRADIENT_LINEAR:
+                t = ((x + 0.5) * ca + (y + 0.5) * sa - pmin) * scale;
+                gradient_row_linear(dst, area->w, lut, (float)t,
+                                    (float)(ca * scale));
+                break;
+            case PG_GRADIENT_RADIAL:
+                t = ((y + 0.5) * 2.0 / rect->h - 1.0) * scale;
+                gradient_row_radial(
+                    dst, area->w, lut,
+                    (float)(((x + 0.5) * 2.0 / rect->w - 1.0) * scale),
+                    (float)(2.0 / rect->w * scale), (float)(t * t));
+                break;
+            default:
+                gradient_row_conic(dst, area->w, lut, x + 0.5 - rect->w / 2.0,
+                                   y + 0.5 - rect->h / 2.0,
+                                   angle * M_PI / 180.0);
+                break;
+        }
+
+        if (blend_row) {
+            blend_row((Uint32 *)pixels, row, area->w);
+        }
+        else if (blendargs != 0) {
+            gradient_blend_row(pixels, row, area->w, fmt, palette, bpp, ppa,
+                               blendargs);
+        }
+        else if (row) {
+            gradient_store_row(pixels, row, area->w, bpp);
+        }
+    }
+
+    if (locked) {
+        SDL_UnlockSurface(surface);
+    }
+    free(row);
+    return 0;
+}
@@ -38,14 +38,22 @@ static int
 pgSurface_LockBy(pgSurfaceObject *, PyObject *);
 static int
 pgSurface_UnlockBy(pgSurfaceObject *, PyObject *);
+static int
+pgSurface_Unshare(pgSurfaceObject *);
+static int
+_pg_lock_by(pgSurfaceObject *, PyObject *);
 
-static void
+/* Subsurfaces only read their parent through this lock, writers unshare
+ * the pixels themselves first */
+static int
 pgSurface_Prep(pgSurfaceObject *surfobj)
 {
     struct pgSubSurface_Data *data = ((pgSurfaceObject *)surfobj)->subsurface;
     if (data != NULL) {
-        pgSurface_LockBy((pgSurfaceObject *)data->owner, (PyObject *)surfobj);
+        return _pg_lock_by((pgSurfaceObject *)data->owner,
+                           (PyObject *)surfobj);
     }
+    return 1;
 }
 
 static void
@@ -64,14 +72,107 @@ pgSurface_Lock(pgSurfaceObject *surfobj)
     return pgSurface_LockBy(surfobj, (PyObject *)surfobj);
 }
 
+static int
+pgSurface_LockRead(pgSurfaceObject *surfobj)
+{
+    return _pg_lock_by(surfobj, (PyObject *)surfobj);
+}
+
 static int
 pgSurface_Unlock(pgSurfaceObject *surfobj)
 {
     return pgSurface_UnlockBy(surfobj, (PyObject *)surfobj);
 }
 
+/* Gives a copy-on-write copy its own duplicate of the shared pixels. The
+ * SDL surface keeps its address, only its pixels pointer changes. */
+static int
+_pg_cow_detach(pgSurfaceObject *surfobj)
+{
+    struct pgCowData *cow = surfobj->cow;
+    SDL_Surface *surf = surfobj->surf;
+    size_t size = (size_t)surf->pitch * surf->h;
+    void *pixels = PyMem_Malloc(size ? size : 1);
+
+    if (pixels == NULL) {
+        PyErr_NoMemory();
+        return 0;
+    }
+    memcpy(pixels, surf->pixels, size);
+    surf->pixels = pixels;
+    cow->pixels = pixels;
+    SDL_FreeSurface(cow->backing);
+    cow->backing = NULL;
+    return 1;
+}
+
+static int
+pgSurface_Unshare(pgSurfaceObject *surfobj)
+{
+    struct pgCowData *cow;
+    PyObject *copies, *ref;
+    pgSurfaceObject *copy;
+    Py_ssize_t i;
+    int shared;
+
+    /* Every writer unshares first, so cached span runs are dropped here.
+     * A subsurface writes the pixels of the Surface it is part of. */
+    while (1) {
+        if (surfobj->spans != NULL) {
+            surfobj->spans->valid = 0;
+        }
+        if (surfobj->subsurface == NULL) {
+            break;
+        }
+        surfobj = (pgSurfaceObject *)surfobj->subsurface->owner;
+    }
+    cow = surfobj->cow;
+    if (cow == NULL) {
+        return 1;
+    }
+    if (cow->backing != NULL && !_pg_cow_detach(surfobj)) {
+        return 0;
+    }
+
+    copies = cow->copies;
+    if (copies == NULL) {
+        return 1;
+    }
+    for (i = 0; i < PyList_GET_SIZE(copies); ++i) {
+        switch (PyWeakref_GetRef(PyList_GET_ITEM(copies, i), &ref)) {
+            case -1:
+                return 0;
+            case 0:
+                continue;
+        }
+        copy = (pgSurfaceObject *)ref;
+        /* Copies already detached are left alone */
+        shared = copy->cow != NULL && copy->cow->backing != NULL &&
+                 copy->cow->backing == surfobj->surf;
+        if (shared && !_pg_cow_detach(copy)) {
+            Py_DECREF(ref);
+            return 0;
+        }
+        Py_DECREF(ref);
+    }
+    cow->copies = NULL;
+    Py_DECREF(copies);
+    return 1;
+}
+
 static int
 pgSurface_LockBy(pgSurfaceObject *surfobj, PyObject *lockobj)
+{
+    /* The pixels may be written while locked */
+    if (!pgSurface_Unshare(surfobj)) {
+        return 0;
+    }
+    return _pg_lock_by(surfobj, lockobj);
+}
+
+/* Locks surfobj without unsharing its pixels, for reading them */
+static int
+_pg_lock_by(pgSurfaceObject *surfobj, PyObject *lockobj)
 {
     PyObject *ref;
     pgSurfaceObject *surf = (pgSurfaceObject *)surfobj;
@@ -96,8 +197,11 @@ pgSurface_LockBy(pgSurfaceObject *surfobj, PyObject *lockobj)
     }
     Py_DECREF(ref);
 
-    if (surf->subsurface != NULL) {
-        pgSurface_Prep(surfobj);
+    if (surf->subsurface != NULL && !pgSurface_Prep(surfobj)) {
+        /* Drop the entry added above, the lock was not taken */
+        PySequence_DelItem(surf->locklist,
+                           PyList_GET_SIZE(surf->locklist) - 1);
+        return 0;
     }
     if (!PG_LockSurface(surf->surf)) {
         PyErr_SetString(PyExc_RuntimeError, "error locking surface");
@@ -181,6 +285,11 @@ pgSurface_UnlockBy(pgSurfaceObject *surfobj, PyObject *lockobj)
         return noerror;
     }
 
+    /* Whatever held the lock may have written the pixels until now */
+    if (surf->spans != NULL) {
+        surf->spans->valid = 0;
+    }
+
     /* Release all found locks. */
     while (found > 0) {
         if (surf->surf != NULL) {
@@ -228,6 +337,8 @@ MODINIT_DEFINE(surflock)
     c_api[3] = pgSurface_Unlock;
     c_api[4] = pgSurface_LockBy;
     c_api[5] = pgSurface_UnlockBy;
+    c_api[6] = pgSurface_Unshare;
+    c_api[7] = pgSurface_LockRead;
     apiobj = encapsulate_api(c_api, "surflock");
     if (PyModule_AddObject(module, PYGAMEAPI_LOCAL_ENTRY, apiobj)) {
         Py_XDECREF(apiobj);
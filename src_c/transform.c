@@ -34,6 +34,10 @@
 #include <string.h>
 #include <limits.h>
 
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
 #include "simd_shared.h"
 #include "simd_transform.h"
 #include "scale.h"
@@ -50,10 +54,18 @@ struct _module_state {
 
 #define GETSTATE(m) ((struct _module_state *)PyModule_GetState(m))
 
-void
-scale2x(SDL_Surface *src, SDL_Surface *dst);
+int
+scale2x(SDL_Surface *src, SDL_Surface *dst, int simd, pg_rowrunner run_rows);
+int
+scale3x(SDL_Surface *src, SDL_Surface *dst, int simd, pg_rowrunner run_rows);
+int
+scale4x(SDL_Surface *src, SDL_Surface *dst, int simd, pg_rowrunner run_rows);
+int
+xbr2x(SDL_Surface *src, SDL_Surface *dst, const int *shifts,
+      pg_rowrunner run_rows);
 extern SDL_Surface *
-rotozoomSurface(SDL_Surface *src, double angle, double zoom, int smooth);
+rotozoomSurface(SDL_Surface *src, double angle, double zoom, int smooth,
+                pg_rowrunner run_rows);
 
 static int
 _get_factor(PyObject *factorobj, float *x, float *y)
@@ -129,7 +141,7 @@ newsurf_fromsurf(SDL_Surface *surf, int width, int height)
             PyExc_ValueError, "unsupported Surface bit depth for transform"));
     }
 
-    newsurf = PG_CreateSurface(width, height, PG_SURF_FORMATENUM(surf));
+    newsurf = pgSurface_PoolCreate(width, height, PG_SURF_FORMATENUM(surf));
     if (!newsurf) {
         return (SDL_Surface *)(RAISE(pgExc_SDLError, SDL_GetError()));
     }
@@ -439,6 +451,16 @@ rotate(SDL_Surface *src, SDL_Surface *dst, Uint32 bgcolor, double sangle,
     }
 }
 
+/* filters of transform.scale */
+#define PG_SCALE_NEAREST 0
+#define PG_SCALE_BILINEAR 1
+#define PG_SCALE_BICUBIC 2
+#define PG_SCALE_LANCZOS3 3
+
+static SDL_Surface *
+resample_to(pgSurfaceObject *srcobj, pgSurfaceObject *dstobj, int width,
+            int height, int filter);
+
 static SDL_Surface *
 scale_to(pgSurfaceObject *srcobj, pgSurfaceObject *dstobj, int width,
          int height)
@@ -501,7 +523,7 @@ scale_to(pgSurfaceObject *srcobj, pgSurfaceObject *dstobj, int width,
      * surfaces with "0" as the width or height, and for those nothing should
      * happen here. */
     if ((width && height) && (src->w && src->h)) {
-        pgSurface_Lock(srcobj);
+        pgSurface_LockRead(srcobj);
         Py_BEGIN_ALLOW_THREADS;
 
         stretch_result_num = PG_SoftStretchNearest(src, NULL, modsurf, NULL);
@@ -521,6 +543,30 @@ scale_to(pgSurfaceObject *srcobj, pgSurfaceObject *dstobj, int width,
     return retsurf;
 }
 
+/* Looks up the filter named in transform.scale, returns -1 with a
+ * ValueError set for unknown names */
+static int
+_get_scale_filter(const char *name)
+{
+    if (!strcmp(name, "nearest")) {
+        return PG_SCALE_NEAREST;
+    }
+    if (!strcmp(name, "bilinear")) {
+        return PG_SCALE_BILINEAR;
+    }
+    if (!strcmp(name, "bicubic")) {
+        return PG_SCALE_BICUBIC;
+    }
+    if (!strcmp(name, "lanczos3")) {
+        return PG_SCALE_LANCZOS3;
+    }
+    PyErr_Format(PyExc_ValueError,
+                 "filter must be 'nearest', 'bilinear', 'bicubic' or "
+                 "'lanczos3', not '%s'",
+                 name);
+    return -1;
+}
+
 static PyObject *
 surf_scale(PyObject *self, PyObject *args, PyObject *kwargs)
 {
@@ -529,11 +575,23 @@ surf_scale(PyObject *self, PyObject *args, PyObject *kwargs)
     PyObject *size;
     SDL_Surface *newsurf, *surf;
     int width, height;
-    static char *keywords[] = {"surface", "size", "dest_surface", NULL};
+    const char *filtername = "nearest";
+    int filter;
+    static char *keywords[] = {"surface", "size", "dest_surface", "filter",
+                               NULL};
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!O|O!", keywords,
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!O|O!s", keywords,
                                      &pgSurface_Type, &surfobj, &size,
-                                     &pgSurface_Type, &surfobj2)) {
+                                     &pgSurface_Type, &surfobj2,
+                                     &filtername)) {
+        return NULL;
+    }
+
+    if ((filter = _get_scale_filter(filtername)) < 0) {
+        return NULL;
+    }
+
+    if (surfobj2 && !pgSurface_Unshare(surfobj2)) {
         return NULL;
     }
 
@@ -544,12 +602,18 @@ surf_scale(PyObject *self, PyObject *args, PyObject *kwargs)
         return RAISE(PyExc_TypeError, "size must be two numbers");
     }
 
-    newsurf = scale_to(surfobj, surfobj2, width, height);
+    if (filter == PG_SCALE_NEAREST) {
+        newsurf = scale_to(surfobj, surfobj2, width, height);
+    }
+    else {
+        newsurf = resample_to(surfobj, surfobj2, width, height, filter);
+    }
     if (!newsurf) {
         return NULL;
     }
 
     if (surfobj2) {
+        pgSurface_AddDirtyRect(surfobj2, NULL);
         Py_INCREF(surfobj2);
         return (PyObject *)surfobj2;
     }
@@ -565,12 +629,25 @@ surf_scale_by(PyObject *self, PyObject *args, PyObject *kwargs)
     pgSurfaceObject *surfobj2 = NULL;
     PyObject *factorobj = NULL;
     float scalex, scaley;
+    int width, height;
     SDL_Surface *surf, *newsurf;
-    static char *keywords[] = {"surface", "factor", "dest_surface", NULL};
+    const char *filtername = "nearest";
+    int filter;
+    static char *keywords[] = {"surface", "factor", "dest_surface", "filter",
+                               NULL};
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!O|O!", keywords,
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!O|O!s", keywords,
                                      &pgSurface_Type, &surfobj, &factorobj,
-                                     &pgSurface_Type, &surfobj2)) {
+                                     &pgSurface_Type, &surfobj2,
+                                     &filtername)) {
+        return NULL;
+    }
+
+    if ((filter = _get_scale_filter(filtername)) < 0) {
+        return NULL;
+    }
+
+    if (surfobj2 && !pgSurface_Unshare(surfobj2)) {
         return NULL;
     }
 
@@ -581,13 +658,20 @@ surf_scale_by(PyObject *self, PyObject *args, PyObject *kwargs)
     surf = pgSurface_AsSurface(surfobj);
     SURF_INIT_CHECK(surf)
 
-    newsurf = scale_to(surfobj, surfobj2, (int)(surf->w * scalex),
-                       (int)(surf->h * scaley));
+    width = (int)(surf->w * scalex);
+    height = (int)(surf->h * scaley);
+    if (filter == PG_SCALE_NEAREST) {
+        newsurf = scale_to(surfobj, surfobj2, width, height);
+    }
+    else {
+        newsurf = resample_to(surfobj, surfobj2, width, height, filter);
+    }
     if (!newsurf) {
         return NULL;
     }
 
     if (surfobj2) {
+        pgSurface_AddDirtyRect(surfobj2, NULL);
         Py_INCREF(surfobj2);
         return (PyObject *)surfobj2;
     }
@@ -596,12 +680,36 @@ surf_scale_by(PyObject *self, PyObject *args, PyObject *kwargs)
     }
 }
 
+/* Lets rotozoomSurface() and the pixel art scalers run their rows in
+ * bands on the worker pool */
+static void
+_pool_run_rows(int rows, Py_ssize_t work, pg_rowbandproc func, void *data)
+{
+    int bands = pg_ParallelBandCount(rows, work);
+
+    if (bands > 1) {
+        pg_ParallelForRows(rows, bands, func, data);
+    }
+    else {
+        func(data, 0, rows);
+    }
+}
+
+/* The pixel art scalers of scale2x.c */
+#define PG_PIXELART_SCALE2X 2
+#define PG_PIXELART_SCALE3X 3
+#define PG_PIXELART_SCALE4X 4
+#define PG_PIXELART_XBR2X 5
+
 static PyObject *
-surf_scale2x(PyObject *self, PyObject *args, PyObject *kwargs)
+scale_pixelart(PyObject *args, PyObject *kwargs, int scaler)
 {
     PyObject *surfobj, *surfobj2 = NULL;
     SDL_Surface *surf;
     SDL_Surface *newsurf;
+    PG_PixelFormat *fmt;
+    int factor = scaler == PG_PIXELART_XBR2X ? 2 : scaler;
+    int shifts[3], bpp, simd = 0, okay = 0;
     static char *keywords[] = {"surface", "dest_surface", NULL};
 
     if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!|O!", keywords,
@@ -610,14 +718,43 @@ surf_scale2x(PyObject *self, PyObject *args, PyObject *kwargs)
         return NULL;
     }
 
+    if (surfobj2 && !pgSurface_Unshare((pgSurfaceObject *)surfobj2)) {
+        return NULL;
+    }
+
     surf = pgSurface_AsSurface(surfobj);
     SURF_INIT_CHECK(surf)
 
+    bpp = PG_SURF_BytesPerPixel(surf);
+    if (scaler == PG_PIXELART_XBR2X) {
+        if (bpp < 3 || bpp > 4) {
+            return RAISE(PyExc_ValueError,
+                         "Only 24-bit or 32-bit surfaces can be scaled with "
+                         "xBR");
+        }
+        fmt = PG_GetSurfaceFormat(surf);
+        if (!fmt) {
+            return RAISE(pgExc_SDLError, SDL_GetError());
+        }
+        /* the bit positions in the pixel values read by scale2x.c, 24 bit
+         * pixels are read big endian from their bytes */
+        shifts[0] = fmt->Rshift;
+        shifts[1] = fmt->Gshift;
+        shifts[2] = fmt->Bshift;
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+        if (bpp == 3) {
+            shifts[0] = 16 - shifts[0];
+            shifts[1] = 16 - shifts[1];
+            shifts[2] = 16 - shifts[2];
+        }
+#endif
+    }
+
     /* if the second surface is not there, then make a new one. */
 
     if (!surfobj2) {
-        int width = surf->w * 2;
-        int height = surf->h * 2;
+        int width = surf->w * factor;
+        int height = surf->h * factor;
 
         newsurf = newsurf_fromsurf(surf, width, height);
 
@@ -629,9 +766,10 @@ surf_scale2x(PyObject *self, PyObject *args, PyObject *kwargs)
         newsurf = pgSurface_AsSurface(surfobj2);
     }
 
-    /* check to see if the size is twice as big. */
-    if (newsurf->w != (surf->w * 2) || newsurf->h != (surf->h * 2)) {
-        return RAISE(PyExc_ValueError, "Destination surface not 2x bigger.");
+    /* check to see if the size is factor times as big. */
+    if (newsurf->w != (surf->w * factor) || newsurf->h != (surf->h * factor)) {
+        return PyErr_Format(PyExc_ValueError,
+                            "Destination surface not %dx bigger.", factor);
     }
 
     /* check to see if the format of the surface is the same. */
@@ -640,17 +778,47 @@ surf_scale2x(PyObject *self, PyObject *args, PyObject *kwargs)
                      "Source and destination surfaces need the same format.");
     }
 
+#if !defined(__EMSCRIPTEN__)
+#if defined(__SSE2__) || defined(PG_ENABLE_ARM_NEON)
+    simd = pg_HasSSE_NEON();
+#endif /* defined(__SSE2__) || defined(PG_ENABLE_ARM_NEON) */
+    if (pg_has_avx2()) {
+        simd = 2;
+    }
+#endif /* !defined(__EMSCRIPTEN__) */
+
     SDL_LockSurface(newsurf);
     SDL_LockSurface(surf);
 
     Py_BEGIN_ALLOW_THREADS;
-    scale2x(surf, newsurf);
+    switch (scaler) {
+        case PG_PIXELART_SCALE2X:
+            okay = scale2x(surf, newsurf, simd, _pool_run_rows);
+            break;
+        case PG_PIXELART_SCALE3X:
+            okay = scale3x(surf, newsurf, simd, _pool_run_rows);
+            break;
+        case PG_PIXELART_SCALE4X:
+            okay = scale4x(surf, newsurf, simd, _pool_run_rows);
+            break;
+        default:
+            okay = xbr2x(surf, newsurf, shifts, _pool_run_rows);
+            break;
+    }
     Py_END_ALLOW_THREADS;
 
     SDL_UnlockSurface(surf);
     SDL_UnlockSurface(newsurf);
 
+    if (!okay) {
+        if (!surfobj2) {
+            SDL_FreeSurface(newsurf);
+        }
+        return PyErr_NoMemory();
+    }
+
     if (surfobj2) {
+        pgSurface_AddDirtyRect((pgSurfaceObject *)surfobj2, NULL);
         Py_INCREF(surfobj2);
         return surfobj2;
     }
@@ -659,6 +827,30 @@ surf_scale2x(PyObject *self, PyObject *args, PyObject *kwargs)
     }
 }
 
+static PyObject *
+surf_scale2x(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+    return scale_pixelart(args, kwargs, PG_PIXELART_SCALE2X);
+}
+
+static PyObject *
+surf_scale3x(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+    return scale_pixelart(args, kwargs, PG_PIXELART_SCALE3X);
+}
+
+static PyObject *
+surf_scale4x(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+    return scale_pixelart(args, kwargs, PG_PIXELART_SCALE4X);
+}
+
+static PyObject *
+surf_xbr2x(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+    return scale_pixelart(args, kwargs, PG_PIXELART_XBR2X);
+}
+
 static PyObject *
 surf_rotate(PyObject *self, PyObject *args, PyObject *kwargs)
 {
@@ -690,7 +882,7 @@ surf_rotate(PyObject *self, PyObject *args, PyObject *kwargs)
     }
 
     if (!(fmod((double)angle, (double)90.0f))) {
-        pgSurface_Lock(surfobj);
+        pgSurface_LockRead(surfobj);
 
         /* The function releases GIL internally, don't release here */
         newsurf = rotate90(surf, (int)angle);
@@ -758,7 +950,7 @@ surf_rotate(PyObject *self, PyObject *args, PyObject *kwargs)
     }
 
     SDL_LockSurface(newsurf);
-    pgSurface_Lock(surfobj);
+    pgSurface_LockRead(surfobj);
 
     Py_BEGIN_ALLOW_THREADS;
     rotate(surf, newsurf, bgcolor, sangle, cangle);
@@ -798,7 +990,7 @@ surf_flip(PyObject *self, PyObject *args, PyObject *kwargs)
     dstpitch = newsurf->pitch;
 
     SDL_LockSurface(newsurf);
-    pgSurface_Lock(surfobj);
+    pgSurface_LockRead(surfobj);
 
     srcpix = (Uint8 *)surf->pixels;
     dstpix = (Uint8 *)newsurf->pixels;
@@ -953,28 +1145,37 @@ surf_rotozoom(PyObject *self, PyObject *args, PyObject *kwargs)
 
     if (PG_SURF_BitsPerPixel(surf) == 32) {
         surf32 = surf;
-        pgSurface_Lock(surfobj);
+        if (!pgSurface_LockRead(surfobj)) {
+            return NULL;
+        }
     }
     else {
+        /* The pool needs the GIL */
+        surf32 = pgSurface_PoolCreate(surf->w, surf->h,
+                                      SDL_PIXELFORMAT_ABGR8888);
+        if (!surf32) {
+            return RAISE(pgExc_SDLError, SDL_GetError());
+        }
         Py_BEGIN_ALLOW_THREADS;
-        surf32 = PG_CreateSurface(surf->w, surf->h, SDL_PIXELFORMAT_ABGR8888);
         SDL_BlitSurface(surf, NULL, surf32, NULL);
         Py_END_ALLOW_THREADS;
     }
 
     Py_BEGIN_ALLOW_THREADS;
-    newsurf = rotozoomSurface(surf32, angle, scale, 1);
+    newsurf = rotozoomSurface(surf32, angle, scale, 1, _pool_run_rows);
     Py_END_ALLOW_THREADS;
     if (newsurf == NULL) {
         PyErr_SetString(pgExc_SDLError, SDL_GetError());
-        return NULL;
     }
 
     if (surf32 == surf) {
         pgSurface_Unlock(surfobj);
     }
     else {
-        SDL_FreeSurface(surf32);
+        pgSurface_PoolRelease(surf32);
+    }
+    if (newsurf == NULL) {
+        return NULL;
     }
     return (PyObject *)pgSurface_New(newsurf);
 }
@@ -1307,6 +1508,14 @@ smoothscale_init(struct _module_state *st)
     }
 
 #if !defined(__EMSCRIPTEN__)
+    if (pg_has_avx2()) {
+        st->filter_type = "AVX2";
+        st->filter_shrink_X = filter_shrink_X_AVX2;
+        st->filter_shrink_Y = filter_shrink_Y_AVX2;
+        st->filter_expand_X = filter_expand_X_AVX2;
+        st->filter_expand_Y = filter_expand_Y_AVX2;
+        return;
+    }
 #if PG_ENABLE_SSE_NEON
     if (SDL_HasSSE2()) {
         st->filter_type = "SSE2";
@@ -1318,10 +1527,17 @@ smoothscale_init(struct _module_state *st)
     }
     if (SDL_HasNEON()) {
         st->filter_type = "NEON";
+#if PG_ENABLE_NATIVE_NEON
+        st->filter_shrink_X = filter_shrink_X_NEON;
+        st->filter_shrink_Y = filter_shrink_Y_NEON;
+        st->filter_expand_X = filter_expand_X_NEON;
+        st->filter_expand_Y = filter_expand_Y_NEON;
+#else
         st->filter_shrink_X = filter_shrink_X_SSE2;
         st->filter_shrink_Y = filter_shrink_Y_SSE2;
         st->filter_expand_X = filter_expand_X_SSE2;
         st->filter_expand_Y = filter_expand_Y_SSE2;
+#endif /* PG_ENABLE_NATIVE_NEON */
         return;
     }
 #endif /* PG_ENABLE_SSE_NEON */
@@ -1393,6 +1609,58 @@ convert_32_24(Uint8 *srcpix, int srcpitch, Uint8 *dstpix, int dstpitch,
     }
 }
 
+/* One pass of scalesmooth. The X filters work on each row and the Y filters
+ * on each column independently, so the pass is split in bands of rows or
+ * columns that can be run on separate threads. */
+typedef struct {
+    SMOOTHSCALE_FILTER_P filter;
+    Uint8 *srcpix;
+    Uint8 *dstpix;
+    int srcpitch;
+    int dstpitch;
+    int srclength;
+    int dstlength;
+    int columns;
+} pgSmoothScalePass;
+
+static void
+_scalesmooth_band(void *data, int start, int end)
+{
+    pgSmoothScalePass *pass = (pgSmoothScalePass *)data;
+    size_t srcoffset, dstoffset;
+
+    if (pass->columns) {
+        srcoffset = dstoffset = (size_t)start * 4;
+    }
+    else {
+        srcoffset = (size_t)start * pass->srcpitch;
+        dstoffset = (size_t)start * pass->dstpitch;
+    }
+    pass->filter(pass->srcpix + srcoffset, pass->dstpix + dstoffset,
+                 end - start, pass->srcpitch, pass->dstpitch, pass->srclength,
+                 pass->dstlength);
+}
+
+/* Runs filter over count rows, or columns for the Y filters, scaling them
+ * from srclength to dstlength pixels. */
+static void
+scalesmooth_pass(SMOOTHSCALE_FILTER_P filter, Uint8 *srcpix, Uint8 *dstpix,
+                 int count, int srcpitch, int dstpitch, int srclength,
+                 int dstlength, int columns)
+{
+    pgSmoothScalePass pass = {filter,   srcpix,    dstpix,    srcpitch,
+                              dstpitch, srclength, dstlength, columns};
+    int bands = pg_ParallelBandCount(
+        count, (Py_ssize_t)count * MAX(srclength, dstlength));
+
+    if (bands > 1) {
+        pg_ParallelForRows(count, bands, _scalesmooth_band, &pass);
+    }
+    else {
+        _scalesmooth_band(&pass, 0, count);
+    }
+}
+
 static void
 scalesmooth(SDL_Surface *src, SDL_Surface *dst, struct _module_state *st)
 {
@@ -1451,46 +1719,46 @@ scalesmooth(SDL_Surface *src, SDL_Surface *dst, struct _module_state *st)
     if (dstwidth < srcwidth) /* shrink */
     {
         if (srcheight != dstheight) {
-            st->filter_shrink_X(srcpix, temppix, srcheight, srcpitch,
-                                temppitch, srcwidth, dstwidth);
+            scalesmooth_pass(st->filter_shrink_X, srcpix, temppix, srcheight,
+                             srcpitch, temppitch, srcwidth, dstwidth, 0);
         }
         else {
-            st->filter_shrink_X(srcpix, dstpix, srcheight, srcpitch, dstpitch,
-                                srcwidth, dstwidth);
+            scalesmooth_pass(st->filter_shrink_X, srcpix, dstpix, srcheight,
+                             srcpitch, dstpitch, srcwidth, dstwidth, 0);
         }
     }
     else if (dstwidth > srcwidth) /* expand */
     {
         if (srcheight != dstheight) {
-            st->filter_expand_X(srcpix, temppix, srcheight, srcpitch,
-                                temppitch, srcwidth, dstwidth);
+            scalesmooth_pass(st->filter_expand_X, srcpix, temppix, srcheight,
+                             srcpitch, temppitch, srcwidth, dstwidth, 0);
         }
         else {
-            st->filter_expand_X(srcpix, dstpix, srcheight, srcpitch, dstpitch,
-                                srcwidth, dstwidth);
+            scalesmooth_pass(st->filter_expand_X, srcpix, dstpix, srcheight,
+                             srcpitch, dstpitch, srcwidth, dstwidth, 0);
         }
     }
     /* Now do the Y scale */
     if (dstheight < srcheight) /* shrink */
     {
         if (srcwidth != dstwidth) {
-            st->filter_shrink_Y(temppix, dstpix, tempwidth, temppitch,
-                                dstpitch, srcheight, dstheight);
+            scalesmooth_pass(st->filter_shrink_Y, temppix, dstpix, tempwidth,
+                             temppitch, dstpitch, srcheight, dstheight, 1);
         }
         else {
-            st->filter_shrink_Y(srcpix, dstpix, srcwidth, srcpitch, dstpitch,
-                                srcheight, dstheight);
+            scalesmooth_pass(st->filter_shrink_Y, srcpix, dstpix, srcwidth,
+                             srcpitch, dstpitch, srcheight, dstheight, 1);
         }
     }
     else if (dstheight > srcheight) /* expand */
     {
         if (srcwidth != dstwidth) {
-            st->filter_expand_Y(temppix, dstpix, tempwidth, temppitch,
-                                dstpitch, srcheight, dstheight);
+            scalesmooth_pass(st->filter_expand_Y, temppix, dstpix, tempwidth,
+                             temppitch, dstpitch, srcheight, dstheight, 1);
         }
         else {
-            st->filter_expand_Y(srcpix, dstpix, srcwidth, srcpitch, dstpitch,
-                                srcheight, dstheight);
+            scalesmooth_pass(st->filter_expand_Y, srcpix, dstpix, srcwidth,
+                             srcpitch, dstpitch, srcheight, dstheight, 1);
         }
     }
 
@@ -1509,1590 +1777,1595 @@ scalesmooth(SDL_Surface *src, SDL_Surface *dst, struct _module_state *st)
     }
 }
 
-static SDL_Surface *
-smoothscale_to(PyObject *self, pgSurfaceObject *srcobj,
-               pgSurfaceObject *dstobj, int width, int height)
+/* Resampling of transform.scale with the bilinear, bicubic and lanczos3
+ * filters. The X and Y scaling are done in two passes, each output pixel
+ * being a weighted sum of the source pixels under the filter, with the
+ * weights of each row and column computed ahead of time in 2.14 fixed
+ * point. Like smoothscale, this works on 32 bit pixels and treats the four
+ * channels alike. */
+typedef struct {
+    int *starts;      /* first source pixel of each output pixel */
+    int *counts;      /* number of source pixels of each output pixel */
+    Sint16 *weights;  /* window weights for each output pixel */
+    int window;
+} pgResampleTable;
+
+static double
+_resample_kernel(int filter, double x)
 {
-    SDL_Surface *src = NULL;
-    SDL_Surface *retsurf = NULL;
-    int bpp;
-    if (width < 0 || height < 0) {
-        return (SDL_Surface *)(RAISE(PyExc_ValueError,
-                                     "Cannot scale to negative size"));
+    x = fabs(x);
+    switch (filter) {
+        case PG_SCALE_BILINEAR:
+            return x < 1.0 ? 1.0 - x : 0.0;
+        case PG_SCALE_BICUBIC:
+            /* Keys' cubic convolution with a = -0.5 */
+            if (x < 1.0) {
+                return (1.5 * x - 2.5) * x * x + 1.0;
+            }
+            if (x < 2.0) {
+                return ((-0.5 * x + 2.5) * x - 4.0) * x + 2.0;
+            }
+            return 0.0;
+        default: /* PG_SCALE_LANCZOS3 */
+            if (x < 1e-8) {
+                return 1.0;
+            }
+            if (x >= 3.0) {
+                return 0.0;
+            }
+            return 3.0 * sin(M_PI * x) * sin(M_PI * x / 3.0) /
+                   (M_PI * M_PI * x * x);
     }
+}
 
-    src = pgSurface_AsSurface(srcobj);
+static void
+_resample_table_free(pgResampleTable *table)
+{
+    free(table->starts);
+    free(table->counts);
+    free(table->weights);
+    table->starts = table->counts = NULL;
+    table->weights = NULL;
+}
 
-    bpp = PG_SURF_BytesPerPixel(src);
-    if (bpp < 3 || bpp > 4) {
-        return (SDL_Surface *)(RAISE(
-            PyExc_ValueError,
-            "Only 24-bit or 32-bit surfaces can be smoothly scaled"));
+/* Fills in the weights for scaling srclen pixels to dstlen, returns 0 when
+ * out of memory. When shrinking, the filter is stretched to cover all the
+ * source pixels of an output pixel. */
+static int
+_resample_table_init(pgResampleTable *table, int srclen, int dstlen,
+                     int filter)
+{
+    static const double supports[] = {0.0, 1.0, 2.0, 3.0};
+    double scale = (double)srclen / dstlen;
+    double filterscale = MAX(scale, 1.0);
+    double support = supports[filter] * filterscale;
+    double *taps;
+    int i, k;
+
+    table->window = (int)ceil(support) * 2 + 1;
+    table->starts = (int *)malloc(sizeof(int) * dstlen);
+    table->counts = (int *)malloc(sizeof(int) * dstlen);
+    table->weights =
+        (Sint16 *)calloc((size_t)dstlen * table->window, sizeof(Sint16));
+    taps = (double *)malloc(sizeof(double) * table->window);
+    if (!table->starts || !table->counts || !table->weights || !taps) {
+        _resample_table_free(table);
+        free(taps);
+        return 0;
     }
 
-    if (!dstobj) {
-        retsurf = newsurf_fromsurf(src, width, height);
-        if (!retsurf) {
-            return NULL;
+    for (i = 0; i < dstlen; i++) {
+        Sint16 *weights = table->weights + (size_t)i * table->window;
+        double center = (i + 0.5) * scale;
+        double total = 0.0;
+        int start = MAX((int)(center - support + 0.5), 0);
+        int count = MIN((int)(center + support + 0.5), srclen) - start;
+        int best = 0, sum = 0;
+
+        count = MIN(MAX(count, 1), table->window);
+        for (k = 0; k < count; k++) {
+            taps[k] = _resample_kernel(
+                filter, (start + k - center + 0.5) / filterscale);
+            total += taps[k];
         }
-    }
-    else {
-        retsurf = pgSurface_AsSurface(dstobj);
-    }
+        for (k = 0; k < count; k++) {
+            double weight = total != 0.0 ? taps[k] / total : k == 0;
+            int fixed = (int)floor(weight * (1 << 14) + 0.5);
+            weights[k] = (Sint16)MIN(MAX(fixed, -0x7FFF), 0x7FFF);
+            sum += weights[k];
+            if (weights[k] > weights[best]) {
+                best = k;
+            }
+        }
+        /* rounding must not change the brightness of flat areas */
+        weights[best] += (Sint16)((1 << 14) - sum);
 
-    if (retsurf->w != width || retsurf->h != height) {
-        return (SDL_Surface *)(RAISE(
-            PyExc_ValueError,
-            "Destination surface not the given width or height."));
+        table->starts[i] = start;
+        table->counts[i] = count;
     }
+    free(taps);
+    return 1;
+}
 
-    if (((width * bpp + 3) >> 2) > retsurf->pitch) {
-        return (SDL_Surface *)(RAISE(
-            PyExc_ValueError,
-            "SDL Error: destination surface pitch not 4-byte aligned."));
+static PG_INLINE Uint8
+_resample_clamp(Sint32 acc)
+{
+    if (acc < 0) {
+        return 0;
     }
+    acc >>= 14;
+    return acc > 255 ? 255 : (Uint8)acc;
+}
 
-    if (width && height) {
-        SDL_LockSurface(retsurf);
-        pgSurface_Lock(srcobj);
+static void
+resample_row_h(const Uint8 *srcrow, Uint8 *dstrow, int dstwidth,
+               const int *starts, const int *counts, const Sint16 *weights,
+               int window)
+{
+    int x, k, c;
 
-        /* handle trivial case */
-        if (src->w == width && src->h == height) {
-            int y;
-            Py_BEGIN_ALLOW_THREADS;
-            for (y = 0; y < height; y++) {
-                memcpy((Uint8 *)retsurf->pixels + y * retsurf->pitch,
-                       (Uint8 *)src->pixels + y * src->pitch, width * bpp);
+    for (x = 0; x < dstwidth; x++) {
+        const Uint8 *srcp = srcrow + (size_t)starts[x] * 4;
+        const Sint16 *w = weights + (size_t)x * window;
+        Sint32 acc[4] = {1 << 13, 1 << 13, 1 << 13, 1 << 13};
+
+        for (k = 0; k < counts[x]; k++) {
+            for (c = 0; c < 4; c++) {
+                acc[c] += srcp[c] * w[k];
             }
-            Py_END_ALLOW_THREADS;
+            srcp += 4;
         }
-        else {
-            struct _module_state *st = GETSTATE(self);
-            Py_BEGIN_ALLOW_THREADS;
-            scalesmooth(src, retsurf, st);
-            Py_END_ALLOW_THREADS;
+        for (c = 0; c < 4; c++) {
+            *dstrow++ = _resample_clamp(acc[c]);
         }
-
-        pgSurface_Unlock(srcobj);
-        SDL_UnlockSurface(retsurf);
     }
-
-    return retsurf;
 }
 
-static PyObject *
-surf_scalesmooth(PyObject *self, PyObject *args, PyObject *kwargs)
+static void
+resample_row_v(const Uint8 *srcpix, int srcpitch, Uint8 *dstrow, int width,
+               int count, const Sint16 *weights)
 {
-    pgSurfaceObject *surfobj;
-    pgSurfaceObject *surfobj2 = NULL;
-    SDL_Surface *surf;
-    PyObject *size;
-    SDL_Surface *newsurf;
-    int width, height;
-    static char *keywords[] = {"surface", "size", "dest_surface", NULL};
+    int x, k;
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!O|O!", keywords,
-                                     &pgSurface_Type, &surfobj, &size,
-                                     &pgSurface_Type, &surfobj2)) {
-        return NULL;
+    for (x = 0; x < width * 4; x++) {
+        const Uint8 *srcp = srcpix + x;
+        Sint32 acc = 1 << 13;
+
+        for (k = 0; k < count; k++) {
+            acc += *srcp * weights[k];
+            srcp += srcpitch;
+        }
+        dstrow[x] = _resample_clamp(acc);
     }
+}
 
-    surf = pgSurface_AsSurface(surfobj);
-    SURF_INIT_CHECK(surf)
+/* One resampling pass, run in bands of output rows */
+typedef struct {
+    const Uint8 *srcpix;
+    Uint8 *dstpix;
+    int srcpitch;
+    int dstpitch;
+    int width;
+    const pgResampleTable *table;
+    int simd;
+} pgResamplePass;
 
-    if (!pg_TwoIntsFromObj(size, &width, &height)) {
-        return RAISE(PyExc_TypeError, "size must be two numbers");
+static void
+_resample_h_band(void *data, int start, int end)
+{
+    pgResamplePass *pass = (pgResamplePass *)data;
+    const pgResampleTable *table = pass->table;
+    int y;
+
+    for (y = start; y < end; y++) {
+        const Uint8 *srcrow = pass->srcpix + (size_t)y * pass->srcpitch;
+        Uint8 *dstrow = pass->dstpix + (size_t)y * pass->dstpitch;
+#if !defined(__EMSCRIPTEN__)
+#if defined(__SSE2__) || defined(PG_ENABLE_ARM_NEON)
+        if (pass->simd) {
+            resample_row_h_sse2(srcrow, dstrow, pass->width, table->starts,
+                                table->counts, table->weights, table->window);
+            continue;
+        }
+#endif /* defined(__SSE2__) || defined(PG_ENABLE_ARM_NEON) */
+#endif /* !defined(__EMSCRIPTEN__) */
+        resample_row_h(srcrow, dstrow, pass->width, table->starts,
+                       table->counts, table->weights, table->window);
     }
+}
 
-    newsurf = smoothscale_to(self, surfobj, surfobj2, width, height);
-    if (!newsurf) {
-        return NULL;
+static void
+_resample_v_band(void *data, int start, int end)
+{
+    pgResamplePass *pass = (pgResamplePass *)data;
+    const pgResampleTable *table = pass->table;
+    int y;
+
+    for (y = start; y < end; y++) {
+        const Uint8 *srcpix =
+            pass->srcpix + (size_t)table->starts[y] * pass->srcpitch;
+        const Sint16 *weights = table->weights + (size_t)y * table->window;
+        Uint8 *dstrow = pass->dstpix + (size_t)y * pass->dstpitch;
+#if !defined(__EMSCRIPTEN__)
+#if defined(__SSE2__) || defined(PG_ENABLE_ARM_NEON)
+        if (pass->simd) {
+            resample_row_v_sse2(srcpix, pass->srcpitch, dstrow, pass->width,
+                                table->counts[y], weights);
+            continue;
+        }
+#endif /* defined(__SSE2__) || defined(PG_ENABLE_ARM_NEON) */
+#endif /* !defined(__EMSCRIPTEN__) */
+        resample_row_v(srcpix, pass->srcpitch, dstrow, pass->width,
+                       table->counts[y], weights);
     }
+}
 
-    if (surfobj2) {
-        Py_INCREF(surfobj2);
-        return (PyObject *)surfobj2;
+/* Runs a pass over the given number of output rows of width pixels */
+static void
+resample_pass(pgResamplePass *pass, pg_rowbandproc func, int rows,
+              const pgResampleTable *table)
+{
+    int bands =
+        pg_ParallelBandCount(rows, (Py_ssize_t)rows * pass->width *
+                                       MAX(table->window / 2, 1));
+
+    pass->table = table;
+    if (bands > 1) {
+        pg_ParallelForRows(rows, bands, func, pass);
     }
     else {
-        return (PyObject *)pgSurface_New(newsurf);
+        func(pass, 0, rows);
     }
 }
 
-static PyObject *
-surf_scalesmooth_by(PyObject *self, PyObject *args, PyObject *kwargs)
+/* Scales src into dst, both 24 or 32 bit surfaces of the same format.
+ * Returns 0 when out of memory. */
+static int
+resample(SDL_Surface *src, SDL_Surface *dst, int filter)
 {
-    pgSurfaceObject *surfobj;
-    pgSurfaceObject *surfobj2 = NULL;
-    PyObject *factorobj = NULL;
-    float scale, scaley;
-    SDL_Surface *surf, *newsurf;
-    static char *keywords[] = {"surface", "factor", "dest_surface", NULL};
-
-    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!O|O!", keywords,
-                                     &pgSurface_Type, &surfobj, &factorobj,
-                                     &pgSurface_Type, &surfobj2)) {
-        return NULL;
-    }
+    Uint8 *srcpix = (Uint8 *)src->pixels;
+    Uint8 *dstpix = (Uint8 *)dst->pixels;
+    Uint8 *src32 = NULL, *dst32 = NULL, *temppix = NULL;
+    int srcpitch = src->pitch;
+    int dstpitch = dst->pitch;
+    int srcwidth = src->w, srcheight = src->h;
+    int dstwidth = dst->w, dstheight = dst->h;
+    int bpp = PG_SURF_BytesPerPixel(src);
+    pgResampleTable xtable = {NULL}, ytable = {NULL};
+    pgResamplePass pass = {NULL};
+    int y, okay = 0;
 
-    if (!_get_factor(factorobj, &scale, &scaley)) {
-        return NULL;
+#if !defined(__EMSCRIPTEN__)
+#if defined(__SSE2__) || defined(PG_ENABLE_ARM_NEON)
+    pass.simd = pg_HasSSE_NEON();
+#endif /* defined(__SSE2__) || defined(PG_ENABLE_ARM_NEON) */
+#endif /* !defined(__EMSCRIPTEN__) */
+
+    if (srcwidth == dstwidth && srcheight == dstheight) {
+        for (y = 0; y < dstheight; y++) {
+            memcpy(dstpix + (size_t)y * dstpitch,
+                   srcpix + (size_t)y * srcpitch, (size_t)dstwidth * bpp);
+        }
+        return 1;
     }
 
-    surf = pgSurface_AsSurface(surfobj);
-    SURF_INIT_CHECK(surf)
+    if ((srcwidth != dstwidth &&
+         !_resample_table_init(&xtable, srcwidth, dstwidth, filter)) ||
+        (srcheight != dstheight &&
+         !_resample_table_init(&ytable, srcheight, dstheight, filter))) {
+        goto end;
+    }
 
-    newsurf = smoothscale_to(self, surfobj, surfobj2, (int)(surf->w * scale),
-                             (int)(surf->h * scaley));
-    if (!newsurf) {
-        return NULL;
+    /* convert to 32-bit if necessary */
+    if (bpp == 3) {
+        src32 = (Uint8 *)malloc((size_t)srcwidth * 4 * srcheight);
+        dst32 = (Uint8 *)malloc((size_t)dstwidth * 4 * dstheight);
+        if (!src32 || !dst32) {
+            goto end;
+        }
+        convert_24_32(srcpix, srcpitch, src32, srcwidth * 4, srcwidth,
+                      srcheight);
+        srcpix = src32;
+        srcpitch = srcwidth * 4;
+        dstpix = dst32;
+        dstpitch = dstwidth * 4;
     }
 
-    if (surfobj2) {
-        Py_INCREF(surfobj2);
-        return (PyObject *)surfobj2;
+    pass.srcpix = srcpix;
+    pass.srcpitch = srcpitch;
+    if (srcwidth != dstwidth) {
+        if (srcheight != dstheight) {
+            temppix = (Uint8 *)malloc((size_t)dstwidth * 4 * srcheight);
+            if (!temppix) {
+                goto end;
+            }
+            pass.dstpix = temppix;
+            pass.dstpitch = dstwidth * 4;
+        }
+        else {
+            pass.dstpix = dstpix;
+            pass.dstpitch = dstpitch;
+        }
+        pass.width = dstwidth;
+        resample_pass(&pass, _resample_h_band, srcheight, &xtable);
+
+        pass.srcpix = pass.dstpix;
+        pass.srcpitch = pass.dstpitch;
     }
-    else {
-        return (PyObject *)pgSurface_New(newsurf);
+    if (srcheight != dstheight) {
+        pass.dstpix = dstpix;
+        pass.dstpitch = dstpitch;
+        pass.width = dstwidth;
+        resample_pass(&pass, _resample_v_band, dstheight, &ytable);
     }
-}
 
-static PyObject *
-surf_get_smoothscale_backend(PyObject *self, PyObject *_null)
-{
-    return PyUnicode_FromString(GETSTATE(self)->filter_type);
+    /* Convert back to 24-bit if necessary */
+    if (bpp == 3) {
+        convert_32_24(dst32, dstpitch, (Uint8 *)dst->pixels, dst->pitch,
+                      dstwidth, dstheight);
+    }
+    okay = 1;
+
+end:
+    free(temppix);
+    free(src32);
+    free(dst32);
+    _resample_table_free(&xtable);
+    _resample_table_free(&ytable);
+    return okay;
 }
 
-static PyObject *
-surf_set_smoothscale_backend(PyObject *self, PyObject *args, PyObject *kwargs)
+static SDL_Surface *
+resample_to(pgSurfaceObject *srcobj, pgSurfaceObject *dstobj, int width,
+            int height, int filter)
 {
-    struct _module_state *st = GETSTATE(self);
-    char *keywords[] = {"backend", NULL};
-    const char *type;
-
-#ifdef _MSC_VER
-    /* MSVC static analyzer false alarm: assure type is NULL-terminated by
-     * making analyzer assume it was initialised */
-    __analysis_assume(type = "inited");
-#endif
+    SDL_Surface *src = pgSurface_AsSurface(srcobj);
+    SDL_Surface *retsurf;
+    int bpp = PG_SURF_BytesPerPixel(src);
+    int okay = 1;
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "s", keywords, &type)) {
-        return NULL;
+    if (width < 0 || height < 0) {
+        return RAISE(PyExc_ValueError, "Cannot scale to negative size");
     }
-
-    if (strcmp(type, "GENERIC") == 0) {
-        st->filter_type = "GENERIC";
-        st->filter_shrink_X = filter_shrink_X_ONLYC;
-        st->filter_shrink_Y = filter_shrink_Y_ONLYC;
-        st->filter_expand_X = filter_expand_X_ONLYC;
-        st->filter_expand_Y = filter_expand_Y_ONLYC;
+    if (bpp < 3 || bpp > 4) {
+        return RAISE(PyExc_ValueError,
+                     "Only 24-bit or 32-bit surfaces can be scaled with a "
+                     "filter");
     }
-#if defined(SCALE_MMX_SUPPORT)
-    else if (strcmp(type, "MMX") == 0) {
-        if (!SDL_HasMMX()) {
-            return RAISE(PyExc_ValueError,
-                         "MMX not supported on this machine");
-        }
-        if (PyErr_WarnEx(
-                PyExc_DeprecationWarning,
-                "MMX backend is deprecated in favor of new SSE2 backend",
-                1) == -1) {
+
+    if (!dstobj) {
+        retsurf = newsurf_fromsurf(src, width, height);
+        if (!retsurf) {
             return NULL;
         }
-        st->filter_type = "MMX";
-        st->filter_shrink_X = filter_shrink_X_MMX;
-        st->filter_shrink_Y = filter_shrink_Y_MMX;
-        st->filter_expand_X = filter_expand_X_MMX;
-        st->filter_expand_Y = filter_expand_Y_MMX;
     }
-    else if (strcmp(type, "SSE") == 0) {
-        if (!SDL_HasSSE()) {
-            return RAISE(PyExc_ValueError,
-                         "SSE not supported on this machine");
+    else {
+        retsurf = pgSurface_AsSurface(dstobj);
+
+        PG_PixelFormat *ret_format = PG_GetSurfaceFormat(retsurf);
+        PG_PixelFormat *src_format = PG_GetSurfaceFormat(src);
+        if (ret_format == NULL || src_format == NULL) {
+            return RAISE(pgExc_SDLError, SDL_GetError());
         }
-        if (PyErr_WarnEx(
-                PyExc_DeprecationWarning,
-                "SSE backend is deprecated in favor of new SSE2 backend",
-                1) == -1) {
-            return NULL;
+        if (PG_FORMAT_BytesPerPixel(ret_format) != bpp ||
+            ret_format->Rmask != src_format->Rmask ||
+            ret_format->Gmask != src_format->Gmask ||
+            ret_format->Bmask != src_format->Bmask) {
+            return RAISE(PyExc_ValueError,
+                         "Source and destination surfaces need to be "
+                         "compatible formats.");
         }
-        st->filter_type = "SSE";
-        st->filter_shrink_X = filter_shrink_X_SSE;
-        st->filter_shrink_Y = filter_shrink_Y_SSE;
-        st->filter_expand_X = filter_expand_X_SSE;
-        st->filter_expand_Y = filter_expand_Y_SSE;
     }
-#else
-    else if (strcmp(st->filter_type, "MMX") == 0 ||
-             strcmp(st->filter_type, "SSE") == 0) {
-        return PyErr_Format(PyExc_ValueError,
-                            "%s not supported on this machine", type);
+
+    if (retsurf->w != width || retsurf->h != height) {
+        return RAISE(PyExc_ValueError,
+                     "Destination surface not the given width or height.");
     }
-#endif /* ~defined(SCALE_MMX_SUPPORT) */
-#if !defined(__EMSCRIPTEN__)
-#if PG_ENABLE_SSE_NEON
-    else if (strcmp(type, "SSE2") == 0) {
-        if (!SDL_HasSSE2()) {
-            return RAISE(PyExc_ValueError,
-                         "SSE2 not supported on this machine");
-        }
-        st->filter_type = "SSE2";
-        st->filter_shrink_X = filter_shrink_X_SSE2;
-        st->filter_shrink_Y = filter_shrink_Y_SSE2;
-        st->filter_expand_X = filter_expand_X_SSE2;
-        st->filter_expand_Y = filter_expand_Y_SSE2;
+
+    if (width && height && src->w && src->h) {
+        SDL_LockSurface(retsurf);
+        pgSurface_LockRead(srcobj);
+        Py_BEGIN_ALLOW_THREADS;
+        okay = resample(src, retsurf, filter);
+        Py_END_ALLOW_THREADS;
+        pgSurface_Unlock(srcobj);
+        SDL_UnlockSurface(retsurf);
     }
 
-    else if (strcmp(type, "NEON") == 0) {
-        if (!SDL_HasNEON()) {
-            return RAISE(PyExc_ValueError,
-                         "NEON not supported on this machine");
+    if (!okay) {
+        if (!dstobj) {
+            SDL_FreeSurface(retsurf);
         }
-        st->filter_type = "NEON";
-        st->filter_shrink_X = filter_shrink_X_SSE2;
-        st->filter_shrink_Y = filter_shrink_Y_SSE2;
-        st->filter_expand_X = filter_expand_X_SSE2;
-        st->filter_expand_Y = filter_expand_Y_SSE2;
-    }
-#endif /* PG_ENABLE_SSE_NEON */
-#endif /* !__EMSCRIPTEN__ */
-    else {
-        return PyErr_Format(PyExc_ValueError, "Unknown backend type %s", type);
+        return (SDL_Surface *)PyErr_NoMemory();
     }
-    Py_RETURN_NONE;
+    return retsurf;
 }
 
-/* _get_color_move_pixels is for iterating over pixels in a Surface.
-
-    bpp - bytes per pixel
-    the_color - is set for that pixel
-    pixels - pointer is advanced by one pixel.
- */
-static PG_INLINE Uint8 *
-_get_color_move_pixels(Uint8 bpp, Uint8 *pixels, Uint32 *the_color)
+/* Mipmaps of transform.build_mipmaps. Each level is half the size of the
+ * level above, rounded down but at least 1, and each of its bytes is the
+ * rounded mean of the 2x2 block of bytes above it. Odd last rows and
+ * columns are dropped, levels one pixel wide or high are reduced along the
+ * other side only. */
+static void
+mipmap_row(const Uint8 *row0, const Uint8 *row1, Uint8 *dst, int width,
+           int bpp)
 {
-    Uint8 *pix;
-    // printf("bpp:%i, pixels:%p\n", bpp, pixels);
+    int x, k, i;
 
-    switch (bpp) {
-        case 1:
-            *the_color = (Uint32) * ((Uint8 *)pixels);
-            return pixels + 1;
-        case 2:
-            *the_color = (Uint32) * ((Uint16 *)pixels);
-            return pixels + 2;
-        case 3:
-            pix = ((Uint8 *)pixels);
-#if SDL_BYTEORDER == SDL_LIL_ENDIAN
-            *the_color = (pix[0]) + (pix[1] << 8) + (pix[2] << 16);
-#else
-            *the_color = (pix[2]) + (pix[1] << 8) + (pix[0] << 16);
-#endif
-            return pixels + 3;
-        default: /* case 4: */
-            *the_color = *((Uint32 *)pixels);
-            return pixels + 4;
+    for (x = 0; x < width; x++) {
+        for (k = 0; k < bpp; k++) {
+            i = x * 2 * bpp + k;
+            dst[x * bpp + k] = (Uint8)(
+                (row0[i] + row0[i + bpp] + row1[i] + row1[i + bpp] + 2) >> 2);
+        }
     }
-    // printf("---bpp:%i, pixels:%p\n", bpp, pixels);
 }
 
-/* _set_at_pixels sets the pixel to the_color.
-
-    x - x pos in the SDL_Surface pixels.
-    y - y pos in the SDL_Surface pixels.
-    format - of the SDL_Surface pixels.
-    pitch - of the SDL_Surface.
-    the_color - to set in the pixels at this position.
-*/
+/* Averages the count 32 bit pixels of block into dst like mipmap_row, but
+ * with the colors weighted by the alpha byte at offset alpha, as if they
+ * were premultiplied. Transparent pixels then do not darken their
+ * neighbours. A fully transparent block gets the plain mean. */
 static PG_INLINE void
-_set_at_pixels(int x, int y, Uint8 *pixels, PG_PixelFormat *format,
-               int surf_pitch, Uint32 the_color)
+mipmap_alpha_pixel(const Uint8 *const *block, int count, int alpha,
+                   Uint8 *dst)
 {
-    Uint8 *byte_buf;
+    Uint32 total = 0, weight, sums[4] = {0, 0, 0, 0};
+    int i, k;
 
-    switch (PG_FORMAT_BytesPerPixel(format)) {
-        case 1:
-            *((Uint8 *)pixels + y * surf_pitch + x) = (Uint8)the_color;
-            break;
-        case 2:
-            *((Uint16 *)(pixels + y * surf_pitch) + x) = (Uint16)the_color;
-            break;
-        case 3:
-            byte_buf = (Uint8 *)(pixels + y * surf_pitch) + x * 3;
-#if (SDL_BYTEORDER == SDL_LIL_ENDIAN)
-            *(byte_buf + (format->Rshift >> 3)) = (Uint8)(the_color >> 16);
-            *(byte_buf + (format->Gshift >> 3)) = (Uint8)(the_color >> 8);
-            *(byte_buf + (format->Bshift >> 3)) = (Uint8)the_color;
-#else
-            *(byte_buf + 2 - (format->Rshift >> 3)) = (Uint8)(the_color >> 16);
-            *(byte_buf + 2 - (format->Gshift >> 3)) = (Uint8)(the_color >> 8);
-            *(byte_buf + 2 - (format->Bshift >> 3)) = (Uint8)the_color;
-#endif
-            break;
-        default: /* case 4: */
-            *((Uint32 *)(pixels + y * surf_pitch) + x) = the_color;
-            break;
+    for (i = 0; i < count; i++) {
+        total += block[i][alpha];
+    }
+    for (i = 0; i < count; i++) {
+        weight = total ? block[i][alpha] : 1;
+        for (k = 0; k < 4; k++) {
+            sums[k] += block[i][k] * (k == alpha ? 1 : weight);
+        }
+    }
+    for (k = 0; k < 4; k++) {
+        weight = k == alpha || !total ? (Uint32)count : total;
+        dst[k] = (Uint8)((sums[k] + weight / 2) / weight);
     }
 }
 
-static int
-get_threshold(SDL_Surface *dest_surf, PG_PixelFormat *dest_fmt,
-              SDL_Surface *surf, PG_PixelFormat *surf_fmt,
-              SDL_Palette *surf_palette, Uint32 color_search_color,
-              Uint32 color_threshold, Uint32 color_set_color, int set_behavior,
-              SDL_Surface *search_surf, PG_PixelFormat *search_surf_fmt,
-              SDL_Palette *search_surf_palette, int inverse_set)
+static void
+mipmap_row_alpha(const Uint8 *row0, const Uint8 *row1, Uint8 *dst,
+                 int width, int alpha)
 {
-    int x, y, similar;
-    Uint8 *pixels, *destpixels = NULL, *pixels2 = NULL;
-    Uint32 the_color, the_color2, dest_set_color;
-    Uint8 search_color_r, search_color_g, search_color_b;
-    Uint8 surf_r, surf_g, surf_b;
-    Uint8 threshold_r, threshold_g, threshold_b;
-    Uint8 search_surf_r, search_surf_g, search_surf_b;
+    const Uint8 *block[4];
+    int x;
 
-    int within_threshold;
+    for (x = 0; x < width; x++) {
+        block[0] = row0 + x * 8;
+        block[1] = block[0] + 4;
+        block[2] = row1 + x * 8;
+        block[3] = block[2] + 4;
+        mipmap_alpha_pixel(block, 4, alpha, dst + x * 4);
+    }
+}
 
-    similar = 0;
+typedef struct {
+    SDL_Surface *src;
+    SDL_Surface *dst;
+    int simd;
+    int alpha; /* offset of the alpha byte of 32 bit pixels, or -1 */
+} pgMipmapPass;
 
-    if (set_behavior) {
-        destpixels = (Uint8 *)dest_surf->pixels;
-    }
-    if (search_surf) {
-        pixels2 = (Uint8 *)search_surf->pixels;
-    }
-
-    PG_GetRGB(color_search_color, surf_fmt, surf_palette, &search_color_r,
-              &search_color_g, &search_color_b);
-    PG_GetRGB(color_threshold, surf_fmt, surf_palette, &threshold_r,
-              &threshold_g, &threshold_b);
+static PG_INLINE void
+_mipmap_row(pgMipmapPass *pass, const Uint8 *row0, const Uint8 *row1,
+            Uint8 *dst)
+{
+    int width = pass->dst->w;
+    int bpp = PG_SURF_BytesPerPixel(pass->src);
 
-    for (y = 0; y < surf->h; y++) {
-        pixels = (Uint8 *)surf->pixels + y * surf->pitch;
-        if (search_surf) {
-            pixels2 = (Uint8 *)search_surf->pixels + y * search_surf->pitch;
-        }
+    if (pass->alpha >= 0) {
+        mipmap_row_alpha(row0, row1, dst, width, pass->alpha);
+        return;
+    }
+#if !defined(__EMSCRIPTEN__)
+    if (bpp == 4 && pass->simd == 2) {
+        mipmap_row_avx2(row0, row1, dst, width);
+        return;
+    }
+#if defined(__SSE2__) || defined(PG_ENABLE_ARM_NEON)
+    if (bpp == 4 && pass->simd) {
+        mipmap_row_sse2(row0, row1, dst, width);
+        return;
+    }
+#endif /* defined(__SSE2__) || defined(PG_ENABLE_ARM_NEON) */
+#endif /* !defined(__EMSCRIPTEN__) */
+    mipmap_row(row0, row1, dst, width, bpp);
+}
 
-        for (x = 0; x < surf->w; x++) {
-            pixels = _get_color_move_pixels(PG_SURF_BytesPerPixel(surf),
-                                            pixels, &the_color);
-            PG_GetRGB(the_color, surf_fmt, surf_palette, &surf_r, &surf_g,
-                      &surf_b);
+static void
+_mipmap_band(void *data, int start, int end)
+{
+    pgMipmapPass *pass = (pgMipmapPass *)data;
+    SDL_Surface *src = pass->src;
+    SDL_Surface *dst = pass->dst;
+    int bpp = PG_SURF_BytesPerPixel(src);
+    int y, k;
 
-            if (search_surf) {
-                /* Get search_surf.color */
-                pixels2 = _get_color_move_pixels(
-                    PG_SURF_BytesPerPixel(search_surf), pixels2, &the_color2);
-                PG_GetRGB(the_color2, search_surf_fmt, search_surf_palette,
-                          &search_surf_r, &search_surf_g, &search_surf_b);
+    for (y = start; y < end; y++) {
+        int srcy = src->h > 1 ? y * 2 : y;
+        const Uint8 *row0 = (Uint8 *)src->pixels + (size_t)srcy * src->pitch;
+        const Uint8 *row1 = src->h > 1 ? row0 + src->pitch : row0;
+        Uint8 *dstrow = (Uint8 *)dst->pixels + (size_t)y * dst->pitch;
 
-                /* search_surf(the_color2) is within threshold of
-                 * surf(the_color) */
-                within_threshold =
-                    ((abs((int)search_surf_r - (int)surf_r) <= threshold_r) &&
-                     (abs((int)search_surf_g - (int)surf_g) <= threshold_g) &&
-                     (abs((int)search_surf_b - (int)surf_b) <= threshold_b));
-                dest_set_color =
-                    ((set_behavior == 2) ? the_color2 : color_set_color);
-            }
-            else {
-                /* search_color within threshold of surf.the_color */
-                // printf("rgb: %i,%i,%i\n", surf_r, surf_g, surf_b);
-                within_threshold =
-                    ((abs((int)search_color_r - (int)surf_r) <= threshold_r) &&
-                     (abs((int)search_color_g - (int)surf_g) <= threshold_g) &&
-                     (abs((int)search_color_b - (int)surf_b) <= threshold_b));
-                dest_set_color =
-                    ((set_behavior == 2) ? the_color : color_set_color);
-            }
+        if (src->w == 1 && pass->alpha >= 0) {
+            const Uint8 *block[2] = {row0, row1};
 
-            if (within_threshold) {
-                similar++;
-            }
-            if (set_behavior && ((within_threshold && inverse_set) ||
-                                 (!within_threshold && !inverse_set))) {
-                _set_at_pixels(x, y, destpixels, dest_fmt, dest_surf->pitch,
-                               dest_set_color);
+            mipmap_alpha_pixel(block, 2, pass->alpha, dstrow);
+        }
+        else if (src->w == 1) {
+            for (k = 0; k < bpp; k++) {
+                dstrow[k] = (Uint8)((row0[k] + row1[k] + 1) >> 1);
             }
         }
+        else {
+            _mipmap_row(pass, row0, row1, dstrow);
+        }
     }
-    return similar;
 }
 
-/* _color_from_obj gets a color from a python object.
-
-Returns 0 if ok, and sets color to the color.
-   -1 means error.
-   If color_obj is NULL, use rgba_default.
-   If rgba_default is NULL, do not use a default color, return -1.
-*/
-int
-_color_from_obj(PyObject *color_obj, SDL_Surface *surf, Uint8 rgba_default[4],
-                Uint32 *color)
+/* Reduces src into dst, a 24 or 32 bit surface of the same format and half
+ * the size. alpha is the offset of the alpha byte of 32 bit pixels with per
+ * pixel alpha, or -1. */
+static void
+mipmap_reduce(SDL_Surface *src, SDL_Surface *dst, int alpha)
 {
-    if (color_obj) {
-        if (!pg_MappedColorFromObj(color_obj, surf, color,
-                                   PG_COLOR_HANDLE_ALL)) {
-            return -1;
-        }
+    pgMipmapPass pass;
+    int bands;
+
+    pass.src = src;
+    pass.dst = dst;
+    pass.alpha = alpha;
+    pass.simd = 0;
+#if !defined(__EMSCRIPTEN__)
+#if defined(__SSE2__) || defined(PG_ENABLE_ARM_NEON)
+    pass.simd = pg_HasSSE_NEON();
+#endif /* defined(__SSE2__) || defined(PG_ENABLE_ARM_NEON) */
+    if (pg_has_avx2()) {
+        pass.simd = 2;
     }
-    else {
-        if (!rgba_default) {
-            return -1;
-        }
+#endif /* !defined(__EMSCRIPTEN__) */
 
-        PG_PixelFormat *surf_format;
-        SDL_Palette *surf_palette;
-        if (!PG_GetSurfaceDetails(surf, &surf_format, &surf_palette)) {
-            return -1;
-        }
-        *color = PG_MapRGBA(surf_format, surf_palette, rgba_default[0],
-                            rgba_default[1], rgba_default[2], rgba_default[3]);
+    bands = pg_ParallelBandCount(dst->h, (Py_ssize_t)src->w * src->h);
+    if (bands > 1) {
+        pg_ParallelForRows(dst->h, bands, _mipmap_band, &pass);
+    }
+    else {
+        _mipmap_band(&pass, 0, dst->h);
     }
-    return 0;
 }
 
 static PyObject *
-surf_threshold(PyObject *self, PyObject *args, PyObject *kwds)
+surf_build_mipmaps(PyObject *self, PyObject *args, PyObject *kwargs)
 {
-    PyObject *dest_surf_obj;
-    SDL_Surface *dest_surf = NULL;
+    pgSurfaceObject *surfobj, *levelobj;
+    SDL_Surface *surf, *newsurf;
+    PG_PixelFormat *format;
+    PyObject *chain;
+    int levels = -1, bpp, alpha = -1;
+    static char *keywords[] = {"surface", "levels", NULL};
 
-    pgSurfaceObject *surf_obj;
-    SDL_Surface *surf = NULL;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!|i", keywords,
+                                     &pgSurface_Type, &surfobj, &levels)) {
+        return NULL;
+    }
 
-    PyObject *search_color_obj;
-    PyObject *threshold_obj = NULL;
-    PyObject *set_color_obj = NULL;
-    int set_behavior = 1;
-    int inverse_set = 0;
-    PyObject *search_surf_obj = NULL;
-    SDL_Surface *search_surf = NULL;
+    surf = pgSurface_AsSurface(surfobj);
+    SURF_INIT_CHECK(surf)
 
-    Uint8 rgba_threshold_default[4] = {0, 0, 0, 255};
-    Uint8 rgba_set_color_default[4] = {0, 0, 0, 255};
+    bpp = PG_SURF_BytesPerPixel(surf);
+    if (bpp < 3 || bpp > 4) {
+        return RAISE(PyExc_ValueError,
+                     "Only 24-bit or 32-bit surfaces can be mipmapped");
+    }
+    format = PG_GetSurfaceFormat(surf);
+    if (!format) {
+        return RAISE(pgExc_SDLError, SDL_GetError());
+    }
+    if (bpp == 4 && format->Amask == 0xFFu << format->Ashift) {
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+        alpha = format->Ashift >> 3;
+#else
+        alpha = 3 - (format->Ashift >> 3);
+#endif
+    }
 
-    Uint32 color_search_color = 0;
-    Uint32 color_threshold = 0;
-    Uint32 color_set_color = 0;
+    chain = PyList_New(1);
+    if (!chain) {
+        return NULL;
+    }
+    Py_INCREF(surfobj);
+    PyList_SET_ITEM(chain, 0, (PyObject *)surfobj);
 
-    int num_threshold_pixels = 0;
+    /* a negative number of levels goes down to one pixel */
+    for (; levels != 0 && surf->w && surf->h && (surf->w > 1 || surf->h > 1);
+         levels--) {
+        newsurf =
+            newsurf_fromsurf(surf, MAX(surf->w / 2, 1), MAX(surf->h / 2, 1));
+        if (!newsurf) {
+            Py_DECREF(chain);
+            return NULL;
+        }
 
-    /*
-    https://pyga.me/docs/ref/transform.html#pygame.transform.threshold
+        SDL_LockSurface(newsurf);
+        pgSurface_LockRead(surfobj);
+        Py_BEGIN_ALLOW_THREADS;
+        mipmap_reduce(surf, newsurf, alpha);
+        Py_END_ALLOW_THREADS;
+        pgSurface_Unlock(surfobj);
+        SDL_UnlockSurface(newsurf);
 
-    Returns the number of pixels within the threshold.
-    */
-    static char *kwlist[] = {
-        "dest_surface", /* Surface we are changing. See 'set_behavior'.
-                          None - if counting (set_behavior is 0),
-                                 don't need 'dest_surf'. */
-        "surface",      /* Surface we are looking at. */
-        "search_color", /* Color we are searching for. */
-        "threshold",    /* =(0,0,0,0)  Within this distance from
-                                       search_color (or search_surf). */
-        "set_color",    /* =(0,0,0,0)  Color we set. */
-        "set_behavior", /* =1 What and where we set pixels (if at all)
-                             1 - pixels in dest_surface will be changed
-                                 to 'set_color'.
-                             0 - we do not change 'dest_surf', just count.
-                                 Make dest_surf=None.
-                             2 - pixels set in 'dest_surf' will be from
-                           'surface'.
-                        */
-        "search_surf",  /* =None If set, compare to this surface.
-                             None - search against 'search_color' instead.
-                             Surface - look at the color in here rather
-                                       than 'search_color'.
-                        */
-        "inverse_set",  /* =False.
-                             False - pixels outside of threshold are changed.
-                             True - pixels within threshold are changed.
-                        */
-        0};
+        levelobj = pgSurface_New(newsurf);
+        if (!levelobj) {
+            Py_DECREF(chain);
+            return NULL;
+        }
+        if (PyList_Append(chain, (PyObject *)levelobj)) {
+            Py_DECREF(levelobj);
+            Py_DECREF(chain);
+            return NULL;
+        }
+        Py_DECREF(levelobj);
 
-    /* Get all arguments into our variables.
+        surfobj = levelobj;
+        surf = newsurf;
+    }
+    return chain;
+}
 
-    https://docs.python.org/3/c-api/arg.html#c.PyArg_ParseTupleAndKeywords
-    https://docs.python.org/3/c-api/arg.html#parsing-arguments
-    */
+static PyObject *
+surf_scale_mipmapped(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+    pgSurfaceObject *surfobj2 = NULL;
+    PyObject *chainobj, *size, *chain, *best = NULL, *largest = NULL;
+    SDL_Surface *surf, *newsurf;
+    Py_ssize_t i, count, area, best_area = 0, largest_area = 0;
+    int width, height;
+    static char *keywords[] = {"chain", "size", "dest_surface", NULL};
 
-    if (!PyArg_ParseTupleAndKeywords(
-            args, kwds, "OO!O|OOiOi", kwlist,
-            /* required */
-            &dest_surf_obj,             /* O python object from c type  */
-            &pgSurface_Type, &surf_obj, /* O! python object from c type */
-            &search_color_obj, /* O| python object. All after | optional. */
-            /* optional */
-            &threshold_obj,   /* O  python object. */
-            &set_color_obj,   /* O  python object. */
-            &set_behavior,    /* i  plain python int. */
-            &search_surf_obj, /* O python object. */
-            &inverse_set)) {  /* i  plain python int. */
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OO|O!", keywords,
+                                     &chainobj, &size, &pgSurface_Type,
+                                     &surfobj2)) {
         return NULL;
     }
 
-    if (set_behavior == 0 &&
-        !(set_color_obj == NULL || set_color_obj == Py_None)) {
-        return RAISE(PyExc_TypeError,
-                     "if set_behavior==0 set_color should be None");
+    if (surfobj2 && !pgSurface_Unshare(surfobj2)) {
+        return NULL;
     }
-    if (set_behavior == 0 && dest_surf_obj != Py_None) {
-        return RAISE(PyExc_TypeError,
-                     "if set_behavior==0 dest_surf_obj should be None");
+
+    if (!pg_TwoIntsFromObj(size, &width, &height)) {
+        return RAISE(PyExc_TypeError, "size must be two numbers");
     }
 
-    if (dest_surf_obj && dest_surf_obj != Py_None &&
-        pgSurface_Check(dest_surf_obj)) {
-        dest_surf = pgSurface_AsSurface(dest_surf_obj);
+    chain = PySequence_Fast(chainobj,
+                            "chain must be a sequence of surface objects");
+    if (!chain) {
+        return NULL;
     }
-    else if (set_behavior != 0) {
-        return RAISE(
-            PyExc_TypeError,
-            "argument 1 must be pygame.Surface, or None with set_behavior=1");
+    count = PySequence_Fast_GET_SIZE(chain);
+    if (count < 1) {
+        Py_DECREF(chain);
+        return RAISE(PyExc_ValueError, "chain must not be empty");
     }
 
-    surf = pgSurface_AsSurface(surf_obj);
-    if (NULL == surf) {
-        return RAISE(PyExc_TypeError, "invalid surf argument");
-    }
+    /* the smallest level covering the size, else the largest level */
+    for (i = 0; i < count; i++) {
+        PyObject *levelobj = PySequence_Fast_GET_ITEM(chain, i);
 
-    if (search_surf_obj && pgSurface_Check(search_surf_obj)) {
-        search_surf = pgSurface_AsSurface(search_surf_obj);
+        if (!pgSurface_Check(levelobj)) {
+            Py_DECREF(chain);
+            return RAISE(PyExc_TypeError,
+                         "chain must be a sequence of surface objects");
+        }
+        surf = pgSurface_AsSurface(levelobj);
+        if (!surf) {
+            Py_DECREF(chain);
+            return RAISE(pgExc_SDLError, "Surface is not initialized");
+        }
+        area = (Py_ssize_t)surf->w * surf->h;
+        if (surf->w >= width && surf->h >= height &&
+            (!best || area < best_area)) {
+            best = levelobj;
+            best_area = area;
+        }
+        if (!largest || area > largest_area) {
+            largest = levelobj;
+            largest_area = area;
+        }
     }
-
-    if (search_surf && search_color_obj != Py_None) {
-        return RAISE(PyExc_TypeError,
-                     "if search_surf is used, search_color should be None");
+    if (!best) {
+        best = largest;
     }
 
-    if (set_behavior == 2 && set_color_obj != Py_None) {
-        return RAISE(PyExc_TypeError,
-                     "if set_behavior==2 set_color should be None");
+    newsurf = resample_to((pgSurfaceObject *)best, surfobj2, width, height,
+                          PG_SCALE_BILINEAR);
+    Py_DECREF(chain);
+    if (!newsurf) {
+        return NULL;
     }
 
-    if (search_color_obj != Py_None) {
-        if (_color_from_obj(search_color_obj, surf, NULL,
-                            &color_search_color)) {
-            return RAISE(PyExc_TypeError, "invalid search_color argument");
-        }
+    if (surfobj2) {
+        pgSurface_AddDirtyRect(surfobj2, NULL);
+        Py_INCREF(surfobj2);
+        return (PyObject *)surfobj2;
     }
-    if (_color_from_obj(threshold_obj, surf, rgba_threshold_default,
-                        &color_threshold)) {
-        return RAISE(PyExc_TypeError, "invalid threshold argument");
+    else {
+        return (PyObject *)pgSurface_New(newsurf);
     }
+}
 
-    if (set_color_obj != Py_None) {
-        if (_color_from_obj(set_color_obj, surf, rgba_set_color_default,
-                            &color_set_color)) {
-            return RAISE(PyExc_TypeError, "invalid set_color argument");
-        }
+static SDL_Surface *
+smoothscale_to(PyObject *self, pgSurfaceObject *srcobj,
+               pgSurfaceObject *dstobj, int width, int height)
+{
+    SDL_Surface *src = NULL;
+    SDL_Surface *retsurf = NULL;
+    int bpp;
+    if (width < 0 || height < 0) {
+        return (SDL_Surface *)(RAISE(PyExc_ValueError,
+                                     "Cannot scale to negative size"));
     }
 
-    if (dest_surf && (surf->h != dest_surf->h || surf->w != dest_surf->w)) {
-        return RAISE(PyExc_TypeError, "surf and dest_surf not the same size");
-    }
+    src = pgSurface_AsSurface(srcobj);
 
-    if (search_surf &&
-        (surf->h != search_surf->h || surf->w != search_surf->w)) {
-        return RAISE(PyExc_TypeError,
-                     "surf and search_surf not the same size");
+    bpp = PG_SURF_BytesPerPixel(src);
+    if (bpp < 3 || bpp > 4) {
+        return (SDL_Surface *)(RAISE(
+            PyExc_ValueError,
+            "Only 24-bit or 32-bit surfaces can be smoothly scaled"));
     }
 
-    PG_PixelFormat *dest_fmt = NULL;
-    if (dest_surf) {
-        dest_fmt = PG_GetSurfaceFormat(dest_surf);
-        if (dest_fmt == NULL) {
-            return RAISE(pgExc_SDLError, SDL_GetError());
+    if (!dstobj) {
+        retsurf = newsurf_fromsurf(src, width, height);
+        if (!retsurf) {
+            return NULL;
         }
     }
+    else {
+        retsurf = pgSurface_AsSurface(dstobj);
+    }
 
-    PG_PixelFormat *surf_format;
-    SDL_Palette *surf_palette;
-    if (!PG_GetSurfaceDetails(surf, &surf_format, &surf_palette)) {
-        return RAISE(pgExc_SDLError, SDL_GetError());
+    if (retsurf->w != width || retsurf->h != height) {
+        return (SDL_Surface *)(RAISE(
+            PyExc_ValueError,
+            "Destination surface not the given width or height."));
     }
 
-    PG_PixelFormat *search_surf_format = NULL;
-    SDL_Palette *search_surf_palette = NULL;
-    if (search_surf) {
-        if (!PG_GetSurfaceDetails(search_surf, &search_surf_format,
-                                  &search_surf_palette)) {
-            return RAISE(pgExc_SDLError, SDL_GetError());
+    if (((width * bpp + 3) >> 2) > retsurf->pitch) {
+        return (SDL_Surface *)(RAISE(
+            PyExc_ValueError,
+            "SDL Error: destination surface pitch not 4-byte aligned."));
+    }
+
+    if (width && height) {
+        SDL_LockSurface(retsurf);
+        pgSurface_LockRead(srcobj);
+
+        /* handle trivial case */
+        if (src->w == width && src->h == height) {
+            int y;
+            Py_BEGIN_ALLOW_THREADS;
+            for (y = 0; y < height; y++) {
+                memcpy((Uint8 *)retsurf->pixels + y * retsurf->pitch,
+                       (Uint8 *)src->pixels + y * src->pitch, width * bpp);
+            }
+            Py_END_ALLOW_THREADS;
+        }
+        else {
+            struct _module_state *st = GETSTATE(self);
+            Py_BEGIN_ALLOW_THREADS;
+            scalesmooth(src, retsurf, st);
+            Py_END_ALLOW_THREADS;
         }
+
+        pgSurface_Unlock(srcobj);
+        SDL_UnlockSurface(retsurf);
     }
 
-    if (dest_surf) {
-        pgSurface_Lock((pgSurfaceObject *)dest_surf_obj);
+    return retsurf;
+}
+
+static PyObject *
+surf_scalesmooth(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+    pgSurfaceObject *surfobj;
+    pgSurfaceObject *surfobj2 = NULL;
+    SDL_Surface *surf;
+    PyObject *size;
+    SDL_Surface *newsurf;
+    int width, height;
+    static char *keywords[] = {"surface", "size", "dest_surface", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!O|O!", keywords,
+                                     &pgSurface_Type, &surfobj, &size,
+                                     &pgSurface_Type, &surfobj2)) {
+        return NULL;
     }
-    pgSurface_Lock(surf_obj);
-    if (search_surf) {
-        pgSurface_Lock((pgSurfaceObject *)search_surf_obj);
+
+    if (surfobj2 && !pgSurface_Unshare(surfobj2)) {
+        return NULL;
     }
 
-    Py_BEGIN_ALLOW_THREADS;
-    num_threshold_pixels = get_threshold(
-        dest_surf, dest_fmt, surf, surf_format, surf_palette,
-        color_search_color, color_threshold, color_set_color, set_behavior,
-        search_surf, search_surf_format, search_surf_palette, inverse_set);
-    Py_END_ALLOW_THREADS;
+    surf = pgSurface_AsSurface(surfobj);
+    SURF_INIT_CHECK(surf)
 
-    if (dest_surf) {
-        pgSurface_Unlock((pgSurfaceObject *)dest_surf_obj);
+    if (!pg_TwoIntsFromObj(size, &width, &height)) {
+        return RAISE(PyExc_TypeError, "size must be two numbers");
     }
-    pgSurface_Unlock(surf_obj);
-    if (search_surf) {
-        pgSurface_Unlock((pgSurfaceObject *)search_surf_obj);
+
+    newsurf = smoothscale_to(self, surfobj, surfobj2, width, height);
+    if (!newsurf) {
+        return NULL;
     }
 
-    return PyLong_FromLong(num_threshold_pixels);
+    if (surfobj2) {
+        pgSurface_AddDirtyRect(surfobj2, NULL);
+        Py_INCREF(surfobj2);
+        return (PyObject *)surfobj2;
+    }
+    else {
+        return (PyObject *)pgSurface_New(newsurf);
+    }
 }
 
-/*
-
-TODO:
-add_4
-sub_4
-mul_4
-clamp_4
-
-*/
+static PyObject *
+surf_scalesmooth_by(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+    pgSurfaceObject *surfobj;
+    pgSurfaceObject *surfobj2 = NULL;
+    PyObject *factorobj = NULL;
+    float scale, scaley;
+    SDL_Surface *surf, *newsurf;
+    static char *keywords[] = {"surface", "factor", "dest_surface", NULL};
 
-#define SURF_GET_AT(p_color, p_surf, p_x, p_y, p_pixels, p_format, p_pix)    \
-    switch (PG_FORMAT_BytesPerPixel(p_format)) {                             \
-        case 1:                                                              \
-            p_color = (Uint32) *                                             \
-                      ((Uint8 *)(p_pixels) + (p_y) * p_surf->pitch + (p_x)); \
-            break;                                                           \
-        case 2:                                                              \
-            p_color =                                                        \
-                (Uint32) *                                                   \
-                ((Uint16 *)((p_pixels) + (p_y) * p_surf->pitch) + (p_x));    \
-            break;                                                           \
-        case 3:                                                              \
-            p_pix =                                                          \
-                ((Uint8 *)(p_pixels + (p_y) * p_surf->pitch) + (p_x) * 3);   \
-            p_color = (SDL_BYTEORDER == SDL_LIL_ENDIAN)                      \
-                          ? (p_pix[0]) + (p_pix[1] << 8) + (p_pix[2] << 16)  \
-                          : (p_pix[2]) + (p_pix[1] << 8) + (p_pix[0] << 16); \
-            break;                                                           \
-        default: /* case 4: */                                               \
-            p_color =                                                        \
-                *((Uint32 *)(p_pixels + (p_y) * p_surf->pitch) + (p_x));     \
-            break;                                                           \
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!O|O!", keywords,
+                                     &pgSurface_Type, &surfobj, &factorobj,
+                                     &pgSurface_Type, &surfobj2)) {
+        return NULL;
     }
 
-#if (SDL_BYTEORDER == SDL_LIL_ENDIAN)
+    if (surfobj2 && !pgSurface_Unshare(surfobj2)) {
+        return NULL;
+    }
 
-#define SURF_SET_AT(p_color, p_surf, p_x, p_y, p_pixels, p_format,       \
-                    p_byte_buf)                                          \
-    switch (PG_FORMAT_BytesPerPixel(p_format)) {                         \
-        case 1:                                                          \
-            *((Uint8 *)p_pixels + (p_y) * p_surf->pitch + (p_x)) =       \
-                (Uint8)p_color;                                          \
-            break;                                                       \
-        case 2:                                                          \
-            *((Uint16 *)(p_pixels + (p_y) * p_surf->pitch) + (p_x)) =    \
-                (Uint16)p_color;                                         \
-            break;                                                       \
-        case 3:                                                          \
-            p_byte_buf =                                                 \
-                (Uint8 *)(p_pixels + (p_y) * p_surf->pitch) + (p_x) * 3; \
-            *(p_byte_buf + (p_format->Rshift >> 3)) =                    \
-                (Uint8)(p_color >> p_format->Rshift);                    \
-            *(p_byte_buf + (p_format->Gshift >> 3)) =                    \
-                (Uint8)(p_color >> p_format->Gshift);                    \
-            *(p_byte_buf + (p_format->Bshift >> 3)) =                    \
-                (Uint8)(p_color >> p_format->Bshift);                    \
-            break;                                                       \
-        default:                                                         \
-            *((Uint32 *)(p_pixels + (p_y) * p_surf->pitch) + (p_x)) =    \
-                p_color;                                                 \
-            break;                                                       \
+    if (!_get_factor(factorobj, &scale, &scaley)) {
+        return NULL;
     }
 
-#else
+    surf = pgSurface_AsSurface(surfobj);
+    SURF_INIT_CHECK(surf)
 
-#define SURF_SET_AT(p_color, p_surf, p_x, p_y, p_pixels, p_format,       \
-                    p_byte_buf)                                          \
-    switch (PG_FORMAT_BytesPerPixel(p_format)) {                         \
-        case 1:                                                          \
-            *((Uint8 *)p_pixels + (p_y) * p_surf->pitch + (p_x)) =       \
-                (Uint8)p_color;                                          \
-            break;                                                       \
-        case 2:                                                          \
-            *((Uint16 *)(p_pixels + (p_y) * p_surf->pitch) + (p_x)) =    \
-                (Uint16)p_color;                                         \
-            break;                                                       \
-        case 3:                                                          \
-            p_byte_buf =                                                 \
-                (Uint8 *)(p_pixels + (p_y) * p_surf->pitch) + (p_x) * 3; \
-            *(p_byte_buf + 2 - (p_format->Rshift >> 3)) =                \
-                (Uint8)(p_color >> p_format->Rshift);                    \
-            *(p_byte_buf + 2 - (p_format->Gshift >> 3)) =                \
-                (Uint8)(p_color >> p_format->Gshift);                    \
-            *(p_byte_buf + 2 - (p_format->Bshift >> 3)) =                \
-                (Uint8)(p_color >> p_format->Bshift);                    \
-            break;                                                       \
-        default:                                                         \
-            *((Uint32 *)(p_pixels + (p_y) * p_surf->pitch) + (p_x)) =    \
-                p_color;                                                 \
-            break;                                                       \
+    newsurf = smoothscale_to(self, surfobj, surfobj2, (int)(surf->w * scale),
+                             (int)(surf->h * scaley));
+    if (!newsurf) {
+        return NULL;
     }
 
-#endif
+    if (surfobj2) {
+        pgSurface_AddDirtyRect(surfobj2, NULL);
+        Py_INCREF(surfobj2);
+        return (PyObject *)surfobj2;
+    }
+    else {
+        return (PyObject *)pgSurface_New(newsurf);
+    }
+}
 
-void
-grayscale_non_simd(SDL_Surface *src, PG_PixelFormat *src_format,
-                   SDL_Surface *newsurf, PG_PixelFormat *newsurf_format)
+static PyObject *
+surf_get_smoothscale_backend(PyObject *self, PyObject *_null)
 {
-    SDL_Palette *src_palette = PG_GetSurfacePalette(src);
-    SDL_Palette *newsurf_palette = PG_GetSurfacePalette(newsurf);
+    return PyUnicode_FromString(GETSTATE(self)->filter_type);
+}
 
-    for (int y = 0; y < src->h; y++) {
-        for (int x = 0; x < src->w; x++) {
-            Uint32 pixel;
-            Uint8 *pix;
-            SURF_GET_AT(pixel, src, x, y, (Uint8 *)src->pixels, src_format,
-                        pix);
-            Uint8 r, g, b, a;
-            PG_GetRGBA(pixel, src_format, src_palette, &r, &g, &b, &a);
+static PyObject *
+surf_set_smoothscale_backend(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+    struct _module_state *st = GETSTATE(self);
+    char *keywords[] = {"backend", NULL};
+    const char *type;
 
-            /* RGBA to GRAY formula used by OpenCV
-             * We are using a bitshift and integer addition to align the
-             * calculation with what is fastest for SIMD operations.
-             * Results are almost identical to floating point multiplication.
-             */
-            Uint8 grayscale_pixel =
-                (Uint8)((((76 * r) + 255) >> 8) + (((150 * g) + 255) >> 8) +
-                        (((29 * b) + 255) >> 8));
-            Uint32 new_pixel =
-                PG_MapRGBA(newsurf_format, newsurf_palette, grayscale_pixel,
-                           grayscale_pixel, grayscale_pixel, a);
-            SURF_SET_AT(new_pixel, newsurf, x, y, (Uint8 *)newsurf->pixels,
-                        newsurf_format, pix);
-        }
-    }
-}
+#ifdef _MSC_VER
+    /* MSVC static analyzer false alarm: assure type is NULL-terminated by
+     * making analyzer assume it was initialised */
+    __analysis_assume(type = "inited");
+#endif
 
-SDL_Surface *
-grayscale(pgSurfaceObject *srcobj, pgSurfaceObject *dstobj)
-{
-    SDL_Surface *src = pgSurface_AsSurface(srcobj);
-    SDL_Surface *newsurf;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "s", keywords, &type)) {
+        return NULL;
+    }
 
-    if (!dstobj) {
-        newsurf = newsurf_fromsurf(src, srcobj->surf->w, srcobj->surf->h);
-        if (!newsurf) {
+    if (strcmp(type, "GENERIC") == 0) {
+        st->filter_type = "GENERIC";
+        st->filter_shrink_X = filter_shrink_X_ONLYC;
+        st->filter_shrink_Y = filter_shrink_Y_ONLYC;
+        st->filter_expand_X = filter_expand_X_ONLYC;
+        st->filter_expand_Y = filter_expand_Y_ONLYC;
+    }
+#if defined(SCALE_MMX_SUPPORT)
+    else if (strcmp(type, "MMX") == 0) {
+        if (!SDL_HasMMX()) {
+            return RAISE(PyExc_ValueError,
+                         "MMX not supported on this machine");
+        }
+        if (PyErr_WarnEx(
+                PyExc_DeprecationWarning,
+                "MMX backend is deprecated in favor of new SSE2 backend",
+                1) == -1) {
             return NULL;
         }
+        st->filter_type = "MMX";
+        st->filter_shrink_X = filter_shrink_X_MMX;
+        st->filter_shrink_Y = filter_shrink_Y_MMX;
+        st->filter_expand_X = filter_expand_X_MMX;
+        st->filter_expand_Y = filter_expand_Y_MMX;
     }
-    else {
-        newsurf = pgSurface_AsSurface(dstobj);
+    else if (strcmp(type, "SSE") == 0) {
+        if (!SDL_HasSSE()) {
+            return RAISE(PyExc_ValueError,
+                         "SSE not supported on this machine");
+        }
+        if (PyErr_WarnEx(
+                PyExc_DeprecationWarning,
+                "SSE backend is deprecated in favor of new SSE2 backend",
+                1) == -1) {
+            return NULL;
+        }
+        st->filter_type = "SSE";
+        st->filter_shrink_X = filter_shrink_X_SSE;
+        st->filter_shrink_Y = filter_shrink_Y_SSE;
+        st->filter_expand_X = filter_expand_X_SSE;
+        st->filter_expand_Y = filter_expand_Y_SSE;
     }
-
-    if (newsurf->w != src->w || newsurf->h != src->h) {
-        return (SDL_Surface *)(RAISE(
-            PyExc_ValueError,
-            "Destination surface must be the same size as source surface."));
+#else
+    else if (strcmp(st->filter_type, "MMX") == 0 ||
+             strcmp(st->filter_type, "SSE") == 0) {
+        return PyErr_Format(PyExc_ValueError,
+                            "%s not supported on this machine", type);
     }
-
-    if (PG_SURF_BytesPerPixel(src) != PG_SURF_BytesPerPixel(newsurf)) {
-        return (SDL_Surface *)(RAISE(
-            PyExc_ValueError,
-            "Source and destination surfaces need the same format."));
+#endif /* ~defined(SCALE_MMX_SUPPORT) */
+#if !defined(__EMSCRIPTEN__)
+    else if (strcmp(type, "AVX2") == 0) {
+        if (!pg_has_avx2()) {
+            return RAISE(PyExc_ValueError,
+                         "AVX2 not supported on this machine");
+        }
+        st->filter_type = "AVX2";
+        st->filter_shrink_X = filter_shrink_X_AVX2;
+        st->filter_shrink_Y = filter_shrink_Y_AVX2;
+        st->filter_expand_X = filter_expand_X_AVX2;
+        st->filter_expand_Y = filter_expand_Y_AVX2;
     }
-
-    PG_PixelFormat *src_format = PG_GetSurfaceFormat(src);
-    PG_PixelFormat *newsurf_format = PG_GetSurfaceFormat(newsurf);
-    if (src_format == NULL || newsurf_format == NULL) {
-        return (SDL_Surface *)(RAISE(pgExc_SDLError, SDL_GetError()));
+#if PG_ENABLE_SSE_NEON
+    else if (strcmp(type, "SSE2") == 0) {
+        if (!SDL_HasSSE2()) {
+            return RAISE(PyExc_ValueError,
+                         "SSE2 not supported on this machine");
+        }
+        st->filter_type = "SSE2";
+        st->filter_shrink_X = filter_shrink_X_SSE2;
+        st->filter_shrink_Y = filter_shrink_Y_SSE2;
+        st->filter_expand_X = filter_expand_X_SSE2;
+        st->filter_expand_Y = filter_expand_Y_SSE2;
     }
 
-#if defined(__EMSCRIPTEN__)
-    grayscale_non_simd(src, src_format, newsurf, newsurf_format);
-#else  // !defined(__EMSCRIPTEN__)
-    if (PG_FORMAT_BytesPerPixel(src_format) == 4 &&
-        src_format->Rmask == newsurf_format->Rmask &&
-        src_format->Gmask == newsurf_format->Gmask &&
-        src_format->Bmask == newsurf_format->Bmask && (src->pitch % 4 == 0) &&
-        (newsurf->pitch == (newsurf->w * 4))) {
-        if (pg_has_avx2()) {
-            grayscale_avx2(src, src_format, newsurf);
-        }
-#if defined(__SSE2__) || defined(PG_ENABLE_ARM_NEON)
-        else if (pg_HasSSE_NEON()) {
-            grayscale_sse2(src, src_format, newsurf);
-        }
-#endif  // defined(__SSE2__) || defined(PG_ENABLE_ARM_NEON)
-        else {
-            grayscale_non_simd(src, src_format, newsurf, newsurf_format);
+    else if (strcmp(type, "NEON") == 0) {
+        if (!SDL_HasNEON()) {
+            return RAISE(PyExc_ValueError,
+                         "NEON not supported on this machine");
         }
+        st->filter_type = "NEON";
+#if PG_ENABLE_NATIVE_NEON
+        st->filter_shrink_X = filter_shrink_X_NEON;
+        st->filter_shrink_Y = filter_shrink_Y_NEON;
+        st->filter_expand_X = filter_expand_X_NEON;
+        st->filter_expand_Y = filter_expand_Y_NEON;
+#else
+        st->filter_shrink_X = filter_shrink_X_SSE2;
+        st->filter_shrink_Y = filter_shrink_Y_SSE2;
+        st->filter_expand_X = filter_expand_X_SSE2;
+        st->filter_expand_Y = filter_expand_Y_SSE2;
+#endif /* PG_ENABLE_NATIVE_NEON */
     }
+#endif /* PG_ENABLE_SSE_NEON */
+#endif /* !__EMSCRIPTEN__ */
     else {
-        grayscale_non_simd(src, src_format, newsurf, newsurf_format);
+        return PyErr_Format(PyExc_ValueError, "Unknown backend type %s", type);
     }
-#endif  // !defined(__EMSCRIPTEN__)
-
-    SDL_UnlockSurface(newsurf);
-
-    return newsurf;
+    Py_RETURN_NONE;
 }
 
-static PyObject *
-surf_grayscale(PyObject *self, PyObject *args, PyObject *kwargs)
-{
-    pgSurfaceObject *surfobj;
-    pgSurfaceObject *surfobj2 = NULL;
-    SDL_Surface *newsurf;
+/* _get_color_move_pixels is for iterating over pixels in a Surface.
 
-    static char *keywords[] = {"surface", "dest_surface", NULL};
+    bpp - bytes per pixel
+    the_color - is set for that pixel
+    pixels - pointer is advanced by one pixel.
+ */
+static PG_INLINE Uint8 *
+_get_color_move_pixels(Uint8 bpp, Uint8 *pixels, Uint32 *the_color)
+{
+    Uint8 *pix;
+    // printf("bpp:%i, pixels:%p\n", bpp, pixels);
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!|O!", keywords,
-                                     &pgSurface_Type, &surfobj,
-                                     &pgSurface_Type, &surfobj2)) {
-        return NULL;
+    switch (bpp) {
+        case 1:
+            *the_color = (Uint32) * ((Uint8 *)pixels);
+            return pixels + 1;
+        case 2:
+            *the_color = (Uint32) * ((Uint16 *)pixels);
+            return pixels + 2;
+        case 3:
+            pix = ((Uint8 *)pixels);
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+            *the_color = (pix[0]) + (pix[1] << 8) + (pix[2] << 16);
+#else
+            *the_color = (pix[2]) + (pix[1] << 8) + (pix[0] << 16);
+#endif
+            return pixels + 3;
+        default: /* case 4: */
+            *the_color = *((Uint32 *)pixels);
+            return pixels + 4;
     }
+    // printf("---bpp:%i, pixels:%p\n", bpp, pixels);
+}
 
-    newsurf = grayscale(surfobj, surfobj2);
+/* _set_at_pixels sets the pixel to the_color.
 
-    if (!newsurf) {
-        return NULL;
-    }
+    x - x pos in the SDL_Surface pixels.
+    y - y pos in the SDL_Surface pixels.
+    format - of the SDL_Surface pixels.
+    pitch - of the SDL_Surface.
+    the_color - to set in the pixels at this position.
+*/
+static PG_INLINE void
+_set_at_pixels(int x, int y, Uint8 *pixels, PG_PixelFormat *format,
+               int surf_pitch, Uint32 the_color)
+{
+    Uint8 *byte_buf;
 
-    if (surfobj2) {
-        Py_INCREF(surfobj2);
-        return (PyObject *)surfobj2;
-    }
-    else {
-        return (PyObject *)pgSurface_New(newsurf);
+    switch (PG_FORMAT_BytesPerPixel(format)) {
+        case 1:
+            *((Uint8 *)pixels + y * surf_pitch + x) = (Uint8)the_color;
+            break;
+        case 2:
+            *((Uint16 *)(pixels + y * surf_pitch) + x) = (Uint16)the_color;
+            break;
+        case 3:
+            byte_buf = (Uint8 *)(pixels + y * surf_pitch) + x * 3;
+#if (SDL_BYTEORDER == SDL_LIL_ENDIAN)
+            *(byte_buf + (format->Rshift >> 3)) = (Uint8)(the_color >> 16);
+            *(byte_buf + (format->Gshift >> 3)) = (Uint8)(the_color >> 8);
+            *(byte_buf + (format->Bshift >> 3)) = (Uint8)the_color;
+#else
+            *(byte_buf + 2 - (format->Rshift >> 3)) = (Uint8)(the_color >> 16);
+            *(byte_buf + 2 - (format->Gshift >> 3)) = (Uint8)(the_color >> 8);
+            *(byte_buf + 2 - (format->Bshift >> 3)) = (Uint8)the_color;
+#endif
+            break;
+        default: /* case 4: */
+            *((Uint32 *)(pixels + y * surf_pitch) + x) = the_color;
+            break;
     }
 }
 
-SDL_Surface *
-solid_overlay(pgSurfaceObject *srcobj, Uint32 color, pgSurfaceObject *dstobj,
-              const int keep_alpha)
+static int
+get_threshold(SDL_Surface *dest_surf, PG_PixelFormat *dest_fmt,
+              SDL_Surface *surf, PG_PixelFormat *surf_fmt,
+              SDL_Palette *surf_palette, Uint32 color_search_color,
+              Uint32 color_threshold, Uint32 color_set_color, int set_behavior,
+              SDL_Surface *search_surf, PG_PixelFormat *search_surf_fmt,
+              SDL_Palette *search_surf_palette, int inverse_set)
 {
-    SDL_Surface *src = pgSurface_AsSurface(srcobj);
-    SDL_Surface *newsurf;
-    Uint8 a;
-
-    if (!dstobj) {
-        newsurf = newsurf_fromsurf(src, srcobj->surf->w, srcobj->surf->h);
-        if (!newsurf) {
-            return NULL;
-        }
-    }
-    else {
-        newsurf = pgSurface_AsSurface(dstobj);
-    }
-
-    if (newsurf->w != src->w || newsurf->h != src->h) {
-        return (SDL_Surface *)(RAISE(
-            PyExc_ValueError,
-            "Destination surface must be the same size as source surface."));
-    }
+    int x, y, similar;
+    Uint8 *pixels, *destpixels = NULL, *pixels2 = NULL;
+    Uint32 the_color, the_color2, dest_set_color;
+    Uint8 search_color_r, search_color_g, search_color_b;
+    Uint8 surf_r, surf_g, surf_b;
+    Uint8 threshold_r, threshold_g, threshold_b;
+    Uint8 search_surf_r, search_surf_g, search_surf_b;
 
-    PG_PixelFormat *fmt, *newsurf_format;
-    SDL_Palette *src_palette, *newsurf_palette;
-    if (!PG_GetSurfaceDetails(src, &fmt, &src_palette) ||
-        !PG_GetSurfaceDetails(newsurf, &newsurf_format, &newsurf_palette)) {
-        return (SDL_Surface *)(RAISE(pgExc_SDLError, SDL_GetError()));
-    }
+    int within_threshold;
 
-    if (fmt->format != newsurf_format->format) {
-        return (SDL_Surface *)(RAISE(
-            PyExc_ValueError,
-            "Source and destination surfaces need the same format."));
-    }
+    similar = 0;
 
-    /* If the source surface has no alpha channel, we can't overlay with alpha
-     * blending. */
-    if (!SDL_ISPIXELFORMAT_ALPHA(fmt->format)) {
-        return newsurf;
+    if (set_behavior) {
+        destpixels = (Uint8 *)dest_surf->pixels;
     }
-
-    /* If we are keeping the src alpha, then we need to remove the alpha from
-     * the color so it's easier to add the base pixel alpha back in */
-    if (keep_alpha) {
-        color &= ~fmt->Amask;
+    if (search_surf) {
+        pixels2 = (Uint8 *)search_surf->pixels;
     }
 
-    int src_lock = SDL_MUSTLOCK(src);
-    int dst_lock = src != newsurf && SDL_MUSTLOCK(newsurf);
+    PG_GetRGB(color_search_color, surf_fmt, surf_palette, &search_color_r,
+              &search_color_g, &search_color_b);
+    PG_GetRGB(color_threshold, surf_fmt, surf_palette, &threshold_r,
+              &threshold_g, &threshold_b);
 
-    if (src_lock && !PG_LockSurface(src)) {
-        return NULL;
-    }
-    if (dst_lock && !PG_LockSurface(newsurf)) {
-        if (src_lock) {
-            SDL_UnlockSurface(src);
+    for (y = 0; y < surf->h; y++) {
+        pixels = (Uint8 *)surf->pixels + y * surf->pitch;
+        if (search_surf) {
+            pixels2 = (Uint8 *)search_surf->pixels + y * search_surf->pitch;
         }
-        return NULL;
-    }
 
-    /* optimized path for 32 bit surfaces */
-    if (PG_FORMAT_BytesPerPixel(fmt) == 4) {
-        /* This algorithm iterates over each pixel's alpha channel. If it's not
-         * zero, the pixel is set to the desired color. If the keep_alpha flag
-         * is set, the original alpha value is retained, allowing the overlay
-         * color to inherit the surface pixel's alpha value. */
-#if SDL_BYTEORDER == SDL_LIL_ENDIAN
-        const int dst_ashift = fmt->Ashift;
-        const char _a_off = fmt->Ashift >> 3;
-#else
-        const int dst_ashift = 24 - newsurf->format->Ashift;
-        const char _a_off = 3 - (newsurf->format->Ashift >> 3);
-#endif
-
-        Uint8 *srcp = (Uint8 *)src->pixels + _a_off;
-        Uint32 *dstp = (Uint32 *)newsurf->pixels;
+        for (x = 0; x < surf->w; x++) {
+            pixels = _get_color_move_pixels(PG_SURF_BytesPerPixel(surf),
+                                            pixels, &the_color);
+            PG_GetRGB(the_color, surf_fmt, surf_palette, &surf_r, &surf_g,
+                      &surf_b);
 
-        const int src_skip = src->pitch - src->w * 4;
-        const int dst_skip = newsurf->pitch / 4 - newsurf->w;
-        int n, height = src->h;
+            if (search_surf) {
+                /* Get search_surf.color */
+                pixels2 = _get_color_move_pixels(
+                    PG_SURF_BytesPerPixel(search_surf), pixels2, &the_color2);
+                PG_GetRGB(the_color2, search_surf_fmt, search_surf_palette,
+                          &search_surf_r, &search_surf_g, &search_surf_b);
 
-        if (srcobj == dstobj) {
-            if (!keep_alpha) {
-                while (height--) {
-                    LOOP_UNROLLED4(
-                        {
-                            if (*srcp) {
-                                *dstp = color;
-                            }
-                            srcp += 4;
-                            dstp++;
-                        },
-                        n, src->w);
-                    srcp += src_skip;
-                    dstp += dst_skip;
-                }
+                /* search_surf(the_color2) is within threshold of
+                 * surf(the_color) */
+                within_threshold =
+                    ((abs((int)search_surf_r - (int)surf_r) <= threshold_r) &&
+                     (abs((int)search_surf_g - (int)surf_g) <= threshold_g) &&
+                     (abs((int)search_surf_b - (int)surf_b) <= threshold_b));
+                dest_set_color =
+                    ((set_behavior == 2) ? the_color2 : color_set_color);
             }
             else {
-                while (height--) {
-                    LOOP_UNROLLED4(
-                        {
-                            if ((a = *srcp)) {
-                                *dstp = color | (a << dst_ashift);
-                            }
-                            srcp += 4;
-                            dstp++;
-                        },
-                        n, src->w);
-                    srcp += src_skip;
-                    dstp += dst_skip;
-                }
+                /* search_color within threshold of surf.the_color */
+                // printf("rgb: %i,%i,%i\n", surf_r, surf_g, surf_b);
+                within_threshold =
+                    ((abs((int)search_color_r - (int)surf_r) <= threshold_r) &&
+                     (abs((int)search_color_g - (int)surf_g) <= threshold_g) &&
+                     (abs((int)search_color_b - (int)surf_b) <= threshold_b));
+                dest_set_color =
+                    ((set_behavior == 2) ? the_color : color_set_color);
             }
-        }
-        else {
-            if (!keep_alpha) {
-                while (height--) {
-                    LOOP_UNROLLED4(
-                        {
-                            if (*srcp) {
-                                *dstp = color;
-                            }
-                            srcp += 4;
-                            dstp++;
-                        },
-                        n, src->w);
-                    srcp += src_skip;
-                    dstp += dst_skip;
-                }
+
+            if (within_threshold) {
+                similar++;
             }
-            else {
-                while (height--) {
-                    LOOP_UNROLLED4(
-                        {
-                            if ((a = *srcp)) {
-                                *dstp = color | (a << dst_ashift);
-                            }
-                            srcp += 4;
-                            dstp++;
-                        },
-                        n, src->w);
-                    srcp += src_skip;
-                    dstp += dst_skip;
-                }
+            if (set_behavior && ((within_threshold && inverse_set) ||
+                                 (!within_threshold && !inverse_set))) {
+                _set_at_pixels(x, y, destpixels, dest_fmt, dest_surf->pitch,
+                               dest_set_color);
             }
         }
     }
-    else /* path for 16 bit surfaces */
-    {
-        int x, y;
-        Uint8 r, g, b;
-        Uint16 *src_row = (Uint16 *)src->pixels;
-        Uint16 *dst_row = (Uint16 *)newsurf->pixels;
-        const int src_skip = src->pitch / 2 - src->w;
-        const int dst_skip = newsurf->pitch / 2 - newsurf->w;
-
-        Uint8 Cr, Cg, Cb, Ca;
-        PG_GetRGBA(color, fmt, src_palette, &Cr, &Cg, &Cb, &Ca);
-        const Uint16 color16 = (Uint16)PG_MapRGBA(
-            newsurf_format, newsurf_palette, Cr, Cg, Cb, Ca);
-
-        for (y = 0; y < src->h; y++) {
-            for (x = 0; x < src->w; x++) {
-                PG_GetRGBA((Uint32)*src_row, fmt, src_palette, &r, &g, &b, &a);
+    return similar;
+}
 
-                if (a) {
-                    if (keep_alpha) {
-                        *dst_row = (Uint16)PG_MapRGBA(
-                            newsurf_format, newsurf_palette, Cr, Cg, Cb, a);
-                    }
-                    else {
-                        *dst_row = color16;
-                    }
-                }
+/* _color_from_obj gets a color from a python object.
 
-                src_row++;
-                dst_row++;
-            }
-            src_row += src_skip;
-            dst_row += dst_skip;
+Returns 0 if ok, and sets color to the color.
+   -1 means error.
+   If color_obj is NULL, use rgba_default.
+   If rgba_default is NULL, do not use a default color, return -1.
+*/
+int
+_color_from_obj(PyObject *color_obj, SDL_Surface *surf, Uint8 rgba_default[4],
+                Uint32 *color)
+{
+    if (color_obj) {
+        if (!pg_MappedColorFromObj(color_obj, surf, color,
+                                   PG_COLOR_HANDLE_ALL)) {
+            return -1;
         }
     }
+    else {
+        if (!rgba_default) {
+            return -1;
+        }
 
-    if (src_lock) {
-        SDL_UnlockSurface(src);
-    }
-    if (dst_lock) {
-        SDL_UnlockSurface(newsurf);
+        PG_PixelFormat *surf_format;
+        SDL_Palette *surf_palette;
+        if (!PG_GetSurfaceDetails(surf, &surf_format, &surf_palette)) {
+            return -1;
+        }
+        *color = PG_MapRGBA(surf_format, surf_palette, rgba_default[0],
+                            rgba_default[1], rgba_default[2], rgba_default[3]);
     }
-
-    return newsurf;
+    return 0;
 }
 
 static PyObject *
-surf_solid_overlay(PyObject *self, PyObject *args, PyObject *kwargs)
+surf_threshold(PyObject *self, PyObject *args, PyObject *kwds)
 {
-    pgSurfaceObject *surfobj;
-    PyObject *colorobj;
-    Uint32 color;
+    PyObject *dest_surf_obj;
+    SDL_Surface *dest_surf = NULL;
 
-    pgSurfaceObject *surfobj2 = NULL;
-    SDL_Surface *newsurf;
-    SDL_Surface *surf;
-    int keep_alpha = 0;
+    pgSurfaceObject *surf_obj;
+    SDL_Surface *surf = NULL;
 
-    static char *keywords[] = {"surface", "color", "dest_surface",
-                               "keep_alpha", NULL};
+    PyObject *search_color_obj;
+    PyObject *threshold_obj = NULL;
+    PyObject *set_color_obj = NULL;
+    int set_behavior = 1;
+    int inverse_set = 0;
+    PyObject *search_surf_obj = NULL;
+    SDL_Surface *search_surf = NULL;
 
-    if (!PyArg_ParseTupleAndKeywords(
-            args, kwargs, "O!O|O!i", keywords, &pgSurface_Type, &surfobj,
-            &colorobj, &pgSurface_Type, &surfobj2, &keep_alpha)) {
-        return NULL;
-    }
+    Uint8 rgba_threshold_default[4] = {0, 0, 0, 255};
+    Uint8 rgba_set_color_default[4] = {0, 0, 0, 255};
 
-    surf = pgSurface_AsSurface(surfobj);
+    Uint32 color_search_color = 0;
+    Uint32 color_threshold = 0;
+    Uint32 color_set_color = 0;
 
-    if (!pg_MappedColorFromObj(colorobj, surf, &color, PG_COLOR_HANDLE_ALL)) {
-        return RAISE(PyExc_TypeError, "invalid color argument");
-    }
+    int num_threshold_pixels = 0;
 
-    newsurf = solid_overlay(surfobj, color, surfobj2, keep_alpha);
+    /*
+    https://pyga.me/docs/ref/transform.html#pygame.transform.threshold
 
-    if (!newsurf) {
+    Returns the number of pixels within the threshold.
+    */
+    static char *kwlist[] = {
+        "dest_surface", /* Surface we are changing. See 'set_behavior'.
+                          None - if counting (set_behavior is 0),
+                                 don't need 'dest_surf'. */
+        "surface",      /* Surface we are looking at. */
+        "search_color", /* Color we are searching for. */
+        "threshold",    /* =(0,0,0,0)  Within this distance from
+                                       search_color (or search_surf). */
+        "set_color",    /* =(0,0,0,0)  Color we set. */
+        "set_behavior", /* =1 What and where we set pixels (if at all)
+                             1 - pixels in dest_surface will be changed
+                                 to 'set_color'.
+                             0 - we do not change 'dest_surf', just count.
+                                 Make dest_surf=None.
+                             2 - pixels set in 'dest_surf' will be from
+                           'surface'.
+                        */
+        "search_surf",  /* =None If set, compare to this surface.
+                             None - search against 'search_color' instead.
+                             Surface - look at the color in here rather
+                                       than 'search_color'.
+                        */
+        "inverse_set",  /* =False.
+                             False - pixels outside of threshold are changed.
+                             True - pixels within threshold are changed.
+                        */
+        0};
+
+    /* Get all arguments into our variables.
+
+    https://docs.python.org/3/c-api/arg.html#c.PyArg_ParseTupleAndKeywords
+    https://docs.python.org/3/c-api/arg.html#parsing-arguments
+    */
+
+    if (!PyArg_ParseTupleAndKeywords(
+            args, kwds, "OO!O|OOiOi", kwlist,
+            /* required */
+            &dest_surf_obj,             /* O python object from c type  */
+            &pgSurface_Type, &surf_obj, /* O! python object from c type */
+            &search_color_obj, /* O| python object. All after | optional. */
+            /* optional */
+            &threshold_obj,   /* O  python object. */
+            &set_color_obj,   /* O  python object. */
+            &set_behavior,    /* i  plain python int. */
+            &search_surf_obj, /* O python object. */
+            &inverse_set)) {  /* i  plain python int. */
         return NULL;
     }
 
-    if (surfobj2) {
-        Py_INCREF(surfobj2);
-        return (PyObject *)surfobj2;
+    if (set_behavior == 0 &&
+        !(set_color_obj == NULL || set_color_obj == Py_None)) {
+        return RAISE(PyExc_TypeError,
+                     "if set_behavior==0 set_color should be None");
     }
-    else {
-        return (PyObject *)pgSurface_New(newsurf);
+    if (set_behavior == 0 && dest_surf_obj != Py_None) {
+        return RAISE(PyExc_TypeError,
+                     "if set_behavior==0 dest_surf_obj should be None");
     }
-}
-
-#define MIN3(a, b, c) MIN(MIN(a, b), c)
-#define MAX3(a, b, c) MAX(MAX(a, b), c)
 
-/* Following hsl code is based on code from
- * https://gist.github.com/ciembor/1494530
- * and
- * http://en.wikipedia.org/wiki/HSL_color_space
- */
-static PG_FORCEINLINE void
-RGB_to_HSL(Uint8 r, Uint8 g, Uint8 b, float *h, float *s, float *l)
-{
-    float r_1 = r / 255.0f;
-    float g_1 = g / 255.0f;
-    float b_1 = b / 255.0f;
+    if (dest_surf_obj && dest_surf_obj != Py_None &&
+        pgSurface_Check(dest_surf_obj)) {
+        dest_surf = pgSurface_AsSurface(dest_surf_obj);
+    }
+    else if (set_behavior != 0) {
+        return RAISE(
+            PyExc_TypeError,
+            "argument 1 must be pygame.Surface, or None with set_behavior=1");
+    }
 
-    float min = MIN3(r_1, g_1, b_1);
-    float max = MAX3(r_1, g_1, b_1);
-    float delta = max - min;
+    surf = pgSurface_AsSurface(surf_obj);
+    if (NULL == surf) {
+        return RAISE(PyExc_TypeError, "invalid surf argument");
+    }
 
-    *l = (max + min) / 2.0f;
+    if (search_surf_obj && pgSurface_Check(search_surf_obj)) {
+        search_surf = pgSurface_AsSurface(search_surf_obj);
+    }
 
-    if (delta == 0) {
-        *h = *s = 0;  // achromatic
+    if (search_surf && search_color_obj != Py_None) {
+        return RAISE(PyExc_TypeError,
+                     "if search_surf is used, search_color should be None");
     }
-    else {
-        *s = *l > 0.5f ? delta / (2.0f - max - min) : delta / (max + min);
 
-        if (max == r_1) {
-            *h = (g_1 - b_1) / delta + (g_1 < b_1 ? 6 : 0);
-        }
-        else if (max == g_1) {
-            *h = (b_1 - r_1) / delta + 2;
-        }
-        else {
-            *h = (r_1 - g_1) / delta + 4;
-        }
-        *h /= 6;
+    if (set_behavior == 2 && set_color_obj != Py_None) {
+        return RAISE(PyExc_TypeError,
+                     "if set_behavior==2 set_color should be None");
     }
-}
 
-static PG_FORCEINLINE float
-hue_to_rgb(float p, float q, float t)
-{
-    if (t < 0) {
-        t += 1;
+    if (search_color_obj != Py_None) {
+        if (_color_from_obj(search_color_obj, surf, NULL,
+                            &color_search_color)) {
+            return RAISE(PyExc_TypeError, "invalid search_color argument");
+        }
     }
-    if (t > 1) {
-        t -= 1;
+    if (_color_from_obj(threshold_obj, surf, rgba_threshold_default,
+                        &color_threshold)) {
+        return RAISE(PyExc_TypeError, "invalid threshold argument");
     }
-    if (t < 1 / 6.0f) {
-        return p + (q - p) * 6 * t;
+
+    if (set_color_obj != Py_None) {
+        if (_color_from_obj(set_color_obj, surf, rgba_set_color_default,
+                            &color_set_color)) {
+            return RAISE(PyExc_TypeError, "invalid set_color argument");
+        }
     }
-    if (t < 1 / 2.0f) {
-        return q;
+
+    if (dest_surf && (surf->h != dest_surf->h || surf->w != dest_surf->w)) {
+        return RAISE(PyExc_TypeError, "surf and dest_surf not the same size");
     }
-    if (t < 2 / 3.0f) {
-        return p + (q - p) * (2 / 3.0f - t) * 6;
+
+    if (search_surf &&
+        (surf->h != search_surf->h || surf->w != search_surf->w)) {
+        return RAISE(PyExc_TypeError,
+                     "surf and search_surf not the same size");
     }
-    return p;
-}
 
-static PG_FORCEINLINE void
-HSL_to_RGB(float h, float s, float l, Uint8 *r, Uint8 *g, Uint8 *b)
-{
-    if (s == 0) {
-        *r = *g = *b = (Uint8)(l * 255);
+    PG_PixelFormat *dest_fmt = NULL;
+    if (dest_surf) {
+        dest_fmt = PG_GetSurfaceFormat(dest_surf);
+        if (dest_fmt == NULL) {
+            return RAISE(pgExc_SDLError, SDL_GetError());
+        }
     }
-    else {
-        float q = l < 0.5f ? l * (1 + s) : l + s - l * s;
-        float p = 2 * l - q;
-        *r = (Uint8)(hue_to_rgb(p, q, h + 1 / 3.0f) * 255);
-        *g = (Uint8)(hue_to_rgb(p, q, h) * 255);
-        *b = (Uint8)(hue_to_rgb(p, q, h - 1 / 3.0f) * 255);
+
+    PG_PixelFormat *surf_format;
+    SDL_Palette *surf_palette;
+    if (!PG_GetSurfaceDetails(surf, &surf_format, &surf_palette)) {
+        return RAISE(pgExc_SDLError, SDL_GetError());
     }
-}
 
-static void
-modify_hsl(SDL_Surface *surf, PG_PixelFormat *fmt, SDL_Surface *dst,
-           PG_PixelFormat *dst_format, float h, float s, float l)
-{
-    int surf_locked = 0;
-    if (SDL_MUSTLOCK(surf)) {
-        if (PG_LockSurface(surf)) {
-            surf_locked = 1;
+    PG_PixelFormat *search_surf_format = NULL;
+    SDL_Palette *search_surf_palette = NULL;
+    if (search_surf) {
+        if (!PG_GetSurfaceDetails(search_surf, &search_surf_format,
+                                  &search_surf_palette)) {
+            return RAISE(pgExc_SDLError, SDL_GetError());
         }
     }
-    int dst_locked = 0;
-    if (SDL_MUSTLOCK(dst)) {
-        if (PG_LockSurface(dst)) {
-            dst_locked = 1;
-        }
+
+    if (dest_surf) {
+        pgSurface_Lock((pgSurfaceObject *)dest_surf_obj);
+    }
+    pgSurface_LockRead(surf_obj);
+    if (search_surf) {
+        pgSurface_LockRead((pgSurfaceObject *)search_surf_obj);
     }
 
-    int x, y;
-    Uint8 r, g, b, a;
-    float s_h = 0, s_s = 0, s_l = 0;
-    Uint8 *srcp8 = (Uint8 *)surf->pixels;
-    Uint8 *dstp8 = (Uint8 *)dst->pixels;
-    SDL_Palette *surf_palette = PG_GetSurfacePalette(surf);
-    SDL_Palette *dst_palette = PG_GetSurfacePalette(dst);
+    Py_BEGIN_ALLOW_THREADS;
+    num_threshold_pixels = get_threshold(
+        dest_surf, dest_fmt, surf, surf_format, surf_palette,
+        color_search_color, color_threshold, color_set_color, set_behavior,
+        search_surf, search_surf_format, search_surf_palette, inverse_set);
+    Py_END_ALLOW_THREADS;
 
-    if (PG_FORMAT_BytesPerPixel(fmt) == 4 ||
-        PG_FORMAT_BytesPerPixel(fmt) == 3) {
-        const int src_skip =
-            surf->pitch - surf->w * PG_FORMAT_BytesPerPixel(fmt);
-        const int dst_skip =
-            dst->pitch - dst->w * PG_FORMAT_BytesPerPixel(fmt);
+    if (dest_surf) {
+        pgSurface_Unlock((pgSurfaceObject *)dest_surf_obj);
+        pgSurface_AddDirtyRect((pgSurfaceObject *)dest_surf_obj, NULL);
+    }
+    pgSurface_Unlock(surf_obj);
+    if (search_surf) {
+        pgSurface_Unlock((pgSurfaceObject *)search_surf_obj);
+    }
 
-#if SDL_BYTEORDER == SDL_LIL_ENDIAN
-        const int Ridx = fmt->Rshift >> 3;
-        const int Gidx = fmt->Gshift >> 3;
-        const int Bidx = fmt->Bshift >> 3;
-        const int Aidx = fmt->Ashift >> 3;
-#else
-        const int Ridx = 3 - (fmt->Rshift >> 3);
-        const int Gidx = 3 - (fmt->Gshift >> 3);
-        const int Bidx = 3 - (fmt->Bshift >> 3);
-        const int Aidx = 3 - (fmt->Ashift >> 3);
-#endif
+    return PyLong_FromLong(num_threshold_pixels);
+}
 
-        int height = surf->h;
+/*
 
-        while (height--) {
-            for (x = 0; x < surf->w; x++) {
-                RGB_to_HSL(srcp8[Ridx], srcp8[Gidx], srcp8[Bidx], &s_h, &s_s,
-                           &s_l);
-
-                if (h) {
-                    s_h += h;
-                    if (s_h > 1) {
-                        s_h -= 1;
-                    }
-                    else if (s_h < 0) {
-                        s_h += 1;
-                    }
-                }
-                if (s) {
-                    s_s = s_s * (1 + s);
-                    s_s = s_s > 1 ? 1 : s_s < 0 ? 0 : s_s;
-                }
-                if (l) {
-                    s_l = l < 0 ? s_l * (1 + l) : s_l * (1 - l) + l;
-                    s_l = s_l > 1 ? 1 : s_l < 0 ? 0 : s_l;
-                }
+TODO:
+add_4
+sub_4
+mul_4
+clamp_4
 
-                HSL_to_RGB(s_h, s_s, s_l, &r, &g, &b);
-                dstp8[Ridx] = r;
-                dstp8[Gidx] = g;
-                dstp8[Bidx] = b;
-                if (fmt->Amask) {
-                    dstp8[Aidx] = srcp8[Aidx];
-                }
+*/
 
-                srcp8 += PG_FORMAT_BytesPerPixel(fmt);
-                dstp8 += PG_FORMAT_BytesPerPixel(fmt);
-            }
-            srcp8 += src_skip;
-            dstp8 += dst_skip;
-        }
+#define SURF_GET_AT(p_color, p_surf, p_x, p_y, p_pixels, p_format, p_pix)    \
+    switch (PG_FORMAT_BytesPerPixel(p_format)) {                             \
+        case 1:                                                              \
+            p_color = (Uint32) *                                             \
+                      ((Uint8 *)(p_pixels) + (p_y) * p_surf->pitch + (p_x)); \
+            break;                                                           \
+        case 2:                                                              \
+            p_color =                                                        \
+                (Uint32) *                                                   \
+                ((Uint16 *)((p_pixels) + (p_y) * p_surf->pitch) + (p_x));    \
+            break;                                                           \
+        case 3:                                                              \
+            p_pix =                                                          \
+                ((Uint8 *)(p_pixels + (p_y) * p_surf->pitch) + (p_x) * 3);   \
+            p_color = (SDL_BYTEORDER == SDL_LIL_ENDIAN)                      \
+                          ? (p_pix[0]) + (p_pix[1] << 8) + (p_pix[2] << 16)  \
+                          : (p_pix[2]) + (p_pix[1] << 8) + (p_pix[0] << 16); \
+            break;                                                           \
+        default: /* case 4: */                                               \
+            p_color =                                                        \
+                *((Uint32 *)(p_pixels + (p_y) * p_surf->pitch) + (p_x));     \
+            break;                                                           \
     }
-    else {
-        Uint8 *pix;
-        Uint32 pixel;
-        for (y = 0; y < surf->h; y++) {
-            for (x = 0; x < surf->w; x++) {
-                SURF_GET_AT(pixel, surf, x, y, srcp8, fmt, pix);
-                PG_GetRGBA(pixel, fmt, surf_palette, &r, &g, &b, &a);
-                RGB_to_HSL(r, g, b, &s_h, &s_s, &s_l);
 
-                if (h) {
-                    s_h += h;
-                    if (s_h > 1) {
-                        s_h -= 1;
-                    }
-                    else if (s_h < 0) {
-                        s_h += 1;
-                    }
-                }
-                if (s) {
-                    s_s = s_s * (1 + s);
-                    s_s = s_s > 1 ? 1 : s_s < 0 ? 0 : s_s;
-                }
-                if (l) {
-                    s_l = l < 0 ? s_l * (1 + l) : s_l * (1 - l) + l;
-                    s_l = s_l > 1 ? 1 : s_l < 0 ? 0 : s_l;
-                }
+#if (SDL_BYTEORDER == SDL_LIL_ENDIAN)
 
-                HSL_to_RGB(s_h, s_s, s_l, &r, &g, &b);
-                pixel = PG_MapRGBA(dst_format, dst_palette, r, g, b, a);
-                SURF_SET_AT(pixel, dst, x, y, dstp8, fmt, pix);
-            }
-        }
+#define SURF_SET_AT(p_color, p_surf, p_x, p_y, p_pixels, p_format,       \
+                    p_byte_buf)                                          \
+    switch (PG_FORMAT_BytesPerPixel(p_format)) {                         \
+        case 1:                                                          \
+            *((Uint8 *)p_pixels + (p_y) * p_surf->pitch + (p_x)) =       \
+                (Uint8)p_color;                                          \
+            break;                                                       \
+        case 2:                                                          \
+            *((Uint16 *)(p_pixels + (p_y) * p_surf->pitch) + (p_x)) =    \
+                (Uint16)p_color;                                         \
+            break;                                                       \
+        case 3:                                                          \
+            p_byte_buf =                                                 \
+                (Uint8 *)(p_pixels + (p_y) * p_surf->pitch) + (p_x) * 3; \
+            *(p_byte_buf + (p_format->Rshift >> 3)) =                    \
+                (Uint8)(p_color >> p_format->Rshift);                    \
+            *(p_byte_buf + (p_format->Gshift >> 3)) =                    \
+                (Uint8)(p_color >> p_format->Gshift);                    \
+            *(p_byte_buf + (p_format->Bshift >> 3)) =                    \
+                (Uint8)(p_color >> p_format->Bshift);                    \
+            break;                                                       \
+        default:                                                         \
+            *((Uint32 *)(p_pixels + (p_y) * p_surf->pitch) + (p_x)) =    \
+                p_color;                                                 \
+            break;                                                       \
     }
 
-    if (surf_locked) {
-        SDL_UnlockSurface(surf);
-    }
-    if (dst_locked) {
-        SDL_UnlockSurface(dst);
+#else
+
+#define SURF_SET_AT(p_color, p_surf, p_x, p_y, p_pixels, p_format,       \
+                    p_byte_buf)                                          \
+    switch (PG_FORMAT_BytesPerPixel(p_format)) {                         \
+        case 1:                                                          \
+            *((Uint8 *)p_pixels + (p_y) * p_surf->pitch + (p_x)) =       \
+                (Uint8)p_color;                                          \
+            break;                                                       \
+        case 2:                                                          \
+            *((Uint16 *)(p_pixels + (p_y) * p_surf->pitch) + (p_x)) =    \
+                (Uint16)p_color;                                         \
+            break;                                                       \
+        case 3:                                                          \
+            p_byte_buf =                                                 \
+                (Uint8 *)(p_pixels + (p_y) * p_surf->pitch) + (p_x) * 3; \
+            *(p_byte_buf + 2 - (p_format->Rshift >> 3)) =                \
+                (Uint8)(p_color >> p_format->Rshift);                    \
+            *(p_byte_buf + 2 - (p_format->Gshift >> 3)) =                \
+                (Uint8)(p_color >> p_format->Gshift);                    \
+            *(p_byte_buf + 2 - (p_format->Bshift >> 3)) =                \
+                (Uint8)(p_color >> p_format->Bshift);                    \
+            break;                                                       \
+        default:                                                         \
+            *((Uint32 *)(p_pixels + (p_y) * p_surf->pitch) + (p_x)) =    \
+                p_color;                                                 \
+            break;                                                       \
     }
-}
 
-static PyObject *
-surf_hsl(PyObject *self, PyObject *args, PyObject *kwargs)
-{
-    pgSurfaceObject *surfobj;
-    pgSurfaceObject *surfobj2 = NULL;
-    SDL_Surface *dst, *src;
-    float h = 0, s = 0, l = 0;
+#endif
 
-    static char *keywords[] = {"surface",   "hue",          "saturation",
-                               "lightness", "dest_surface", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!|fffO!", keywords,
-                                     &pgSurface_Type, &surfobj, &h, &s, &l,
-                                     &pgSurface_Type, &surfobj2)) {
-        return NULL;
-    }
+void
+grayscale_non_simd(SDL_Surface *src, PG_PixelFormat *src_format,
+                   SDL_Surface *newsurf, PG_PixelFormat *newsurf_format)
+{
+    SDL_Palette *src_palette = PG_GetSurfacePalette(src);
+    SDL_Palette *newsurf_palette = PG_GetSurfacePalette(newsurf);
 
-    if (s < -1 || s > 1) {
-        PyObject *value = PyFloat_FromDouble((double)s);
-        if (!value) {
-            return NULL;
-        }
+    for (int y = 0; y < src->h; y++) {
+        for (int x = 0; x < src->w; x++) {
+            Uint32 pixel;
+            Uint8 *pix;
+            SURF_GET_AT(pixel, src, x, y, (Uint8 *)src->pixels, src_format,
+                        pix);
+            Uint8 r, g, b, a;
+            PG_GetRGBA(pixel, src_format, src_palette, &r, &g, &b, &a);
 
-        PyErr_Format(PyExc_ValueError,
-                     "saturation value must be between -1 and 1, got %R",
-                     value);
-        Py_DECREF(value);
-        return NULL;
-    }
-    if (l < -1 || l > 1) {
-        PyObject *value = PyFloat_FromDouble((double)l);
-        if (!value) {
-            return NULL;
+            /* RGBA to GRAY formula used by OpenCV
+             * We are using a bitshift and integer addition to align the
+             * calculation with what is fastest for SIMD operations.
+             * Results are almost identical to floating point multiplication.
+             */
+            Uint8 grayscale_pixel =
+                (Uint8)((((76 * r) + 255) >> 8) + (((150 * g) + 255) >> 8) +
+                        (((29 * b) + 255) >> 8));
+            Uint32 new_pixel =
+                PG_MapRGBA(newsurf_format, newsurf_palette, grayscale_pixel,
+                           grayscale_pixel, grayscale_pixel, a);
+            SURF_SET_AT(new_pixel, newsurf, x, y, (Uint8 *)newsurf->pixels,
+                        newsurf_format, pix);
         }
-        PyErr_Format(PyExc_ValueError,
-                     "lightness value must be between -1 and 1, got %R",
-                     value);
-        Py_DECREF(value);
-        return NULL;
     }
+}
 
-    h = (float)(fmodf(h, 360.0) / 360.0);
-
-    src = pgSurface_AsSurface(surfobj);
-    SURF_INIT_CHECK(src);
+SDL_Surface *
+grayscale(pgSurfaceObject *srcobj, pgSurfaceObject *dstobj)
+{
+    SDL_Surface *src = pgSurface_AsSurface(srcobj);
+    SDL_Surface *newsurf;
 
-    if (!surfobj2) {
-        dst = newsurf_fromsurf(src, src->w, src->h);
-        if (!dst) {
+    if (!dstobj) {
+        newsurf = newsurf_fromsurf(src, srcobj->surf->w, srcobj->surf->h);
+        if (!newsurf) {
             return NULL;
         }
     }
     else {
-        dst = pgSurface_AsSurface(surfobj2);
+        newsurf = pgSurface_AsSurface(dstobj);
     }
 
-    if (dst->w != src->w || dst->h != src->h) {
-        return RAISE(
+    if (newsurf->w != src->w || newsurf->h != src->h) {
+        return (SDL_Surface *)(RAISE(
             PyExc_ValueError,
-            "Destination surface must be the same size as source surface.");
+            "Destination surface must be the same size as source surface."));
     }
-    if (PG_SURF_FORMATENUM(src) != PG_SURF_FORMATENUM(dst)) {
-        return RAISE(PyExc_ValueError,
-                     "Source and destination surfaces need the same format.");
+
+    if (PG_SURF_BytesPerPixel(src) != PG_SURF_BytesPerPixel(newsurf)) {
+        return (SDL_Surface *)(RAISE(
+            PyExc_ValueError,
+            "Source and destination surfaces need the same format."));
     }
 
     PG_PixelFormat *src_format = PG_GetSurfaceFormat(src);
-    PG_PixelFormat *dst_format = PG_GetSurfaceFormat(dst);
-    if (src_format == NULL || dst_format == NULL) {
-        return RAISE(pgExc_SDLError, SDL_GetError());
+    PG_PixelFormat *newsurf_format = PG_GetSurfaceFormat(newsurf);
+    if (src_format == NULL || newsurf_format == NULL) {
+        return (SDL_Surface *)(RAISE(pgExc_SDLError, SDL_GetError()));
     }
 
-    Py_BEGIN_ALLOW_THREADS;
-    modify_hsl(src, src_format, dst, dst_format, h, s, l);
-    Py_END_ALLOW_THREADS;
-
-    if (surfobj2) {
-        Py_INCREF(surfobj2);
-        return (PyObject *)surfobj2;
+#if defined(__EMSCRIPTEN__)
+    grayscale_non_simd(src, src_format, newsurf, newsurf_format);
+#else  // !defined(__EMSCRIPTEN__)
+    if (PG_FORMAT_BytesPerPixel(src_format) == 4 &&
+        src_format->Rmask == newsurf_format->Rmask &&
+        src_format->Gmask == newsurf_format->Gmask &&
+        src_format->Bmask == newsurf_format->Bmask && (src->pitch % 4 == 0) &&
+        (newsurf->pitch == (newsurf->w * 4))) {
+        if (pg_has_avx2()) {
+            grayscale_avx2(src, src_format, newsurf);
+        }
+#if defined(__SSE2__) || defined(PG_ENABLE_ARM_NEON)
+        else if (pg_HasSSE_NEON()) {
+#if PG_ENABLE_NATIVE_NEON
+            grayscale_neon(src, src_format, newsurf);
+#else
+            grayscale_sse2(src, src_format, newsurf);
+#endif /* PG_ENABLE_NATIVE_NEON */
+        }
+#endif  // defined(__SSE2__) || defined(PG_ENABLE_ARM_NEON)
+        else {
+            grayscale_non_simd(src, src_format, newsurf, newsurf_format);
+        }
     }
     else {
-        return (PyObject *)pgSurface_New(dst);
+        grayscale_non_simd(src, src_format, newsurf, newsurf_format);
     }
-}
+#endif  // !defined(__EMSCRIPTEN__)
 
-/*
-number to use for missing samples
-*/
-#define LAPLACIAN_NUM 0xFFFFFFFF
+    SDL_UnlockSurface(newsurf);
 
-void
-laplacian(SDL_Surface *surf, PG_PixelFormat *format, SDL_Surface *destsurf,
-          PG_PixelFormat *destformat)
-{
-    int ii;
-    int x, y, height, width;
-
-    Uint32 sample[9];
-    // Uint32 total[4];
-    int total[4];
-
-    Uint8 c1r, c1g, c1b, c1a;
-    // Uint32 c1r, c1g, c1b, c1a;
-    Uint8 acolor[4];
-
-    Uint32 the_color;
-
-    int atmp0;
-    int atmp1;
-    int atmp2;
-    int atmp3;
-
-    Uint8 *pixels, *destpixels;
-    Uint8 *pix;
-
-    Uint8 *byte_buf;
-
-    height = surf->h;
-    width = surf->w;
-
-    pixels = (Uint8 *)surf->pixels;
-    destpixels = (Uint8 *)destsurf->pixels;
-    SDL_Palette *surf_palette = PG_GetSurfacePalette(surf);
-
-    /*
-        -1 -1 -1
-        -1  8 -1
-        -1 -1 -1
-
-        col = (sample[4] * 8) - (sample[0] + sample[1] + sample[2] +
-                                 sample[3] +             sample[5] +
-                                 sample[6] + sample[7] + sample[8])
-
-        [(-1,-1), (0,-1), (1,-1),     (-1,0), (0,0), (1,0),     (-1,1), (0,1),
-       (1,1)]
-
-    */
-
-    for (y = 0; y < height; y++) {
-        for (x = 0; x < width; x++) {
-            // Need to bounds check these accesses.
-
-            if (y > 0) {
-                if (x > 0) {
-                    SURF_GET_AT(sample[0], surf, x + -1, y + -1, pixels,
-                                format, pix);
-                }
-
-                SURF_GET_AT(sample[1], surf, x + 0, y + -1, pixels, format,
-                            pix);
-
-                if (x + 1 < width) {
-                    SURF_GET_AT(sample[2], surf, x + 1, y + -1, pixels, format,
-                                pix);
-                }
-            }
-            else {
-                sample[0] = LAPLACIAN_NUM;
-                sample[1] = LAPLACIAN_NUM;
-                sample[2] = LAPLACIAN_NUM;
-            }
-
-            if (x > 0) {
-                SURF_GET_AT(sample[3], surf, x + -1, y + 0, pixels, format,
-                            pix);
-            }
-            else {
-                sample[3] = LAPLACIAN_NUM;
-            }
-
-            // SURF_GET_AT(sample[4], surf, x+0 , y+0);
-            sample[4] = 0;
-
-            if (x + 1 < width) {
-                SURF_GET_AT(sample[5], surf, x + 1, y + 0, pixels, format,
-                            pix);
-            }
-            else {
-                sample[5] = LAPLACIAN_NUM;
-            }
-
-            if (y + 1 < height) {
-                if (x > 0) {
-                    SURF_GET_AT(sample[6], surf, x + -1, y + 1, pixels, format,
-                                pix);
-                }
-
-                SURF_GET_AT(sample[7], surf, x + 0, y + 1, pixels, format,
-                            pix);
-
-                if (x + 1 < width) {
-                    SURF_GET_AT(sample[8], surf, x + 1, y + 1, pixels, format,
-                                pix);
-                }
-            }
-            else {
-                sample[6] = LAPLACIAN_NUM;
-                sample[7] = LAPLACIAN_NUM;
-                sample[8] = LAPLACIAN_NUM;
-            }
-
-            memset(total, 0, 4 * sizeof(int));
-
-            for (ii = 0; ii < 9; ii++) {
-                PG_GetRGBA(sample[ii], format, surf_palette, &c1r, &c1g, &c1b,
-                           &c1a);
-                total[0] += c1r;
-                total[1] += c1g;
-                total[2] += c1b;
-                total[3] += c1a;
-            }
-
-            SURF_GET_AT(sample[4], surf, x, y, pixels, format, pix);
-
-            PG_GetRGBA(sample[4], format, surf_palette, &c1r, &c1g, &c1b,
-                       &c1a);
-
-            // cast on the right to a signed int, and then clamp to 0-255.
-
-            // atmp = c1r * 8
-
-            atmp0 = c1r * 8;
-            acolor[0] = MIN(MAX(atmp0 - total[0], 0), 255);
-            atmp1 = c1g * 8;
-            acolor[1] = MIN(MAX(atmp1 - total[1], 0), 255);
-            atmp2 = c1b * 8;
-            acolor[2] = MIN(MAX(atmp2 - total[2], 0), 255);
-            atmp3 = c1a * 8;
-            acolor[3] = MIN(MAX(atmp3 - total[3], 0), 255);
-
-            // printf("%d;;%d;;%d;;  ", atmp0, acolor[0],total[0]);
-
-            // printf("%d,%d,%d,%d;;  \n", acolor[0], acolor[1], acolor[2],
-            // acolor[3]);
-
-            // the_color = (Uint32)acolor;
-            // the_color = 0x00000000;
-
-            // cast on the right to Uint32, and then clamp to 255.
-
-            the_color = PG_MapRGBA(format, surf_palette, acolor[0], acolor[1],
-                                   acolor[2], acolor[3]);
-
-            // set_at(destsurf, color, x,y);
-
-            switch (PG_FORMAT_BytesPerPixel(destformat)) {
-                case 1:
-                    *((Uint8 *)destpixels + y * destsurf->pitch + x) =
-                        (Uint8)the_color;
-                    break;
-                case 2:
-                    *((Uint16 *)(destpixels + y * destsurf->pitch) + x) =
-                        (Uint16)the_color;
-                    break;
-                case 3:
-                    byte_buf =
-                        (Uint8 *)(destpixels + y * destsurf->pitch) + x * 3;
-#if (SDL_BYTEORDER == SDL_LIL_ENDIAN)
-                    *(byte_buf + (destformat->Rshift >> 3)) =
-                        (Uint8)(the_color >> format->Rshift);
-                    *(byte_buf + (destformat->Gshift >> 3)) =
-                        (Uint8)(the_color >> format->Gshift);
-                    *(byte_buf + (destformat->Bshift >> 3)) =
-                        (Uint8)(the_color >> format->Bshift);
-#else
-                    *(byte_buf + 2 - (destformat->Rshift >> 3)) =
-                        (Uint8)(the_color >> format->Rshift);
-                    *(byte_buf + 2 - (destformat->Gshift >> 3)) =
-                        (Uint8)(the_color >> format->Gshift);
-                    *(byte_buf + 2 - (destformat->Bshift >> 3)) =
-                        (Uint8)(the_color >> format->Bshift);
-#endif
-                    break;
-                default:
-                    *((Uint32 *)(destpixels + y * destsurf->pitch) + x) =
-                        the_color;
-                    break;
-            }
-        }
-    }
+    return newsurf;
 }
 
 static PyObject *
-surf_laplacian(PyObject *self, PyObject *args, PyObject *kwargs)
+surf_grayscale(PyObject *self, PyObject *args, PyObject *kwargs)
 {
-    PyObject *surfobj, *surfobj2 = NULL;
-    SDL_Surface *surf;
+    pgSurfaceObject *surfobj;
+    pgSurfaceObject *surfobj2 = NULL;
     SDL_Surface *newsurf;
+
     static char *keywords[] = {"surface", "dest_surface", NULL};
 
     if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!|O!", keywords,
@@ -3101,608 +3374,1470 @@ surf_laplacian(PyObject *self, PyObject *args, PyObject *kwargs)
         return NULL;
     }
 
-    surf = pgSurface_AsSurface(surfobj);
-    SURF_INIT_CHECK(surf)
+    if (surfobj2 && !pgSurface_Unshare(surfobj2)) {
+        return NULL;
+    }
 
-    /* if the second surface is not there, then make a new one. */
+    newsurf = grayscale(surfobj, surfobj2);
 
-    if (!surfobj2) {
-        int width = surf->w;
-        int height = surf->h;
+    if (!newsurf) {
+        return NULL;
+    }
 
-        newsurf = newsurf_fromsurf(surf, width, height);
+    if (surfobj2) {
+        pgSurface_AddDirtyRect(surfobj2, NULL);
+        Py_INCREF(surfobj2);
+        return (PyObject *)surfobj2;
+    }
+    else {
+        return (PyObject *)pgSurface_New(newsurf);
+    }
+}
+
+SDL_Surface *
+solid_overlay(pgSurfaceObject *srcobj, Uint32 color, pgSurfaceObject *dstobj,
+              const int keep_alpha)
+{
+    SDL_Surface *src = pgSurface_AsSurface(srcobj);
+    SDL_Surface *newsurf;
+    Uint8 a;
 
+    if (!dstobj) {
+        newsurf = newsurf_fromsurf(src, srcobj->surf->w, srcobj->surf->h);
         if (!newsurf) {
             return NULL;
         }
     }
     else {
-        newsurf = pgSurface_AsSurface(surfobj2);
+        newsurf = pgSurface_AsSurface(dstobj);
     }
 
-    /* check to see if the size is the correct size. */
-    if (newsurf->w != (surf->w) || newsurf->h != (surf->h)) {
-        return RAISE(PyExc_ValueError,
-                     "Destination surface not the same size.");
+    if (newsurf->w != src->w || newsurf->h != src->h) {
+        return (SDL_Surface *)(RAISE(
+            PyExc_ValueError,
+            "Destination surface must be the same size as source surface."));
     }
 
-    /* check to see if the format of the surface is the same. */
-    if (PG_SURF_BytesPerPixel(surf) != PG_SURF_BytesPerPixel(newsurf)) {
-        return RAISE(PyExc_ValueError,
-                     "Source and destination surfaces need the same format.");
+    PG_PixelFormat *fmt, *newsurf_format;
+    SDL_Palette *src_palette, *newsurf_palette;
+    if (!PG_GetSurfaceDetails(src, &fmt, &src_palette) ||
+        !PG_GetSurfaceDetails(newsurf, &newsurf_format, &newsurf_palette)) {
+        return (SDL_Surface *)(RAISE(pgExc_SDLError, SDL_GetError()));
     }
 
-    PG_PixelFormat *surf_format = PG_GetSurfaceFormat(surf);
-    PG_PixelFormat *newsurf_format = PG_GetSurfaceFormat(newsurf);
-    if (surf_format == NULL || newsurf_format == NULL) {
-        return RAISE(pgExc_SDLError, SDL_GetError());
+    if (fmt->format != newsurf_format->format) {
+        return (SDL_Surface *)(RAISE(
+            PyExc_ValueError,
+            "Source and destination surfaces need the same format."));
     }
 
-    SDL_LockSurface(newsurf);
-    SDL_LockSurface(surf);
-
-    Py_BEGIN_ALLOW_THREADS;
-    laplacian(surf, surf_format, newsurf, newsurf_format);
-    Py_END_ALLOW_THREADS;
+    /* If the source surface has no alpha channel, we can't overlay with alpha
+     * blending. */
+    if (!SDL_ISPIXELFORMAT_ALPHA(fmt->format)) {
+        return newsurf;
+    }
 
-    SDL_UnlockSurface(surf);
-    SDL_UnlockSurface(newsurf);
+    /* If we are keeping the src alpha, then we need to remove the alpha from
+     * the color so it's easier to add the base pixel alpha back in */
+    if (keep_alpha) {
+        color &= ~fmt->Amask;
+    }
 
-    if (surfobj2) {
-        Py_INCREF(surfobj2);
-        return surfobj2;
+    int src_lock = SDL_MUSTLOCK(src);
+    int dst_lock = src != newsurf && SDL_MUSTLOCK(newsurf);
+
+    if (src_lock && !PG_LockSurface(src)) {
+        return NULL;
     }
-    else {
-        return (PyObject *)pgSurface_New(newsurf);
+    if (dst_lock && !PG_LockSurface(newsurf)) {
+        if (src_lock) {
+            SDL_UnlockSurface(src);
+        }
+        return NULL;
     }
-}
 
-int
-average_surfaces(SDL_Surface **surfaces, size_t num_surfaces,
-                 SDL_Surface *destsurf, int palette_colors)
-{
-    /*
-        returns the average surface from the ones given.
+    /* optimized path for 32 bit surfaces */
+    if (PG_FORMAT_BytesPerPixel(fmt) == 4) {
+        /* This algorithm iterates over each pixel's alpha channel. If it's not
+         * zero, the pixel is set to the desired color. If the keep_alpha flag
+         * is set, the original alpha value is retained, allowing the overlay
+         * color to inherit the surface pixel's alpha value. */
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+        const int dst_ashift = fmt->Ashift;
+        const char _a_off = fmt->Ashift >> 3;
+#else
+        const int dst_ashift = 24 - newsurf->format->Ashift;
+        const char _a_off = 3 - (newsurf->format->Ashift >> 3);
+#endif
 
-        All surfaces need to be the same size.
+        Uint8 *srcp = (Uint8 *)src->pixels + _a_off;
+        Uint32 *dstp = (Uint32 *)newsurf->pixels;
 
-        palette_colors - if true we average the colors in palette, otherwise we
-            average the pixel values.  This is useful if the surface is
-            actually grayscale colors, and not palette colors.
+        const int src_skip = src->pitch - src->w * 4;
+        const int dst_skip = newsurf->pitch / 4 - newsurf->w;
+        int n, height = src->h;
 
-    */
+        if (srcobj == dstobj) {
+            if (!keep_alpha) {
+                while (height--) {
+                    LOOP_UNROLLED4(
+                        {
+                            if (*srcp) {
+                                *dstp = color;
+                            }
+                            srcp += 4;
+                            dstp++;
+                        },
+                        n, src->w);
+                    srcp += src_skip;
+                    dstp += dst_skip;
+                }
+            }
+            else {
+                while (height--) {
+                    LOOP_UNROLLED4(
+                        {
+                            if ((a = *srcp)) {
+                                *dstp = color | (a << dst_ashift);
+                            }
+                            srcp += 4;
+                            dstp++;
+                        },
+                        n, src->w);
+                    srcp += src_skip;
+                    dstp += dst_skip;
+                }
+            }
+        }
+        else {
+            if (!keep_alpha) {
+                while (height--) {
+                    LOOP_UNROLLED4(
+                        {
+                            if (*srcp) {
+                                *dstp = color;
+                            }
+                            srcp += 4;
+                            dstp++;
+                        },
+                        n, src->w);
+                    srcp += src_skip;
+                    dstp += dst_skip;
+                }
+            }
+            else {
+                while (height--) {
+                    LOOP_UNROLLED4(
+                        {
+                            if ((a = *srcp)) {
+                                *dstp = color | (a << dst_ashift);
+                            }
+                            srcp += 4;
+                            dstp++;
+                        },
+                        n, src->w);
+                    srcp += src_skip;
+                    dstp += dst_skip;
+                }
+            }
+        }
+    }
+    else /* path for 16 bit surfaces */
+    {
+        int x, y;
+        Uint8 r, g, b;
+        Uint16 *src_row = (Uint16 *)src->pixels;
+        Uint16 *dst_row = (Uint16 *)newsurf->pixels;
+        const int src_skip = src->pitch / 2 - src->w;
+        const int dst_skip = newsurf->pitch / 2 - newsurf->w;
 
-    Uint32 *accumulate;
-    Uint32 *the_idx;
-    Uint32 the_color;
-    SDL_Surface *surf;
-    size_t surf_idx;
-    int height, width, x, y;
+        Uint8 Cr, Cg, Cb, Ca;
+        PG_GetRGBA(color, fmt, src_palette, &Cr, &Cg, &Cb, &Ca);
+        const Uint16 color16 = (Uint16)PG_MapRGBA(
+            newsurf_format, newsurf_palette, Cr, Cg, Cb, Ca);
 
-    float div_inv;
+        for (y = 0; y < src->h; y++) {
+            for (x = 0; x < src->w; x++) {
+                PG_GetRGBA((Uint32)*src_row, fmt, src_palette, &r, &g, &b, &a);
 
-    PG_PixelFormat *format, *destformat;
-    SDL_Palette *destpalette;
-    Uint8 *pixels, *destpixels;
-    Uint8 *pix;
-    Uint8 *byte_buf;
+                if (a) {
+                    if (keep_alpha) {
+                        *dst_row = (Uint16)PG_MapRGBA(
+                            newsurf_format, newsurf_palette, Cr, Cg, Cb, a);
+                    }
+                    else {
+                        *dst_row = color16;
+                    }
+                }
 
-    Uint32 rmask, gmask, bmask;
-    int rshift, gshift, bshift, rloss, gloss, bloss;
-    int num_elements;
+                src_row++;
+                dst_row++;
+            }
+            src_row += src_skip;
+            dst_row += dst_skip;
+        }
+    }
 
-    if (!num_surfaces) {
-        return 0;
+    if (src_lock) {
+        SDL_UnlockSurface(src);
+    }
+    if (dst_lock) {
+        SDL_UnlockSurface(newsurf);
     }
 
-    height = surfaces[0]->h;
-    width = surfaces[0]->w;
+    return newsurf;
+}
 
-    destpixels = (Uint8 *)destsurf->pixels;
-    if (!PG_GetSurfaceDetails(destsurf, &destformat, &destpalette)) {
-        return -1;
-    }
+static PyObject *
+surf_solid_overlay(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+    pgSurfaceObject *surfobj;
+    PyObject *colorobj;
+    Uint32 color;
 
-    /* allocate an array to accumulate them all.
+    pgSurfaceObject *surfobj2 = NULL;
+    SDL_Surface *newsurf;
+    SDL_Surface *surf;
+    int keep_alpha = 0;
 
-    If we're using 1 byte per pixel, then only need to average on that much.
-    */
+    static char *keywords[] = {"surface", "color", "dest_surface",
+                               "keep_alpha", NULL};
 
-    if ((PG_FORMAT_BytesPerPixel(destformat) == 1) && destpalette &&
-        (!palette_colors)) {
-        num_elements = 1;
+    if (!PyArg_ParseTupleAndKeywords(
+            args, kwargs, "O!O|O!i", keywords, &pgSurface_Type, &surfobj,
+            &colorobj, &pgSurface_Type, &surfobj2, &keep_alpha)) {
+        return NULL;
     }
-    else {
-        num_elements = 3;
+
+    if (surfobj2 && !pgSurface_Unshare(surfobj2)) {
+        return NULL;
     }
 
-    accumulate =
-        (Uint32 *)calloc(1, sizeof(Uint32) * height * width * num_elements);
+    surf = pgSurface_AsSurface(surfobj);
 
-    if (!accumulate) {
-        return -1;
+    if (!pg_MappedColorFromObj(colorobj, surf, &color, PG_COLOR_HANDLE_ALL)) {
+        return RAISE(PyExc_TypeError, "invalid color argument");
     }
 
-    /* add up the r,g,b from all the surfaces. */
+    newsurf = solid_overlay(surfobj, color, surfobj2, keep_alpha);
 
-    for (surf_idx = 0; surf_idx < num_surfaces; surf_idx++) {
-        surf = surfaces[surf_idx];
+    if (!newsurf) {
+        return NULL;
+    }
 
-        pixels = (Uint8 *)surf->pixels;
-        format = PG_GetSurfaceFormat(surf);
-        if (!format) {
-            return -1;
-        }
-        rmask = format->Rmask;
-        gmask = format->Gmask;
-        bmask = format->Bmask;
-        rshift = format->Rshift;
-        gshift = format->Gshift;
-        bshift = format->Bshift;
-        rloss = PG_FORMAT_R_LOSS(format);
-        gloss = PG_FORMAT_G_LOSS(format);
-        bloss = PG_FORMAT_B_LOSS(format);
+    if (surfobj2) {
+        pgSurface_AddDirtyRect(surfobj2, NULL);
+        Py_INCREF(surfobj2);
+        return (PyObject *)surfobj2;
+    }
+    else {
+        return (PyObject *)pgSurface_New(newsurf);
+    }
+}
 
-        the_idx = accumulate;
-        /* If palette surface, we use a different code path... */
+#define MIN3(a, b, c) MIN(MIN(a, b), c)
+#define MAX3(a, b, c) MAX(MAX(a, b), c)
 
-        if ((PG_FORMAT_BytesPerPixel(format) == 1 &&
-             PG_FORMAT_BytesPerPixel(destformat) == 1) &&
-            PG_GetSurfacePalette(surf) && (destpalette) && (!palette_colors)) {
-            /*
-            This is useful if the surface is actually grayscale colors,
-            and not palette colors.
-            */
-            for (y = 0; y < height; y++) {
-                for (x = 0; x < width; x++) {
-                    SURF_GET_AT(the_color, surf, x, y, pixels, format, pix);
-                    *(the_idx) += the_color;
-                    the_idx++;
-                }
-            }
-        }
-        else {
-            /* TODO: This doesn't work correctly for palette surfaces yet, when
-               the source is paletted.  Probably need to use something like
-               GET_PIXELVALS_1 from surface.h
-            */
-
-            /* for non palette surfaces, we do this... */
-            for (y = 0; y < height; y++) {
-                for (x = 0; x < width; x++) {
-                    SURF_GET_AT(the_color, surf, x, y, pixels, format, pix);
-
-                    *(the_idx) += ((the_color & rmask) >> rshift) << rloss;
-                    *(the_idx + 1) += ((the_color & gmask) >> gshift) << gloss;
-                    *(the_idx + 2) += ((the_color & bmask) >> bshift) << bloss;
-                    the_idx += 3;
-                }
-            }
-        }
-    }
+/* Following hsl code is based on code from
+ * https://gist.github.com/ciembor/1494530
+ * and
+ * http://en.wikipedia.org/wiki/HSL_color_space
+ */
+static PG_FORCEINLINE void
+RGB_to_HSL(Uint8 r, Uint8 g, Uint8 b, float *h, float *s, float *l)
+{
+    float r_1 = r / 255.0f;
+    float g_1 = g / 255.0f;
+    float b_1 = b / 255.0f;
 
-    /* blit the accumulated array back to the destination surface. */
+    float min = MIN3(r_1, g_1, b_1);
+    float max = MAX3(r_1, g_1, b_1);
+    float delta = max - min;
 
-    div_inv = (float)(1.0L / (num_surfaces));
+    *l = (max + min) / 2.0f;
 
-    the_idx = accumulate;
+    if (delta == 0) {
+        *h = *s = 0;  // achromatic
+    }
+    else {
+        *s = *l > 0.5f ? delta / (2.0f - max - min) : delta / (max + min);
 
-    if (num_elements == 1 && (!palette_colors)) {
-        /* this is where we are using the palette surface without using its
-        colors from the palette.
-        */
-        for (y = 0; y < height; y++) {
-            for (x = 0; x < width; x++) {
-                the_color = (Uint32)(*(the_idx)*div_inv + .5f);
-                SURF_SET_AT(the_color, destsurf, x, y, destpixels, destformat,
-                            byte_buf);
-                the_idx++;
-            }
+        if (max == r_1) {
+            *h = (g_1 - b_1) / delta + (g_1 < b_1 ? 6 : 0);
         }
-        /* TODO: will need to handle palette colors.
-         */
+        else if (max == g_1) {
+            *h = (b_1 - r_1) / delta + 2;
+        }
+        else {
+            *h = (r_1 - g_1) / delta + 4;
+        }
+        *h /= 6;
     }
-    else if (num_elements == 3) {
-        for (y = 0; y < height; y++) {
-            for (x = 0; x < width; x++) {
-                the_color = PG_MapRGB(destformat, destpalette,
-                                      (Uint8)(*(the_idx)*div_inv + .5f),
-                                      (Uint8)(*(the_idx + 1) * div_inv + .5f),
-                                      (Uint8)(*(the_idx + 2) * div_inv + .5f));
-
-                /* TODO: should it take into consideration the output
-                    shifts/masks/losses?  Or does SDL_MapRGB do that correctly?
-
-                    *(the_idx) += ((the_color & rmask) >> rshift) << rloss;
-                    *(the_idx + 1) += ((the_color & gmask) >> gshift) << gloss;
-                    *(the_idx + 2) += ((the_color & bmask) >> bshift) << bloss;
-                */
+}
 
-                SURF_SET_AT(the_color, destsurf, x, y, destpixels, destformat,
-                            byte_buf);
+static PG_FORCEINLINE float
+hue_to_rgb(float p, float q, float t)
+{
+    if (t < 0) {
+        t += 1;
+    }
+    if (t > 1) {
+        t -= 1;
+    }
+    if (t < 1 / 6.0f) {
+        return p + (q - p) * 6 * t;
+    }
+    if (t < 1 / 2.0f) {
+        return q;
+    }
+    if (t < 2 / 3.0f) {
+        return p + (q - p) * (2 / 3.0f - t) * 6;
+    }
+    return p;
+}
 
-                the_idx += 3;
-            }
-        }
+static PG_FORCEINLINE void
+HSL_to_RGB(float h, float s, float l, Uint8 *r, Uint8 *g, Uint8 *b)
+{
+    if (s == 0) {
+        *r = *g = *b = (Uint8)(l * 255);
     }
     else {
-        free(accumulate);
-        return -4;
+        float q = l < 0.5f ? l * (1 + s) : l + s - l * s;
+        float p = 2 * l - q;
+        *r = (Uint8)(hue_to_rgb(p, q, h + 1 / 3.0f) * 255);
+        *g = (Uint8)(hue_to_rgb(p, q, h) * 255);
+        *b = (Uint8)(hue_to_rgb(p, q, h - 1 / 3.0f) * 255);
     }
-
-    free(accumulate);
-
-    return 1;
 }
 
-/*
-    returns the average surface from the ones given.
-
-    All surfaces need to be the same size.
-
-    palette_colors - if true we average the colors in palette, otherwise we
-        average the pixel values.  This is useful if the surface is
-        actually grayscale colors, and not palette colors.
-
-*/
-static PyObject *
-surf_average_surfaces(PyObject *self, PyObject *args, PyObject *kwargs)
+static PG_FORCEINLINE void
+adjust_hsl(float *s_h, float *s_s, float *s_l, float h, float s, float l)
 {
-    PyObject *surfobj2 = NULL;
-    SDL_Surface *surf;
-    SDL_Surface *newsurf = NULL;
-    SDL_Surface **surfaces;
-    int width, height;
-    int an_error = 0;
-    size_t size, loop, loop_up_to;
-    int palette_colors = 1;
-    PyObject *list, *obj;
-    PyObject *ret = NULL;
-    static char *keywords[] = {"surfaces", "dest_surface", "palette_colors",
-                               NULL};
-
-    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|O!i", keywords, &list,
-                                     &pgSurface_Type, &surfobj2,
-                                     &palette_colors)) {
-        return NULL;
+    if (h) {
+        *s_h += h;
+        if (*s_h > 1) {
+            *s_h -= 1;
+        }
+        else if (*s_h < 0) {
+            *s_h += 1;
+        }
     }
-
-    if (!PySequence_Check(list)) {
-        return RAISE(PyExc_TypeError,
-                     "Argument must be a sequence of surface objects.");
+    if (s) {
+        *s_s = *s_s * (1 + s);
+        *s_s = *s_s > 1 ? 1 : *s_s < 0 ? 0 : *s_s;
     }
+    if (l) {
+        *s_l = l < 0 ? *s_l * (1 + l) : *s_l * (1 - l) + l;
+        *s_l = *s_l > 1 ? 1 : *s_l < 0 ? 0 : *s_l;
+    }
+}
 
-    size = PySequence_Length(list); /*warning, size could be -1 on error?*/
-
-    if (size < 1) {
-        return RAISE(PyExc_TypeError,
-                     "Needs to be given at least one surface.");
+/* Shifts the hue, saturation and lightness of count 32 bit pixels. shifts
+ * holds the bit positions of red, green and blue in the pixel values, the
+ * other bits are copied. */
+static void
+modify_hsl_row(const Uint8 *src, Uint8 *dst, int count, const int *shifts,
+               float h, float s, float l)
+{
+    const Uint32 keep = ~((0xFFu << shifts[0]) | (0xFFu << shifts[1]) |
+                          (0xFFu << shifts[2]));
+    float s_h = 0, s_s = 0, s_l = 0;
+    Uint8 r, g, b;
+    Uint32 pixel;
+    int i;
+
+    for (i = 0; i < count; i++) {
+        memcpy(&pixel, src + i * 4, 4);
+        RGB_to_HSL((Uint8)(pixel >> shifts[0]), (Uint8)(pixel >> shifts[1]),
+                   (Uint8)(pixel >> shifts[2]), &s_h, &s_s, &s_l);
+        adjust_hsl(&s_h, &s_s, &s_l, h, s, l);
+        HSL_to_RGB(s_h, s_s, s_l, &r, &g, &b);
+        pixel = (pixel & keep) | ((Uint32)r << shifts[0]) |
+                ((Uint32)g << shifts[1]) | ((Uint32)b << shifts[2]);
+        memcpy(dst + i * 4, &pixel, 4);
     }
+}
 
-    /* Allocate an array of surface pointers. */
+typedef struct {
+    SDL_Surface *surf;
+    SDL_Surface *dst;
+    int shifts[3];
+    float h, s, l;
+    int simd;
+    int failed;
+} pgHSLPass;
 
-    surfaces = (SDL_Surface **)calloc(1, sizeof(SDL_Surface *) * size);
+static PG_INLINE void
+_modify_hsl_row(pgHSLPass *pass, const Uint8 *src, Uint8 *dst)
+{
+    int count = pass->surf->w;
 
-    if (!surfaces) {
-        return RAISE(PyExc_MemoryError,
-                     "Not enough memory to store surfaces.\n");
+#if !defined(__EMSCRIPTEN__)
+    if (pass->simd == 2) {
+        modify_hsl_avx2(src, dst, count, pass->shifts, pass->h, pass->s,
+                        pass->l);
+        return;
     }
+#if defined(__SSE2__) || defined(PG_ENABLE_ARM_NEON)
+    if (pass->simd) {
+        modify_hsl_sse2(src, dst, count, pass->shifts, pass->h, pass->s,
+                        pass->l);
+        return;
+    }
+#endif /* defined(__SSE2__) || defined(PG_ENABLE_ARM_NEON) */
+#endif /* !defined(__EMSCRIPTEN__) */
+    modify_hsl_row(src, dst, count, pass->shifts, pass->h, pass->s, pass->l);
+}
 
-    /* Iterate over 'surfaces' passed in. */
-
-    /* need to get the first surface to see how big it is */
+/* A band of rows of 24 or 32 bit surfaces, 24 bit rows go through a 32 bit
+ * row */
+static void
+_modify_hsl_band(void *data, int start, int end)
+{
+    pgHSLPass *pass = (pgHSLPass *)data;
+    SDL_Surface *surf = pass->surf;
+    SDL_Surface *dst = pass->dst;
+    Uint8 *row = NULL;
+    int y;
+
+    if (PG_SURF_BytesPerPixel(surf) == 3) {
+        row = malloc((size_t)surf->w * 4);
+        if (!row) {
+            pass->failed = 1;
+            return;
+        }
+    }
 
-    for (loop = 0; loop < size; ++loop) {
-        obj = PySequence_GetItem(list, loop);
+    for (y = start; y < end; y++) {
+        Uint8 *srcrow = (Uint8 *)surf->pixels + (size_t)y * surf->pitch;
+        Uint8 *dstrow = (Uint8 *)dst->pixels + (size_t)y * dst->pitch;
 
-        if (!obj) {
-            Py_XDECREF(obj);
-            ret = RAISE(PyExc_TypeError, "Needs to be a surface object.");
-            an_error = 1;
-            break;
+        if (!row) {
+            _modify_hsl_row(pass, srcrow, dstrow);
+            continue;
         }
+        convert_24_32(srcrow, surf->pitch, row, surf->w * 4, surf->w, 1);
+        _modify_hsl_row(pass, row, row);
+        convert_32_24(row, surf->w * 4, dstrow, dst->pitch, surf->w, 1);
+    }
+    free(row);
+}
 
-        if (!pgSurface_Check(obj)) {
-            Py_XDECREF(obj);
-            ret = RAISE(PyExc_TypeError, "Needs to be a surface object.");
-            an_error = 1;
-            break;
+/* Returns -1 if memory ran out */
+static int
+modify_hsl(SDL_Surface *surf, PG_PixelFormat *fmt, SDL_Surface *dst,
+           PG_PixelFormat *dst_format, float h, float s, float l)
+{
+    int surf_locked = 0;
+    if (SDL_MUSTLOCK(surf)) {
+        if (PG_LockSurface(surf)) {
+            surf_locked = 1;
         }
-
-        surf = pgSurface_AsSurface(obj);
-
-        if (!surf) {
-            Py_XDECREF(obj);
-            ret = RAISE(PyExc_TypeError, "Needs to be a surface object.");
-            an_error = 1;
-            break;
+    }
+    int dst_locked = 0;
+    if (SDL_MUSTLOCK(dst)) {
+        if (PG_LockSurface(dst)) {
+            dst_locked = 1;
         }
+    }
 
-        if (loop == 0) {
-            /* if the second surface is not there, then make a new one. */
-            if (!surfobj2) {
-                width = surf->w;
-                height = surf->h;
+    int x, y, result = 0;
+    Uint8 r, g, b, a;
+    float s_h = 0, s_s = 0, s_l = 0;
+    Uint8 *srcp8 = (Uint8 *)surf->pixels;
+    Uint8 *dstp8 = (Uint8 *)dst->pixels;
+    SDL_Palette *surf_palette = PG_GetSurfacePalette(surf);
+    SDL_Palette *dst_palette = PG_GetSurfacePalette(dst);
 
-                newsurf = newsurf_fromsurf(surf, width, height);
+    if (PG_FORMAT_BytesPerPixel(fmt) == 4 ||
+        PG_FORMAT_BytesPerPixel(fmt) == 3) {
+        pgHSLPass pass;
+        int bands;
+
+        /* the bit positions in the pixel values, 24 bit rows are widened
+         * to 32 bits with the channels in the same bytes */
+        pass.shifts[0] = fmt->Rshift;
+        pass.shifts[1] = fmt->Gshift;
+        pass.shifts[2] = fmt->Bshift;
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+        if (PG_FORMAT_BytesPerPixel(fmt) == 3) {
+            pass.shifts[0] += 8;
+            pass.shifts[1] += 8;
+            pass.shifts[2] += 8;
+        }
+#endif
+        pass.surf = surf;
+        pass.dst = dst;
+        pass.h = h;
+        pass.s = s;
+        pass.l = l;
+        pass.failed = 0;
+        pass.simd = 0;
+#if !defined(__EMSCRIPTEN__)
+#if defined(__SSE2__) || defined(PG_ENABLE_ARM_NEON)
+        pass.simd = pg_HasSSE_NEON();
+#endif /* defined(__SSE2__) || defined(PG_ENABLE_ARM_NEON) */
+        if (pg_has_avx2()) {
+            pass.simd = 2;
+        }
+#endif /* !defined(__EMSCRIPTEN__) */
 
-                if (!newsurf) {
-                    Py_XDECREF(obj);
-                    ret = RAISE(PyExc_ValueError,
-                                "Could not create new surface.");
-                    an_error = 1;
-                    break;
-                }
-            }
-            else {
-                newsurf = pgSurface_AsSurface(surfobj2);
-            }
-
-            /* check to see if the size is the correct size. */
-            if (newsurf->w != (surf->w) || newsurf->h != (surf->h)) {
-                Py_XDECREF(obj);
-                ret = RAISE(PyExc_ValueError,
-                            "Destination surface not the same size.");
-                an_error = 1;
-                break;
-            }
-
-            /* check to see if the format of the surface is the same. */
-            if (PG_SURF_BytesPerPixel(surf) !=
-                PG_SURF_BytesPerPixel(newsurf)) {
-                Py_XDECREF(obj);
-                ret = RAISE(
-                    PyExc_ValueError,
-                    "Source and destination surfaces need the same format.");
-                an_error = 1;
-                break;
+        bands =
+            pg_ParallelBandCount(surf->h, (Py_ssize_t)surf->w * surf->h * 8);
+        if (bands > 1) {
+            pg_ParallelForRows(surf->h, bands, _modify_hsl_band, &pass);
+        }
+        else {
+            _modify_hsl_band(&pass, 0, surf->h);
+        }
+        result = pass.failed ? -1 : 0;
+    }
+    else {
+        Uint8 *pix;
+        Uint32 pixel;
+        for (y = 0; y < surf->h; y++) {
+            for (x = 0; x < surf->w; x++) {
+                SURF_GET_AT(pixel, surf, x, y, srcp8, fmt, pix);
+                PG_GetRGBA(pixel, fmt, surf_palette, &r, &g, &b, &a);
+                RGB_to_HSL(r, g, b, &s_h, &s_s, &s_l);
+                adjust_hsl(&s_h, &s_s, &s_l, h, s, l);
+                HSL_to_RGB(s_h, s_s, s_l, &r, &g, &b);
+                pixel = PG_MapRGBA(dst_format, dst_palette, r, g, b, a);
+                SURF_SET_AT(pixel, dst, x, y, dstp8, fmt, pix);
             }
         }
+    }
 
-        /* Copy surface pointer, and also lock surface. */
-        SDL_LockSurface(surf);
-        surfaces[loop] = surf;
+    if (surf_locked) {
+        SDL_UnlockSurface(surf);
+    }
+    if (dst_locked) {
+        SDL_UnlockSurface(dst);
+    }
+    return result;
+}
 
-        Py_DECREF(obj);
+static PyObject *
+surf_hsl(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+    pgSurfaceObject *surfobj;
+    pgSurfaceObject *surfobj2 = NULL;
+    SDL_Surface *dst, *src;
+    float h = 0, s = 0, l = 0;
+    int result;
+
+    static char *keywords[] = {"surface",   "hue",          "saturation",
+                               "lightness", "dest_surface", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!|fffO!", keywords,
+                                     &pgSurface_Type, &surfobj, &h, &s, &l,
+                                     &pgSurface_Type, &surfobj2)) {
+        return NULL;
     }
 
-    loop_up_to = loop;
+    if (surfobj2 && !pgSurface_Unshare(surfobj2)) {
+        return NULL;
+    }
 
-    if (!an_error) {
-        /* Process images, get average surface. */
+    if (s < -1 || s > 1) {
+        PyObject *value = PyFloat_FromDouble((double)s);
+        if (!value) {
+            return NULL;
+        }
 
-        SDL_LockSurface(newsurf);
+        PyErr_Format(PyExc_ValueError,
+                     "saturation value must be between -1 and 1, got %R",
+                     value);
+        Py_DECREF(value);
+        return NULL;
+    }
+    if (l < -1 || l > 1) {
+        PyObject *value = PyFloat_FromDouble((double)l);
+        if (!value) {
+            return NULL;
+        }
+        PyErr_Format(PyExc_ValueError,
+                     "lightness value must be between -1 and 1, got %R",
+                     value);
+        Py_DECREF(value);
+        return NULL;
+    }
 
-        Py_BEGIN_ALLOW_THREADS;
-        average_surfaces(surfaces, size, newsurf, palette_colors);
-        Py_END_ALLOW_THREADS;
+    h = (float)(fmodf(h, 360.0) / 360.0);
 
-        SDL_UnlockSurface(newsurf);
+    src = pgSurface_AsSurface(surfobj);
+    SURF_INIT_CHECK(src);
 
-        if (surfobj2) {
-            Py_INCREF(surfobj2);
-            ret = surfobj2;
-        }
-        else {
-            ret = (PyObject *)pgSurface_New(newsurf);
+    if (!surfobj2) {
+        dst = newsurf_fromsurf(src, src->w, src->h);
+        if (!dst) {
+            return NULL;
         }
     }
+    else {
+        dst = pgSurface_AsSurface(surfobj2);
+    }
 
-    /* cleanup */
+    if (dst->w != src->w || dst->h != src->h) {
+        return RAISE(
+            PyExc_ValueError,
+            "Destination surface must be the same size as source surface.");
+    }
+    if (PG_SURF_FORMATENUM(src) != PG_SURF_FORMATENUM(dst)) {
+        return RAISE(PyExc_ValueError,
+                     "Source and destination surfaces need the same format.");
+    }
 
-    /* unlock the surfaces we got up to. */
+    PG_PixelFormat *src_format = PG_GetSurfaceFormat(src);
+    PG_PixelFormat *dst_format = PG_GetSurfaceFormat(dst);
+    if (src_format == NULL || dst_format == NULL) {
+        return RAISE(pgExc_SDLError, SDL_GetError());
+    }
 
-    for (loop = 0; loop < loop_up_to; loop++) {
-        if (surfaces[loop]) {
-            SDL_UnlockSurface(surfaces[loop]);
+    Py_BEGIN_ALLOW_THREADS;
+    result = modify_hsl(src, src_format, dst, dst_format, h, s, l);
+    Py_END_ALLOW_THREADS;
+
+    if (result) {
+        if (!surfobj2) {
+            SDL_FreeSurface(dst);
         }
+        return PyErr_NoMemory();
     }
 
-    free(surfaces);
-
-    return ret;
+    if (surfobj2) {
+        pgSurface_AddDirtyRect(surfobj2, NULL);
+        Py_INCREF(surfobj2);
+        return (PyObject *)surfobj2;
+    }
+    else {
+        return (PyObject *)pgSurface_New(dst);
+    }
 }
 
-/* VS 2015 crashes when compiling this function, turning off optimisations to
- try to fix it */
-#if defined(_MSC_VER) && (_MSC_VER == 1900)
-#pragma optimize("", off)
-#endif
-
-/* When GCC compiles the following function with -O3 on PPC64 little endian,
- * the function gives incorrect output with 24-bit surfaces. This is most
- * likely a compiler bug, see #2876 for related issue.
- * So turn optimisations off here */
-#if defined(__GNUC__) && defined(__PPC64__)
-#pragma GCC push_options
-#pragma GCC optimize("O0")
-#endif
+/*
+number to use for missing samples
+*/
+#define LAPLACIAN_NUM 0xFFFFFFFF
 
 void
-average_color(SDL_Surface *surf, PG_PixelFormat *format, int x, int y,
-              int width, int height, Uint8 *r, Uint8 *g, Uint8 *b, Uint8 *a,
-              SDL_bool consider_alpha)
+laplacian(SDL_Surface *surf, PG_PixelFormat *format, SDL_Surface *destsurf,
+          PG_PixelFormat *destformat)
 {
-    Uint32 color, rmask, gmask, bmask, amask;
-    Uint8 *pixels;
-    unsigned int rtot, gtot, btot, atot, size, rshift, gshift, bshift, ashift,
-        alpha;
-    unsigned int rloss, gloss, bloss, aloss;
-    int row, col, width_and_x, height_and_y;
+    int ii;
+    int x, y, height, width;
 
-    rmask = format->Rmask;
-    gmask = format->Gmask;
-    bmask = format->Bmask;
-    amask = format->Amask;
-    rshift = format->Rshift;
-    gshift = format->Gshift;
-    bshift = format->Bshift;
-    ashift = format->Ashift;
-    rloss = PG_FORMAT_R_LOSS(format);
-    gloss = PG_FORMAT_G_LOSS(format);
-    bloss = PG_FORMAT_B_LOSS(format);
-    aloss = PG_FORMAT_A_LOSS(format);
-    rtot = gtot = btot = atot = 0;
+    Uint32 sample[9];
+    // Uint32 total[4];
+    int total[4];
 
-    /* make sure the area specified is within the Surface */
-    if ((x + width) > surf->w) {
-        width = surf->w - x;
-    }
-    if ((y + height) > surf->h) {
-        height = surf->h - y;
-    }
-    if (x < 0) {
-        width -= (-x);
-        x = 0;
-    }
-    if (y < 0) {
-        height -= (-y);
-        y = 0;
-    }
+    Uint8 c1r, c1g, c1b, c1a;
+    // Uint32 c1r, c1g, c1b, c1a;
+    Uint8 acolor[4];
 
-    size = width * height;
-    width_and_x = width + x;
-    height_and_y = height + y;
+    Uint32 the_color;
 
-    if (consider_alpha) {
-        switch (PG_FORMAT_BytesPerPixel(format)) {
-            case 1: {
-                Uint8 color8;
-                for (row = y; row < height_and_y; row++) {
-                    pixels = (Uint8 *)surf->pixels + row * surf->pitch + x;
-                    for (col = x; col < width_and_x; col++) {
-                        color8 = *(Uint8 *)pixels;
-                        alpha = ((color8 & amask) >> ashift) << aloss;
-                        atot += alpha;
-                        rtot +=
-                            ((((color8 & rmask) >> rshift) << rloss) * alpha);
-                        gtot +=
-                            ((((color8 & gmask) >> gshift) << gloss) * alpha);
-                        btot +=
-                            ((((color8 & bmask) >> bshift) << bloss) * alpha);
-                        pixels++;
-                    }
-                }
-            } break;
-            case 2:
-                for (row = y; row < height_and_y; row++) {
-                    pixels = (Uint8 *)surf->pixels + row * surf->pitch + x * 2;
-                    for (col = x; col < width_and_x; col++) {
-                        color = (Uint32) * ((Uint16 *)pixels);
-                        alpha = ((color & amask) >> ashift) << aloss;
-                        atot += alpha;
-                        rtot +=
-                            ((((color & rmask) >> rshift) << rloss) * alpha);
-                        gtot +=
-                            ((((color & gmask) >> gshift) << gloss) * alpha);
-                        btot +=
-                            ((((color & bmask) >> bshift) << bloss) * alpha);
-                        pixels += 2;
-                    }
-                }
-                break;
-            case 3:
-                for (row = y; row < height_and_y; row++) {
-                    pixels = (Uint8 *)surf->pixels + row * surf->pitch + x * 3;
-                    for (col = x; col < width_and_x; col++) {
-#if SDL_BYTEORDER == SDL_LIL_ENDIAN
-                        color =
-                            (pixels[0]) + (pixels[1] << 8) + (pixels[2] << 16);
-#else
-                        color =
-                            (pixels[2]) + (pixels[1] << 8) + (pixels[0] << 16);
-#endif
-                        alpha = ((color & amask) >> ashift) << aloss;
-                        atot += alpha;
-                        rtot +=
-                            ((((color & rmask) >> rshift) << rloss) * alpha);
-                        gtot +=
-                            ((((color & gmask) >> gshift) << gloss) * alpha);
-                        btot +=
-                            ((((color & bmask) >> bshift) << bloss) * alpha);
-                        pixels += 3;
-                    }
+    int atmp0;
+    int atmp1;
+    int atmp2;
+    int atmp3;
+
+    Uint8 *pixels, *destpixels;
+    Uint8 *pix;
+
+    Uint8 *byte_buf;
+
+    height = surf->h;
+    width = surf->w;
+
+    pixels = (Uint8 *)surf->pixels;
+    destpixels = (Uint8 *)destsurf->pixels;
+    SDL_Palette *surf_palette = PG_GetSurfacePalette(surf);
+
+    /*
+        -1 -1 -1
+        -1  8 -1
+        -1 -1 -1
+
+        col = (sample[4] * 8) - (sample[0] + sample[1] + sample[2] +
+                                 sample[3] +             sample[5] +
+                                 sample[6] + sample[7] + sample[8])
+
+        [(-1,-1), (0,-1), (1,-1),     (-1,0), (0,0), (1,0),     (-1,1), (0,1),
+       (1,1)]
+
+    */
+
+    for (y = 0; y < height; y++) {
+        for (x = 0; x < width; x++) {
+            // Need to bounds check these accesses.
+
+            if (y > 0) {
+                if (x > 0) {
+                    SURF_GET_AT(sample[0], surf, x + -1, y + -1, pixels,
+                                format, pix);
                 }
-                break;
-            default: /* case 4: */
-                for (row = y; row < height_and_y; row++) {
-                    pixels = (Uint8 *)surf->pixels + row * surf->pitch + x * 4;
-                    for (col = x; col < width_and_x; col++) {
-                        color = *(Uint32 *)pixels;
-                        alpha = ((color & amask) >> ashift) << aloss;
-                        atot += alpha;
-                        rtot +=
-                            ((((color & rmask) >> rshift) << rloss) * alpha);
-                        gtot +=
-                            ((((color & gmask) >> gshift) << gloss) * alpha);
-                        btot +=
-                            ((((color & bmask) >> bshift) << bloss) * alpha);
-                        pixels += 4;
-                    }
+
+                SURF_GET_AT(sample[1], surf, x + 0, y + -1, pixels, format,
+                            pix);
+
+                if (x + 1 < width) {
+                    SURF_GET_AT(sample[2], surf, x + 1, y + -1, pixels, format,
+                                pix);
                 }
-                break;
-        }
-        *a = atot / size;
-        size = (atot == 0 ? size : atot);
-        *r = rtot / size;
-        *g = gtot / size;
-        *b = btot / size;
-    }
-    else {
-        switch (PG_FORMAT_BytesPerPixel(format)) {
-            case 1: {
-                Uint8 color8;
-                for (row = y; row < height_and_y; row++) {
-                    pixels = (Uint8 *)surf->pixels + row * surf->pitch + x;
-                    for (col = x; col < width_and_x; col++) {
-                        color8 = *(Uint8 *)pixels;
-                        rtot += ((color8 & rmask) >> rshift) << rloss;
-                        gtot += ((color8 & gmask) >> gshift) << gloss;
-                        btot += ((color8 & bmask) >> bshift) << bloss;
-                        atot += ((color8 & amask) >> ashift) << aloss;
-                        pixels++;
-                    }
+            }
+            else {
+                sample[0] = LAPLACIAN_NUM;
+                sample[1] = LAPLACIAN_NUM;
+                sample[2] = LAPLACIAN_NUM;
+            }
+
+            if (x > 0) {
+                SURF_GET_AT(sample[3], surf, x + -1, y + 0, pixels, format,
+                            pix);
+            }
+            else {
+                sample[3] = LAPLACIAN_NUM;
+            }
+
+            // SURF_GET_AT(sample[4], surf, x+0 , y+0);
+            sample[4] = 0;
+
+            if (x + 1 < width) {
+                SURF_GET_AT(sample[5], surf, x + 1, y + 0, pixels, format,
+                            pix);
+            }
+            else {
+                sample[5] = LAPLACIAN_NUM;
+            }
+
+            if (y + 1 < height) {
+                if (x > 0) {
+                    SURF_GET_AT(sample[6], surf, x + -1, y + 1, pixels, format,
+                                pix);
                 }
-            } break;
-            case 2:
-                for (row = y; row < height_and_y; row++) {
-                    pixels = (Uint8 *)surf->pixels + row * surf->pitch + x * 2;
-                    for (col = x; col < width_and_x; col++) {
-                        color = (Uint32) * ((Uint16 *)pixels);
-                        rtot += ((color & rmask) >> rshift) << rloss;
-                        gtot += ((color & gmask) >> gshift) << gloss;
-                        btot += ((color & bmask) >> bshift) << bloss;
-                        atot += ((color & amask) >> ashift) << aloss;
-                        pixels += 2;
-                    }
+
+                SURF_GET_AT(sample[7], surf, x + 0, y + 1, pixels, format,
+                            pix);
+
+                if (x + 1 < width) {
+                    SURF_GET_AT(sample[8], surf, x + 1, y + 1, pixels, format,
+                                pix);
                 }
-                break;
-            case 3:
-                for (row = y; row < height_and_y; row++) {
-                    pixels = (Uint8 *)surf->pixels + row * surf->pitch + x * 3;
-                    for (col = x; col < width_and_x; col++) {
-#if SDL_BYTEORDER == SDL_LIL_ENDIAN
-                        color =
-                            (pixels[0]) + (pixels[1] << 8) + (pixels[2] << 16);
+            }
+            else {
+                sample[6] = LAPLACIAN_NUM;
+                sample[7] = LAPLACIAN_NUM;
+                sample[8] = LAPLACIAN_NUM;
+            }
+
+            memset(total, 0, 4 * sizeof(int));
+
+            for (ii = 0; ii < 9; ii++) {
+                PG_GetRGBA(sample[ii], format, surf_palette, &c1r, &c1g, &c1b,
+                           &c1a);
+                total[0] += c1r;
+                total[1] += c1g;
+                total[2] += c1b;
+                total[3] += c1a;
+            }
+
+            SURF_GET_AT(sample[4], surf, x, y, pixels, format, pix);
+
+            PG_GetRGBA(sample[4], format, surf_palette, &c1r, &c1g, &c1b,
+                       &c1a);
+
+            // cast on the right to a signed int, and then clamp to 0-255.
+
+            // atmp = c1r * 8
+
+            atmp0 = c1r * 8;
+            acolor[0] = MIN(MAX(atmp0 - total[0], 0), 255);
+            atmp1 = c1g * 8;
+            acolor[1] = MIN(MAX(atmp1 - total[1], 0), 255);
+            atmp2 = c1b * 8;
+            acolor[2] = MIN(MAX(atmp2 - total[2], 0), 255);
+            atmp3 = c1a * 8;
+            acolor[3] = MIN(MAX(atmp3 - total[3], 0), 255);
+
+            // printf("%d;;%d;;%d;;  ", atmp0, acolor[0],total[0]);
+
+            // printf("%d,%d,%d,%d;;  \n", acolor[0], acolor[1], acolor[2],
+            // acolor[3]);
+
+            // the_color = (Uint32)acolor;
+            // the_color = 0x00000000;
+
+            // cast on the right to Uint32, and then clamp to 255.
+
+            the_color = PG_MapRGBA(format, surf_palette, acolor[0], acolor[1],
+                                   acolor[2], acolor[3]);
+
+            // set_at(destsurf, color, x,y);
+
+            switch (PG_FORMAT_BytesPerPixel(destformat)) {
+                case 1:
+                    *((Uint8 *)destpixels + y * destsurf->pitch + x) =
+                        (Uint8)the_color;
+                    break;
+                case 2:
+                    *((Uint16 *)(destpixels + y * destsurf->pitch) + x) =
+                        (Uint16)the_color;
+                    break;
+                case 3:
+                    byte_buf =
+                        (Uint8 *)(destpixels + y * destsurf->pitch) + x * 3;
+#if (SDL_BYTEORDER == SDL_LIL_ENDIAN)
+                    *(byte_buf + (destformat->Rshift >> 3)) =
+                        (Uint8)(the_color >> format->Rshift);
+                    *(byte_buf + (destformat->Gshift >> 3)) =
+                        (Uint8)(the_color >> format->Gshift);
+                    *(byte_buf + (destformat->Bshift >> 3)) =
+                        (Uint8)(the_color >> format->Bshift);
 #else
-                        color =
-                            (pixels[2]) + (pixels[1] << 8) + (pixels[0] << 16);
+                    *(byte_buf + 2 - (destformat->Rshift >> 3)) =
+                        (Uint8)(the_color >> format->Rshift);
+                    *(byte_buf + 2 - (destformat->Gshift >> 3)) =
+                        (Uint8)(the_color >> format->Gshift);
+                    *(byte_buf + 2 - (destformat->Bshift >> 3)) =
+                        (Uint8)(the_color >> format->Bshift);
 #endif
-                        rtot += ((color & rmask) >> rshift) << rloss;
-                        gtot += ((color & gmask) >> gshift) << gloss;
-                        btot += ((color & bmask) >> bshift) << bloss;
-                        atot += ((color & amask) >> ashift) << aloss;
-                        pixels += 3;
-                    }
-                }
-                break;
-            default: /* case 4: */
-                for (row = y; row < height_and_y; row++) {
-                    pixels = (Uint8 *)surf->pixels + row * surf->pitch + x * 4;
-                    for (col = x; col < width_and_x; col++) {
-                        color = *(Uint32 *)pixels;
-                        rtot += ((color & rmask) >> rshift) << rloss;
-                        gtot += ((color & gmask) >> gshift) << gloss;
+                    break;
+                default:
+                    *((Uint32 *)(destpixels + y * destsurf->pitch) + x) =
+                        the_color;
+                    break;
+            }
+        }
+    }
+}
+
+static PyObject *
+surf_laplacian(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+    PyObject *surfobj, *surfobj2 = NULL;
+    SDL_Surface *surf;
+    SDL_Surface *newsurf;
+    static char *keywords[] = {"surface", "dest_surface", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!|O!", keywords,
+                                     &pgSurface_Type, &surfobj,
+                                     &pgSurface_Type, &surfobj2)) {
+        return NULL;
+    }
+
+    if (surfobj2 && !pgSurface_Unshare((pgSurfaceObject *)surfobj2)) {
+        return NULL;
+    }
+
+    surf = pgSurface_AsSurface(surfobj);
+    SURF_INIT_CHECK(surf)
+
+    /* if the second surface is not there, then make a new one. */
+
+    if (!surfobj2) {
+        int width = surf->w;
+        int height = surf->h;
+
+        newsurf = newsurf_fromsurf(surf, width, height);
+
+        if (!newsurf) {
+            return NULL;
+        }
+    }
+    else {
+        newsurf = pgSurface_AsSurface(surfobj2);
+    }
+
+    /* check to see if the size is the correct size. */
+    if (newsurf->w != (surf->w) || newsurf->h != (surf->h)) {
+        return RAISE(PyExc_ValueError,
+                     "Destination surface not the same size.");
+    }
+
+    /* check to see if the format of the surface is the same. */
+    if (PG_SURF_BytesPerPixel(surf) != PG_SURF_BytesPerPixel(newsurf)) {
+        return RAISE(PyExc_ValueError,
+                     "Source and destination surfaces need the same format.");
+    }
+
+    PG_PixelFormat *surf_format = PG_GetSurfaceFormat(surf);
+    PG_PixelFormat *newsurf_format = PG_GetSurfaceFormat(newsurf);
+    if (surf_format == NULL || newsurf_format == NULL) {
+        return RAISE(pgExc_SDLError, SDL_GetError());
+    }
+
+    SDL_LockSurface(newsurf);
+    SDL_LockSurface(surf);
+
+    Py_BEGIN_ALLOW_THREADS;
+    laplacian(surf, surf_format, newsurf, newsurf_format);
+    Py_END_ALLOW_THREADS;
+
+    SDL_UnlockSurface(surf);
+    SDL_UnlockSurface(newsurf);
+
+    if (surfobj2) {
+        pgSurface_AddDirtyRect((pgSurfaceObject *)surfobj2, NULL);
+        Py_INCREF(surfobj2);
+        return surfobj2;
+    }
+    else {
+        return (PyObject *)pgSurface_New(newsurf);
+    }
+}
+
+int
+average_surfaces(SDL_Surface **surfaces, size_t num_surfaces,
+                 SDL_Surface *destsurf, int palette_colors)
+{
+    /*
+        returns the average surface from the ones given.
+
+        All surfaces need to be the same size.
+
+        palette_colors - if true we average the colors in palette, otherwise we
+            average the pixel values.  This is useful if the surface is
+            actually grayscale colors, and not palette colors.
+
+    */
+
+    Uint32 *accumulate;
+    Uint32 *the_idx;
+    Uint32 the_color;
+    SDL_Surface *surf;
+    size_t surf_idx;
+    int height, width, x, y;
+
+    float div_inv;
+
+    PG_PixelFormat *format, *destformat;
+    SDL_Palette *destpalette;
+    Uint8 *pixels, *destpixels;
+    Uint8 *pix;
+    Uint8 *byte_buf;
+
+    Uint32 rmask, gmask, bmask;
+    int rshift, gshift, bshift, rloss, gloss, bloss;
+    int num_elements;
+
+    if (!num_surfaces) {
+        return 0;
+    }
+
+    height = surfaces[0]->h;
+    width = surfaces[0]->w;
+
+    destpixels = (Uint8 *)destsurf->pixels;
+    if (!PG_GetSurfaceDetails(destsurf, &destformat, &destpalette)) {
+        return -1;
+    }
+
+    /* allocate an array to accumulate them all.
+
+    If we're using 1 byte per pixel, then only need to average on that much.
+    */
+
+    if ((PG_FORMAT_BytesPerPixel(destformat) == 1) && destpalette &&
+        (!palette_colors)) {
+        num_elements = 1;
+    }
+    else {
+        num_elements = 3;
+    }
+
+    accumulate =
+        (Uint32 *)calloc(1, sizeof(Uint32) * height * width * num_elements);
+
+    if (!accumulate) {
+        return -1;
+    }
+
+    /* add up the r,g,b from all the surfaces. */
+
+    for (surf_idx = 0; surf_idx < num_surfaces; surf_idx++) {
+        surf = surfaces[surf_idx];
+
+        pixels = (Uint8 *)surf->pixels;
+        format = PG_GetSurfaceFormat(surf);
+        if (!format) {
+            return -1;
+        }
+        rmask = format->Rmask;
+        gmask = format->Gmask;
+        bmask = format->Bmask;
+        rshift = format->Rshift;
+        gshift = format->Gshift;
+        bshift = format->Bshift;
+        rloss = PG_FORMAT_R_LOSS(format);
+        gloss = PG_FORMAT_G_LOSS(format);
+        bloss = PG_FORMAT_B_LOSS(format);
+
+        the_idx = accumulate;
+        /* If palette surface, we use a different code path... */
+
+        if ((PG_FORMAT_BytesPerPixel(format) == 1 &&
+             PG_FORMAT_BytesPerPixel(destformat) == 1) &&
+            PG_GetSurfacePalette(surf) && (destpalette) && (!palette_colors)) {
+            /*
+            This is useful if the surface is actually grayscale colors,
+            and not palette colors.
+            */
+            for (y = 0; y < height; y++) {
+                for (x = 0; x < width; x++) {
+                    SURF_GET_AT(the_color, surf, x, y, pixels, format, pix);
+                    *(the_idx) += the_color;
+                    the_idx++;
+                }
+            }
+        }
+        else {
+            /* TODO: This doesn't work correctly for palette surfaces yet, when
+               the source is paletted.  Probably need to use something like
+               GET_PIXELVALS_1 from surface.h
+            */
+
+            /* for non palette surfaces, we do this... */
+            for (y = 0; y < height; y++) {
+                for (x = 0; x < width; x++) {
+                    SURF_GET_AT(the_color, surf, x, y, pixels, format, pix);
+
+                    *(the_idx) += ((the_color & rmask) >> rshift) << rloss;
+                    *(the_idx + 1) += ((the_color & gmask) >> gshift) << gloss;
+                    *(the_idx + 2) += ((the_color & bmask) >> bshift) << bloss;
+                    the_idx += 3;
+                }
+            }
+        }
+    }
+
+    /* blit the accumulated array back to the destination surface. */
+
+    div_inv = (float)(1.0L / (num_surfaces));
+
+    the_idx = accumulate;
+
+    if (num_elements == 1 && (!palette_colors)) {
+        /* this is where we are using the palette surface without using its
+        colors from the palette.
+        */
+        for (y = 0; y < height; y++) {
+            for (x = 0; x < width; x++) {
+                the_color = (Uint32)(*(the_idx)*div_inv + .5f);
+                SURF_SET_AT(the_color, destsurf, x, y, destpixels, destformat,
+                            byte_buf);
+                the_idx++;
+            }
+        }
+        /* TODO: will need to handle palette colors.
+         */
+    }
+    else if (num_elements == 3) {
+        for (y = 0; y < height; y++) {
+            for (x = 0; x < width; x++) {
+                the_color = PG_MapRGB(destformat, destpalette,
+                                      (Uint8)(*(the_idx)*div_inv + .5f),
+                                      (Uint8)(*(the_idx + 1) * div_inv + .5f),
+                                      (Uint8)(*(the_idx + 2) * div_inv + .5f));
+
+                /* TODO: should it take into consideration the output
+                    shifts/masks/losses?  Or does SDL_MapRGB do that correctly?
+
+                    *(the_idx) += ((the_color & rmask) >> rshift) << rloss;
+                    *(the_idx + 1) += ((the_color & gmask) >> gshift) << gloss;
+                    *(the_idx + 2) += ((the_color & bmask) >> bshift) << bloss;
+                */
+
+                SURF_SET_AT(the_color, destsurf, x, y, destpixels, destformat,
+                            byte_buf);
+
+                the_idx += 3;
+            }
+        }
+    }
+    else {
+        free(accumulate);
+        return -4;
+    }
+
+    free(accumulate);
+
+    return 1;
+}
+
+/*
+    returns the average surface from the ones given.
+
+    All surfaces need to be the same size.
+
+    palette_colors - if true we average the colors in palette, otherwise we
+        average the pixel values.  This is useful if the surface is
+        actually grayscale colors, and not palette colors.
+
+*/
+static PyObject *
+surf_average_surfaces(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+    PyObject *surfobj2 = NULL;
+    SDL_Surface *surf;
+    SDL_Surface *newsurf = NULL;
+    SDL_Surface **surfaces;
+    int width, height;
+    int an_error = 0;
+    size_t size, loop, loop_up_to;
+    int palette_colors = 1;
+    PyObject *list, *obj;
+    PyObject *ret = NULL;
+    static char *keywords[] = {"surfaces", "dest_surface", "palette_colors",
+                               NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|O!i", keywords, &list,
+                                     &pgSurface_Type, &surfobj2,
+                                     &palette_colors)) {
+        return NULL;
+    }
+
+    if (surfobj2 && !pgSurface_Unshare((pgSurfaceObject *)surfobj2)) {
+        return NULL;
+    }
+
+    if (!PySequence_Check(list)) {
+        return RAISE(PyExc_TypeError,
+                     "Argument must be a sequence of surface objects.");
+    }
+
+    size = PySequence_Length(list); /*warning, size could be -1 on error?*/
+
+    if (size < 1) {
+        return RAISE(PyExc_TypeError,
+                     "Needs to be given at least one surface.");
+    }
+
+    /* Allocate an array of surface pointers. */
+
+    surfaces = (SDL_Surface **)calloc(1, sizeof(SDL_Surface *) * size);
+
+    if (!surfaces) {
+        return RAISE(PyExc_MemoryError,
+                     "Not enough memory to store surfaces.\n");
+    }
+
+    /* Iterate over 'surfaces' passed in. */
+
+    /* need to get the first surface to see how big it is */
+
+    for (loop = 0; loop < size; ++loop) {
+        obj = PySequence_GetItem(list, loop);
+
+        if (!obj) {
+            Py_XDECREF(obj);
+            ret = RAISE(PyExc_TypeError, "Needs to be a surface object.");
+            an_error = 1;
+            break;
+        }
+
+        if (!pgSurface_Check(obj)) {
+            Py_XDECREF(obj);
+            ret = RAISE(PyExc_TypeError, "Needs to be a surface object.");
+            an_error = 1;
+            break;
+        }
+
+        surf = pgSurface_AsSurface(obj);
+
+        if (!surf) {
+            Py_XDECREF(obj);
+            ret = RAISE(PyExc_TypeError, "Needs to be a surface object.");
+            an_error = 1;
+            break;
+        }
+
+        if (loop == 0) {
+            /* if the second surface is not there, then make a new one. */
+            if (!surfobj2) {
+                width = surf->w;
+                height = surf->h;
+
+                newsurf = newsurf_fromsurf(surf, width, height);
+
+                if (!newsurf) {
+                    Py_XDECREF(obj);
+                    ret = RAISE(PyExc_ValueError,
+                                "Could not create new surface.");
+                    an_error = 1;
+                    break;
+                }
+            }
+            else {
+                newsurf = pgSurface_AsSurface(surfobj2);
+            }
+
+            /* check to see if the size is the correct size. */
+            if (newsurf->w != (surf->w) || newsurf->h != (surf->h)) {
+                Py_XDECREF(obj);
+                ret = RAISE(PyExc_ValueError,
+                            "Destination surface not the same size.");
+                an_error = 1;
+                break;
+            }
+
+            /* check to see if the format of the surface is the same. */
+            if (PG_SURF_BytesPerPixel(surf) !=
+                PG_SURF_BytesPerPixel(newsurf)) {
+                Py_XDECREF(obj);
+                ret = RAISE(
+                    PyExc_ValueError,
+                    "Source and destination surfaces need the same format.");
+                an_error = 1;
+                break;
+            }
+        }
+
+        /* Copy surface pointer, and also lock surface. */
+        SDL_LockSurface(surf);
+        surfaces[loop] = surf;
+
+        Py_DECREF(obj);
+    }
+
+    loop_up_to = loop;
+
+    if (!an_error) {
+        /* Process images, get average surface. */
+
+        SDL_LockSurface(newsurf);
+
+        Py_BEGIN_ALLOW_THREADS;
+        average_surfaces(surfaces, size, newsurf, palette_colors);
+        Py_END_ALLOW_THREADS;
+
+        SDL_UnlockSurface(newsurf);
+
+        if (surfobj2) {
+            pgSurface_AddDirtyRect((pgSurfaceObject *)surfobj2, NULL);
+            Py_INCREF(surfobj2);
+            ret = surfobj2;
+        }
+        else {
+            ret = (PyObject *)pgSurface_New(newsurf);
+        }
+    }
+
+    /* cleanup */
+
+    /* unlock the surfaces we got up to. */
+
+    for (loop = 0; loop < loop_up_to; loop++) {
+        if (surfaces[loop]) {
+            SDL_UnlockSurface(surfaces[loop]);
+        }
+    }
+
+    free(surfaces);
+
+    return ret;
+}
+
+/* VS 2015 crashes when compiling this function, turning off optimisations to
+ try to fix it */
+#if defined(_MSC_VER) && (_MSC_VER == 1900)
+#pragma optimize("", off)
+#endif
+
+/* When GCC compiles the following function with -O3 on PPC64 little endian,
+ * the function gives incorrect output with 24-bit surfaces. This is most
+ * likely a compiler bug, see #2876 for related issue.
+ * So turn optimisations off here */
+#if defined(__GNUC__) && defined(__PPC64__)
+#pragma GCC push_options
+#pragma GCC optimize("O0")
+#endif
+
+void
+average_color(SDL_Surface *surf, PG_PixelFormat *format, int x, int y,
+              int width, int height, Uint8 *r, Uint8 *g, Uint8 *b, Uint8 *a,
+              SDL_bool consider_alpha)
+{
+    Uint32 color, rmask, gmask, bmask, amask;
+    Uint8 *pixels;
+    unsigned int rtot, gtot, btot, atot, size, rshift, gshift, bshift, ashift,
+        alpha;
+    unsigned int rloss, gloss, bloss, aloss;
+    int row, col, width_and_x, height_and_y;
+
+    rmask = format->Rmask;
+    gmask = format->Gmask;
+    bmask = format->Bmask;
+    amask = format->Amask;
+    rshift = format->Rshift;
+    gshift = format->Gshift;
+    bshift = format->Bshift;
+    ashift = format->Ashift;
+    rloss = PG_FORMAT_R_LOSS(format);
+    gloss = PG_FORMAT_G_LOSS(format);
+    bloss = PG_FORMAT_B_LOSS(format);
+    aloss = PG_FORMAT_A_LOSS(format);
+    rtot = gtot = btot = atot = 0;
+
+    /* make sure the area specified is within the Surface */
+    if ((x + width) > surf->w) {
+        width = surf->w - x;
+    }
+    if ((y + height) > surf->h) {
+        height = surf->h - y;
+    }
+    if (x < 0) {
+        width -= (-x);
+        x = 0;
+    }
+    if (y < 0) {
+        height -= (-y);
+        y = 0;
+    }
+
+    size = width * height;
+    width_and_x = width + x;
+    height_and_y = height + y;
+
+    if (consider_alpha) {
+        switch (PG_FORMAT_BytesPerPixel(format)) {
+            case 1: {
+                Uint8 color8;
+                for (row = y; row < height_and_y; row++) {
+                    pixels = (Uint8 *)surf->pixels + row * surf->pitch + x;
+                    for (col = x; col < width_and_x; col++) {
+                        color8 = *(Uint8 *)pixels;
+                        alpha = ((color8 & amask) >> ashift) << aloss;
+                        atot += alpha;
+                        rtot +=
+                            ((((color8 & rmask) >> rshift) << rloss) * alpha);
+                        gtot +=
+                            ((((color8 & gmask) >> gshift) << gloss) * alpha);
+                        btot +=
+                            ((((color8 & bmask) >> bshift) << bloss) * alpha);
+                        pixels++;
+                    }
+                }
+            } break;
+            case 2:
+                for (row = y; row < height_and_y; row++) {
+                    pixels = (Uint8 *)surf->pixels + row * surf->pitch + x * 2;
+                    for (col = x; col < width_and_x; col++) {
+                        color = (Uint32) * ((Uint16 *)pixels);
+                        alpha = ((color & amask) >> ashift) << aloss;
+                        atot += alpha;
+                        rtot +=
+                            ((((color & rmask) >> rshift) << rloss) * alpha);
+                        gtot +=
+                            ((((color & gmask) >> gshift) << gloss) * alpha);
+                        btot +=
+                            ((((color & bmask) >> bshift) << bloss) * alpha);
+                        pixels += 2;
+                    }
+                }
+                break;
+            case 3:
+                for (row = y; row < height_and_y; row++) {
+                    pixels = (Uint8 *)surf->pixels + row * surf->pitch + x * 3;
+                    for (col = x; col < width_and_x; col++) {
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+                        color =
+                            (pixels[0]) + (pixels[1] << 8) + (pixels[2] << 16);
+#else
+                        color =
+                            (pixels[2]) + (pixels[1] << 8) + (pixels[0] << 16);
+#endif
+                        alpha = ((color & amask) >> ashift) << aloss;
+                        atot += alpha;
+                        rtot +=
+                            ((((color & rmask) >> rshift) << rloss) * alpha);
+                        gtot +=
+                            ((((color & gmask) >> gshift) << gloss) * alpha);
+                        btot +=
+                            ((((color & bmask) >> bshift) << bloss) * alpha);
+                        pixels += 3;
+                    }
+                }
+                break;
+            default: /* case 4: */
+                for (row = y; row < height_and_y; row++) {
+                    pixels = (Uint8 *)surf->pixels + row * surf->pitch + x * 4;
+                    for (col = x; col < width_and_x; col++) {
+                        color = *(Uint32 *)pixels;
+                        alpha = ((color & amask) >> ashift) << aloss;
+                        atot += alpha;
+                        rtot +=
+                            ((((color & rmask) >> rshift) << rloss) * alpha);
+                        gtot +=
+                            ((((color & gmask) >> gshift) << gloss) * alpha);
+                        btot +=
+                            ((((color & bmask) >> bshift) << bloss) * alpha);
+                        pixels += 4;
+                    }
+                }
+                break;
+        }
+        *a = atot / size;
+        size = (atot == 0 ? size : atot);
+        *r = rtot / size;
+        *g = gtot / size;
+        *b = btot / size;
+    }
+    else {
+        switch (PG_FORMAT_BytesPerPixel(format)) {
+            case 1: {
+                Uint8 color8;
+                for (row = y; row < height_and_y; row++) {
+                    pixels = (Uint8 *)surf->pixels + row * surf->pitch + x;
+                    for (col = x; col < width_and_x; col++) {
+                        color8 = *(Uint8 *)pixels;
+                        rtot += ((color8 & rmask) >> rshift) << rloss;
+                        gtot += ((color8 & gmask) >> gshift) << gloss;
+                        btot += ((color8 & bmask) >> bshift) << bloss;
+                        atot += ((color8 & amask) >> ashift) << aloss;
+                        pixels++;
+                    }
+                }
+            } break;
+            case 2:
+                for (row = y; row < height_and_y; row++) {
+                    pixels = (Uint8 *)surf->pixels + row * surf->pitch + x * 2;
+                    for (col = x; col < width_and_x; col++) {
+                        color = (Uint32) * ((Uint16 *)pixels);
+                        rtot += ((color & rmask) >> rshift) << rloss;
+                        gtot += ((color & gmask) >> gshift) << gloss;
+                        btot += ((color & bmask) >> bshift) << bloss;
+                        atot += ((color & amask) >> ashift) << aloss;
+                        pixels += 2;
+                    }
+                }
+                break;
+            case 3:
+                for (row = y; row < height_and_y; row++) {
+                    pixels = (Uint8 *)surf->pixels + row * surf->pitch + x * 3;
+                    for (col = x; col < width_and_x; col++) {
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+                        color =
+                            (pixels[0]) + (pixels[1] << 8) + (pixels[2] << 16);
+#else
+                        color =
+                            (pixels[2]) + (pixels[1] << 8) + (pixels[0] << 16);
+#endif
+                        rtot += ((color & rmask) >> rshift) << rloss;
+                        gtot += ((color & gmask) >> gshift) << gloss;
+                        btot += ((color & bmask) >> bshift) << bloss;
+                        atot += ((color & amask) >> ashift) << aloss;
+                        pixels += 3;
+                    }
+                }
+                break;
+            default: /* case 4: */
+                for (row = y; row < height_and_y; row++) {
+                    pixels = (Uint8 *)surf->pixels + row * surf->pitch + x * 4;
+                    for (col = x; col < width_and_x; col++) {
+                        color = *(Uint32 *)pixels;
+                        rtot += ((color & rmask) >> rshift) << rloss;
+                        gtot += ((color & gmask) >> gshift) << gloss;
                         btot += ((color & bmask) >> bshift) << bloss;
                         atot += ((color & amask) >> ashift) << aloss;
                         pixels += 4;
@@ -3710,405 +4845,1943 @@ average_color(SDL_Surface *surf, PG_PixelFormat *format, int x, int y,
                 }
                 break;
         }
-        *r = rtot / size;
-        *g = gtot / size;
-        *b = btot / size;
-        *a = atot / size;
+        *r = rtot / size;
+        *g = gtot / size;
+        *b = btot / size;
+        *a = atot / size;
+    }
+}
+
+/* Optimisation was only disabled for one function - see above */
+#if defined(_MSC_VER) && (_MSC_VER == 1900)
+#pragma optimize("", on)
+#endif
+
+/* Optimisation was only disabled for one function on GCC+PPC64 - see above */
+#if defined(__GNUC__) && defined(__PPC64__)
+#pragma GCC pop_options
+#endif
+
+static PyObject *
+surf_average_color(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+    pgSurfaceObject *surfobj;
+    PyObject *rectobj = NULL;
+    SDL_Surface *surf;
+    SDL_Rect *rect, temp;
+    Uint8 r, g, b, a;
+    int x, y, w, h;
+    static char *keywords[] = {"surface", "rect", "consider_alpha", NULL};
+    int consider_alpha = SDL_FALSE;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!|Op", keywords,
+                                     &pgSurface_Type, &surfobj, &rectobj,
+                                     &consider_alpha)) {
+        return NULL;
+    }
+
+    surf = pgSurface_AsSurface(surfobj);
+    pgSurface_LockRead(surfobj);
+
+    if (!rectobj) {
+        x = 0;
+        y = 0;
+        w = surf->w;
+        h = surf->h;
+    }
+    else {
+        if (!(rect = pgRect_FromObject(rectobj, &temp))) {
+            return RAISE(PyExc_TypeError, "Rect argument is invalid");
+        }
+        x = rect->x;
+        y = rect->y;
+        w = rect->w;
+        h = rect->h;
+    }
+
+    PG_PixelFormat *surf_format = PG_GetSurfaceFormat(surf);
+    if (surf_format == NULL) {
+        return RAISE(pgExc_SDLError, SDL_GetError());
+    }
+
+    Py_BEGIN_ALLOW_THREADS;
+    average_color(surf, surf_format, x, y, w, h, &r, &g, &b, &a,
+                  consider_alpha);
+    Py_END_ALLOW_THREADS;
+
+    pgSurface_Unlock(surfobj);
+    return Py_BuildValue("(bbbb)", r, g, b, a);
+}
+
+static int
+box_blur(SDL_Surface *src, SDL_Surface *dst, int radius, SDL_bool repeat)
+{
+    // Reference : https://blog.csdn.net/blogshinelee/article/details/80997324
+
+    Uint8 *srcpx = (Uint8 *)src->pixels;
+    Uint8 *dstpx = (Uint8 *)dst->pixels;
+    Uint8 nb = PG_SURF_BytesPerPixel(src);
+    int w = dst->w, h = dst->h;
+    int dst_pitch = dst->pitch;
+    int src_pitch = src->pitch;
+    int i, x, y, color;
+
+    // Allocate bytes for buf, sum_v, and sum_h at once to reduce allocations.
+    Uint32 *overall_buf = malloc(sizeof(Uint32) * (dst_pitch * 2 + nb));
+    Uint32 *buf = overall_buf;
+    Uint32 *sum_v = overall_buf + dst_pitch;
+    Uint32 *sum_h = overall_buf + dst_pitch * 2;
+
+    if (overall_buf == NULL) {
+        return -1;
+    }
+
+    memset(sum_v, 0, dst_pitch * sizeof(Uint32));
+    for (y = 0; y <= radius; y++) {  // y-pre
+        for (i = 0; i < dst_pitch; i++) {
+            sum_v[i] += srcpx[src_pitch * y + i];
+        }
+    }
+    if (repeat) {
+        for (i = 0; i < dst_pitch; i++) {
+            sum_v[i] += srcpx[i] * radius;
+        }
+    }
+    for (y = 0; y < h; y++) {  // y
+        for (i = 0; i < dst_pitch; i++) {
+            buf[i] = sum_v[i] / (radius * 2 + 1);
+
+            // update vertical sum
+            if (y - radius >= 0) {
+                sum_v[i] -= srcpx[src_pitch * (y - radius) + i];
+            }
+            else if (repeat) {
+                sum_v[i] -= srcpx[i];
+            }
+            if (y + radius + 1 < h) {
+                sum_v[i] += srcpx[src_pitch * (y + radius + 1) + i];
+            }
+            else if (repeat) {
+                sum_v[i] += srcpx[src_pitch * (h - 1) + i];
+            }
+        }
+
+        memset(sum_h, 0, nb * sizeof(Uint32));
+        for (x = 0; x <= radius; x++) {  // x-pre
+            for (color = 0; color < nb; color++) {
+                sum_h[color] += buf[x * nb + color];
+            }
+        }
+        if (repeat) {
+            for (color = 0; color < nb; color++) {
+                sum_h[color] += buf[color] * radius;
+            }
+        }
+        for (x = 0; x < w; x++) {  // x
+            for (color = 0; color < nb; color++) {
+                dstpx[dst_pitch * y + nb * x + color] =
+                    sum_h[color] / (radius * 2 + 1);
+
+                // update horizontal sum
+                if (x - radius >= 0) {
+                    sum_h[color] -= buf[(x - radius) * nb + color];
+                }
+                else if (repeat) {
+                    sum_h[color] -= buf[color];
+                }
+                if (x + radius + 1 < w) {
+                    sum_h[color] += buf[(x + radius + 1) * nb + color];
+                }
+                else if (repeat) {
+                    sum_h[color] += buf[(w - 1) * nb + color];
+                }
+            }
+        }
+    }
+
+    free(overall_buf);
+    return 0;
+}
+
+static int
+gaussian_blur(SDL_Surface *src, SDL_Surface *dst, int sigma, SDL_bool repeat)
+{
+    Uint8 *srcpx = (Uint8 *)src->pixels;
+    Uint8 *dstpx = (Uint8 *)dst->pixels;
+    Uint8 nb = PG_SURF_BytesPerPixel(src);
+    int w = dst->w, h = dst->h;
+    int dst_pitch = dst->pitch;
+    int src_pitch = src->pitch;
+    int i, j, x, y, color;
+    int kernel_radius = sigma * 2;
+    float lut_sum = 0.0;
+
+    // Allocate bytes for buf, buf2, and lut at once to reduce allocations.
+    float *overall_buf =
+        malloc(sizeof(float) * (dst_pitch * 2 + kernel_radius + 1));
+    float *buf = overall_buf;
+    float *buf2 = overall_buf + dst_pitch;
+    float *lut = overall_buf + dst_pitch * 2;
+
+    if (overall_buf == NULL) {
+        return -1;
+    }
+
+    for (i = 0; i <= kernel_radius; i++) {  // init gaussian lut
+        // Gaussian function
+        lut[i] =
+            expf(-powf((float)i, 2.0f) / (2.0f * powf((float)sigma, 2.0f)));
+        lut_sum += lut[i] * 2;
+    }
+    lut_sum -= lut[0];
+    for (i = 0; i <= kernel_radius; i++) {
+        lut[i] /= lut_sum;
+    }
+
+    for (i = 0; i < dst_pitch; i++) {
+        buf[i] = 0.0;
+        buf2[i] = 0.0;
+    }
+
+    for (y = 0; y < h; y++) {
+        for (j = -kernel_radius; j <= kernel_radius; j++) {
+            for (i = 0; i < dst_pitch; i++) {
+                if (y + j >= 0 && y + j < h) {
+                    buf[i] +=
+                        (float)srcpx[src_pitch * (y + j) + i] * lut[abs(j)];
+                }
+                else if (repeat) {
+                    if (y + j < 0) {
+                        buf[i] += (float)srcpx[i] * lut[abs(j)];
+                    }
+                    else {
+                        buf[i] += (float)srcpx[src_pitch * (h - 1) + i] *
+                                  lut[abs(j)];
+                    }
+                }
+            }
+        }
+
+        for (x = 0; x < w; x++) {
+            for (j = -kernel_radius; j <= kernel_radius; j++) {
+                for (color = 0; color < nb; color++) {
+                    if (x + j >= 0 && x + j < w) {
+                        buf2[nb * x + color] +=
+                            buf[nb * (x + j) + color] * lut[abs(j)];
+                    }
+                    else if (repeat) {
+                        if (x + j < 0) {
+                            buf2[nb * x + color] += buf[color] * lut[abs(j)];
+                        }
+                        else {
+                            buf2[nb * x + color] +=
+                                buf[nb * (w - 1) + color] * lut[abs(j)];
+                        }
+                    }
+                }
+            }
+        }
+        for (i = 0; i < dst_pitch; i++) {
+            dstpx[dst_pitch * y + i] = (Uint8)buf2[i];
+            buf[i] = 0.0;
+            buf2[i] = 0.0;
+        }
+    }
+
+    free(overall_buf);
+    return 0;
+}
+
+/* The fast gaussian blur runs three box blurs in a row, which come close to
+ * a gaussian blur at a cost per pixel that does not depend on the radius.
+ * The box sizes are picked to match the given standard deviation, see
+ * https://peterkovesi.com/papers/FastGaussianSmoothing.pdf */
+static void
+_fastblur_radii(int sigma, int radii[3])
+{
+    double variance = 12.0 * sigma * sigma;
+    int lower = (int)floor(sqrt(variance / 3 + 1));
+    int count, i;
+
+    if (lower % 2 == 0) {
+        lower--;
+    }
+    /* how many of the boxes use the lower odd size */
+    count = (int)floor((variance - 3.0 * lower * lower - 12.0 * lower - 9.0) /
+                           (-4.0 * lower - 4.0) +
+                       0.5);
+    for (i = 0; i < 3; i++) {
+        radii[i] = ((i < count ? lower : lower + 2) - 1) / 2;
+    }
+}
+
+/* Box blurs a row of pixels with nb bytes, like fastblur_row_sse2 */
+static void
+fastblur_row(const Uint8 *src, Uint8 *dst, int width, int nb, int radius,
+             int repeat)
+{
+    float inv = 1.0f / (radius * 2 + 1);
+    int x, k, c;
+
+    for (c = 0; c < nb; c++) {
+        const Uint8 *srcp = src + c;
+        Uint32 first = repeat ? srcp[0] : 0;
+        Uint32 last = repeat ? srcp[(size_t)(width - 1) * nb] : 0;
+        Uint32 sum = 0;
+
+/* channel c of pixel k */
+#define _PG_BLUR_PIXEL(k) \
+    ((k) < 0 ? first : ((k) >= width ? last : srcp[(size_t)(k) * nb]))
+
+        for (k = -radius; k <= radius; k++) {
+            sum += _PG_BLUR_PIXEL(k);
+        }
+        for (x = 0; x < width; x++) {
+            dst[(size_t)x * nb + c] = (Uint8)((float)sum * inv + 0.5f);
+            sum += _PG_BLUR_PIXEL(x + radius + 1);
+            sum -= _PG_BLUR_PIXEL(x - radius);
+        }
+#undef _PG_BLUR_PIXEL
+    }
+}
+
+/* Box blurs count bytes of each row down the columns, like
+ * fastblur_columns_sse2 */
+static void
+fastblur_columns(const Uint8 *src, int src_pitch, Uint8 *dst, int dst_pitch,
+                 Uint32 *sums, int height, int count, int radius, int repeat)
+{
+    float inv = 1.0f / (radius * 2 + 1);
+    const Uint8 *add, *sub;
+    int i, k, y;
+
+/* row k of src, NULL past the ends without repeat */
+#define _PG_BLUR_ROW(k)                                               \
+    ((k) < 0 ? (repeat ? src : NULL)                                  \
+             : ((k) >= height ? (repeat ? src + (size_t)(height - 1) * \
+                                                  src_pitch            \
+                                        : NULL)                       \
+                              : src + (size_t)(k) * src_pitch))
+
+    memset(sums, 0, sizeof(Uint32) * count);
+    for (k = -radius; k <= radius; k++) {
+        add = _PG_BLUR_ROW(k);
+        if (add) {
+            for (i = 0; i < count; i++) {
+                sums[i] += add[i];
+            }
+        }
+    }
+
+    for (y = 0; y < height; y++) {
+        Uint8 *dstrow = dst + (size_t)y * dst_pitch;
+
+        add = _PG_BLUR_ROW(y + radius + 1);
+        sub = _PG_BLUR_ROW(y - radius);
+        for (i = 0; i < count; i++) {
+            dstrow[i] = (Uint8)((float)sums[i] * inv + 0.5f);
+            if (add) {
+                sums[i] += add[i];
+            }
+            if (sub) {
+                sums[i] -= sub[i];
+            }
+        }
+    }
+#undef _PG_BLUR_ROW
+}
+
+typedef struct {
+    const Uint8 *srcpx;
+    Uint8 *tmppx;
+    Uint8 *dstpx;
+    Uint32 *sums;
+    int src_pitch;
+    int tmp_pitch;
+    int dst_pitch;
+    int w, h, nb;
+    int radii[3];
+    int repeat;
+    int simd;
+} pgFastBlur;
+
+static PG_INLINE void
+_fastblur_row(pgFastBlur *blur, const Uint8 *src, Uint8 *dst, int radius)
+{
+#if !defined(__EMSCRIPTEN__)
+#if defined(__SSE2__) || defined(PG_ENABLE_ARM_NEON)
+    if (blur->simd && blur->nb == 4) {
+        fastblur_row_sse2(src, dst, blur->w, radius, blur->repeat);
+        return;
+    }
+#endif /* defined(__SSE2__) || defined(PG_ENABLE_ARM_NEON) */
+#endif /* !defined(__EMSCRIPTEN__) */
+    fastblur_row(src, dst, blur->w, blur->nb, radius, blur->repeat);
+}
+
+static PG_INLINE void
+_fastblur_columns(pgFastBlur *blur, const Uint8 *src, int src_pitch,
+                  Uint8 *dst, int dst_pitch, Uint32 *sums, int count,
+                  int radius)
+{
+#if !defined(__EMSCRIPTEN__)
+#if defined(__SSE2__) || defined(PG_ENABLE_ARM_NEON)
+    if (blur->simd) {
+        fastblur_columns_sse2(src, src_pitch, dst, dst_pitch, sums, blur->h,
+                              count, radius, blur->repeat);
+        return;
+    }
+#endif /* defined(__SSE2__) || defined(PG_ENABLE_ARM_NEON) */
+#endif /* !defined(__EMSCRIPTEN__) */
+    fastblur_columns(src, src_pitch, dst, dst_pitch, sums, blur->h, count,
+                     radius, blur->repeat);
+}
+
+/* The horizontal boxes of a band of rows, from src to tmp to dst to tmp */
+static void
+_fastblur_rows_band(void *data, int start, int end)
+{
+    pgFastBlur *blur = (pgFastBlur *)data;
+    int y;
+
+    for (y = start; y < end; y++) {
+        const Uint8 *srcrow = blur->srcpx + (size_t)y * blur->src_pitch;
+        Uint8 *tmprow = blur->tmppx + (size_t)y * blur->tmp_pitch;
+        Uint8 *dstrow = blur->dstpx + (size_t)y * blur->dst_pitch;
+
+        _fastblur_row(blur, srcrow, tmprow, blur->radii[0]);
+        _fastblur_row(blur, tmprow, dstrow, blur->radii[1]);
+        _fastblur_row(blur, dstrow, tmprow, blur->radii[2]);
+    }
+}
+
+/* The vertical boxes of a band of columns, from tmp to dst to tmp to dst */
+static void
+_fastblur_columns_band(void *data, int start, int end)
+{
+    pgFastBlur *blur = (pgFastBlur *)data;
+    size_t offset = (size_t)start * blur->nb;
+    int count = (end - start) * blur->nb;
+    Uint8 *tmp = blur->tmppx + offset;
+    Uint8 *dst = blur->dstpx + offset;
+    Uint32 *sums = blur->sums + offset;
+
+    _fastblur_columns(blur, tmp, blur->tmp_pitch, dst, blur->dst_pitch, sums,
+                      count, blur->radii[0]);
+    _fastblur_columns(blur, dst, blur->dst_pitch, tmp, blur->tmp_pitch, sums,
+                      count, blur->radii[1]);
+    _fastblur_columns(blur, tmp, blur->tmp_pitch, dst, blur->dst_pitch, sums,
+                      count, blur->radii[2]);
+}
+
+static int
+fast_gaussian_blur(SDL_Surface *src, SDL_Surface *dst, int sigma,
+                   SDL_bool repeat)
+{
+    pgFastBlur blur;
+    Py_ssize_t work = (Py_ssize_t)dst->w * dst->h;
+    int bands;
+
+    blur.srcpx = (const Uint8 *)src->pixels;
+    blur.dstpx = (Uint8 *)dst->pixels;
+    blur.src_pitch = src->pitch;
+    blur.dst_pitch = dst->pitch;
+    blur.w = dst->w;
+    blur.h = dst->h;
+    blur.nb = PG_SURF_BytesPerPixel(src);
+    blur.tmp_pitch = blur.w * blur.nb;
+    blur.repeat = repeat;
+    blur.simd = 0;
+#if !defined(__EMSCRIPTEN__)
+#if defined(__SSE2__) || defined(PG_ENABLE_ARM_NEON)
+    blur.simd = pg_HasSSE_NEON();
+#endif /* defined(__SSE2__) || defined(PG_ENABLE_ARM_NEON) */
+#endif /* !defined(__EMSCRIPTEN__) */
+    _fastblur_radii(sigma, blur.radii);
+
+    // Allocate bytes for the pixels and the column sums at once.
+    blur.sums = malloc(sizeof(Uint32) * blur.tmp_pitch +
+                       (size_t)blur.tmp_pitch * blur.h);
+    if (blur.sums == NULL) {
+        return -1;
+    }
+    blur.tmppx = (Uint8 *)(blur.sums + blur.tmp_pitch);
+
+    bands = pg_ParallelBandCount(blur.h, work * 3);
+    if (bands > 1) {
+        pg_ParallelForRows(blur.h, bands, _fastblur_rows_band, &blur);
+    }
+    else {
+        _fastblur_rows_band(&blur, 0, blur.h);
+    }
+
+    bands = pg_ParallelBandCount(blur.w, work * 3);
+    if (bands > 1) {
+        pg_ParallelForRows(blur.w, bands, _fastblur_columns_band, &blur);
+    }
+    else {
+        _fastblur_columns_band(&blur, 0, blur.w);
+    }
+
+    free(blur.sums);
+    return 0;
+}
+
+/* Checks the surfaces of filters writing a surface of the same size and
+ * format as the source, and returns dstobj's surface or a new one. The
+ * errors are worded with verb and routines, e.g. "blurred" and "Blur". */
+static SDL_Surface *
+_filter_dest_surface(pgSurfaceObject *srcobj, pgSurfaceObject *dstobj,
+                     const char *verb, const char *routines)
+{
+    SDL_Surface *src = pgSurface_AsSurface(srcobj);
+    SDL_Surface *retsurf = NULL;
+
+    if (PG_GetSurfacePalette(src)) {
+        PyErr_Format(PyExc_ValueError, "Indexed surfaces cannot be %s.",
+                     verb);
+        return NULL;
+    }
+
+    if (!dstobj) {
+        retsurf = newsurf_fromsurf(src, src->w, src->h);
+        if (!retsurf) {
+            return NULL;
+        }
+    }
+    else {
+        retsurf = pgSurface_AsSurface(dstobj);
+    }
+
+    if ((retsurf->w) != (src->w) || (retsurf->h) != (src->h)) {
+        return RAISE(PyExc_ValueError,
+                     "Destination surface not the same size.");
+    }
+
+    if (retsurf->w == 0 || retsurf->h == 0) {
+        return retsurf;
+    }
+
+    Uint8 *ret_start = retsurf->pixels;
+    Uint8 *ret_end = ret_start + retsurf->h * retsurf->pitch;
+    Uint8 *src_start = src->pixels;
+    Uint8 *src_end = src_start + src->h * src->pitch;
+    if ((ret_start <= src_start && ret_end >= src_start) ||
+        (src_start <= ret_start && src_end >= ret_start)) {
+        PyErr_Format(
+            PyExc_ValueError,
+            "%s routines do not support dest_surfaces that share pixels "
+            "with the source surface. Likely the surfaces are the same, one "
+            "of them is a subsurface, or they are sharing the same buffer.",
+            routines);
+        return NULL;
+    }
+
+    if (PG_SURF_BytesPerPixel(src) != PG_SURF_BytesPerPixel(retsurf)) {
+        return (SDL_Surface *)(RAISE(
+            PyExc_ValueError,
+            "Source and destination surfaces need the same format."));
+    }
+
+    return retsurf;
+}
+
+static SDL_Surface *
+blur(pgSurfaceObject *srcobj, pgSurfaceObject *dstobj, int radius,
+     SDL_bool repeat, char algorithm)
+{
+    SDL_Surface *src = NULL;
+    SDL_Surface *retsurf = NULL;
+    int result = 0;
+
+    if (radius < 0) {
+        return RAISE(PyExc_ValueError,
+                     "The radius should not be less than zero.");
+    }
+
+    src = pgSurface_AsSurface(srcobj);
+    retsurf = _filter_dest_surface(srcobj, dstobj, "blurred", "Blur");
+    if (!retsurf) {
+        return NULL;
+    }
+
+    if (retsurf->w == 0 || retsurf->h == 0) {
+        return retsurf;
+    }
+
+    if (radius > MIN(src->w, src->h)) {
+        radius = MIN(src->w, src->h) - 1;
+    }
+
+    SDL_LockSurface(retsurf);
+    pgSurface_LockRead(srcobj);
+
+    Py_BEGIN_ALLOW_THREADS;
+
+    if (algorithm == 'b') {
+        result = box_blur(src, retsurf, radius, repeat);
+    }
+    else if (algorithm == 'g') {
+        result = gaussian_blur(src, retsurf, radius, repeat);
+    }
+    else if (algorithm == 'f') {
+        result = fast_gaussian_blur(src, retsurf, radius, repeat);
+    }
+
+    Py_END_ALLOW_THREADS;
+
+    pgSurface_Unlock(srcobj);
+    SDL_UnlockSurface(retsurf);
+
+    // Routines only set error flag if memory allocation failed
+    // Setting Python exception here outside of Py_ THREADS block to be safe
+    if (result) {
+        PyErr_NoMemory();
+        return NULL;
+    }
+
+    return retsurf;
+}
+
+static PyObject *
+surf_box_blur(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+    pgSurfaceObject *dst_surf_obj = NULL;
+    pgSurfaceObject *src_surf_obj;
+    SDL_Surface *new_surf = NULL;
+    int repeat_edge_pixels = SDL_TRUE;
+
+    int radius;
+
+    static char *kwlist[] = {"surface", "radius", "repeat_edge_pixels",
+                             "dest_surface", 0};
+
+    if (!PyArg_ParseTupleAndKeywords(
+            args, kwargs, "O!i|pO!", kwlist, &pgSurface_Type, &src_surf_obj,
+            &radius, &repeat_edge_pixels, &pgSurface_Type, &dst_surf_obj)) {
+        return NULL;
+    }
+
+    if (dst_surf_obj && !pgSurface_Unshare(dst_surf_obj)) {
+        return NULL;
+    }
+
+    new_surf =
+        blur(src_surf_obj, dst_surf_obj, radius, repeat_edge_pixels, 'b');
+    if (!new_surf) {
+        return NULL;
+    }
+
+    if (dst_surf_obj) {
+        pgSurface_AddDirtyRect(dst_surf_obj, NULL);
+        Py_INCREF(dst_surf_obj);
+        return (PyObject *)dst_surf_obj;
+    }
+
+    return (PyObject *)pgSurface_New(new_surf);
+}
+
+static PyObject *
+surf_gaussian_blur(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+    pgSurfaceObject *dst_surf_obj = NULL;
+    pgSurfaceObject *src_surf_obj;
+    SDL_Surface *new_surf = NULL;
+    int repeat_edge_pixels = SDL_TRUE;
+
+    const char *mode = "exact";
+    char algorithm;
+
+    int radius;
+
+    static char *kwlist[] = {"surface",      "radius", "repeat_edge_pixels",
+                             "dest_surface", "mode",   0};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!i|pO!s", kwlist,
+                                     &pgSurface_Type, &src_surf_obj, &radius,
+                                     &repeat_edge_pixels, &pgSurface_Type,
+                                     &dst_surf_obj, &mode)) {
+        return NULL;
+    }
+
+    if (!strcmp(mode, "exact")) {
+        algorithm = 'g';
+    }
+    else if (!strcmp(mode, "fast")) {
+        algorithm = 'f';
+    }
+    else {
+        return RAISE(PyExc_ValueError, "mode must be 'exact' or 'fast'");
+    }
+
+    if (dst_surf_obj && !pgSurface_Unshare(dst_surf_obj)) {
+        return NULL;
+    }
+
+    new_surf = blur(src_surf_obj, dst_surf_obj, radius, repeat_edge_pixels,
+                    algorithm);
+    if (!new_surf) {
+        return NULL;
+    }
+
+    if (dst_surf_obj) {
+        pgSurface_AddDirtyRect(dst_surf_obj, NULL);
+        Py_INCREF(dst_surf_obj);
+        return (PyObject *)dst_surf_obj;
+    }
+
+    return (PyObject *)pgSurface_New(new_surf);
+}
+
+#define PG_BORDER_CLAMP 0
+#define PG_BORDER_WRAP 1
+#define PG_BORDER_ZERO 2
+
+/* Adds a row convolved with taps to the accumulators of convolve(). row
+ * holds width + count - 1 pixels of four 16 bit channels, and each of the
+ * width accumulated pixels gets the sum of the count pixels from its own
+ * position on, weighted by taps. */
+static void
+convolve_h(Sint32 *acc, const Sint16 *row, int width, const Sint16 *taps,
+           int count)
+{
+    int x, k, c;
+
+    for (x = 0; x < width; x++) {
+        for (c = 0; c < 4; c++) {
+            const Sint16 *srcp = row + (size_t)x * 4 + c;
+            Sint32 sum = 0;
+
+            for (k = 0; k < count; k++) {
+                sum += taps[k] * srcp[k * 4];
+            }
+            acc[(size_t)x * 4 + c] += sum;
+        }
+    }
+}
+
+/* Adds two rows of count 16 bit values, weighted by weight0 and weight1, to
+ * the accumulators of convolve() */
+static void
+convolve_v(Sint32 *acc, const Sint16 *row0, const Sint16 *row1, int weight0,
+           int weight1, int count)
+{
+    int i;
+
+    for (i = 0; i < count; i++) {
+        acc[i] += weight0 * row0[i] + weight1 * row1[i];
+    }
+}
+
+/* Rounds the count accumulators to fixed point with shift fraction bits,
+ * and saturates them to 16 bit values in dst16, or to 8 bit values in dst8
+ * when dst16 is NULL */
+static void
+convolve_finish(const Sint32 *acc, Sint16 *dst16, Uint8 *dst8, int count,
+                int shift)
+{
+    Sint32 round = shift ? 1 << (shift - 1) : 0;
+    int i;
+
+    for (i = 0; i < count; i++) {
+        Sint32 value = (acc[i] + round) >> shift;
+
+        if (dst16) {
+            dst16[i] = (Sint16)MIN(MAX(value, -32768), 32767);
+        }
+        else {
+            dst8[i] = (Uint8)MIN(MAX(value, 0), 255);
+        }
+    }
+}
+
+/* Quantizes count weights to 16 bits with as many fraction bits as possible,
+ * keeping the weighted sum of inputs up to inmax within 31 bits. Returns the
+ * number of fraction bits, or -1 if the weights are too large. */
+static int
+_convolve_quantize(const double *weights, int count, Sint32 inmax,
+                   Sint16 *out)
+{
+    int bits, i;
+
+    for (bits = 24; bits >= 0; bits--) {
+        double scale = ldexp(1.0, bits);
+        double total = 0.0;
+
+        for (i = 0; i < count; i++) {
+            double q = fabs(floor(weights[i] * scale + 0.5));
+
+            if (q > 32767.0) {
+                break;
+            }
+            total += q;
+        }
+        if (i == count && total * inmax <= (double)(1 << 30)) {
+            for (i = 0; i < count; i++) {
+                out[i] = (Sint16)floor(weights[i] * scale + 0.5);
+            }
+            return bits;
+        }
+    }
+    return -1;
+}
+
+/* Splits a kernel into a column and a row whose product is the kernel.
+ * Returns 0 if the kernel is not separable. */
+static int
+_convolve_separate(const double *kernel, int kw, int kh, double *column,
+                   double *row)
+{
+    double pivot = 0.0;
+    int px = 0, py = 0;
+    int x, y;
+
+    for (y = 0; y < kh; y++) {
+        for (x = 0; x < kw; x++) {
+            if (fabs(kernel[y * kw + x]) > fabs(pivot)) {
+                pivot = kernel[y * kw + x];
+                px = x;
+                py = y;
+            }
+        }
+    }
+    if (pivot == 0.0) {
+        return 0;
+    }
+
+    for (x = 0; x < kw; x++) {
+        row[x] = kernel[py * kw + x];
+    }
+    for (y = 0; y < kh; y++) {
+        column[y] = kernel[y * kw + px] / pivot;
+        for (x = 0; x < kw; x++) {
+            if (fabs(column[y] * row[x] - kernel[y * kw + x]) >
+                fabs(pivot) * 1e-6) {
+                return 0;
+            }
+        }
+    }
+    return 1;
+}
+
+typedef struct {
+    SDL_Surface *src;
+    SDL_Surface *dst;
+    Uint32 amask;
+    int nb;
+    int border;
+    int kw, kh;
+    const Sint16 *weights; /* kh rows of kw weights, or the row weights */
+    const Sint16 *column;  /* the column weights of separable kernels */
+    Sint16 *tmp;           /* the first pass of separable kernels */
+    int shift1, shift2;
+    int simd;
+    int failed;
+} pgConvolve;
+
+static PG_INLINE int
+_convolve_index(int i, int size, int border)
+{
+    if (i >= 0 && i < size) {
+        return i;
+    }
+    switch (border) {
+        case PG_BORDER_CLAMP:
+            return i < 0 ? 0 : size - 1;
+        case PG_BORDER_WRAP:
+            i %= size;
+            return i < 0 ? i + size : i;
+        default:
+            return -1;
+    }
+}
+
+/* Widens source row y to 16 bit channels, with the kw - 1 pixels needed
+ * around it by the border */
+static void
+_convolve_load_row(pgConvolve *conv, int y, Sint16 *padded)
+{
+    const Uint8 *srcrow =
+        (const Uint8 *)conv->src->pixels + (size_t)y * conv->src->pitch;
+    int width = conv->src->w;
+    int x, c;
+
+    for (x = 0; x < width + conv->kw - 1; x++) {
+        int sx = _convolve_index(x - conv->kw / 2, width, conv->border);
+        Sint16 *dstp = padded + (size_t)x * 4;
+
+        if (sx < 0) {
+            memset(dstp, 0, sizeof(Sint16) * 4);
+            continue;
+        }
+        for (c = 0; c < conv->nb; c++) {
+            dstp[c] = srcrow[(size_t)sx * conv->nb + c];
+        }
+        if (conv->nb == 3) {
+            dstp[3] = 0;
+        }
+    }
+}
+
+/* Writes a row of 32 bit results to row y of the destination, keeping the
+ * alpha of the source */
+static void
+_convolve_store_row(pgConvolve *conv, int y, const Uint8 *out)
+{
+    const Uint8 *srcrow =
+        (const Uint8 *)conv->src->pixels + (size_t)y * conv->src->pitch;
+    Uint8 *dstrow = (Uint8 *)conv->dst->pixels + (size_t)y * conv->dst->pitch;
+    int width = conv->dst->w;
+    Uint32 srcpx, dstpx;
+    int x;
+
+    if (conv->nb == 3) {
+        for (x = 0; x < width; x++) {
+            memcpy(dstrow + (size_t)x * 3, out + (size_t)x * 4, 3);
+        }
+        return;
+    }
+    if (!conv->amask) {
+        memcpy(dstrow, out, (size_t)width * 4);
+        return;
+    }
+    for (x = 0; x < width; x++) {
+        memcpy(&srcpx, srcrow + (size_t)x * 4, 4);
+        memcpy(&dstpx, out + (size_t)x * 4, 4);
+        dstpx = (dstpx & ~conv->amask) | (srcpx & conv->amask);
+        memcpy(dstrow + (size_t)x * 4, &dstpx, 4);
+    }
+}
+
+static PG_INLINE void
+_convolve_h(pgConvolve *conv, Sint32 *acc, const Sint16 *row,
+            const Sint16 *taps)
+{
+#if !defined(__EMSCRIPTEN__)
+    if (conv->simd == 2) {
+        convolve_h_avx2(acc, row, conv->dst->w, taps, conv->kw);
+        return;
+    }
+#if defined(__SSE2__) || defined(PG_ENABLE_ARM_NEON)
+    if (conv->simd) {
+        convolve_h_sse2(acc, row, conv->dst->w, taps, conv->kw);
+        return;
+    }
+#endif /* defined(__SSE2__) || defined(PG_ENABLE_ARM_NEON) */
+#endif /* !defined(__EMSCRIPTEN__) */
+    convolve_h(acc, row, conv->dst->w, taps, conv->kw);
+}
+
+static PG_INLINE void
+_convolve_v(pgConvolve *conv, Sint32 *acc, const Sint16 *row0,
+            const Sint16 *row1, int weight0, int weight1)
+{
+    int count = conv->dst->w * 4;
+
+#if !defined(__EMSCRIPTEN__)
+    if (conv->simd == 2) {
+        convolve_v_avx2(acc, row0, row1, weight0, weight1, count);
+        return;
+    }
+#if defined(__SSE2__) || defined(PG_ENABLE_ARM_NEON)
+    if (conv->simd) {
+        convolve_v_sse2(acc, row0, row1, weight0, weight1, count);
+        return;
+    }
+#endif /* defined(__SSE2__) || defined(PG_ENABLE_ARM_NEON) */
+#endif /* !defined(__EMSCRIPTEN__) */
+    convolve_v(acc, row0, row1, weight0, weight1, count);
+}
+
+static PG_INLINE void
+_convolve_finish(pgConvolve *conv, const Sint32 *acc, Sint16 *dst16,
+                 Uint8 *dst8, int shift)
+{
+    int count = conv->dst->w * 4;
+
+#if !defined(__EMSCRIPTEN__)
+#if defined(__SSE2__) || defined(PG_ENABLE_ARM_NEON)
+    if (conv->simd) {
+        convolve_finish_sse2(acc, dst16, dst8, count, shift);
+        return;
+    }
+#endif /* defined(__SSE2__) || defined(PG_ENABLE_ARM_NEON) */
+#endif /* !defined(__EMSCRIPTEN__) */
+    convolve_finish(acc, dst16, dst8, count, shift);
+}
+
+/* Allocates the padded source row, the accumulators and the output row of
+ * a band at once */
+static Sint16 *
+_convolve_scratch(pgConvolve *conv, Sint32 **acc, Uint8 **out)
+{
+    size_t count = (size_t)conv->dst->w * 4;
+    size_t padded = (size_t)(conv->dst->w + conv->kw - 1) * 4;
+    Sint32 *buf = malloc(sizeof(Sint32) * count + sizeof(Sint16) * padded +
+                         count);
+
+    if (!buf) {
+        conv->failed = 1;
+        return NULL;
+    }
+    *acc = buf;
+    *out = (Uint8 *)(buf + count) + sizeof(Sint16) * padded;
+    return (Sint16 *)(buf + count);
+}
+
+/* A band of destination rows of a kernel applied as is */
+static void
+_convolve_band(void *data, int start, int end)
+{
+    pgConvolve *conv = (pgConvolve *)data;
+    Sint32 *acc;
+    Uint8 *out;
+    Sint16 *padded = _convolve_scratch(conv, &acc, &out);
+    int y, k, sy;
+
+    if (!padded) {
+        return;
+    }
+    for (y = start; y < end; y++) {
+        memset(acc, 0, sizeof(Sint32) * conv->dst->w * 4);
+        for (k = 0; k < conv->kh; k++) {
+            sy = _convolve_index(y + k - conv->kh / 2, conv->src->h,
+                                 conv->border);
+            if (sy < 0) {
+                continue;
+            }
+            _convolve_load_row(conv, sy, padded);
+            _convolve_h(conv, acc, padded, conv->weights + k * conv->kw);
+        }
+        _convolve_finish(conv, acc, NULL, out, conv->shift1);
+        _convolve_store_row(conv, y, out);
+    }
+    free(acc);
+}
+
+/* The row pass of a separable kernel over a band of source rows, into the
+ * 16 bit rows of tmp */
+static void
+_convolve_rows_band(void *data, int start, int end)
+{
+    pgConvolve *conv = (pgConvolve *)data;
+    size_t count = (size_t)conv->src->w * 4;
+    Sint32 *acc;
+    Uint8 *out;
+    Sint16 *padded = _convolve_scratch(conv, &acc, &out);
+    int y;
+
+    if (!padded) {
+        return;
+    }
+    for (y = start; y < end; y++) {
+        memset(acc, 0, sizeof(Sint32) * count);
+        _convolve_load_row(conv, y, padded);
+        _convolve_h(conv, acc, padded, conv->weights);
+        _convolve_finish(conv, acc, conv->tmp + count * y, NULL,
+                         conv->shift1);
+    }
+    free(acc);
+}
+
+/* The column pass of a separable kernel over a band of destination rows,
+ * two rows of tmp at a time */
+static void
+_convolve_columns_band(void *data, int start, int end)
+{
+    pgConvolve *conv = (pgConvolve *)data;
+    size_t count = (size_t)conv->dst->w * 4;
+    const Sint16 *pending = NULL;
+    int pending_weight = 0;
+    Sint32 *acc;
+    Uint8 *out;
+    int y, k, sy;
+
+    if (!_convolve_scratch(conv, &acc, &out)) {
+        return;
+    }
+    for (y = start; y < end; y++) {
+        memset(acc, 0, sizeof(Sint32) * count);
+        for (k = 0; k < conv->kh; k++) {
+            sy = _convolve_index(y + k - conv->kh / 2, conv->src->h,
+                                 conv->border);
+            if (sy < 0) {
+                continue;
+            }
+            if (!pending) {
+                pending = conv->tmp + count * sy;
+                pending_weight = conv->column[k];
+                continue;
+            }
+            _convolve_v(conv, acc, pending, conv->tmp + count * sy,
+                        pending_weight, conv->column[k]);
+            pending = NULL;
+        }
+        if (pending) {
+            _convolve_v(conv, acc, pending, pending, pending_weight, 0);
+            pending = NULL;
+        }
+        _convolve_finish(conv, acc, NULL, out, conv->shift2);
+        _convolve_store_row(conv, y, out);
+    }
+    free(acc);
+}
+
+static int
+_convolve_full(pgConvolve *conv, const double *kernel, Sint16 *weights)
+{
+    Py_ssize_t work = (Py_ssize_t)conv->dst->w * conv->dst->h;
+    int bands;
+
+    conv->weights = weights;
+    conv->shift1 =
+        _convolve_quantize(kernel, conv->kw * conv->kh, 255, weights);
+    if (conv->shift1 < 0) {
+        return -1;
+    }
+
+    bands = pg_ParallelBandCount(conv->dst->h, work * conv->kw * conv->kh);
+    if (bands > 1) {
+        pg_ParallelForRows(conv->dst->h, bands, _convolve_band, conv);
+    }
+    else {
+        _convolve_band(conv, 0, conv->dst->h);
+    }
+    return conv->failed ? -2 : 0;
+}
+
+static int
+_convolve_separable(pgConvolve *conv, const double *column,
+                    const double *row, Sint16 *weights)
+{
+    Py_ssize_t work = (Py_ssize_t)conv->dst->w * conv->dst->h;
+    double bound = 0.0;
+    int row_bits, column_bits, bands, i;
+
+    /* The row pass drops as few fraction bits as needed for its results to
+     * fit 16 bits, the column pass drops the rest. */
+    row_bits = _convolve_quantize(row, conv->kw, 255, weights);
+    if (row_bits < 0) {
+        return -1;
+    }
+    for (i = 0; i < conv->kw; i++) {
+        bound += abs(weights[i]) * 255.0;
+    }
+    conv->shift1 = 0;
+    while (floor(ldexp(bound, -conv->shift1) + 0.5) > 32767.0) {
+        conv->shift1++;
+    }
+    bound = floor(ldexp(bound, -conv->shift1) + 0.5);
+    column_bits = _convolve_quantize(column, conv->kh, (Sint32)MAX(bound, 1),
+                                     weights + conv->kw);
+    if (column_bits < 0 || column_bits + row_bits < conv->shift1) {
+        return -1;
+    }
+    conv->shift2 = column_bits + row_bits - conv->shift1;
+    conv->weights = weights;
+    conv->column = weights + conv->kw;
+
+    conv->tmp =
+        malloc(sizeof(Sint16) * 4 * (size_t)conv->src->w * conv->src->h);
+    if (!conv->tmp) {
+        return -2;
     }
-}
 
-/* Optimisation was only disabled for one function - see above */
-#if defined(_MSC_VER) && (_MSC_VER == 1900)
-#pragma optimize("", on)
-#endif
+    bands = pg_ParallelBandCount(conv->src->h, work * conv->kw);
+    if (bands > 1) {
+        pg_ParallelForRows(conv->src->h, bands, _convolve_rows_band, conv);
+    }
+    else {
+        _convolve_rows_band(conv, 0, conv->src->h);
+    }
+    if (!conv->failed) {
+        bands = pg_ParallelBandCount(conv->dst->h, work * conv->kh);
+        if (bands > 1) {
+            pg_ParallelForRows(conv->dst->h, bands, _convolve_columns_band,
+                               conv);
+        }
+        else {
+            _convolve_columns_band(conv, 0, conv->dst->h);
+        }
+    }
 
-/* Optimisation was only disabled for one function on GCC+PPC64 - see above */
-#if defined(__GNUC__) && defined(__PPC64__)
-#pragma GCC pop_options
-#endif
+    free(conv->tmp);
+    return conv->failed ? -2 : 0;
+}
 
-static PyObject *
-surf_average_color(PyObject *self, PyObject *args, PyObject *kwargs)
+/* Applies the kh rows of kw weights in kernel from src to dst, as a column
+ * and a row pass when column and row are given. The amask bits of the
+ * source are kept. Returns -1 if the weights are too large for the fixed
+ * point passes, or -2 if memory ran out. */
+static int
+convolve(SDL_Surface *src, SDL_Surface *dst, Uint32 amask,
+         const double *kernel, int kw, int kh, const double *column,
+         const double *row, int border)
 {
-    pgSurfaceObject *surfobj;
-    PyObject *rectobj = NULL;
-    SDL_Surface *surf;
-    SDL_Rect *rect, temp;
-    Uint8 r, g, b, a;
-    int x, y, w, h;
-    static char *keywords[] = {"surface", "rect", "consider_alpha", NULL};
-    int consider_alpha = SDL_FALSE;
+    pgConvolve conv;
+    Sint16 *weights;
+    int result;
+
+    conv.src = src;
+    conv.dst = dst;
+    conv.amask = amask;
+    conv.nb = PG_SURF_BytesPerPixel(src);
+    conv.border = border;
+    conv.kw = kw;
+    conv.kh = kh;
+    conv.tmp = NULL;
+    conv.failed = 0;
+    conv.simd = 0;
+#if !defined(__EMSCRIPTEN__)
+#if defined(__SSE2__) || defined(PG_ENABLE_ARM_NEON)
+    conv.simd = pg_HasSSE_NEON();
+#endif /* defined(__SSE2__) || defined(PG_ENABLE_ARM_NEON) */
+    if (pg_has_avx2()) {
+        conv.simd = 2;
+    }
+#endif /* !defined(__EMSCRIPTEN__) */
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!|Op", keywords,
-                                     &pgSurface_Type, &surfobj, &rectobj,
-                                     &consider_alpha)) {
-        return NULL;
+    weights = malloc(sizeof(Sint16) * ((size_t)kw * kh + kw + kh));
+    if (!weights) {
+        return -2;
     }
+    if (column) {
+        result = _convolve_separable(&conv, column, row, weights);
+    }
+    else {
+        result = _convolve_full(&conv, kernel, weights);
+    }
+    free(weights);
+    return result;
+}
 
-    surf = pgSurface_AsSurface(surfobj);
-    pgSurface_Lock(surfobj);
+/* Reads a rectangular sequence of rows of numbers into a new array, stored
+ * row after row */
+static double *
+_get_convolve_kernel(PyObject *obj, int *kw, int *kh)
+{
+    PyObject *rows, *row, *item;
+    double *kernel = NULL;
+    Py_ssize_t nrows, ncols = 0, y, x;
 
-    if (!rectobj) {
-        x = 0;
-        y = 0;
-        w = surf->w;
-        h = surf->h;
+    rows = PySequence_Fast(obj, "kernel must be a sequence of rows");
+    if (!rows) {
+        return NULL;
     }
-    else {
-        if (!(rect = pgRect_FromObject(rectobj, &temp))) {
-            return RAISE(PyExc_TypeError, "Rect argument is invalid");
+    nrows = PySequence_Fast_GET_SIZE(rows);
+    for (y = 0; y < nrows; y++) {
+        row = PySequence_Fast(PySequence_Fast_GET_ITEM(rows, y),
+                              "kernel must be a sequence of rows");
+        if (!row) {
+            goto error;
         }
-        x = rect->x;
-        y = rect->y;
-        w = rect->w;
-        h = rect->h;
+        if (!kernel) {
+            ncols = PySequence_Fast_GET_SIZE(row);
+            if (ncols == 0) {
+                Py_DECREF(row);
+                break;
+            }
+            if (ncols > INT_MAX || nrows > INT_MAX / ncols) {
+                Py_DECREF(row);
+                PyErr_SetString(PyExc_ValueError, "kernel is too large");
+                goto error;
+            }
+            kernel = malloc(sizeof(double) * (size_t)(nrows * ncols));
+            if (!kernel) {
+                Py_DECREF(row);
+                PyErr_NoMemory();
+                goto error;
+            }
+        }
+        if (PySequence_Fast_GET_SIZE(row) != ncols) {
+            Py_DECREF(row);
+            PyErr_SetString(PyExc_ValueError,
+                            "kernel rows must have the same length");
+            goto error;
+        }
+        for (x = 0; x < ncols; x++) {
+            item = PySequence_Fast_GET_ITEM(row, x);
+            kernel[y * ncols + x] = PyFloat_AsDouble(item);
+            if (kernel[y * ncols + x] == -1.0 && PyErr_Occurred()) {
+                Py_DECREF(row);
+                goto error;
+            }
+        }
+        Py_DECREF(row);
     }
-
-    PG_PixelFormat *surf_format = PG_GetSurfaceFormat(surf);
-    if (surf_format == NULL) {
-        return RAISE(pgExc_SDLError, SDL_GetError());
+    if (!kernel) {
+        PyErr_SetString(PyExc_ValueError, "kernel must not be empty");
+        goto error;
     }
 
-    Py_BEGIN_ALLOW_THREADS;
-    average_color(surf, surf_format, x, y, w, h, &r, &g, &b, &a,
-                  consider_alpha);
-    Py_END_ALLOW_THREADS;
+    Py_DECREF(rows);
+    *kw = (int)ncols;
+    *kh = (int)nrows;
+    return kernel;
 
-    pgSurface_Unlock(surfobj);
-    return Py_BuildValue("(bbbb)", r, g, b, a);
+error:
+    Py_DECREF(rows);
+    free(kernel);
+    return NULL;
 }
 
-static int
-box_blur(SDL_Surface *src, SDL_Surface *dst, int radius, SDL_bool repeat)
+static PyObject *
+surf_convolve(PyObject *self, PyObject *args, PyObject *kwargs)
 {
-    // Reference : https://blog.csdn.net/blogshinelee/article/details/80997324
+    pgSurfaceObject *dst_surf_obj = NULL;
+    pgSurfaceObject *src_surf_obj;
+    PyObject *kernel_obj;
+    PyObject *separable_obj = Py_None;
+    SDL_Surface *src, *new_surf = NULL;
+    PG_PixelFormat *src_format, *dst_format;
+    const char *border_name = "clamp";
+    double *kernel, *column = NULL, *row = NULL;
+    Uint32 amask;
+    int kw, kh, border, separable = -1;
+    int result = 0;
 
-    Uint8 *srcpx = (Uint8 *)src->pixels;
-    Uint8 *dstpx = (Uint8 *)dst->pixels;
-    Uint8 nb = PG_SURF_BytesPerPixel(src);
-    int w = dst->w, h = dst->h;
-    int dst_pitch = dst->pitch;
-    int src_pitch = src->pitch;
-    int i, x, y, color;
+    static char *kwlist[] = {"surface",   "kernel", "dest_surface",
+                             "separable", "border", 0};
 
-    // Allocate bytes for buf, sum_v, and sum_h at once to reduce allocations.
-    Uint32 *overall_buf = malloc(sizeof(Uint32) * (dst_pitch * 2 + nb));
-    Uint32 *buf = overall_buf;
-    Uint32 *sum_v = overall_buf + dst_pitch;
-    Uint32 *sum_h = overall_buf + dst_pitch * 2;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!O|O!Os", kwlist,
+                                     &pgSurface_Type, &src_surf_obj,
+                                     &kernel_obj, &pgSurface_Type,
+                                     &dst_surf_obj, &separable_obj,
+                                     &border_name)) {
+        return NULL;
+    }
 
-    if (overall_buf == NULL) {
-        return -1;
+    if (!strcmp(border_name, "clamp")) {
+        border = PG_BORDER_CLAMP;
+    }
+    else if (!strcmp(border_name, "wrap")) {
+        border = PG_BORDER_WRAP;
+    }
+    else if (!strcmp(border_name, "zero")) {
+        border = PG_BORDER_ZERO;
+    }
+    else {
+        return RAISE(PyExc_ValueError,
+                     "border must be 'clamp', 'wrap' or 'zero'");
     }
 
-    memset(sum_v, 0, dst_pitch * sizeof(Uint32));
-    for (y = 0; y <= radius; y++) {  // y-pre
-        for (i = 0; i < dst_pitch; i++) {
-            sum_v[i] += srcpx[src_pitch * y + i];
+    if (separable_obj != Py_None) {
+        separable = PyObject_IsTrue(separable_obj);
+        if (separable < 0) {
+            return NULL;
         }
     }
-    if (repeat) {
-        for (i = 0; i < dst_pitch; i++) {
-            sum_v[i] += srcpx[i] * radius;
-        }
+
+    src = pgSurface_AsSurface(src_surf_obj);
+    SURF_INIT_CHECK(src)
+    if (PG_SURF_BytesPerPixel(src) != 3 && PG_SURF_BytesPerPixel(src) != 4) {
+        return RAISE(PyExc_ValueError,
+                     "Only 24 and 32 bit surfaces can be convolved.");
     }
-    for (y = 0; y < h; y++) {  // y
-        for (i = 0; i < dst_pitch; i++) {
-            buf[i] = sum_v[i] / (radius * 2 + 1);
 
-            // update vertical sum
-            if (y - radius >= 0) {
-                sum_v[i] -= srcpx[src_pitch * (y - radius) + i];
-            }
-            else if (repeat) {
-                sum_v[i] -= srcpx[i];
-            }
-            if (y + radius + 1 < h) {
-                sum_v[i] += srcpx[src_pitch * (y + radius + 1) + i];
-            }
-            else if (repeat) {
-                sum_v[i] += srcpx[src_pitch * (h - 1) + i];
-            }
-        }
+    kernel = _get_convolve_kernel(kernel_obj, &kw, &kh);
+    if (!kernel) {
+        return NULL;
+    }
 
-        memset(sum_h, 0, nb * sizeof(Uint32));
-        for (x = 0; x <= radius; x++) {  // x-pre
-            for (color = 0; color < nb; color++) {
-                sum_h[color] += buf[x * nb + color];
-            }
+    /* Separable kernels are applied as a row and a column pass, which does
+     * not pay off for kernels of a single row. */
+    if (separable != 0) {
+        column = malloc(sizeof(double) * ((size_t)kw + kh));
+        if (!column) {
+            free(kernel);
+            return PyErr_NoMemory();
         }
-        if (repeat) {
-            for (color = 0; color < nb; color++) {
-                sum_h[color] += buf[color] * radius;
+        row = column + kh;
+        if (!_convolve_separate(kernel, kw, kh, column, row)) {
+            free(column);
+            column = row = NULL;
+            if (separable == 1) {
+                free(kernel);
+                return RAISE(PyExc_ValueError, "kernel is not separable");
             }
         }
-        for (x = 0; x < w; x++) {  // x
-            for (color = 0; color < nb; color++) {
-                dstpx[dst_pitch * y + nb * x + color] =
-                    sum_h[color] / (radius * 2 + 1);
-
-                // update horizontal sum
-                if (x - radius >= 0) {
-                    sum_h[color] -= buf[(x - radius) * nb + color];
-                }
-                else if (repeat) {
-                    sum_h[color] -= buf[color];
-                }
-                if (x + radius + 1 < w) {
-                    sum_h[color] += buf[(x + radius + 1) * nb + color];
-                }
-                else if (repeat) {
-                    sum_h[color] += buf[(w - 1) * nb + color];
-                }
-            }
+        else if (kh == 1 && separable == -1) {
+            free(column);
+            column = row = NULL;
         }
     }
 
-    free(overall_buf);
-    return 0;
-}
+    if (dst_surf_obj && !pgSurface_Unshare(dst_surf_obj)) {
+        goto error;
+    }
 
-static int
-gaussian_blur(SDL_Surface *src, SDL_Surface *dst, int sigma, SDL_bool repeat)
-{
-    Uint8 *srcpx = (Uint8 *)src->pixels;
-    Uint8 *dstpx = (Uint8 *)dst->pixels;
-    Uint8 nb = PG_SURF_BytesPerPixel(src);
-    int w = dst->w, h = dst->h;
-    int dst_pitch = dst->pitch;
-    int src_pitch = src->pitch;
-    int i, j, x, y, color;
-    int kernel_radius = sigma * 2;
-    float lut_sum = 0.0;
+    new_surf = _filter_dest_surface(src_surf_obj, dst_surf_obj, "convolved",
+                                    "Convolution");
+    if (!new_surf) {
+        goto error;
+    }
 
-    // Allocate bytes for buf, buf2, and lut at once to reduce allocations.
-    float *overall_buf =
-        malloc(sizeof(float) * (dst_pitch * 2 + kernel_radius + 1));
-    float *buf = overall_buf;
-    float *buf2 = overall_buf + dst_pitch;
-    float *lut = overall_buf + dst_pitch * 2;
+    src_format = PG_GetSurfaceFormat(src);
+    dst_format = PG_GetSurfaceFormat(new_surf);
+    if (!src_format || !dst_format) {
+        PyErr_SetString(pgExc_SDLError, SDL_GetError());
+        goto error;
+    }
+    amask = src_format->Amask == dst_format->Amask ? src_format->Amask : 0;
 
-    if (overall_buf == NULL) {
-        return -1;
+    if (new_surf->w && new_surf->h) {
+        if (!pgSurface_LockRead(src_surf_obj)) {
+            goto error;
+        }
+        SDL_LockSurface(new_surf);
+
+        Py_BEGIN_ALLOW_THREADS;
+        result = convolve(src, new_surf, amask, kernel, kw, kh, column, row,
+                          border);
+        Py_END_ALLOW_THREADS;
+
+        SDL_UnlockSurface(new_surf);
+        pgSurface_Unlock(src_surf_obj);
     }
 
-    for (i = 0; i <= kernel_radius; i++) {  // init gaussian lut
-        // Gaussian function
-        lut[i] =
-            expf(-powf((float)i, 2.0f) / (2.0f * powf((float)sigma, 2.0f)));
-        lut_sum += lut[i] * 2;
+    if (result == -1) {
+        PyErr_SetString(PyExc_ValueError, "kernel weights are too large");
+        goto error;
     }
-    lut_sum -= lut[0];
-    for (i = 0; i <= kernel_radius; i++) {
-        lut[i] /= lut_sum;
+    if (result) {
+        PyErr_NoMemory();
+        goto error;
     }
+    free(kernel);
+    free(column);
 
-    for (i = 0; i < dst_pitch; i++) {
-        buf[i] = 0.0;
-        buf2[i] = 0.0;
+    if (dst_surf_obj) {
+        pgSurface_AddDirtyRect(dst_surf_obj, NULL);
+        Py_INCREF(dst_surf_obj);
+        return (PyObject *)dst_surf_obj;
     }
 
-    for (y = 0; y < h; y++) {
-        for (j = -kernel_radius; j <= kernel_radius; j++) {
-            for (i = 0; i < dst_pitch; i++) {
-                if (y + j >= 0 && y + j < h) {
-                    buf[i] +=
-                        (float)srcpx[src_pitch * (y + j) + i] * lut[abs(j)];
-                }
-                else if (repeat) {
-                    if (y + j < 0) {
-                        buf[i] += (float)srcpx[i] * lut[abs(j)];
-                    }
-                    else {
-                        buf[i] += (float)srcpx[src_pitch * (h - 1) + i] *
-                                  lut[abs(j)];
-                    }
-                }
-            }
-        }
+    return (PyObject *)pgSurface_New(new_surf);
 
-        for (x = 0; x < w; x++) {
-            for (j = -kernel_radius; j <= kernel_radius; j++) {
-                for (color = 0; color < nb; color++) {
-                    if (x + j >= 0 && x + j < w) {
-                        buf2[nb * x + color] +=
-                            buf[nb * (x + j) + color] * lut[abs(j)];
-                    }
-                    else if (repeat) {
-                        if (x + j < 0) {
-                            buf2[nb * x + color] += buf[color] * lut[abs(j)];
-                        }
-                        else {
-                            buf2[nb * x + color] +=
-                                buf[nb * (w - 1) + color] * lut[abs(j)];
-                        }
-                    }
-                }
+error:
+    /* Only a surface made here is freed, never the one of dest_surface */
+    if (new_surf && !dst_surf_obj) {
+        pgSurface_PoolRelease(new_surf);
+    }
+    free(kernel);
+    free(column);
+    return NULL;
+}
+
+#define PG_COLOROP_LUT 0
+#define PG_COLOROP_MATRIX 1
+
+/* The per pixel transform of apply_lut() or color_matrix(), on the four
+ * bytes of 32 bit pixels in memory order */
+typedef struct {
+    SDL_Surface *src;
+    SDL_Surface *dst;
+    int kind;
+    int simd;
+    int failed;
+    Uint8 luts[4][256];
+    Uint32 lut32[4 * 256]; /* by byte of the pixel values, for gathers */
+    Sint16 matrix[16];     /* 12 bit fixed point */
+    Sint32 offsets[4];     /* 12 bit fixed point, with the rounding */
+} pgColorOp;
+
+static void
+colorlut_row(const Uint8 *src, Uint8 *dst, int count,
+             const Uint8 (*luts)[256])
+{
+    int i;
+
+    for (i = 0; i < count; i++) {
+        dst[i * 4] = luts[0][src[i * 4]];
+        dst[i * 4 + 1] = luts[1][src[i * 4 + 1]];
+        dst[i * 4 + 2] = luts[2][src[i * 4 + 2]];
+        dst[i * 4 + 3] = luts[3][src[i * 4 + 3]];
+    }
+}
+
+/* Each output byte o is the sum of matrix[o * 4 + i] times input byte i, in
+ * 12 bit fixed point, plus offsets[o] */
+static void
+colormatrix_row(const Uint8 *src, Uint8 *dst, int count,
+                const Sint16 *matrix, const Sint32 *offsets)
+{
+    Uint8 pixel[4];
+    Sint32 value;
+    int i, o;
+
+    for (i = 0; i < count; i++) {
+        memcpy(pixel, src + i * 4, 4);
+        for (o = 0; o < 4; o++) {
+            value = offsets[o] + matrix[o * 4] * pixel[0] +
+                    matrix[o * 4 + 1] * pixel[1] +
+                    matrix[o * 4 + 2] * pixel[2] +
+                    matrix[o * 4 + 3] * pixel[3];
+            value >>= 12;
+            dst[i * 4 + o] = (Uint8)MIN(MAX(value, 0), 255);
+        }
+    }
+}
+
+/* Moves the channel luts or 4x5 matrix into the bytes of the pixels. pos
+ * holds the bytes of red, green, blue and alpha. Without alpha, the alpha
+ * byte is left as is and the matrix takes the alpha as 255. */
+static void
+_colorop_init(pgColorOp *op, Uint8 (*luts)[256], const double *matrix,
+              const int *pos, int has_alpha)
+{
+    double offset;
+    int c, i, v, byte;
+
+    memset(op->matrix, 0, sizeof(op->matrix));
+    for (c = 0; c < 4; c++) {
+        int o = pos[c];
+
+        if (c == 3 && !has_alpha) {
+            for (v = 0; v < 256; v++) {
+                op->luts[o][v] = (Uint8)v;
             }
+            op->matrix[o * 4 + o] = 4096;
+            op->offsets[o] = 2048;
+            continue;
         }
-        for (i = 0; i < dst_pitch; i++) {
-            dstpx[dst_pitch * y + i] = (Uint8)buf2[i];
-            buf[i] = 0.0;
-            buf2[i] = 0.0;
+        if (luts) {
+            memcpy(op->luts[o], luts[c], 256);
+            continue;
+        }
+
+        offset = matrix[c * 5 + 4];
+        for (i = 0; i < 4; i++) {
+            double weight = matrix[c * 5 + i];
+
+            if (i == 3 && !has_alpha) {
+                offset += weight * 255.0;
+                continue;
+            }
+            op->matrix[o * 4 + pos[i]] =
+                (Sint16)MIN(MAX(floor(weight * 4096.0 + 0.5), -32768), 32767);
         }
+        /* beyond this the result is the same, as the weights add less */
+        offset = MIN(MAX(offset, -65536.0), 65536.0);
+        op->offsets[o] = (Sint32)floor(offset * 4096.0 + 0.5) + 2048;
     }
 
-    free(overall_buf);
-    return 0;
+    for (byte = 0; byte < 4; byte++) {
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+        const Uint8 *lut = op->luts[byte];
+#else
+        const Uint8 *lut = op->luts[3 - byte];
+#endif
+        for (v = 0; v < 256; v++) {
+            op->lut32[byte * 256 + v] = (Uint32)lut[v] << (byte * 8);
+        }
+    }
 }
 
-static SDL_Surface *
-blur(pgSurfaceObject *srcobj, pgSurfaceObject *dstobj, int radius,
-     SDL_bool repeat, char algorithm)
+static PG_INLINE void
+_colorop_row(pgColorOp *op, const Uint8 *src, Uint8 *dst, int count)
 {
-    SDL_Surface *src = NULL;
-    SDL_Surface *retsurf = NULL;
-    int result = 0;
+#if !defined(__EMSCRIPTEN__)
+    if (op->simd == 2) {
+        if (op->kind == PG_COLOROP_LUT) {
+            colorlut_row_avx2(src, dst, count, op->lut32);
+        }
+        else {
+            colormatrix_row_avx2(src, dst, count, op->matrix, op->offsets);
+        }
+        return;
+    }
+#if defined(__SSE2__) || defined(PG_ENABLE_ARM_NEON)
+    /* byte lookups have no SSE2 counterpart */
+    if (op->simd && op->kind == PG_COLOROP_MATRIX) {
+        colormatrix_row_sse2(src, dst, count, op->matrix, op->offsets);
+        return;
+    }
+#endif /* defined(__SSE2__) || defined(PG_ENABLE_ARM_NEON) */
+#endif /* !defined(__EMSCRIPTEN__) */
+    if (op->kind == PG_COLOROP_LUT) {
+        colorlut_row(src, dst, count, (const Uint8(*)[256])op->luts);
+    }
+    else {
+        colormatrix_row(src, dst, count, op->matrix, op->offsets);
+    }
+}
 
-    if (radius < 0) {
-        return RAISE(PyExc_ValueError,
-                     "The radius should not be less than zero.");
+/* A band of rows of 24 or 32 bit surfaces, 24 bit rows go through a 32 bit
+ * row */
+static void
+_colorop_band(void *data, int start, int end)
+{
+    pgColorOp *op = (pgColorOp *)data;
+    int width = op->src->w;
+    Uint8 *row = NULL;
+    int y;
+
+    if (PG_SURF_BytesPerPixel(op->src) == 3) {
+        row = malloc((size_t)width * 4);
+        if (!row) {
+            op->failed = 1;
+            return;
+        }
     }
 
-    src = pgSurface_AsSurface(srcobj);
+    for (y = start; y < end; y++) {
+        Uint8 *srcrow = (Uint8 *)op->src->pixels + (size_t)y * op->src->pitch;
+        Uint8 *dstrow = (Uint8 *)op->dst->pixels + (size_t)y * op->dst->pitch;
 
-    if (PG_GetSurfacePalette(src)) {
-        return RAISE(PyExc_ValueError, "Indexed surfaces cannot be blurred.");
+        if (!row) {
+            _colorop_row(op, srcrow, dstrow, width);
+            continue;
+        }
+        convert_24_32(srcrow, op->src->pitch, row, width * 4, width, 1);
+        _colorop_row(op, row, row, width);
+        convert_32_24(row, width * 4, dstrow, op->dst->pitch, width, 1);
+    }
+    free(row);
+}
+
+/* Any other surfaces, a pixel at a time in RGBA order */
+static void
+_colorop_pixels(pgColorOp *op, PG_PixelFormat *src_format,
+                PG_PixelFormat *dst_format)
+{
+    SDL_Palette *src_palette = PG_GetSurfacePalette(op->src);
+    SDL_Palette *dst_palette = PG_GetSurfacePalette(op->dst);
+    Uint8 rgba[4];
+    Uint32 pixel;
+    Uint8 *pix;
+    int x, y;
+
+    for (y = 0; y < op->src->h; y++) {
+        for (x = 0; x < op->src->w; x++) {
+            SURF_GET_AT(pixel, op->src, x, y, (Uint8 *)op->src->pixels,
+                        src_format, pix);
+            PG_GetRGBA(pixel, src_format, src_palette, rgba, rgba + 1,
+                       rgba + 2, rgba + 3);
+            _colorop_row(op, rgba, rgba, 1);
+            pixel = PG_MapRGBA(dst_format, dst_palette, rgba[0], rgba[1],
+                               rgba[2], rgba[3]);
+            SURF_SET_AT(pixel, op->dst, x, y, (Uint8 *)op->dst->pixels,
+                        dst_format, pix);
+        }
     }
+}
+
+/* Whether the channels of a 24 or 32 bit format are whole bytes */
+static int
+_colorop_bytes(PG_PixelFormat *format)
+{
+    return (format->Rmask == 0xFFu << format->Rshift &&
+            format->Gmask == 0xFFu << format->Gshift &&
+            format->Bmask == 0xFFu << format->Bshift &&
+            (!format->Amask || format->Amask == 0xFFu << format->Ashift));
+}
+
+/* Applies the channel luts or the 4x5 matrix to srcobj, into dstobj or a
+ * new surface */
+static SDL_Surface *
+color_op(pgSurfaceObject *srcobj, pgSurfaceObject *dstobj,
+         Uint8 (*luts)[256], const double *matrix)
+{
+    SDL_Surface *src = pgSurface_AsSurface(srcobj);
+    SDL_Surface *newsurf;
+    PG_PixelFormat *src_format, *newsurf_format;
+    pgColorOp *op;
+    int pos[4] = {0, 1, 2, 3};
+    int has_alpha = 1, bytes = 0, bands;
 
     if (!dstobj) {
-        retsurf = newsurf_fromsurf(src, src->w, src->h);
-        if (!retsurf) {
+        newsurf = newsurf_fromsurf(src, src->w, src->h);
+        if (!newsurf) {
             return NULL;
         }
     }
     else {
-        retsurf = pgSurface_AsSurface(dstobj);
+        newsurf = pgSurface_AsSurface(dstobj);
     }
 
-    if ((retsurf->w) != (src->w) || (retsurf->h) != (src->h)) {
-        return RAISE(PyExc_ValueError,
-                     "Destination surface not the same size.");
+    if (newsurf->w != src->w || newsurf->h != src->h) {
+        PyErr_SetString(
+            PyExc_ValueError,
+            "Destination surface must be the same size as source surface.");
+        goto error;
     }
 
-    if (retsurf->w == 0 || retsurf->h == 0) {
-        return retsurf;
+    src_format = PG_GetSurfaceFormat(src);
+    newsurf_format = PG_GetSurfaceFormat(newsurf);
+    if (src_format == NULL || newsurf_format == NULL) {
+        PyErr_SetString(pgExc_SDLError, SDL_GetError());
+        goto error;
     }
 
-    Uint8 *ret_start = retsurf->pixels;
-    Uint8 *ret_end = ret_start + retsurf->h * retsurf->pitch;
-    Uint8 *src_start = src->pixels;
-    Uint8 *src_end = src_start + src->h * src->pitch;
-    if ((ret_start <= src_start && ret_end >= src_start) ||
-        (src_start <= ret_start && src_end >= ret_start)) {
-        return RAISE(
-            PyExc_ValueError,
-            "Blur routines do not support dest_surfaces that share pixels "
-            "with the source surface. Likely the surfaces are the same, one "
-            "of them is a subsurface, or they are sharing the same buffer.");
+    op = malloc(sizeof(pgColorOp));
+    if (!op) {
+        PyErr_NoMemory();
+        goto error;
     }
+    op->src = src;
+    op->dst = newsurf;
+    op->kind = luts ? PG_COLOROP_LUT : PG_COLOROP_MATRIX;
+    op->failed = 0;
+    op->simd = 0;
+#if !defined(__EMSCRIPTEN__)
+#if defined(__SSE2__) || defined(PG_ENABLE_ARM_NEON)
+    op->simd = pg_HasSSE_NEON();
+#endif /* defined(__SSE2__) || defined(PG_ENABLE_ARM_NEON) */
+    if (pg_has_avx2()) {
+        op->simd = 2;
+    }
+#endif /* !defined(__EMSCRIPTEN__) */
+
+    /* Surfaces of the same 24 or 32 bit format are done on their bytes. */
+    if ((PG_FORMAT_BytesPerPixel(src_format) == 3 ||
+         PG_FORMAT_BytesPerPixel(src_format) == 4) &&
+        PG_FORMAT_BytesPerPixel(src_format) ==
+            PG_FORMAT_BytesPerPixel(newsurf_format) &&
+        src_format->Rmask == newsurf_format->Rmask &&
+        src_format->Gmask == newsurf_format->Gmask &&
+        src_format->Bmask == newsurf_format->Bmask &&
+        src_format->Amask == newsurf_format->Amask &&
+        _colorop_bytes(src_format)) {
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+        pos[0] = src_format->Rshift >> 3;
+        pos[1] = src_format->Gshift >> 3;
+        pos[2] = src_format->Bshift >> 3;
+        pos[3] = src_format->Ashift >> 3;
+#else
+        const int nb = PG_FORMAT_BytesPerPixel(src_format);
 
-    if (PG_SURF_BytesPerPixel(src) != PG_SURF_BytesPerPixel(retsurf)) {
-        return (SDL_Surface *)(RAISE(
-            PyExc_ValueError,
-            "Source and destination surfaces need the same format."));
+        pos[0] = nb - 1 - (src_format->Rshift >> 3);
+        pos[1] = nb - 1 - (src_format->Gshift >> 3);
+        pos[2] = nb - 1 - (src_format->Bshift >> 3);
+        pos[3] = nb - 1 - (src_format->Ashift >> 3);
+#endif
+        has_alpha = src_format->Amask != 0;
+        if (!has_alpha) {
+            /* the byte that is left */
+            pos[3] = 6 - pos[0] - pos[1] - pos[2];
+        }
+        bytes = 1;
     }
+    _colorop_init(op, luts, matrix, pos, has_alpha);
 
-    if (radius > MIN(src->w, src->h)) {
-        radius = MIN(src->w, src->h) - 1;
+    if (!pgSurface_LockRead(srcobj)) {
+        free(op);
+        goto error;
     }
-
-    SDL_LockSurface(retsurf);
-    pgSurface_Lock(srcobj);
+    SDL_LockSurface(newsurf);
 
     Py_BEGIN_ALLOW_THREADS;
-
-    if (algorithm == 'b') {
-        result = box_blur(src, retsurf, radius, repeat);
+    if (bytes) {
+        bands = pg_ParallelBandCount(src->h, (Py_ssize_t)src->w * src->h);
+        if (bands > 1) {
+            pg_ParallelForRows(src->h, bands, _colorop_band, op);
+        }
+        else {
+            _colorop_band(op, 0, src->h);
+        }
     }
-    else if (algorithm == 'g') {
-        result = gaussian_blur(src, retsurf, radius, repeat);
+    else {
+        _colorop_pixels(op, src_format, newsurf_format);
     }
-
     Py_END_ALLOW_THREADS;
 
+    SDL_UnlockSurface(newsurf);
     pgSurface_Unlock(srcobj);
-    SDL_UnlockSurface(retsurf);
 
-    // Routines only set error flag if memory allocation failed
-    // Setting Python exception here outside of Py_ THREADS block to be safe
-    if (result) {
+    if (op->failed) {
+        free(op);
         PyErr_NoMemory();
-        return NULL;
+        goto error;
     }
+    free(op);
+    return newsurf;
 
-    return retsurf;
+error:
+    if (!dstobj) {
+        pgSurface_PoolRelease(newsurf);
+    }
+    return NULL;
 }
 
-static PyObject *
-surf_box_blur(PyObject *self, PyObject *args, PyObject *kwargs)
+/* Reads a lookup table of 256 values from 0 to 255, None is the identity */
+static int
+_get_lut(PyObject *obj, Uint8 *lut)
 {
-    pgSurfaceObject *dst_surf_obj = NULL;
-    pgSurfaceObject *src_surf_obj;
-    SDL_Surface *new_surf = NULL;
-    int repeat_edge_pixels = SDL_TRUE;
+    PyObject *seq;
+    long value;
+    int i;
 
-    int radius;
+    if (obj == Py_None) {
+        for (i = 0; i < 256; i++) {
+            lut[i] = (Uint8)i;
+        }
+        return 1;
+    }
 
-    static char *kwlist[] = {"surface", "radius", "repeat_edge_pixels",
-                             "dest_surface", 0};
+    seq = PySequence_Fast(obj, "LUTs must be sequences of 256 integers");
+    if (!seq) {
+        return 0;
+    }
+    if (PySequence_Fast_GET_SIZE(seq) != 256) {
+        Py_DECREF(seq);
+        PyErr_SetString(PyExc_ValueError, "LUTs must have 256 entries");
+        return 0;
+    }
+    for (i = 0; i < 256; i++) {
+        value = PyLong_AsLong(PySequence_Fast_GET_ITEM(seq, i));
+        if (value == -1 && PyErr_Occurred()) {
+            Py_DECREF(seq);
+            return 0;
+        }
+        if (value < 0 || value > 255) {
+            Py_DECREF(seq);
+            PyErr_SetString(PyExc_ValueError,
+                            "LUT entries must be between 0 and 255");
+            return 0;
+        }
+        lut[i] = (Uint8)value;
+    }
+    Py_DECREF(seq);
+    return 1;
+}
+
+static PyObject *
+surf_apply_lut(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+    pgSurfaceObject *surfobj;
+    pgSurfaceObject *surfobj2 = NULL;
+    PyObject *lut_objs[4] = {Py_None, Py_None, Py_None, Py_None};
+    Uint8 luts[4][256];
+    SDL_Surface *newsurf;
+    int i;
+
+    static char *keywords[] = {"surface", "r_lut",        "g_lut", "b_lut",
+                               "a_lut",   "dest_surface", NULL};
 
     if (!PyArg_ParseTupleAndKeywords(
-            args, kwargs, "O!i|pO!", kwlist, &pgSurface_Type, &src_surf_obj,
-            &radius, &repeat_edge_pixels, &pgSurface_Type, &dst_surf_obj)) {
+            args, kwargs, "O!|OOOOO!", keywords, &pgSurface_Type, &surfobj,
+            &lut_objs[0], &lut_objs[1], &lut_objs[2], &lut_objs[3],
+            &pgSurface_Type, &surfobj2)) {
         return NULL;
     }
 
-    new_surf =
-        blur(src_surf_obj, dst_surf_obj, radius, repeat_edge_pixels, 'b');
-    if (!new_surf) {
+    for (i = 0; i < 4; i++) {
+        if (!_get_lut(lut_objs[i], luts[i])) {
+            return NULL;
+        }
+    }
+
+    if (surfobj2 && !pgSurface_Unshare(surfobj2)) {
         return NULL;
     }
 
-    if (dst_surf_obj) {
-        Py_INCREF(dst_surf_obj);
-        return (PyObject *)dst_surf_obj;
+    newsurf = color_op(surfobj, surfobj2, luts, NULL);
+    if (!newsurf) {
+        return NULL;
     }
 
-    return (PyObject *)pgSurface_New(new_surf);
+    if (surfobj2) {
+        pgSurface_AddDirtyRect(surfobj2, NULL);
+        Py_INCREF(surfobj2);
+        return (PyObject *)surfobj2;
+    }
+    return (PyObject *)pgSurface_New(newsurf);
+}
+
+/* Reads 4 rows of 5 numbers: the weights of red, green, blue and alpha and
+ * an offset */
+static int
+_get_color_matrix(PyObject *obj, double *matrix)
+{
+    PyObject *rows, *row;
+    int y, x;
+
+    rows = PySequence_Fast(obj, "matrix must have 4 rows of 5 numbers");
+    if (!rows) {
+        return 0;
+    }
+    if (PySequence_Fast_GET_SIZE(rows) != 4) {
+        Py_DECREF(rows);
+        PyErr_SetString(PyExc_ValueError,
+                        "matrix must have 4 rows of 5 numbers");
+        return 0;
+    }
+    for (y = 0; y < 4; y++) {
+        row = PySequence_Fast(PySequence_Fast_GET_ITEM(rows, y),
+                              "matrix must have 4 rows of 5 numbers");
+        if (!row) {
+            Py_DECREF(rows);
+            return 0;
+        }
+        if (PySequence_Fast_GET_SIZE(row) != 5) {
+            Py_DECREF(row);
+            Py_DECREF(rows);
+            PyErr_SetString(PyExc_ValueError,
+                            "matrix must have 4 rows of 5 numbers");
+            return 0;
+        }
+        for (x = 0; x < 5; x++) {
+            double value = PyFloat_AsDouble(PySequence_Fast_GET_ITEM(row, x));
+
+            if (value == -1.0 && PyErr_Occurred()) {
+                Py_DECREF(row);
+                Py_DECREF(rows);
+                return 0;
+            }
+            if (x < 4 ? !(value > -8.0 && value < 8.0) : isnan(value)) {
+                Py_DECREF(row);
+                Py_DECREF(rows);
+                PyErr_SetString(PyExc_ValueError,
+                                x < 4 ? "matrix weights must be between -8 "
+                                        "and 8"
+                                      : "matrix offsets must be numbers");
+                return 0;
+            }
+            matrix[y * 5 + x] = value;
+        }
+        Py_DECREF(row);
+    }
+    Py_DECREF(rows);
+    return 1;
 }
 
 static PyObject *
-surf_gaussian_blur(PyObject *self, PyObject *args, PyObject *kwargs)
+surf_color_matrix(PyObject *self, PyObject *args, PyObject *kwargs)
 {
-    pgSurfaceObject *dst_surf_obj = NULL;
-    pgSurfaceObject *src_surf_obj;
-    SDL_Surface *new_surf = NULL;
-    int repeat_edge_pixels = SDL_TRUE;
+    pgSurfaceObject *surfobj;
+    pgSurfaceObject *surfobj2 = NULL;
+    PyObject *matrix_obj;
+    double matrix[20];
+    SDL_Surface *newsurf;
 
-    int radius;
+    static char *keywords[] = {"surface", "matrix", "dest_surface", NULL};
 
-    static char *kwlist[] = {"surface", "radius", "repeat_edge_pixels",
-                             "dest_surface", 0};
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!O|O!", keywords,
+                                     &pgSurface_Type, &surfobj, &matrix_obj,
+                                     &pgSurface_Type, &surfobj2)) {
+        return NULL;
+    }
 
-    if (!PyArg_ParseTupleAndKeywords(
-            args, kwargs, "O!i|pO!", kwlist, &pgSurface_Type, &src_surf_obj,
-            &radius, &repeat_edge_pixels, &pgSurface_Type, &dst_surf_obj)) {
+    if (!_get_color_matrix(matrix_obj, matrix)) {
         return NULL;
     }
 
-    new_surf =
-        blur(src_surf_obj, dst_surf_obj, radius, repeat_edge_pixels, 'g');
-    if (!new_surf) {
+    if (surfobj2 && !pgSurface_Unshare(surfobj2)) {
         return NULL;
     }
 
-    if (dst_surf_obj) {
-        Py_INCREF(dst_surf_obj);
-        return (PyObject *)dst_surf_obj;
+    newsurf = color_op(surfobj, surfobj2, NULL, matrix);
+    if (!newsurf) {
+        return NULL;
     }
 
-    return (PyObject *)pgSurface_New(new_surf);
+    if (surfobj2) {
+        pgSurface_AddDirtyRect(surfobj2, NULL);
+        Py_INCREF(surfobj2);
+        return (PyObject *)surfobj2;
+    }
+    return (PyObject *)pgSurface_New(newsurf);
 }
 
 void
@@ -4180,7 +6853,11 @@ invert(pgSurfaceObject *srcobj, pgSurfaceObject *dstobj)
         }
 #if defined(__SSE2__) || defined(PG_ENABLE_ARM_NEON)
         else if (pg_HasSSE_NEON()) {
+#if PG_ENABLE_NATIVE_NEON
+            invert_neon(src, src_format, newsurf);
+#else
             invert_sse2(src, src_format, newsurf);
+#endif /* PG_ENABLE_NATIVE_NEON */
         }
 #endif  // defined(__SSE2__) || defined(PG_ENABLE_ARM_NEON)
         else {
@@ -4212,6 +6889,10 @@ surf_invert(PyObject *self, PyObject *args, PyObject *kwargs)
         return NULL;
     }
 
+    if (surfobj2 && !pgSurface_Unshare(surfobj2)) {
+        return NULL;
+    }
+
     newsurf = invert(surfobj, surfobj2);
 
     if (!newsurf) {
@@ -4219,6 +6900,7 @@ surf_invert(PyObject *self, PyObject *args, PyObject *kwargs)
     }
 
     if (surfobj2) {
+        pgSurface_AddDirtyRect(surfobj2, NULL);
         Py_INCREF(surfobj2);
         return (PyObject *)surfobj2;
     }
@@ -4242,6 +6924,10 @@ surf_pixelate(PyObject *self, PyObject *args, PyObject *kwargs)
         return NULL;
     }
 
+    if (dst && !pgSurface_Unshare(dst)) {
+        return NULL;
+    }
+
     if (pixel_size < 1) {
         PyErr_SetString(PyExc_ValueError, "pixel_size must be greater than 0");
         return NULL;
@@ -4277,6 +6963,7 @@ surf_pixelate(PyObject *self, PyObject *args, PyObject *kwargs)
     }
 
     if (dst) {
+        pgSurface_AddDirtyRect(dst, NULL);
         Py_INCREF(dst);
         return (PyObject *)dst;
     }
@@ -4284,6 +6971,28 @@ surf_pixelate(PyObject *self, PyObject *args, PyObject *kwargs)
     return (PyObject *)pgSurface_New(new_surf);
 }
 
+static PyObject *
+surf_get_pool_stats(PyObject *self, PyObject *_null)
+{
+    return pgSurface_PoolStats();
+}
+
+static PyObject *
+surf_set_pool_budget(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+    Py_ssize_t budget;
+    static char *keywords[] = {"budget", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "n", keywords, &budget)) {
+        return NULL;
+    }
+    if (budget < 0) {
+        return RAISE(PyExc_ValueError, "budget can not be negative");
+    }
+    pgSurface_PoolSetBudget(budget);
+    Py_RETURN_NONE;
+}
+
 static PyMethodDef _transform_methods[] = {
     {"scale", (PyCFunction)surf_scale, METH_VARARGS | METH_KEYWORDS,
      DOC_TRANSFORM_SCALE},
@@ -4299,14 +7008,28 @@ static PyMethodDef _transform_methods[] = {
      DOC_TRANSFORM_CHOP},
     {"scale2x", (PyCFunction)surf_scale2x, METH_VARARGS | METH_KEYWORDS,
      DOC_TRANSFORM_SCALE2X},
+    {"scale3x", (PyCFunction)surf_scale3x, METH_VARARGS | METH_KEYWORDS,
+     DOC_TRANSFORM_SCALE3X},
+    {"scale4x", (PyCFunction)surf_scale4x, METH_VARARGS | METH_KEYWORDS,
+     DOC_TRANSFORM_SCALE4X},
+    {"xbr2x", (PyCFunction)surf_xbr2x, METH_VARARGS | METH_KEYWORDS,
+     DOC_TRANSFORM_XBR2X},
     {"smoothscale", (PyCFunction)surf_scalesmooth,
      METH_VARARGS | METH_KEYWORDS, DOC_TRANSFORM_SMOOTHSCALE},
     {"smoothscale_by", (PyCFunction)surf_scalesmooth_by,
      METH_VARARGS | METH_KEYWORDS, DOC_TRANSFORM_SMOOTHSCALEBY},
+    {"build_mipmaps", (PyCFunction)surf_build_mipmaps,
+     METH_VARARGS | METH_KEYWORDS, DOC_TRANSFORM_BUILDMIPMAPS},
+    {"scale_mipmapped", (PyCFunction)surf_scale_mipmapped,
+     METH_VARARGS | METH_KEYWORDS, DOC_TRANSFORM_SCALEMIPMAPPED},
     {"get_smoothscale_backend", surf_get_smoothscale_backend, METH_NOARGS,
      DOC_TRANSFORM_GETSMOOTHSCALEBACKEND},
     {"set_smoothscale_backend", (PyCFunction)surf_set_smoothscale_backend,
      METH_VARARGS | METH_KEYWORDS, DOC_TRANSFORM_SETSMOOTHSCALEBACKEND},
+    {"get_pool_stats", surf_get_pool_stats, METH_NOARGS,
+     DOC_TRANSFORM_GETPOOLSTATS},
+    {"set_pool_budget", (PyCFunction)surf_set_pool_budget,
+     METH_VARARGS | METH_KEYWORDS, DOC_TRANSFORM_SETPOOLBUDGET},
     {"threshold", (PyCFunction)surf_threshold, METH_VARARGS | METH_KEYWORDS,
      DOC_TRANSFORM_THRESHOLD},
     {"laplacian", (PyCFunction)surf_laplacian, METH_VARARGS | METH_KEYWORDS,
@@ -4319,6 +7042,12 @@ static PyMethodDef _transform_methods[] = {
      DOC_TRANSFORM_BOXBLUR},
     {"gaussian_blur", (PyCFunction)surf_gaussian_blur,
      METH_VARARGS | METH_KEYWORDS, DOC_TRANSFORM_GAUSSIANBLUR},
+    {"convolve", (PyCFunction)surf_convolve, METH_VARARGS | METH_KEYWORDS,
+     DOC_TRANSFORM_CONVOLVE},
+    {"apply_lut", (PyCFunction)surf_apply_lut, METH_VARARGS | METH_KEYWORDS,
+     DOC_TRANSFORM_APPLYLUT},
+    {"color_matrix", (PyCFunction)surf_color_matrix,
+     METH_VARARGS | METH_KEYWORDS, DOC_TRANSFORM_COLORMATRIX},
     {"invert", (PyCFunction)surf_invert, METH_VARARGS | METH_KEYWORDS,
      DOC_TRANSFORM_INVERT},
     {"grayscale", (PyCFunction)surf_grayscale, METH_VARARGS | METH_KEYWORDS,
@@ -221,7 +221,7 @@ except (ImportError, OSError):
 
 try:
     import pygame.surflock
-    from pygame.surface import Surface, SurfaceType
+    from pygame.surface import Surface, SurfaceType, BlitBatch
 except (ImportError, OSError):
 
     def Surface(size, flags, depth, masks):  # pylint: disable=unused-argument
@@ -229,12 +229,33 @@ except (ImportError, OSError):
 
     SurfaceType = Surface
 
+    def BlitBatch(blit_sequence=()):  # pylint: disable=unused-argument
+        _attribute_undefined("pygame.BlitBatch")
+
 # sprite.py is using pygame.surface.Surface type
 try:
     import pygame.sprite
 except (ImportError, OSError):
     sprite = MissingModule("sprite", urgent=1)
 
+try:
+    import pygame.atlas
+    from pygame.atlas import Atlas
+except (ImportError, OSError):
+    atlas = MissingModule("atlas", urgent=1)
+
+    def Atlas(*args, **kwargs):  # pylint: disable=unused-argument
+        _attribute_undefined("pygame.Atlas")
+
+try:
+    import pygame.tilelayer
+    from pygame.tilelayer import TileLayer
+except (ImportError, OSError):
+    tilelayer = MissingModule("tilelayer", urgent=1)
+
+    def TileLayer(*args, **kwargs):  # pylint: disable=unused-argument
+        _attribute_undefined("pygame.TileLayer")
+
 
 try:
     import pygame.mask
@@ -0,0 +1,223 @@
+#    pygame-ce - Python Game Library
+#
+#    This library is free software; you can redistribute it and/or
+#    modify it under the terms of the GNU Library General Public
+#    License as published by the Free Software Foundation; either
+#    version 2 of the License, or (at your option) any later version.
+#
+#    This library is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+#    Library General Public License for more details.
+#
+#    You should have received a copy of the GNU Library General Public
+#    License along with this library; if not, write to the Free
+#    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+"""Pygame module for packing many small surfaces into a few large ones.
+
+Games often load thousands of tiny images. Each of them is a separate
+allocation, so drawing many of them touches memory all over the place. An
+:class:`Atlas` copies such surfaces into one or a few large page surfaces and
+hands back a region for each of them.
+
+A region is a subsurface of its page, so it can be passed to
+:meth:`pygame.Surface.blit`, :meth:`pygame.Surface.blits`,
+:meth:`pygame.Surface.fblits` and :class:`pygame.BlitBatch` like any other
+surface, while its pixels live next to those of the other regions.
+
+.. versionadded:: 2.5.7
+"""
+
+import pygame
+from pygame.rect import Rect
+from pygame.surface import Surface
+
+
+class _Skyline:
+    """Bottom-left skyline packer for a single page.
+
+    The skyline is a list of [x, y, width] segments covering the width of the
+    page from left to right, y being the lowest free row above the segment.
+    """
+
+    def __init__(self, width, height):
+        self.width = width
+        self.height = height
+        self.segments = [[0, 0, width]]
+
+    def _fit(self, index, width, height):
+        """Returns the y a box placed on segment index would rest at, or -1"""
+        x = self.segments[index][0]
+        if x + width > self.width:
+            return -1
+        y = 0
+        remaining = width
+        while remaining > 0:
+            _, seg_y, seg_width = self.segments[index]
+            y = max(y, seg_y)
+            if y + height > self.height:
+                return -1
+            remaining -= seg_width
+            index += 1
+        return y
+
+    def insert(self, width, height):
+        """Places a width x height box, returns its (x, y) or None if full"""
+        best = None
+        for index, (x, _, seg_width) in enumerate(self.segments):
+            y = self._fit(index, width, height)
+            if y < 0:
+                continue
+            # lowest top edge first, then the narrowest segment wastes least
+            key = (y + height, seg_width)
+            if best is None or key < best[0]:
+                best = (key, index, x, y)
+        if best is None:
+            return None
+
+        _, index, x, y = best
+        self.segments.insert(index, [x, y + height, width])
+        index += 1
+        # trim the segments now covered by the box
+        while index < len(self.segments):
+            segment = self.segments[index]
+            covered = x + width - segment[0]
+            if covered <= 0:
+                break
+            if covered < segment[2]:
+                segment[0] += covered
+                segment[2] -= covered
+                break
+            del self.segments[index]
+        # merge neighbours at the same height
+        index = 0
+        while index < len(self.segments) - 1:
+            if self.segments[index][1] == self.segments[index + 1][1]:
+                self.segments[index][2] += self.segments[index + 1][2]
+                del self.segments[index + 1]
+            else:
+                index += 1
+        return x, y
+
+
+class Atlas:
+    """Pygame object for packing surfaces into shared pages.
+
+    Atlas(page_size=(1024, 1024), padding=1, flags=pygame.SRCALPHA, depth=32) -> Atlas
+
+    Surfaces added to the atlas are copied into page surfaces of ``page_size``
+    created with ``flags`` and ``depth``. A new page is started when a surface
+    does not fit on any existing page. ``padding`` transparent pixels are kept
+    between the regions, so that scaled or filtered drawing of a region does
+    not bleed in its neighbours.
+
+    Pixels are copied with a regular blit onto the empty (transparent black)
+    page, so a colorkey or surface alpha of the added surface is baked into the
+    alpha of the region.
+
+    .. versionadded:: 2.5.7
+    """
+
+    def __init__(
+        self, page_size=(1024, 1024), padding=1, flags=pygame.SRCALPHA, depth=32
+    ):
+        width, height = page_size
+        if width <= 0 or height <= 0:
+            raise ValueError("page_size must be positive")
+        if padding < 0:
+            raise ValueError("padding can not be negative")
+        self._page_size = (int(width), int(height))
+        self._padding = int(padding)
+        self._flags = flags
+        self._depth = depth
+        self._pages = []
+        self._packers = []
+
+    @property
+    def pages(self):
+        """The page surfaces, in the order they were created (read-only)."""
+        return list(self._pages)
+
+    def add(self, surface):
+        """Copy a surface into the atlas.
+
+        add(surface) -> Surface
+
+        Returns the region of a page holding a copy of ``surface``, a
+        subsurface with the same size. Raises ``ValueError`` if the surface
+        does not fit in an empty page.
+        """
+        width, height = surface.get_size()
+        page_width, page_height = self._page_size
+        if width > page_width or height > page_height:
+            raise ValueError(
+                f"surface of size {(width, height)} does not fit in an atlas "
+                f"page of size {self._page_size}"
+            )
+        # the padding is not needed against the page edges
+        padded_width = min(width + self._padding, page_width)
+        padded_height = min(height + self._padding, page_height)
+
+        for page, packer in zip(self._pages, self._packers):
+            pos = packer.insert(padded_width, padded_height)
+            if pos is not None:
+                break
+        else:
+            page = Surface(self._page_size, self._flags, self._depth)
+            packer = _Skyline(page_width, page_height)
+            self._pages.append(page)
+            self._packers.append(packer)
+            pos = packer.insert(padded_width, padded_height)
+
+        region = page.subsurface(Rect(pos, (width, height)))
+        region.blit(surface, (0, 0))
+        return region
+
+    def add_all(self, surfaces):
+        """Copy many surfaces into the atlas.
+
+        add_all(surfaces) -> list[Surface]
+
+        Like calling :meth:`add` for each surface, but the surfaces are packed
+        from the tallest to the shortest, which fills the pages more tightly.
+        The regions are returned in the order of ``surfaces``.
+        """
+        surfaces = list(surfaces)
+        order = sorted(
+            range(len(surfaces)),
+            key=lambda i: (-surfaces[i].get_height(), -surfaces[i].get_width()),
+        )
+        regions = [None] * len(surfaces)
+        for i in order:
+            regions[i] = self.add(surfaces[i])
+        return regions
+
+    def locate(self, region):
+        """Find where a region lives in the atlas.
+
+        locate(region) -> (int, Rect)
+
+        Returns the index of the page holding ``region`` in :attr:`pages` and
+        the area of the region on that page. Raises ``ValueError`` if
+        ``region`` was not returned by this atlas.
+        """
+        parent = region.get_parent()
+        for index, page in enumerate(self._pages):
+            if parent is page:
+                return index, Rect(region.get_offset(), region.get_size())
+        raise ValueError("region is not part of this atlas")
+
+    def get_textures(self, renderer):
+        """Upload the pages for a renderer.
+
+        get_textures(renderer) -> list[Texture]
+
+        Returns one ``pygame._render.Texture`` per page, in the order of
+        :attr:`pages`. Draw a region with the texture of its page and the area
+        from :meth:`locate`, e.g. ``renderer.blit(textures[index], dest, area)``.
+        Regions added later need new textures.
+        """
+        from pygame._render import Texture
+
+        return [Texture.from_surface(renderer, page) for page in self._pages]
@@ -0,0 +1,185 @@
+#    pygame-ce - Python Game Library
+#
+#    This library is free software; you can redistribute it and/or
+#    modify it under the terms of the GNU Library General Public
+#    License as published by the Free Software Foundation; either
+#    version 2 of the License, or (at your option) any later version.
+#
+#    This library is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+#    Library General Public License for more details.
+#
+#    You should have received a copy of the GNU Library General Public
+#    License along with this library; if not, write to the Free
+#    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+"""Pygame module for drawing tile maps.
+
+A :class:`TileLayer` draws a grid of tiles from a tileset surface with
+:meth:`pygame.Surface.blit_tilemap`, which only draws the tiles that are
+visible. Layers that do not change can also be drawn from chunks of tiles
+rendered ahead of time, so that scrolling a large map costs a handful of blits
+per frame.
+
+.. versionadded:: 2.5.7
+"""
+
+import pygame
+from pygame.rect import Rect
+from pygame.surface import Surface
+
+
+class TileLayer:
+    """Pygame object for drawing a grid of tiles.
+
+    TileLayer(tileset, tile_size, tiles, chunk_size=None) -> TileLayer
+
+    ``tiles`` is a 2D array of tile indices supporting the buffer protocol,
+    indexed as ``tiles[row][column]``, see :meth:`pygame.Surface.blit_tilemap`
+    for how the indices select the tiles of ``tileset``. The array is not
+    copied, changes to it show up the next time the layer is drawn.
+
+    With a ``chunk_size`` of (columns, rows), the layer is drawn from 32 bit
+    surfaces each holding that many tiles, rendered the first time they are
+    visible and kept until :meth:`invalidate` is called. This is much faster
+    for large maps, at the cost of the memory of the chunks, and because the
+    tiles are rendered onto transparent chunks first, ``special_flags`` apply
+    to the rendered chunks instead of each tile.
+
+    .. versionadded:: 2.5.7
+    """
+
+    def __init__(self, tileset, tile_size, tiles, chunk_size=None):
+        tile_width, tile_height = tile_size
+        if tile_width <= 0 or tile_height <= 0:
+            raise ValueError("tile_size must be positive")
+        if chunk_size is not None:
+            chunk_columns, chunk_rows = chunk_size
+            if chunk_columns <= 0 or chunk_rows <= 0:
+                raise ValueError("chunk_size must be positive")
+            chunk_size = (int(chunk_columns), int(chunk_rows))
+        self.tileset = tileset
+        self.tiles = tiles
+        self._tile_size = (int(tile_width), int(tile_height))
+        self._chunk_size = chunk_size
+        self._chunks = {}
+
+    @property
+    def tile_size(self):
+        """The width and height of a tile in pixels (read-only)."""
+        return self._tile_size
+
+    @property
+    def chunk_size(self):
+        """The number of columns and rows of tiles in a chunk, or ``None``
+        when the layer is not cached (read-only)."""
+        return self._chunk_size
+
+    @property
+    def size(self):
+        """The number of columns and rows of the map (read-only)."""
+        rows, columns = memoryview(self.tiles).shape
+        return columns, rows
+
+    def invalidate(self, area=None):
+        """Forget the rendered chunks.
+
+        invalidate(area=None) -> None
+
+        Call this after changing the tiles or the tileset of a cached layer.
+        ``area`` is a rect of tiles, in columns and rows, limiting the chunks
+        that are rendered again to the ones it overlaps. Does nothing for
+        layers that are not cached.
+        """
+        if area is None:
+            self._chunks.clear()
+            return
+        if self._chunk_size is None:
+            return
+        area = Rect(area)
+        chunk_columns, chunk_rows = self._chunk_size
+        for key in list(self._chunks):
+            column, row = key
+            chunk = Rect(
+                column * chunk_columns, row * chunk_rows, chunk_columns, chunk_rows
+            )
+            if chunk.colliderect(area):
+                del self._chunks[key]
+
+    def _render_chunk(self, column, row):
+        chunk_columns, chunk_rows = self._chunk_size
+        tile_width, tile_height = self._tile_size
+        chunk = Surface(
+            (chunk_columns * tile_width, chunk_rows * tile_height),
+            pygame.SRCALPHA,
+            32,
+        )
+        chunk.blit_tilemap(
+            self.tileset,
+            self._tile_size,
+            self.tiles,
+            (column * chunk.get_width(), row * chunk.get_height()),
+        )
+        self._chunks[column, row] = chunk
+        return chunk
+
+    def draw(self, surface, offset=(0, 0), viewport=None, special_flags=0):
+        """Draw the visible tiles.
+
+        draw(surface, offset=(0, 0), viewport=None, special_flags=0) -> Rect
+
+        Draws the layer inside the ``viewport`` rect of ``surface``, the
+        whole surface by default, with pixel ``offset`` of the map at the top
+        left corner of the viewport. Returns the area of ``surface`` that was
+        drawn on.
+        """
+        if self._chunk_size is None:
+            return surface.blit_tilemap(
+                self.tileset,
+                self._tile_size,
+                self.tiles,
+                offset,
+                viewport,
+                special_flags,
+            )
+
+        viewport = surface.get_rect() if viewport is None else Rect(viewport)
+        clip = surface.get_clip()
+        area = viewport.clip(clip)
+        if not area:
+            return Rect(viewport.topleft, (0, 0))
+
+        columns, rows = self.size
+        chunk_columns, chunk_rows = self._chunk_size
+        chunk_width = chunk_columns * self._tile_size[0]
+        chunk_height = chunk_rows * self._tile_size[1]
+        origin_x = viewport.x - int(offset[0])
+        origin_y = viewport.y - int(offset[1])
+        first_column = max((area.left - origin_x) // chunk_width, 0)
+        last_column = min(
+            (area.right - 1 - origin_x) // chunk_width,
+            (columns - 1) // chunk_columns,
+        )
+        first_row = max((area.top - origin_y) // chunk_height, 0)
+        last_row = min(
+            (area.bottom - 1 - origin_y) // chunk_height,
+            (rows - 1) // chunk_rows,
+        )
+
+        blits = []
+        for row in range(first_row, last_row + 1):
+            for column in range(first_column, last_column + 1):
+                chunk = self._chunks.get((column, row))
+                if chunk is None:
+                    chunk = self._render_chunk(column, row)
+                x = origin_x + column * chunk_width
+                y = origin_y + row * chunk_height
+                blits.append((chunk, (x, y)))
+
+        surface.set_clip(area)
+        try:
+            surface.fblits(blits, special_flags)
+        finally:
+            surface.set_clip(clip)
+        return area
@@ -0,0 +1,69 @@
+import unittest
+
+import pygame
+
+
+class AtlasTypeTest(unittest.TestCase):
+    def test_add_copies_pixels_into_page(self):
+        atlas = pygame.Atlas((64, 64))
+        surf = pygame.Surface((10, 5), pygame.SRCALPHA)
+        surf.fill((10, 20, 30, 40))
+        surf.set_at((9, 4), (200, 100, 50, 255))
+
+        region = atlas.add(surf)
+
+        self.assertEqual(region.get_size(), (10, 5))
+        self.assertIs(region.get_parent(), atlas.pages[0])
+        self.assertEqual(region.get_at((0, 0)), (10, 20, 30, 40))
+        self.assertEqual(region.get_at((9, 4)), (200, 100, 50, 255))
+
+    def test_regions_do_not_overlap(self):
+        atlas = pygame.Atlas((100, 80), padding=2)
+        sizes = [(w, h) for w in (3, 7, 20) for h in (1, 9, 30)] * 4
+        regions = atlas.add_all(pygame.Surface(size) for size in sizes)
+
+        self.assertEqual([region.get_size() for region in regions], sizes)
+        placed = {}
+        for region in regions:
+            index, rect = atlas.locate(region)
+            self.assertTrue(atlas.pages[index].get_rect().contains(rect))
+            padded = pygame.Rect(rect.topleft, (rect.w + 2, rect.h + 2))
+            for other in placed.get(index, []):
+                self.assertFalse(padded.colliderect(other))
+            placed.setdefault(index, []).append(rect)
+
+    def test_new_page_when_full(self):
+        atlas = pygame.Atlas((32, 32), padding=0)
+        regions = [atlas.add(pygame.Surface((32, 16))) for _ in range(3)]
+
+        self.assertEqual(len(atlas.pages), 2)
+        self.assertEqual(atlas.locate(regions[2]), (1, pygame.Rect(0, 0, 32, 16)))
+
+    def test_too_large(self):
+        atlas = pygame.Atlas((32, 32))
+        with self.assertRaises(ValueError):
+            atlas.add(pygame.Surface((33, 1)))
+        # the padding is dropped against the page edge
+        atlas.add(pygame.Surface((32, 32)))
+
+    def test_regions_can_be_blitted(self):
+        atlas = pygame.Atlas((64, 64))
+        red = pygame.Surface((4, 4))
+        red.fill("red")
+        blue = pygame.Surface((4, 4))
+        blue.fill("blue")
+        regions = atlas.add_all([red, blue])
+
+        dest = pygame.Surface((8, 4))
+        dest.fblits([(regions[0], (0, 0)), (regions[1], (4, 0))])
+        self.assertEqual(dest.get_at((1, 1)), (255, 0, 0, 255))
+        self.assertEqual(dest.get_at((5, 1)), (0, 0, 255, 255))
+
+    def test_locate_foreign_surface(self):
+        atlas = pygame.Atlas()
+        with self.assertRaises(ValueError):
+            atlas.locate(pygame.Surface((4, 4)).subsurface((0, 0, 2, 2)))
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -550,6 +550,31 @@ class BaseModuleTest(unittest.TestCase):
 
         self.assertEqual(quit_count, 1)
 
+    def test_set_num_threads(self):
+        """Ensure the number of worker threads can be changed."""
+        old_settings = pygame.set_num_threads(3)
+        try:
+            self.assertIsInstance(old_settings, tuple)
+            self.assertEqual(len(old_settings), 2)
+            self.assertEqual(pygame.get_num_threads(), 3)
+
+            self.assertEqual(pygame.set_num_threads(2, threshold=1000)[0], 3)
+            self.assertEqual(pygame.get_num_threads(), 2)
+
+            # the previous settings come back, threshold included
+            self.assertEqual(pygame.set_num_threads(1), (2, 1000))
+            self.assertEqual(pygame.get_num_threads(), 1)
+
+            # 0 means one thread per CPU core
+            pygame.set_num_threads(0)
+            self.assertGreaterEqual(pygame.get_num_threads(), 1)
+
+            self.assertRaises(ValueError, pygame.set_num_threads, -1)
+            self.assertRaises(ValueError, pygame.set_num_threads, 2, -5)
+            self.assertRaises(TypeError, pygame.set_num_threads, "2")
+        finally:
+            pygame.set_num_threads(*old_settings)
+
     def test_get_error(self):
         # __doc__ (as of 2008-08-02) for pygame.base.get_error:
 
@@ -2,6 +2,7 @@ import unittest
 
 import pygame
 from pygame.locals import *
+from pygame.tests import test_utils
 
 
 class BlitTest(unittest.TestCase):
@@ -71,6 +72,112 @@ class BlitTest(unittest.TestCase):
         s.blit(d, (0, 0), None, BLEND_SUB)
         self.assertEqual(s.get_at((0, 0))[0], 0)
 
+    def test_threaded_blit_matches_serial(self):
+        """Ensure blits split over worker threads match serial blits."""
+        import random
+
+        rng = random.Random(42)
+        size = (317, 241)
+
+        def random_surface(flags):
+            surf = pygame.Surface(size, flags, 32)
+            surf.get_buffer().write(rng.randbytes(size[0] * size[1] * 4))
+            return surf
+
+        src_surfs = [random_surface(SRCALPHA), random_surface(0)]
+        dst_surfs = [random_surface(SRCALPHA), random_surface(0)]
+        blend_flags = [
+            0,
+            BLEND_ADD,
+            BLEND_SUB,
+            BLEND_MULT,
+            BLEND_MIN,
+            BLEND_MAX,
+            BLEND_RGBA_ADD,
+            BLEND_RGBA_SUB,
+            BLEND_RGBA_MULT,
+            BLEND_RGBA_MIN,
+            BLEND_RGBA_MAX,
+            BLEND_PREMULTIPLIED,
+        ]
+
+        def blit(dst, src, flags):
+            result = dst.copy()
+            result.blit(result if src is None else src, (5, 3), None, flags)
+            return result
+
+        for src in src_surfs:
+            for dst in dst_surfs:
+                for flags in blend_flags:
+                    test_utils.assert_same_threaded(
+                        self,
+                        lambda: blit(dst, src, flags),
+                        f"mismatch with flags {flags}",
+                    )
+
+        # self blits that overlap always run serially
+        test_utils.assert_same_threaded(self, lambda: blit(dst_surfs[0], None, 0))
+
+    def test_simd_blit_matches_scalar(self):
+        """Ensure the SIMD blitters (SSE2/NEON, AVX2 or AVX512, whichever is
+        in use) give the same pixels as the scalar blitters.
+
+        The SIMD blitters are only used when source and destination share a
+        channel order, so blitting from a source with swapped red and blue
+        masks forces the scalar path for comparison.
+        """
+        import random
+
+        rng = random.Random(1234)
+        blend_flags = [
+            0,
+            BLEND_RGBA_ADD,
+            BLEND_RGBA_SUB,
+            BLEND_RGBA_MULT,
+            BLEND_RGBA_MIN,
+            BLEND_RGBA_MAX,
+            BLEND_PREMULTIPLIED,
+        ]
+
+        def swap_red_blue(surf):
+            return pygame.image.frombytes(
+                pygame.image.tobytes(surf, "RGBA"), surf.get_size(), "RGBA"
+            )
+
+        # widths chosen to hit both full vectors and every kind of tail
+        for size in ((1, 3), (7, 5), (16, 2), (31, 4), (67, 9)):
+            data = rng.randbytes(size[0] * size[1] * 4)
+            simd_src = pygame.image.frombytes(data, size, "BGRA")
+            scalar_src = swap_red_blue(simd_src)
+            self.assertNotEqual(simd_src.get_masks(), scalar_src.get_masks())
+
+            dst_size = (size[0] + 5, size[1] + 3)
+            for dst_flags, fmt in ((SRCALPHA, "RGBA"), (0, "RGB")):
+                dst = pygame.Surface(dst_size, dst_flags, 32)
+                dst.get_buffer().write(rng.randbytes(dst_size[0] * dst_size[1] * 4))
+
+                for flags in blend_flags:
+                    # only the plain alpha blitters take the surface alpha
+                    for surf_alpha in (None, 100) if flags == 0 else (None,):
+                        src_a, src_b = simd_src, scalar_src
+                        if flags == BLEND_PREMULTIPLIED:
+                            src_a = simd_src.premul_alpha()
+                            src_b = swap_red_blue(src_a)
+                        src_a.set_alpha(surf_alpha)
+                        src_b.set_alpha(surf_alpha)
+
+                        expected = dst.copy()
+                        expected.blit(src_b, (3, 1), None, flags)
+                        result = dst.copy()
+                        result.blit(src_a, (3, 1), None, flags)
+
+                        self.assertEqual(
+                            pygame.image.tobytes(expected, fmt),
+                            pygame.image.tobytes(result, fmt),
+                            f"mismatch with size {size}, flags {flags}, "
+                            f"dst format {fmt}, surface alpha {surf_alpha}",
+                        )
+
     def make_blit_list(self, num_surfs):
         blit_list = []
         for i in range(num_surfs):
@@ -228,6 +335,146 @@ class BlitTest(unittest.TestCase):
 
         self.assertRaises(exc_type, dst.fblits, generate_exception())
 
+    def test_fblits_blit_batch(self):
+        NUM_SURFS = 255
+        blit_list = self.make_blit_list(NUM_SURFS)
+        batch = pygame.BlitBatch(blit_list)
+        self.assertEqual(len(batch), NUM_SURFS)
+
+        expected = pygame.Surface((NUM_SURFS * 10, 10), SRCALPHA, 32)
+        expected.fill((230, 230, 230))
+        expected.fblits(blit_list)
+
+        dst = pygame.Surface((NUM_SURFS * 10, 10), SRCALPHA, 32)
+        dst.fill((230, 230, 230))
+        self.assertEqual(dst.fblits(batch), None)
+        self.assertEqual(dst.get_buffer().raw, expected.get_buffer().raw)
+
+        # the flags passed to fblits are used by items without their own flags
+        expected.fblits(blit_list, BLEND_RGB_ADD)
+        dst.fblits(batch, BLEND_RGB_ADD)
+        self.assertEqual(dst.get_buffer().raw, expected.get_buffer().raw)
+
+        batch.clear()
+        self.assertEqual(len(batch), 0)
+        dst.fblits(batch)
+        self.assertEqual(dst.get_buffer().raw, expected.get_buffer().raw)
+
+    def test_fblits_blit_batch_area_and_flags(self):
+        src = pygame.Surface((20, 20))
+        src.fill((10, 20, 30))
+        src.fill((100, 100, 100), (10, 10, 10, 10))
+        blit_items = [
+            (src, (0, 0)),
+            (src, (20, 0), pygame.Rect(10, 10, 5, 5)),
+            (src, (30, 0), None, BLEND_RGB_ADD),
+            (src, (0, 20), (10, 10, 10, 10), BLEND_RGB_SUB),
+        ]
+
+        expected = pygame.Surface((60, 40))
+        expected.fill((50, 50, 50))
+        expected.blits(blit_items, doreturn=0)
+
+        batch = pygame.BlitBatch()
+        for item in blit_items:
+            batch.append(*item)
+
+        dst = pygame.Surface((60, 40))
+        dst.fill((50, 50, 50))
+        dst.fblits(batch)
+        self.assertEqual(dst.get_buffer().raw, expected.get_buffer().raw)
+
+        batch2 = pygame.BlitBatch()
+        batch2.extend(blit_items)
+        self.assertEqual(len(batch2), len(blit_items))
+        dst.fill((50, 50, 50))
+        dst.fblits(batch2)
+        self.assertEqual(dst.get_buffer().raw, expected.get_buffer().raw)
+
+    def test_blit_batch_set_positions(self):
+        import array
+
+        src = pygame.Surface((2, 2))
+        src.fill((255, 0, 0))
+        batch = pygame.BlitBatch([(src, (0, 0)), (src, (0, 0)), (src, (0, 0))])
+        positions = [(1, 1), (5, 2), (-1, 7)]
+
+        expected = pygame.Surface((10, 10))
+        expected.fblits([(src, pos) for pos in positions])
+
+        flat = [c for pos in positions for c in pos]
+        sources = [
+            positions,
+            array.array("i", flat),
+            array.array("h", flat),
+            array.array("q", flat),
+            array.array("d", [c + (0.5 if c >= 0 else -0.5) for c in flat]),
+            memoryview(array.array("i", flat)).cast("B").cast("i", (3, 2)),
+        ]
+        for positions_obj in sources:
+            dst = pygame.Surface((10, 10))
+            batch.set_positions([(100, 100)] * 3)
+            batch.set_positions(positions_obj)
+            dst.fblits(batch)
+            self.assertEqual(dst.get_buffer().raw, expected.get_buffer().raw)
+
+        # a strided view only reads the selected items
+        strided = memoryview(array.array("i", [1, 9, 1, 9]))[::2]
+        batch2 = pygame.BlitBatch([(src, (0, 0))])
+        batch2.set_positions(strided)
+        dst = pygame.Surface((10, 10))
+        dst.fblits(batch2)
+        self.assertEqual(dst.get_at((1, 1)), (255, 0, 0))
+        self.assertEqual(dst.get_at((0, 0)), (0, 0, 0))
+
+        self.assertRaises(ValueError, batch.set_positions, positions[:2])
+        self.assertRaises(ValueError, batch.set_positions, array.array("i", flat[:5]))
+        self.assertRaises(TypeError, batch.set_positions, [(1, 1), "ab", None])
+        self.assertRaises(TypeError, batch.set_positions, 5)
+
+    def test_blit_batch_set_positions_out_of_range(self):
+        import array
+
+        src = pygame.Surface((2, 2))
+        src.fill((255, 0, 0))
+        batch = pygame.BlitBatch([(src, (0, 0)), (src, (0, 0))])
+        batch.set_positions([(1, 1), (5, 5)])
+
+        for typecode, bad, error in (
+            ("d", float("nan"), ValueError),
+            ("f", float("nan"), ValueError),
+            ("d", float("-inf"), ValueError),
+            ("d", 1e300, OverflowError),
+            ("d", -1e300, OverflowError),
+            ("f", 3e9, OverflowError),
+        ):
+            positions = array.array(typecode, [0, 0, 3, bad])
+            self.assertRaises(error, batch.set_positions, positions)
+        self.assertRaises(
+            OverflowError, batch.set_positions, array.array("q", [0, 0, 2**40, 0])
+        )
+        self.assertRaises(
+            OverflowError, batch.set_positions, array.array("Q", [0, 0, 2**63, 0])
+        )
+
+        # a rejected array leaves the positions untouched
+        dst = pygame.Surface((10, 10))
+        dst.fblits(batch)
+        self.assertEqual(dst.get_at((1, 1)), (255, 0, 0))
+        self.assertEqual(dst.get_at((5, 5)), (255, 0, 0))
+        self.assertEqual(dst.get_at((0, 0)), (0, 0, 0))
+
+    def test_blit_batch_bad_items(self):
+        surf = pygame.Surface((10, 10))
+        batch = pygame.BlitBatch()
+        self.assertRaises(TypeError, batch.append, None, (0, 0))
+        self.assertRaises(TypeError, batch.append, surf, "ab")
+        self.assertRaises(TypeError, batch.append, surf, (0, 0), "area")
+        self.assertRaises(ValueError, batch.extend, [(surf,)])
+        self.assertRaises(TypeError, batch.extend, [(surf, (0, 0), None, "x")])
+        self.assertRaises(TypeError, pygame.BlitBatch, 5)
+        self.assertEqual(len(batch), 0)
+
     def test_blits_not_sequence(self):
         dst = pygame.Surface((100, 10), SRCALPHA, 32)
         self.assertRaises(ValueError, dst.blits, None)
@@ -11,6 +11,7 @@ try:
     from pygame.tests.test_utils.arrinter import *
 except (ImportError, NameError):
     pass
+import array
 import ctypes
 import gc
 import itertools
@@ -1845,6 +1846,56 @@ class GeneralSurfaceTests(unittest.TestCase):
         finally:
             pygame.display.quit()
 
+    def test_convert__24_and_32_bit_formats(self):
+        """Ensure convert moves the channels between 24 and 32 bit formats."""
+        formats = [
+            (0, 24, (0xFF0000, 0xFF00, 0xFF, 0)),
+            (0, 24, (0xFF, 0xFF00, 0xFF0000, 0)),
+            (0, 32, (0xFF0000, 0xFF00, 0xFF, 0)),
+            (0, 32, (0xFF, 0xFF00, 0xFF0000, 0)),
+            (SRCALPHA, 32, (0xFF0000, 0xFF00, 0xFF, 0xFF000000)),
+            (SRCALPHA, 32, (0xFF00, 0xFF0000, 0xFF000000, 0xFF)),
+        ]
+        # an odd width covers the pixels left over by the vectorized loops
+        size = (37, 3)
+
+        pygame.display.init()
+        try:
+            for src_format in formats:
+                src = pygame.Surface(size, *src_format)
+                for x in range(size[0]):
+                    for y in range(size[1]):
+                        src.set_at((x, y), (x * 7, y * 50, 255 - x, x * 3 + y))
+                for dst_format in formats:
+                    dst = src.convert(pygame.Surface((1, 1), *dst_format))
+                    self.assertEqual(dst.get_masks(), dst_format[2])
+                    both_alpha = src_format[2][3] and dst_format[2][3]
+                    for x in range(size[0]):
+                        for y in range(size[1]):
+                            r, g, b, a = src.get_at((x, y))
+                            self.assertEqual(
+                                dst.get_at((x, y)), (r, g, b, a if both_alpha else 255)
+                            )
+        finally:
+            pygame.display.quit()
+
+    def test_convert__keeps_surface_settings(self):
+        """Ensure convert keeps the surface alpha and clip of the surface."""
+        surf = pygame.Surface((20, 10), 0, 24)
+        surf.fill((10, 20, 30))
+        surf.set_alpha(100)
+        surf.set_clip((2, 3, 4, 5))
+
+        pygame.display.init()
+        try:
+            converted = surf.convert(pygame.Surface((1, 1), SRCALPHA, 32))
+
+            self.assertEqual(converted.get_alpha(), 100)
+            self.assertEqual(converted.get_clip(), pygame.Rect(2, 3, 4, 5))
+            self.assertEqual(converted.get_at((5, 5)), (10, 20, 30, 255))
+        finally:
+            pygame.display.quit()
+
     def test_convert_alpha_argument_deprecation(self):
         pygame.display.init()
         pygame.display.set_mode((640, 480))
@@ -4383,6 +4434,911 @@ class SurfaceFillTest(unittest.TestCase):
                     screen.get_at((col, row)), other_surface.get_at((col, row))
                 )
 
+    def test_fill_rects_matches_fill(self):
+        rects = [(x * 7 - 3, y * 5 - 2, 6, 4) for x in range(8) for y in range(10)]
+        colors = [((i * 37) % 256, (i * 91) % 256, i % 256) for i in range(80)]
+        flags = (0, pygame.BLEND_ADD, pygame.BLEND_RGBA_MULT, pygame.BLEND_MAX)
+        for depth in (8, 16, 24, 32):
+            for flag in flags:
+                expected = pygame.Surface((50, 40), depth=depth)
+                expected.fill((30, 60, 90))
+                result = expected.copy()
+                for rect, color in zip(rects, colors):
+                    expected.fill(color, rect, flag)
+
+                bounds = result.fill_rects(colors, rects, flag)
+                self.assertEqual(bounds, pygame.Rect(0, 0, 50, 40))
+                for x in range(50):
+                    for y in range(40):
+                        self.assertEqual(result.get_at((x, y)), expected.get_at((x, y)))
+
+    def test_fill_rects_single_color_and_buffers(self):
+        surf = pygame.Surface((10, 10))
+        bounds = surf.fill_rects("red", [(1, 1, 2, 2), pygame.Rect(5, 6, 1, 1)])
+        self.assertEqual(bounds, pygame.Rect(1, 1, 5, 6))
+        self.assertEqual(surf.get_at((2, 2)), (255, 0, 0, 255))
+        self.assertEqual(surf.get_at((5, 6)), (255, 0, 0, 255))
+        self.assertEqual(surf.get_at((3, 3)), (0, 0, 0, 255))
+
+        rects = memoryview(array.array("i", [0, 0, 1, 1, 9, 9, 1, 1]))
+        colors = memoryview(bytearray([0, 255, 0, 0, 0, 255])).cast("B", (2, 3))
+        surf.fill_rects(colors, rects)
+        self.assertEqual(surf.get_at((0, 0)), (0, 255, 0, 255))
+        self.assertEqual(surf.get_at((9, 9)), (0, 0, 255, 255))
+
+        surf.fill_rects((1, 2, 3), rects.cast("B").cast("i", (2, 4)))
+        self.assertEqual(surf.get_at((9, 9)), (1, 2, 3, 255))
+
+        surf.set_clip((0, 0, 5, 5))
+        bounds = surf.fill_rects("white", [(3, 3, 5, 5), (6, 6, 1, 1)])
+        self.assertEqual(bounds, pygame.Rect(3, 3, 2, 2))
+        self.assertEqual(surf.get_at((4, 4)), (255, 255, 255, 255))
+        self.assertEqual(surf.get_at((5, 5)), (0, 0, 0, 255))
+
+    def test_fill_rects_empty_and_errors(self):
+        surf = pygame.Surface((10, 10))
+        self.assertEqual(surf.fill_rects("red", []), pygame.Rect(0, 0, 0, 0))
+        self.assertEqual(
+            surf.fill_rects("red", [(20, 20, 5, 5)]), pygame.Rect(0, 0, 0, 0)
+        )
+        with self.assertRaises(ValueError):
+            surf.fill_rects(["red", "blue"], [(0, 0, 1, 1)])
+        with self.assertRaises(ValueError):
+            surf.fill_rects("not a color", [(0, 0, 1, 1)])
+        with self.assertRaises(TypeError):
+            surf.fill_rects("red", [(0, 0, 1, 1), "invalid"])
+        with self.assertRaises(ValueError):
+            surf.fill_rects("red", array.array("i", [0, 0, 1]))
+        with self.assertRaises(ValueError):
+            surf.fill_rects("red", array.array("d", [0, 0, float("nan"), 1]))
+        with self.assertRaises(OverflowError):
+            surf.fill_rects("red", array.array("d", [0, 0, 1e300, 1]))
+
+    def test_fill_gradient_linear(self):
+        surf = pygame.Surface((100, 10))
+        bounds = surf.fill_gradient(None, [(0, 0, 0), (255, 0, 0)])
+        self.assertEqual(bounds, pygame.Rect(0, 0, 100, 10))
+        for x in range(100):
+            red = surf.get_at((x, 5)).r
+            self.assertAlmostEqual(red, 255 * (x + 0.5) / 100, delta=2)
+            self.assertEqual(surf.get_at((x, 0)), surf.get_at((x, 9)))
+
+        # 90 degrees goes from the bottom to the top
+        surf = pygame.Surface((10, 100))
+        surf.fill_gradient(None, ["black", "white"], angle=90)
+        self.assertAlmostEqual(surf.get_at((5, 99)).r, 1, delta=2)
+        self.assertAlmostEqual(surf.get_at((5, 0)).r, 254, delta=2)
+        self.assertEqual(surf.get_at((0, 40)), surf.get_at((9, 40)))
+
+    def test_fill_gradient_stops(self):
+        surf = pygame.Surface((100, 4))
+        stops = [(0, "red"), (0.5, "red"), (0.5, "blue"), (1, "blue")]
+        surf.fill_gradient(None, stops)
+        self.assertEqual(surf.get_at((10, 1)), (255, 0, 0, 255))
+        self.assertEqual(surf.get_at((48, 1)), (255, 0, 0, 255))
+        self.assertEqual(surf.get_at((52, 1)), (0, 0, 255, 255))
+        self.assertEqual(surf.get_at((99, 1)), (0, 0, 255, 255))
+
+        # plain colors and pairs can be mixed, plain colors are spread evenly
+        surf.fill_gradient(None, [(0, 0, 0), (0.9, "white"), "white"])
+        self.assertAlmostEqual(surf.get_at((45, 1)).r, 128, delta=3)
+        self.assertEqual(surf.get_at((95, 1)), (255, 255, 255, 255))
+
+        surf.fill_gradient((0, 0, 100, 4), ["green"])
+        self.assertEqual(surf.get_at((0, 0)), (0, 255, 0, 255))
+        self.assertEqual(surf.get_at((99, 3)), (0, 255, 0, 255))
+
+    def test_fill_gradient_radial_and_conic(self):
+        surf = pygame.Surface((21, 21))
+        surf.fill_gradient(None, ["white", "black"], "radial")
+        self.assertEqual(surf.get_at((10, 10)), (255, 255, 255, 255))
+        self.assertEqual(surf.get_at((0, 0)), (0, 0, 0, 255))
+        self.assertEqual(surf.get_at((0, 10)), surf.get_at((10, 0)))
+        self.assertGreater(surf.get_at((10, 5)).r, surf.get_at((10, 2)).r)
+
+        surf = pygame.Surface((20, 20))
+        surf.fill_gradient(None, ["black", "white"], "conic")
+        self.assertLess(surf.get_at((19, 9)).r, 5)
+        self.assertGreater(surf.get_at((19, 10)).r, 250)
+        self.assertAlmostEqual(surf.get_at((10, 0)).r, 62, delta=3)
+        self.assertAlmostEqual(surf.get_at((0, 10)).r, 130, delta=3)
+
+        # the start rotates counterclockwise with the angle
+        surf.fill_gradient(None, ["black", "white"], "conic", 90)
+        self.assertLess(surf.get_at((9, 0)).r, 5)
+        self.assertGreater(surf.get_at((10, 0)).r, 250)
+
+    def test_fill_gradient_clip(self):
+        expected = pygame.Surface((40, 30))
+        expected.fill_gradient((5, 5, 30, 20), ["red", "yellow", "blue"], angle=30)
+
+        surf = pygame.Surface((40, 30))
+        surf.set_clip((20, 0, 40, 12))
+        bounds = surf.fill_gradient(
+            (5, 5, 30, 20), ["red", "yellow", "blue"], angle=30
+        )
+        self.assertEqual(bounds, pygame.Rect(20, 5, 15, 7))
+        for x in range(40):
+            for y in range(30):
+                if not bounds.collidepoint(x, y):
+                    self.assertEqual(surf.get_at((x, y)), (0, 0, 0, 255))
+                    continue
+                # rows starting at another pixel may round to the next color
+                color = surf.get_at((x, y))
+                for i, value in enumerate(expected.get_at((x, y))):
+                    self.assertAlmostEqual(color[i], value, delta=1)
+
+        bounds = surf.fill_gradient((0, 20, 10, 10), ["red", "blue"])
+        self.assertEqual(bounds, pygame.Rect(0, 0, 0, 0))
+
+    def test_fill_gradient_special_flags(self):
+        ops = {
+            pygame.BLEND_ADD: lambda d, g: min(d + g, 255),
+            pygame.BLEND_SUB: lambda d, g: max(d - g, 0),
+            pygame.BLEND_MULT: lambda d, g: (d * g + 255) >> 8,
+            pygame.BLEND_MIN: min,
+            pygame.BLEND_MAX: max,
+        }
+        stops = [(250, 10, 0), (0, 128, 255), (60, 200, 100)]
+        for depth, flags in ((24, 0), (32, 0), (32, pygame.SRCALPHA)):
+            base = pygame.Surface((37, 5), flags, depth)
+            base.fill((30, 60, 90, 100))
+            gradient = base.copy()
+            gradient.fill_gradient(None, stops)
+            for flag, op in ops.items():
+                surf = base.copy()
+                surf.fill_gradient(None, stops, special_flags=flag)
+                for x in range(37):
+                    d = base.get_at((x, 2))
+                    g = gradient.get_at((x, 2))
+                    expected = tuple(op(d[i], g[i]) for i in range(3)) + (d.a,)
+                    self.assertEqual(surf.get_at((x, 2)), expected)
+
+        base = pygame.Surface((37, 5), pygame.SRCALPHA)
+        base.fill((30, 60, 90, 100))
+        gradient = base.copy()
+        stops = [(250, 10, 0, 50), (0, 128, 255, 255)]
+        gradient.fill_gradient(None, stops)
+        surf = base.copy()
+        surf.fill_gradient(None, stops, special_flags=pygame.BLEND_RGBA_ADD)
+        for x in range(37):
+            d = base.get_at((x, 2))
+            g = gradient.get_at((x, 2))
+            expected = tuple(min(d[i] + g[i], 255) for i in range(4))
+            self.assertEqual(surf.get_at((x, 2)), expected)
+
+    def test_fill_gradient_depths(self):
+        for depth in (8, 16, 24, 32):
+            surf = pygame.Surface((50, 3), depth=depth)
+            surf.fill_gradient(None, ["black", "white"])
+            surf.fill_gradient(
+                None, ["black", "white"], special_flags=pygame.BLEND_ADD
+            )
+            self.assertLess(surf.get_at((0, 1)).r, 20)
+            self.assertGreater(surf.get_at((49, 1)).r, 235)
+
+    def test_fill_gradient_errors(self):
+        surf = pygame.Surface((10, 10))
+        with self.assertRaises(ValueError):
+            surf.fill_gradient(None, ["red", "blue"], "diamond")
+        with self.assertRaises(ValueError):
+            surf.fill_gradient(None, [])
+        with self.assertRaises(TypeError):
+            surf.fill_gradient(None, "red")
+        with self.assertRaises(ValueError):
+            surf.fill_gradient(None, ["red", "not a color"])
+        with self.assertRaises(ValueError):
+            surf.fill_gradient(None, [(0.5, "red"), (1.5, "blue")])
+        with self.assertRaises(ValueError):
+            surf.fill_gradient(None, [(0.5, "red"), (0.25, "blue")])
+        with self.assertRaises(ValueError):
+            surf.fill_gradient(None, ["red", "blue"], angle=float("nan"))
+        with self.assertRaises(ValueError):
+            surf.fill_gradient("invalid", ["red", "blue"])
+        with self.assertRaises(pygame.error):
+            surf.fill_gradient(
+                None, ["red", "blue"], special_flags=pygame.BLEND_PREMULTIPLIED
+            )
+
+
+class SurfaceDirtyRectsTest(unittest.TestCase):
+    def test_tracking_off_by_default(self):
+        surf = pygame.Surface((20, 20))
+        surf.fill("red")
+
+        self.assertFalse(surf.get_dirty_tracking())
+        self.assertEqual(surf.get_dirty_rects(), [])
+
+    def test_set_dirty_tracking(self):
+        surf = pygame.Surface((20, 20))
+        surf.set_dirty_tracking()
+        self.assertTrue(surf.get_dirty_tracking())
+        self.assertEqual(surf.get_dirty_rects(), [])
+
+        surf.fill("red", (2, 3, 4, 5))
+        self.assertEqual(surf.get_dirty_rects(), [pygame.Rect(2, 3, 4, 5)])
+
+        surf.clear_dirty()
+        self.assertTrue(surf.get_dirty_tracking())
+        self.assertEqual(surf.get_dirty_rects(), [])
+
+        surf.fill("red", (2, 3, 4, 5))
+        surf.set_dirty_tracking(False)
+        self.assertFalse(surf.get_dirty_tracking())
+        self.assertEqual(surf.get_dirty_rects(), [])
+
+    def test_blits_are_recorded(self):
+        src = pygame.Surface((10, 10))
+        surf = pygame.Surface((100, 100))
+        surf.set_dirty_tracking(True)
+
+        surf.blit(src, (95, -5))
+        self.assertEqual(surf.get_dirty_rects(), [pygame.Rect(95, 0, 5, 5)])
+        surf.clear_dirty()
+
+        surf.blit(src, (200, 200))
+        self.assertEqual(surf.get_dirty_rects(), [])
+
+        surf.blits([(src, (0, 0)), (src, (50, 50), (0, 0, 4, 4))], doreturn=0)
+        self.assertEqual(
+            sorted(surf.get_dirty_rects()),
+            [pygame.Rect(0, 0, 10, 10), pygame.Rect(50, 50, 4, 4)],
+        )
+        surf.clear_dirty()
+
+        surf.fblits([(src, (20, 20))])
+        surf.fblits(pygame.BlitBatch([(src, (40, 20))]))
+        self.assertEqual(
+            sorted(surf.get_dirty_rects()),
+            [pygame.Rect(20, 20, 10, 10), pygame.Rect(40, 20, 10, 10)],
+        )
+
+    def test_rects_are_coalesced(self):
+        surf = pygame.Surface((100, 100))
+        surf.set_dirty_tracking()
+
+        surf.fill("red", (0, 0, 10, 10))
+        surf.fill("red", (2, 2, 5, 5))
+        self.assertEqual(surf.get_dirty_rects(), [pygame.Rect(0, 0, 10, 10)])
+
+        surf.fill("red", (10, 0, 10, 10))
+        self.assertEqual(surf.get_dirty_rects(), [pygame.Rect(0, 0, 20, 10)])
+
+        surf.fill("red", (0, 0, 50, 50))
+        self.assertEqual(surf.get_dirty_rects(), [pygame.Rect(0, 0, 50, 50)])
+
+    def test_many_rects_are_bounded(self):
+        surf = pygame.Surface((200, 200))
+        surf.set_dirty_tracking()
+        points = [(x * 7 % 200, x * 13 % 200) for x in range(300)]
+        for point in points:
+            surf.fill("red", (point, (1, 1)))
+
+        rects = surf.get_dirty_rects()
+        self.assertLessEqual(len(rects), 32)
+        for point in points:
+            self.assertNotEqual(pygame.Rect(point, (1, 1)).collidelist(rects), -1)
+
+    def test_draw_and_transform_are_recorded(self):
+        surf = pygame.Surface((100, 100))
+        surf.set_dirty_tracking()
+
+        drawn = pygame.draw.rect(surf, "red", (10, 10, 20, 5))
+        self.assertEqual(surf.get_dirty_rects(), [drawn])
+        surf.clear_dirty()
+
+        drawn = pygame.draw.line(surf, "red", (60, 60), (80, 90), 3)
+        self.assertEqual(surf.get_dirty_rects(), [drawn])
+        surf.clear_dirty()
+
+        pygame.draw.line(surf, "red", (-60, -60), (-80, -90))
+        self.assertEqual(surf.get_dirty_rects(), [])
+
+        pygame.transform.scale(pygame.Surface((10, 10)), (100, 100), surf)
+        self.assertEqual(surf.get_dirty_rects(), [surf.get_rect()])
+
+    def test_gfxdraw_and_premul_are_recorded(self):
+        import pygame.gfxdraw
+
+        surf = pygame.Surface((100, 100), pygame.SRCALPHA)
+        surf.set_dirty_tracking()
+
+        pygame.gfxdraw.pixel(surf, 3, 4, "red")
+        self.assertEqual(surf.get_dirty_rects(), [surf.get_rect()])
+        surf.clear_dirty()
+
+        pygame.gfxdraw.filled_circle(surf, 50, 50, 10, "red")
+        self.assertEqual(surf.get_dirty_rects(), [surf.get_rect()])
+        surf.clear_dirty()
+
+        surf.premul_alpha_ip()
+        self.assertEqual(surf.get_dirty_rects(), [surf.get_rect()])
+
+    def test_failed_premul_unlocks_parent(self):
+        parent = pygame.Surface((20, 20), depth=24)
+        child = parent.subsurface((0, 0, 10, 10))
+
+        self.assertRaises(ValueError, child.premul_alpha_ip)
+        self.assertFalse(parent.get_locked())
+
+    def test_subsurface_changes_reach_parent(self):
+        parent = pygame.Surface((100, 100))
+        parent.set_dirty_tracking()
+        child = parent.subsurface((10, 20, 30, 30))
+        grandchild = child.subsurface((5, 5, 10, 10))
+        child.set_dirty_tracking()
+
+        grandchild.fill("red", (1, 2, 3, 4))
+        self.assertEqual(parent.get_dirty_rects(), [pygame.Rect(16, 27, 3, 4)])
+        self.assertEqual(child.get_dirty_rects(), [pygame.Rect(6, 7, 3, 4)])
+        self.assertEqual(grandchild.get_dirty_rects(), [])
+
+    def test_display_update_clears_dirty_rects(self):
+        pygame.display.init()
+        try:
+            screen = pygame.display.set_mode((100, 100))
+            screen.set_dirty_tracking()
+            screen.fill("red", (0, 0, 10, 10))
+            pygame.display.update()
+            self.assertEqual(screen.get_dirty_rects(), [])
+
+            screen.fill("red", (0, 0, 10, 10))
+            pygame.display.flip()
+            self.assertEqual(screen.get_dirty_rects(), [])
+        finally:
+            pygame.display.quit()
+
+
+class SurfaceSpanEncodingTest(unittest.TestCase):
+    @staticmethod
+    def _sprite():
+        sprite = pygame.Surface((40, 30), pygame.SRCALPHA)
+        sprite.fill((255, 0, 0, 255), (5, 5, 10, 20))
+        sprite.fill((0, 255, 0, 128), (12, 3, 20, 6))
+        sprite.fill((0, 0, 255, 1), (30, 20, 10, 10))
+        sprite.set_at((0, 0), (10, 20, 30, 255))
+        return sprite
+
+    def _assert_same_blits(self, sprite, dest, positions, area=None):
+        expected = dest.copy()
+        result = dest.copy()
+        for pos in positions:
+            expected.blit(sprite, pos, area)
+        sprite.set_span_encoding()
+        for pos in positions:
+            result.blit(sprite, pos, area)
+        sprite.set_span_encoding(False)
+        self.assertEqual(
+            pygame.image.tobytes(result, "RGBA"),
+            pygame.image.tobytes(expected, "RGBA"),
+        )
+
+    def test_set_get_span_encoding(self):
+        surf = pygame.Surface((10, 10))
+        self.assertFalse(surf.get_span_encoding())
+        surf.set_span_encoding()
+        self.assertTrue(surf.get_span_encoding())
+        surf.set_span_encoding(False)
+        self.assertFalse(surf.get_span_encoding())
+
+        with self.assertRaises(ValueError):
+            surf.subsurface((0, 0, 5, 5)).set_span_encoding()
+
+    def test_blit_matches_plain_blit(self):
+        positions = [(0, 0), (-7, 3), (25, -4), (60, 50), (90, 75), (200, 0)]
+        for dest_flags in (0, pygame.SRCALPHA):
+            dest = pygame.Surface((100, 80), dest_flags)
+            dest.fill((40, 80, 120, 200))
+            dest.fill((0, 0, 0, 0), (50, 40, 50, 40))
+            self._assert_same_blits(self._sprite(), dest, positions)
+            self._assert_same_blits(
+                self._sprite(), dest, positions, pygame.Rect(8, 4, 25, 20)
+            )
+
+    def test_blit_with_surface_alpha(self):
+        sprite = self._sprite()
+        sprite.set_alpha(100)
+        self._assert_same_blits(sprite, pygame.Surface((50, 50)), [(3, 4)])
+
+    def test_colorkey_blit(self):
+        sprite = pygame.Surface((20, 20))
+        sprite.fill("magenta")
+        sprite.fill("yellow", (2, 3, 5, 10))
+        sprite.set_colorkey("magenta")
+        dest = pygame.Surface((40, 40))
+        dest.fill("blue")
+        self._assert_same_blits(sprite, dest, [(0, 0), (-5, 25), (30, 10)])
+
+    def test_changes_are_picked_up(self):
+        sprite = self._sprite()
+        sprite.set_span_encoding()
+        dest = pygame.Surface((40, 30))
+        dest.blit(sprite, (0, 0))
+
+        sprite.fill((0, 0, 0, 0))
+        sprite.set_at((1, 1), (255, 255, 255, 255))
+        dest.fill("black")
+        dest.blit(sprite, (0, 0))
+        self.assertEqual(dest.get_at((1, 1)), (255, 255, 255, 255))
+        self.assertEqual(dest.get_at((6, 6)), (0, 0, 0, 255))
+
+        sprite.blit(self._sprite(), (0, 0))
+        dest.fill("black")
+        dest.blit(sprite, (0, 0))
+        self.assertEqual(dest.get_at((6, 6)), (255, 0, 0, 255))
+
+        pygame.draw.rect(sprite, (0, 0, 255, 255), (20, 25, 5, 5))
+        sprite.subsurface((0, 0, 10, 10)).fill((0, 0, 0, 0))
+        dest.fill("black")
+        dest.blit(sprite, (0, 0))
+        self.assertEqual(dest.get_at((6, 6)), (0, 0, 0, 255))
+        self.assertEqual(dest.get_at((22, 27)), (0, 0, 255, 255))
+
+        sprite.set_colorkey((0, 0, 255))
+        dest.fill("black")
+        dest.blit(sprite, (0, 0))
+        self.assertEqual(dest.get_at((22, 27)), (0, 0, 0, 255))
+
+    def test_gfxdraw_changes_are_picked_up(self):
+        import pygame.gfxdraw
+
+        sprite = self._sprite()
+        sprite.set_span_encoding()
+        dest = pygame.Surface((40, 30))
+        dest.blit(sprite, (0, 0))
+
+        # (35, 5) was fully transparent when the runs were encoded
+        pygame.gfxdraw.box(sprite, (33, 3, 5, 5), (255, 255, 0, 255))
+        pygame.gfxdraw.pixel(sprite, 1, 28, (0, 255, 255, 255))
+        dest.fill("black")
+        dest.blit(sprite, (0, 0))
+        self.assertEqual(dest.get_at((35, 5)), (255, 255, 0, 255))
+        self.assertEqual(dest.get_at((1, 28)), (0, 255, 255, 255))
+
+    def test_writes_through_pixelarray(self):
+        results = []
+        for encoded in (False, True):
+            sprite = self._sprite()
+            sprite.set_span_encoding(encoded)
+            dest = pygame.Surface((40, 30))
+            dest.blit(sprite, (0, 0))
+
+            pixels = pygame.PixelArray(sprite)
+            # the PixelArray keeps the sprite locked, so it can't be blitted
+            self.assertRaises(pygame.error, dest.blit, sprite, (0, 0))
+            pixels[0:10, 0:10] = sprite.map_rgb((0, 0, 0, 0))
+            pixels[20:25, 25:30] = sprite.map_rgb((0, 0, 255, 255))
+            pixels.close()
+
+            dest.fill("black")
+            dest.blit(sprite, (0, 0))
+            self.assertEqual(dest.get_at((6, 6)), (0, 0, 0, 255))
+            self.assertEqual(dest.get_at((22, 27)), (0, 0, 255, 255))
+            results.append(pygame.image.tobytes(dest, "RGBA"))
+        self.assertEqual(results[1], results[0])
+
+
+
+class SurfaceCopyOnWriteTest(unittest.TestCase):
+    @staticmethod
+    def _pair():
+        source = pygame.Surface((16, 8), pygame.SRCALPHA)
+        source.fill((10, 20, 30, 40))
+        return source, source.copy()
+
+    def _assert_unchanged(self, surf):
+        self.assertEqual(surf.get_at((3, 3)), (10, 20, 30, 40))
+
+    def test_writes_to_either_side(self):
+        writes = [
+            lambda s: s.fill("red"),
+            lambda s: s.set_at((3, 3), "red"),
+            lambda s: s.blit(pygame.Surface((16, 8)), (0, 0)),
+            lambda s: s.scroll(20, 0, pygame.SCROLL_ERASE),
+            lambda s: pygame.draw.circle(s, "red", (3, 3), 3),
+            lambda s: pygame.transform.invert(pygame.Surface((16, 8)), s),
+            lambda s: s.subsurface((0, 0, 8, 8)).fill("red"),
+        ]
+        for write in writes:
+            source, copy = self._pair()
+            write(copy)
+            self._assert_unchanged(source)
+
+            source, copy = self._pair()
+            write(source)
+            self._assert_unchanged(copy)
+
+    def test_reads_keep_sides_apart(self):
+        """Reading a side without unsharing it still leaves later writes
+        to one side invisible to the other"""
+        reads = [
+            lambda s: s.get_at((3, 3)),
+            lambda s: s.get_bounding_rect(),
+            lambda s: pygame.Surface((8, 8)).blit(s.subsurface((0, 0, 8, 8)), (0, 0)),
+            lambda s: pygame.transform.scale(s, (4, 4)),
+            lambda s: pygame.transform.smoothscale(s, (32, 16)),
+            lambda s: pygame.transform.rotate(s, 90),
+        ]
+        for read in reads:
+            source, copy = self._pair()
+            read(source)
+            read(copy)
+            copy.fill("red")
+            self._assert_unchanged(source)
+
+            source, copy = self._pair()
+            read(copy)
+            source.fill("red")
+            self._assert_unchanged(copy)
+
+    def test_pixel_array(self):
+        source, copy = self._pair()
+        with pygame.PixelArray(copy) as array:
+            array[3, 3] = (255, 0, 0, 255)
+        self._assert_unchanged(source)
+        self.assertEqual(copy.get_at((3, 3)), (255, 0, 0, 255))
+
+    def test_many_copies(self):
+        source, copy = self._pair()
+        copies = [source.copy() for _ in range(200)]
+        copy_of_copy = copy.copy()
+        source.fill("blue")
+        copy.fill("green")
+        for other in copies + [copy_of_copy]:
+            self._assert_unchanged(other)
+
+    def test_source_deleted_or_reinitialized(self):
+        source, copy = self._pair()
+        del source
+        gc.collect()
+        self._assert_unchanged(copy)
+        copy.fill("red")
+
+        source, copy = self._pair()
+        source.__init__((4, 4))
+        self._assert_unchanged(copy)
+        source.fill("red")
+        self._assert_unchanged(copy)
+
+    def test_copy_keeps_settings(self):
+        source = pygame.Surface((8, 8))
+        source.set_colorkey((1, 2, 3))
+        source.set_alpha(100)
+        copy = source.copy()
+        self.assertEqual(copy.get_colorkey(), (1, 2, 3, 255))
+        self.assertEqual(copy.get_alpha(), 100)
+
+        source.set_colorkey((1, 2, 3), pygame.RLEACCEL)
+        source.fill((4, 5, 6))
+        self.assertEqual(copy.get_at((0, 0)), (0, 0, 0, 255))
+
+
+class SurfaceBlitTransformedTest(unittest.TestCase):
+    @staticmethod
+    def _source():
+        source = pygame.Surface((6, 4), pygame.SRCALPHA)
+        for x in range(6):
+            for y in range(4):
+                source.set_at((x, y), (40 * x, 60 * y, 100, 50 + 50 * y))
+        return source
+
+    def _assert_same(self, surf, expected):
+        self.assertEqual(surf.get_size(), expected.get_size())
+        for x in range(surf.get_width()):
+            for y in range(surf.get_height()):
+                self.assertEqual(surf.get_at((x, y)), expected.get_at((x, y)))
+
+    def _draw_both(self, transformed, **kwargs):
+        source = self._source()
+        expected = pygame.Surface((12, 12))
+        expected.fill((5, 5, 5))
+        result = expected.copy()
+        expected.blit(transformed(source), (3, 2))
+        rect = result.blit_transformed(source, (3, 2), **kwargs)
+        self._assert_same(result, expected)
+        return rect
+
+    def test_identity_matches_blit(self):
+        for smooth in (True, False):
+            rect = self._draw_both(lambda s: s, smooth=smooth)
+            self.assertEqual(rect, pygame.Rect(3, 2, 6, 4))
+
+    def test_flip_matches_flip(self):
+        for flip_x, flip_y in ((True, False), (False, True), (True, True)):
+            self._draw_both(
+                lambda s: pygame.transform.flip(s, flip_x, flip_y),
+                flip_x=flip_x,
+                flip_y=flip_y,
+                smooth=False,
+            )
+
+    def test_rotate_matches_rotate(self):
+        for angle in (90, 180, -90):
+            rect = self._draw_both(
+                lambda s: pygame.transform.rotate(s, angle),
+                angle=angle,
+                smooth=False,
+            )
+            self.assertEqual(rect.topleft, (3, 2))
+
+    @staticmethod
+    def _coverage(surf):
+        """Number and centroid of the mostly opaque pixels of surf"""
+        count = sum_x = sum_y = 0
+        for x in range(surf.get_width()):
+            for y in range(surf.get_height()):
+                if surf.get_at((x, y)).a >= 128:
+                    count += 1
+                    sum_x += x
+                    sum_y += y
+        return count, sum_x / count, sum_y / count
+
+    def test_rotozoom_matches_rotozoom(self):
+        source = pygame.Surface((20, 12), pygame.SRCALPHA)
+        source.fill("red", (0, 0, 12, 6))
+        size = (60, 60)
+
+        result = pygame.Surface(size, pygame.SRCALPHA)
+        rect = result.blit_transformed(source, (5, 5), angle=30, scale=1.5)
+        expected_surf = pygame.transform.rotozoom(source, 30, 1.5)
+        self.assertLessEqual(rect.w, expected_surf.get_width())
+        self.assertLessEqual(rect.h, expected_surf.get_height())
+        self.assertGreaterEqual(rect.w, expected_surf.get_width() - 2)
+        self.assertGreaterEqual(rect.h, expected_surf.get_height() - 2)
+
+        expected = pygame.Surface(size, pygame.SRCALPHA)
+        expected.blit(expected_surf, expected_surf.get_rect(center=rect.center))
+        count, x, y = self._coverage(result)
+        expected_count, expected_x, expected_y = self._coverage(expected)
+        self.assertAlmostEqual(count, expected_count, delta=expected_count / 10)
+        self.assertAlmostEqual(x, expected_x, delta=1.5)
+        self.assertAlmostEqual(y, expected_y, delta=1.5)
+
+    def test_scale(self):
+        source = pygame.Surface((2, 2))
+        source.fill("red")
+        source.set_at((1, 1), "blue")
+        dest = pygame.Surface((8, 8))
+        rect = dest.blit_transformed(source, (1, 1), scale=3, smooth=False)
+
+        self.assertEqual(rect, pygame.Rect(1, 1, 6, 6))
+        self.assertEqual(dest.get_at((3, 3)), (255, 0, 0, 255))
+        self.assertEqual(dest.get_at((4, 4)), (0, 0, 255, 255))
+        self.assertEqual(dest.get_at((6, 6)), (0, 0, 255, 255))
+        self.assertEqual(dest.get_at((7, 7)), (0, 0, 0, 255))
+
+    def test_clipping(self):
+        source = pygame.Surface((10, 10))
+        source.fill("red")
+        dest = pygame.Surface((20, 20))
+        dest.set_clip((0, 0, 5, 20))
+
+        rect = dest.blit_transformed(source, (2, 3), angle=45)
+        self.assertEqual(rect.topleft, (2, 3))
+        self.assertEqual(rect.right, 5)
+        self.assertEqual(dest.get_at((5, 10)), (0, 0, 0, 255))
+
+        rect = dest.blit_transformed(source, (30, 3))
+        self.assertEqual(rect, pygame.Rect(30, 3, 0, 0))
+
+    def test_other_depths_and_self(self):
+        for depth in (8, 16, 24):
+            source = pygame.Surface((4, 4), depth=depth)
+            source.fill((255, 0, 0))
+            dest = pygame.Surface((4, 4))
+            dest.blit_transformed(source, (0, 0), angle=180)
+            self.assertEqual(dest.get_at((1, 1)), source.get_at((1, 1)))
+
+        surf = pygame.Surface((4, 4))
+        surf.fill("red")
+        surf.fill("blue", (0, 0, 2, 4))
+        surf.blit_transformed(surf, (0, 0), flip_x=True)
+        self.assertEqual(surf.get_at((0, 0)), (255, 0, 0, 255))
+        self.assertEqual(surf.get_at((3, 0)), (0, 0, 255, 255))
+
+    def test_special_flags(self):
+        source = pygame.Surface((4, 4))
+        source.fill((10, 20, 30))
+        dest = pygame.Surface((4, 4))
+        dest.fill((1, 2, 3))
+        dest.blit_transformed(
+            source, (0, 0), angle=90, special_flags=pygame.BLEND_ADD
+        )
+        self.assertEqual(dest.get_at((2, 2)), (11, 22, 33, 255))
+
+    def test_invalid_scale(self):
+        dest = pygame.Surface((4, 4))
+        for scale in (0, -1, float("nan")):
+            with self.assertRaises(ValueError):
+                dest.blit_transformed(pygame.Surface((2, 2)), (0, 0), scale=scale)
+        with self.assertRaises(TypeError):
+            dest.blit_transformed(pygame.Surface((2, 2)), "invalid")
+
+
+class SurfaceTiledBlitTest(unittest.TestCase):
+    @staticmethod
+    def _checker(size, colors):
+        surf = pygame.Surface(size)
+        for x in range(size[0]):
+            for y in range(size[1]):
+                surf.set_at((x, y), colors[(x + y) % len(colors)])
+        return surf
+
+    @staticmethod
+    def _panel():
+        """6x6 panel with 2 pixel borders, each piece has its own color"""
+        panel = pygame.Surface((6, 6))
+        for i in range(3):
+            for j in range(3):
+                panel.fill((40 * i, 40 * j, 200), (2 * i, 2 * j, 2, 2))
+        panel.set_at((2, 2), (255, 255, 255))
+        return panel
+
+    def test_blit_tiled(self):
+        source = self._checker((2, 3), ["red", "green", "blue"])
+        dest = pygame.Surface((8, 8))
+
+        rect = dest.blit_tiled(source, (1, 2, 5, 4), (1, 5))
+        self.assertEqual(rect, pygame.Rect(1, 2, 5, 4))
+        for x in range(5):
+            for y in range(4):
+                self.assertEqual(
+                    dest.get_at((1 + x, 2 + y)),
+                    source.get_at(((x + 1) % 2, (y + 5) % 3)),
+                )
+        self.assertEqual(dest.get_at((0, 2)), (0, 0, 0, 255))
+        self.assertEqual(dest.get_at((6, 2)), (0, 0, 0, 255))
+        self.assertEqual(dest.get_at((1, 6)), (0, 0, 0, 255))
+
+    def test_blit_tiled_clip_and_flags(self):
+        source = pygame.Surface((3, 3))
+        source.fill((10, 20, 30))
+        dest = pygame.Surface((8, 8))
+        dest.fill((1, 1, 1))
+        dest.set_clip((0, 0, 4, 4))
+
+        rect = dest.blit_tiled(source, (2, 2, 6, 6), special_flags=pygame.BLEND_ADD)
+        self.assertEqual(rect, pygame.Rect(2, 2, 2, 2))
+        self.assertEqual(dest.get_at((3, 3)), (11, 21, 31, 255))
+        self.assertEqual(dest.get_at((4, 4)), (1, 1, 1, 255))
+
+        rect = dest.blit_tiled(source, (5, 5, 2, 2))
+        self.assertEqual(rect, pygame.Rect(5, 5, 0, 0))
+
+    def test_blit_tiled_huge_rect(self):
+        """Only the tiles inside the clip area are visited, so this does not
+        loop over a billion tiles"""
+        source = self._checker((2, 3), ["red", "green", "blue"])
+        dest = pygame.Surface((8, 8))
+        big = 2**29
+
+        rect = dest.blit_tiled(source, (-big - 1, -big, 2 * big, 2 * big))
+        self.assertEqual(rect, pygame.Rect(0, 0, 8, 8))
+        for x in range(8):
+            for y in range(8):
+                self.assertEqual(
+                    dest.get_at((x, y)),
+                    source.get_at(((x + big + 1) % 2, (y + big) % 3)),
+                )
+
+    def test_blit_nine_slice_keeps_corners(self):
+        panel = self._panel()
+        for mode in ("stretch", "tile"):
+            dest = pygame.Surface((14, 12))
+            rect = dest.blit_nine_slice(panel, (1, 1, 11, 9), 2, mode)
+            self.assertEqual(rect, pygame.Rect(1, 1, 11, 9))
+            for x, y in ((0, 0), (1, 1)):
+                self.assertEqual(dest.get_at((1 + x, 1 + y)), panel.get_at((x, y)))
+                self.assertEqual(
+                    dest.get_at((10 + x, 8 + y)), panel.get_at((4 + x, 4 + y))
+                )
+                self.assertEqual(
+                    dest.get_at((10 + x, 1 + y)), panel.get_at((4 + x, y))
+                )
+            self.assertEqual(dest.get_at((0, 0)), (0, 0, 0, 255))
+            self.assertEqual(dest.get_at((12, 10)), (0, 0, 0, 255))
+
+    def test_blit_nine_slice_center(self):
+        panel = self._panel()
+        white = (255, 255, 255, 255)
+
+        dest = pygame.Surface((12, 12))
+        dest.blit_nine_slice(panel, (0, 0, 12, 12), (2, 2, 2, 2))
+        # the 2x2 center is stretched to 8x8
+        for i in range(4):
+            self.assertEqual(dest.get_at((2 + i, 2)), white)
+        self.assertNotEqual(dest.get_at((6, 2)), white)
+
+        dest = pygame.Surface((12, 12))
+        dest.blit_nine_slice(panel, (0, 0, 12, 12), (2, 2, 2, 2), "tile")
+        for i in range(4):
+            self.assertEqual(dest.get_at((2 + 2 * i, 2 + 2 * i)), white)
+            self.assertNotEqual(dest.get_at((3 + 2 * i, 2)), white)
+
+    def test_blit_nine_slice_small_dest(self):
+        panel = self._panel()
+        dest = pygame.Surface((4, 4))
+        rect = dest.blit_nine_slice(panel, (0, 0, 2, 3), 2)
+        self.assertEqual(rect, pygame.Rect(0, 0, 2, 3))
+        self.assertEqual(dest.get_at((0, 0)), panel.get_at((1, 1)))
+        self.assertEqual(dest.get_at((1, 0)), panel.get_at((5, 1)))
+        self.assertEqual(dest.get_at((2, 0)), (0, 0, 0, 255))
+
+    def test_blit_nine_slice_alpha_and_depth(self):
+        panel = pygame.Surface((6, 6), depth=8)
+        panel.blit(self._panel(), (0, 0))
+        dest = pygame.Surface((10, 10))
+        dest.blit_nine_slice(panel, (0, 0, 10, 10), 2)
+        self.assertEqual(dest.get_at((9, 9)), panel.get_at((5, 5)))
+
+        panel = pygame.Surface((6, 6), pygame.SRCALPHA)
+        panel.fill((255, 0, 0, 128))
+        dest.fill((0, 0, 0))
+        dest.blit_nine_slice(panel, (0, 0, 10, 10), 2)
+        self.assertAlmostEqual(dest.get_at((0, 0)).r, 128, delta=1)
+        self.assertAlmostEqual(dest.get_at((5, 5)).r, 128, delta=1)
+
+    def test_blit_tilemap(self):
+        tileset = pygame.Surface((6, 2))
+        for index, color in enumerate(("red", "green", "blue")):
+            tileset.fill(color, (index * 2, 0, 2, 2))
+        data = array.array("q", [0, 1, 2, -1, 65535, 3, 2, 1, 0])
+        tiles = memoryview(data).cast("B").cast("q", (3, 3))
+        dest = pygame.Surface((10, 10))
+
+        rect = dest.blit_tilemap(tileset, (2, 2), tiles, (1, 1), (4, 4, 4, 4))
+        self.assertEqual(rect, pygame.Rect(4, 4, 4, 4))
+        # tile (0, 0) is half out of the viewport, (1, 1) is empty
+        self.assertEqual(dest.get_at((4, 4)), (255, 0, 0, 255))
+        self.assertEqual(dest.get_at((5, 4)), (0, 255, 0, 255))
+        self.assertEqual(dest.get_at((7, 4)), (0, 0, 255, 255))
+        self.assertEqual(dest.get_at((5, 5)), (0, 0, 0, 255))
+        self.assertEqual(dest.get_at((6, 7)), (0, 255, 0, 255))
+        self.assertEqual(dest.get_at((7, 7)), (255, 0, 0, 255))
+        self.assertEqual(dest.get_at((3, 4)), (0, 0, 0, 255))
+        self.assertEqual(dest.get_at((8, 7)), (0, 0, 0, 255))
+
+    def test_blit_tilemap_large_indices(self):
+        """Indices past the int range are skipped instead of wrapping around"""
+        tileset = pygame.Surface((4, 2))
+        tileset.fill("red", (0, 0, 2, 2))
+        tileset.fill("green", (2, 0, 2, 2))
+        for typecode, indices in (
+            ("q", [2**32, 2**32 + 1, -(2**32) + 1, 2**63 - 1]),
+            ("Q", [2**32, 2**32 + 1, 2**63 + 1, 2**64 - 1]),
+        ):
+            data = array.array(typecode, indices)
+            tiles = memoryview(data).cast("B").cast(typecode, (2, 2))
+            dest = pygame.Surface((4, 4))
+            dest.blit_tilemap(tileset, (2, 2), tiles)
+            for pos in ((0, 0), (2, 0), (0, 2), (2, 2)):
+                self.assertEqual(dest.get_at(pos), (0, 0, 0, 255), (typecode, pos))
+
+    def test_blit_tilemap_errors(self):
+        dest = pygame.Surface((10, 10))
+        tileset = pygame.Surface((4, 4))
+        flat = array.array("H", [0, 0, 0, 0])
+        with self.assertRaises(ValueError):
+            dest.blit_tilemap(tileset, (2, 2), flat)
+        with self.assertRaises(ValueError):
+            floats = memoryview(array.array("f", [0, 0, 0, 0]))
+            dest.blit_tilemap(tileset, (2, 2), floats.cast("B").cast("f", (2, 2)))
+        with self.assertRaises(ValueError):
+            dest.blit_tilemap(tileset, (0, 2), flat)
+        with self.assertRaises(TypeError):
+            dest.blit_tilemap(tileset, (2, 2), [[0, 0], [0, 0]])
+
+    def test_blit_nine_slice_errors(self):
+        dest = pygame.Surface((10, 10))
+        panel = self._panel()
+        for borders in (4, -1, (1, 2, 6, 0), (0, 4, 0, 4)):
+            with self.assertRaises(ValueError):
+                dest.blit_nine_slice(panel, (0, 0, 10, 10), borders)
+        with self.assertRaises(ValueError):
+            dest.blit_nine_slice(panel, (0, 0, 10, 10), 2, "repeat")
+        with self.assertRaises(TypeError):
+            dest.blit_nine_slice(panel, (0, 0, 10, 10), (1, 2))
+
 
 if __name__ == "__main__":
     unittest.main()
@@ -87,6 +87,45 @@ def gradient(width, height):
             yield (l, t), tuple(map(rgba_between, (l, t, l, l + t)))
 
 
+def color_pattern(surf):
+    """
+
+    Fills surf with a different color and alpha in most pixels, and returns it.
+
+    """
+
+    w, h = surf.get_size()
+    for x in range(w):
+        for y in range(h):
+            color = (x * 4 % 256, y * 5 % 256, x * y % 256, (255 - x) % 256)
+            surf.set_at((x, y), color)
+    return surf
+
+
+def assert_same_threaded(test, fn, msg=None):
+    """
+
+    Asserts that fn() returns the same pixels when pygame runs on one thread
+    and when it splits every operation over four threads. fn returns a
+    Surface or a sequence of them. The thread settings are restored after.
+
+    """
+
+    old_settings = pygame.set_num_threads(1)
+    try:
+        expected = fn()
+        pygame.set_num_threads(4, threshold=0)
+        result = fn()
+    finally:
+        pygame.set_num_threads(*old_settings)
+
+    if isinstance(expected, pygame.Surface):
+        expected, result = [expected], [result]
+    test.assertEqual(len(expected), len(result), msg)
+    for a, b in zip(expected, result):
+        test.assertEqual(a.get_buffer().raw, b.get_buffer().raw, msg)
+
+
 def rect_area_pts(rect):
     for l in range(rect.left, rect.right):
         for t in range(rect.top, rect.bottom):
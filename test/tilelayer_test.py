@@ -0,0 +1,92 @@
+import array
+import unittest
+
+import pygame
+
+TILE_COLORS = [(255, 0, 0), (0, 255, 0), (0, 0, 255), (255, 255, 0)]
+
+
+def make_tileset():
+    """2x2 tiles of 4x4 pixels, tile n filled with TILE_COLORS[n]"""
+    tileset = pygame.Surface((8, 8))
+    for index, color in enumerate(TILE_COLORS):
+        tileset.fill(color, (index % 2 * 4, index // 2 * 4, 4, 4))
+    return tileset
+
+
+def make_tiles(rows):
+    """Returns a uint16 array of the rows and a 2D view of it"""
+    data = array.array("H", [index for row in rows for index in row])
+    return data, memoryview(data).cast("B").cast("H", (len(rows), len(rows[0])))
+
+
+def tile_at(surf, pos):
+    """Index of the tile color at pos, or None"""
+    color = tuple(surf.get_at(pos))[:3]
+    return TILE_COLORS.index(color) if color in TILE_COLORS else None
+
+
+class TileLayerTypeTest(unittest.TestCase):
+    def setUp(self):
+        self.rows = [[(x + y) % 5 for x in range(40)] for y in range(30)]
+        self.data, self.tiles = make_tiles(self.rows)
+
+    def _check(self, surf, offset, viewport):
+        for x in range(viewport.left, viewport.right, 3):
+            for y in range(viewport.top, viewport.bottom, 3):
+                column = (x - viewport.x + offset[0]) // 4
+                row = (y - viewport.y + offset[1]) // 4
+                expected = None
+                if 0 <= column < 40 and 0 <= row < 30 and self.rows[row][column] < 4:
+                    expected = self.rows[row][column]
+                self.assertEqual(tile_at(surf, (x, y)), expected, (x, y))
+
+    def test_draw_matches_blit_tilemap(self):
+        for chunk_size in (None, (3, 2), (16, 16)):
+            layer = pygame.TileLayer(make_tileset(), (4, 4), self.tiles, chunk_size)
+            self.assertEqual(layer.size, (40, 30))
+            for offset in ((0, 0), (5, 7), (-9, -3), (150, 110)):
+                surf = pygame.Surface((50, 40))
+                viewport = pygame.Rect(3, 2, 41, 33)
+                rect = layer.draw(surf, offset, viewport)
+                self.assertEqual(rect, viewport)
+                self._check(surf, offset, viewport)
+                self.assertEqual(surf.get_at((2, 2)), (0, 0, 0, 255))
+
+    def test_chunks_are_cached(self):
+        layer = pygame.TileLayer(make_tileset(), (4, 4), self.tiles, (8, 8))
+        surf = pygame.Surface((32, 32))
+        layer.draw(surf)
+        self.assertEqual(tile_at(surf, (1, 1)), 0)
+
+        # the rendered chunk is drawn until it is invalidated
+        self.data[0] = 3
+        layer.draw(surf)
+        self.assertEqual(tile_at(surf, (1, 1)), 0)
+
+        layer.invalidate((20, 20, 1, 1))
+        layer.draw(surf)
+        self.assertEqual(tile_at(surf, (1, 1)), 0)
+
+        layer.invalidate((0, 0, 1, 1))
+        layer.draw(surf)
+        self.assertEqual(tile_at(surf, (1, 1)), 3)
+
+    def test_clip(self):
+        layer = pygame.TileLayer(make_tileset(), (4, 4), self.tiles, (4, 4))
+        surf = pygame.Surface((20, 20))
+        surf.set_clip((5, 5, 5, 5))
+        self.assertEqual(layer.draw(surf), pygame.Rect(5, 5, 5, 5))
+        self.assertEqual(surf.get_clip(), pygame.Rect(5, 5, 5, 5))
+        self.assertEqual(surf.get_at((4, 4)), (0, 0, 0, 255))
+        self.assertEqual(surf.get_at((10, 10)), (0, 0, 0, 255))
+
+    def test_invalid_sizes(self):
+        with self.assertRaises(ValueError):
+            pygame.TileLayer(make_tileset(), (0, 4), self.tiles)
+        with self.assertRaises(ValueError):
+            pygame.TileLayer(make_tileset(), (4, 4), self.tiles, (0, 1))
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -285,6 +285,198 @@ class TransformModuleTest(unittest.TestCase):
         dest = pygame.Surface((64, 48))
         pygame.transform.scale_by(s, (2.0, 1.5), dest_surface=dest)
 
+    def test_scale__filters(self):
+        """Ensure the scale filters keep flat colors and give the right
+        sizes."""
+        color = (10, 120, 230, 77)
+        for depth, flags in ((32, SRCALPHA), (32, 0), (24, 0)):
+            s = pygame.Surface((37, 23), flags, depth)
+            s.fill(color)
+            expected = s.get_at((0, 0))
+            for filter in ("nearest", "bilinear", "bicubic", "lanczos3"):
+                for size in ((100, 60), (11, 7), (37, 60), (100, 23), (1, 1)):
+                    s2 = pygame.transform.scale(s, size, filter=filter)
+                    self.assertEqual(s2.get_size(), size)
+                    self.assertEqual(s2.get_bitsize(), depth)
+                    for pos in ((0, 0), (size[0] - 1, size[1] - 1)):
+                        self.assertEqual(s2.get_at(pos), expected)
+
+                dest = pygame.Surface((74, 23), flags, depth)
+                pygame.transform.scale_by(s, (2, 1), dest, filter=filter)
+                self.assertEqual(dest.get_at((50, 10)), expected)
+
+    def test_scale__bilinear(self):
+        s = pygame.Surface((2, 1))
+        s.set_at((1, 0), (255, 255, 255))
+
+        s2 = pygame.transform.scale(s, (4, 1), filter="bilinear")
+
+        self.assertEqual(
+            [s2.get_at((x, 0)).r for x in range(4)], [0, 64, 191, 255]
+        )
+
+    def test_scale__filter_errors(self):
+        s = pygame.Surface((8, 8), 0, 32)
+        with self.assertRaises(ValueError):
+            pygame.transform.scale(s, (16, 16), filter="cubic")
+        with self.assertRaises(ValueError):
+            pygame.transform.scale_by(s, 2, filter="")
+        with self.assertRaises(ValueError):
+            pygame.transform.scale(
+                pygame.Surface((8, 8), 0, 8), (16, 16), filter="bicubic"
+            )
+        with self.assertRaises(ValueError):
+            pygame.transform.scale(
+                s, (16, 16), pygame.Surface((16, 16), 0, 24), filter="bicubic"
+            )
+
+    def test_scale__filters_threaded(self):
+        """Ensure the scale filters give the same pixels on several
+        threads."""
+        s = test_utils.color_pattern(pygame.Surface((61, 47), SRCALPHA, 32))
+        sizes = [(30, 20), (130, 90), (30, 90), (130, 20), (61, 90), (30, 47)]
+
+        for surf in (s, s.convert(24)):
+            for filter in ("bilinear", "bicubic", "lanczos3"):
+                for size in sizes:
+                    test_utils.assert_same_threaded(
+                        self,
+                        lambda: pygame.transform.scale(surf, size, filter=filter),
+                        f"mismatch scaling to {size} with {filter}",
+                    )
+
+    @staticmethod
+    def _mipmap_mean(block, weighted):
+        """The rounded mean of the colors of block, with the colors weighted
+        by their alpha when weighted and the block is not transparent."""
+        alpha = sum(c.a for c in block)
+        weights = [c.a if weighted and alpha else 1 for c in block]
+        total = sum(weights)
+        rgb = [
+            (sum(c[k] * w for c, w in zip(block, weights)) + total // 2) // total
+            for k in range(3)
+        ]
+        return (*rgb, (alpha + len(block) // 2) // len(block))
+
+    def test_build_mipmaps(self):
+        """Ensure build_mipmaps halves the surface down to 1x1, averaging
+        each 2x2 block."""
+        for depth, flags in ((32, SRCALPHA), (32, 0), (24, 0)):
+            s = pygame.Surface((37, 23), flags, depth)
+            for x in range(37):
+                for y in range(23):
+                    s.set_at((x, y), (x * 7 % 256, y * 11 % 256, x * y % 256, 255 - x))
+
+            chain = pygame.transform.build_mipmaps(s)
+            self.assertIs(chain[0], s)
+            self.assertEqual(
+                [level.get_size() for level in chain],
+                [(37, 23), (18, 11), (9, 5), (4, 2), (2, 1), (1, 1)],
+            )
+
+            for above, level in zip(chain, chain[1:]):
+                self.assertEqual(level.get_bitsize(), depth)
+                w, h = level.get_size()
+                for x, y in ((0, 0), (w - 1, 0), (w // 2, h - 1)):
+                    # a side 1 pixel long repeats its pixels
+                    rows = (y * 2, min(y * 2 + 1, above.get_height() - 1))
+                    block = [above.get_at((x * 2 + i, j)) for i in (0, 1) for j in rows]
+                    self.assertEqual(
+                        tuple(level.get_at((x, y))), self._mipmap_mean(block, flags)
+                    )
+
+        s = pygame.Surface((64, 1), SRCALPHA, 32)
+        s.fill((200, 100, 50, 25))
+        chain = pygame.transform.build_mipmaps(s, 3)
+        self.assertEqual(
+            [level.get_size() for level in chain], [(64, 1), (32, 1), (16, 1), (8, 1)]
+        )
+        self.assertEqual(chain[-1].get_at((7, 0)), (200, 100, 50, 25))
+        self.assertEqual(len(pygame.transform.build_mipmaps(s, 0)), 1)
+        self.assertEqual(len(pygame.transform.build_mipmaps(s, levels=100)), 7)
+
+        with self.assertRaises(ValueError):
+            pygame.transform.build_mipmaps(pygame.Surface((8, 8), 0, 8))
+
+    def test_build_mipmaps_alpha(self):
+        """Ensure transparent pixels do not darken the opaque pixels next to
+        them."""
+        s = pygame.Surface((8, 8), SRCALPHA, 32)
+        for x in range(8):
+            for y in range(8):
+                s.set_at((x, y), (255, 255, 255, 255) if (x + y) % 2 else (0, 0, 0, 0))
+
+        for level in pygame.transform.build_mipmaps(s)[1:]:
+            w, h = level.get_size()
+            for x in range(w):
+                for y in range(h):
+                    self.assertEqual(level.get_at((x, y)), (255, 255, 255, 128))
+
+        # a fully transparent block keeps the mean of its colors
+        s.fill((200, 0, 0, 0))
+        s.fill((0, 0, 100, 0), (0, 0, 1, 8))
+        level = pygame.transform.build_mipmaps(s, 1)[1]
+        self.assertEqual(level.get_at((0, 0)), (100, 0, 50, 0))
+        self.assertEqual(level.get_at((1, 0)), (200, 0, 0, 0))
+
+        # without per pixel alpha the colors are averaged as they are
+        s = s.convert(24)
+        s.fill((0, 0, 0))
+        s.fill((255, 255, 255), (0, 0, 1, 8))
+        level = pygame.transform.build_mipmaps(s, 1)[1]
+        self.assertEqual(level.get_at((0, 0)), (128, 128, 128, 255))
+
+    def test_build_mipmaps_threaded(self):
+        """Ensure build_mipmaps gives the same pixels on several threads."""
+        s = test_utils.color_pattern(pygame.Surface((123, 97), SRCALPHA, 32))
+
+        for surf in (s, s.convert(24)):
+            test_utils.assert_same_threaded(
+                self, lambda: pygame.transform.build_mipmaps(surf)
+            )
+
+    def test_scale_mipmapped(self):
+        """Ensure scale_mipmapped scales the smallest level covering the
+        size."""
+        s = pygame.Surface((64, 48), SRCALPHA, 32)
+        for x in range(64):
+            for y in range(48):
+                s.set_at((x, y), (x * 4, y * 5, (x * y) % 256, 255 - x))
+        chain = pygame.transform.build_mipmaps(s)
+
+        for size, level in (
+            ((20, 10), 1),
+            ((16, 12), 2),
+            ((17, 12), 1),
+            ((3, 3), 4),
+            ((64, 48), 0),
+            ((100, 20), 0),
+        ):
+            result = pygame.transform.scale_mipmapped(chain, size)
+            expected = pygame.transform.scale(chain[level], size, filter="bilinear")
+            self.assertEqual(result.get_size(), size)
+            self.assertEqual(result.get_buffer().raw, expected.get_buffer().raw)
+
+        # the levels do not need to be in order
+        result = pygame.transform.scale_mipmapped(chain[::-1], (20, 10))
+        expected = pygame.transform.scale(chain[1], (20, 10), filter="bilinear")
+        self.assertEqual(result.get_buffer().raw, expected.get_buffer().raw)
+
+        dest = pygame.Surface((20, 10), SRCALPHA, 32)
+        self.assertIs(
+            pygame.transform.scale_mipmapped(chain, (20, 10), dest_surface=dest), dest
+        )
+        self.assertEqual(dest.get_buffer().raw, expected.get_buffer().raw)
+
+        with self.assertRaises(ValueError):
+            pygame.transform.scale_mipmapped([], (10, 10))
+        with self.assertRaises(TypeError):
+            pygame.transform.scale_mipmapped([s, 1], (10, 10))
+        with self.assertRaises(TypeError):
+            pygame.transform.scale_mipmapped(s, (10, 10))
+        with self.assertRaises(ValueError):
+            pygame.transform.scale_mipmapped(chain, (10, 10), pygame.Surface((5, 5)))
+
     def test_smoothscale_by(self):
         s = pygame.Surface((32, 32))
 
@@ -297,6 +489,50 @@ class TransformModuleTest(unittest.TestCase):
         dest = pygame.Surface((64, 48))
         pygame.transform.smoothscale_by(s, (2.0, 1.5), dest_surface=dest)
 
+    def test_smoothscale_threaded(self):
+        """Ensure smoothscale gives the same pixels on several threads."""
+        s = test_utils.color_pattern(pygame.Surface((61, 47), SRCALPHA, 32))
+        sizes = [(30, 20), (130, 90), (30, 90), (130, 20), (61, 90), (30, 47)]
+
+        for surf in (s, s.convert(24)):
+            for size in sizes:
+                test_utils.assert_same_threaded(
+                    self,
+                    lambda: pygame.transform.smoothscale(surf, size),
+                    f"mismatch scaling to {size}",
+                )
+
+    def test_smoothscale_avx2_matches_sse2(self):
+        """Ensure the AVX2 smoothscale backend gives the same pixels as the
+        SSE2 one."""
+        original_type = pygame.transform.get_smoothscale_backend()
+        try:
+            pygame.transform.set_smoothscale_backend("AVX2")
+            pygame.transform.set_smoothscale_backend("SSE2")
+        except ValueError:
+            self.skipTest("needs the AVX2 and SSE2 backends")
+
+        s = pygame.Surface((61, 47), SRCALPHA, 32)
+        for x in range(61):
+            for y in range(47):
+                s.set_at((x, y), (x * 4, y * 5, (x * y) % 256, 255 - x))
+        sizes = [(30, 20), (130, 90), (30, 90), (130, 20), (3, 2), (7, 5)]
+
+        try:
+            for size in sizes:
+                pygame.transform.set_smoothscale_backend("SSE2")
+                expected = pygame.transform.smoothscale(s, size)
+                pygame.transform.set_smoothscale_backend("AVX2")
+                result = pygame.transform.smoothscale(s, size)
+
+                self.assertEqual(
+                    expected.get_buffer().raw,
+                    result.get_buffer().raw,
+                    f"mismatch scaling to {size}",
+                )
+        finally:
+            pygame.transform.set_smoothscale_backend(original_type)
+
     def test_grayscale(self):
         s = pygame.Surface((32, 32))
         s.fill((255, 0, 0))
@@ -543,6 +779,47 @@ class TransformModuleTest(unittest.TestCase):
                             self.assertAlmostEqual(v1, v2, delta=1)
                         self.assertEqual(c_a, actual_color.a)
 
+    def test_hsl_rows(self):
+        """Ensures hsl() modifies every pixel of wider surfaces the same on
+        one or several threads."""
+        for depth, flags in ((32, pygame.SRCALPHA), (32, 0), (24, 0)):
+            surf = test_utils.color_pattern(pygame.Surface((37, 23), flags, depth))
+            test_utils.assert_same_threaded(
+                self, lambda: pygame.transform.hsl(surf, 100, -0.3, 0.2)
+            )
+
+            result = pygame.transform.hsl(surf, 100, -0.3, 0.2)
+            for x, y in ((0, 0), (36, 0), (17, 11), (36, 22)):
+                color = surf.get_at((x, y))
+                expected_rgb = hsl_to_rgb(
+                    modify_hsl(*rgb_to_hsl(color[:3]), 100 / 360.0, -0.3, 0.2)
+                )
+                actual = result.get_at((x, y))
+                for v1, v2 in zip(expected_rgb, actual.rgb):
+                    self.assertAlmostEqual(v1, v2, delta=1)
+                self.assertEqual(color.a, actual.a)
+
+    def test_hsl_reference(self):
+        """Ensures the 4 and 8 pixel hsl() kernels stay within 1 of the
+        reference conversion for colors on every branch of it."""
+        levels = (0, 1, 64, 127, 128, 200, 254, 255)
+        colors = [(r, g, b) for r in levels for g in levels for b in levels]
+
+        for depth in (24, 32):
+            surf = pygame.Surface((32, 16), 0, depth)
+            for i, color in enumerate(colors):
+                surf.set_at((i % 32, i // 32), color)
+
+            for h, s, l in ((0, 0, 0), (100, -0.3, 0.2), (-45, 0.5, -0.4), (180, 1, 1)):
+                result = pygame.transform.hsl(surf, h, s, l)
+                for i, color in enumerate(colors):
+                    expected_rgb = hsl_to_rgb(
+                        modify_hsl(*rgb_to_hsl(color), h / 360.0, s, l)
+                    )
+                    actual_rgb = result.get_at((i % 32, i // 32)).rgb
+                    for v1, v2 in zip(expected_rgb, actual_rgb):
+                        self.assertAlmostEqual(v1, v2, delta=1)
+
     def test_solid_overlay(self):
         test_surface = pygame.Surface((20, 20), pygame.SRCALPHA)
         test_surface.fill((0, 0, 0, 0))
@@ -1549,6 +1826,247 @@ class TransformModuleTest(unittest.TestCase):
         self.assertEqual(s1.get_rect().size, (64, 64))
         self.assertEqual(s2.get_rect().size, (64, 64))
 
+    def _pixelart_pattern(self, depth):
+        """A surface of a few colors, with edges in every direction."""
+        colors = [(0, 0, 0), (255, 0, 0), (20, 200, 90), (255, 255, 255)]
+        s = pygame.Surface((29, 13), 0, depth)
+        for x in range(29):
+            for y in range(13):
+                s.set_at((x, y), colors[(x * x + 3 * y * x // 5 + y) // 7 % 4])
+        return s
+
+    def _scalex_reference(self, s, factor):
+        """AdvanceMAME Scale2x and Scale3x, as lists of mapped pixel rows."""
+        w, h = s.get_size()
+
+        def at(x, y):
+            return s.get_at_mapped((min(max(x, 0), w - 1), min(max(y, 0), h - 1)))
+
+        rows = [[0] * (w * factor) for _ in range(h * factor)]
+        for y in range(h):
+            for x in range(w):
+                A, B, C = at(x - 1, y - 1), at(x, y - 1), at(x + 1, y - 1)
+                D, E, F = at(x - 1, y), at(x, y), at(x + 1, y)
+                G, H, I = at(x - 1, y + 1), at(x, y + 1), at(x + 1, y + 1)
+                out = [E] * (factor * factor)
+                if B != H and D != F and factor == 2:
+                    out = [
+                        D if D == B else E,
+                        F if B == F else E,
+                        D if D == H else E,
+                        F if H == F else E,
+                    ]
+                elif B != H and D != F:
+                    out = [
+                        D if D == B else E,
+                        B if (D == B and E != C) or (B == F and E != A) else E,
+                        F if B == F else E,
+                        D if (D == B and E != G) or (D == H and E != A) else E,
+                        E,
+                        F if (B == F and E != I) or (H == F and E != C) else E,
+                        D if D == H else E,
+                        H if (D == H and E != I) or (H == F and E != G) else E,
+                        F if H == F else E,
+                    ]
+                for k, pixel in enumerate(out):
+                    rows[y * factor + k // factor][x * factor + k % factor] = pixel
+        return rows
+
+    def _xbr2x_reference(self, s):
+        """2xBR of the 32 bit s, as lists of mapped pixel rows."""
+        w, h = s.get_size()
+        shifts = s.get_shifts()[:3]
+
+        def at(x, y):
+            pixel = s.get_at_mapped((min(max(x, 0), w - 1), min(max(y, 0), h - 1)))
+            pixel &= 0xFFFFFFFF
+            r, g, b = ((pixel >> shift) & 0xFF for shift in shifts)
+            yuv = (
+                77 * r + 150 * g + 29 * b,
+                -43 * r - 85 * g + 128 * b,
+                128 * r - 107 * g - 21 * b,
+            )
+            return pixel, yuv
+
+        def diff(a, b):
+            return sum(k * abs(p - q) for k, p, q in zip((48, 7, 6), a[1], b[1]))
+
+        def eq(a, b):
+            return all(abs(p - q) <= k * 256 for k, p, q in zip((48, 7, 6), a[1], b[1]))
+
+        def blend(dst, src, weight):
+            result = 0
+            for k in range(0, 32, 8):
+                old, new = (dst >> k) & 0xFF, (src >> k) & 0xFF
+                result |= ((new * weight + old * (256 - weight)) >> 8) << k
+            return result
+
+        def turn(offset, turns):
+            dx, dy = offset
+            for _ in range(turns):
+                dx, dy = dy, -dx
+            return dx, dy
+
+        # E, I, H, F, G, C, D, B, F4, I4, H5 and I5 of the bottom right corner
+        neighbours = [(0, 0), (1, 1), (0, 1), (1, 0), (-1, 1), (1, -1)]
+        neighbours += [(-1, 0), (0, -1), (2, 0), (2, 1), (0, 2), (1, 2)]
+
+        rows = [[0] * (w * 2) for _ in range(h * 2)]
+        for y in range(h):
+            for x in range(w):
+                out = {(dx, dy): at(x, y)[0] for dx in (-1, 1) for dy in (-1, 1)}
+                # the other corners turn the neighbours around E
+                for turns in range(4):
+                    E, I, H, F, G, C, D, B, F4, I4, H5, I5 = [
+                        at(x + dx, y + dy)
+                        for dx, dy in (turn(n, turns) for n in neighbours)
+                    ]
+                    N1, N2, N3 = [turn(n, turns) for n in ((1, -1), (-1, 1), (1, 1))]
+                    if E[0] in (H[0], F[0]):
+                        continue
+
+                    e = diff(E, C) + diff(E, G) + diff(I, H5) + diff(I, F4)
+                    e += 4 * diff(H, F)
+                    i = diff(H, D) + diff(H, I5) + diff(F, I4) + diff(F, B)
+                    i += 4 * diff(E, I)
+                    px = F[0] if diff(E, F) <= diff(E, H) else H[0]
+
+                    if e < i and (
+                        (not eq(F, B) and not eq(H, D))
+                        or (eq(E, I) and not eq(F, I4) and not eq(H, I5))
+                        or eq(E, G)
+                        or eq(E, C)
+                    ):
+                        ke, ki = diff(F, G), diff(H, C)
+                        shallow = ke * 2 <= ki and E[0] != G[0] and D[0] != G[0]
+                        steep = ke >= ki * 2 and E[0] != C[0] and B[0] != C[0]
+                        if shallow or steep:
+                            out[N3] = blend(out[N3], px, 192)
+                            if shallow:
+                                out[N2] = blend(out[N2], px, 64)
+                            if steep:
+                                out[N1] = blend(out[N1], px, 64)
+                        else:
+                            out[N3] = blend(out[N3], px, 128)
+                    elif e <= i:
+                        out[N3] = blend(out[N3], px, 64)
+
+                for (dx, dy), pixel in out.items():
+                    rows[y * 2 + (dy + 1) // 2][x * 2 + (dx + 1) // 2] = pixel
+        return rows
+
+    def _mapped_rows(self, s):
+        w, h = s.get_size()
+        return [[s.get_at_mapped((x, y)) for x in range(w)] for y in range(h)]
+
+    def test_scale2x_rules(self):
+        """Ensures scale2x and scale3x follow the AdvanceMAME rules at every
+        depth."""
+        for depth in (8, 16, 24, 32):
+            s = self._pixelart_pattern(depth)
+            self.assertEqual(
+                self._mapped_rows(pygame.transform.scale2x(s)),
+                self._scalex_reference(s, 2),
+            )
+            self.assertEqual(
+                self._mapped_rows(pygame.transform.scale3x(s)),
+                self._scalex_reference(s, 3),
+            )
+
+    def test_scale3x(self):
+        s = pygame.Surface((32, 16), pygame.SRCALPHA, 32)
+
+        s1 = pygame.transform.scale3x(s)
+        s2 = pygame.transform.scale3x(surface=s)
+        self.assertEqual(s1.get_size(), (96, 48))
+        self.assertEqual(s2.get_size(), (96, 48))
+
+        dest = pygame.Surface((96, 48), pygame.SRCALPHA, 32)
+        self.assertIs(pygame.transform.scale3x(s, dest_surface=dest), dest)
+
+        with self.assertRaises(ValueError):
+            pygame.transform.scale3x(s, pygame.Surface((64, 32), pygame.SRCALPHA, 32))
+        with self.assertRaises(ValueError):
+            pygame.transform.scale3x(s, pygame.Surface((96, 48), 0, 24))
+
+    def test_scale4x(self):
+        """Ensures scale4x is scale2x applied twice."""
+        for depth in (8, 16, 24, 32):
+            s = self._pixelart_pattern(depth)
+
+            s4 = pygame.transform.scale4x(s)
+            self.assertEqual(s4.get_size(), (116, 52))
+            self.assertEqual(
+                self._mapped_rows(s4),
+                self._mapped_rows(
+                    pygame.transform.scale2x(pygame.transform.scale2x(s))
+                ),
+            )
+
+        dest = pygame.Surface((116, 52), 0, 32)
+        self.assertIs(pygame.transform.scale4x(s, dest_surface=dest), dest)
+        with self.assertRaises(ValueError):
+            pygame.transform.scale4x(s, pygame.Surface((58, 26), 0, 32))
+
+    def test_xbr2x(self):
+        for depth, flags in ((32, pygame.SRCALPHA), (32, 0), (24, 0)):
+            s = pygame.Surface((17, 11), flags, depth)
+            s.fill((10, 120, 230, 200))
+            expected = s.get_at((0, 0))
+
+            s2 = pygame.transform.xbr2x(s)
+            self.assertEqual(s2.get_size(), (34, 22))
+            for pos in ((0, 0), (33, 21), (17, 10)):
+                self.assertEqual(s2.get_at(pos), expected)
+
+            # the pixels along a diagonal edge are blended
+            s.fill((0, 0, 0))
+            for x in range(17):
+                for y in range(11):
+                    if x * 2 > y + 3:
+                        s.set_at((x, y), (255, 255, 255))
+            dest = pygame.Surface((34, 22), flags, depth)
+            self.assertIs(pygame.transform.xbr2x(s, dest_surface=dest), dest)
+            reds = {dest.get_at((x, y)).r for x in range(34) for y in range(22)}
+            self.assertIn(0, reds)
+            self.assertIn(255, reds)
+            self.assertGreater(len(reds), 2)
+
+        with self.assertRaises(ValueError):
+            pygame.transform.xbr2x(pygame.Surface((8, 8), 0, 8))
+        with self.assertRaises(ValueError):
+            pygame.transform.xbr2x(s, pygame.Surface((8, 8), 0, 24))
+
+    def test_xbr2x_rules(self):
+        """Ensures xbr2x blends the edges of a small pattern like 2xBR."""
+        for flags in (0, pygame.SRCALPHA):
+            s = pygame.Surface((29, 13), flags, 32)
+            s.blit(self._pixelart_pattern(32), (0, 0))
+            if flags:
+                s.fill((0, 0, 255, 100), (3, 2, 6, 5))
+            self.assertEqual(
+                [
+                    [pixel & 0xFFFFFFFF for pixel in row]
+                    for row in self._mapped_rows(pygame.transform.xbr2x(s))
+                ],
+                self._xbr2x_reference(s),
+            )
+
+    def test_pixelart_threaded(self):
+        """Ensures the pixel art scalers give the same pixels on several
+        threads."""
+        for depth in (8, 24, 32):
+            s = self._pixelart_pattern(depth)
+            for scale in (
+                pygame.transform.scale2x,
+                pygame.transform.scale3x,
+                pygame.transform.scale4x,
+                pygame.transform.xbr2x,
+            ):
+                if depth == 8 and scale is pygame.transform.xbr2x:
+                    continue
+                test_utils.assert_same_threaded(self, lambda: scale(s))
+
     def test_scale2xraw(self):
         # Even though transform.scale no longer has a special
         # case for 2x upscaling, this test validates that the behavior
@@ -1570,7 +2088,9 @@ class TransformModuleTest(unittest.TestCase):
 
     def test_get_smoothscale_backend(self):
         filter_type = pygame.transform.get_smoothscale_backend()
-        self.assertTrue(filter_type in ["GENERIC", "MMX", "SSE", "SSE2", "NEON"])
+        self.assertTrue(
+            filter_type in ["GENERIC", "MMX", "SSE", "SSE2", "AVX2", "NEON"]
+        )
         # It would be nice to test if a non-generic type corresponds to an x86
         # processor. But there is no simple test for this. platform.machine()
         # returns process version specific information, like 'i686'.
@@ -1717,6 +2237,27 @@ class TransformModuleTest(unittest.TestCase):
         with_rot = pygame.transform.rotozoom(image, 5, 1.1)
         self.assertEqual(image.get_colorkey(), with_rot.get_colorkey())
 
+    def test_rotozoom_threaded(self):
+        """Ensure rotozoom gives the same pixels on several threads."""
+        s = test_utils.color_pattern(pygame.Surface((61, 47), SRCALPHA, 32))
+
+        for angle, scale in ((0, 2.5), (0, 0.4), (30, 1.0), (-117, 3.3)):
+            test_utils.assert_same_threaded(
+                self,
+                lambda: pygame.transform.rotozoom(s, angle, scale),
+                f"mismatch with angle {angle} and scale {scale}",
+            )
+
+    def test_rotozoom_flat_color(self):
+        """Ensure the filtering of rotozoom keeps flat colors."""
+        s = pygame.Surface((40, 30), SRCALPHA, 32)
+        s.fill((10, 150, 250, 200))
+
+        for angle, scale in ((0, 1.7), (45, 1.0), (200, 2.2)):
+            result = pygame.transform.rotozoom(s, angle, scale)
+            center = result.get_rect().center
+            self.assertEqual(result.get_at(center), (10, 150, 250, 200))
+
     def test_invert(self):
         surface = pygame.Surface((10, 10), depth=32)
 
@@ -2040,6 +2581,48 @@ class TransformDisplayModuleTest(unittest.TestCase):
         for pos in data2:
             self.assertTrue(sf_b2.get_at(pos) == data2[pos])
 
+    def test_gaussian_blur_fast(self):
+        """Ensure the fast gaussian blur stays close to the exact one."""
+        sf = pygame.Surface((61, 47), SRCALPHA, 32)
+        for x in range(61):
+            for y in range(47):
+                sf.set_at((x, y), (x * 4, y * 5, (x * y) % 256, 255 - x))
+
+        for radius in (2, 5, 8):
+            exact = pygame.transform.gaussian_blur(sf, radius)
+            fast = pygame.transform.gaussian_blur(sf, radius, mode="fast")
+            self.assertEqual(fast.get_size(), sf.get_size())
+            exact_bytes = exact.get_buffer().raw
+            fast_bytes = fast.get_buffer().raw
+            total = sum(abs(a - b) for a, b in zip(exact_bytes, fast_bytes))
+            self.assertLess(total / len(exact_bytes), 4)
+
+        flat = pygame.Surface((31, 17), pygame.SRCALPHA)
+        flat.fill((10, 120, 230, 77))
+        for depth in (32, 24, 16):
+            surf = flat.convert(depth)
+            expected = surf.get_at((0, 0))
+            blurred = pygame.transform.gaussian_blur(surf, 9, mode="fast")
+            self.assertEqual(blurred.get_at((0, 0)), expected)
+            self.assertEqual(blurred.get_at((30, 16)), expected)
+
+        with self.assertRaises(ValueError):
+            pygame.transform.gaussian_blur(sf, 3, mode="slow")
+
+    def test_gaussian_blur_fast_threaded(self):
+        """Ensure the fast gaussian blur gives the same pixels on several
+        threads."""
+        s = test_utils.color_pattern(pygame.Surface((61, 47), SRCALPHA, 32))
+
+        for surf in (s, s.convert(24)):
+            for repeat in (True, False):
+                test_utils.assert_same_threaded(
+                    self,
+                    lambda: pygame.transform.gaussian_blur(
+                        surf, 6, repeat, mode="fast"
+                    ),
+                )
+
     def test_blur_zero_size_surface(self):
         surface = pygame.Surface((0, 0))
         self.assertEqual(pygame.transform.box_blur(surface, 3).get_size(), (0, 0))
@@ -2053,6 +2636,288 @@ class TransformDisplayModuleTest(unittest.TestCase):
         self.assertEqual(pygame.transform.box_blur(surface, 3).get_size(), (0, 20))
         self.assertEqual(pygame.transform.gaussian_blur(surface, 3).get_size(), (0, 20))
 
+    def test_convolve(self):
+        """Ensure convolve weights the pixels around each pixel."""
+        s = pygame.Surface((3, 3), SRCALPHA, 32)
+        s.fill((0, 0, 0, 77))
+        s.set_at((1, 1), (90, 180, 45, 200))
+
+        identity = [[0, 0, 0], [0, 1, 0], [0, 0, 0]]
+        box = [[1 / 9] * 3] * 3
+        for surf in (s, s.convert(24)):
+            result = pygame.transform.convolve(surf, identity)
+            for x in range(3):
+                for y in range(3):
+                    self.assertEqual(result.get_at((x, y)), surf.get_at((x, y)))
+
+            for separable in (None, True, False):
+                result = pygame.transform.convolve(surf, box, separable=separable)
+                # the alpha is kept from the source
+                alpha = surf.get_at((0, 0))[3]
+                self.assertEqual(result.get_at((0, 0)), (10, 20, 5, alpha))
+                alpha = surf.get_at((1, 1))[3]
+                self.assertEqual(result.get_at((1, 1)), (10, 20, 5, alpha))
+
+        dest = pygame.Surface((3, 3), SRCALPHA, 32)
+        self.assertIs(pygame.transform.convolve(s, box, dest_surface=dest), dest)
+        self.assertEqual(dest.get_at((2, 1)), (10, 20, 5, 77))
+
+    def test_convolve_orientation(self):
+        """Ensure kernel[j][i] weights the pixel (x + i - kw // 2,
+        y + j - kh // 2), without flipping the kernel."""
+        s = pygame.Surface((5, 4), 0, 32)
+        for x in range(5):
+            for y in range(4):
+                s.set_at((x, y), (x * 40, y * 60, 0))
+
+        for kernel, (dx, dy) in (
+            ([[0, 0, 1], [0, 0, 0], [0, 0, 0]], (1, -1)),
+            ([[0, 0, 0], [1, 0, 0]], (-1, 0)),
+            ([[0, 0], [0, 0], [0, 0], [0, 1]], (0, 1)),
+        ):
+            for separable in (None, False):
+                result = pygame.transform.convolve(s, kernel, separable=separable)
+                for x in range(1, 4):
+                    for y in range(1, 3):
+                        self.assertEqual(
+                            result.get_at((x, y)), s.get_at((x + dx, y + dy))
+                        )
+
+    def test_convolve_border(self):
+        """Ensure the border modes pick the pixels past the edges."""
+        s = pygame.Surface((4, 1), 0, 32)
+        for x, value in enumerate((10, 20, 30, 40)):
+            s.set_at((x, 0), (value, value, value))
+        # each pixel takes the value of the pixel on its left
+        kernel = [[1, 0, 0]]
+
+        for border, expected in (
+            ("clamp", (10, 10, 20, 30)),
+            ("wrap", (40, 10, 20, 30)),
+            ("zero", (0, 10, 20, 30)),
+        ):
+            result = pygame.transform.convolve(s, kernel, border=border)
+            self.assertEqual(
+                tuple(result.get_at((x, 0))[0] for x in range(4)), expected
+            )
+
+    def test_convolve_separable(self):
+        """Ensure separable kernels give about the same pixels in two passes."""
+        s = pygame.Surface((41, 29), 0, 32)
+        for x in range(41):
+            for y in range(29):
+                s.set_at((x, y), (x * 6, y * 8, (x * y) % 256))
+
+        weights = (1, 4, 6, 4, 1)
+        gaussian = [[a * b / 256 for b in weights] for a in weights]
+        sharpen = [[0, -1, 0], [-1, 5, -1], [0, -1, 0]]
+
+        for border in ("clamp", "wrap", "zero"):
+            whole = pygame.transform.convolve(
+                s, gaussian, separable=False, border=border
+            )
+            passes = pygame.transform.convolve(
+                s, gaussian, separable=True, border=border
+            )
+            for x in range(41):
+                for y in range(29):
+                    for a, b in zip(whole.get_at((x, y)), passes.get_at((x, y))):
+                        self.assertAlmostEqual(a, b, delta=2)
+
+        self.assertRaises(
+            ValueError, pygame.transform.convolve, s, sharpen, separable=True
+        )
+
+    def test_convolve_threaded(self):
+        """Ensure convolve gives the same pixels on several threads."""
+        s = test_utils.color_pattern(pygame.Surface((61, 47), SRCALPHA, 32))
+
+        kernels = ([[1 / 25] * 5] * 5, [[-2, -1, 0], [-1, 1, 1], [0, 1, 2]])
+        for surf in (s, s.convert(24)):
+            for kernel in kernels:
+                test_utils.assert_same_threaded(
+                    self, lambda: pygame.transform.convolve(surf, kernel)
+                )
+
+    def test_convolve_errors(self):
+        s = pygame.Surface((10, 10), 0, 32)
+        kernel = [[0, 1, 0]]
+
+        self.assertRaises(ValueError, pygame.transform.convolve, s, [[1, 2], [3]])
+        self.assertRaises(ValueError, pygame.transform.convolve, s, [])
+        self.assertRaises(ValueError, pygame.transform.convolve, s, [[]])
+        self.assertRaises(TypeError, pygame.transform.convolve, s, [[1, "2"]])
+        self.assertRaises(TypeError, pygame.transform.convolve, s, 1)
+        self.assertRaises(
+            ValueError, pygame.transform.convolve, s, kernel, border="mirror"
+        )
+        self.assertRaises(ValueError, pygame.transform.convolve, s, [[1e9]])
+        # a single row object repeated, so that the kernel costs little memory
+        with self.assertRaisesRegex(ValueError, "kernel is too large"):
+            pygame.transform.convolve(s, [[0] * 2**16] * 2**16)
+        self.assertRaises(
+            ValueError,
+            pygame.transform.convolve,
+            pygame.Surface((10, 10), 0, 8),
+            kernel,
+        )
+        self.assertRaises(
+            ValueError, pygame.transform.convolve, s, kernel, dest_surface=s
+        )
+        self.assertRaises(
+            ValueError,
+            pygame.transform.convolve,
+            s,
+            kernel,
+            dest_surface=pygame.Surface((5, 10), 0, 32),
+        )
+        self.assertEqual(
+            pygame.transform.convolve(pygame.Surface((0, 7)), kernel).get_size(),
+            (0, 7),
+        )
+
+    def test_apply_lut(self):
+        """Ensure apply_lut maps each channel through its table."""
+        invert = [255 - v for v in range(256)]
+        halve = bytes(v // 2 for v in range(256))
+
+        for surf in (
+            test_utils.color_pattern(pygame.Surface((19, 13), SRCALPHA, 32)),
+            test_utils.color_pattern(pygame.Surface((19, 13), 0, 32)),
+            test_utils.color_pattern(pygame.Surface((19, 13), 0, 24)),
+            test_utils.color_pattern(pygame.Surface((19, 13), SRCALPHA, 16)),
+        ):
+            expected = pygame.transform.invert(surf)
+            result = pygame.transform.apply_lut(surf, invert, invert, invert)
+            self.assertEqual(result.get_size(), surf.get_size())
+            self.assertEqual(result.get_bitsize(), surf.get_bitsize())
+
+            halved = pygame.transform.apply_lut(surf, g_lut=halve, a_lut=halve)
+            for x in range(19):
+                for y in range(13):
+                    self.assertEqual(result.get_at((x, y)), expected.get_at((x, y)))
+
+                    r, g, b, a = surf.get_at((x, y))
+                    if surf.get_flags() & SRCALPHA:
+                        a //= 2
+                    self.assertEqual(
+                        halved.get_at((x, y)),
+                        surf.unmap_rgb(surf.map_rgb((r, g // 2, b, a))),
+                    )
+
+        # the surface itself can be the destination
+        surf = test_utils.color_pattern(pygame.Surface((19, 13), SRCALPHA, 32))
+        expected = pygame.transform.invert(surf)
+        result = pygame.transform.apply_lut(
+            surf, invert, invert, invert, dest_surface=surf
+        )
+        self.assertIs(result, surf)
+        self.assertEqual(surf.get_buffer().raw, expected.get_buffer().raw)
+
+    def test_apply_lut_errors(self):
+        s = pygame.Surface((10, 10), 0, 32)
+
+        self.assertRaises(ValueError, pygame.transform.apply_lut, s, [0] * 255)
+        self.assertRaises(ValueError, pygame.transform.apply_lut, s, [256] * 256)
+        self.assertRaises(ValueError, pygame.transform.apply_lut, s, [-1] * 256)
+        self.assertRaises(TypeError, pygame.transform.apply_lut, s, 1)
+        self.assertRaises(TypeError, pygame.transform.apply_lut, s, [0.5] * 256)
+        self.assertRaises(
+            ValueError,
+            pygame.transform.apply_lut,
+            s,
+            dest_surface=pygame.Surface((10, 9), 0, 32),
+        )
+
+    def test_color_matrix(self):
+        """Ensure color_matrix computes each channel from the source pixel."""
+        identity = [
+            [1, 0, 0, 0, 0],
+            [0, 1, 0, 0, 0],
+            [0, 0, 1, 0, 0],
+            [0, 0, 0, 1, 0],
+        ]
+        # red and blue swapped, green from red and alpha, gray alpha
+        matrix = [
+            [0, 0, 1, 0, 0],
+            [0.5, 0, 0, 0.5, -10],
+            [1, 0, 0, 0, 0],
+            [0.25, 0.25, 0.25, 0.25, 0.4],
+        ]
+
+        for surf in (
+            test_utils.color_pattern(pygame.Surface((19, 13), SRCALPHA, 32)),
+            test_utils.color_pattern(pygame.Surface((19, 13), 0, 32)),
+            test_utils.color_pattern(pygame.Surface((19, 13), 0, 24)),
+            test_utils.color_pattern(pygame.Surface((19, 13), SRCALPHA, 16)),
+        ):
+            result = pygame.transform.color_matrix(surf, identity)
+            self.assertEqual(result.get_buffer().raw, surf.get_buffer().raw)
+
+            result = pygame.transform.color_matrix(surf, matrix)
+            for x in range(19):
+                for y in range(13):
+                    r, g, b, a = surf.get_at((x, y))
+                    expected = (
+                        b,
+                        max(int(0.5 * r + 0.5 * a - 10 + 0.5), 0),
+                        r,
+                        int((r + g + b + a) / 4 + 0.4 + 0.5),
+                    )
+                    if not surf.get_flags() & SRCALPHA:
+                        expected = expected[:3] + (255,)
+                    expected = surf.unmap_rgb(surf.map_rgb(expected))
+                    self.assertEqual(result.get_at((x, y)), expected)
+
+        # the surface itself can be the destination
+        surf = test_utils.color_pattern(pygame.Surface((19, 13), SRCALPHA, 32))
+        swapped = pygame.transform.color_matrix(surf, matrix)
+        result = pygame.transform.color_matrix(surf, matrix, dest_surface=surf)
+        self.assertIs(result, surf)
+        self.assertEqual(surf.get_buffer().raw, swapped.get_buffer().raw)
+
+    def test_color_matrix_errors(self):
+        s = pygame.Surface((10, 10), 0, 32)
+        row = [1, 0, 0, 0, 0]
+
+        self.assertRaises(ValueError, pygame.transform.color_matrix, s, [row] * 3)
+        self.assertRaises(ValueError, pygame.transform.color_matrix, s, [row[:4]] * 4)
+        self.assertRaises(
+            ValueError, pygame.transform.color_matrix, s, [[8, 0, 0, 0, 0]] * 4
+        )
+        self.assertRaises(
+            TypeError, pygame.transform.color_matrix, s, [[1, 0, 0, 0, "0"]] * 4
+        )
+        self.assertRaises(TypeError, pygame.transform.color_matrix, s, 1)
+        self.assertRaises(
+            ValueError,
+            pygame.transform.color_matrix,
+            s,
+            [row] * 4,
+            dest_surface=pygame.Surface((10, 9), 0, 32),
+        )
+
+    def test_color_ops_threaded(self):
+        """Ensure apply_lut and color_matrix give the same pixels on several
+        threads."""
+        lut = [v * 7 % 256 for v in range(256)]
+        matrix = [
+            [0.393, 0.769, 0.189, 0, 0],
+            [0.349, 0.686, 0.168, 0, 0],
+            [0.272, 0.534, 0.131, 0, 0],
+            [0, 0, 0, 1, 0],
+        ]
+        s = test_utils.color_pattern(pygame.Surface((61, 47), SRCALPHA, 32))
+
+        for surf in (s, s.convert(24)):
+            test_utils.assert_same_threaded(
+                self,
+                lambda: (
+                    pygame.transform.apply_lut(surf, lut, lut, lut, lut),
+                    pygame.transform.color_matrix(surf, matrix),
+                ),
+            )
+
     def test_flip(self):
         """honors the set_color key on the returned surface from flip."""
         image_loaded = pygame.image.load(example_path("data/chimp.webp"))
@@ -2139,5 +3004,61 @@ class TransformDisplayModuleTest(unittest.TestCase):
         self.assertEqual(scaled_surf.get_at((8, 8)), (255, 0, 0, 255))
 
 
+class TransformPoolTest(unittest.TestCase):
+    def setUp(self):
+        self.budget = pygame.transform.get_pool_stats()["budget"]
+
+    def tearDown(self):
+        pygame.transform.set_pool_budget(self.budget)
+
+    def test_reuse(self):
+        surf = pygame.Surface((10, 10), SRCALPHA)
+        surf.fill((1, 2, 3, 4))
+        pygame.transform.set_pool_budget(0)
+        pygame.transform.set_pool_budget(1 << 20)
+
+        scaled = pygame.transform.scale(surf, (7, 9))
+        scaled.set_colorkey((1, 2, 3))
+        scaled.set_alpha(10)
+        scaled.set_clip((0, 0, 1, 1))
+        del scaled
+        stats = pygame.transform.get_pool_stats()
+        self.assertEqual(stats["count"], 1)
+        self.assertEqual(stats["bytes"], 7 * 9 * 4)
+
+        hits = stats["hits"]
+        flipped = pygame.transform.flip(pygame.Surface((7, 9), SRCALPHA), 1, 0)
+        stats = pygame.transform.get_pool_stats()
+        self.assertEqual(stats["hits"], hits + 1)
+        self.assertEqual(stats["count"], 0)
+        # nothing of the previous Surface is left
+        self.assertEqual(flipped.get_at((3, 3)), (0, 0, 0, 0))
+        self.assertIsNone(flipped.get_colorkey())
+        self.assertEqual(flipped.get_alpha(), 255)
+        self.assertEqual(flipped.get_clip(), flipped.get_rect())
+
+    def test_budget(self):
+        pygame.transform.set_pool_budget(100 * 100 * 4)
+        for size in ((100, 100), (50, 50), (10, 10)):
+            pygame.transform.scale(pygame.Surface((1, 1), SRCALPHA), size)
+        stats = pygame.transform.get_pool_stats()
+        self.assertLessEqual(stats["bytes"], 100 * 100 * 4)
+        self.assertEqual(stats["budget"], 100 * 100 * 4)
+
+        pygame.transform.set_pool_budget(0)
+        stats = pygame.transform.get_pool_stats()
+        self.assertEqual((stats["count"], stats["bytes"]), (0, 0))
+
+        with self.assertRaises(ValueError):
+            pygame.transform.set_pool_budget(-1)
+
+    def test_quit_empties_pool(self):
+        pygame.init()
+        pygame.transform.scale(pygame.Surface((1, 1)), (20, 20))
+        self.assertGreater(pygame.transform.get_pool_stats()["count"], 0)
+        pygame.quit()
+        self.assertEqual(pygame.transform.get_pool_stats()["count"], 0)
+
+
 if __name__ == "__main__":
     unittest.main()